@@ -3,6 +3,7 @@ lib_LTLIBRARIES += common/libolacommon.la
 # Variables the included files can append to
 # ------------------------------------------
 common_libolacommon_la_CXXFLAGS = $(COMMON_PROTOBUF_CXXFLAGS)
+common_libolacommon_la_LDFLAGS = -version-info 1:0:0
 common_libolacommon_la_LIBADD =
 common_libolacommon_la_SOURCES =
 nodist_common_libolacommon_la_SOURCES =
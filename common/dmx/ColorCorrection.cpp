@@ -0,0 +1,119 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ColorCorrection.cpp
+ * Gamma & white balance correction for RGB pixel outputs.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "common/dmx/ColorCorrection.h"
+#include "ola/StringUtils.h"
+
+namespace ola {
+namespace dmx {
+
+using std::string;
+using std::vector;
+
+const double ColorCorrection::MIN_GAMMA = 0.1;
+const double ColorCorrection::MAX_GAMMA = 5.0;
+
+ColorCorrection::ColorCorrection()
+    : m_gamma(1.0),
+      m_identity(true) {
+  for (unsigned int i = 0; i < COLOR_COUNT; i++) {
+    m_scale[i] = 255;
+  }
+  BuildTables();
+}
+
+
+ColorCorrection::ColorCorrection(double gamma, uint8_t red_scale,
+                                 uint8_t green_scale, uint8_t blue_scale)
+    : m_gamma(gamma) {
+  m_scale[0] = red_scale;
+  m_scale[1] = green_scale;
+  m_scale[2] = blue_scale;
+  m_identity = (gamma == 1.0 && red_scale == 255 && green_scale == 255 &&
+                blue_scale == 255);
+  BuildTables();
+}
+
+
+void ColorCorrection::Apply(const uint8_t *input, unsigned int length,
+                            uint8_t *output) const {
+  unsigned int i = 0;
+  for (; i + COLOR_COUNT <= length; i += COLOR_COUNT) {
+    output[i] = m_tables[0][input[i]];
+    output[i + 1] = m_tables[1][input[i + 1]];
+    output[i + 2] = m_tables[2][input[i + 2]];
+  }
+  for (unsigned int color = 0; i < length; i++, color++) {
+    output[i] = m_tables[color][input[i]];
+  }
+}
+
+
+bool ColorCorrection::FromStrings(const string &gamma_str,
+                                  const string &white_balance,
+                                  ColorCorrection *correction) {
+  double gamma = 1.0;
+  if (!gamma_str.empty()) {
+    char *end = NULL;
+    gamma = strtod(gamma_str.c_str(), &end);
+    if (end == gamma_str.c_str() || *end != 0 || gamma < MIN_GAMMA ||
+        gamma > MAX_GAMMA) {
+      return false;
+    }
+  }
+
+  uint8_t scale[COLOR_COUNT] = {255, 255, 255};
+  if (!white_balance.empty()) {
+    vector<string> tokens;
+    StringSplit(white_balance, &tokens, ",");
+    if (tokens.size() != COLOR_COUNT) {
+      return false;
+    }
+    for (unsigned int i = 0; i < COLOR_COUNT; i++) {
+      StringTrim(&tokens[i]);
+      if (!StringToInt(tokens[i], &scale[i])) {
+        return false;
+      }
+    }
+  }
+
+  *correction = ColorCorrection(gamma, scale[0], scale[1], scale[2]);
+  return true;
+}
+
+
+void ColorCorrection::BuildTables() {
+  for (unsigned int color = 0; color < COLOR_COUNT; color++) {
+    const double scale = m_scale[color] / 255.0;
+    for (unsigned int i = 0; i < 256; i++) {
+      const double value = pow(i / 255.0, m_gamma) * scale;
+      const uint16_t wide = static_cast<uint16_t>(value * 65535 + 0.5);
+      m_wide_tables[color][i] = wide;
+      m_tables[color][i] = static_cast<uint8_t>((wide * 255 + 32767) / 65535);
+    }
+  }
+}
+}  // namespace dmx
+}  // namespace ola
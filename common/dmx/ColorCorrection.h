@@ -0,0 +1,118 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ColorCorrection.h
+ * Gamma & white balance correction for RGB pixel outputs.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_DMX_COLORCORRECTION_H_
+#define COMMON_DMX_COLORCORRECTION_H_
+
+#include <stdint.h>
+#include <string>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief Gamma & white balance correction for RGB pixels.
+ *
+ * The correction is applied using a lookup table for each color. The 8 bit
+ * tables are for outputs with 8 bits per color, the 16 bit tables are for
+ * hardware that can use the extra precision, e.g. the APA102 global
+ * brightness.
+ *
+ * The color of a slot is its offset modulo 3, i.e. the slots are R, G, B.
+ */
+class ColorCorrection {
+ public:
+  /**
+   * @brief Create a correction which doesn't change the data.
+   */
+  ColorCorrection();
+
+  /**
+   * @brief Create a new correction.
+   * @param gamma the gamma to apply, 1.0 is linear.
+   * @param red_scale the value full red is scaled to.
+   * @param green_scale the value full green is scaled to.
+   * @param blue_scale the value full blue is scaled to.
+   */
+  ColorCorrection(double gamma, uint8_t red_scale, uint8_t green_scale,
+                  uint8_t blue_scale);
+
+  /**
+   * @brief Check if this correction doesn't change the data.
+   */
+  bool IsIdentity() const { return m_identity; }
+
+  double Gamma() const { return m_gamma; }
+
+  /**
+   * @brief Return the 8 bit table for a color.
+   * @param color the color, 0 - 2 for R, G & B.
+   */
+  const uint8_t *Table(unsigned int color) const {
+    return m_tables[color];
+  }
+
+  /**
+   * @brief Return the 16 bit table for a color.
+   * @param color the color, 0 - 2 for R, G & B.
+   */
+  const uint16_t *WideTable(unsigned int color) const {
+    return m_wide_tables[color];
+  }
+
+  /**
+   * @brief Correct a run of RGB slots.
+   * @param input the slots to correct, the first one is red.
+   * @param length the number of slots.
+   * @param output where to write the corrected slots, this may be the same as
+   *   input.
+   */
+  void Apply(const uint8_t *input, unsigned int length,
+             uint8_t *output) const;
+
+  /**
+   * @brief Create a correction from the strings used in the preferences.
+   * @param gamma the gamma, e.g. "2.2". An empty string is linear.
+   * @param white_balance the scale for each color, e.g. "255,200,180". An
+   *   empty string is 255,255,255.
+   * @param[out] correction the new correction.
+   * @returns false if either string was invalid, in which case correction
+   *   isn't modified.
+   */
+  static bool FromStrings(const std::string &gamma,
+                          const std::string &white_balance,
+                          ColorCorrection *correction);
+
+  static const unsigned int COLOR_COUNT = 3;
+  static const double MIN_GAMMA;
+  static const double MAX_GAMMA;
+
+ private:
+  double m_gamma;
+  uint8_t m_scale[COLOR_COUNT];
+  bool m_identity;
+  uint8_t m_tables[COLOR_COUNT][256];
+  uint16_t m_wide_tables[COLOR_COUNT][256];
+
+  void BuildTables();
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // COMMON_DMX_COLORCORRECTION_H_
@@ -0,0 +1,151 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ColorCorrectionTest.cpp
+ * Test fixture for the ColorCorrection class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "common/dmx/ColorCorrection.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::dmx::ColorCorrection;
+using std::string;
+
+class ColorCorrectionTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ColorCorrectionTest);
+  CPPUNIT_TEST(testIdentity);
+  CPPUNIT_TEST(testCorrection);
+  CPPUNIT_TEST(testApply);
+  CPPUNIT_TEST(testFromStrings);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testIdentity();
+    void testCorrection();
+    void testApply();
+    void testFromStrings();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ColorCorrectionTest);
+
+
+/*
+ * Check the default correction doesn't change anything.
+ */
+void ColorCorrectionTest::testIdentity() {
+  ColorCorrection correction;
+  OLA_ASSERT_TRUE(correction.IsIdentity());
+  OLA_ASSERT_TRUE(ColorCorrection(1.0, 255, 255, 255).IsIdentity());
+  OLA_ASSERT_FALSE(ColorCorrection(2.2, 255, 255, 255).IsIdentity());
+  OLA_ASSERT_FALSE(ColorCorrection(1.0, 255, 254, 255).IsIdentity());
+
+  for (unsigned int color = 0; color < ColorCorrection::COLOR_COUNT;
+       color++) {
+    for (unsigned int i = 0; i < 256; i++) {
+      OLA_ASSERT_EQ(static_cast<uint8_t>(i), correction.Table(color)[i]);
+      OLA_ASSERT_EQ(static_cast<uint16_t>(i * 257),
+                    correction.WideTable(color)[i]);
+    }
+  }
+}
+
+
+/*
+ * Check gamma & white balance.
+ */
+void ColorCorrectionTest::testCorrection() {
+  ColorCorrection correction(2.0, 255, 128, 0);
+  OLA_ASSERT_EQ(2.0, correction.Gamma());
+
+  // Red is only gamma corrected
+  const uint8_t *red = correction.Table(0);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), red[0]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), red[7]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(64), red[128]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(255), red[255]);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(16513), correction.WideTable(0)[128]);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(65535), correction.WideTable(0)[255]);
+
+  // The 16 bit table keeps the low values
+  OLA_ASSERT_EQ(static_cast<uint16_t>(49), correction.WideTable(0)[7]);
+
+  // Full green is scaled to 128
+  OLA_ASSERT_EQ(static_cast<uint8_t>(128), correction.Table(1)[255]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(32), correction.Table(1)[128]);
+
+  // No blue
+  for (unsigned int i = 0; i < 256; i++) {
+    OLA_ASSERT_EQ(static_cast<uint8_t>(0), correction.Table(2)[i]);
+    OLA_ASSERT_EQ(static_cast<uint16_t>(0), correction.WideTable(2)[i]);
+  }
+}
+
+
+/*
+ * Check that each slot uses the table for its color.
+ */
+void ColorCorrectionTest::testApply() {
+  ColorCorrection correction(1.0, 255, 128, 0);
+  const uint8_t input[] = {255, 255, 255, 100, 100, 100, 255, 255};
+  uint8_t output[sizeof(input)];
+  correction.Apply(input, sizeof(input), output);
+  const uint8_t expected[] = {255, 128, 0, 100, 50, 0, 255, 128};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output, sizeof(output));
+
+  // In place
+  uint8_t data[] = {255, 255, 255};
+  correction.Apply(data, sizeof(data), data);
+  OLA_ASSERT_DATA_EQUALS(expected, 3, data, sizeof(data));
+}
+
+
+/*
+ * Check parsing the preference values.
+ */
+void ColorCorrectionTest::testFromStrings() {
+  ColorCorrection correction(2.0, 1, 2, 3);
+
+  OLA_ASSERT_TRUE(ColorCorrection::FromStrings("", "", &correction));
+  OLA_ASSERT_TRUE(correction.IsIdentity());
+
+  OLA_ASSERT_TRUE(ColorCorrection::FromStrings("2.2", "", &correction));
+  OLA_ASSERT_FALSE(correction.IsIdentity());
+  OLA_ASSERT_EQ(2.2, correction.Gamma());
+
+  OLA_ASSERT_TRUE(ColorCorrection::FromStrings("", "255, 128,0",
+                                               &correction));
+  OLA_ASSERT_EQ(1.0, correction.Gamma());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(128), correction.Table(1)[255]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), correction.Table(2)[255]);
+
+  // Invalid values leave the correction as is
+  OLA_ASSERT_FALSE(ColorCorrection::FromStrings("foo", "", &correction));
+  OLA_ASSERT_FALSE(ColorCorrection::FromStrings("2.2x", "", &correction));
+  OLA_ASSERT_FALSE(ColorCorrection::FromStrings("0", "", &correction));
+  OLA_ASSERT_FALSE(ColorCorrection::FromStrings("10", "", &correction));
+  OLA_ASSERT_FALSE(ColorCorrection::FromStrings("", "255,255", &correction));
+  OLA_ASSERT_FALSE(ColorCorrection::FromStrings("", "255,255,256",
+                                                &correction));
+  OLA_ASSERT_FALSE(ColorCorrection::FromStrings("", "255,255,255,255",
+                                                &correction));
+  OLA_ASSERT_EQ(1.0, correction.Gamma());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(128), correction.Table(1)[255]);
+}
@@ -0,0 +1,117 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DeltaEncoder.cpp
+ * The Delta Encoder
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <ola/dmx/DeltaEncoder.h>
+
+namespace ola {
+namespace dmx {
+
+namespace {
+unsigned int ReadShort(const uint8_t *data) {
+  return (static_cast<unsigned int>(data[0]) << 8) | data[1];
+}
+}  // namespace
+
+bool DeltaEncoder::Encode(const uint8_t *previous,
+                          const uint8_t *current,
+                          unsigned int length,
+                          uint8_t *data,
+                          unsigned int *data_size) {
+  unsigned int dst_size = *data_size;
+  unsigned int &dst_index = *data_size;
+  dst_index = 0;
+
+  unsigned int i = 0;
+  while (i < length) {
+    if (previous[i] == current[i]) {
+      i++;
+      continue;
+    }
+
+    // i is the first changed slot, find the end of the range. A gap of
+    // unchanged slots no larger than a range header is cheaper to send than
+    // to skip.
+    unsigned int end = i + 1;
+    for (unsigned int j = end; j < length && j - end <= RANGE_HEADER_SIZE;
+         j++) {
+      if (previous[j] != current[j]) {
+        end = j + 1;
+      }
+    }
+
+    const unsigned int range_length = end - i;
+    if (dst_size - dst_index < RANGE_HEADER_SIZE + range_length) {
+      return false;
+    }
+    data[dst_index++] = static_cast<uint8_t>(i >> 8);
+    data[dst_index++] = static_cast<uint8_t>(i);
+    data[dst_index++] = static_cast<uint8_t>(range_length >> 8);
+    data[dst_index++] = static_cast<uint8_t>(range_length);
+    memcpy(data + dst_index, current + i, range_length);
+    dst_index += range_length;
+    i = end;
+  }
+  return true;
+}
+
+
+bool DeltaEncoder::Decode(const uint8_t *data,
+                          unsigned int length,
+                          DmxBuffer *output) {
+  if (!Validate(data, length, output->Size())) {
+    return false;
+  }
+
+  unsigned int i = 0;
+  while (i < length) {
+    const unsigned int offset = ReadShort(data + i);
+    const unsigned int range_length = ReadShort(data + i + 2);
+    i += RANGE_HEADER_SIZE;
+    output->SetRange(offset, data + i, range_length);
+    i += range_length;
+  }
+  return true;
+}
+
+
+/*
+ * Check that all the ranges are complete and within the frame.
+ */
+bool DeltaEncoder::Validate(const uint8_t *data, unsigned int length,
+                            unsigned int slot_count) const {
+  unsigned int i = 0;
+  while (i < length) {
+    if (length - i < RANGE_HEADER_SIZE) {
+      return false;
+    }
+    const unsigned int offset = ReadShort(data + i);
+    const unsigned int range_length = ReadShort(data + i + 2);
+    i += RANGE_HEADER_SIZE;
+    if (range_length == 0 || range_length > length - i ||
+        offset + range_length > slot_count) {
+      return false;
+    }
+    i += range_length;
+  }
+  return true;
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,189 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DeltaEncoderTest.cpp
+ * Test fixture for the DeltaEncoder class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <string>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/DeltaEncoder.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::dmx::DeltaEncoder;
+using ola::DmxBuffer;
+using std::string;
+
+class DeltaEncoderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DeltaEncoderTest);
+  CPPUNIT_TEST(testEncode);
+  CPPUNIT_TEST(testEncodeFull);
+  CPPUNIT_TEST(testDecode);
+  CPPUNIT_TEST(testEncodeDecode);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testEncode();
+    void testEncodeFull();
+    void testDecode();
+    void testEncodeDecode();
+
+ private:
+    DeltaEncoder m_encoder;
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DeltaEncoderTest);
+
+
+/*
+ * Check that the changed slots are encoded as ranges.
+ */
+void DeltaEncoderTest::testEncode() {
+  uint8_t previous[20];
+  uint8_t current[20];
+  uint8_t data[ola::DMX_UNIVERSE_SIZE];
+  memset(previous, 0, sizeof(previous));
+  memcpy(current, previous, sizeof(current));
+
+  // Nothing changed
+  unsigned int size = sizeof(data);
+  OLA_ASSERT_TRUE(m_encoder.Encode(previous, current, sizeof(current), data,
+                                   &size));
+  OLA_ASSERT_EQ(0u, size);
+
+  // A single slot
+  current[3] = 10;
+  size = sizeof(data);
+  OLA_ASSERT_TRUE(m_encoder.Encode(previous, current, sizeof(current), data,
+                                   &size));
+  const uint8_t expected1[] = {0, 3, 0, 1, 10};
+  OLA_ASSERT_DATA_EQUALS(expected1, sizeof(expected1), data, size);
+
+  // A small gap is merged into a single range, a large one isn't
+  current[5] = 11;
+  current[15] = 12;
+  current[19] = 13;
+  size = sizeof(data);
+  OLA_ASSERT_TRUE(m_encoder.Encode(previous, current, sizeof(current), data,
+                                   &size));
+  const uint8_t expected2[] = {
+    0, 3, 0, 3, 10, 0, 11,
+    0, 15, 0, 5, 12, 0, 0, 0, 13};
+  OLA_ASSERT_DATA_EQUALS(expected2, sizeof(expected2), data, size);
+
+  // Not enough space
+  size = 10;
+  OLA_ASSERT_FALSE(m_encoder.Encode(previous, current, sizeof(current), data,
+                                    &size));
+}
+
+
+/*
+ * Check a frame where every slot changed.
+ */
+void DeltaEncoderTest::testEncodeFull() {
+  uint8_t previous[ola::DMX_UNIVERSE_SIZE];
+  uint8_t current[ola::DMX_UNIVERSE_SIZE];
+  uint8_t data[ola::DMX_UNIVERSE_SIZE + DeltaEncoder::RANGE_HEADER_SIZE];
+  memset(previous, 0, sizeof(previous));
+  memset(current, 1, sizeof(current));
+
+  // This is larger than the frame itself
+  unsigned int size = ola::DMX_UNIVERSE_SIZE;
+  OLA_ASSERT_FALSE(m_encoder.Encode(previous, current, sizeof(current), data,
+                                    &size));
+
+  size = sizeof(data);
+  OLA_ASSERT_TRUE(m_encoder.Encode(previous, current, sizeof(current), data,
+                                   &size));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(sizeof(data)), size);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), data[0]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), data[1]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(2), data[2]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), data[3]);
+}
+
+
+/*
+ * Check that malformed data is rejected.
+ */
+void DeltaEncoderTest::testDecode() {
+  DmxBuffer buffer;
+  buffer.SetFromString("0,0,0,0,0");
+
+  // No ranges is fine
+  OLA_ASSERT_TRUE(m_encoder.Decode(NULL, 0, &buffer));
+  OLA_ASSERT_EQ(string("0,0,0,0,0"), buffer.ToString());
+
+  const uint8_t ranges[] = {0, 1, 0, 2, 5, 6, 0, 4, 0, 1, 7};
+  OLA_ASSERT_TRUE(m_encoder.Decode(ranges, sizeof(ranges), &buffer));
+  OLA_ASSERT_EQ(string("0,5,6,0,7"), buffer.ToString());
+
+  // Truncated header
+  const uint8_t truncated_header[] = {0, 1, 0, 2, 1, 1, 0, 4};
+  OLA_ASSERT_FALSE(m_encoder.Decode(truncated_header,
+                                    sizeof(truncated_header), &buffer));
+
+  // Truncated data
+  const uint8_t truncated_data[] = {0, 1, 0, 2, 1};
+  OLA_ASSERT_FALSE(m_encoder.Decode(truncated_data, sizeof(truncated_data),
+                                    &buffer));
+
+  // Past the end of the buffer, the earlier range isn't applied
+  const uint8_t past_end[] = {0, 0, 0, 1, 9, 0, 4, 0, 2, 1, 1};
+  OLA_ASSERT_FALSE(m_encoder.Decode(past_end, sizeof(past_end), &buffer));
+
+  // Empty range
+  const uint8_t empty_range[] = {0, 0, 0, 0};
+  OLA_ASSERT_FALSE(m_encoder.Decode(empty_range, sizeof(empty_range),
+                                    &buffer));
+  OLA_ASSERT_EQ(string("0,5,6,0,7"), buffer.ToString());
+}
+
+
+/*
+ * Check that decoding a delta produces the new frame.
+ */
+void DeltaEncoderTest::testEncodeDecode() {
+  uint8_t previous[ola::DMX_UNIVERSE_SIZE];
+  uint8_t current[ola::DMX_UNIVERSE_SIZE];
+  uint8_t data[ola::DMX_UNIVERSE_SIZE];
+  for (unsigned int i = 0; i < sizeof(previous); i++) {
+    previous[i] = i;
+  }
+  memcpy(current, previous, sizeof(current));
+  current[0] = 100;
+  current[1] = 101;
+  current[200] = 1;
+  current[206] = 2;
+  current[511] = 3;
+
+  unsigned int size = sizeof(data);
+  OLA_ASSERT_TRUE(m_encoder.Encode(previous, current, sizeof(current), data,
+                                   &size));
+  OLA_ASSERT_TRUE(size < 30);
+
+  DmxBuffer buffer(previous, sizeof(previous));
+  OLA_ASSERT_TRUE(m_encoder.Decode(data, size, &buffer));
+  OLA_ASSERT_DATA_EQUALS(current, sizeof(current), buffer.GetRaw(),
+                         buffer.Size());
+}
@@ -0,0 +1,319 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxFrameScheduler.cpp
+ * Generates the DMX frame timing for outputs where the host drives the line.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/dmx/DmxFrameScheduler.h"
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/thread/Utils.h"
+
+namespace ola {
+namespace dmx {
+
+using ola::Clock;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::thread::MutexLocker;
+using std::string;
+
+namespace {
+
+const int64_t USEC_PER_SEC = 1000000;
+
+/*
+ * How far ahead of a deadline the thread stops waiting on the condition
+ * variable and switches to clock_nanosleep().
+ */
+const int64_t WAKE_UP_MARGIN = 2000;
+
+/*
+ * The monotonic time in microseconds.
+ */
+int64_t MonotonicTime(const Clock &clock) {
+  TimeStamp now;
+  clock.CurrentMonotonicTime(&now);
+  return static_cast<int64_t>(now.Seconds()) * USEC_PER_SEC +
+         now.MicroSeconds();
+}
+
+/*
+ * Sleep until the monotonic time reaches wake_up.
+ */
+void SleepUntil(const Clock &clock, int64_t wake_up) {
+#if defined(HAVE_CLOCK_NANOSLEEP) && defined(CLOCK_MONOTONIC)
+  (void) clock;
+  struct timespec ts;
+  ts.tv_sec = static_cast<time_t>(wake_up / USEC_PER_SEC);
+  ts.tv_nsec = static_cast<long>(wake_up % USEC_PER_SEC) * 1000;  // NOLINT
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) ==
+         EINTR) {
+  }
+#else
+  const int64_t delay = wake_up - MonotonicTime(clock);
+  if (delay > 0) {
+    usleep(static_cast<useconds_t>(delay));
+  }
+#endif  // HAVE_CLOCK_NANOSLEEP
+}
+}  // namespace
+
+const char DmxFrameScheduler::FRAME_JITTER_VAR[] = "dmx-frame-jitter-us-";
+const char DmxFrameScheduler::FRAME_OVERRUN_VAR[] = "dmx-frame-overruns";
+const char DmxFrameScheduler::OUTPUT_KEY[] = "output";
+
+const unsigned int DmxFrameScheduler::DEFAULT_BREAK_TIME;
+const unsigned int DmxFrameScheduler::DEFAULT_MAB_TIME;
+const unsigned int DmxFrameScheduler::MIN_FRAME_TIME;
+
+struct DmxFrameScheduler::Output {
+  DmxSerialWriter *writer;
+  OutputOptions options;
+  DmxBuffer buffer;  // GUARDED_BY(m_mutex)
+  // The rest is only used by the scheduler thread once the output is added.
+  int64_t deadline;
+  int64_t period;
+  bool setup_done;
+  HistogramVariable *jitter;
+  UIntMapHandle overruns;
+};
+
+
+DmxFrameScheduler::DmxFrameScheduler(const Options &options,
+                                     ExportMap *export_map)
+    : Thread(Thread::Options("dmx-frame-scheduler")),
+      m_options(options),
+      m_export_map(export_map),
+      m_exit(false),
+      m_active_writer(NULL) {
+}
+
+DmxFrameScheduler::~DmxFrameScheduler() {
+  Stop();
+  Outputs::iterator iter = m_outputs.begin();
+  for (; iter != m_outputs.end(); ++iter) {
+    delete *iter;
+  }
+}
+
+bool DmxFrameScheduler::Start() {
+  {
+    MutexLocker lock(&m_mutex);
+    m_exit = false;
+  }
+  return Thread::Start();
+}
+
+bool DmxFrameScheduler::Stop() {
+  if (!IsRunning()) {
+    return true;
+  }
+  {
+    MutexLocker lock(&m_mutex);
+    m_exit = true;
+  }
+  m_cond_var.Signal();
+  return Join();
+}
+
+void DmxFrameScheduler::AddOutput(DmxSerialWriter *writer,
+                                  const OutputOptions &options) {
+  Output *output = new Output();
+  output->writer = writer;
+  output->options = options;
+  output->period = 0;
+  if (options.frame_rate) {
+    output->period = std::max(USEC_PER_SEC / options.frame_rate,
+                              static_cast<int64_t>(MIN_FRAME_TIME));
+  }
+  output->deadline = MonotonicTime(Clock());
+  output->setup_done = false;
+  output->jitter = NULL;
+  if (m_export_map) {
+    const string name = options.name.empty() ? writer->Description() :
+                        options.name;
+    output->jitter = m_export_map->GetHistogramVar(FRAME_JITTER_VAR + name);
+    output->overruns = m_export_map->GetUIntMapVar(
+        FRAME_OVERRUN_VAR, OUTPUT_KEY)->GetHandle(name);
+  }
+
+  {
+    MutexLocker lock(&m_mutex);
+    m_outputs.push_back(output);
+  }
+  m_cond_var.Signal();
+}
+
+void DmxFrameScheduler::RemoveOutput(DmxSerialWriter *writer) {
+  MutexLocker lock(&m_mutex);
+  while (m_active_writer == writer) {
+    m_idle_cond_var.Wait(&m_mutex);
+  }
+
+  Outputs::iterator iter = m_outputs.begin();
+  for (; iter != m_outputs.end(); ++iter) {
+    if ((*iter)->writer == writer) {
+      delete *iter;
+      m_outputs.erase(iter);
+      return;
+    }
+  }
+}
+
+bool DmxFrameScheduler::WriteDMX(DmxSerialWriter *writer,
+                                 const DmxBuffer &buffer) {
+  MutexLocker lock(&m_mutex);
+  Outputs::iterator iter = m_outputs.begin();
+  for (; iter != m_outputs.end(); ++iter) {
+    if ((*iter)->writer == writer) {
+      // Take a copy of the data, since the buffer is read by another thread.
+      (*iter)->buffer.Set(buffer.GetRaw(), buffer.Size());
+      return true;
+    }
+  }
+  return false;
+}
+
+void *DmxFrameScheduler::Run() {
+  if (m_options.realtime_priority > 0) {
+    struct sched_param param;
+    param.sched_priority = m_options.realtime_priority;
+    if (ola::thread::SetSchedParam(pthread_self(), SCHED_FIFO, param)) {
+      OLA_INFO << "DMX frame scheduler using SCHED_FIFO, priority "
+               << param.sched_priority;
+    } else {
+      OLA_WARN << "Failed to set SCHED_FIFO for the DMX frame scheduler, "
+               << "frame timing may be less accurate";
+    }
+  }
+
+  Clock clock;
+  DmxBuffer buffer;
+  m_mutex.Lock();
+  while (!m_exit) {
+    Output *output = NextOutput();
+    if (!output) {
+      m_cond_var.Wait(&m_mutex);
+      continue;
+    }
+
+    // Wait on the condition variable while the deadline is a long way off,
+    // so new outputs & Stop() are handled promptly. The last part of the wait
+    // uses clock_nanosleep(), which is far more accurate.
+    const int64_t wait = output->deadline - MonotonicTime(clock);
+    if (wait > WAKE_UP_MARGIN) {
+      TimeStamp wake_up;
+      clock.CurrentRealTime(&wake_up);
+      wake_up += TimeInterval(wait - WAKE_UP_MARGIN);
+      m_cond_var.TimedWait(&m_mutex, wake_up);
+      continue;
+    }
+
+    m_active_writer = output->writer;
+    buffer.Set(output->buffer.GetRaw(), output->buffer.Size());
+    m_mutex.Unlock();
+
+    SendFrame(output, buffer, clock);
+
+    m_mutex.Lock();
+    m_active_writer = NULL;
+    m_idle_cond_var.Broadcast();
+  }
+  m_mutex.Unlock();
+  return NULL;
+}
+
+/*
+ * Return the output with the earliest deadline.
+ */
+DmxFrameScheduler::Output *DmxFrameScheduler::NextOutput() {
+  Output *next = NULL;
+  Outputs::iterator iter = m_outputs.begin();
+  for (; iter != m_outputs.end(); ++iter) {
+    if (!next || (*iter)->deadline < next->deadline) {
+      next = *iter;
+    }
+  }
+  return next;
+}
+
+/*
+ * Send a single frame and work out the deadline for the next one.
+ */
+void DmxFrameScheduler::SendFrame(Output *output, const DmxBuffer &buffer,
+                                  const Clock &clock) {
+  DmxSerialWriter *writer = output->writer;
+  const OutputOptions &options = output->options;
+
+  if (!output->setup_done) {
+    output->setup_done = true;
+    if (!writer->IsOpen()) {
+      writer->SetupOutput();
+    }
+    // Opening the device can take a while, and the output may have been
+    // added before the thread started, so the schedule starts from now.
+    output->deadline = MonotonicTime(clock);
+  }
+
+  SleepUntil(clock, output->deadline);
+  const int64_t start = MonotonicTime(clock);
+  if (output->jitter) {
+    output->jitter->Record(
+        start > output->deadline ? start - output->deadline : 0);
+  }
+
+  if (writer->SetBreak(true)) {
+    SleepUntil(clock, start + options.break_time);
+    if (writer->SetBreak(false)) {
+      SleepUntil(clock, start + options.break_time + options.mab_time);
+      writer->Write(buffer);
+    }
+  }
+
+  // Without a frame rate or mark after frame, a writer that returns
+  // straight away, e.g. because the device has gone, would otherwise keep
+  // the thread spinning.
+  const int64_t end = MonotonicTime(clock);
+  int64_t next = std::max(end + options.mark_after_frame,
+                          start + static_cast<int64_t>(MIN_FRAME_TIME));
+  if (output->period) {
+    if (next > output->deadline + output->period) {
+      // We've missed the next deadline, so start from now rather than trying
+      // to catch up.
+      output->overruns.Increment();
+    } else {
+      next = output->deadline + output->period;
+    }
+  }
+  output->deadline = next;
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,187 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxFrameScheduler.h
+ * Generates the DMX frame timing for outputs where the host drives the line.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_DMX_DMXFRAMESCHEDULER_H_
+#define COMMON_DMX_DMXFRAMESCHEDULER_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Thread.h"
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief The interface for a serial line that the DmxFrameScheduler drives.
+ */
+class DmxSerialWriter {
+ public:
+  virtual ~DmxSerialWriter() {}
+
+  virtual std::string Description() const = 0;
+  virtual bool IsOpen() const = 0;
+  virtual bool SetupOutput() = 0;
+  virtual bool SetBreak(bool on) = 0;
+  /**
+   * @brief Send the data, this is called from the scheduler thread.
+   */
+  virtual bool Write(const ola::DmxBuffer &data) = 0;
+};
+
+
+/**
+ * @brief Sends DMX frames on a set of DmxSerialWriters from a single thread.
+ *
+ * Each output has its own frame deadline. The thread sleeps until the
+ * earliest deadline with clock_nanosleep(TIMER_ABSTIME) on CLOCK_MONOTONIC,
+ * and then sends the break, mark after break and data for that output. The
+ * deadlines advance by the frame period, so the rate doesn't drift with the
+ * time taken to send each frame.
+ *
+ * How late each frame starts, in microseconds, is exported as the
+ * dmx-frame-jitter-us-<output> histogram, and frames which couldn't be sent
+ * within the period are counted in dmx-frame-overruns.
+ *
+ * The outputs are sent one after another, so a DmxSerialWriter that blocks,
+ * e.g. in ftdi_write_data(), delays every other output on the same scheduler.
+ * Frames that start late because of this are counted in dmx-frame-overruns
+ * too. Writers that may block should use a scheduler of their own.
+ */
+class DmxFrameScheduler : private ola::thread::Thread {
+ public:
+  struct Options {
+    /**
+     * @brief The SCHED_FIFO priority for the thread, or 0 to use the default
+     *   scheduling.
+     */
+    int realtime_priority;
+
+    Options() : realtime_priority(0) {}
+  };
+
+  struct OutputOptions {
+    /** @brief The break time in microseconds. */
+    unsigned int break_time;
+    /** @brief The mark after break time in microseconds. */
+    unsigned int mab_time;
+    /**
+     * @brief The minimum time between the end of one frame and the start of
+     *   the next one, in microseconds.
+     */
+    unsigned int mark_after_frame;
+    /**
+     * @brief The frames per second, 0 sends frames as fast as the timings
+     *   allow. Frames never start less than MIN_FRAME_TIME apart.
+     */
+    unsigned int frame_rate;
+    /**
+     * @brief The name used in the exported variables, if empty the writer's
+     *   Description() is used.
+     */
+    std::string name;
+
+    OutputOptions()
+        : break_time(DEFAULT_BREAK_TIME),
+          mab_time(DEFAULT_MAB_TIME),
+          mark_after_frame(0),
+          frame_rate(0) {
+    }
+  };
+
+  explicit DmxFrameScheduler(const Options &options,
+                             ExportMap *export_map = NULL);
+  ~DmxFrameScheduler();
+
+  /**
+   * @brief Start the scheduler thread.
+   */
+  bool Start();
+
+  /**
+   * @brief Stop the scheduler thread.
+   */
+  bool Stop();
+
+  /**
+   * @brief Start sending frames on an output.
+   * @param writer the output, ownership isn't transferred.
+   * @param options the timing for the output.
+   */
+  void AddOutput(DmxSerialWriter *writer, const OutputOptions &options);
+
+  /**
+   * @brief Stop sending frames on an output.
+   *
+   * Once this returns the scheduler won't use the writer again.
+   */
+  void RemoveOutput(DmxSerialWriter *writer);
+
+  /**
+   * @brief Set the data to send on an output.
+   * @returns false if the output wasn't added.
+   */
+  bool WriteDMX(DmxSerialWriter *writer, const DmxBuffer &buffer);
+
+  static const unsigned int DEFAULT_BREAK_TIME = 110;
+  static const unsigned int DEFAULT_MAB_TIME = 16;
+  /**
+   * @brief The minimum time from the start of one frame to the start of the
+   *   next, in microseconds. This is the minimum break to break time from
+   *   E1.11.
+   */
+  static const unsigned int MIN_FRAME_TIME = 1204;
+
+ protected:
+  void *Run();
+
+ private:
+  struct Output;
+  typedef std::vector<Output*> Outputs;
+
+  const Options m_options;
+  ExportMap *m_export_map;
+  ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_cond_var;
+  // Signalled when the thread finishes with an output.
+  ola::thread::ConditionVariable m_idle_cond_var;
+  bool m_exit;  // GUARDED_BY(m_mutex)
+  Outputs m_outputs;  // GUARDED_BY(m_mutex)
+  DmxSerialWriter *m_active_writer;  // GUARDED_BY(m_mutex)
+
+  Output *NextOutput();
+  void SendFrame(Output *output, const DmxBuffer &buffer,
+                 const ola::Clock &clock);
+
+  static const char FRAME_JITTER_VAR[];
+  static const char FRAME_OVERRUN_VAR[];
+  static const char OUTPUT_KEY[];
+
+  DISALLOW_COPY_AND_ASSIGN(DmxFrameScheduler);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // COMMON_DMX_DMXFRAMESCHEDULER_H_
@@ -0,0 +1,398 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxFrameSchedulerTest.cpp
+ * Test fixture for the DmxFrameScheduler class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <unistd.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/dmx/DmxFrameScheduler.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Mutex.h"
+
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::ExportMap;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::dmx::DmxFrameScheduler;
+using ola::dmx::DmxSerialWriter;
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+/*
+ * Records when each frame starts.
+ */
+class FakeSerialWriter: public DmxSerialWriter {
+ public:
+  explicit FakeSerialWriter(const string &description)
+      : m_description(description),
+        m_open(false),
+        m_break(false),
+        m_setup_count(0),
+        m_writes_during_break(0),
+        m_write_delay(0) {
+  }
+
+  string Description() const { return m_description; }
+
+  bool IsOpen() const {
+    MutexLocker lock(&m_mutex);
+    return m_open;
+  }
+
+  bool SetupOutput() {
+    MutexLocker lock(&m_mutex);
+    m_setup_count++;
+    m_open = true;
+    return true;
+  }
+
+  bool SetBreak(bool on) {
+    MutexLocker lock(&m_mutex);
+    if (on && !m_break) {
+      TimeStamp now;
+      m_clock.CurrentMonotonicTime(&now);
+      m_frame_starts.push_back(now);
+    }
+    m_break = on;
+    return true;
+  }
+
+  bool Write(const DmxBuffer &data) {
+    MutexLocker lock(&m_mutex);
+    // This runs on the scheduler thread, so the test checks the count.
+    if (m_break) {
+      m_writes_during_break++;
+    }
+    m_last_data = data;
+    if (m_write_delay) {
+      usleep(m_write_delay);
+    }
+    m_cond_var.Broadcast();
+    return true;
+  }
+
+  /*
+   * Make Write() block for a while, like ftdi_write_data() does.
+   */
+  void SetWriteDelay(useconds_t delay) {
+    MutexLocker lock(&m_mutex);
+    m_write_delay = delay;
+  }
+
+  /*
+   * Wait until frame_count frames have been written.
+   */
+  bool WaitForFrames(unsigned int frame_count) {
+    MutexLocker lock(&m_mutex);
+    TimeStamp wake_up;
+    Clock().CurrentRealTime(&wake_up);
+    wake_up += TimeInterval(10, 0);
+    while (m_frame_starts.size() < frame_count) {
+      if (!m_cond_var.TimedWait(&m_mutex, wake_up)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  vector<TimeStamp> FrameStarts() const {
+    MutexLocker lock(&m_mutex);
+    return m_frame_starts;
+  }
+
+  unsigned int FrameCount() const {
+    MutexLocker lock(&m_mutex);
+    return m_frame_starts.size();
+  }
+
+  unsigned int SetupCount() const {
+    MutexLocker lock(&m_mutex);
+    return m_setup_count;
+  }
+
+  unsigned int WritesDuringBreak() const {
+    MutexLocker lock(&m_mutex);
+    return m_writes_during_break;
+  }
+
+  DmxBuffer LastData() const {
+    MutexLocker lock(&m_mutex);
+    return DmxBuffer(m_last_data.GetRaw(), m_last_data.Size());
+  }
+
+ private:
+  const string m_description;
+  Clock m_clock;
+  mutable ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_cond_var;
+  bool m_open;
+  bool m_break;
+  unsigned int m_setup_count;
+  unsigned int m_writes_during_break;
+  useconds_t m_write_delay;
+  vector<TimeStamp> m_frame_starts;
+  DmxBuffer m_last_data;
+};
+
+
+class DmxFrameSchedulerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DmxFrameSchedulerTest);
+  CPPUNIT_TEST(testFrameRate);
+  CPPUNIT_TEST(testMarkAfterFrame);
+  CPPUNIT_TEST(testMinimumFrameTime);
+  CPPUNIT_TEST(testMultipleOutputs);
+  CPPUNIT_TEST(testRemoveOutput);
+  CPPUNIT_TEST(testBlockingWriter);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testFrameRate();
+    void testMarkAfterFrame();
+    void testMinimumFrameTime();
+    void testMultipleOutputs();
+    void testRemoveOutput();
+    void testBlockingWriter();
+
+ private:
+    static vector<int64_t> FramePeriods(const vector<TimeStamp> &starts);
+    static int64_t Percentile(vector<int64_t> values, unsigned int percentile);
+
+    // The most a frame period can be off by, in microseconds.
+    static const int64_t MAX_JITTER = 1000;
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DmxFrameSchedulerTest);
+
+
+/*
+ * Return the time between each frame start, in microseconds.
+ */
+vector<int64_t> DmxFrameSchedulerTest::FramePeriods(
+    const vector<TimeStamp> &starts) {
+  vector<int64_t> periods;
+  for (unsigned int i = 1; i < starts.size(); i++) {
+    periods.push_back((starts[i] - starts[i - 1]).AsInt());
+  }
+  return periods;
+}
+
+
+/*
+ * Return a percentile of the values.
+ */
+int64_t DmxFrameSchedulerTest::Percentile(vector<int64_t> values,
+                                          unsigned int percentile) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() * percentile / 100];
+}
+
+
+/*
+ * Check frames are sent at the requested rate, and the jitter is bounded.
+ */
+void DmxFrameSchedulerTest::testFrameRate() {
+  ExportMap export_map;
+  FakeSerialWriter writer("fake");
+  DmxFrameScheduler scheduler((DmxFrameScheduler::Options()), &export_map);
+  DmxFrameScheduler::OutputOptions options;
+  options.frame_rate = 100;
+  scheduler.AddOutput(&writer, options);
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  OLA_ASSERT_TRUE(scheduler.WriteDMX(&writer, buffer));
+  OLA_ASSERT_TRUE(scheduler.Start());
+
+  const unsigned int frame_count = 50;
+  OLA_ASSERT_TRUE(writer.WaitForFrames(frame_count));
+  OLA_ASSERT_TRUE(scheduler.Stop());
+
+  OLA_ASSERT_EQ(1u, writer.SetupCount());
+  OLA_ASSERT_EQ(buffer, writer.LastData());
+  OLA_ASSERT_EQ(0u, writer.WritesDuringBreak());
+
+  // Check the frame period, allowing for the odd frame which is delayed
+  // because the machine is busy.
+  const vector<int64_t> periods = FramePeriods(writer.FrameStarts());
+  const int64_t expected_period = 10000;
+  OLA_ASSERT_TRUE(Percentile(periods, 50) > expected_period * 98 / 100);
+  OLA_ASSERT_TRUE(Percentile(periods, 50) < expected_period * 102 / 100);
+  unsigned int late_frames = 0;
+  for (unsigned int i = 0; i < periods.size(); i++) {
+    if (periods[i] < expected_period - MAX_JITTER ||
+        periods[i] > expected_period + MAX_JITTER) {
+      late_frames++;
+    }
+  }
+  OLA_ASSERT_LT(late_frames, static_cast<unsigned int>(periods.size() / 4));
+
+  ola::HistogramVariable *jitter = export_map.GetHistogramVar(
+      "dmx-frame-jitter-us-fake");
+  OLA_ASSERT_TRUE(jitter->Count() >= frame_count);
+}
+
+
+/*
+ * Check an output without a frame rate waits for the mark after frame time.
+ */
+void DmxFrameSchedulerTest::testMarkAfterFrame() {
+  FakeSerialWriter writer("fake");
+  DmxFrameScheduler scheduler((DmxFrameScheduler::Options()));
+  DmxFrameScheduler::OutputOptions options;
+  options.break_time = 100;
+  options.mab_time = 20;
+  options.mark_after_frame = 2000;
+  scheduler.AddOutput(&writer, options);
+  OLA_ASSERT_TRUE(scheduler.Start());
+  OLA_ASSERT_TRUE(writer.WaitForFrames(20));
+  OLA_ASSERT_TRUE(scheduler.Stop());
+
+  const vector<int64_t> periods = FramePeriods(writer.FrameStarts());
+  for (unsigned int i = 0; i < periods.size(); i++) {
+    OLA_ASSERT_TRUE(periods[i] >= 2120);
+  }
+}
+
+
+/*
+ * Check an output without any frame timing doesn't send back to back frames.
+ */
+void DmxFrameSchedulerTest::testMinimumFrameTime() {
+  FakeSerialWriter writer("fake");
+  DmxFrameScheduler scheduler((DmxFrameScheduler::Options()));
+  DmxFrameScheduler::OutputOptions options;
+  options.break_time = 0;
+  options.mab_time = 0;
+  scheduler.AddOutput(&writer, options);
+  OLA_ASSERT_TRUE(scheduler.Start());
+  OLA_ASSERT_TRUE(writer.WaitForFrames(20));
+  OLA_ASSERT_TRUE(scheduler.Stop());
+
+  const vector<int64_t> periods = FramePeriods(writer.FrameStarts());
+  for (unsigned int i = 0; i < periods.size(); i++) {
+    OLA_ASSERT_TRUE(periods[i] >=
+                    static_cast<int64_t>(DmxFrameScheduler::MIN_FRAME_TIME));
+  }
+}
+
+
+/*
+ * Check a single scheduler runs several outputs at their own rates.
+ */
+void DmxFrameSchedulerTest::testMultipleOutputs() {
+  FakeSerialWriter fast_writer("fast"), slow_writer("slow");
+  DmxFrameScheduler scheduler((DmxFrameScheduler::Options()));
+  DmxFrameScheduler::OutputOptions options;
+  options.frame_rate = 40;
+  scheduler.AddOutput(&fast_writer, options);
+  options.frame_rate = 20;
+  scheduler.AddOutput(&slow_writer, options);
+
+  DmxBuffer fast_data, slow_data;
+  fast_data.SetFromString("1,2,3,4");
+  slow_data.SetFromString("10,20");
+  OLA_ASSERT_TRUE(scheduler.WriteDMX(&fast_writer, fast_data));
+  OLA_ASSERT_TRUE(scheduler.WriteDMX(&slow_writer, slow_data));
+  OLA_ASSERT_TRUE(scheduler.Start());
+
+  OLA_ASSERT_TRUE(slow_writer.WaitForFrames(10));
+  OLA_ASSERT_TRUE(fast_writer.WaitForFrames(20));
+  OLA_ASSERT_TRUE(scheduler.Stop());
+
+  OLA_ASSERT_EQ(fast_data, fast_writer.LastData());
+  OLA_ASSERT_EQ(slow_data, slow_writer.LastData());
+  OLA_ASSERT_EQ(0u, fast_writer.WritesDuringBreak());
+  OLA_ASSERT_EQ(0u, slow_writer.WritesDuringBreak());
+
+  const int64_t fast_period = Percentile(
+      FramePeriods(fast_writer.FrameStarts()), 50);
+  const int64_t slow_period = Percentile(
+      FramePeriods(slow_writer.FrameStarts()), 50);
+  OLA_ASSERT_TRUE(fast_period > 24500 && fast_period < 25500);
+  OLA_ASSERT_TRUE(slow_period > 49000 && slow_period < 51000);
+
+  // Outputs that aren't known are rejected.
+  FakeSerialWriter other_writer("other");
+  OLA_ASSERT_FALSE(scheduler.WriteDMX(&other_writer, fast_data));
+}
+
+
+/*
+ * Check no frames are sent once an output is removed.
+ */
+void DmxFrameSchedulerTest::testRemoveOutput() {
+  FakeSerialWriter writer1("one"), writer2("two");
+  DmxFrameScheduler scheduler((DmxFrameScheduler::Options()));
+  DmxFrameScheduler::OutputOptions options;
+  options.frame_rate = 200;
+  scheduler.AddOutput(&writer1, options);
+  scheduler.AddOutput(&writer2, options);
+  OLA_ASSERT_TRUE(scheduler.Start());
+  OLA_ASSERT_TRUE(writer1.WaitForFrames(5));
+
+  scheduler.RemoveOutput(&writer1);
+  const unsigned int frame_count = writer1.FrameCount();
+  const unsigned int writer2_count = writer2.FrameCount();
+  OLA_ASSERT_TRUE(writer2.WaitForFrames(writer2_count + 10));
+  OLA_ASSERT_EQ(frame_count, writer1.FrameCount());
+
+  DmxBuffer buffer;
+  OLA_ASSERT_FALSE(scheduler.WriteDMX(&writer1, buffer));
+  OLA_ASSERT_TRUE(scheduler.Stop());
+}
+
+
+/*
+ * Check that a writer which blocks delays the other outputs on the same
+ * scheduler, and that the missed frames are counted as overruns.
+ */
+void DmxFrameSchedulerTest::testBlockingWriter() {
+  ExportMap export_map;
+  FakeSerialWriter blocking_writer("blocking"), writer("other");
+  blocking_writer.SetWriteDelay(30000);
+  DmxFrameScheduler scheduler((DmxFrameScheduler::Options()), &export_map);
+  DmxFrameScheduler::OutputOptions options;
+  options.frame_rate = 40;
+  scheduler.AddOutput(&blocking_writer, options);
+  scheduler.AddOutput(&writer, options);
+  OLA_ASSERT_TRUE(scheduler.Start());
+  OLA_ASSERT_TRUE(writer.WaitForFrames(10));
+  OLA_ASSERT_TRUE(scheduler.Stop());
+
+  // Each output waits for the other one's 30ms write, so neither can keep
+  // up with the 25ms period.
+  const int64_t period = Percentile(FramePeriods(writer.FrameStarts()), 50);
+  OLA_ASSERT_TRUE(period > 30000);
+
+  ola::UIntMap *overruns = export_map.GetUIntMapVar("dmx-frame-overruns",
+                                                    "output");
+  OLA_ASSERT_TRUE((*overruns)["other"] > 0);
+  OLA_ASSERT_TRUE((*overruns)["blocking"] > 0);
+  OLA_ASSERT_EQ(0u, writer.WritesDuringBreak());
+}
@@ -0,0 +1,271 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HTPMerge.cpp
+ * Multi-source HTP merge kernels.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * Each kernel walks the slots once, taking the max of a block of slots from
+ * every input before storing the block. This means the output can alias any
+ * of the inputs.
+ *
+ * The SIMD kernels are compiled with per-function target attributes so we
+ * don't need special compiler flags, the one to use is picked at runtime
+ * based on what the CPU supports.
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+#include "common/dmx/HTPMerge.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OLA_HTP_MERGE_X86
+#include <immintrin.h>
+#endif  // defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OLA_HTP_MERGE_NEON
+#include <arm_neon.h>
+#endif  // defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+namespace ola {
+namespace dmx {
+
+using std::max;
+using std::min;
+using std::string;
+
+namespace {
+
+typedef void (*MergeFunction)(const uint8_t *const *inputs,
+                              unsigned int input_count,
+                              unsigned int length,
+                              uint8_t *output);
+
+const unsigned int SCALAR_BLOCK_SIZE = 64;
+
+/*
+ * Merge slots [offset, length) a block at a time. This is used on its own
+ * and to handle the tail for the SIMD kernels.
+ */
+void ScalarMergeFrom(const uint8_t *const *inputs,
+                     unsigned int input_count,
+                     unsigned int offset,
+                     unsigned int length,
+                     uint8_t *output) {
+  uint8_t merged[SCALAR_BLOCK_SIZE];
+  while (offset < length) {
+    unsigned int block_size = min(SCALAR_BLOCK_SIZE, length - offset);
+    memcpy(merged, inputs[0] + offset, block_size);
+    for (unsigned int input = 1; input < input_count; input++) {
+      const uint8_t *data = inputs[input] + offset;
+      for (unsigned int i = 0; i < block_size; i++) {
+        merged[i] = max(merged[i], data[i]);
+      }
+    }
+    memcpy(output + offset, merged, block_size);
+    offset += block_size;
+  }
+}
+
+void ScalarMerge(const uint8_t *const *inputs,
+                 unsigned int input_count,
+                 unsigned int length,
+                 uint8_t *output) {
+  ScalarMergeFrom(inputs, input_count, 0, length, output);
+}
+
+#ifdef OLA_HTP_MERGE_X86
+__attribute__((target("sse2")))
+unsigned int SSE2MergeFrom(const uint8_t *const *inputs,
+                           unsigned int input_count,
+                           unsigned int offset,
+                           unsigned int length,
+                           uint8_t *output) {
+  for (; offset + sizeof(__m128i) <= length; offset += sizeof(__m128i)) {
+    __m128i merged = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(inputs[0] + offset));
+    for (unsigned int input = 1; input < input_count; input++) {
+      merged = _mm_max_epu8(
+          merged,
+          _mm_loadu_si128(
+              reinterpret_cast<const __m128i*>(inputs[input] + offset)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + offset), merged);
+  }
+  return offset;
+}
+
+__attribute__((target("sse2")))
+void SSE2Merge(const uint8_t *const *inputs,
+               unsigned int input_count,
+               unsigned int length,
+               uint8_t *output) {
+  unsigned int offset = SSE2MergeFrom(inputs, input_count, 0, length, output);
+  ScalarMergeFrom(inputs, input_count, offset, length, output);
+}
+
+__attribute__((target("avx2")))
+void AVX2Merge(const uint8_t *const *inputs,
+               unsigned int input_count,
+               unsigned int length,
+               uint8_t *output) {
+  unsigned int offset = 0;
+  for (; offset + sizeof(__m256i) <= length; offset += sizeof(__m256i)) {
+    __m256i merged = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(inputs[0] + offset));
+    for (unsigned int input = 1; input < input_count; input++) {
+      merged = _mm256_max_epu8(
+          merged,
+          _mm256_loadu_si256(
+              reinterpret_cast<const __m256i*>(inputs[input] + offset)));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + offset), merged);
+  }
+  offset = SSE2MergeFrom(inputs, input_count, offset, length, output);
+  ScalarMergeFrom(inputs, input_count, offset, length, output);
+}
+#endif  // OLA_HTP_MERGE_X86
+
+#ifdef OLA_HTP_MERGE_NEON
+void NEONMerge(const uint8_t *const *inputs,
+               unsigned int input_count,
+               unsigned int length,
+               uint8_t *output) {
+  unsigned int offset = 0;
+  for (; offset + sizeof(uint8x16_t) <= length;
+       offset += sizeof(uint8x16_t)) {
+    uint8x16_t merged = vld1q_u8(inputs[0] + offset);
+    for (unsigned int input = 1; input < input_count; input++) {
+      merged = vmaxq_u8(merged, vld1q_u8(inputs[input] + offset));
+    }
+    vst1q_u8(output + offset, merged);
+  }
+  ScalarMergeFrom(inputs, input_count, offset, length, output);
+}
+#endif  // OLA_HTP_MERGE_NEON
+
+MergeFunction KernelFunction(htp_merge_kernel kernel) {
+  switch (kernel) {
+    case HTP_MERGE_SCALAR:
+      return &ScalarMerge;
+#ifdef OLA_HTP_MERGE_X86
+    case HTP_MERGE_SSE2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse2") ? &SSE2Merge : NULL;
+    case HTP_MERGE_AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") ? &AVX2Merge : NULL;
+#endif  // OLA_HTP_MERGE_X86
+#ifdef OLA_HTP_MERGE_NEON
+    case HTP_MERGE_NEON:
+      return &NEONMerge;
+#endif  // OLA_HTP_MERGE_NEON
+    default:
+      return NULL;
+  }
+}
+
+/*
+ * Pick the best kernel for this CPU. This is only done once, a race between
+ * two threads is harmless since they'll both store the same values.
+ */
+htp_merge_kernel active_kernel = HTP_MERGE_SCALAR;
+MergeFunction active_function = NULL;
+
+MergeFunction ActiveFunction() {
+  if (active_function) {
+    return active_function;
+  }
+
+  const htp_merge_kernel preferred[] = {
+    HTP_MERGE_AVX2,
+    HTP_MERGE_NEON,
+    HTP_MERGE_SSE2,
+  };
+
+  htp_merge_kernel kernel = HTP_MERGE_SCALAR;
+  MergeFunction function = &ScalarMerge;
+  for (unsigned int i = 0; i < sizeof(preferred) / sizeof(preferred[0]); i++) {
+    MergeFunction candidate = KernelFunction(preferred[i]);
+    if (candidate) {
+      kernel = preferred[i];
+      function = candidate;
+      break;
+    }
+  }
+  active_kernel = kernel;
+  active_function = function;
+  return function;
+}
+}  // namespace
+
+
+void HTPMergeSlots(const uint8_t *const *inputs,
+                   unsigned int input_count,
+                   unsigned int length,
+                   uint8_t *output) {
+  if (!input_count) {
+    return;
+  }
+  ActiveFunction()(inputs, input_count, length, output);
+}
+
+
+bool HTPMergeSlotsWithKernel(htp_merge_kernel kernel,
+                             const uint8_t *const *inputs,
+                             unsigned int input_count,
+                             unsigned int length,
+                             uint8_t *output) {
+  MergeFunction function = KernelFunction(kernel);
+  if (!function) {
+    return false;
+  }
+  if (input_count) {
+    function(inputs, input_count, length, output);
+  }
+  return true;
+}
+
+
+bool HTPMergeKernelSupported(htp_merge_kernel kernel) {
+  return KernelFunction(kernel) != NULL;
+}
+
+
+htp_merge_kernel ActiveHTPMergeKernel() {
+  ActiveFunction();
+  return active_kernel;
+}
+
+
+string HTPMergeKernelName(htp_merge_kernel kernel) {
+  switch (kernel) {
+    case HTP_MERGE_SCALAR:
+      return "scalar";
+    case HTP_MERGE_SSE2:
+      return "sse2";
+    case HTP_MERGE_AVX2:
+      return "avx2";
+    case HTP_MERGE_NEON:
+      return "neon";
+    default:
+      return "unknown";
+  }
+}
+}  // namespace dmx
+}  // namespace ola
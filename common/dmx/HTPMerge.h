@@ -0,0 +1,90 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HTPMerge.h
+ * Multi-source HTP merge kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_DMX_HTPMERGE_H_
+#define COMMON_DMX_HTPMERGE_H_
+
+#include <stdint.h>
+#include <string>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief The implementations of the HTP merge kernel.
+ */
+typedef enum {
+  HTP_MERGE_SCALAR,  /**< Portable C++ */
+  HTP_MERGE_SSE2,  /**< x86 SSE2, 16 slots at a time */
+  HTP_MERGE_AVX2,  /**< x86 AVX2, 32 slots at a time */
+  HTP_MERGE_NEON,  /**< ARM NEON, 16 slots at a time */
+} htp_merge_kernel;
+
+/**
+ * @brief HTP merge a number of slot arrays in a single pass.
+ * @param inputs an array of input_count pointers to slot data. Each input must
+ *   have at least length slots.
+ * @param input_count the number of inputs, must be at least 1.
+ * @param length the number of slots to merge.
+ * @param output where to write the merged slots. This may be the same as one
+ *   of the inputs.
+ *
+ * The fastest kernel supported by the CPU is selected the first time this is
+ * called.
+ */
+void HTPMergeSlots(const uint8_t *const *inputs,
+                   unsigned int input_count,
+                   unsigned int length,
+                   uint8_t *output);
+
+/**
+ * @brief HTP merge using a specific kernel.
+ * @param kernel the kernel to use.
+ * @param inputs see HTPMergeSlots().
+ * @param input_count see HTPMergeSlots().
+ * @param length see HTPMergeSlots().
+ * @param output see HTPMergeSlots().
+ * @returns false if the kernel isn't supported on this machine.
+ *
+ * This is used by the tests & benchmarks to compare kernels.
+ */
+bool HTPMergeSlotsWithKernel(htp_merge_kernel kernel,
+                             const uint8_t *const *inputs,
+                             unsigned int input_count,
+                             unsigned int length,
+                             uint8_t *output);
+
+/**
+ * @brief Check if a kernel was compiled in and is supported by the CPU.
+ */
+bool HTPMergeKernelSupported(htp_merge_kernel kernel);
+
+/**
+ * @brief Return the kernel that HTPMergeSlots() uses.
+ */
+htp_merge_kernel ActiveHTPMergeKernel();
+
+/**
+ * @brief Return the name of a kernel, e.g. "avx2".
+ */
+std::string HTPMergeKernelName(htp_merge_kernel kernel);
+}  // namespace dmx
+}  // namespace ola
+#endif  // COMMON_DMX_HTPMERGE_H_
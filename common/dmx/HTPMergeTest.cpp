@@ -0,0 +1,170 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HTPMergeTest.cpp
+ * Test fixture for the HTP merge kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+#include "common/dmx/HTPMerge.h"
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::dmx::HTPMergeKernelName;
+using ola::dmx::HTPMergeKernelSupported;
+using ola::dmx::HTPMergeSlots;
+using ola::dmx::HTPMergeSlotsWithKernel;
+using ola::dmx::htp_merge_kernel;
+using std::max;
+using std::string;
+
+class HTPMergeTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(HTPMergeTest);
+  CPPUNIT_TEST(testKernels);
+  CPPUNIT_TEST(testInPlace);
+  CPPUNIT_TEST(testActiveKernel);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void testKernels();
+    void testInPlace();
+    void testActiveKernel();
+
+ private:
+    enum { MAX_INPUTS = 10 };
+
+    uint8_t m_inputs[MAX_INPUTS][ola::DMX_UNIVERSE_SIZE];
+    const uint8_t *m_input_ptrs[MAX_INPUTS];
+
+    void ReferenceMerge(unsigned int input_count, unsigned int length,
+                        uint8_t *output);
+    void CheckKernel(htp_merge_kernel kernel);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HTPMergeTest);
+
+
+/*
+ * Fill the inputs with a pattern that gives every input the max on some slots.
+ */
+void HTPMergeTest::setUp() {
+  for (unsigned int input = 0; input < MAX_INPUTS; input++) {
+    for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+      m_inputs[input][i] = static_cast<uint8_t>((i * 7 + input * 31) ^
+                                                (input << 4));
+    }
+    m_input_ptrs[input] = m_inputs[input];
+  }
+}
+
+
+/*
+ * The byte at a time merge.
+ */
+void HTPMergeTest::ReferenceMerge(unsigned int input_count,
+                                  unsigned int length,
+                                  uint8_t *output) {
+  memcpy(output, m_inputs[0], length);
+  for (unsigned int input = 1; input < input_count; input++) {
+    for (unsigned int i = 0; i < length; i++) {
+      output[i] = max(output[i], m_inputs[input][i]);
+    }
+  }
+}
+
+
+/*
+ * Check a kernel against the reference merge, using lengths which exercise
+ * the vector and tail paths.
+ */
+void HTPMergeTest::CheckKernel(htp_merge_kernel kernel) {
+  const unsigned int lengths[] = {0, 1, 15, 16, 17, 31, 32, 33, 63, 100,
+                                  511, 512};
+  uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+  uint8_t output[ola::DMX_UNIVERSE_SIZE];
+
+  for (unsigned int input_count = 1; input_count <= MAX_INPUTS;
+       input_count++) {
+    for (unsigned int i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+      const unsigned int length = lengths[i];
+      memset(output, 0xaa, sizeof(output));
+      ReferenceMerge(input_count, length, expected);
+      OLA_ASSERT_TRUE(HTPMergeSlotsWithKernel(kernel, m_input_ptrs,
+                                              input_count, length, output));
+      OLA_ASSERT_DATA_EQUALS(expected, length, output, length);
+      // check we didn't write past the end
+      if (length < ola::DMX_UNIVERSE_SIZE) {
+        OLA_ASSERT_EQ(static_cast<uint8_t>(0xaa), output[length]);
+      }
+    }
+  }
+}
+
+
+/*
+ * Check all kernels the CPU supports produce the same result.
+ */
+void HTPMergeTest::testKernels() {
+  const htp_merge_kernel kernels[] = {
+    ola::dmx::HTP_MERGE_SCALAR,
+    ola::dmx::HTP_MERGE_SSE2,
+    ola::dmx::HTP_MERGE_AVX2,
+    ola::dmx::HTP_MERGE_NEON,
+  };
+
+  // The scalar kernel is always available.
+  OLA_ASSERT_TRUE(HTPMergeKernelSupported(ola::dmx::HTP_MERGE_SCALAR));
+
+  for (unsigned int i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+    if (!HTPMergeKernelSupported(kernels[i])) {
+      OLA_INFO << "Skipping unsupported kernel "
+               << HTPMergeKernelName(kernels[i]);
+      continue;
+    }
+    CheckKernel(kernels[i]);
+  }
+}
+
+
+/*
+ * Check the output can be one of the inputs.
+ */
+void HTPMergeTest::testInPlace() {
+  uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+  ReferenceMerge(MAX_INPUTS, ola::DMX_UNIVERSE_SIZE, expected);
+
+  HTPMergeSlots(m_input_ptrs, MAX_INPUTS, ola::DMX_UNIVERSE_SIZE,
+                m_inputs[3]);
+  OLA_ASSERT_DATA_EQUALS(expected, ola::DMX_UNIVERSE_SIZE,
+                         m_inputs[3], ola::DMX_UNIVERSE_SIZE);
+}
+
+
+/*
+ * Check the active kernel is one that is supported.
+ */
+void HTPMergeTest::testActiveKernel() {
+  htp_merge_kernel kernel = ola::dmx::ActiveHTPMergeKernel();
+  OLA_ASSERT_TRUE(HTPMergeKernelSupported(kernel));
+  OLA_ASSERT_NE(string("unknown"), HTPMergeKernelName(kernel));
+}
@@ -1,11 +1,54 @@
 # LIBRARIES
 ##################################################
-common_libolacommon_la_SOURCES += common/dmx/RunLengthEncoder.cpp
+common_libolacommon_la_SOURCES += \
+    common/dmx/ColorCorrection.cpp \
+    common/dmx/ColorCorrection.h \
+    common/dmx/DeltaEncoder.cpp \
+    common/dmx/DmxFrameScheduler.cpp \
+    common/dmx/DmxFrameScheduler.h \
+    common/dmx/HTPMerge.cpp \
+    common/dmx/HTPMerge.h \
+    common/dmx/RunLengthEncoder.cpp \
+    common/dmx/SharedDmxRegion.cpp \
+    common/dmx/SharedDmxRegion.h
+
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += common/dmx/htp_merge_benchmark
+common_dmx_htp_merge_benchmark_SOURCES = common/dmx/htp_merge_benchmark.cpp
+common_dmx_htp_merge_benchmark_LDADD = common/libolacommon.la
 
 # TESTS
 ##################################################
-test_programs += common/dmx/RunLengthEncoderTester
+test_programs += \
+    common/dmx/ColorCorrectionTester \
+    common/dmx/DeltaEncoderTester \
+    common/dmx/DmxFrameSchedulerTester \
+    common/dmx/HTPMergeTester \
+    common/dmx/RunLengthEncoderTester \
+    common/dmx/SharedDmxRegionTester
+
+common_dmx_ColorCorrectionTester_SOURCES = common/dmx/ColorCorrectionTest.cpp
+common_dmx_ColorCorrectionTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_ColorCorrectionTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_DeltaEncoderTester_SOURCES = common/dmx/DeltaEncoderTest.cpp
+common_dmx_DeltaEncoderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_DeltaEncoderTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_DmxFrameSchedulerTester_SOURCES = \
+    common/dmx/DmxFrameSchedulerTest.cpp
+common_dmx_DmxFrameSchedulerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_DmxFrameSchedulerTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_HTPMergeTester_SOURCES = common/dmx/HTPMergeTest.cpp
+common_dmx_HTPMergeTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_HTPMergeTester_LDADD = $(COMMON_TESTING_LIBS)
 
 common_dmx_RunLengthEncoderTester_SOURCES = common/dmx/RunLengthEncoderTest.cpp
 common_dmx_RunLengthEncoderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_dmx_RunLengthEncoderTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_SharedDmxRegionTester_SOURCES = common/dmx/SharedDmxRegionTest.cpp
+common_dmx_SharedDmxRegionTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_SharedDmxRegionTester_LDADD = $(COMMON_TESTING_LIBS)
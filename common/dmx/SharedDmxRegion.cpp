@@ -0,0 +1,352 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedDmxRegion.cpp
+ * DMX data for many universes, in memory shared between processes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef HAVE_SHM_OPEN
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // HAVE_SHM_OPEN
+
+#include <algorithm>
+#include <string>
+
+#include "common/dmx/SharedDmxRegion.h"
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+
+namespace ola {
+namespace dmx {
+
+using std::string;
+
+/*
+ * The layout of the region is a RegionHeader followed by slot_count
+ * RegionSlots. Both are a multiple of 8 bytes so the slots stay aligned.
+ */
+struct SharedDmxRegion::RegionHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t slot_count;
+  uint32_t slots_used;
+  uint32_t pending;
+  uint32_t reserved[3];
+};
+
+struct SharedDmxRegion::RegionSlot {
+  uint32_t sequence;
+  uint32_t universe;
+  uint16_t length;
+  uint8_t priority;
+  uint8_t reserved[5];
+  uint8_t data[DMX_UNIVERSE_SIZE];
+};
+
+namespace {
+
+/*
+ * Atomic access to the shared memory. Regions can't be created without the
+ * atomic builtins, so the fallbacks are never used.
+ */
+inline uint32_t LoadAcquire(const uint32_t *value) {
+#ifdef HAVE_ATOMIC_BUILTINS
+  return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#else
+  return *value;
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+
+template <typename T>
+inline T LoadRelaxed(const T *value) {
+#ifdef HAVE_ATOMIC_BUILTINS
+  return __atomic_load_n(value, __ATOMIC_RELAXED);
+#else
+  return *value;
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+
+inline void StoreRelease(uint32_t *value, uint32_t new_value) {
+#ifdef HAVE_ATOMIC_BUILTINS
+  __atomic_store_n(value, new_value, __ATOMIC_RELEASE);
+#else
+  *value = new_value;
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+
+template <typename T>
+inline void StoreRelaxed(T *value, T new_value) {
+#ifdef HAVE_ATOMIC_BUILTINS
+  __atomic_store_n(value, new_value, __ATOMIC_RELAXED);
+#else
+  *value = new_value;
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+
+inline uint32_t Exchange(uint32_t *value, uint32_t new_value) {
+#ifdef HAVE_ATOMIC_BUILTINS
+  return __atomic_exchange_n(value, new_value, __ATOMIC_ACQ_REL);
+#else
+  uint32_t old_value = *value;
+  *value = new_value;
+  return old_value;
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+
+inline void FenceAcquire() {
+#ifdef HAVE_ATOMIC_BUILTINS
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+
+inline void FenceRelease() {
+#ifdef HAVE_ATOMIC_BUILTINS
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+}  // namespace
+
+const unsigned int SharedDmxRegion::MAX_SLOT_COUNT;
+
+SharedDmxRegion::SharedDmxRegion(const string &name, bool owner,
+                                 uint8_t *memory, unsigned int size,
+                                 unsigned int slot_count)
+    : m_name(name),
+      m_owner(owner),
+      m_memory(memory),
+      m_size(size),
+      m_slot_count(slot_count),
+      m_header(reinterpret_cast<RegionHeader*>(memory)),
+      m_slots(reinterpret_cast<RegionSlot*>(memory + sizeof(RegionHeader))),
+      m_read_sequence(slot_count, 0) {
+}
+
+SharedDmxRegion::~SharedDmxRegion() {
+#ifdef HAVE_SHM_OPEN
+  munmap(m_memory, m_size);
+  if (m_owner) {
+    // The client normally removes the name once it has opened the region.
+    shm_unlink(m_name.c_str());
+  }
+#endif  // HAVE_SHM_OPEN
+}
+
+SharedDmxRegion *SharedDmxRegion::Create(const string &name,
+                                         unsigned int slot_count) {
+#if defined(HAVE_SHM_OPEN) && defined(HAVE_ATOMIC_BUILTINS)
+  if (slot_count == 0 || slot_count > MAX_SLOT_COUNT) {
+    OLA_WARN << "Invalid shared memory slot count " << slot_count;
+    return NULL;
+  }
+
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR,
+                    S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    OLA_WARN << "shm_open(" << name << ") failed: " << strerror(errno);
+    return NULL;
+  }
+
+  unsigned int size = RegionSize(slot_count);
+  if (ftruncate(fd, size)) {
+    OLA_WARN << "ftruncate(" << name << ") failed: " << strerror(errno);
+    close(fd);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "mmap(" << name << ") failed: " << strerror(errno);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  // ftruncate zeros the memory, so all that's left is the header.
+  RegionHeader *header = reinterpret_cast<RegionHeader*>(memory);
+  header->magic = MAGIC;
+  header->version = REGION_VERSION;
+  header->slot_count = slot_count;
+  return new SharedDmxRegion(name, true, reinterpret_cast<uint8_t*>(memory),
+                             size, slot_count);
+#else
+  OLA_WARN << "Shared memory isn't supported";
+  (void) name;
+  (void) slot_count;
+  return NULL;
+#endif  // HAVE_SHM_OPEN && HAVE_ATOMIC_BUILTINS
+}
+
+SharedDmxRegion *SharedDmxRegion::Open(const string &name) {
+#if defined(HAVE_SHM_OPEN) && defined(HAVE_ATOMIC_BUILTINS)
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    OLA_WARN << "shm_open(" << name << ") failed: " << strerror(errno);
+    return NULL;
+  }
+
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf)) {
+    OLA_WARN << "fstat(" << name << ") failed: " << strerror(errno);
+    close(fd);
+    return NULL;
+  }
+
+  if (stat_buf.st_size < static_cast<off_t>(sizeof(RegionHeader)) ||
+      stat_buf.st_size > static_cast<off_t>(RegionSize(MAX_SLOT_COUNT))) {
+    OLA_WARN << "Shared memory region " << name << " has invalid size "
+             << stat_buf.st_size;
+    close(fd);
+    return NULL;
+  }
+
+  unsigned int size = stat_buf.st_size;
+  void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "mmap(" << name << ") failed: " << strerror(errno);
+    return NULL;
+  }
+
+  const RegionHeader *header = reinterpret_cast<RegionHeader*>(memory);
+  unsigned int slot_count = header->slot_count;
+  if (header->magic != MAGIC || header->version != REGION_VERSION ||
+      slot_count == 0 || slot_count > MAX_SLOT_COUNT ||
+      RegionSize(slot_count) > size) {
+    OLA_WARN << "Shared memory region " << name << " isn't valid";
+    munmap(memory, size);
+    return NULL;
+  }
+  return new SharedDmxRegion(name, false, reinterpret_cast<uint8_t*>(memory),
+                             size, slot_count);
+#else
+  OLA_WARN << "Shared memory isn't supported";
+  (void) name;
+  return NULL;
+#endif  // HAVE_SHM_OPEN && HAVE_ATOMIC_BUILTINS
+}
+
+void SharedDmxRegion::Unlink(const string &name) {
+#ifdef HAVE_SHM_OPEN
+  if (shm_unlink(name.c_str()) && errno != ENOENT) {
+    OLA_WARN << "shm_unlink(" << name << ") failed: " << strerror(errno);
+  }
+#else
+  (void) name;
+#endif  // HAVE_SHM_OPEN
+}
+
+bool SharedDmxRegion::Supported() {
+#if defined(HAVE_SHM_OPEN) && defined(HAVE_ATOMIC_BUILTINS)
+  return true;
+#else
+  return false;
+#endif  // HAVE_SHM_OPEN && HAVE_ATOMIC_BUILTINS
+}
+
+bool SharedDmxRegion::Write(unsigned int universe, uint8_t priority,
+                            const uint8_t *data, unsigned int length) {
+  unsigned int index;
+  UniverseSlotMap::const_iterator iter = m_universe_slots.find(universe);
+  if (iter == m_universe_slots.end()) {
+    index = m_universe_slots.size();
+    if (index >= m_slot_count) {
+      return false;
+    }
+    // The universe must be set before the reader can see the slot.
+    StoreRelaxed(&m_slots[index].universe, static_cast<uint32_t>(universe));
+    StoreRelease(&m_header->slots_used, index + 1);
+    m_universe_slots[universe] = index;
+  } else {
+    index = iter->second;
+  }
+
+  RegionSlot *slot = &m_slots[index];
+  length = std::min(length, static_cast<unsigned int>(DMX_UNIVERSE_SIZE));
+
+  // Make the sequence number odd while we update the slot.
+  uint32_t sequence = LoadRelaxed(&slot->sequence);
+  StoreRelaxed(&slot->sequence, sequence + 1);
+  FenceRelease();
+  StoreRelaxed(&slot->priority, priority);
+  StoreRelaxed(&slot->length, static_cast<uint16_t>(length));
+  memcpy(slot->data, data, length);
+  StoreRelease(&slot->sequence, sequence + 2);
+  return true;
+}
+
+bool SharedDmxRegion::SetPending() {
+  return Exchange(&m_header->pending, 1) == 0;
+}
+
+void SharedDmxRegion::ClearPending() {
+  Exchange(&m_header->pending, 0);
+}
+
+unsigned int SharedDmxRegion::SlotsUsed() const {
+  // The other process may have written anything here.
+  return std::min(LoadAcquire(&m_header->slots_used),
+                  static_cast<uint32_t>(m_slot_count));
+}
+
+bool SharedDmxRegion::ReadSlot(unsigned int slot_index,
+                               unsigned int *universe,
+                               uint8_t *priority,
+                               uint8_t *data,
+                               unsigned int *length) {
+  if (slot_index >= m_slot_count) {
+    return false;
+  }
+
+  const RegionSlot *slot = &m_slots[slot_index];
+  uint32_t sequence = LoadAcquire(&slot->sequence);
+  if ((sequence & 1) || sequence == m_read_sequence[slot_index]) {
+    return false;
+  }
+
+  unsigned int slot_length = std::min(
+      static_cast<unsigned int>(LoadRelaxed(&slot->length)),
+      static_cast<unsigned int>(DMX_UNIVERSE_SIZE));
+  *universe = LoadRelaxed(&slot->universe);
+  *priority = LoadRelaxed(&slot->priority);
+  memcpy(data, slot->data, slot_length);
+
+  // If the sequence number changed while we were copying, the data may be
+  // torn. The writer will call SetPending() when it's done.
+  FenceAcquire();
+  if (LoadRelaxed(&slot->sequence) != sequence) {
+    return false;
+  }
+  m_read_sequence[slot_index] = sequence;
+  *length = slot_length;
+  return true;
+}
+
+unsigned int SharedDmxRegion::RegionSize(unsigned int slot_count) {
+  return sizeof(RegionHeader) + slot_count * sizeof(RegionSlot);
+}
+}  // namespace dmx
+}  // namespace ola
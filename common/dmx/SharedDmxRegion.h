@@ -0,0 +1,173 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedDmxRegion.h
+ * DMX data for many universes, in memory shared between processes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_DMX_SHAREDDMXREGION_H_
+#define COMMON_DMX_SHAREDDMXREGION_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief DMX data for a set of universes, in memory shared between a client
+ * and olad.
+ *
+ * A region has a single writer and a single reader. The writer assigns a
+ * slot to each universe the first time it's written. Each slot has a sequence
+ * number which is odd while the writer is updating the slot, so the reader
+ * can detect a torn read, and can tell which slots have changed since it
+ * last looked. Neither side ever blocks.
+ *
+ * To avoid polling, once the writer has finished a batch of updates it calls
+ * SetPending(). If that returns true, the reader has to be told there is new
+ * data, which is done over the RPC channel. The reader calls ClearPending()
+ * before it reads the slots, so anything written after that triggers another
+ * notification.
+ *
+ * olad creates the regions, so they are owned by the user olad runs as and
+ * only readable & writable by that user.
+ */
+class SharedDmxRegion {
+ public:
+  ~SharedDmxRegion();
+
+  /**
+   * @brief Create a new region.
+   * @param name the name of the region, this should start with a '/'.
+   * @param slot_count the number of universes the region can hold.
+   * @returns a new SharedDmxRegion or NULL if it couldn't be created.
+   *
+   * The name is removed when the region is deleted, if it still exists.
+   */
+  static SharedDmxRegion *Create(const std::string &name,
+                                 unsigned int slot_count);
+
+  /**
+   * @brief Open a region created by another process.
+   * @param name the name of the region.
+   * @returns a new SharedDmxRegion or NULL if the region couldn't be opened,
+   *   or isn't valid.
+   */
+  static SharedDmxRegion *Open(const std::string &name);
+
+  /**
+   * @brief Remove the name of a region.
+   * @param name the name of the region.
+   *
+   * Processes that have the region open can continue to use it.
+   */
+  static void Unlink(const std::string &name);
+
+  /**
+   * @brief Check if shared memory is supported on this platform.
+   */
+  static bool Supported();
+
+  /**
+   * @brief The largest number of universes a region can hold.
+   */
+  static const unsigned int MAX_SLOT_COUNT = 4096;
+
+  /**
+   * @brief The number of universes this region can hold.
+   */
+  unsigned int SlotCount() const { return m_slot_count; }
+
+  /**
+   * @brief Write the DMX data for a universe.
+   * @param universe the universe id.
+   * @param priority the priority of the data.
+   * @param data the slot data.
+   * @param length the number of slots, this is truncated to
+   *   DMX_UNIVERSE_SIZE.
+   * @returns true if the data was written, false if there is no space for
+   *   the universe.
+   */
+  bool Write(unsigned int universe, uint8_t priority, const uint8_t *data,
+             unsigned int length);
+
+  /**
+   * @brief Called by the writer once it has written a batch of universes.
+   * @returns true if the reader needs to be told there is new data, false if
+   *   it has already been told and hasn't read the slots yet.
+   */
+  bool SetPending();
+
+  /**
+   * @brief Called by the reader before it reads the slots.
+   */
+  void ClearPending();
+
+  /**
+   * @brief The number of slots that are in use.
+   */
+  unsigned int SlotsUsed() const;
+
+  /**
+   * @brief Read a slot if it has changed since it was last read.
+   * @param slot the slot to read, from 0 to SlotsUsed() - 1.
+   * @param[out] universe the universe id.
+   * @param[out] priority the priority of the data.
+   * @param[out] data where to copy the data, this must be at least
+   *   DMX_UNIVERSE_SIZE bytes.
+   * @param[out] length the number of slots copied.
+   * @returns true if the slot had new data, false if it hasn't changed, or
+   *   the writer was updating it. In the latter case the writer will call
+   *   SetPending() once it's done.
+   */
+  bool ReadSlot(unsigned int slot, unsigned int *universe, uint8_t *priority,
+                uint8_t *data, unsigned int *length);
+
+ private:
+  struct RegionHeader;
+  struct RegionSlot;
+  typedef std::map<unsigned int, unsigned int> UniverseSlotMap;
+
+  const std::string m_name;
+  const bool m_owner;
+  uint8_t *m_memory;
+  const unsigned int m_size;
+  const unsigned int m_slot_count;
+  RegionHeader *m_header;
+  RegionSlot *m_slots;
+  // Writer side, the slot for each universe.
+  UniverseSlotMap m_universe_slots;
+  // Reader side, the sequence number of each slot when it was last read.
+  std::vector<uint32_t> m_read_sequence;
+
+  SharedDmxRegion(const std::string &name, bool owner, uint8_t *memory,
+                  unsigned int size, unsigned int slot_count);
+
+  static unsigned int RegionSize(unsigned int slot_count);
+
+  static const uint32_t MAGIC = 0x4f4c4144;  // OLAD
+  static const uint32_t REGION_VERSION = 1;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedDmxRegion);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // COMMON_DMX_SHAREDDMXREGION_H_
@@ -0,0 +1,193 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedDmxRegionTest.cpp
+ * Test fixture for the SharedDmxRegion class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "common/dmx/SharedDmxRegion.h"
+#include "ola/Constants.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::dmx::SharedDmxRegion;
+using std::auto_ptr;
+using std::string;
+
+class SharedDmxRegionTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SharedDmxRegionTest);
+  CPPUNIT_TEST(testReadWrite);
+  CPPUNIT_TEST(testFull);
+  CPPUNIT_TEST(testPending);
+  CPPUNIT_TEST(testOpen);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void testReadWrite();
+    void testFull();
+    void testPending();
+    void testOpen();
+
+ private:
+    string m_name;
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SharedDmxRegionTest);
+
+
+void SharedDmxRegionTest::setUp() {
+  std::ostringstream str;
+  str << "/ola-test-" << getpid();
+  m_name = str.str();
+}
+
+
+/*
+ * Check that data written by one side can be read by the other.
+ */
+void SharedDmxRegionTest::testReadWrite() {
+  if (!SharedDmxRegion::Supported()) {
+    return;
+  }
+
+  auto_ptr<SharedDmxRegion> writer(SharedDmxRegion::Create(m_name, 4));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  OLA_ASSERT_EQ(4u, writer->SlotCount());
+  auto_ptr<SharedDmxRegion> reader(SharedDmxRegion::Open(m_name));
+  OLA_ASSERT_NOT_NULL(reader.get());
+  OLA_ASSERT_EQ(4u, reader->SlotCount());
+  SharedDmxRegion::Unlink(m_name);
+
+  OLA_ASSERT_EQ(0u, reader->SlotsUsed());
+
+  const uint8_t data1[] = {1, 2, 3, 4};
+  const uint8_t data2[] = {5, 6};
+  OLA_ASSERT_TRUE(writer->Write(10, 100, data1, sizeof(data1)));
+  OLA_ASSERT_TRUE(writer->Write(5, 50, data2, sizeof(data2)));
+  OLA_ASSERT_EQ(2u, reader->SlotsUsed());
+
+  unsigned int universe, length;
+  uint8_t priority;
+  uint8_t data[ola::DMX_UNIVERSE_SIZE];
+  OLA_ASSERT_TRUE(reader->ReadSlot(0, &universe, &priority, data, &length));
+  OLA_ASSERT_EQ(10u, universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), priority);
+  OLA_ASSERT_DATA_EQUALS(data1, sizeof(data1), data, length);
+
+  OLA_ASSERT_TRUE(reader->ReadSlot(1, &universe, &priority, data, &length));
+  OLA_ASSERT_EQ(5u, universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(50), priority);
+  OLA_ASSERT_DATA_EQUALS(data2, sizeof(data2), data, length);
+
+  // Nothing has changed
+  OLA_ASSERT_FALSE(reader->ReadSlot(0, &universe, &priority, data, &length));
+  OLA_ASSERT_FALSE(reader->ReadSlot(1, &universe, &priority, data, &length));
+  OLA_ASSERT_FALSE(reader->ReadSlot(2, &universe, &priority, data, &length));
+  OLA_ASSERT_FALSE(reader->ReadSlot(4, &universe, &priority, data, &length));
+
+  // Update the first universe, it should keep its slot
+  OLA_ASSERT_TRUE(writer->Write(10, 100, data2, sizeof(data2)));
+  OLA_ASSERT_EQ(2u, reader->SlotsUsed());
+  OLA_ASSERT_FALSE(reader->ReadSlot(1, &universe, &priority, data, &length));
+  OLA_ASSERT_TRUE(reader->ReadSlot(0, &universe, &priority, data, &length));
+  OLA_ASSERT_EQ(10u, universe);
+  OLA_ASSERT_DATA_EQUALS(data2, sizeof(data2), data, length);
+
+  // Lengths are truncated to a universe
+  uint8_t large[ola::DMX_UNIVERSE_SIZE + 10];
+  memset(large, 7, sizeof(large));
+  OLA_ASSERT_TRUE(writer->Write(10, 100, large, sizeof(large)));
+  OLA_ASSERT_TRUE(reader->ReadSlot(0, &universe, &priority, data, &length));
+  OLA_ASSERT_DATA_EQUALS(large, ola::DMX_UNIVERSE_SIZE, data, length);
+}
+
+
+/*
+ * Check what happens when all the slots are used.
+ */
+void SharedDmxRegionTest::testFull() {
+  if (!SharedDmxRegion::Supported()) {
+    return;
+  }
+
+  auto_ptr<SharedDmxRegion> region(SharedDmxRegion::Create(m_name, 2));
+  OLA_ASSERT_NOT_NULL(region.get());
+
+  const uint8_t data[] = {1, 2, 3};
+  OLA_ASSERT_TRUE(region->Write(1, 100, data, sizeof(data)));
+  OLA_ASSERT_TRUE(region->Write(2, 100, data, sizeof(data)));
+  OLA_ASSERT_FALSE(region->Write(3, 100, data, sizeof(data)));
+  OLA_ASSERT_TRUE(region->Write(1, 100, data, sizeof(data)));
+  OLA_ASSERT_EQ(2u, region->SlotsUsed());
+
+  OLA_ASSERT_NULL(SharedDmxRegion::Create(m_name + "-2", 0));
+  OLA_ASSERT_NULL(SharedDmxRegion::Create(
+      m_name + "-2", SharedDmxRegion::MAX_SLOT_COUNT + 1));
+}
+
+
+/*
+ * Check the reader is only notified once per batch.
+ */
+void SharedDmxRegionTest::testPending() {
+  if (!SharedDmxRegion::Supported()) {
+    return;
+  }
+
+  auto_ptr<SharedDmxRegion> writer(SharedDmxRegion::Create(m_name, 2));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  auto_ptr<SharedDmxRegion> reader(SharedDmxRegion::Open(m_name));
+  OLA_ASSERT_NOT_NULL(reader.get());
+
+  OLA_ASSERT_TRUE(writer->SetPending());
+  OLA_ASSERT_FALSE(writer->SetPending());
+  reader->ClearPending();
+  OLA_ASSERT_TRUE(writer->SetPending());
+  reader->ClearPending();
+  reader->ClearPending();
+  OLA_ASSERT_TRUE(writer->SetPending());
+}
+
+
+/*
+ * Check that Open fails if the region doesn't exist or has been unlinked.
+ */
+void SharedDmxRegionTest::testOpen() {
+  if (!SharedDmxRegion::Supported()) {
+    return;
+  }
+
+  OLA_ASSERT_NULL(SharedDmxRegion::Open(m_name));
+
+  auto_ptr<SharedDmxRegion> region(SharedDmxRegion::Create(m_name, 2));
+  OLA_ASSERT_NOT_NULL(region.get());
+  // The name is already in use
+  OLA_ASSERT_NULL(SharedDmxRegion::Create(m_name, 2));
+
+  SharedDmxRegion::Unlink(m_name);
+  OLA_ASSERT_NULL(SharedDmxRegion::Open(m_name));
+  // Unlinking twice is fine
+  SharedDmxRegion::Unlink(m_name);
+}
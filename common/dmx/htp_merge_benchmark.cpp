@@ -0,0 +1,132 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * htp_merge_benchmark.cpp
+ * Compare the per-source HTP merge with the single pass kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/dmx/HTPMerge.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::dmx::HTPMergeKernelName;
+using ola::dmx::HTPMergeKernelSupported;
+using ola::dmx::htp_merge_kernel;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(iterations, i, 200000, "The number of merges to run");
+DEFINE_s_uint16(sources, s, 8, "The number of HTP sources to merge");
+
+/**
+ * Print the result of a run.
+ */
+void PrintResult(const string &name, const TimeInterval &duration) {
+  double total_usec = static_cast<double>(duration.AsInt());
+  double ns_per_merge = total_usec * 1000.0 / FLAGS_iterations;
+  cout << std::left << std::setw(24) << name << std::right << std::fixed
+       << std::setprecision(1) << std::setw(10) << ns_per_merge
+       << " ns/merge " << std::setw(12) << std::setprecision(0)
+       << (ns_per_merge > 0 ? 1e9 / ns_per_merge : 0) << " merges/s" << endl;
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "", "Benchmark the HTP merge kernels.");
+
+  if (FLAGS_sources == 0 || FLAGS_iterations == 0) {
+    return -1;
+  }
+
+  const unsigned int source_count = FLAGS_sources;
+  vector<DmxBuffer> buffers(source_count);
+  vector<const DmxBuffer*> buffer_ptrs;
+  vector<const uint8_t*> inputs;
+  for (unsigned int i = 0; i < source_count; i++) {
+    uint8_t data[ola::DMX_UNIVERSE_SIZE];
+    for (unsigned int j = 0; j < ola::DMX_UNIVERSE_SIZE; j++) {
+      data[j] = static_cast<uint8_t>(i * 13 + j * 7);
+    }
+    buffers[i].Set(data, sizeof(data));
+    buffer_ptrs.push_back(&buffers[i]);
+    inputs.push_back(buffers[i].GetRaw());
+  }
+
+  cout << source_count << " sources, " << FLAGS_iterations
+       << " merges, active kernel: "
+       << HTPMergeKernelName(ola::dmx::ActiveHTPMergeKernel()) << endl;
+
+  Clock clock;
+  TimeStamp start, end;
+  DmxBuffer output;
+
+  // The original path, one DmxBuffer::HTPMerge() per source.
+  clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    output.Reset();
+    for (unsigned int j = 0; j < source_count; j++) {
+      output.HTPMerge(buffers[j]);
+    }
+  }
+  clock.CurrentMonotonicTime(&end);
+  PrintResult("DmxBuffer per-source", end - start);
+
+  // The single pass DmxBuffer API.
+  clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    output.Reset();
+    output.HTPMerge(buffer_ptrs);
+  }
+  clock.CurrentMonotonicTime(&end);
+  PrintResult("DmxBuffer single-pass", end - start);
+
+  // Each of the raw kernels.
+  const htp_merge_kernel kernels[] = {
+    ola::dmx::HTP_MERGE_SCALAR,
+    ola::dmx::HTP_MERGE_SSE2,
+    ola::dmx::HTP_MERGE_AVX2,
+    ola::dmx::HTP_MERGE_NEON,
+  };
+
+  uint8_t slots[ola::DMX_UNIVERSE_SIZE];
+  for (unsigned int k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+    if (!HTPMergeKernelSupported(kernels[k])) {
+      continue;
+    }
+    clock.CurrentMonotonicTime(&start);
+    for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+      ola::dmx::HTPMergeSlotsWithKernel(kernels[k], &inputs[0], source_count,
+                                        ola::DMX_UNIVERSE_SIZE, slots);
+    }
+    clock.CurrentMonotonicTime(&end);
+    PrintResult("kernel " + HTPMergeKernelName(kernels[k]), end - start);
+  }
+  return 0;
+}
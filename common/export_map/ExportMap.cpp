@@ -18,7 +18,12 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <algorithm>
+#include <cmath>
 #include <string>
 #include <map>
 #include <vector>
@@ -34,9 +39,198 @@ using std::ostringstream;
 using std::string;
 using std::vector;
 
+namespace {
+
+/*
+ * Relaxed atomic access to the histogram counters. Without the atomic builtins
+ * we fall back to plain operations, which is fine for the single threaded
+ * case.
+ */
+template<typename Type>
+inline void AtomicAdd(Type *value, Type delta) {
+#ifdef HAVE_ATOMIC_BUILTINS
+  __atomic_fetch_add(value, delta, __ATOMIC_RELAXED);
+#else
+  *value += delta;
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+
+inline void AtomicIncrement(unsigned int *value) {
+  AtomicAdd(value, 1u);
+}
+
+template<typename Type>
+inline Type AtomicLoad(const Type *value) {
+#ifdef HAVE_ATOMIC_BUILTINS
+  return __atomic_load_n(value, __ATOMIC_RELAXED);
+#else
+  return *value;
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+
+template<typename Type>
+inline void AtomicStore(Type *value, Type new_value) {
+#ifdef HAVE_ATOMIC_BUILTINS
+  __atomic_store_n(value, new_value, __ATOMIC_RELAXED);
+#else
+  *value = new_value;
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+
+inline void AtomicMax(unsigned int *value, unsigned int new_value) {
+#ifdef HAVE_ATOMIC_BUILTINS
+  unsigned int current = __atomic_load_n(value, __ATOMIC_RELAXED);
+  while (new_value > current &&
+         !__atomic_compare_exchange_n(value, &current, new_value, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+#else
+  if (new_value > *value) {
+    *value = new_value;
+  }
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+}  // namespace
+
+namespace internal {
+void RelaxedAdd(int *value, int delta) {
+  AtomicAdd(value, delta);
+}
+
+void RelaxedAdd(unsigned int *value, int delta) {
+  // Unsigned arithmetic wraps, so adding the converted delta subtracts.
+  AtomicAdd(value, static_cast<unsigned int>(delta));
+}
+
+int RelaxedLoad(const int *value) {
+  return AtomicLoad(value);
+}
+
+unsigned int RelaxedLoad(const unsigned int *value) {
+  return AtomicLoad(value);
+}
+
+void RelaxedStore(int *value, int new_value) {
+  AtomicStore(value, new_value);
+}
+
+void RelaxedStore(unsigned int *value, unsigned int new_value) {
+  AtomicStore(value, new_value);
+}
+}  // namespace internal
+
+void CounterVariable::operator++(int) {
+  AtomicIncrement(&m_value);
+}
+
+void CounterVariable::operator+=(unsigned int value) {
+  AtomicAdd(&m_value, value);
+}
+
+void CounterVariable::Reset() {
+  AtomicStore(&m_value, 0u);
+}
+
+unsigned int CounterVariable::Get() const {
+  return AtomicLoad(&m_value);
+}
+
+HistogramVariable::HistogramVariable(const string &name)
+    : BaseVariable(name),
+      m_count(0),
+      m_max(0) {
+  std::fill(m_buckets, m_buckets + BUCKET_COUNT, 0);
+}
+
+void HistogramVariable::Record(uint64_t value) {
+  unsigned int sample = value > 0xffffffff ?
+      0xffffffff : static_cast<unsigned int>(value);
+  AtomicIncrement(&m_buckets[BucketIndex(sample)]);
+  AtomicIncrement(&m_count);
+  AtomicMax(&m_max, sample);
+}
+
+void HistogramVariable::Reset() {
+  for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+    AtomicStore(&m_buckets[i], 0u);
+  }
+  AtomicStore(&m_count, 0u);
+  AtomicStore(&m_max, 0u);
+}
+
+unsigned int HistogramVariable::Count() const {
+  return AtomicLoad(&m_count);
+}
+
+unsigned int HistogramVariable::Max() const {
+  return AtomicLoad(&m_max);
+}
+
+unsigned int HistogramVariable::Percentile(double percentile) const {
+  // Sum the buckets rather than using m_count, so the result is consistent
+  // with the bucket values we read.
+  uint64_t total = 0;
+  for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+    total += AtomicLoad(&m_buckets[i]);
+  }
+  if (!total) {
+    return 0;
+  }
+
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t rank = static_cast<uint64_t>(
+      std::ceil(percentile * total / 100.0));
+  rank = std::max(rank, static_cast<uint64_t>(1));
+
+  uint64_t seen = 0;
+  for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+    seen += AtomicLoad(&m_buckets[i]);
+    if (seen >= rank) {
+      return std::min(BucketUpperBound(i), Max());
+    }
+  }
+  return Max();
+}
+
+const string HistogramVariable::Value() const {
+  ostringstream out;
+  out << "count:" << Count() << " p50:" << Percentile(50) << " p99:"
+      << Percentile(99) << " p999:" << Percentile(99.9) << " max:" << Max();
+  return out.str();
+}
+
+/*
+ * Values below SUB_BUCKETS have a bucket each. After that each power of two
+ * is split into SUB_BUCKETS buckets, using the bits after the most
+ * significant one.
+ */
+unsigned int HistogramVariable::BucketIndex(unsigned int value) {
+  if (value < SUB_BUCKETS) {
+    return value;
+  }
+  unsigned int msb = SUB_BUCKET_BITS;
+  while (msb < 31 && (value >> (msb + 1))) {
+    msb++;
+  }
+  unsigned int sub_bucket = (value >> (msb - SUB_BUCKET_BITS)) &
+                            (SUB_BUCKETS - 1);
+  return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub_bucket;
+}
+
+unsigned int HistogramVariable::BucketUpperBound(unsigned int index) {
+  if (index < SUB_BUCKETS) {
+    return index;
+  }
+  unsigned int shift = index / SUB_BUCKETS - 1;
+  unsigned int lower = (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+  return lower + ((1u << shift) - 1);
+}
+
+
 ExportMap::~ExportMap() {
   STLDeleteValues(&m_bool_variables);
   STLDeleteValues(&m_counter_variables);
+  STLDeleteValues(&m_histogram_variables);
   STLDeleteValues(&m_int_map_variables);
   STLDeleteValues(&m_int_variables);
   STLDeleteValues(&m_str_map_variables);
@@ -60,6 +254,14 @@ StringVariable *ExportMap::GetStringVar(const string &name) {
   return GetVar(&m_string_variables, name);
 }
 
+HistogramVariable *ExportMap::GetHistogramVar(const string &name) {
+  return GetVar(&m_histogram_variables, name);
+}
+
+void ExportMap::RemoveHistogramVar(const string &name) {
+  STLRemoveAndDelete(&m_histogram_variables, name);
+}
+
 
 /*
  * Lookup or create a string map variable
@@ -102,6 +304,7 @@ vector<BaseVariable*> ExportMap::AllVariables() const {
   vector<BaseVariable*> variables;
   STLValues(m_bool_variables, &variables);
   STLValues(m_counter_variables, &variables);
+  STLValues(m_histogram_variables, &variables);
   STLValues(m_int_map_variables, &variables);
   STLValues(m_int_variables, &variables);
   STLValues(m_str_map_variables, &variables);
@@ -113,6 +316,17 @@ vector<BaseVariable*> ExportMap::AllVariables() const {
 }
 
 
+/*
+ * Return a list of the histogram variables.
+ * @return a vector of the histograms, sorted by name.
+ */
+vector<HistogramVariable*> ExportMap::AllHistograms() const {
+  vector<HistogramVariable*> histograms;
+  STLValues(m_histogram_variables, &histograms);
+  return histograms;
+}
+
+
 template<typename Type>
 Type *ExportMap::GetVar(map<string, Type*> *var_map, const string &name) {
   typename map<string, Type*>::iterator iter;
@@ -24,15 +24,19 @@
 
 #include "ola/ExportMap.h"
 #include "ola/testing/TestUtils.h"
+#include "ola/thread/Thread.h"
 
 using ola::BaseVariable;
 using ola::BoolVariable;
 using ola::CounterVariable;
 using ola::ExportMap;
+using ola::HistogramVariable;
 using ola::IntMap;
 using ola::IntegerVariable;
 using ola::StringMap;
 using ola::StringVariable;
+using ola::UIntMap;
+using ola::UIntMapHandle;
 using std::string;
 using std::vector;
 
@@ -45,6 +49,9 @@ class ExportMapTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testBoolVariable);
   CPPUNIT_TEST(testStringMapVariable);
   CPPUNIT_TEST(testIntMapVariable);
+  CPPUNIT_TEST(testMapVariableHandle);
+  CPPUNIT_TEST(testConcurrentIncrement);
+  CPPUNIT_TEST(testHistogramVariable);
   CPPUNIT_TEST(testExportMap);
   CPPUNIT_TEST_SUITE_END();
 
@@ -55,6 +62,9 @@ class ExportMapTest: public CppUnit::TestFixture {
     void testBoolVariable();
     void testStringMapVariable();
     void testIntMapVariable();
+    void testMapVariableHandle();
+    void testConcurrentIncrement();
+    void testHistogramVariable();
     void testExportMap();
 };
 
@@ -62,6 +72,36 @@ class ExportMapTest: public CppUnit::TestFixture {
 CPPUNIT_TEST_SUITE_REGISTRATION(ExportMapTest);
 
 
+/*
+ * Increments a counter and a map entry from another thread.
+ */
+class IncrementThread: public ola::thread::Thread {
+ public:
+  IncrementThread(CounterVariable *counter, UIntMapHandle handle)
+      : Thread(),
+        m_counter(counter),
+        m_handle(handle) {
+  }
+
+  static const unsigned int INCREMENTS = 100000;
+
+ protected:
+  void *Run() {
+    for (unsigned int i = 0; i < INCREMENTS; i++) {
+      (*m_counter)++;
+      m_handle.Increment();
+    }
+    return NULL;
+  }
+
+ private:
+  CounterVariable *m_counter;
+  UIntMapHandle m_handle;
+};
+
+const unsigned int IncrementThread::INCREMENTS;
+
+
 /*
  * Check that the IntegerVariable works correctly.
  */
@@ -213,6 +253,117 @@ void ExportMapTest::testIntMapVariable() {
   OLA_ASSERT_EQ(var.Value(), string("map:count key1:1"));
 }
 
+
+/*
+ * Check that handles to map entries work correctly.
+ */
+void ExportMapTest::testMapVariableHandle() {
+  UIntMap var("foo", "count");
+
+  // An invalid handle ignores updates
+  UIntMapHandle invalid_handle;
+  OLA_ASSERT_FALSE(invalid_handle.IsValid());
+  invalid_handle.Increment();
+  invalid_handle.Set(4);
+  OLA_ASSERT_EQ(0u, invalid_handle.Get());
+
+  UIntMapHandle handle = var.GetHandle("key1");
+  OLA_ASSERT_TRUE(handle.IsValid());
+  OLA_ASSERT_EQ(var.Value(), string("map:count key1:0"));
+
+  handle.Increment();
+  handle.Increment();
+  OLA_ASSERT_EQ(2u, handle.Get());
+  OLA_ASSERT_EQ(2u, var["key1"]);
+  handle.Decrement();
+  OLA_ASSERT_EQ(var.Value(), string("map:count key1:1"));
+
+  // Adding other keys doesn't invalidate the handle
+  var["key0"] = 7;
+  var["key2"] = 9;
+  handle.Set(10);
+  OLA_ASSERT_EQ(var.Value(), string("map:count key0:7 key1:10 key2:9"));
+
+  // Handles to the same key share the value
+  UIntMapHandle handle2 = var.GetHandle("key1");
+  handle2.Increment();
+  OLA_ASSERT_EQ(11u, handle.Get());
+}
+
+/*
+ * Check that the HistogramVariable works correctly.
+ */
+void ExportMapTest::testHistogramVariable() {
+  HistogramVariable var("latency");
+  OLA_ASSERT_EQ(var.Name(), string("latency"));
+  OLA_ASSERT_EQ(0u, var.Count());
+  OLA_ASSERT_EQ(0u, var.Percentile(50));
+  OLA_ASSERT_EQ(var.Value(), string("count:0 p50:0 p99:0 p999:0 max:0"));
+
+  // Small values are exact
+  for (unsigned int i = 1; i <= 8; i++) {
+    var.Record(i);
+  }
+  OLA_ASSERT_EQ(8u, var.Count());
+  OLA_ASSERT_EQ(8u, var.Max());
+  OLA_ASSERT_EQ(1u, var.Percentile(0));
+  OLA_ASSERT_EQ(4u, var.Percentile(50));
+  OLA_ASSERT_EQ(8u, var.Percentile(100));
+
+  // 1000 samples from 1 to 1000; the percentiles are within one bucket.
+  var.Reset();
+  OLA_ASSERT_EQ(0u, var.Count());
+  for (unsigned int i = 1; i <= 1000; i++) {
+    var.Record(i);
+  }
+  OLA_ASSERT_EQ(1000u, var.Count());
+  OLA_ASSERT_EQ(1000u, var.Max());
+  unsigned int p50 = var.Percentile(50);
+  OLA_ASSERT_TRUE(p50 >= 500 && p50 < 500 * 9 / 8);
+  unsigned int p99 = var.Percentile(99);
+  OLA_ASSERT_TRUE(p99 >= 990 && p99 <= 1000);
+  OLA_ASSERT_EQ(1000u, var.Percentile(99.9));
+  OLA_ASSERT_EQ(var.Value(),
+                string("count:1000 p50:511 p99:1000 p999:1000 max:1000"));
+
+  // Outliers are reported in the tail only
+  var.Reset();
+  for (unsigned int i = 0; i < 999; i++) {
+    var.Record(100);
+  }
+  var.Record(1000000);
+  OLA_ASSERT_EQ(103u, var.Percentile(50));
+  OLA_ASSERT_EQ(103u, var.Percentile(99.9));
+  OLA_ASSERT_EQ(1000000u, var.Percentile(100));
+  OLA_ASSERT_EQ(1000000u, var.Max());
+
+  // Large values are clamped
+  var.Reset();
+  var.Record(static_cast<uint64_t>(1) << 40);
+  OLA_ASSERT_EQ(0xffffffffu, var.Max());
+  OLA_ASSERT_EQ(0xffffffffu, var.Percentile(50));
+}
+
+
+/*
+ * Check counters and handles can be updated from several threads.
+ */
+void ExportMapTest::testConcurrentIncrement() {
+  CounterVariable counter("foo");
+  UIntMap map("bar", "count");
+  UIntMapHandle handle = map.GetHandle("key1");
+
+  IncrementThread thread1(&counter, handle), thread2(&counter, handle);
+  OLA_ASSERT_TRUE(thread1.Start());
+  OLA_ASSERT_TRUE(thread2.Start());
+  OLA_ASSERT_TRUE(thread1.Join());
+  OLA_ASSERT_TRUE(thread2.Join());
+
+  OLA_ASSERT_EQ(2 * IncrementThread::INCREMENTS, counter.Get());
+  OLA_ASSERT_EQ(2 * IncrementThread::INCREMENTS, handle.Get());
+}
+
+
 /*
  * Check the export map works correctly.
  */
@@ -227,6 +378,7 @@ void ExportMapTest::testExportMap() {
   IntegerVariable *int_var = map.GetIntegerVar(int_var_name);
   StringVariable *str_var = map.GetStringVar(str_var_name);
   StringMap *map_var = map.GetStringMapVar(map_var_name, map_var_label);
+  HistogramVariable *histogram_var = map.GetHistogramVar("histogram_var");
 
   OLA_ASSERT_EQ(bool_var->Name(), bool_var_name);
   OLA_ASSERT_EQ(int_var->Name(), int_var_name);
@@ -238,6 +390,17 @@ void ExportMapTest::testExportMap() {
   OLA_ASSERT_EQ(map_var->Name(), map_var_name);
   OLA_ASSERT_EQ(map_var->Label(), map_var_label);
 
+  OLA_ASSERT_EQ(histogram_var, map.GetHistogramVar("histogram_var"));
+  vector<HistogramVariable*> histograms = map.AllHistograms();
+  OLA_ASSERT_EQ(histograms.size(), (size_t) 1);
+  OLA_ASSERT_EQ(histogram_var, histograms[0]);
+
   vector<BaseVariable*> variables = map.AllVariables();
+  OLA_ASSERT_EQ(variables.size(), (size_t) 5);
+
+  map.RemoveHistogramVar("histogram_var");
+  map.RemoveHistogramVar("unknown_var");
+  OLA_ASSERT_TRUE(map.AllHistograms().empty());
+  variables = map.AllVariables();
   OLA_ASSERT_EQ(variables.size(), (size_t) 4);
 }
@@ -22,6 +22,7 @@
 #include <ola/http/OlaHTTPServer.h>
 #include <ola/ExportMap.h>
 #include <ola/Clock.h>
+#include <ola/web/Json.h>
 #include <memory>
 #include <string>
 #include <vector>
@@ -30,6 +31,7 @@ namespace ola {
 namespace http {
 
 using ola::ExportMap;
+using ola::web::JsonObject;
 using std::auto_ptr;
 using std::ostringstream;
 using std::string;
@@ -49,6 +51,7 @@ OlaHTTPServer::OlaHTTPServer(const HTTPServer::HTTPServerOptions &options,
       m_server(options) {
   RegisterHandler("/debug", &OlaHTTPServer::DisplayDebug);
   RegisterHandler("/help", &OlaHTTPServer::DisplayHandlers);
+  RegisterHandler("/json/histograms", &OlaHTTPServer::JsonHistograms);
 
   StringVariable *data_dir_var = export_map->GetStringVar(K_DATA_DIR_VAR);
   data_dir_var->Set(m_server.DataDir());
@@ -93,6 +96,31 @@ int OlaHTTPServer::DisplayDebug(const HTTPRequest*,
 }
 
 
+/**
+ * Return the percentiles of the histogram variables in the ExportMap as JSON.
+ */
+int OlaHTTPServer::JsonHistograms(const HTTPRequest*,
+                                  HTTPResponse *raw_response) {
+  auto_ptr<HTTPResponse> response(raw_response);
+  vector<HistogramVariable*> histograms = m_export_map->AllHistograms();
+
+  JsonObject json;
+  vector<HistogramVariable*>::const_iterator iter;
+  for (iter = histograms.begin(); iter != histograms.end(); ++iter) {
+    JsonObject *histogram = json.AddObject((*iter)->Name());
+    histogram->Add("count", (*iter)->Count());
+    histogram->Add("p50", (*iter)->Percentile(50));
+    histogram->Add("p99", (*iter)->Percentile(99));
+    histogram->Add("p999", (*iter)->Percentile(99.9));
+    histogram->Add("max", (*iter)->Max());
+  }
+
+  response->SetNoCache();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
+  return response->SendJson(json);
+}
+
+
 /**
  * Display a list of registered handlers
  */
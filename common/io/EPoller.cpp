@@ -143,11 +143,16 @@ EPoller::EPoller(ExportMap *export_map, Clock* clock)
     : m_export_map(export_map),
       m_loop_iterations(NULL),
       m_loop_time(NULL),
+      m_loop_histogram(NULL),
+      m_connected_descriptors_var(NULL),
       m_epoll_fd(INVALID_DESCRIPTOR),
       m_clock(clock) {
   if (m_export_map) {
     m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
     m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+    m_loop_histogram = m_export_map->GetHistogramVar(K_LOOP_HISTOGRAM);
+    m_connected_descriptors_var = m_export_map->GetIntegerVar(
+        K_CONNECTED_DESCRIPTORS_VAR);
   }
 
   m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
@@ -310,6 +315,12 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
       (*m_loop_iterations)++;
   }
 
+  // The time from the last wake up until now covers dispatching the events,
+  // running the timeouts and any work the SelectServer did between polls.
+  if (m_loop_histogram && m_loop_start_time.IsSet()) {
+    m_loop_histogram->Record((now - m_loop_start_time).AsInt());
+  }
+
   int ms_to_sleep = sleep_interval.InMilliSeconds();
   // If we haven't been asked to wait as part of the poll interval, then don't
   // wait in the epoll to allow for fast streaming
@@ -318,6 +329,7 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
 
   if (ready == 0) {
     m_clock->CurrentMonotonicTime(&m_wake_up_time);
+    m_loop_start_time = m_wake_up_time;
     timeout_manager->ExecuteTimeouts(&m_wake_up_time);
     return true;
   } else if (ready == -1) {
@@ -328,6 +340,7 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
   }
 
   m_clock->CurrentMonotonicTime(&m_wake_up_time);
+  m_loop_start_time = m_wake_up_time;
 
   for (int i = 0; i < ready; i++) {
     EPollData *descriptor = reinterpret_cast<EPollData*>(
@@ -379,8 +392,8 @@ void EPoller::CheckDescriptor(struct epoll_event *event,
         bool removed = RemoveDescriptor(
             epoll_data->connected_descriptor->ReadDescriptor(), READ_FLAGS,
             false);
-        if (removed && m_export_map) {
-          (*m_export_map->GetIntegerVar(K_CONNECTED_DESCRIPTORS_VAR))--;
+        if (removed && m_connected_descriptors_var) {
+          (*m_connected_descriptors_var)--;
         }
         delete epoll_data->connected_descriptor;
         epoll_data->connected_descriptor = NULL;
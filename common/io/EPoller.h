@@ -89,9 +89,12 @@ class EPoller : public PollerInterface {
   ExportMap *m_export_map;
   CounterVariable *m_loop_iterations;
   CounterVariable *m_loop_time;
+  HistogramVariable *m_loop_histogram;
+  IntegerVariable *m_connected_descriptors_var;
   int m_epoll_fd;
   Clock *m_clock;
   TimeStamp m_wake_up_time;
+  TimeStamp m_loop_start_time;  // when the last poll returned
 
   std::pair<EPollData*, bool> LookupOrCreateDescriptor(int fd);
 
@@ -90,12 +90,15 @@ KQueuePoller::KQueuePoller(ExportMap *export_map, Clock* clock)
     : m_export_map(export_map),
       m_loop_iterations(NULL),
       m_loop_time(NULL),
+      m_connected_descriptors_var(NULL),
       m_kqueue_fd(INVALID_DESCRIPTOR),
       m_next_change_entry(0),
       m_clock(clock) {
   if (m_export_map) {
     m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
     m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+    m_connected_descriptors_var = m_export_map->GetIntegerVar(
+        K_CONNECTED_DESCRIPTORS_VAR);
   }
 
   m_kqueue_fd = kqueue();
@@ -342,8 +345,8 @@ void KQueuePoller::CheckDescriptor(struct kevent *event) {
           kqueue_data = STLLookupAndRemovePtr(&m_descriptor_map, event->ident);
           if (kqueue_data) {
             m_orphaned_descriptors.push_back(kqueue_data);
-            if (m_export_map) {
-              (*m_export_map->GetIntegerVar(K_CONNECTED_DESCRIPTORS_VAR))--;
+            if (m_connected_descriptors_var) {
+              (*m_connected_descriptors_var)--;
             }
           }
         }
@@ -91,6 +91,7 @@ class KQueuePoller : public PollerInterface {
   ExportMap *m_export_map;
   CounterVariable *m_loop_iterations;
   CounterVariable *m_loop_time;
+  IntegerVariable *m_connected_descriptors_var;
   int m_kqueue_fd;
 
   struct kevent m_change_set[CHANGE_SET_SIZE];
@@ -51,5 +51,10 @@ const char PollerInterface::K_LOOP_TIME[] = "ss-loop-time";
  */
 const char PollerInterface::K_LOOP_COUNT[] = "ss-loop-count";
 
+/**
+ * @brief The time in microseconds from waking up to the next poll.
+ */
+const char PollerInterface::K_LOOP_HISTOGRAM[] = "ss-loop-time-us";
+
 }  // namespace io
 }  // namespace ola
@@ -147,6 +147,7 @@ class PollerInterface {
  protected:
   static const char K_LOOP_TIME[];
   static const char K_LOOP_COUNT[];
+  static const char K_LOOP_HISTOGRAM[];
 };
 }  // namespace io
 }  // namespace ola
@@ -101,10 +101,13 @@ SelectPoller::SelectPoller(ExportMap *export_map, Clock* clock)
     : m_export_map(export_map),
       m_loop_iterations(NULL),
       m_loop_time(NULL),
+      m_connected_descriptors_var(NULL),
       m_clock(clock) {
   if (m_export_map) {
     m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
     m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+    m_connected_descriptors_var = m_export_map->GetIntegerVar(
+        K_CONNECTED_DESCRIPTORS_VAR);
   }
 }
 
@@ -401,8 +404,8 @@ void SelectPoller::CheckDescriptors(fd_set *r_set, fd_set *w_set) {
 
       delete con_iter->second;
       con_iter->second = NULL;
-      if (m_export_map) {
-        (*m_export_map->GetIntegerVar(K_CONNECTED_DESCRIPTORS_VAR))--;
+      if (m_connected_descriptors_var) {
+        (*m_connected_descriptors_var)--;
       }
 
       if (on_close)
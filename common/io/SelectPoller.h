@@ -78,6 +78,7 @@ class SelectPoller : public PollerInterface {
   ExportMap *m_export_map;
   CounterVariable *m_loop_iterations;
   CounterVariable *m_loop_time;
+  IntegerVariable *m_connected_descriptors_var;
   Clock *m_clock;
   TimeStamp m_wake_up_time;
 
@@ -74,6 +74,11 @@ using std::max;
 
 const TimeStamp SelectServer::empty_time;
 
+struct SelectServer::IncomingCallback {
+  ola::BaseCallback0<void> *callback;
+  IncomingCallback *next;
+};
+
 SelectServer::SelectServer(ExportMap *export_map,
                            Clock *clock)
     : m_export_map(export_map),
@@ -81,7 +86,11 @@ SelectServer::SelectServer(ExportMap *export_map,
       m_is_running(false),
       m_poll_interval(POLL_INTERVAL_SECOND, POLL_INTERVAL_USECOND),
       m_clock(clock),
-      m_free_clock(false) {
+      m_free_clock(false),
+      m_read_descriptor_var(NULL),
+      m_write_descriptor_var(NULL),
+      m_connected_descriptor_var(NULL),
+      m_incoming_callbacks(NULL) {
   Options options;
   Init(options);
 }
@@ -92,7 +101,11 @@ SelectServer::SelectServer(const Options &options)
       m_is_running(false),
       m_poll_interval(POLL_INTERVAL_SECOND, POLL_INTERVAL_USECOND),
       m_clock(options.clock),
-      m_free_clock(false) {
+      m_free_clock(false),
+      m_read_descriptor_var(NULL),
+      m_write_descriptor_var(NULL),
+      m_connected_descriptor_var(NULL),
+      m_incoming_callbacks(NULL) {
   Init(options);
 }
 
@@ -152,8 +165,8 @@ void SelectServer::RunOnce(const TimeInterval &block_interval) {
 
 bool SelectServer::AddReadDescriptor(ReadFileDescriptor *descriptor) {
   bool added =  m_poller->AddReadDescriptor(descriptor);
-  if (added && m_export_map) {
-    (*m_export_map->GetIntegerVar(PollerInterface::K_READ_DESCRIPTOR_VAR))++;
+  if (added && m_read_descriptor_var) {
+    (*m_read_descriptor_var)++;
   }
   return added;
 }
@@ -161,9 +174,8 @@ bool SelectServer::AddReadDescriptor(ReadFileDescriptor *descriptor) {
 bool SelectServer::AddReadDescriptor(ConnectedDescriptor *descriptor,
                                      bool delete_on_close) {
   bool added =  m_poller->AddReadDescriptor(descriptor, delete_on_close);
-  if (added && m_export_map) {
-    (*m_export_map->GetIntegerVar(
-        PollerInterface::K_CONNECTED_DESCRIPTORS_VAR))++;
+  if (added && m_connected_descriptor_var) {
+    (*m_connected_descriptor_var)++;
   }
   return added;
 }
@@ -175,9 +187,8 @@ void SelectServer::RemoveReadDescriptor(ReadFileDescriptor *descriptor) {
   }
 
   bool removed = m_poller->RemoveReadDescriptor(descriptor);
-  if (removed && m_export_map) {
-    (*m_export_map->GetIntegerVar(
-        PollerInterface::K_READ_DESCRIPTOR_VAR))--;
+  if (removed && m_read_descriptor_var) {
+    (*m_read_descriptor_var)--;
   }
 }
 
@@ -188,16 +199,15 @@ void SelectServer::RemoveReadDescriptor(ConnectedDescriptor *descriptor) {
   }
 
   bool removed = m_poller->RemoveReadDescriptor(descriptor);
-  if (removed && m_export_map) {
-    (*m_export_map->GetIntegerVar(
-        PollerInterface::K_CONNECTED_DESCRIPTORS_VAR))--;
+  if (removed && m_connected_descriptor_var) {
+    (*m_connected_descriptor_var)--;
   }
 }
 
 bool SelectServer::AddWriteDescriptor(WriteFileDescriptor *descriptor) {
   bool added = m_poller->AddWriteDescriptor(descriptor);
-  if (added && m_export_map) {
-    (*m_export_map->GetIntegerVar(PollerInterface::K_WRITE_DESCRIPTOR_VAR))++;
+  if (added && m_write_descriptor_var) {
+    (*m_write_descriptor_var)++;
   }
   return added;
 }
@@ -209,8 +219,8 @@ void SelectServer::RemoveWriteDescriptor(WriteFileDescriptor *descriptor) {
   }
 
   bool removed = m_poller->RemoveWriteDescriptor(descriptor);
-  if (removed && m_export_map) {
-    (*m_export_map->GetIntegerVar(PollerInterface::K_WRITE_DESCRIPTOR_VAR))--;
+  if (removed && m_write_descriptor_var) {
+    (*m_write_descriptor_var)--;
   }
 }
 
@@ -251,31 +261,43 @@ void SelectServer::RunInLoop(Callback0<void> *callback) {
 }
 
 void SelectServer::Execute(ola::BaseCallback0<void> *callback) {
+  IncomingCallback *node = new IncomingCallback;
+  node->callback = callback;
+
+  // Push onto the stack, the SelectServer thread takes the entire stack at
+  // once, so there's no ABA problem here.
+  IncomingCallback *head;
+#ifdef HAVE_ATOMIC_BUILTINS
+  head = __atomic_load_n(&m_incoming_callbacks, __ATOMIC_RELAXED);
+  do {
+    node->next = head;
+  } while (!__atomic_compare_exchange_n(&m_incoming_callbacks, &head, node,
+                                        true, __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED));
+#else
   {
     ola::thread::MutexLocker locker(&m_incoming_mutex);
-    m_incoming_callbacks.push_back(callback);
+    head = m_incoming_callbacks;
+    node->next = head;
+    m_incoming_callbacks = node;
   }
+#endif  // HAVE_ATOMIC_BUILTINS
 
   // kick select(), we do this even if we're in the same thread as select() is
   // called. If we don't do this there is a race condition because a callback
   // may be added just prior to select(). Without this kick, select() will
   // sleep for the poll_interval before executing the callback.
-  uint8_t wake_up = 'a';
-  m_incoming_descriptor.Send(&wake_up, sizeof(wake_up));
+  // If the stack wasn't empty, whoever added the first callback has already
+  // kicked select() and the callbacks haven't been taken yet.
+  if (head == NULL) {
+    uint8_t wake_up = 'a';
+    m_incoming_descriptor.Send(&wake_up, sizeof(wake_up));
+  }
 }
 
 
 void SelectServer::DrainCallbacks() {
-  Callbacks callbacks_to_run;
-  while (true) {
-    {
-      ola::thread::MutexLocker locker(&m_incoming_mutex);
-      if (m_incoming_callbacks.empty()) {
-        return;
-      }
-      callbacks_to_run.swap(m_incoming_callbacks);
-    }
-    RunCallbacks(&callbacks_to_run);
+  while (RunIncomingCallbacks()) {
   }
 }
 
@@ -286,12 +308,18 @@ void SelectServer::Init(const Options &options) {
   }
 
   if (m_export_map) {
-    m_export_map->GetIntegerVar(PollerInterface::K_READ_DESCRIPTOR_VAR);
-    m_export_map->GetIntegerVar(PollerInterface::K_WRITE_DESCRIPTOR_VAR);
-    m_export_map->GetIntegerVar(PollerInterface::K_CONNECTED_DESCRIPTORS_VAR);
+    m_read_descriptor_var = m_export_map->GetIntegerVar(
+        PollerInterface::K_READ_DESCRIPTOR_VAR);
+    m_write_descriptor_var = m_export_map->GetIntegerVar(
+        PollerInterface::K_WRITE_DESCRIPTOR_VAR);
+    m_connected_descriptor_var = m_export_map->GetIntegerVar(
+        PollerInterface::K_CONNECTED_DESCRIPTORS_VAR);
   }
 
-  m_timeout_manager.reset(new TimeoutManager(m_export_map, m_clock));
+  m_timeout_manager.reset(new TimeoutManager(
+      m_export_map, m_clock,
+      options.use_timer_wheel ? TimeoutManager::TIMER_WHEEL :
+                                TimeoutManager::PRIORITY_QUEUE));
 #ifdef _WIN32
   m_poller.reset(new WindowsPoller(m_export_map, m_clock));
   (void) options;
@@ -363,26 +391,50 @@ void SelectServer::DrainAndExecute() {
                                   sizeof(message), size);
   }
 
-  // We can't hold the mutex while we execute the callback, so instead we swap
-  // out the vector under a lock, release the lock and then run all the
-  // callbacks.
-  Callbacks callbacks_to_run;
+  RunIncomingCallbacks();
+}
+
+/*
+ * Take the callbacks added with Execute() and run them. Callbacks added while
+ * these are running are left for the next call.
+ * @returns true if any callbacks were run.
+ */
+bool SelectServer::RunIncomingCallbacks() {
+  IncomingCallback *head;
+#ifdef HAVE_ATOMIC_BUILTINS
+  head = __atomic_exchange_n(&m_incoming_callbacks,
+                             static_cast<IncomingCallback*>(NULL),
+                             __ATOMIC_ACQUIRE);
+#else
   {
     thread::MutexLocker lock(&m_incoming_mutex);
-    callbacks_to_run.swap(m_incoming_callbacks);
+    head = m_incoming_callbacks;
+    m_incoming_callbacks = NULL;
   }
+#endif  // HAVE_ATOMIC_BUILTINS
 
-  RunCallbacks(&callbacks_to_run);
-}
+  if (!head) {
+    return false;
+  }
+
+  // The stack is newest first, reverse it so the callbacks run in order.
+  IncomingCallback *callbacks = NULL;
+  while (head) {
+    IncomingCallback *next = head->next;
+    head->next = callbacks;
+    callbacks = head;
+    head = next;
+  }
 
-void SelectServer::RunCallbacks(Callbacks *callbacks) {
-  Callbacks::iterator iter = callbacks->begin();
-  for (; iter != callbacks->end(); ++iter) {
-    if (*iter) {
-      (*iter)->Run();
+  while (callbacks) {
+    IncomingCallback *node = callbacks;
+    callbacks = node->next;
+    if (node->callback) {
+      node->callback->Run();
     }
+    delete node;
   }
-  callbacks->clear();
+  return true;
 }
 }  // namespace io
 }  // namespace ola
@@ -21,9 +21,12 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <vector>
+
 #include "ola/testing/TestUtils.h"
 
 #include "ola/Callback.h"
+#include "ola/Clock.h"
 #include "ola/Logging.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/Socket.h"
@@ -31,6 +34,8 @@
 // to be after WinSock2.h, hence this order
 #include "ola/thread/Thread.h"
 
+using ola::Clock;
+using ola::TimeStamp;
 using ola::io::SelectServer;
 using ola::network::UDPSocket;
 using ola::thread::ThreadId;
@@ -66,18 +71,86 @@ class TestThread: public ola::thread::Thread {
 };
 
 
+/*
+ * Counts callbacks and terminates the SelectServer once all have run.
+ */
+class CallbackCounter {
+ public:
+    CallbackCounter(SelectServer *ss, unsigned int expected)
+        : m_ss(ss),
+          m_expected(expected),
+          m_count(0) {
+    }
+
+    void Increment() {
+      if (++m_count == m_expected) {
+        m_ss->Terminate();
+      }
+    }
+
+    unsigned int Count() const { return m_count; }
+
+ private:
+    SelectServer *m_ss;
+    unsigned int m_expected;
+    unsigned int m_count;
+};
+
+
+/*
+ * Posts a number of callbacks to the SelectServer as fast as it can.
+ */
+class PostingThread: public ola::thread::Thread {
+ public:
+    PostingThread(SelectServer *ss,
+                  CallbackCounter *counter,
+                  unsigned int count)
+        : m_ss(ss),
+          m_counter(counter),
+          m_count(count) {
+    }
+
+    void *Run() {
+      for (unsigned int i = 0; i < m_count; i++) {
+        m_ss->Execute(
+            ola::NewSingleCallback(m_counter, &CallbackCounter::Increment));
+      }
+      return NULL;
+    }
+
+ private:
+    SelectServer *m_ss;
+    CallbackCounter *m_counter;
+    unsigned int m_count;
+};
+
+
 class SelectServerThreadTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(SelectServerThreadTest);
   CPPUNIT_TEST(testSameThreadCallback);
   CPPUNIT_TEST(testDifferentThreadCallback);
+  CPPUNIT_TEST(testCallbackOrder);
+  CPPUNIT_TEST(testManyThreadBenchmark);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void testSameThreadCallback();
   void testDifferentThreadCallback();
+  void testCallbackOrder();
+  void testManyThreadBenchmark();
+
+  void RecordCallback(unsigned int i) {
+    m_order.push_back(i);
+    if (m_order.size() == CALLBACK_COUNT) {
+      m_ss.Terminate();
+    }
+  }
 
  private:
   SelectServer m_ss;
+  std::vector<unsigned int> m_order;
+
+  static const unsigned int CALLBACK_COUNT = 100;
 };
 
 
@@ -108,3 +181,58 @@ void SelectServerThreadTest::testDifferentThreadCallback() {
   test_thread.Join();
   OLA_ASSERT_TRUE(test_thread.CallbackRun());
 }
+
+
+/*
+ * Check that callbacks run in the order they were added.
+ */
+void SelectServerThreadTest::testCallbackOrder() {
+  for (unsigned int i = 0; i < CALLBACK_COUNT; i++) {
+    m_ss.Execute(
+        ola::NewSingleCallback(this, &SelectServerThreadTest::RecordCallback,
+                               i));
+  }
+  m_ss.Run();
+
+  OLA_ASSERT_EQ(static_cast<size_t>(CALLBACK_COUNT), m_order.size());
+  for (unsigned int i = 0; i < CALLBACK_COUNT; i++) {
+    OLA_ASSERT_EQ(i, m_order[i]);
+  }
+}
+
+
+/*
+ * Measure the rate at which 8 threads can post callbacks to the SelectServer.
+ */
+void SelectServerThreadTest::testManyThreadBenchmark() {
+  const unsigned int THREAD_COUNT = 8;
+  const unsigned int CALLBACKS_PER_THREAD = 50000;
+  CallbackCounter counter(&m_ss, THREAD_COUNT * CALLBACKS_PER_THREAD);
+
+  std::vector<PostingThread*> threads;
+  for (unsigned int i = 0; i < THREAD_COUNT; i++) {
+    threads.push_back(
+        new PostingThread(&m_ss, &counter, CALLBACKS_PER_THREAD));
+  }
+
+  Clock clock;
+  TimeStamp start, end;
+  clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < THREAD_COUNT; i++) {
+    threads[i]->Start();
+  }
+  m_ss.Run();
+  clock.CurrentMonotonicTime(&end);
+
+  for (unsigned int i = 0; i < THREAD_COUNT; i++) {
+    threads[i]->Join();
+    delete threads[i];
+  }
+
+  OLA_ASSERT_EQ(THREAD_COUNT * CALLBACKS_PER_THREAD, counter.Count());
+  int64_t elapsed = (end - start).AsInt();
+  OLA_INFO << THREAD_COUNT << " threads posted " << counter.Count()
+           << " callbacks in " << elapsed / 1000 << "ms, "
+           << (elapsed ? counter.Count() * 1000000ll / elapsed : 0)
+           << " posts/sec";
+}
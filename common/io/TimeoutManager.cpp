@@ -18,6 +18,7 @@
  * Copyright (C) 2013 Simon Newton
  */
 
+#include <algorithm>
 #include <queue>
 #include <set>
 #include <vector>
@@ -37,11 +38,29 @@ using ola::thread::INVALID_TIMEOUT;
 using ola::thread::timeout_id;
 
 TimeoutManager::TimeoutManager(ExportMap *export_map,
-                               Clock *clock)
+                               Clock *clock,
+                               TimerImplementation implementation)
     : m_export_map(export_map),
-      m_clock(clock) {
+      m_timer_var(NULL),
+      m_clock(clock),
+      m_use_wheel(implementation == TIMER_WHEEL),
+      m_wheel_tick(0),
+      m_wheel_running_event(NULL),
+      m_wheel_running_cancelled(false) {
   if (m_export_map) {
-    m_export_map->GetIntegerVar(K_TIMER_VAR);
+    m_timer_var = m_export_map->GetIntegerVar(K_TIMER_VAR);
+  }
+
+  std::fill(m_wheel_level_counts, m_wheel_level_counts + WHEEL_LEVELS, 0);
+  if (m_use_wheel) {
+    m_clock->CurrentMonotonicTime(&m_wheel_epoch);
+    // The buckets are sentinels, they must point at themselves, not at the
+    // temporary they were copied from.
+    m_wheel_buckets.resize(WHEEL_LEVELS * WHEEL_SIZE);
+    std::vector<WheelNode>::iterator iter = m_wheel_buckets.begin();
+    for (; iter != m_wheel_buckets.end(); ++iter) {
+      iter->Reset();
+    }
   }
 }
 
@@ -52,6 +71,12 @@ TimeoutManager::~TimeoutManager() {
     delete m_events.top();
     m_events.pop();
   }
+
+  wheel_event_map::iterator iter = m_wheel_events.begin();
+  for (; iter != m_wheel_events.end(); ++iter) {
+    delete iter->second;
+  }
+  m_wheel_events.clear();
 }
 
 timeout_id TimeoutManager::RegisterRepeatingTimeout(
@@ -60,11 +85,11 @@ timeout_id TimeoutManager::RegisterRepeatingTimeout(
   if (!closure)
     return INVALID_TIMEOUT;
 
-  if (m_export_map)
-    (*m_export_map->GetIntegerVar(K_TIMER_VAR))++;
+  if (m_timer_var)
+    (*m_timer_var)++;
 
   Event *event = new RepeatingEvent(interval, m_clock, closure);
-  m_events.push(event);
+  AddEvent(event);
   return event;
 }
 
@@ -74,11 +99,11 @@ timeout_id TimeoutManager::RegisterSingleTimeout(
   if (!closure)
     return INVALID_TIMEOUT;
 
-  if (m_export_map)
-    (*m_export_map->GetIntegerVar(K_TIMER_VAR))++;
+  if (m_timer_var)
+    (*m_timer_var)++;
 
   Event *event = new SingleEvent(interval, m_clock, closure);
-  m_events.push(event);
+  AddEvent(event);
   return event;
 }
 
@@ -88,11 +113,31 @@ void TimeoutManager::CancelTimeout(timeout_id id) {
   if (id == INVALID_TIMEOUT)
     return;
 
+  if (m_use_wheel) {
+    wheel_event_map::iterator iter = m_wheel_events.find(id);
+    if (iter == m_wheel_events.end())
+      return;
+
+    Event *event = iter->second;
+    if (event == m_wheel_running_event) {
+      // Cleaned up once the callback returns.
+      m_wheel_running_cancelled = true;
+      return;
+    }
+    m_wheel_events.erase(iter);
+    WheelRemove(event);
+    ReleaseEvent(event);
+    return;
+  }
+
   if (!m_removed_timeouts.insert(id).second)
     OLA_WARN << "timeout " << id << " already in remove set";
 }
 
 TimeInterval TimeoutManager::ExecuteTimeouts(TimeStamp *now) {
+  if (m_use_wheel)
+    return ExecuteWheelTimeouts(now);
+
   Event *e;
   if (m_events.empty())
     return TimeInterval();
@@ -104,8 +149,8 @@ TimeInterval TimeoutManager::ExecuteTimeouts(TimeStamp *now) {
     // if this was removed, skip it
     if (m_removed_timeouts.erase(e)) {
       delete e;
-      if (m_export_map)
-        (*m_export_map->GetIntegerVar(K_TIMER_VAR))--;
+      if (m_timer_var)
+        (*m_timer_var)--;
       continue;
     }
 
@@ -115,8 +160,8 @@ TimeInterval TimeoutManager::ExecuteTimeouts(TimeStamp *now) {
       m_events.push(e);
     } else {
       delete e;
-      if (m_export_map)
-        (*m_export_map->GetIntegerVar(K_TIMER_VAR))--;
+      if (m_timer_var)
+        (*m_timer_var)--;
     }
     m_clock->CurrentMonotonicTime(now);
   }
@@ -126,5 +171,202 @@ TimeInterval TimeoutManager::ExecuteTimeouts(TimeStamp *now) {
   else
     return m_events.top()->NextTime() - *now;
 }
+
+void TimeoutManager::AddEvent(Event *event) {
+  if (m_use_wheel) {
+    m_wheel_events[event] = event;
+    WheelInsert(event);
+  } else {
+    m_events.push(event);
+  }
+}
+
+void TimeoutManager::ReleaseEvent(Event *event) {
+  delete event;
+  if (m_timer_var)
+    (*m_timer_var)--;
+}
+
+/*
+ * The timer wheel is made up of WHEEL_LEVELS wheels, each of WHEEL_SIZE
+ * buckets. Level 0 has a bucket per tick, level 1 a bucket per WHEEL_SIZE
+ * ticks and so on. As the current tick crosses the boundary of a bucket in
+ * one of the outer wheels, the events in that bucket are cascaded down to the
+ * inner wheels. Events only run from the current bucket of level 0.
+ */
+TimeInterval TimeoutManager::ExecuteWheelTimeouts(TimeStamp *now) {
+  while (true) {
+    bool triggered = WheelRunBucket(now);
+
+    const uint64_t target = WheelTick(*now);
+    if (m_wheel_events.empty()) {
+      m_wheel_tick = std::max(m_wheel_tick, target);
+      break;
+    }
+
+    if (m_wheel_tick >= target) {
+      // Callbacks may have registered events that are already due.
+      if (triggered)
+        continue;
+      break;
+    }
+
+    if (m_wheel_level_counts[0] == 0) {
+      // Skip straight to the next point we may need to cascade.
+      m_wheel_tick = std::min(target, (m_wheel_tick | WHEEL_MASK) + 1);
+    } else {
+      m_wheel_tick++;
+    }
+
+    uint64_t index = m_wheel_tick;
+    for (unsigned int level = 1;
+         level < WHEEL_LEVELS && (index & WHEEL_MASK) == 0; level++) {
+      index >>= WHEEL_BITS;
+      WheelCascade(level, index & WHEEL_MASK);
+    }
+  }
+  return WheelNextEvent(*now);
+}
+
+uint64_t TimeoutManager::WheelTick(const TimeStamp &time) const {
+  if (time <= m_wheel_epoch)
+    return 0;
+  return (time - m_wheel_epoch).AsInt() / WHEEL_TICK_USECS;
+}
+
+void TimeoutManager::WheelInsert(Event *event) {
+  uint64_t tick = std::max(WheelTick(event->NextTime()), m_wheel_tick);
+  const uint64_t delta = tick - m_wheel_tick;
+
+  unsigned int level = 0;
+  while (level < WHEEL_LEVELS - 1 &&
+         delta >> (WHEEL_BITS * (level + 1))) {
+    level++;
+  }
+
+  // Events beyond the range of the outer wheel are filed under its last
+  // bucket, and re-filed when that bucket is cascaded.
+  const uint64_t max_delta = (1ULL << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+  if (delta > max_delta)
+    tick = m_wheel_tick + max_delta;
+
+  unsigned int bucket = static_cast<unsigned int>(
+      (tick >> (WHEEL_BITS * level)) & WHEEL_MASK);
+  event->level = level;
+  m_wheel_level_counts[level]++;
+  event->InsertBefore(&m_wheel_buckets[level * WHEEL_SIZE + bucket]);
+}
+
+void TimeoutManager::WheelRemove(Event *event) {
+  if (event->level >= 0)
+    m_wheel_level_counts[event->level]--;
+  event->level = -1;
+  event->Unlink();
+}
+
+void TimeoutManager::WheelCascade(unsigned int level, unsigned int bucket) {
+  WheelNode *head = &m_wheel_buckets[level * WHEEL_SIZE + bucket];
+  while (!head->Empty()) {
+    Event *event = static_cast<Event*>(head->next);
+    WheelRemove(event);
+    WheelInsert(event);
+  }
+}
+
+/*
+ * Run the expired events in the current bucket. Returns true if any events
+ * were triggered.
+ */
+bool TimeoutManager::WheelRunBucket(TimeStamp *now) {
+  WheelNode *head = &m_wheel_buckets[m_wheel_tick & WHEEL_MASK];
+  if (head->Empty())
+    return false;
+
+  // Move the events aside, the callbacks may add or cancel timeouts.
+  WheelNode pending;
+  while (!head->Empty()) {
+    Event *event = static_cast<Event*>(head->next);
+    WheelRemove(event);
+    event->InsertBefore(&pending);
+  }
+
+  bool triggered = false;
+  while (!pending.Empty()) {
+    Event *event = static_cast<Event*>(pending.next);
+    event->Unlink();
+
+    if (event->NextTime() > *now) {
+      WheelInsert(event);
+      continue;
+    }
+
+    triggered = true;
+    m_wheel_running_event = event;
+    m_wheel_running_cancelled = false;
+    bool repeat = event->Trigger();
+    m_wheel_running_event = NULL;
+
+    if (repeat && !m_wheel_running_cancelled) {
+      // true implies we need to run this again
+      event->UpdateTime(*now);
+      WheelInsert(event);
+    } else {
+      m_wheel_events.erase(event);
+      ReleaseEvent(event);
+    }
+    m_clock->CurrentMonotonicTime(now);
+  }
+  return triggered;
+}
+
+/*
+ * Return the time until the next event, or the next cascade if that's
+ * sooner.
+ */
+TimeInterval TimeoutManager::WheelNextEvent(const TimeStamp &now) const {
+  if (m_wheel_events.empty())
+    return TimeInterval();
+
+  TimeStamp next;
+  if (m_wheel_level_counts[0]) {
+    for (unsigned int i = 0; i < WHEEL_SIZE; i++) {
+      const WheelNode *head =
+          &m_wheel_buckets[(m_wheel_tick + i) & WHEEL_MASK];
+      const WheelNode *node = head->next;
+      for (; node != head; node = node->next) {
+        const TimeStamp &time = static_cast<const Event*>(node)->NextTime();
+        if (!next.IsSet() || time < next)
+          next = time;
+      }
+      if (next.IsSet())
+        break;
+    }
+  }
+
+  for (unsigned int level = 1; level < WHEEL_LEVELS; level++) {
+    if (m_wheel_level_counts[level] == 0)
+      continue;
+
+    const unsigned int shift = WHEEL_BITS * level;
+    const uint64_t index = m_wheel_tick >> shift;
+    for (unsigned int i = 1; i <= WHEEL_SIZE; i++) {
+      if (m_wheel_buckets[level * WHEEL_SIZE +
+                          ((index + i) & WHEEL_MASK)].Empty()) {
+        continue;
+      }
+      TimeStamp cascade = m_wheel_epoch + TimeInterval(
+          static_cast<int64_t>(((index + i) << shift) * WHEEL_TICK_USECS));
+      if (!next.IsSet() || cascade < next)
+        next = cascade;
+      break;
+    }
+  }
+
+  if (next <= now) {
+    // Don't return zero, that indicates there are no events.
+    return TimeInterval(0, 1);
+  }
+  return next - now;
+}
 }  // namespace io
 }  // namespace ola
@@ -21,6 +21,11 @@
 #ifndef COMMON_IO_TIMEOUTMANAGER_H_
 #define COMMON_IO_TIMEOUTMANAGER_H_
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <stdint.h>
 #include <queue>
 #include <set>
 #include <vector>
@@ -31,6 +36,20 @@
 #include "ola/base/Macro.h"
 #include "ola/thread/SchedulerInterface.h"
 
+#include HASH_MAP_H
+
+#ifndef HAVE_UNORDERED_MAP
+// This adds support for hashing pointers if it's not present
+namespace HASH_NAMESPACE {
+
+template<> struct hash<void*> {
+  size_t operator()(void *x) const {
+    return reinterpret_cast<size_t>(x);
+  }
+};
+}  // namespace HASH_NAMESPACE
+#endif  // HAVE_UNORDERED_MAP
+
 namespace ola {
 namespace io {
 
@@ -41,15 +60,33 @@ namespace io {
  *
  * The TimeoutManager allows Callbacks to trigger at some point in the future.
  * Callbacks can be invoked once, or periodically.
+ *
+ * Two implementations are available. The default keeps events in a priority
+ * queue and records cancelled timeouts in a set, which is checked as events
+ * are popped. The timer wheel stores events in a hierarchy of 1ms buckets,
+ * which makes both registering and cancelling a timeout O(1). This suits
+ * workloads where most timeouts are cancelled before they fire, such as RDM
+ * request timeouts.
  */
 class TimeoutManager {
  public :
+  /**
+   * @brief The data structure used to store the timeouts.
+   */
+  enum TimerImplementation {
+    PRIORITY_QUEUE,  /**< A priority queue and a set of cancelled timeouts */
+    TIMER_WHEEL,  /**< A hierarchical timer wheel */
+  };
+
   /**
    * @brief Create a new TimeoutManager.
    * @param export_map an ExportMap to update
    * @param clock the Clock to use.
+   * @param implementation the data structure used to store timeouts.
    */
-  TimeoutManager(ola::ExportMap *export_map, Clock *clock);
+  TimeoutManager(ola::ExportMap *export_map,
+                 Clock *clock,
+                 TimerImplementation implementation = PRIORITY_QUEUE);
 
   ~TimeoutManager();
 
@@ -85,11 +122,12 @@ class TimeoutManager {
 
   /**
    * @brief Check if there are any events in the queue.
-   * Events remain in the queue even if they have been cancelled.
+   * With the priority queue, events remain in the queue even if they have
+   * been cancelled. The timer wheel removes cancelled events immediately.
    * @returns true if there are events pending, false otherwise.
    */
   bool EventsPending() const {
-    return !m_events.empty();
+    return m_use_wheel ? !m_wheel_events.empty() : !m_events.empty();
   }
 
   /**
@@ -103,7 +141,36 @@ class TimeoutManager {
   static const char K_TIMER_VAR[];
 
  private :
-  class Event {
+  /*
+   * A node in one of the circular, doubly linked lists that make up the timer
+   * wheel. The buckets themselves are sentinel nodes.
+   */
+  struct WheelNode {
+    WheelNode() : prev(this), next(this), level(-1) {}
+
+    WheelNode *prev;
+    WheelNode *next;
+    int level;  // the wheel this node is filed under, or -1
+
+    bool Empty() const { return next == this; }
+
+    void Reset() { prev = next = this; }
+
+    void Unlink() {
+      prev->next = next;
+      next->prev = prev;
+      prev = next = this;
+    }
+
+    void InsertBefore(WheelNode *node) {
+      prev = node->prev;
+      next = node;
+      node->prev->next = this;
+      node->prev = this;
+    }
+  };
+
+  class Event : public WheelNode {
    public:
     explicit Event(const TimeInterval &interval, const Clock *clock)
         : m_interval(interval) {
@@ -187,12 +254,45 @@ class TimeoutManager {
   typedef std::priority_queue<Event*, std::vector<Event*>, ltevent>
       event_queue_t;
 
+  typedef HASH_NAMESPACE::HASH_MAP_CLASS<ola::thread::timeout_id, Event*>
+      wheel_event_map;
+
   ola::ExportMap *m_export_map;
+  IntegerVariable *m_timer_var;
   Clock *m_clock;
+  const bool m_use_wheel;
 
+  // The priority queue implementation
   event_queue_t m_events;
   std::set<ola::thread::timeout_id> m_removed_timeouts;
 
+  static const unsigned int WHEEL_LEVELS = 4;
+  static const unsigned int WHEEL_BITS = 8;
+  static const unsigned int WHEEL_SIZE = 1 << WHEEL_BITS;
+  static const unsigned int WHEEL_MASK = WHEEL_SIZE - 1;
+  // The length of one tick of the innermost wheel, in microseconds.
+  static const int64_t WHEEL_TICK_USECS = 1000;
+
+  // The timer wheel implementation
+  TimeStamp m_wheel_epoch;
+  uint64_t m_wheel_tick;
+  std::vector<WheelNode> m_wheel_buckets;
+  unsigned int m_wheel_level_counts[WHEEL_LEVELS];
+  wheel_event_map m_wheel_events;
+  Event *m_wheel_running_event;
+  bool m_wheel_running_cancelled;
+
+  void AddEvent(Event *event);
+  void ReleaseEvent(Event *event);
+
+  TimeInterval ExecuteWheelTimeouts(TimeStamp *now);
+  uint64_t WheelTick(const TimeStamp &time) const;
+  void WheelInsert(Event *event);
+  void WheelRemove(Event *event);
+  void WheelCascade(unsigned int level, unsigned int bucket);
+  bool WheelRunBucket(TimeStamp *now);
+  TimeInterval WheelNextEvent(const TimeStamp &now) const;
+
   DISALLOW_COPY_AND_ASSIGN(TimeoutManager);
 };
 }  // namespace io
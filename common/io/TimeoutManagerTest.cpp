@@ -21,6 +21,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <map>
+#include <vector>
 
 #include "common/io/TimeoutManager.h"
 #include "ola/Callback.h"
@@ -44,13 +45,43 @@ class TimeoutManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testRepeatingTimeouts);
   CPPUNIT_TEST(testAbortedRepeatingTimeouts);
   CPPUNIT_TEST(testPendingEventShutdown);
+  CPPUNIT_TEST(testWheelSingleTimeouts);
+  CPPUNIT_TEST(testWheelRepeatingTimeouts);
+  CPPUNIT_TEST(testWheelAbortedRepeatingTimeouts);
+  CPPUNIT_TEST(testWheelPendingEventShutdown);
+  CPPUNIT_TEST(testWheelCascade);
+  CPPUNIT_TEST(testWheelCancelFromCallback);
+  CPPUNIT_TEST(testBenchmark);
   CPPUNIT_TEST_SUITE_END();
 
  public:
-    void testSingleTimeouts();
-    void testRepeatingTimeouts();
-    void testAbortedRepeatingTimeouts();
-    void testPendingEventShutdown();
+    void testSingleTimeouts() {
+      CheckSingleTimeouts(TimeoutManager::PRIORITY_QUEUE);
+    }
+    void testRepeatingTimeouts() {
+      CheckRepeatingTimeouts(TimeoutManager::PRIORITY_QUEUE);
+    }
+    void testAbortedRepeatingTimeouts() {
+      CheckAbortedRepeatingTimeouts(TimeoutManager::PRIORITY_QUEUE);
+    }
+    void testPendingEventShutdown() {
+      CheckPendingEventShutdown(TimeoutManager::PRIORITY_QUEUE);
+    }
+    void testWheelSingleTimeouts() {
+      CheckSingleTimeouts(TimeoutManager::TIMER_WHEEL);
+    }
+    void testWheelRepeatingTimeouts() {
+      CheckRepeatingTimeouts(TimeoutManager::TIMER_WHEEL);
+    }
+    void testWheelAbortedRepeatingTimeouts() {
+      CheckAbortedRepeatingTimeouts(TimeoutManager::TIMER_WHEEL);
+    }
+    void testWheelPendingEventShutdown() {
+      CheckPendingEventShutdown(TimeoutManager::TIMER_WHEEL);
+    }
+    void testWheelCascade();
+    void testWheelCancelFromCallback();
+    void testBenchmark();
 
     void HandleEvent(unsigned int event_id) {
       m_event_counters[event_id]++;
@@ -67,6 +98,21 @@ class TimeoutManagerTest: public CppUnit::TestFixture {
       return m_event_counters[event_id] < 2;
     }
 
+    void CancelEvent(TimeoutManager *timeout_manager,
+                     const timeout_id *id,
+                     unsigned int event_id) {
+      m_event_counters[event_id]++;
+      timeout_manager->CancelTimeout(*id);
+    }
+
+    bool CancelRepeatingEvent(TimeoutManager *timeout_manager,
+                              const timeout_id *id,
+                              unsigned int event_id) {
+      m_event_counters[event_id]++;
+      timeout_manager->CancelTimeout(*id);
+      return true;
+    }
+
     unsigned int GetEventCounter(unsigned int event_id) {
       return m_event_counters[event_id];
     }
@@ -74,6 +120,13 @@ class TimeoutManagerTest: public CppUnit::TestFixture {
  private:
     ExportMap m_map;
     std::map<unsigned int, unsigned int> m_event_counters;
+
+    void CheckSingleTimeouts(TimeoutManager::TimerImplementation impl);
+    void CheckRepeatingTimeouts(TimeoutManager::TimerImplementation impl);
+    void CheckAbortedRepeatingTimeouts(
+        TimeoutManager::TimerImplementation impl);
+    void CheckPendingEventShutdown(TimeoutManager::TimerImplementation impl);
+    int64_t RunBenchmark(TimeoutManager::TimerImplementation impl);
 };
 
 
@@ -82,9 +135,10 @@ CPPUNIT_TEST_SUITE_REGISTRATION(TimeoutManagerTest);
 /*
  * Check RegisterSingleTimeout works.
  */
-void TimeoutManagerTest::testSingleTimeouts() {
+void TimeoutManagerTest::CheckSingleTimeouts(
+    TimeoutManager::TimerImplementation impl) {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, impl);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -136,9 +190,10 @@ void TimeoutManagerTest::testSingleTimeouts() {
 /*
  * Check RegisterRepeatingTimeout works.
  */
-void TimeoutManagerTest::testRepeatingTimeouts() {
+void TimeoutManagerTest::CheckRepeatingTimeouts(
+    TimeoutManager::TimerImplementation impl) {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, impl);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -190,9 +245,10 @@ void TimeoutManagerTest::testRepeatingTimeouts() {
 /*
  * Check returning false from a repeating timeout cancels the timeout.
  */
-void TimeoutManagerTest::testAbortedRepeatingTimeouts() {
+void TimeoutManagerTest::CheckAbortedRepeatingTimeouts(
+    TimeoutManager::TimerImplementation impl) {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, impl);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -222,9 +278,10 @@ void TimeoutManagerTest::testAbortedRepeatingTimeouts() {
  * Check we don't leak if there are events pending when the manager is
  * destroyed.
  */
-void TimeoutManagerTest::testPendingEventShutdown() {
+void TimeoutManagerTest::CheckPendingEventShutdown(
+    TimeoutManager::TimerImplementation impl) {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, impl);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -241,3 +298,138 @@ void TimeoutManagerTest::testPendingEventShutdown() {
 
   OLA_ASSERT_TRUE(timeout_manager.EventsPending());
 }
+
+/*
+ * Check that timeouts in the outer wheels are cascaded down and trigger on
+ * time.
+ */
+void TimeoutManagerTest::testWheelCascade() {
+  MockClock clock;
+  TimeoutManager timeout_manager(&m_map, &clock, TimeoutManager::TIMER_WHEEL);
+
+  // 100ms, 2s, 5 minutes, 10 hours and 60 days.
+  const TimeInterval intervals[] = {
+    TimeInterval(0, 100000),
+    TimeInterval(2, 0),
+    TimeInterval(300, 0),
+    TimeInterval(36000, 0),
+    TimeInterval(5184000, 0),
+  };
+  const unsigned int count = sizeof(intervals) / sizeof(intervals[0]);
+
+  TimeStamp start;
+  clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < count; i++) {
+    timeout_manager.RegisterSingleTimeout(
+        intervals[i],
+        NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, i));
+  }
+
+  TimeStamp now = start;
+  for (unsigned int i = 0; i < count; i++) {
+    // Just before the event is due
+    TimeStamp due = start + intervals[i];
+    clock.AdvanceTime((due - TimeInterval(0, 1000)) - now);
+    clock.CurrentMonotonicTime(&now);
+    TimeInterval next = timeout_manager.ExecuteTimeouts(&now);
+    OLA_ASSERT_EQ(0u, GetEventCounter(i));
+    OLA_ASSERT_FALSE(next.IsZero());
+    OLA_ASSERT_LT(next, TimeInterval(0, 50000));
+
+    clock.AdvanceTime(0, 1000);
+    clock.CurrentMonotonicTime(&now);
+    timeout_manager.ExecuteTimeouts(&now);
+    OLA_ASSERT_EQ(1u, GetEventCounter(i));
+    if (i + 1 < count) {
+      OLA_ASSERT_EQ(0u, GetEventCounter(i + 1));
+    }
+  }
+  OLA_ASSERT_FALSE(timeout_manager.EventsPending());
+}
+
+/*
+ * Check that callbacks can cancel other timeouts, and themselves.
+ */
+void TimeoutManagerTest::testWheelCancelFromCallback() {
+  MockClock clock;
+  TimeoutManager timeout_manager(&m_map, &clock, TimeoutManager::TIMER_WHEEL);
+
+  TimeInterval timeout_interval(0, 10000);
+  timeout_id id2 = ola::thread::INVALID_TIMEOUT;
+  timeout_id id3 = ola::thread::INVALID_TIMEOUT;
+  timeout_id id1 = timeout_manager.RegisterSingleTimeout(
+      timeout_interval,
+      NewSingleCallback(this, &TimeoutManagerTest::CancelEvent,
+                        &timeout_manager,
+                        static_cast<const timeout_id*>(&id2), 1u));
+  id2 = timeout_manager.RegisterSingleTimeout(
+      timeout_interval,
+      NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, 2u));
+  id3 = timeout_manager.RegisterRepeatingTimeout(
+      timeout_interval,
+      NewCallback(this, &TimeoutManagerTest::CancelRepeatingEvent,
+                  &timeout_manager, static_cast<const timeout_id*>(&id3),
+                  3u));
+
+  TimeStamp now;
+  clock.AdvanceTime(1, 0);
+  clock.CurrentMonotonicTime(&now);
+  TimeInterval next = timeout_manager.ExecuteTimeouts(&now);
+  OLA_ASSERT_TRUE(next.IsZero());
+  OLA_ASSERT_EQ(1u, GetEventCounter(1));
+  OLA_ASSERT_EQ(0u, GetEventCounter(2));
+  OLA_ASSERT_EQ(1u, GetEventCounter(3));
+  OLA_ASSERT_FALSE(timeout_manager.EventsPending());
+
+  // Cancelling timeouts that have already run is a no-op.
+  timeout_manager.CancelTimeout(id1);
+  timeout_manager.CancelTimeout(id3);
+}
+
+/*
+ * Register 100k timeouts, cancel most of them, then run the remainder. This
+ * mimics RDM requests, most of which get a response before they time out.
+ */
+int64_t TimeoutManagerTest::RunBenchmark(
+    TimeoutManager::TimerImplementation impl) {
+  const unsigned int TIMER_COUNT = 100000;
+  ola::Clock wall_clock;
+  MockClock clock;
+  TimeoutManager timeout_manager(NULL, &clock, impl);
+  m_event_counters.clear();
+
+  TimeStamp start, end;
+  wall_clock.CurrentMonotonicTime(&start);
+
+  std::vector<timeout_id> ids;
+  ids.reserve(TIMER_COUNT);
+  for (unsigned int i = 0; i < TIMER_COUNT; i++) {
+    ids.push_back(timeout_manager.RegisterSingleTimeout(
+        TimeInterval(0, 1000 * (i % 10000 + 1)),
+        NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, 1u)));
+  }
+
+  for (unsigned int i = 0; i < TIMER_COUNT; i++) {
+    if (i % 4)
+      timeout_manager.CancelTimeout(ids[i]);
+  }
+
+  TimeStamp now;
+  for (unsigned int i = 0; i < 1000; i++) {
+    clock.AdvanceTime(0, 10000);
+    clock.CurrentMonotonicTime(&now);
+    timeout_manager.ExecuteTimeouts(&now);
+  }
+  wall_clock.CurrentMonotonicTime(&end);
+
+  OLA_ASSERT_EQ(TIMER_COUNT / 4, GetEventCounter(1));
+  OLA_ASSERT_FALSE(timeout_manager.EventsPending());
+  return (end - start).InMilliSeconds();
+}
+
+void TimeoutManagerTest::testBenchmark() {
+  int64_t queue_time = RunBenchmark(TimeoutManager::PRIORITY_QUEUE);
+  int64_t wheel_time = RunBenchmark(TimeoutManager::TIMER_WHEEL);
+  OLA_INFO << "100k timeouts: priority queue " << queue_time
+           << "ms, timer wheel " << wheel_time << "ms";
+}
@@ -103,10 +103,13 @@ WindowsPoller::WindowsPoller(ExportMap *export_map, Clock *clock)
     : m_export_map(export_map),
       m_loop_iterations(NULL),
       m_loop_time(NULL),
+      m_connected_descriptors_var(NULL),
       m_clock(clock) {
   if (m_export_map) {
     m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
     m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+    m_connected_descriptors_var = m_export_map->GetIntegerVar(
+        K_CONNECTED_DESCRIPTORS_VAR);
   }
 }
 
@@ -359,9 +362,8 @@ bool WindowsPoller::Poll(TimeoutManager *timeout_manager,
               if (descriptor->connected_descriptor) {
                 if (descriptor->delete_connected_on_close) {
                   if (RemoveReadDescriptor(descriptor->connected_descriptor) &&
-                      m_export_map) {
-                    (*m_export_map->GetIntegerVar(
-                        K_CONNECTED_DESCRIPTORS_VAR))--;
+                      m_connected_descriptors_var) {
+                    (*m_connected_descriptors_var)--;
                   }
                   delete descriptor->connected_descriptor;
                   descriptor->connected_descriptor = NULL;
@@ -687,8 +689,8 @@ void WindowsPoller::HandleWakeup(PollData* data) {
                 on_close->Run();
               if (descriptor->delete_connected_on_close) {
                 if (RemoveReadDescriptor(descriptor->connected_descriptor) &&
-                    m_export_map) {
-                  (*m_export_map->GetIntegerVar(K_CONNECTED_DESCRIPTORS_VAR))--;
+                    m_connected_descriptors_var) {
+                  (*m_connected_descriptors_var)--;
                 }
                 delete descriptor->connected_descriptor;
                 descriptor->connected_descriptor = NULL;
@@ -75,6 +75,7 @@ class WindowsPoller : public PollerInterface {
   ExportMap *m_export_map;
   CounterVariable *m_loop_iterations;
   CounterVariable *m_loop_time;
+  IntegerVariable *m_connected_descriptors_var;
   Clock *m_clock;
   TimeStamp m_wake_up_time;
 
@@ -0,0 +1,331 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * LocalSocket.cpp
+ * Implementation of the local domain socket classes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef _WIN32
+#include <ola/win/CleanWinSock2.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif  // _WIN32
+
+#include <string>
+
+#include "ola/Logging.h"
+#include "ola/base/Credentials.h"
+#include "ola/io/Descriptor.h"
+#include "ola/network/LocalSocket.h"
+#include "ola/network/SocketCloser.h"
+
+namespace ola {
+namespace network {
+
+using std::string;
+
+#ifndef _WIN32
+namespace {
+
+/*
+ * Fill in a sockaddr_un for a path.
+ * @returns false if the path is empty or too long.
+ */
+bool PathToSockAddr(const string &path, struct sockaddr_un *address) {
+  memset(address, 0, sizeof(*address));
+  address->sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(address->sun_path)) {
+    OLA_WARN << "Invalid socket path: " << path;
+    return false;
+  }
+  strncpy(address->sun_path, path.c_str(), sizeof(address->sun_path) - 1);
+  return true;
+}
+
+/*
+ * Remove a socket left behind by a process that didn't exit cleanly.
+ * @returns false if something other than a stale socket exists at the path.
+ */
+bool RemoveStaleSocket(const string &path,
+                       const struct sockaddr_un &address) {
+  struct stat stat_buf;
+  if (lstat(path.c_str(), &stat_buf)) {
+    return errno == ENOENT;
+  }
+
+  if (!S_ISSOCK(stat_buf.st_mode)) {
+    OLA_WARN << path << " exists and isn't a socket";
+    return false;
+  }
+
+  int sd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sd < 0) {
+    OLA_WARN << "socket() failed, " << strerror(errno);
+    return false;
+  }
+  SocketCloser closer(sd);
+
+  if (connect(sd, reinterpret_cast<const struct sockaddr*>(&address),
+              sizeof(address)) == 0) {
+    OLA_WARN << "Another process is listening on " << path;
+    return false;
+  }
+
+  if (errno != ECONNREFUSED) {
+    OLA_WARN << "connect(" << path << "): " << strerror(errno);
+    return false;
+  }
+
+  OLA_INFO << "Removing stale socket " << path;
+  if (unlink(path.c_str()) && errno != ENOENT) {
+    OLA_WARN << "Failed to remove " << path << ", " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Restrict who can connect to the socket.
+ */
+bool SetSocketPermissions(const string &path, const string &group) {
+  mode_t mode = S_IRUSR | S_IWUSR;
+  if (!group.empty()) {
+    GroupEntry group_entry;
+    if (!GetGroupName(group, &group_entry)) {
+      OLA_WARN << "Unknown group " << group;
+      return false;
+    }
+    if (chown(path.c_str(), static_cast<uid_t>(-1), group_entry.gr_gid)) {
+      OLA_WARN << "Failed to set the group of " << path << " to " << group
+               << ", " << strerror(errno);
+      return false;
+    }
+    mode |= S_IRGRP | S_IWGRP;
+  }
+
+  if (chmod(path.c_str(), mode)) {
+    OLA_WARN << "Failed to set permissions on " << path << ", "
+             << strerror(errno);
+    return false;
+  }
+  return true;
+}
+}  // namespace
+#endif  // !_WIN32
+
+
+// LocalSocket
+// ------------------------------------------------
+
+LocalSocket::LocalSocket(int sd) {
+#ifdef _WIN32
+  m_handle.m_handle.m_fd = sd;
+  m_handle.m_type = ola::io::SOCKET_DESCRIPTOR;
+#else
+  m_handle = sd;
+#endif  // _WIN32
+  SetNoSigPipe(m_handle);
+}
+
+
+/*
+ * Close this LocalSocket
+ */
+bool LocalSocket::Close() {
+  if (m_handle != ola::io::INVALID_DESCRIPTOR) {
+#ifdef _WIN32
+    closesocket(m_handle.m_handle.m_fd);
+#else
+    close(m_handle);
+#endif  // _WIN32
+    m_handle = ola::io::INVALID_DESCRIPTOR;
+  }
+  return true;
+}
+
+
+LocalSocket* LocalSocket::Connect(const string &path) {
+#ifdef _WIN32
+  OLA_WARN << "Local sockets aren't supported on Windows, can't connect to "
+           << path;
+  return NULL;
+#else
+  struct sockaddr_un address;
+  if (!PathToSockAddr(path, &address)) {
+    return NULL;
+  }
+
+  int sd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sd < 0) {
+    OLA_WARN << "socket() failed, " << strerror(errno);
+    return NULL;
+  }
+
+  SocketCloser closer(sd);
+
+  if (connect(sd, reinterpret_cast<struct sockaddr*>(&address),
+              sizeof(address))) {
+    OLA_WARN << "connect(" << path << "): " << strerror(errno);
+    return NULL;
+  }
+  LocalSocket *socket = new LocalSocket(closer.Release());
+  socket->SetReadNonBlocking();
+  return socket;
+#endif  // _WIN32
+}
+
+
+// LocalAcceptingSocket
+// ------------------------------------------------
+
+LocalAcceptingSocket::LocalAcceptingSocket(AcceptCallback *on_accept)
+    : ReadFileDescriptor(),
+      m_handle(ola::io::INVALID_DESCRIPTOR),
+      m_on_accept(on_accept) {
+}
+
+
+LocalAcceptingSocket::~LocalAcceptingSocket() {
+  Close();
+}
+
+
+bool LocalAcceptingSocket::Listen(const string &path, const string &group,
+                                  int backlog) {
+#ifdef _WIN32
+  OLA_WARN << "Local sockets aren't supported on Windows, can't listen on "
+           << path;
+  (void) group;
+  (void) backlog;
+  return false;
+#else
+  if (m_handle != ola::io::INVALID_DESCRIPTOR) {
+    return false;
+  }
+
+  struct sockaddr_un address;
+  if (!PathToSockAddr(path, &address)) {
+    return false;
+  }
+
+  if (!RemoveStaleSocket(path, address)) {
+    return false;
+  }
+
+  int sd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sd < 0) {
+    OLA_WARN << "socket() failed: " << strerror(errno);
+    return false;
+  }
+
+  SocketCloser closer(sd);
+
+  if (!ola::io::ConnectedDescriptor::SetNonBlocking(sd)) {
+    OLA_WARN << "Failed to mark local accept socket as non-blocking";
+    return false;
+  }
+
+  if (bind(sd, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address)) == -1) {
+    OLA_WARN << "bind to " << path << " failed, " << strerror(errno);
+    return false;
+  }
+
+  // Clients can't connect until we call listen(), so fix the permissions
+  // first.
+  if (!SetSocketPermissions(path, group)) {
+    unlink(path.c_str());
+    return false;
+  }
+
+  if (listen(sd, backlog)) {
+    OLA_WARN << "listen on " << path << " failed, " << strerror(errno);
+    unlink(path.c_str());
+    return false;
+  }
+
+  m_handle = closer.Release();
+  m_path = path;
+  return true;
+#endif  // _WIN32
+}
+
+
+bool LocalAcceptingSocket::Close() {
+  bool ret = true;
+  if (m_handle != ola::io::INVALID_DESCRIPTOR) {
+#ifdef _WIN32
+    if (closesocket(m_handle.m_handle.m_fd)) {
+#else
+    if (close(m_handle)) {
+#endif  // _WIN32
+      OLA_WARN << "close() failed " << strerror(errno);
+      ret = false;
+    }
+  }
+  m_handle = ola::io::INVALID_DESCRIPTOR;
+
+  if (!m_path.empty()) {
+    if (unlink(m_path.c_str()) && errno != ENOENT) {
+      OLA_WARN << "Failed to remove " << m_path << ", " << strerror(errno);
+      ret = false;
+    }
+    m_path.clear();
+  }
+  return ret;
+}
+
+
+/*
+ * Accept new connections
+ */
+void LocalAcceptingSocket::PerformRead() {
+#ifndef _WIN32
+  if (m_handle == ola::io::INVALID_DESCRIPTOR)
+    return;
+
+  while (1) {
+    int sd = accept(m_handle, NULL, NULL);
+    if (sd < 0) {
+      if (errno != EWOULDBLOCK && errno != EAGAIN) {
+        OLA_WARN << "accept() failed, " << strerror(errno);
+      }
+      return;
+    }
+
+    if (m_on_accept.get()) {
+      // The callback takes ownership of the new socket
+      m_on_accept->Run(new LocalSocket(sd));
+    } else {
+      OLA_WARN << "Accepted new local connection but no callback registered";
+      close(sd);
+    }
+  }
+#endif  // !_WIN32
+}
+}  // namespace network
+}  // namespace ola
@@ -8,6 +8,7 @@ common_libolacommon_la_SOURCES += \
     common/network/IPV6Address.cpp \
     common/network/Interface.cpp \
     common/network/InterfacePicker.cpp \
+    common/network/LocalSocket.cpp \
     common/network/MACAddress.cpp \
     common/network/NetworkUtils.cpp \
     common/network/NetworkUtilsInternal.h \
@@ -48,7 +48,13 @@
 #include <netinet/in.h>
 #endif  // HAVE_NETINET_IN_H
 
+#ifdef HAVE_SYS_UIO_H
+#include <sys/uio.h>
+#endif  // HAVE_SYS_UIO_H
+
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "common/network/SocketHelper.h"
 #include "ola/Logging.h"
@@ -60,23 +66,116 @@ namespace network {
 
 namespace {
 
+void LogReceiveError(int fd) {
+#ifdef _WIN32
+  OLA_WARN << "recvfrom fd: " << fd << " failed: " << WSAGetLastError();
+#else
+  OLA_WARN << "recvfrom fd: " << fd << " failed: " << strerror(errno);
+#endif  // _WIN32
+}
+
 bool ReceiveFrom(int fd, uint8_t *buffer, ssize_t *data_read,
                  struct sockaddr_in *source, socklen_t *src_size) {
   *data_read = recvfrom(
     fd, reinterpret_cast<char*>(buffer), *data_read,
     0, reinterpret_cast<struct sockaddr*>(source), source ? src_size : NULL);
   if (*data_read < 0) {
+    LogReceiveError(fd);
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Returns true if the last receive failed because there was no data waiting.
+ */
+bool WouldBlock() {
 #ifdef _WIN32
-    OLA_WARN << "recvfrom fd: " << fd << " failed: " << WSAGetLastError();
+  return WSAGetLastError() == WSAEWOULDBLOCK;
 #else
-    OLA_WARN << "recvfrom fd: " << fd << " failed: " << strerror(errno);
+  return errno == EAGAIN || errno == EWOULDBLOCK;
 #endif  // _WIN32
+}
+
+IPV4SocketAddress FromSockAddr(const struct sockaddr_in &address) {
+  return IPV4SocketAddress(IPV4Address(address.sin_addr.s_addr),
+                           NetworkToHost(address.sin_port));
+}
+
+#ifdef HAVE_RECVMMSG
+// The number of datagrams we pass to each recvmmsg() call.
+const unsigned int MAX_RECVMMSG_BATCH = 32;
+#endif  // HAVE_RECVMMSG
+
+#ifdef HAVE_SENDMMSG
+// The number of datagrams we pass to each sendmmsg() call.
+const unsigned int MAX_SENDMMSG_BATCH = 64;
+#endif  // HAVE_SENDMMSG
+
+}  // namespace
+
+// DatagramBatch
+// ------------------------------------------------
+
+DatagramBatch::DatagramBatch(unsigned int max_size, unsigned int capacity)
+    : m_max_size(max_size),
+      m_capacity(capacity),
+      m_stride((max_size + 7) & ~7u),
+      m_count(0),
+      m_buffer(new uint8_t[m_stride * capacity]),
+      m_sizes(capacity),
+      m_sources(capacity) {
+}
+
+DatagramBatch::~DatagramBatch() {
+  delete[] m_buffer;
+}
+
+bool DatagramBatch::Append(unsigned int size,
+                           const IPV4SocketAddress &source) {
+  if (Full()) {
     return false;
   }
+  m_sizes[m_count] = std::min(size, m_max_size);
+  m_sources[m_count] = source;
+  m_count++;
   return true;
 }
 
-}  // namespace
+// UDPSocketInterface
+// ------------------------------------------------
+
+unsigned int UDPSocketInterface::RecvBatch(DatagramBatch *batch) {
+  batch->Clear();
+  if (batch->Full()) {
+    return 0;
+  }
+  ssize_t size = batch->MaxSize();
+  IPV4SocketAddress source;
+  if (RecvFrom(batch->Data(0), &size, &source)) {
+    batch->Append(static_cast<unsigned int>(size), source);
+  }
+  return batch->Count();
+}
+
+unsigned int UDPSocketInterface::SendToMany(
+    const uint8_t *buffer,
+    unsigned int size,
+    const std::vector<IPV4SocketAddress> &destinations,
+    unsigned int *syscalls) const {
+  unsigned int sent = 0;
+  std::vector<IPV4SocketAddress>::const_iterator iter = destinations.begin();
+  for (; iter != destinations.end(); ++iter) {
+    ssize_t bytes_sent = SendTo(buffer, size, *iter);
+    if (bytes_sent >= 0 && static_cast<unsigned int>(bytes_sent) == size) {
+      sent++;
+    }
+  }
+  if (syscalls) {
+    *syscalls = destinations.size();
+  }
+  return sent;
+}
 
 // UDPSocket
 // ------------------------------------------------
@@ -279,6 +378,65 @@ ssize_t UDPSocket::SendTo(ola::io::IOVecInterface *data,
   return bytes_sent;
 }
 
+unsigned int UDPSocket::SendToMany(
+    const uint8_t *buffer,
+    unsigned int size,
+    const std::vector<IPV4SocketAddress> &destinations,
+    unsigned int *syscalls) const {
+#ifdef HAVE_SENDMMSG
+  if (syscalls) {
+    *syscalls = 0;
+  }
+  if (!ValidWriteDescriptor())
+    return 0;
+
+  struct mmsghdr messages[MAX_SENDMMSG_BATCH];
+  struct sockaddr_in addresses[MAX_SENDMMSG_BATCH];
+  struct iovec iov;
+  iov.iov_base = const_cast<uint8_t*>(buffer);
+  iov.iov_len = size;
+
+  unsigned int sent = 0;
+  unsigned int offset = 0;
+  while (offset < destinations.size()) {
+    const unsigned int count = std::min(
+        static_cast<unsigned int>(destinations.size()) - offset,
+        MAX_SENDMMSG_BATCH);
+    memset(messages, 0, sizeof(messages[0]) * count);
+    for (unsigned int i = 0; i < count; i++) {
+      destinations[offset + i].ToSockAddr(
+          reinterpret_cast<sockaddr*>(&addresses[i]), sizeof(addresses[i]));
+      messages[i].msg_hdr.msg_name = &addresses[i];
+      messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+      messages[i].msg_hdr.msg_iov = &iov;
+      messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int result = sendmmsg(m_handle, messages, count, 0);
+    if (syscalls) {
+      (*syscalls)++;
+    }
+    if (result <= 0) {
+      // sendmmsg only fails if the first datagram couldn't be sent, skip it
+      // and carry on with the rest.
+      OLA_INFO << "sendmmsg failed: " << destinations[offset] << " : "
+               << strerror(errno);
+      offset++;
+      continue;
+    }
+    for (int i = 0; i < result; i++) {
+      if (messages[i].msg_len == size) {
+        sent++;
+      }
+    }
+    offset += result;
+  }
+  return sent;
+#else
+  return UDPSocketInterface::SendToMany(buffer, size, destinations, syscalls);
+#endif  // HAVE_SENDMMSG
+}
+
 bool UDPSocket::RecvFrom(uint8_t *buffer, ssize_t *data_read) const {
   socklen_t length = 0;
 #ifdef _WIN32
@@ -342,6 +500,83 @@ bool UDPSocket::RecvFrom(uint8_t *buffer,
   return ok;
 }
 
+unsigned int UDPSocket::RecvBatch(DatagramBatch *batch) {
+  batch->Clear();
+  if (m_handle == ola::io::INVALID_DESCRIPTOR) {
+    return 0;
+  }
+#ifdef _WIN32
+  int fd = m_handle.m_handle.m_fd;
+#else
+  int fd = m_handle;
+#endif  // _WIN32
+
+#ifdef HAVE_RECVMMSG
+  struct mmsghdr messages[MAX_RECVMMSG_BATCH];
+  struct iovec iovs[MAX_RECVMMSG_BATCH];
+  struct sockaddr_in sources[MAX_RECVMMSG_BATCH];
+
+  while (!batch->Full()) {
+    const unsigned int offset = batch->Count();
+    const unsigned int count = std::min(batch->Capacity() - offset,
+                                        MAX_RECVMMSG_BATCH);
+    memset(messages, 0, sizeof(messages[0]) * count);
+    for (unsigned int i = 0; i < count; i++) {
+      iovs[i].iov_base = batch->Data(offset + i);
+      iovs[i].iov_len = batch->MaxSize();
+      messages[i].msg_hdr.msg_name = &sources[i];
+      messages[i].msg_hdr.msg_namelen = sizeof(sources[i]);
+      messages[i].msg_hdr.msg_iov = &iovs[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int received = recvmmsg(fd, messages, count, MSG_DONTWAIT, NULL);
+    if (received < 0) {
+      if (!WouldBlock()) {
+        LogReceiveError(fd);
+      }
+      break;
+    }
+    for (int i = 0; i < received; i++) {
+      batch->Append(messages[i].msg_len, FromSockAddr(sources[i]));
+    }
+    if (static_cast<unsigned int>(received) < count) {
+      break;
+    }
+  }
+#else
+#if defined(MSG_DONTWAIT)
+  const int flags = MSG_DONTWAIT;
+  const unsigned int limit = batch->Capacity();
+#elif defined(_WIN32)
+  // Windows sockets are already non-blocking.
+  const int flags = 0;
+  const unsigned int limit = batch->Capacity();
+#else
+  // Without MSG_DONTWAIT only the first read is guaranteed not to block.
+  const int flags = 0;
+  const unsigned int limit = std::min(batch->Capacity(), 1u);
+#endif  // defined(MSG_DONTWAIT)
+
+  while (batch->Count() < limit) {
+    struct sockaddr_in source;
+    socklen_t source_size = sizeof(source);
+    ssize_t size = recvfrom(
+        fd, reinterpret_cast<char*>(batch->Data(batch->Count())),
+        batch->MaxSize(), flags, reinterpret_cast<struct sockaddr*>(&source),
+        &source_size);
+    if (size < 0) {
+      if (!WouldBlock()) {
+        LogReceiveError(fd);
+      }
+      break;
+    }
+    batch->Append(static_cast<unsigned int>(size), FromSockAddr(source));
+  }
+#endif  // HAVE_RECVMMSG
+  return batch->Count();
+}
+
 bool UDPSocket::EnableBroadcast() {
   if (m_handle == ola::io::INVALID_DESCRIPTOR)
     return false;
@@ -20,8 +20,17 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif  // !_WIN32
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "ola/Callback.h"
 #include "ola/Logging.h"
@@ -29,6 +38,7 @@
 #include "ola/io/IOQueue.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/IPV4Address.h"
+#include "ola/network/LocalSocket.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/network/Socket.h"
 #include "ola/network/TCPSocketFactory.h"
@@ -39,12 +49,16 @@ using ola::io::ConnectedDescriptor;
 using ola::io::IOQueue;
 using ola::io::SelectServer;
 using ola::network::IPV4Address;
+using ola::network::DatagramBatch;
 using ola::network::GenericSocketAddress;
 using ola::network::IPV4SocketAddress;
+using ola::network::LocalAcceptingSocket;
+using ola::network::LocalSocket;
 using ola::network::TCPAcceptingSocket;
 using ola::network::TCPSocket;
 using ola::network::UDPSocket;
 using std::string;
+using std::vector;
 
 static const unsigned char test_cstring[] = "Foo";
 // used to set a timeout which aborts the tests
@@ -54,8 +68,12 @@ class SocketTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(SocketTest);
   CPPUNIT_TEST(testTCPSocketClientClose);
   CPPUNIT_TEST(testTCPSocketServerClose);
+  CPPUNIT_TEST(testLocalSocket);
+  CPPUNIT_TEST(testStaleLocalSocket);
   CPPUNIT_TEST(testUDPSocket);
   CPPUNIT_TEST(testIOQueueUDPSend);
+  CPPUNIT_TEST(testUDPRecvBatch);
+  CPPUNIT_TEST(testUDPSendToMany);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -63,8 +81,12 @@ class SocketTest: public CppUnit::TestFixture {
     void tearDown();
     void testTCPSocketClientClose();
     void testTCPSocketServerClose();
+    void testLocalSocket();
+    void testStaleLocalSocket();
     void testUDPSocket();
     void testIOQueueUDPSend();
+    void testUDPRecvBatch();
+    void testUDPSendToMany();
 
     // timing out indicates something went wrong
     void Timeout() {
@@ -80,6 +102,7 @@ class SocketTest: public CppUnit::TestFixture {
     void ReceiveSendAndClose(ConnectedDescriptor *socket);
     void NewConnectionSend(TCPSocket *socket);
     void NewConnectionSendAndClose(TCPSocket *socket);
+    void NewLocalConnectionSend(LocalSocket *socket);
     void UDPReceiveAndTerminate(UDPSocket *socket);
     void UDPReceiveAndSend(UDPSocket *socket);
 
@@ -91,6 +114,7 @@ class SocketTest: public CppUnit::TestFixture {
  private:
     SelectServer *m_ss;
     ola::SingleUseCallback0<void> *m_timeout_closure;
+    string m_socket_path;
 
     void SocketClientClose(ConnectedDescriptor *socket,
                            ConnectedDescriptor *socket2);
@@ -110,6 +134,10 @@ void SocketTest::setUp() {
   OLA_ASSERT_TRUE(m_ss->RegisterSingleTimeout(ABORT_TIMEOUT_IN_MS,
                                               m_timeout_closure));
 
+  std::ostringstream str;
+  str << "/tmp/ola-socket-test-" << getpid();
+  m_socket_path = str.str();
+
 #if _WIN32
   WSADATA wsa_data;
   int result = WSAStartup(MAKEWORD(2, 0), &wsa_data);
@@ -123,6 +151,7 @@ void SocketTest::setUp() {
  */
 void SocketTest::tearDown() {
   delete m_ss;
+  unlink(m_socket_path.c_str());
 
 #ifdef _WIN32
   WSACleanup();
@@ -200,6 +229,86 @@ void SocketTest::testTCPSocketServerClose() {
 }
 
 
+/*
+ * Test local sockets work correctly.
+ * The client connects and the server sends some data. The client checks the
+ * data matches and then closes the connection.
+ */
+void SocketTest::testLocalSocket() {
+#ifndef _WIN32
+  LocalAcceptingSocket socket(
+      ola::NewCallback(this, &SocketTest::NewLocalConnectionSend));
+  OLA_ASSERT_TRUE(socket.Listen(m_socket_path));
+  OLA_ASSERT_FALSE(socket.Listen(m_socket_path));
+  OLA_ASSERT_EQ(m_socket_path, socket.Path());
+
+  // Only we can connect
+  struct stat stat_buf;
+  OLA_ASSERT_EQ(0, stat(m_socket_path.c_str(), &stat_buf));
+  OLA_ASSERT_TRUE(S_ISSOCK(stat_buf.st_mode));
+  OLA_ASSERT_EQ(static_cast<mode_t>(S_IRUSR | S_IWUSR),
+                stat_buf.st_mode & 0777);
+
+  OLA_ASSERT_TRUE(m_ss->AddReadDescriptor(&socket));
+
+  LocalSocket *client_socket = LocalSocket::Connect(m_socket_path);
+  OLA_ASSERT_NOT_NULL(client_socket);
+  client_socket->SetOnData(ola::NewCallback(
+        this, &SocketTest::ReceiveAndClose,
+        static_cast<ConnectedDescriptor*>(client_socket)));
+  OLA_ASSERT_TRUE(m_ss->AddReadDescriptor(client_socket));
+  m_ss->Run();
+  m_ss->RemoveReadDescriptor(&socket);
+  m_ss->RemoveReadDescriptor(client_socket);
+  delete client_socket;
+
+  // Someone is already listening
+  LocalAcceptingSocket other_socket(NULL);
+  OLA_ASSERT_FALSE(other_socket.Listen(m_socket_path));
+
+  // Closing removes the socket
+  OLA_ASSERT_TRUE(socket.Close());
+  OLA_ASSERT_EQ(string(""), socket.Path());
+  OLA_ASSERT_NE(0, stat(m_socket_path.c_str(), &stat_buf));
+  OLA_ASSERT_NULL(LocalSocket::Connect(m_socket_path));
+#endif  // !_WIN32
+}
+
+
+/*
+ * Check that a socket left behind by another process is replaced, but other
+ * files aren't.
+ */
+void SocketTest::testStaleLocalSocket() {
+#ifndef _WIN32
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, m_socket_path.c_str(),
+          sizeof(address.sun_path) - 1);
+
+  int sd = socket(AF_UNIX, SOCK_STREAM, 0);
+  OLA_ASSERT_TRUE(sd >= 0);
+  OLA_ASSERT_EQ(0, bind(sd, reinterpret_cast<struct sockaddr*>(&address),
+                        sizeof(address)));
+  close(sd);
+
+  LocalAcceptingSocket socket(NULL);
+  OLA_ASSERT_TRUE(socket.Listen(m_socket_path));
+  OLA_ASSERT_TRUE(socket.Close());
+
+  FILE *file = fopen(m_socket_path.c_str(), "w");
+  OLA_ASSERT_NOT_NULL(file);
+  fclose(file);
+  OLA_ASSERT_FALSE(socket.Listen(m_socket_path));
+  // The file is left alone
+  struct stat stat_buf;
+  OLA_ASSERT_EQ(0, stat(m_socket_path.c_str(), &stat_buf));
+  OLA_ASSERT_TRUE(S_ISREG(stat_buf.st_mode));
+#endif  // !_WIN32
+}
+
+
 /*
  * Test UDP sockets work correctly.
  * The client connects and the server sends some data. The client checks the
@@ -279,6 +388,95 @@ void SocketTest::testIOQueueUDPSend() {
 }
 
 
+/*
+ * Test that RecvBatch drains waiting datagrams without blocking.
+ */
+void SocketTest::testUDPRecvBatch() {
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&local_address));
+
+  DatagramBatch batch(sizeof(test_cstring) + 10, 2);
+  OLA_ASSERT_EQ(2u, batch.Capacity());
+
+  // nothing is waiting
+  OLA_ASSERT_EQ(0u, socket.RecvBatch(&batch));
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+  OLA_ASSERT_TRUE(client_socket.Bind(
+      IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+  IPV4SocketAddress client_address;
+  OLA_ASSERT_TRUE(client_socket.GetSocketAddress(&client_address));
+
+  for (unsigned int i = 0; i < 3; i++) {
+    ssize_t bytes_sent = client_socket.SendTo(
+        static_cast<const uint8_t*>(test_cstring), sizeof(test_cstring) - i,
+        local_address);
+    OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(test_cstring) - i), bytes_sent);
+  }
+
+  OLA_ASSERT_EQ(2u, socket.RecvBatch(&batch));
+  OLA_ASSERT_EQ(2u, batch.Count());
+  OLA_ASSERT_TRUE(batch.Full());
+  for (unsigned int i = 0; i < batch.Count(); i++) {
+    OLA_ASSERT_DATA_EQUALS(test_cstring, sizeof(test_cstring) - i,
+                           batch.Data(i), batch.Size(i));
+    OLA_ASSERT_EQ(client_address, batch.Source(i));
+  }
+
+  OLA_ASSERT_EQ(1u, socket.RecvBatch(&batch));
+  OLA_ASSERT_DATA_EQUALS(test_cstring, sizeof(test_cstring) - 2,
+                         batch.Data(0), batch.Size(0));
+
+  OLA_ASSERT_EQ(0u, socket.RecvBatch(&batch));
+  OLA_ASSERT_EQ(0u, batch.Count());
+}
+
+
+/*
+ * Test that SendToMany delivers the datagram to each destination.
+ */
+void SocketTest::testUDPSendToMany() {
+  UDPSocket socket1;
+  OLA_ASSERT_TRUE(socket1.Init());
+  OLA_ASSERT_TRUE(socket1.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+  UDPSocket socket2;
+  OLA_ASSERT_TRUE(socket2.Init());
+  OLA_ASSERT_TRUE(socket2.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+
+  vector<IPV4SocketAddress> destinations;
+  IPV4SocketAddress address;
+  OLA_ASSERT_TRUE(socket1.GetSocketAddress(&address));
+  destinations.push_back(address);
+  OLA_ASSERT_TRUE(socket2.GetSocketAddress(&address));
+  destinations.push_back(address);
+  destinations.push_back(address);
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+  unsigned int syscalls = 0;
+  OLA_ASSERT_EQ(3u, client_socket.SendToMany(
+      static_cast<const uint8_t*>(test_cstring), sizeof(test_cstring),
+      destinations, &syscalls));
+  OLA_ASSERT_TRUE(syscalls >= 1 && syscalls <= 3);
+
+  DatagramBatch batch(sizeof(test_cstring) + 10);
+  OLA_ASSERT_EQ(1u, socket1.RecvBatch(&batch));
+  OLA_ASSERT_DATA_EQUALS(test_cstring, sizeof(test_cstring),
+                         batch.Data(0), batch.Size(0));
+  OLA_ASSERT_EQ(2u, socket2.RecvBatch(&batch));
+  OLA_ASSERT_DATA_EQUALS(test_cstring, sizeof(test_cstring),
+                         batch.Data(1), batch.Size(1));
+
+  destinations.clear();
+  OLA_ASSERT_EQ(0u, client_socket.SendToMany(
+      static_cast<const uint8_t*>(test_cstring), sizeof(test_cstring),
+      destinations, NULL));
+}
+
 /*
  * Receive some data and close the socket
  */
@@ -355,6 +553,21 @@ void SocketTest::NewConnectionSend(TCPSocket *new_socket) {
 }
 
 
+/*
+ * Accept a new local connection and send some test data
+ */
+void SocketTest::NewLocalConnectionSend(LocalSocket *new_socket) {
+  OLA_ASSERT_NOT_NULL(new_socket);
+  ssize_t bytes_sent = new_socket->Send(
+      static_cast<const uint8_t*>(test_cstring),
+      sizeof(test_cstring));
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(test_cstring)), bytes_sent);
+  new_socket->SetOnClose(ola::NewSingleCallback(this,
+                                               &SocketTest::TerminateOnClose));
+  m_ss->AddReadDescriptor(new_socket, true);
+}
+
+
 /*
  * Accept a new connect, send some data and close
  */
@@ -21,10 +21,17 @@
 #include "common/rpc/RpcChannel.h"
 
 #include <errno.h>
+#include <string.h>
+#ifdef _WIN32
+#include <ola/win/CleanWinSock2.h>
+#endif  // _WIN32
 #include <google/protobuf/service.h>
 #include <google/protobuf/message.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/dynamic_message.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
 #include <string>
 
 #include "common/rpc/Rpc.pb.h"
@@ -33,6 +40,7 @@
 #include "common/rpc/RpcHeader.h"
 #include "common/rpc/RpcService.h"
 #include "ola/Callback.h"
+#include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/stl/STLUtils.h"
@@ -43,6 +51,8 @@ namespace rpc {
 using google::protobuf::Message;
 using google::protobuf::MethodDescriptor;
 using google::protobuf::ServiceDescriptor;
+using ola::io::ConnectedDescriptor;
+using ola::io::SelectServerInterface;
 using std::auto_ptr;
 using std::string;
 
@@ -50,6 +60,8 @@ const char RpcChannel::K_RPC_RECEIVED_TYPE_VAR[] = "rpc-received-type";
 const char RpcChannel::K_RPC_RECEIVED_VAR[] = "rpc-received";
 const char RpcChannel::K_RPC_SENT_ERROR_VAR[] = "rpc-send-errors";
 const char RpcChannel::K_RPC_SENT_VAR[] = "rpc-sent";
+const char RpcChannel::K_RPC_DMX_DROPPED_VAR[] = "rpc-dmx-frames-dropped";
+const char RpcChannel::K_RPC_DMX_QUEUED_VAR[] = "rpc-dmx-frames-queued";
 const char RpcChannel::STREAMING_NO_RESPONSE[] = "STREAMING_NO_RESPONSE";
 
 const char *RpcChannel::K_RPC_VARIABLES[] = {
@@ -58,6 +70,19 @@ const char *RpcChannel::K_RPC_VARIABLES[] = {
   K_RPC_SENT_VAR,
 };
 
+namespace {
+/*
+ * Check if the last send failed because the descriptor wasn't writable.
+ */
+bool WouldBlock() {
+#ifdef _WIN32
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif  // _WIN32
+}
+}  // namespace
+
 class OutstandingRequest {
   /*
    * These are requests on the server end that haven't completed yet.
@@ -117,8 +142,19 @@ RpcChannel::RpcChannel(
       m_buffer_size(0),
       m_expected_size(0),
       m_current_size(0),
+      m_expected_version(PROTOCOL_VERSION),
+      m_peer_features(0),
+      m_features_sent(false),
       m_export_map(export_map),
-      m_recv_type_map(NULL) {
+      m_recv_type_map(NULL),
+      m_sent_var(NULL),
+      m_sent_error_var(NULL),
+      m_received_var(NULL),
+      m_queue_ss(NULL),
+      m_ss(NULL),
+      m_write_registered(false),
+      m_dropped_frames(0),
+      m_keyframe_interval(0) {
   if (descriptor) {
     descriptor->SetOnData(
         ola::NewCallback(this, &RpcChannel::DescriptorReady));
@@ -130,12 +166,28 @@ RpcChannel::RpcChannel(
     for (unsigned int i = 0; i < arraysize(K_RPC_VARIABLES); ++i) {
       m_export_map->GetCounterVar(string(K_RPC_VARIABLES[i]));
     }
+    m_sent_var = m_export_map->GetCounterVar(K_RPC_SENT_VAR);
+    m_sent_error_var = m_export_map->GetCounterVar(K_RPC_SENT_ERROR_VAR);
+    m_received_var = m_export_map->GetCounterVar(K_RPC_RECEIVED_VAR);
+
+    // The per-message types get handles, the rest are looked up when they
+    // arrive.
     m_recv_type_map = m_export_map->GetUIntMapVar(K_RPC_RECEIVED_TYPE_VAR,
                                                   "type");
+    m_recv_request_var = m_recv_type_map->GetHandle("request");
+    m_recv_response_var = m_recv_type_map->GetHandle("response");
+    m_recv_stream_request_var = m_recv_type_map->GetHandle("stream_request");
+    m_recv_dmx_frame_var = m_recv_type_map->GetHandle("dmx_frame");
+    m_recv_dmx_delta_var = m_recv_type_map->GetHandle("dmx_delta");
   }
 }
 
 RpcChannel::~RpcChannel() {
+  CancelWrites();
+  if (m_export_map && !m_export_key.empty()) {
+    m_export_map->GetUIntMapVar(K_RPC_DMX_QUEUED_VAR)->Remove(m_export_key);
+    m_export_map->GetUIntMapVar(K_RPC_DMX_DROPPED_VAR)->Remove(m_export_key);
+  }
   free(m_buffer);
 }
 
@@ -149,11 +201,13 @@ void RpcChannel::DescriptorReady() {
     if (!m_expected_size)
       return;
 
-    if (version != PROTOCOL_VERSION) {
+    if (version != PROTOCOL_VERSION && version != DMX_FRAME_VERSION &&
+        version != DMX_DELTA_VERSION) {
       OLA_WARN << "protocol mismatch " << version << " != " <<
         PROTOCOL_VERSION;
       return;
     }
+    m_expected_version = version;
 
     if (m_expected_size > MAX_BUFFER_SIZE) {
       OLA_WARN << "Incoming message size " << m_expected_size
@@ -188,7 +242,15 @@ void RpcChannel::DescriptorReady() {
 
   if (m_current_size == m_expected_size) {
     // we've got all of this message so parse it.
-    if (!HandleNewMsg(m_buffer, m_expected_size)) {
+    bool ok;
+    if (m_expected_version == DMX_FRAME_VERSION) {
+      ok = HandleDmxFrame(m_buffer, m_expected_size);
+    } else if (m_expected_version == DMX_DELTA_VERSION) {
+      ok = HandleDmxDelta(m_buffer, m_expected_size);
+    } else {
+      ok = HandleNewMsg(m_buffer, m_expected_size);
+    }
+    if (!ok) {
       // this probably means we've messed the framing up, close the channel
       OLA_WARN << "Errors detected on RPC channel, closing";
       m_descriptor->Close();
@@ -277,9 +339,79 @@ RpcSession *RpcChannel::Session() {
   return m_session.get();
 }
 
+bool RpcChannel::SendDmxFrame(unsigned int universe, uint8_t priority,
+                              const uint8_t *data, unsigned int length) {
+  length = std::min(length, static_cast<unsigned int>(DMX_UNIVERSE_SIZE));
+
+  if (m_write_queue.Empty()) {
+    return WriteDmxFrame(universe, priority, data, length);
+  }
+
+  // The descriptor isn't writable, hold on to the latest frame for the
+  // universe until it is. The frame is encoded when it's sent, since a delta
+  // has to be relative to the last frame that was actually sent.
+  if (!m_descriptor) {
+    return false;
+  }
+  std::pair<std::map<unsigned int, PendingFrame>::iterator, bool> result =
+      m_pending_frames.insert(std::make_pair(universe, PendingFrame()));
+  if (!result.second) {
+    m_dropped_frames++;
+    m_dropped_frames_var.Increment();
+  }
+  result.first->second.priority = priority;
+  if (length) {
+    result.first->second.data.Set(data, length);
+  } else {
+    result.first->second.data.Reset();
+  }
+  m_queued_frames_var.Set(m_pending_frames.size());
+  return true;
+}
+
+bool RpcChannel::EnableWriteQueue(SelectServerInterface *ss) {
+  if (!m_descriptor) {
+    return false;
+  }
+
+  m_queue_ss = ss;
+  if (PeerSupportsDmxFrames()) {
+    StartWriteQueue();
+  }
+  return true;
+}
+
 // private
 //-----------------------------------------------------------------------------
 
+/*
+ * Start queueing writes, once the peer has said it accepts DMX frames.
+ */
+void RpcChannel::StartWriteQueue() {
+  if (m_ss || !m_descriptor) {
+    return;
+  }
+
+  if (!ConnectedDescriptor::SetNonBlocking(m_descriptor->WriteDescriptor())) {
+    OLA_WARN << "Failed to make RPC descriptor non-blocking";
+    return;
+  }
+
+  m_ss = m_queue_ss;
+  m_descriptor->SetOnWritable(
+      ola::NewCallback(this, &RpcChannel::DescriptorWritable));
+
+  if (m_export_map) {
+    std::ostringstream str;
+    str << m_descriptor->WriteDescriptor();
+    m_export_key = str.str();
+    m_queued_frames_var = m_export_map->GetUIntMapVar(
+        K_RPC_DMX_QUEUED_VAR, "client")->GetHandle(m_export_key);
+    m_dropped_frames_var = m_export_map->GetUIntMapVar(
+        K_RPC_DMX_DROPPED_VAR, "client")->GetHandle(m_export_key);
+  }
+}
+
 /*
  * Write an RpcMessage to the write descriptor.
  */
@@ -289,6 +421,11 @@ bool RpcChannel::SendMsg(RpcMessage *msg) {
     return false;
   }
 
+  if (!m_features_sent) {
+    msg->set_features(LocalFeatures());
+    m_features_sent = true;
+  }
+
   uint32_t header;
   // reserve the first 4 bytes for the header
   string output(sizeof(header), 0);
@@ -301,33 +438,203 @@ bool RpcChannel::SendMsg(RpcMessage *msg) {
       0, sizeof(header),
       reinterpret_cast<const char*>(&header), sizeof(header));
 
-  ssize_t ret = m_descriptor->Send(
-      reinterpret_cast<const uint8_t*>(output.data()), length);
+  return SendFrame(reinterpret_cast<const uint8_t*>(output.data()), length);
+}
+
+
+/*
+ * Write a complete frame, including the header, to the descriptor.
+ */
+bool RpcChannel::SendFrame(const uint8_t *data, unsigned int length) {
+  if (!(m_descriptor && m_descriptor->ValidReadDescriptor())) {
+    OLA_WARN << "RPC descriptor closed, not sending messages";
+    return false;
+  }
+
+  if (!m_write_queue.Empty()) {
+    // Keep the frames in order.
+    m_write_queue.Write(data, length);
+    if (m_write_queue.Size() > MAX_WRITE_QUEUE_SIZE) {
+      OLA_WARN << "RPC write queue exceeded " << MAX_WRITE_QUEUE_SIZE
+               << " bytes, closing channel";
+      WriteFailed();
+      return false;
+    }
+  } else {
+    ssize_t ret = m_descriptor->Send(data, length);
+
+    if (ret != static_cast<ssize_t>(length)) {
+      if (m_ss && (ret >= 0 || WouldBlock())) {
+        // Queue the rest and send it once the descriptor is writable.
+        const unsigned int sent = ret > 0 ? ret : 0;
+        m_write_queue.Write(data + sent, length - sent);
+        if (!m_write_registered) {
+          m_ss->AddWriteDescriptor(m_descriptor);
+          m_write_registered = true;
+        }
+      } else {
+        OLA_WARN << "Failed to send full RPC message, closing channel";
+        WriteFailed();
+        return false;
+      }
+    }
+  }
+
+  if (m_sent_var) {
+    (*m_sent_var)++;
+  }
+  return true;
+}
 
-  if (ret != length) {
-    OLA_WARN << "Failed to send full RPC message, closing channel";
 
-    if (m_export_map) {
-      (*m_export_map->GetCounterVar(K_RPC_SENT_ERROR_VAR))++;
+/*
+ * Encode a DMX frame, as a delta if we can, and write it to the descriptor.
+ */
+bool RpcChannel::WriteDmxFrame(unsigned int universe, uint8_t priority,
+                               const uint8_t *data, unsigned int length) {
+  uint8_t frame[sizeof(uint32_t) + RpcHeader::DMX_FRAME_HEADER_SIZE +
+                DMX_UNIVERSE_SIZE];
+  uint8_t *payload = frame + sizeof(uint32_t) +
+                     RpcHeader::DMX_FRAME_HEADER_SIZE;
+  unsigned int version = DMX_FRAME_VERSION;
+  unsigned int payload_size = length;
+
+  SentFrame *sent = NULL;
+  if (m_keyframe_interval) {
+    std::map<unsigned int, SentFrame>::iterator iter =
+        m_sent_frames.find(universe);
+    if (iter == m_sent_frames.end()) {
+      SentFrame new_frame;
+      new_frame.priority = priority;
+      new_frame.deltas_sent = 0;
+      iter = m_sent_frames.insert(std::make_pair(universe, new_frame)).first;
+    } else if (PeerSupportsDmxDeltas() && length &&
+               iter->second.deltas_sent < m_keyframe_interval &&
+               iter->second.priority == priority &&
+               iter->second.data.Size() == length) {
+      // Only use the delta if it's smaller than the frame.
+      unsigned int delta_size = length - 1;
+      if (m_delta_encoder.Encode(iter->second.data.GetRaw(), data, length,
+                                 payload, &delta_size)) {
+        version = DMX_DELTA_VERSION;
+        payload_size = delta_size;
+      }
     }
+    sent = &iter->second;
+  }
 
-    // At this point there is no point using the descriptor since framing has
-    // probably been messed up.
-    // TODO(simon): consider if it's worth leaving the descriptor open for
-    // reading.
-    m_descriptor = NULL;
+  if (version == DMX_FRAME_VERSION && length) {
+    memcpy(payload, data, length);
+  }
 
-    HandleChannelClose();
+  uint32_t header;
+  RpcHeader::EncodeHeader(&header, version,
+                          RpcHeader::DMX_FRAME_HEADER_SIZE + payload_size);
+  memcpy(frame, &header, sizeof(header));
+  RpcHeader::EncodeDmxFrameHeader(frame + sizeof(header), universe, priority,
+                                  length);
+
+  if (!SendFrame(frame, sizeof(header) + RpcHeader::DMX_FRAME_HEADER_SIZE +
+                        payload_size)) {
     return false;
   }
 
-  if (m_export_map) {
-    (*m_export_map->GetCounterVar(K_RPC_SENT_VAR))++;
+  if (sent) {
+    if (version == DMX_DELTA_VERSION) {
+      sent->deltas_sent++;
+    } else {
+      sent->priority = priority;
+      sent->deltas_sent = 0;
+    }
+    if (length) {
+      sent->data.Set(data, length);
+    } else {
+      sent->data.Reset();
+    }
   }
   return true;
 }
 
 
+/*
+ * Called when the descriptor is writable and we have data queued.
+ */
+void RpcChannel::DescriptorWritable() {
+  if (!m_descriptor) {
+    return;
+  }
+
+  if (!m_write_queue.Empty()) {
+    if (m_descriptor->Send(&m_write_queue) < 0 && !WouldBlock()) {
+      OLA_WARN << "Failed to send queued RPC data, closing channel";
+      WriteFailed();
+      return;
+    }
+  }
+
+  if (m_write_queue.Empty()) {
+    SendPendingFrames();
+  }
+
+  if (m_write_queue.Empty() && m_write_registered && m_descriptor) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+    m_write_registered = false;
+  }
+}
+
+
+/*
+ * Send the DMX frames that were held back while the descriptor wasn't
+ * writable.
+ */
+void RpcChannel::SendPendingFrames() {
+  std::map<unsigned int, PendingFrame> frames;
+  frames.swap(m_pending_frames);
+  m_queued_frames_var.Set(0);
+
+  std::map<unsigned int, PendingFrame>::const_iterator iter = frames.begin();
+  for (; iter != frames.end(); ++iter) {
+    if (!WriteDmxFrame(iter->first, iter->second.priority,
+                       iter->second.data.GetRaw(),
+                       iter->second.data.Size())) {
+      return;
+    }
+  }
+}
+
+
+/*
+ * Called when a write fails. At this point there is no point using the
+ * descriptor since framing has probably been messed up.
+ */
+void RpcChannel::WriteFailed() {
+  if (m_sent_error_var) {
+    (*m_sent_error_var)++;
+  }
+
+  // TODO(simon): consider if it's worth leaving the descriptor open for
+  // reading.
+  CancelWrites();
+  m_descriptor = NULL;
+  HandleChannelClose();
+}
+
+
+/*
+ * Discard any queued data and stop waiting for the descriptor to become
+ * writable.
+ */
+void RpcChannel::CancelWrites() {
+  if (m_write_registered && m_descriptor) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+  }
+  m_write_registered = false;
+  m_write_queue.Clear();
+  m_pending_frames.clear();
+  m_queued_frames_var.Set(0);
+}
+
+
 /*
  * Allocate an incoming message buffer
  * @param size the size of the new buffer to allocate
@@ -393,18 +700,20 @@ bool RpcChannel::HandleNewMsg(uint8_t *data, unsigned int size) {
     return false;
   }
 
-  if (m_export_map)
-    (*m_export_map->GetCounterVar(K_RPC_RECEIVED_VAR))++;
+  if (m_received_var)
+    (*m_received_var)++;
+
+  if (msg.has_features()) {
+    PeerFeaturesReceived(msg.features());
+  }
 
   switch (msg.type()) {
     case REQUEST:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["request"]++;
+      m_recv_request_var.Increment();
       HandleRequest(&msg);
       break;
     case RESPONSE:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["response"]++;
+      m_recv_response_var.Increment();
       HandleResponse(&msg);
       break;
     case RESPONSE_CANCEL:
@@ -423,10 +732,13 @@ bool RpcChannel::HandleNewMsg(uint8_t *data, unsigned int size) {
       HandleNotImplemented(&msg);
       break;
     case STREAM_REQUEST:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["stream_request"]++;
+      m_recv_stream_request_var.Increment();
       HandleStreamRequest(&msg);
       break;
+    case FEATURES:
+      if (m_recv_type_map)
+        (*m_recv_type_map)["features"]++;
+      break;
     default:
       OLA_WARN << "not sure of msg type " << msg.type();
       break;
@@ -435,6 +747,99 @@ bool RpcChannel::HandleNewMsg(uint8_t *data, unsigned int size) {
 }
 
 
+/*
+ * Handle a compact DMX frame.
+ */
+bool RpcChannel::HandleDmxFrame(const uint8_t *data, unsigned int size) {
+  unsigned int universe, length;
+  uint8_t priority;
+  if (!RpcHeader::DecodeDmxFrameHeader(data, size, &universe, &priority,
+                                       &length)) {
+    OLA_WARN << "Invalid DMX frame of size " << size;
+    return false;
+  }
+
+  if (m_received_var)
+    (*m_received_var)++;
+  m_recv_dmx_frame_var.Increment();
+
+  if (!m_service || !m_service->SupportsDmxFrames()) {
+    OLA_WARN << "DMX frame received but the service doesn't support them";
+    return true;
+  }
+
+  RpcController controller(m_session.get());
+  m_service->DmxFrameReceived(&controller, universe, priority,
+                              data + RpcHeader::DMX_FRAME_HEADER_SIZE, length);
+  return true;
+}
+
+
+/*
+ * Handle a DMX delta.
+ */
+bool RpcChannel::HandleDmxDelta(const uint8_t *data, unsigned int size) {
+  unsigned int universe, length;
+  uint8_t priority;
+  if (!RpcHeader::DecodeDmxDeltaHeader(data, size, &universe, &priority,
+                                       &length)) {
+    OLA_WARN << "Invalid DMX delta of size " << size;
+    return false;
+  }
+
+  if (m_received_var)
+    (*m_received_var)++;
+  m_recv_dmx_delta_var.Increment();
+
+  if (!m_service || !m_service->SupportsDmxDeltas()) {
+    OLA_WARN << "DMX delta received but the service doesn't support them";
+    return true;
+  }
+
+  RpcController controller(m_session.get());
+  m_service->DmxDeltaReceived(&controller, universe, priority, length,
+                              data + RpcHeader::DMX_FRAME_HEADER_SIZE,
+                              size - RpcHeader::DMX_FRAME_HEADER_SIZE);
+  return true;
+}
+
+
+/*
+ * Return the features this end of the channel supports.
+ */
+uint32_t RpcChannel::LocalFeatures() const {
+  uint32_t features = 0;
+  if (m_service && m_service->SupportsDmxFrames()) {
+    features |= FEATURE_DMX_FRAMES;
+    if (m_service->SupportsDmxDeltas()) {
+      features |= FEATURE_DMX_DELTAS;
+    }
+  }
+  if (m_service && m_service->SupportsDmxBatches()) {
+    features |= FEATURE_DMX_BATCHES;
+  }
+  return features;
+}
+
+
+/*
+ * Called when the peer tells us what it supports. If we haven't sent anything
+ * yet we reply with our own features, the peer set the field so it knows how
+ * to handle a FEATURES message.
+ */
+void RpcChannel::PeerFeaturesReceived(uint32_t features) {
+  m_peer_features = features;
+  if (m_queue_ss && PeerSupportsDmxFrames()) {
+    StartWriteQueue();
+  }
+  if (!m_features_sent) {
+    RpcMessage message;
+    message.set_type(FEATURES);
+    SendMsg(&message);
+  }
+}
+
+
 /*
  * Handle a new RPC method call.
  */
@@ -625,6 +1030,7 @@ void RpcChannel::HandleNotImplemented(RpcMessage *msg) {
  * Invoke the Channel close handler/
  */
 void RpcChannel::HandleChannelClose() {
+  CancelWrites();
   if (m_on_close.get()) {
     m_on_close.release()->Run(m_session.get());
   }
@@ -28,9 +28,15 @@
 #include <stdint.h>
 #include <google/protobuf/service.h>
 #include <ola/Callback.h>
+#include <ola/DmxBuffer.h>
+#include <ola/dmx/DeltaEncoder.h>
 #include <ola/io/Descriptor.h>
+#include <ola/io/IOQueue.h>
+#include <ola/io/SelectServerInterface.h>
 #include <ola/util/SequenceNumber.h>
+#include <map>
 #include <memory>
+#include <string>
 
 #include "ola/ExportMap.h"
 
@@ -130,15 +136,162 @@ class RpcChannel {
      */
     RpcSession *Session();
 
+    /**
+     * @brief Check if the peer accepts compact DMX frames.
+     * @returns true if the peer has advertised FEATURE_DMX_FRAMES.
+     *
+     * Support is negotiated when the first messages are exchanged, until then
+     * this returns false and DMX should be sent using the regular RPC.
+     */
+    bool PeerSupportsDmxFrames() const {
+      return m_peer_features & FEATURE_DMX_FRAMES;
+    }
+
+    /**
+     * @brief Send a DMX frame using the compact encoding.
+     * @param universe the universe the data is for.
+     * @param priority the priority of the data.
+     * @param data the slot data.
+     * @param length the number of slots, at most DMX_UNIVERSE_SIZE.
+     * @returns true if the frame was sent, false otherwise.
+     *
+     * The frame is a fixed header followed by the slots, it avoids the
+     * protobuf encoding and the method lookup on the receiving end. This
+     * should only be used if PeerSupportsDmxFrames() returns true.
+     */
+    bool SendDmxFrame(unsigned int universe, uint8_t priority,
+                      const uint8_t *data, unsigned int length);
+
+    /**
+     * @brief Check if the peer accepts DMX deltas.
+     * @returns true if the peer has advertised FEATURE_DMX_DELTAS.
+     */
+    bool PeerSupportsDmxDeltas() const {
+      return m_peer_features & FEATURE_DMX_DELTAS;
+    }
+
+    /**
+     * @brief Check if the peer accepts batched DMX updates.
+     * @returns true if the peer has advertised FEATURE_DMX_BATCHES.
+     *
+     * Like PeerSupportsDmxFrames() this returns false until the features
+     * have been exchanged.
+     */
+    bool PeerSupportsDmxBatches() const {
+      return m_peer_features & FEATURE_DMX_BATCHES;
+    }
+
+    /**
+     * @brief Send frames from SendDmxFrame() as deltas where possible.
+     * @param keyframe_interval the maximum number of deltas to send between
+     *   full frames, 0 disables deltas.
+     *
+     * Only the ranges of slots that changed since the previous frame for the
+     * universe are sent. A full frame is sent if the peer doesn't support
+     * deltas, the slot count or priority changed, the delta would be larger
+     * than the frame, or keyframe_interval deltas have been sent since the
+     * last full frame.
+     */
+    void EnableDmxDeltas(
+        unsigned int keyframe_interval = DEFAULT_KEYFRAME_INTERVAL) {
+      m_keyframe_interval = keyframe_interval;
+      m_sent_frames.clear();
+    }
+
+    /**
+     * @brief Queue data that can't be written straight away, rather than
+     * closing the channel, if the peer accepts compact DMX frames.
+     * @param ss the SelectServer to use to wait for the descriptor to become
+     *   writable. Ownership is not transferred.
+     * @returns false if the channel doesn't have a descriptor.
+     *
+     * The queue is only used once the peer has advertised FEATURE_DMX_FRAMES.
+     * Until then, and for peers that never do, writes behave as before: the
+     * descriptor is left blocking and a short write closes the channel.
+     *
+     * While data is queued, DMX frames sent with SendDmxFrame() are held back
+     * and a newer frame for a universe replaces the one that is waiting, so a
+     * slow peer gets the latest data rather than a growing backlog. If more
+     * than MAX_WRITE_QUEUE_SIZE bytes are queued the peer isn't reading and
+     * the channel is closed.
+     */
+    bool EnableWriteQueue(ola::io::SelectServerInterface *ss);
+
+    /**
+     * @brief Check if writes are being queued.
+     * @returns true if EnableWriteQueue() was called and the peer accepts
+     *   compact DMX frames.
+     */
+    bool WriteQueueActive() const { return m_ss != NULL; }
+
+    /**
+     * @brief The number of bytes waiting to be written.
+     */
+    unsigned int QueuedBytes() const { return m_write_queue.Size(); }
+
+    /**
+     * @brief The number of DMX frames waiting for the descriptor to become
+     * writable. This is at most one per universe.
+     */
+    unsigned int QueuedDmxFrames() const { return m_pending_frames.size(); }
+
+    /**
+     * @brief The number of DMX frames that were replaced by a newer frame
+     * before they could be sent.
+     */
+    unsigned int DroppedDmxFrames() const { return m_dropped_frames; }
+
     /**
      * @brief the RPC protocol version.
      */
     static const unsigned int PROTOCOL_VERSION = 1;
 
+    /**
+     * @brief the version used in the RPC header for compact DMX frames.
+     */
+    static const unsigned int DMX_FRAME_VERSION = 2;
+
+    /**
+     * @brief Set in the features if the sender accepts compact DMX frames.
+     */
+    static const uint32_t FEATURE_DMX_FRAMES = 1;
+
+    /**
+     * @brief the version used in the RPC header for DMX deltas.
+     */
+    static const unsigned int DMX_DELTA_VERSION = 3;
+
+    /**
+     * @brief Set in the features if the sender accepts DMX deltas.
+     */
+    static const uint32_t FEATURE_DMX_DELTAS = 2;
+
+    /**
+     * @brief Set in the features if the sender handles the StreamDmxBatch
+     * method.
+     */
+    static const uint32_t FEATURE_DMX_BATCHES = 4;
+
+    /**
+     * @brief The default number of deltas between full frames.
+     */
+    static const unsigned int DEFAULT_KEYFRAME_INTERVAL = 40;
+
  private:
     typedef HASH_NAMESPACE::HASH_MAP_CLASS<int, class OutstandingResponse*>
       ResponseMap;
 
+    typedef struct {
+      uint8_t priority;
+      DmxBuffer data;
+    } PendingFrame;
+
+    typedef struct {
+      uint8_t priority;
+      DmxBuffer data;
+      unsigned int deltas_sent;
+    } SentFrame;
+
     std::auto_ptr<RpcSession> m_session;
     RpcService *m_service;  // service to dispatch requests to
     std::auto_ptr<CloseCallback> m_on_close;
@@ -149,15 +302,58 @@ class RpcChannel {
     unsigned int m_buffer_size;  // size of the buffer
     unsigned int m_expected_size;  // the total size of the current msg
     unsigned int m_current_size;  // the amount of data read for the current msg
+    unsigned int m_expected_version;  // the version of the current msg
+    uint32_t m_peer_features;
+    bool m_features_sent;
     HASH_NAMESPACE::HASH_MAP_CLASS<int, class OutstandingRequest*> m_requests;
     ResponseMap m_responses;
     ExportMap *m_export_map;
     UIntMap *m_recv_type_map;
+    CounterVariable *m_sent_var;
+    CounterVariable *m_sent_error_var;
+    CounterVariable *m_received_var;
+    UIntMapHandle m_recv_request_var;
+    UIntMapHandle m_recv_response_var;
+    UIntMapHandle m_recv_stream_request_var;
+    UIntMapHandle m_recv_dmx_frame_var;
+    UIntMapHandle m_recv_dmx_delta_var;
+
+    // Set by EnableWriteQueue(), the queue is started once the peer
+    // advertises FEATURE_DMX_FRAMES.
+    ola::io::SelectServerInterface *m_queue_ss;
+    // Only used once the write queue has started.
+    ola::io::SelectServerInterface *m_ss;
+    ola::io::IOQueue m_write_queue;
+    bool m_write_registered;
+    // DMX frames waiting to be sent, keyed by universe.
+    std::map<unsigned int, PendingFrame> m_pending_frames;
+    unsigned int m_dropped_frames;
+    std::string m_export_key;
+    UIntMapHandle m_queued_frames_var;
+    UIntMapHandle m_dropped_frames_var;
+
+    // Only used if EnableDmxDeltas() has been called. The last frame sent
+    // for each universe, which the next delta is relative to.
+    unsigned int m_keyframe_interval;
+    std::map<unsigned int, SentFrame> m_sent_frames;
+    ola::dmx::DeltaEncoder m_delta_encoder;
 
     bool SendMsg(RpcMessage *msg);
+    bool SendFrame(const uint8_t *data, unsigned int length);
+    bool WriteDmxFrame(unsigned int universe, uint8_t priority,
+                       const uint8_t *data, unsigned int length);
+    void DescriptorWritable();
+    void SendPendingFrames();
+    void StartWriteQueue();
+    void WriteFailed();
+    void CancelWrites();
     int AllocateMsgBuffer(unsigned int size);
     int ReadHeader(unsigned int *version, unsigned int *size) const;
     bool HandleNewMsg(uint8_t *buffer, unsigned int size);
+    bool HandleDmxFrame(const uint8_t *buffer, unsigned int size);
+    bool HandleDmxDelta(const uint8_t *buffer, unsigned int size);
+    uint32_t LocalFeatures() const;
+    void PeerFeaturesReceived(uint32_t features);
     void HandleRequest(RpcMessage *msg);
     void HandleStreamRequest(RpcMessage *msg);
 
@@ -178,10 +374,13 @@ class RpcChannel {
     static const char K_RPC_RECEIVED_VAR[];
     static const char K_RPC_SENT_ERROR_VAR[];
     static const char K_RPC_SENT_VAR[];
+    static const char K_RPC_DMX_DROPPED_VAR[];
+    static const char K_RPC_DMX_QUEUED_VAR[];
     static const char *K_RPC_VARIABLES[];
     static const char STREAMING_NO_RESPONSE[];
     static const unsigned int INITIAL_BUFFER_SIZE = 1 << 11;  // 2k
     static const unsigned int MAX_BUFFER_SIZE = 1 << 20;  // 1M
+    static const unsigned int MAX_WRITE_QUEUE_SIZE = 1 << 20;  // 1M
 };
 }  // namespace rpc
 }  // namespace ola
@@ -18,29 +18,40 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <string.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <google/protobuf/stubs/common.h>
 #include <memory>
 #include <string>
 
 #include "common/rpc/RpcChannel.h"
+#include "common/rpc/Rpc.pb.h"
 #include "common/rpc/RpcController.h"
+#include "common/rpc/RpcHeader.h"
 #include "common/rpc/TestService.h"
 #include "common/rpc/TestService.pb.h"
 #include "common/rpc/TestServiceService.pb.h"
 #include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/io/Descriptor.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/Socket.h"
 #include "ola/testing/TestUtils.h"
 
 
 using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::io::ConnectedDescriptor;
 using ola::io::LoopbackDescriptor;
 using ola::io::SelectServer;
+using ola::io::UnixSocket;
 using ola::rpc::EchoReply;
 using ola::rpc::EchoRequest;
 using ola::rpc::RpcChannel;
 using ola::rpc::RpcController;
+using ola::rpc::RpcHeader;
+using ola::rpc::RpcMessage;
 using ola::rpc::STREAMING_NO_RESPONSE;
 using ola::rpc::RpcController;
 using ola::rpc::TestService;
@@ -53,6 +64,13 @@ class RpcChannelTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testEcho);
   CPPUNIT_TEST(testFailedEcho);
   CPPUNIT_TEST(testStreamRequest);
+  CPPUNIT_TEST(testDmxFrame);
+  CPPUNIT_TEST(testDmxFrameQueue);
+  CPPUNIT_TEST(testDmxDelta);
+#ifndef _WIN32
+  CPPUNIT_TEST(testOldPeer);
+  CPPUNIT_TEST(testNewPeers);
+#endif  // !_WIN32
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -61,25 +79,37 @@ class RpcChannelTest: public CppUnit::TestFixture {
   void testEcho();
   void testFailedEcho();
   void testStreamRequest();
+  void testDmxFrame();
+  void testDmxFrameQueue();
+  void testDmxDelta();
+  void testOldPeer();
+  void testNewPeers();
   void EchoComplete();
   void FailedEchoComplete();
+  void ChannelClosed(ola::rpc::RpcSession*) { m_channel_closed = true; }
 
  private:
   RpcController m_controller;
   EchoRequest m_request;
   EchoReply m_reply;
   SelectServer m_ss;
+  bool m_channel_closed;
 
   auto_ptr<TestServiceImpl> m_service;
   auto_ptr<RpcChannel> m_channel;
   auto_ptr<TestService_Stub> m_stub;
   auto_ptr<LoopbackDescriptor> m_socket;
+
+  void SendOldStyleStream(ConnectedDescriptor *socket);
+  bool ReceiveMessage(ConnectedDescriptor *socket, unsigned int *version,
+                      RpcMessage *message);
 };
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RpcChannelTest);
 
 void RpcChannelTest::setUp() {
+  m_channel_closed = false;
   m_socket.reset(new LoopbackDescriptor());
   m_socket->Init();
 
@@ -91,6 +121,8 @@ void RpcChannelTest::setUp() {
 
 void RpcChannelTest::tearDown() {
   m_ss.RemoveReadDescriptor(m_socket.get());
+  // The channel may have registered the descriptor for writes.
+  m_channel.reset();
 }
 
 void RpcChannelTest::EchoComplete() {
@@ -139,3 +171,333 @@ void RpcChannelTest::testStreamRequest() {
   m_stub->Stream(NULL, &m_request, NULL, NULL);
   m_ss.Run();
 }
+
+/*
+ * Check compact DMX frames are negotiated and delivered.
+ */
+void RpcChannelTest::testDmxFrame() {
+  // Nothing has been exchanged yet.
+  OLA_ASSERT_FALSE(m_channel->PeerSupportsDmxFrames());
+
+  // The first message carries the features.
+  m_request.set_data("foo");
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  m_ss.Run();
+  OLA_ASSERT_TRUE(m_channel->PeerSupportsDmxFrames());
+  // Batches are advertised separately, the TestService doesn't handle them.
+  OLA_ASSERT_FALSE(m_channel->PeerSupportsDmxBatches());
+
+  const uint8_t slots[] = {1, 2, 3, 4, 5, 0, 255};
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(10, 150, slots, sizeof(slots)));
+  m_ss.Run();
+  OLA_ASSERT_EQ(10u, m_service->LastFrameUniverse());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), m_service->LastFramePriority());
+  OLA_ASSERT_EQ(string(reinterpret_cast<const char*>(slots), sizeof(slots)),
+                m_service->LastFrameData());
+
+  // An empty frame.
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(11, 100, NULL, 0));
+  m_ss.Run();
+  OLA_ASSERT_EQ(11u, m_service->LastFrameUniverse());
+  OLA_ASSERT_EQ(string(), m_service->LastFrameData());
+}
+
+
+/*
+ * Check that DMX frames are held back, and replaced by newer ones, while the
+ * descriptor isn't writable.
+ */
+void RpcChannelTest::testDmxFrameQueue() {
+  OLA_ASSERT_TRUE(m_channel->EnableWriteQueue(&m_ss));
+  // The queue isn't used until the peer accepts DMX frames.
+  OLA_ASSERT_FALSE(m_channel->WriteQueueActive());
+
+  m_request.set_data("foo");
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  m_ss.Run();
+  OLA_ASSERT_TRUE(m_channel->PeerSupportsDmxFrames());
+  OLA_ASSERT_TRUE(m_channel->WriteQueueActive());
+
+  // Fill the pipe without reading from it.
+  uint8_t slots[ola::DMX_UNIVERSE_SIZE];
+  memset(slots, 0, sizeof(slots));
+  unsigned int frames_sent = 0;
+  while (m_channel->QueuedBytes() == 0 && frames_sent < 100000) {
+    OLA_ASSERT_TRUE(m_channel->SendDmxFrame(1, 100, slots, sizeof(slots)));
+    frames_sent++;
+  }
+  OLA_ASSERT_TRUE(m_channel->QueuedBytes() > 0);
+  OLA_ASSERT_EQ(0u, m_channel->QueuedDmxFrames());
+  const unsigned int queued_bytes = m_channel->QueuedBytes();
+
+  // These are held back rather than queued.
+  slots[0] = 1;
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(3, 100, slots, sizeof(slots)));
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(2, 100, slots, sizeof(slots)));
+  slots[0] = 2;
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(3, 100, slots, sizeof(slots)));
+  OLA_ASSERT_EQ(queued_bytes, m_channel->QueuedBytes());
+  OLA_ASSERT_EQ(2u, m_channel->QueuedDmxFrames());
+  OLA_ASSERT_EQ(1u, m_channel->DroppedDmxFrames());
+
+  // Reading from the pipe lets the queue drain. The frames are sent in
+  // universe order, so universe 3 is last.
+  for (unsigned int i = 0;
+       i < 100000 && m_service->FrameCount() < frames_sent + 2; i++) {
+    m_ss.RunOnce(TimeInterval(0, 1000));
+  }
+  OLA_ASSERT_EQ(frames_sent + 2, m_service->FrameCount());
+  OLA_ASSERT_EQ(0u, m_channel->QueuedBytes());
+  OLA_ASSERT_EQ(0u, m_channel->QueuedDmxFrames());
+  OLA_ASSERT_EQ(3u, m_service->LastFrameUniverse());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(2),
+                static_cast<uint8_t>(m_service->LastFrameData()[0]));
+
+  // Once the queue is empty, frames are sent straight away.
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(4, 100, slots, sizeof(slots)));
+  OLA_ASSERT_EQ(0u, m_channel->QueuedDmxFrames());
+  m_ss.Run();
+  OLA_ASSERT_EQ(4u, m_service->LastFrameUniverse());
+}
+
+
+/*
+ * Check that DMX frames are sent as deltas, with periodic full frames.
+ */
+void RpcChannelTest::testDmxDelta() {
+  m_channel->EnableDmxDeltas(2);
+
+  m_request.set_data("foo");
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  m_ss.Run();
+  OLA_ASSERT_TRUE(m_channel->PeerSupportsDmxDeltas());
+
+  uint8_t slots[ola::DMX_UNIVERSE_SIZE];
+  memset(slots, 0, sizeof(slots));
+
+  // The first frame is always sent in full.
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(1, 100, slots, sizeof(slots)));
+  m_ss.Run();
+  OLA_ASSERT_EQ(1u, m_service->FrameCount());
+  OLA_ASSERT_EQ(0u, m_service->DeltaCount());
+
+  // Then deltas, including one where nothing changed.
+  slots[10] = 10;
+  slots[400] = 40;
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(1, 100, slots, sizeof(slots)));
+  m_ss.Run();
+  OLA_ASSERT_EQ(1u, m_service->DeltaCount());
+  OLA_ASSERT_EQ(string(reinterpret_cast<const char*>(slots), sizeof(slots)),
+                m_service->LastFrameData());
+
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(1, 100, slots, sizeof(slots)));
+  m_ss.Run();
+  OLA_ASSERT_EQ(2u, m_service->DeltaCount());
+  OLA_ASSERT_EQ(string(reinterpret_cast<const char*>(slots), sizeof(slots)),
+                m_service->LastFrameData());
+
+  // The keyframe interval was reached.
+  slots[11] = 11;
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(1, 100, slots, sizeof(slots)));
+  m_ss.Run();
+  OLA_ASSERT_EQ(4u, m_service->FrameCount());
+  OLA_ASSERT_EQ(2u, m_service->DeltaCount());
+
+  // A change in priority or size forces a full frame.
+  slots[12] = 12;
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(1, 50, slots, sizeof(slots)));
+  m_ss.Run();
+  OLA_ASSERT_EQ(2u, m_service->DeltaCount());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(50), m_service->LastFramePriority());
+
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(1, 50, slots, 100));
+  m_ss.Run();
+  OLA_ASSERT_EQ(2u, m_service->DeltaCount());
+  OLA_ASSERT_EQ(string(reinterpret_cast<const char*>(slots), 100),
+                m_service->LastFrameData());
+
+  // If everything changed, the full frame is smaller.
+  memset(slots, 255, sizeof(slots));
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(1, 50, slots, 100));
+  m_ss.Run();
+  OLA_ASSERT_EQ(7u, m_service->FrameCount());
+  OLA_ASSERT_EQ(2u, m_service->DeltaCount());
+  OLA_ASSERT_EQ(string(reinterpret_cast<const char*>(slots), 100),
+                m_service->LastFrameData());
+
+  // Other universes have their own state.
+  OLA_ASSERT_TRUE(m_channel->SendDmxFrame(2, 100, slots, 100));
+  m_ss.Run();
+  OLA_ASSERT_EQ(2u, m_service->DeltaCount());
+  OLA_ASSERT_EQ(2u, m_service->LastFrameUniverse());
+}
+
+
+/*
+ * Send a stream request the way a peer without feature negotiation does, i.e.
+ * without the features field.
+ */
+void RpcChannelTest::SendOldStyleStream(ConnectedDescriptor *socket) {
+  EchoRequest request;
+  request.set_data(TestClient::kTestData);
+  RpcMessage message;
+  message.set_type(ola::rpc::STREAM_REQUEST);
+  message.set_id(0);
+  message.set_name("Stream");
+  request.SerializeToString(message.mutable_buffer());
+
+  uint32_t header;
+  string output(sizeof(header), 0);
+  message.AppendToString(&output);
+  RpcHeader::EncodeHeader(&header, RpcChannel::PROTOCOL_VERSION,
+                          output.size() - sizeof(header));
+  output.replace(0, sizeof(header), reinterpret_cast<const char*>(&header),
+                 sizeof(header));
+  OLA_ASSERT_EQ(static_cast<ssize_t>(output.size()),
+                socket->Send(reinterpret_cast<const uint8_t*>(output.data()),
+                             output.size()));
+}
+
+
+/*
+ * Read a single message from the socket, as a peer without feature
+ * negotiation would.
+ */
+bool RpcChannelTest::ReceiveMessage(ConnectedDescriptor *socket,
+                                    unsigned int *version,
+                                    RpcMessage *message) {
+  uint8_t buffer[1024];
+  unsigned int data_read = 0;
+  if (socket->Receive(buffer, sizeof(buffer), data_read) || !data_read) {
+    return false;
+  }
+
+  uint32_t header;
+  unsigned int size;
+  OLA_ASSERT_TRUE(data_read >= sizeof(header));
+  memcpy(&header, buffer, sizeof(header));
+  RpcHeader::DecodeHeader(header, version, &size);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(data_read - sizeof(header)), size);
+  return message->ParseFromArray(buffer + sizeof(header), size);
+}
+
+
+/*
+ * Check a channel talking to a peer that doesn't negotiate features falls
+ * back to the plain RPCs in both directions.
+ */
+void RpcChannelTest::testOldPeer() {
+  UnixSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  auto_ptr<UnixSocket> old_end(socket.OppositeEnd());
+
+  TestServiceImpl service(&m_ss);
+  RpcChannel channel(&service, &socket);
+  m_ss.AddReadDescriptor(&socket);
+  OLA_ASSERT_TRUE(channel.EnableWriteQueue(&m_ss));
+
+  // An old client calls the new server.
+  SendOldStyleStream(old_end.get());
+  m_ss.Run();
+  OLA_ASSERT_FALSE(channel.PeerSupportsDmxFrames());
+  OLA_ASSERT_FALSE(channel.PeerSupportsDmxDeltas());
+
+  // Writes to the old client aren't queued.
+  OLA_ASSERT_FALSE(channel.WriteQueueActive());
+
+  // The new end didn't send a FEATURES message, which the old end can't
+  // parse.
+  unsigned int version;
+  RpcMessage message;
+  OLA_ASSERT_FALSE(ReceiveMessage(old_end.get(), &version, &message));
+
+  // The new end calls the old one. The first message carries the features,
+  // which the old end ignores, and is otherwise a plain stream request.
+  TestService_Stub stub(&channel);
+  m_request.set_data(TestClient::kTestData);
+  stub.Stream(NULL, &m_request, NULL, NULL);
+  OLA_ASSERT_TRUE(ReceiveMessage(old_end.get(), &version, &message));
+  OLA_ASSERT_EQ(1u, version);
+  OLA_ASSERT_EQ(ola::rpc::STREAM_REQUEST, message.type());
+  OLA_ASSERT_EQ(string("Stream"), message.name());
+  OLA_ASSERT_TRUE(message.has_features());
+
+  // The old end never replies with its features, so DMX keeps using the
+  // plain RPC, without the write queue.
+  m_ss.RunOnce(TimeInterval(0, 10000));
+  OLA_ASSERT_FALSE(channel.PeerSupportsDmxFrames());
+  OLA_ASSERT_FALSE(channel.PeerSupportsDmxBatches());
+  OLA_ASSERT_FALSE(channel.WriteQueueActive());
+
+  stub.Stream(NULL, &m_request, NULL, NULL);
+  OLA_ASSERT_TRUE(ReceiveMessage(old_end.get(), &version, &message));
+  OLA_ASSERT_EQ(1u, version);
+  OLA_ASSERT_FALSE(message.has_features());
+
+  // A write that doesn't fit closes the channel, as it always has, rather
+  // than being queued.
+  channel.SetChannelCloseHandler(
+      NewSingleCallback(this, &RpcChannelTest::ChannelClosed));
+  m_request.set_data(string(1000, 'x'));
+  for (unsigned int i = 0; i < 100000 && !m_channel_closed; i++) {
+    stub.Stream(NULL, &m_request, NULL, NULL);
+  }
+  OLA_ASSERT_TRUE(m_channel_closed);
+  OLA_ASSERT_EQ(0u, channel.QueuedBytes());
+
+  m_ss.RemoveReadDescriptor(&socket);
+}
+
+
+/*
+ * Check two channels that both negotiate features switch to DMX frames.
+ */
+void RpcChannelTest::testNewPeers() {
+  UnixSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+  auto_ptr<UnixSocket> server_socket(client_socket.OppositeEnd());
+
+  TestServiceImpl client_service(&m_ss), server_service(&m_ss);
+  RpcChannel client_channel(&client_service, &client_socket);
+  RpcChannel server_channel(&server_service, server_socket.get());
+  m_ss.AddReadDescriptor(&client_socket);
+  m_ss.AddReadDescriptor(server_socket.get());
+  OLA_ASSERT_TRUE(server_channel.EnableWriteQueue(&m_ss));
+
+  OLA_ASSERT_FALSE(client_channel.PeerSupportsDmxFrames());
+  OLA_ASSERT_FALSE(server_channel.PeerSupportsDmxFrames());
+  OLA_ASSERT_FALSE(server_channel.WriteQueueActive());
+
+  // The client's first call carries its features, the server replies with
+  // a FEATURES message.
+  TestService_Stub stub(&client_channel);
+  m_request.set_data(TestClient::kTestData);
+  stub.Stream(NULL, &m_request, NULL, NULL);
+  m_ss.Run();
+  OLA_ASSERT_TRUE(server_channel.PeerSupportsDmxFrames());
+  // The client accepts DMX frames, so the server queues its writes.
+  OLA_ASSERT_TRUE(server_channel.WriteQueueActive());
+  for (unsigned int i = 0;
+       i < 100 && !client_channel.PeerSupportsDmxFrames(); i++) {
+    m_ss.RunOnce(TimeInterval(0, 10000));
+  }
+  OLA_ASSERT_TRUE(client_channel.PeerSupportsDmxFrames());
+  OLA_ASSERT_TRUE(client_channel.PeerSupportsDmxDeltas());
+
+  // DMX now goes as compact frames, in both directions.
+  const uint8_t slots[] = {1, 2, 3};
+  OLA_ASSERT_TRUE(client_channel.SendDmxFrame(5, 100, slots, sizeof(slots)));
+  m_ss.Run();
+  OLA_ASSERT_EQ(1u, server_service.FrameCount());
+  OLA_ASSERT_EQ(5u, server_service.LastFrameUniverse());
+  OLA_ASSERT_EQ(string(reinterpret_cast<const char*>(slots), sizeof(slots)),
+                server_service.LastFrameData());
+
+  OLA_ASSERT_TRUE(server_channel.SendDmxFrame(6, 100, slots, sizeof(slots)));
+  m_ss.Run();
+  OLA_ASSERT_EQ(1u, client_service.FrameCount());
+  OLA_ASSERT_EQ(6u, client_service.LastFrameUniverse());
+
+  m_ss.RemoveReadDescriptor(&client_socket);
+  m_ss.RemoveReadDescriptor(server_socket.get());
+}
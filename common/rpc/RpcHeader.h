@@ -50,7 +50,71 @@ class RpcHeader {
       *size = header & SIZE_MASK;
     }
 
+    /**
+     * Encode the header of a compact DMX frame. These frames use
+     * RpcChannel::DMX_FRAME_VERSION in the RPC header and are followed by the
+     * raw slot data. All fields are in network byte order:
+     *   universe (4 bytes), priority (1 byte), reserved (1 byte),
+     *   slot count (2 bytes).
+     */
+    static void EncodeDmxFrameHeader(uint8_t *output, unsigned int universe,
+                                     uint8_t priority, unsigned int length) {
+      output[0] = static_cast<uint8_t>(universe >> 24);
+      output[1] = static_cast<uint8_t>(universe >> 16);
+      output[2] = static_cast<uint8_t>(universe >> 8);
+      output[3] = static_cast<uint8_t>(universe);
+      output[4] = priority;
+      output[5] = 0;
+      output[6] = static_cast<uint8_t>(length >> 8);
+      output[7] = static_cast<uint8_t>(length);
+    }
+
+    /**
+     * Decode the header of a compact DMX frame.
+     * @returns false if the frame size doesn't match the slot count.
+     */
+    static bool DecodeDmxFrameHeader(const uint8_t *data, unsigned int size,
+                                     unsigned int *universe,
+                                     uint8_t *priority,
+                                     unsigned int *length) {
+      if (size < DMX_FRAME_HEADER_SIZE) {
+        return false;
+      }
+      DecodeDmxFields(data, universe, priority, length);
+      return size == DMX_FRAME_HEADER_SIZE + *length;
+    }
+
+    /**
+     * Decode the header of a DMX delta. Deltas use
+     * RpcChannel::DMX_DELTA_VERSION and the same header as a compact frame,
+     * the slot count is the size of the complete frame. The header is
+     * followed by the ranges produced by ola::dmx::DeltaEncoder.
+     * @returns false if the delta is too short to contain the header.
+     */
+    static bool DecodeDmxDeltaHeader(const uint8_t *data, unsigned int size,
+                                     unsigned int *universe,
+                                     uint8_t *priority,
+                                     unsigned int *length) {
+      if (size < DMX_FRAME_HEADER_SIZE) {
+        return false;
+      }
+      DecodeDmxFields(data, universe, priority, length);
+      return true;
+    }
+
+    static const unsigned int DMX_FRAME_HEADER_SIZE = 8;
+
  private:
+    static void DecodeDmxFields(const uint8_t *data, unsigned int *universe,
+                                uint8_t *priority, unsigned int *length) {
+      *universe = (static_cast<unsigned int>(data[0]) << 24) |
+                  (static_cast<unsigned int>(data[1]) << 16) |
+                  (static_cast<unsigned int>(data[2]) << 8) |
+                  data[3];
+      *priority = data[4];
+      *length = (static_cast<unsigned int>(data[6]) << 8) | data[7];
+    }
+
     static const unsigned int VERSION_MASK = 0xf0000000;
     static const unsigned int SIZE_MASK = 0x0fffffff;
 };
@@ -32,10 +32,12 @@ using ola::rpc::RpcHeader;
 class RpcHeaderTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(RpcHeaderTest);
   CPPUNIT_TEST(testHeaderEncoding);
+  CPPUNIT_TEST(testDmxFrameHeaderEncoding);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testHeaderEncoding();
+    void testDmxFrameHeaderEncoding();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RpcHeaderTest);
@@ -59,3 +61,28 @@ void RpcHeaderTest::testHeaderEncoding() {
   RpcHeader::DecodeHeader(header, &o_version, &o_size);
   OLA_ASSERT_EQ(version, o_version);
 }
+
+void RpcHeaderTest::testDmxFrameHeaderEncoding() {
+  /*
+   * Test we can encode and decode the DMX frame headers.
+   */
+  uint8_t header[RpcHeader::DMX_FRAME_HEADER_SIZE];
+  unsigned int universe, length;
+  uint8_t priority;
+
+  RpcHeader::EncodeDmxFrameHeader(header, 0x12345678, 200, 512);
+  const uint8_t expected[] = {0x12, 0x34, 0x56, 0x78, 200, 0, 0x02, 0x00};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), header, sizeof(header));
+
+  OLA_ASSERT_TRUE(RpcHeader::DecodeDmxFrameHeader(
+      header, sizeof(header) + 512, &universe, &priority, &length));
+  OLA_ASSERT_EQ(0x12345678u, universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(200), priority);
+  OLA_ASSERT_EQ(512u, length);
+
+  // the size must match the slot count
+  OLA_ASSERT_FALSE(RpcHeader::DecodeDmxFrameHeader(
+      header, sizeof(header) + 511, &universe, &priority, &length));
+  OLA_ASSERT_FALSE(RpcHeader::DecodeDmxFrameHeader(
+      header, sizeof(header) - 1, &universe, &priority, &length));
+}
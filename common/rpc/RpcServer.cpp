@@ -36,6 +36,8 @@ using ola::io::ConnectedDescriptor;
 using ola::network::GenericSocketAddress;
 using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
+using ola::network::LocalAcceptingSocket;
+using ola::network::LocalSocket;
 using ola::network::TCPAcceptingSocket;
 using ola::network::TCPSocket;
 
@@ -49,6 +51,7 @@ void CleanupChannel(RpcChannel *channel,
 
 const char RpcServer::K_CLIENT_VAR[] = "clients-connected";
 const char RpcServer::K_RPC_PORT_VAR[] = "rpc-port";
+const char RpcServer::K_RPC_SOCKET_VAR[] = "rpc-socket";
 
 RpcServer::RpcServer(ola::io::SelectServerInterface *ss,
                      RpcService *service,
@@ -81,6 +84,10 @@ RpcServer::~RpcServer() {
   if (m_accepting_socket.get() && m_accepting_socket->ValidReadDescriptor()) {
     m_ss->RemoveReadDescriptor(m_accepting_socket.get());
   }
+
+  if (m_local_socket.get() && m_local_socket->ValidReadDescriptor()) {
+    m_ss->RemoveReadDescriptor(m_local_socket.get());
+  }
 }
 
 bool RpcServer::Init() {
@@ -115,6 +122,33 @@ bool RpcServer::Init() {
   }
 
   m_accepting_socket.reset(accepting_socket.release());
+
+  if (!m_options.socket_path.empty()) {
+    return ListenOnLocalSocket();
+  }
+  return true;
+}
+
+bool RpcServer::ListenOnLocalSocket() {
+  auto_ptr<LocalAcceptingSocket> local_socket(new LocalAcceptingSocket(
+      ola::NewCallback(this, &RpcServer::NewLocalConnection)));
+
+  if (!local_socket->Listen(m_options.socket_path, m_options.socket_group)) {
+    OLA_FATAL << "Could not listen on the RPC socket "
+              << m_options.socket_path;
+    return false;
+  }
+
+  if (!m_ss->AddReadDescriptor(local_socket.get())) {
+    OLA_WARN << "Failed to add local RPC socket to SelectServer";
+    return false;
+  }
+
+  if (m_options.export_map) {
+    m_options.export_map->GetStringVar(K_RPC_SOCKET_VAR)->Set(
+        m_options.socket_path);
+  }
+  m_local_socket.reset(local_socket.release());
   return true;
 }
 
@@ -126,11 +160,24 @@ GenericSocketAddress RpcServer::ListenAddress() {
 }
 
 bool RpcServer::AddClient(ConnectedDescriptor *descriptor) {
+  return InternalAddClient(descriptor, true);
+}
+
+bool RpcServer::InternalAddClient(ConnectedDescriptor *descriptor,
+                                  bool local) {
   // If RpcChannel had a pointer to the SelectServer to use, we could hand off
   // ownership of the socket here.
   RpcChannel *channel = new RpcChannel(m_service, descriptor,
                                        m_options.export_map);
+  // Slow clients that stream DMX frames shouldn't block the server, or be
+  // disconnected when their socket fills up. Clients that don't negotiate
+  // DMX frames keep the plain blocking writes.
+  channel->EnableWriteQueue(m_ss);
+  if (m_options.dmx_keyframe_interval) {
+    channel->EnableDmxDeltas(m_options.dmx_keyframe_interval);
+  }
 
+  channel->Session()->SetLocal(local);
   if (m_session_handler) {
     m_session_handler->NewClient(channel->Session());
   }
@@ -153,7 +200,17 @@ void RpcServer::NewTCPConnection(TCPSocket *socket) {
     return;
 
   socket->SetNoDelay();
-  AddClient(socket);
+  const GenericSocketAddress peer = socket->GetPeerAddress();
+  const bool local = (peer.Family() == AF_INET &&
+                      peer.V4Addr().Host() == IPV4Address::Loopback());
+  InternalAddClient(socket, local);
+}
+
+void RpcServer::NewLocalConnection(LocalSocket *socket) {
+  if (!socket)
+    return;
+
+  InternalAddClient(socket, true);
 }
 
 void RpcServer::ChannelClosed(ConnectedDescriptor *descriptor,
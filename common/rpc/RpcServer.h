@@ -23,10 +23,12 @@
 
 #include <stdint.h>
 #include <ola/io/SelectServerInterface.h>
+#include <ola/network/LocalSocket.h>
 #include <ola/network/TCPSocketFactory.h>
 
 #include <set>
 #include <memory>
+#include <string>
 
 namespace ola {
 
@@ -38,7 +40,8 @@ namespace rpc {
  * @brief An RPC server.
  *
  * The RPCServer starts listening on 127.0.0.0:[listen_port] for new client
- * connections. After accepting a new client connection it calls
+ * connections, and optionally on a local socket at [socket_path]. After
+ * accepting a new client connection it calls
  * RpcSessionHandlerInterface::NewClient() on the session_handler. For each RPC
  * it then invokes the correct method from the RpcService object.
  *
@@ -72,10 +75,35 @@ class RpcServer {
      */
     ola::network::TCPAcceptingSocket *listen_socket;
 
+    /**
+     * @brief The path of a local socket to also listen on.
+     *
+     * Local clients avoid the overhead of the TCP stack by connecting to
+     * this. If empty, only TCP is used.
+     */
+    std::string socket_path;
+
+    /**
+     * @brief The group allowed to connect to the local socket.
+     *
+     * If empty, only the user we're running as can connect.
+     */
+    std::string socket_group;
+
+    /**
+     * @brief Send DMX to clients as deltas, with a full frame at least this
+     * often.
+     *
+     * 0 means clients are always sent full frames. See
+     * RpcChannel::EnableDmxDeltas().
+     */
+    unsigned int dmx_keyframe_interval;
+
     Options()
       : listen_port(0),
         export_map(NULL),
-        listen_socket(NULL) {
+        listen_socket(NULL),
+        dmx_keyframe_interval(0) {
     }
   };
 
@@ -110,6 +138,9 @@ class RpcServer {
    * @brief Manually attach a new client on the given descriptor
    * @param descriptor The ConnectedDescriptor that the client is using.
    *   Ownership of the descriptor is transferred.
+   *
+   * Clients attached this way are created in the same process, so they're
+   * treated as local.
    */
   bool AddClient(ola::io::ConnectedDescriptor *descriptor);
 
@@ -123,14 +154,20 @@ class RpcServer {
 
   ola::network::TCPSocketFactory m_tcp_socket_factory;
   std::auto_ptr<ola::network::TCPAcceptingSocket> m_accepting_socket;
+  std::auto_ptr<ola::network::LocalAcceptingSocket> m_local_socket;
   ClientDescriptors m_connected_sockets;
 
+  bool ListenOnLocalSocket();
+  bool InternalAddClient(ola::io::ConnectedDescriptor *descriptor,
+                         bool local);
   void NewTCPConnection(ola::network::TCPSocket *socket);
+  void NewLocalConnection(ola::network::LocalSocket *socket);
   void ChannelClosed(ola::io::ConnectedDescriptor *socket,
                      class RpcSession *session);
 
   static const char K_CLIENT_VAR[];
   static const char K_RPC_PORT_VAR[];
+  static const char K_RPC_SOCKET_VAR[];
 };
 }  // namespace rpc
 }  // namespace ola
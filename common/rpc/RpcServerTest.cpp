@@ -18,7 +18,11 @@
  * Copyright (C) 2014 Simon Newton
  */
 
+#include <unistd.h>
+
 #include <memory>
+#include <sstream>
+#include <string>
 
 #include "common/rpc/RpcServer.h"
 #include "common/rpc/RpcSession.h"
@@ -32,6 +36,7 @@ using ola::io::SelectServer;
 using ola::rpc::RpcSession;
 using ola::rpc::RpcServer;
 using std::auto_ptr;
+using std::string;
 
 class RpcServerTest: public CppUnit::TestFixture,
                      public ola::rpc::RpcSessionHandlerInterface {
@@ -39,12 +44,14 @@ class RpcServerTest: public CppUnit::TestFixture,
   CPPUNIT_TEST(testEcho);
   CPPUNIT_TEST(testFailedEcho);
   CPPUNIT_TEST(testStreamRequest);
+  CPPUNIT_TEST(testLocalSocket);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void testEcho();
   void testFailedEcho();
   void testStreamRequest();
+  void testLocalSocket();
 
   void setUp();
 
@@ -73,6 +80,8 @@ void RpcServerTest::setUp() {
 }
 
 void RpcServerTest::NewClient(RpcSession *session) {
+  // Both the loopback TCP socket and the local socket are on this host.
+  OLA_ASSERT_TRUE(session->IsLocal());
   session->SetData(&ptr_data);
 }
 
@@ -91,3 +100,19 @@ void RpcServerTest::testFailedEcho() {
 void RpcServerTest::testStreamRequest() {
   m_client->StreamMessage();
 }
+
+void RpcServerTest::testLocalSocket() {
+#ifndef _WIN32
+  std::ostringstream str;
+  str << "/tmp/ola-rpc-test-" << getpid();
+
+  RpcServer::Options options;
+  options.socket_path = str.str();
+  RpcServer server(&m_ss, m_service.get(), this, options);
+  OLA_ASSERT_TRUE(server.Init());
+
+  TestClient client(&m_ss, options.socket_path);
+  OLA_ASSERT_TRUE(client.Init());
+  client.CallEcho(&ptr_data);
+#endif  // !_WIN32
+}
@@ -23,9 +23,11 @@
 #ifndef COMMON_RPC_RPCSERVICE_H_
 #define COMMON_RPC_RPCSERVICE_H_
 
+#include <stdint.h>
 #include <google/protobuf/service.h>
 #include <string>
 #include "ola/Callback.h"
+#include "ola/base/Macro.h"
 
 namespace ola {
 namespace rpc {
@@ -53,6 +55,39 @@ class RpcService {
         const google::protobuf::MethodDescriptor *method) const = 0;
     virtual const google::protobuf::Message& GetResponsePrototype(
         const google::protobuf::MethodDescriptor *method) const = 0;
+
+    // Return true if this service handles compact DMX frames. If so the
+    // RpcChannel will advertise them to the peer.
+    virtual bool SupportsDmxFrames() const { return false; }
+
+    // Called when a compact DMX frame arrives. The data is only valid for the
+    // duration of the call.
+    virtual void DmxFrameReceived(OLA_UNUSED RpcController *controller,
+                                  OLA_UNUSED unsigned int universe,
+                                  OLA_UNUSED uint8_t priority,
+                                  OLA_UNUSED const uint8_t *data,
+                                  OLA_UNUSED unsigned int length) {
+    }
+
+    // Return true if this service handles DMX deltas. This requires
+    // SupportsDmxFrames() since a delta is applied to an earlier frame.
+    virtual bool SupportsDmxDeltas() const { return false; }
+
+    // Called when a DMX delta arrives. length is the size of the complete
+    // frame, the delta is a list of ranges, see ola::dmx::DeltaEncoder. If
+    // the receiver doesn't have a frame of that size for the universe the
+    // delta should be ignored, a full frame will follow.
+    virtual void DmxDeltaReceived(OLA_UNUSED RpcController *controller,
+                                  OLA_UNUSED unsigned int universe,
+                                  OLA_UNUSED uint8_t priority,
+                                  OLA_UNUSED unsigned int length,
+                                  OLA_UNUSED const uint8_t *delta,
+                                  OLA_UNUSED unsigned int delta_size) {
+    }
+
+    // Return true if this service implements the StreamDmxBatch method. If so
+    // the RpcChannel will advertise it to the peer.
+    virtual bool SupportsDmxBatches() const { return false; }
 };
 }  // namespace rpc
 }  // namespace ola
@@ -51,7 +51,8 @@ class RpcSession {
    */
   explicit RpcSession(RpcChannel *channel)
       : m_channel(channel),
-        m_data(NULL) {
+        m_data(NULL),
+        m_local(false) {
   }
 
   /**
@@ -75,11 +76,25 @@ class RpcSession {
    */
   void *GetData() const { return m_data; }
 
+  /**
+   * @brief Mark if the client is on the same host as us.
+   * @param local true if the client connected over a local socket or the
+   *   loopback interface.
+   */
+  void SetLocal(bool local) { m_local = local; }
+
+  /**
+   * @brief Check if the client is on the same host as us.
+   * @returns true if the client is local.
+   */
+  bool IsLocal() const { return m_local; }
+
   // TODO(simon): return the RpcPeer here as well.
 
  private:
   RpcChannel *m_channel;
   void *m_data;
+  bool m_local;
 };
 }  // namespace rpc
 }  // namespace ola
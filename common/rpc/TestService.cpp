@@ -26,10 +26,14 @@
 #include "common/rpc/RpcController.h"
 #include "common/rpc/RpcSession.h"
 #include "common/rpc/TestServiceService.pb.h"
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/DeltaEncoder.h"
 #include "ola/io/SelectServer.h"
+#include "ola/network/LocalSocket.h"
 #include "ola/testing/TestUtils.h"
 #include "common/rpc/RpcChannel.h"
 
+using ola::DmxBuffer;
 using ola::NewSingleCallback;
 using ola::io::SelectServer;
 using ola::rpc::EchoReply;
@@ -38,6 +42,7 @@ using ola::rpc::RpcChannel;
 using ola::rpc::RpcController;
 using ola::rpc::STREAMING_NO_RESPONSE;
 using ola::rpc::TestService_Stub;
+using ola::network::LocalSocket;
 using ola::network::TCPSocket;
 using ola::network::GenericSocketAddress;
 using std::string;
@@ -76,6 +81,39 @@ void TestServiceImpl::Stream(RpcController* controller,
   m_ss->Terminate();
 }
 
+void TestServiceImpl::DmxFrameReceived(RpcController* controller,
+                                       unsigned int universe,
+                                       uint8_t priority,
+                                       const uint8_t *data,
+                                       unsigned int length) {
+  OLA_ASSERT_NOT_NULL(controller);
+  m_frame_count++;
+  m_frame_universe = universe;
+  m_frame_priority = priority;
+  m_frame_data.assign(reinterpret_cast<const char*>(data), length);
+  m_ss->Terminate();
+}
+
+void TestServiceImpl::DmxDeltaReceived(RpcController* controller,
+                                       unsigned int universe,
+                                       uint8_t priority,
+                                       unsigned int length,
+                                       const uint8_t *delta,
+                                       unsigned int delta_size) {
+  OLA_ASSERT_NOT_NULL(controller);
+  OLA_ASSERT_EQ(m_frame_universe, universe);
+  OLA_ASSERT_EQ(m_frame_priority, priority);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(m_frame_data.size()), length);
+
+  DmxBuffer buffer(m_frame_data);
+  ola::dmx::DeltaEncoder encoder;
+  OLA_ASSERT_TRUE(encoder.Decode(delta, delta_size, &buffer));
+  m_frame_count++;
+  m_delta_count++;
+  m_frame_data = buffer.Get();
+  m_ss->Terminate();
+}
+
 
 TestClient::TestClient(SelectServer *ss,
                        const GenericSocketAddress &server_addr)
@@ -83,12 +121,21 @@ TestClient::TestClient(SelectServer *ss,
       m_server_addr(server_addr) {
 }
 
+TestClient::TestClient(SelectServer *ss, const string &socket_path)
+    : m_ss(ss),
+      m_socket_path(socket_path) {
+}
+
 TestClient::~TestClient() {
   m_ss->RemoveReadDescriptor(m_socket.get());
 }
 
 bool TestClient::Init() {
-  m_socket.reset(TCPSocket::Connect(m_server_addr));
+  if (m_socket_path.empty()) {
+    m_socket.reset(TCPSocket::Connect(m_server_addr));
+  } else {
+    m_socket.reset(LocalSocket::Connect(m_socket_path));
+  }
   OLA_ASSERT_NOT_NULL(m_socket.get());
 
   m_channel.reset(new RpcChannel(NULL, m_socket.get()));
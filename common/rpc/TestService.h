@@ -21,17 +21,26 @@
 #ifndef COMMON_RPC_TESTSERVICE_H_
 #define COMMON_RPC_TESTSERVICE_H_
 
+#include <stdint.h>
 #include <memory>
+#include <string>
 
 #include "common/rpc/RpcController.h"
 #include "common/rpc/TestServiceService.pb.h"
+#include "ola/io/Descriptor.h"
 #include "ola/network/TCPSocket.h"
 #include "ola/io/SelectServer.h"
 #include "common/rpc/RpcChannel.h"
 
 class TestServiceImpl: public ola::rpc::TestService {
  public:
-  explicit TestServiceImpl(ola::io::SelectServer *ss) : m_ss(ss) {}
+  explicit TestServiceImpl(ola::io::SelectServer *ss)
+      : m_ss(ss),
+        m_frame_count(0),
+        m_delta_count(0),
+        m_frame_universe(0),
+        m_frame_priority(0) {
+  }
   ~TestServiceImpl() {}
 
   void Echo(ola::rpc::RpcController* controller,
@@ -48,8 +57,42 @@ class TestServiceImpl: public ola::rpc::TestService {
               const ola::rpc::EchoRequest* request,
               ola::rpc::STREAMING_NO_RESPONSE* response,
               CompletionCallback* done);
+
+  bool SupportsDmxFrames() const { return true; }
+
+  void DmxFrameReceived(ola::rpc::RpcController *controller,
+                        unsigned int universe,
+                        uint8_t priority,
+                        const uint8_t *data,
+                        unsigned int length);
+
+  bool SupportsDmxDeltas() const { return true; }
+
+  void DmxDeltaReceived(ola::rpc::RpcController *controller,
+                        unsigned int universe,
+                        uint8_t priority,
+                        unsigned int length,
+                        const uint8_t *delta,
+                        unsigned int delta_size);
+
+  // The number of DMX frames received, including deltas.
+  unsigned int FrameCount() const { return m_frame_count; }
+
+  // The number of DMX deltas received.
+  unsigned int DeltaCount() const { return m_delta_count; }
+
+  // The last DMX frame received.
+  unsigned int LastFrameUniverse() const { return m_frame_universe; }
+  uint8_t LastFramePriority() const { return m_frame_priority; }
+  const std::string &LastFrameData() const { return m_frame_data; }
+
  private:
   ola::io::SelectServer *m_ss;
+  unsigned int m_frame_count;
+  unsigned int m_delta_count;
+  unsigned int m_frame_universe;
+  uint8_t m_frame_priority;
+  std::string m_frame_data;
 };
 
 
@@ -57,6 +100,8 @@ class TestClient {
  public:
   TestClient(ola::io::SelectServer *ss,
              const ola::network::GenericSocketAddress &server_addr);
+  // Connect to a local socket rather than TCP.
+  TestClient(ola::io::SelectServer *ss, const std::string &socket_path);
   ~TestClient();
 
   bool Init();
@@ -77,7 +122,8 @@ class TestClient {
  private:
   ola::io::SelectServer *m_ss;
   const ola::network::GenericSocketAddress m_server_addr;
-  std::auto_ptr<ola::network::TCPSocket> m_socket;
+  const std::string m_socket_path;
+  std::auto_ptr<ola::io::ConnectedDescriptor> m_socket;
   std::auto_ptr<ola::rpc::TestService_Stub> m_stub;
   std::auto_ptr<ola::rpc::RpcChannel> m_channel;
 };
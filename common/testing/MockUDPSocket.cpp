@@ -52,7 +52,8 @@ MockUDPSocket::MockUDPSocket()
       m_broadcast_set(false),
       m_port(0),
       m_tos(0),
-      m_discard_mode(false) {
+      m_discard_mode(false),
+      m_failure_mode(false) {
 }
 
 
@@ -103,6 +104,9 @@ ssize_t MockUDPSocket::SendTo(const uint8_t *buffer,
                               unsigned int size,
                               const ola::network::IPV4Address &ip_address,
                               unsigned short port) const {
+  if (m_failure_mode) {
+    return -1;
+  }
   if (m_discard_mode) {
     return size;
   }
@@ -125,6 +129,10 @@ ssize_t MockUDPSocket::SendTo(const uint8_t *buffer,
 ssize_t MockUDPSocket::SendTo(IOVecInterface *data,
                               const ola::network::IPV4Address &ip_address,
                               unsigned short port) const {
+  if (m_failure_mode) {
+    return -1;
+  }
+
   // This incurs a copy but it's only testing code.
 
   int io_len;
@@ -206,6 +214,21 @@ bool MockUDPSocket::RecvFrom(
 }
 
 
+/*
+ * Drain the queued datagrams into the batch.
+ */
+unsigned int MockUDPSocket::RecvBatch(ola::network::DatagramBatch *batch) {
+  batch->Clear();
+  while (!m_received_data.empty() && !batch->Full()) {
+    ssize_t size = batch->MaxSize();
+    IPV4SocketAddress source;
+    RecvFrom(batch->Data(batch->Count()), &size, &source);
+    batch->Append(static_cast<unsigned int>(size), source);
+  }
+  return batch->Count();
+}
+
+
 bool MockUDPSocket::EnableBroadcast() {
   m_broadcast_set = true;
   return true;
@@ -32,6 +32,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include "common/dmx/HTPMerge.h"
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
@@ -44,11 +45,72 @@ using std::max;
 using std::string;
 using std::vector;
 
+/*
+ * The changes recorded when change tracking is enabled. The change that
+ * produced generation g is stored at index g % HISTORY_SIZE.
+ */
+struct DmxBuffer::ChangeHistory {
+  static const unsigned int HISTORY_SIZE = 16;
+
+  unsigned int generation;
+  unsigned int first_generation;
+  unsigned int offsets[HISTORY_SIZE];
+  unsigned int ends[HISTORY_SIZE];
+  // A copy of the data before an update that is easier to diff afterwards.
+  uint8_t previous[DMX_UNIVERSE_SIZE];
+  unsigned int previous_length;
+};
+
+namespace {
+
+/*
+ * Find the first and last slots which differ.
+ * @returns false if the data is the same.
+ */
+bool DiffRange(const uint8_t *a, const uint8_t *b, unsigned int length,
+               unsigned int *first, unsigned int *end) {
+  if (!length || !memcmp(a, b, length)) {
+    return false;
+  }
+  unsigned int i = 0;
+  while (a[i] == b[i]) {
+    i++;
+  }
+  unsigned int j = length;
+  while (a[j - 1] == b[j - 1]) {
+    j--;
+  }
+  *first = i;
+  *end = j;
+  return true;
+}
+
+/*
+ * Find the slots which changed when one frame replaced another.
+ * @returns false if nothing changed.
+ */
+bool ChangedRange(const uint8_t *old_data, unsigned int old_length,
+                  const uint8_t *new_data, unsigned int new_length,
+                  unsigned int *first, unsigned int *end) {
+  const unsigned int common_length = min(old_length, new_length);
+  bool changed = DiffRange(old_data, new_data, common_length, first, end);
+  if (old_length != new_length) {
+    if (!changed) {
+      *first = common_length;
+    }
+    *end = max(old_length, new_length);
+    changed = true;
+  }
+  return changed;
+}
+}  // namespace
+
 DmxBuffer::DmxBuffer()
     : m_ref_count(NULL),
       m_copy_on_write(false),
       m_data(NULL),
-      m_length(0) {
+      m_length(0),
+      m_changes(NULL) {
 }
 
 
@@ -56,7 +118,8 @@ DmxBuffer::DmxBuffer(const DmxBuffer &other)
     : m_ref_count(NULL),
       m_copy_on_write(false),
       m_data(NULL),
-      m_length(0) {
+      m_length(0),
+      m_changes(NULL) {
 
   if (other.m_data && other.m_ref_count) {
     CopyFromOther(other);
@@ -68,7 +131,8 @@ DmxBuffer::DmxBuffer(const uint8_t *data, unsigned int length)
     : m_ref_count(0),
       m_copy_on_write(false),
       m_data(NULL),
-      m_length(0) {
+      m_length(0),
+      m_changes(NULL) {
   Set(data, length);
 }
 
@@ -77,18 +141,23 @@ DmxBuffer::DmxBuffer(const string &data)
     : m_ref_count(0),
       m_copy_on_write(false),
       m_data(NULL),
-      m_length(0) {
+      m_length(0),
+      m_changes(NULL) {
     Set(data);
 }
 
 
 DmxBuffer::~DmxBuffer() {
   CleanupMemory();
+  delete m_changes;
 }
 
 
 DmxBuffer& DmxBuffer::operator=(const DmxBuffer &other) {
   if (this != &other) {
+    if (m_changes) {
+      RecordSet(other.m_data, other.m_data ? other.m_length : 0);
+    }
     CleanupMemory();
     if (other.m_data) {
       CopyFromOther(other);
@@ -125,6 +194,9 @@ bool DmxBuffer::HTPMerge(const DmxBuffer &other) {
       return false;
   }
   DuplicateIfNeeded();
+  if (m_changes) {
+    SaveForDiff();
+  }
 
   unsigned int other_length = min((unsigned int) DMX_UNIVERSE_SIZE,
                                   other.m_length);
@@ -139,6 +211,85 @@ bool DmxBuffer::HTPMerge(const DmxBuffer &other) {
            other_length - merge_length);
     m_length = other_length;
   }
+
+  if (m_changes) {
+    RecordDiff();
+  }
+  return true;
+}
+
+
+bool DmxBuffer::HTPMerge(const vector<const DmxBuffer*> &sources) {
+  if (!m_data) {
+    if (!Init())
+      return false;
+  }
+  DuplicateIfNeeded();
+  if (m_changes) {
+    SaveForDiff();
+  }
+
+  // Zero is the identity for HTP, so extending this buffer with zeros to the
+  // longest source gives the same result as copying the tail of that source.
+  unsigned int merged_length = m_length;
+  unsigned int common_length = (m_length ? m_length :
+                               (unsigned int) DMX_UNIVERSE_SIZE);
+  vector<const DmxBuffer*>::const_iterator iter;
+  for (iter = sources.begin(); iter != sources.end(); ++iter) {
+    if (!*iter || !(*iter)->m_length) {
+      continue;
+    }
+    unsigned int length = min((unsigned int) DMX_UNIVERSE_SIZE,
+                              (*iter)->m_length);
+    merged_length = max(merged_length, length);
+    common_length = min(common_length, length);
+  }
+  if (merged_length > m_length) {
+    memset(m_data + m_length, DMX_MIN_SLOT_VALUE, merged_length - m_length);
+    m_length = merged_length;
+  }
+  common_length = min(common_length, m_length);
+
+  // The inputs are this buffer plus up to MAX_MERGE_INPUTS - 1 sources. Since
+  // the output is also an input, large source lists are merged in groups.
+  const uint8_t *inputs[MAX_MERGE_INPUTS];
+  unsigned int input_count = 0;
+  inputs[input_count++] = m_data;
+  for (iter = sources.begin(); iter != sources.end(); ++iter) {
+    if (!*iter || !(*iter)->m_length) {
+      continue;
+    }
+    inputs[input_count++] = (*iter)->m_data;
+    if (input_count == MAX_MERGE_INPUTS) {
+      dmx::HTPMergeSlots(inputs, input_count, common_length, m_data);
+      input_count = 1;
+    }
+  }
+  if (input_count > 1) {
+    dmx::HTPMergeSlots(inputs, input_count, common_length, m_data);
+  }
+
+  // Any sources longer than the shortest one have their tail merged
+  // separately.
+  for (iter = sources.begin(); iter != sources.end(); ++iter) {
+    if (!*iter) {
+      continue;
+    }
+    unsigned int length = min((unsigned int) DMX_UNIVERSE_SIZE,
+                              (*iter)->m_length);
+    if (length > common_length) {
+      const uint8_t *tail_inputs[] = {
+        m_data + common_length,
+        (*iter)->m_data + common_length
+      };
+      dmx::HTPMergeSlots(tail_inputs, 2, length - common_length,
+                         m_data + common_length);
+    }
+  }
+
+  if (m_changes) {
+    RecordDiff();
+  }
   return true;
 }
 
@@ -147,6 +298,9 @@ bool DmxBuffer::Set(const uint8_t *data, unsigned int length) {
   if (!data)
     return false;
 
+  if (m_changes)
+    RecordSet(data, length);
+
   if (m_copy_on_write)
     CleanupMemory();
   if (!m_data) {
@@ -174,6 +328,8 @@ bool DmxBuffer::SetFromString(const string &input) {
   vector<string> dmx_values;
   vector<string>::const_iterator iter;
 
+  if (m_changes)
+    SaveForDiff();
   if (m_copy_on_write)
     CleanupMemory();
   if (!m_data)
@@ -182,6 +338,8 @@ bool DmxBuffer::SetFromString(const string &input) {
 
   if (input.empty()) {
     m_length = 0;
+    if (m_changes)
+      RecordDiff();
     return true;
   }
   StringSplit(input, &dmx_values, ",");
@@ -190,6 +348,8 @@ bool DmxBuffer::SetFromString(const string &input) {
     m_data[i] = atoi(iter->data());
   }
   m_length = i;
+  if (m_changes)
+    RecordDiff();
   return true;
 }
 
@@ -210,6 +370,11 @@ bool DmxBuffer::SetRangeToValue(unsigned int offset,
   DuplicateIfNeeded();
 
   unsigned int copy_length = min(length, DMX_UNIVERSE_SIZE - offset);
+  if (m_changes) {
+    uint8_t values[DMX_UNIVERSE_SIZE];
+    memset(values, value, copy_length);
+    RecordRange(offset, values, copy_length);
+  }
   memset(m_data + offset, value, copy_length);
   m_length = max(m_length, offset + copy_length);
   return true;
@@ -232,6 +397,8 @@ bool DmxBuffer::SetRange(unsigned int offset,
   DuplicateIfNeeded();
 
   unsigned int copy_length = min(length, DMX_UNIVERSE_SIZE - offset);
+  if (m_changes)
+    RecordRange(offset, data, copy_length);
   memcpy(m_data + offset, data, copy_length);
   m_length = max(m_length, offset + copy_length);
   return true;
@@ -253,6 +420,8 @@ void DmxBuffer::SetChannel(unsigned int channel, uint8_t data) {
   }
 
   DuplicateIfNeeded();
+  if (m_changes)
+    RecordRange(channel, &data, 1);
   m_data[channel] = data;
   m_length = max(channel+1, m_length);
 }
@@ -301,6 +470,11 @@ string DmxBuffer::Get() const {
 
 
 bool DmxBuffer::Blackout() {
+  if (m_changes) {
+    uint8_t zeros[DMX_UNIVERSE_SIZE];
+    memset(zeros, DMX_MIN_SLOT_VALUE, sizeof(zeros));
+    RecordSet(zeros, sizeof(zeros));
+  }
   if (m_copy_on_write) {
     CleanupMemory();
   }
@@ -317,6 +491,8 @@ bool DmxBuffer::Blackout() {
 
 void DmxBuffer::Reset() {
   if (m_data) {
+    if (m_changes)
+      RecordChange(0, m_length);
     m_length = 0;
   }
 }
@@ -367,7 +543,9 @@ bool DmxBuffer::DuplicateIfNeeded() {
     unsigned int length = m_length;
     m_copy_on_write = false;
     if (Init()) {
-      Set(original_data, length);
+      // This doesn't change the contents, so it's not recorded.
+      memcpy(m_data, original_data, length);
+      m_length = length;
       (*old_ref_count)--;
       return true;
     }
@@ -408,6 +586,126 @@ void DmxBuffer::CleanupMemory() {
   }
 }
 
+void DmxBuffer::EnableChangeTracking() {
+  if (!m_changes) {
+    m_changes = new ChangeHistory();
+    m_changes->generation = 1;
+    m_changes->first_generation = 1;
+    m_changes->previous_length = 0;
+  }
+}
+
+
+unsigned int DmxBuffer::Generation() const {
+  return m_changes ? m_changes->generation : 0;
+}
+
+
+bool DmxBuffer::ChangedSince(unsigned int generation, unsigned int *offset,
+                             unsigned int *length) const {
+  if (m_changes && generation == m_changes->generation) {
+    return false;
+  }
+
+  *offset = 0;
+  *length = DMX_UNIVERSE_SIZE;
+  if (!m_changes) {
+    return true;
+  }
+
+  // Unsigned arithmetic handles the generation wrapping.
+  const unsigned int age = m_changes->generation - generation;
+  if (age > ChangeHistory::HISTORY_SIZE ||
+      age > m_changes->generation - m_changes->first_generation) {
+    return true;
+  }
+
+  unsigned int first = DMX_UNIVERSE_SIZE;
+  unsigned int end = 0;
+  for (unsigned int g = generation + 1; g != m_changes->generation + 1; g++) {
+    const unsigned int index = g % ChangeHistory::HISTORY_SIZE;
+    first = min(first, m_changes->offsets[index]);
+    end = max(end, m_changes->ends[index]);
+  }
+  *offset = first;
+  *length = end - first;
+  return true;
+}
+
+
+/*
+ * Record that the slots from offset up to end changed.
+ */
+void DmxBuffer::RecordChange(unsigned int offset, unsigned int end) {
+  if (offset >= end) {
+    return;
+  }
+  m_changes->generation++;
+  const unsigned int index =
+      m_changes->generation % ChangeHistory::HISTORY_SIZE;
+  m_changes->offsets[index] = offset;
+  m_changes->ends[index] = end;
+}
+
+
+/*
+ * Record the changes made by replacing the contents with new data.
+ */
+void DmxBuffer::RecordSet(const uint8_t *data, unsigned int length) {
+  unsigned int first, end;
+  if (ChangedRange(m_data, m_data ? m_length : 0, data,
+                   min(length, (unsigned int) DMX_UNIVERSE_SIZE),
+                   &first, &end)) {
+    RecordChange(first, end);
+  }
+}
+
+
+/*
+ * Record the changes made by writing data at an offset.
+ * @pre offset <= m_length and offset + length <= DMX_UNIVERSE_SIZE
+ */
+void DmxBuffer::RecordRange(unsigned int offset, const uint8_t *data,
+                            unsigned int length) {
+  const unsigned int old_end = min(m_length, offset + length);
+  unsigned int first = old_end;
+  unsigned int end = old_end;
+  unsigned int diff_first, diff_end;
+  if (offset < old_end &&
+      DiffRange(m_data + offset, data, old_end - offset, &diff_first,
+                &diff_end)) {
+    first = offset + diff_first;
+    end = offset + diff_end;
+  }
+  if (offset + length > m_length) {
+    end = offset + length;
+  }
+  RecordChange(first, end);
+}
+
+
+/*
+ * Take a copy of the data for RecordDiff().
+ */
+void DmxBuffer::SaveForDiff() {
+  m_changes->previous_length = m_data ? m_length : 0;
+  if (m_changes->previous_length) {
+    memcpy(m_changes->previous, m_data, m_changes->previous_length);
+  }
+}
+
+
+/*
+ * Record the changes since SaveForDiff() was called.
+ */
+void DmxBuffer::RecordDiff() {
+  unsigned int first, end;
+  if (ChangedRange(m_changes->previous, m_changes->previous_length, m_data,
+                   m_data ? m_length : 0, &first, &end)) {
+    RecordChange(first, end);
+  }
+}
+
 std::ostream& operator<<(std::ostream &out, const DmxBuffer &data) {
   return out << data.ToString();
 }
@@ -21,6 +21,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <string.h>
 #include <string>
+#include <vector>
 
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
@@ -28,6 +29,7 @@
 
 using std::ostringstream;
 using std::string;
+using std::vector;
 using ola::DmxBuffer;
 
 class DmxBufferTest: public CppUnit::TestFixture {
@@ -39,12 +41,14 @@ class DmxBufferTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testCopy);
   CPPUNIT_TEST(testAdditiveChecksum);
   CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testMultiMerge);
   CPPUNIT_TEST(testStringToDmx);
   CPPUNIT_TEST(testCopyOnWrite);
   CPPUNIT_TEST(testSetRange);
   CPPUNIT_TEST(testSetRangeToValue);
   CPPUNIT_TEST(testSetChannel);
   CPPUNIT_TEST(testToString);
+  CPPUNIT_TEST(testChangeTracking);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -55,12 +59,14 @@ class DmxBufferTest: public CppUnit::TestFixture {
     void testCopy();
     void testAdditiveChecksum();
     void testMerge();
+    void testMultiMerge();
     void testStringToDmx();
     void testCopyOnWrite();
     void testSetRange();
     void testSetRangeToValue();
     void testSetChannel();
     void testToString();
+    void testChangeTracking();
 
  private:
     static const uint8_t TEST_DATA[];
@@ -310,6 +316,69 @@ void DmxBufferTest::testMerge() {
 }
 
 
+/*
+ * Check that merging many buffers in one pass matches merging one at a time.
+ */
+void DmxBufferTest::testMultiMerge() {
+  DmxBuffer buffer1(TEST_DATA, sizeof(TEST_DATA));
+  DmxBuffer buffer2(TEST_DATA2, sizeof(TEST_DATA2));
+  DmxBuffer buffer3(TEST_DATA3, sizeof(TEST_DATA3));
+  DmxBuffer empty_buffer;
+  DmxBuffer merge_result2(MERGE_RESULT2, sizeof(MERGE_RESULT2));
+
+  // no sources leaves the buffer untouched
+  DmxBuffer result(buffer1);
+  vector<const DmxBuffer*> sources;
+  OLA_ASSERT_TRUE(result.HTPMerge(sources));
+  OLA_ASSERT_DMX_EQUALS(buffer1, result);
+
+  // sources of different lengths, including empty & NULL ones
+  sources.push_back(&buffer1);
+  sources.push_back(&empty_buffer);
+  sources.push_back(&buffer2);
+  sources.push_back(NULL);
+  sources.push_back(&buffer3);
+
+  DmxBuffer uninitialized_buffer;
+  OLA_ASSERT_TRUE(uninitialized_buffer.HTPMerge(sources));
+  OLA_ASSERT_DMX_EQUALS(merge_result2, uninitialized_buffer);
+
+  // Reset() then merge is what the Universe does
+  result.Reset();
+  OLA_ASSERT_TRUE(result.HTPMerge(sources));
+  OLA_ASSERT_DMX_EQUALS(merge_result2, result);
+
+  // the existing data takes part in the merge
+  result = buffer3;
+  sources.clear();
+  sources.push_back(&buffer1);
+  OLA_ASSERT_TRUE(result.HTPMerge(sources));
+  OLA_ASSERT_DMX_EQUALS(DmxBuffer(MERGE_RESULT, sizeof(MERGE_RESULT)),
+                        result);
+  // and the copy-on-write source wasn't modified
+  OLA_ASSERT_DMX_EQUALS(DmxBuffer(TEST_DATA3, sizeof(TEST_DATA3)), buffer3);
+
+  // more sources than fit in a single kernel pass, compare against merging
+  // one at a time
+  vector<DmxBuffer> many_buffers(40);
+  sources.clear();
+  DmxBuffer expected;
+  for (unsigned int i = 0; i < many_buffers.size(); i++) {
+    uint8_t data[ola::DMX_UNIVERSE_SIZE];
+    unsigned int length = ola::DMX_UNIVERSE_SIZE - (i % 3) * 100;
+    for (unsigned int j = 0; j < length; j++) {
+      data[j] = static_cast<uint8_t>((i * 37 + j * 11) ^ i);
+    }
+    many_buffers[i].Set(data, length);
+    sources.push_back(&many_buffers[i]);
+    expected.HTPMerge(many_buffers[i]);
+  }
+  result.Reset();
+  OLA_ASSERT_TRUE(result.HTPMerge(sources));
+  OLA_ASSERT_DMX_EQUALS(expected, result);
+}
+
+
 /*
  * Run the StringToDmxTest
  * @param input the string to parse
@@ -548,3 +617,115 @@ void DmxBufferTest::testToString() {
   str << buffer;
   OLA_ASSERT_EQ(string("1,2,3,4"), str.str());
 }
+
+
+/*
+ * Check that changes are recorded once tracking is enabled.
+ */
+void DmxBufferTest::testChangeTracking() {
+  unsigned int offset, length;
+  DmxBuffer buffer;
+  OLA_ASSERT_FALSE(buffer.ChangeTrackingEnabled());
+  OLA_ASSERT_EQ(0u, buffer.Generation());
+
+  // Without tracking everything has changed.
+  OLA_ASSERT_TRUE(buffer.ChangedSince(0, &offset, &length));
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(ola::DMX_UNIVERSE_SIZE), length);
+
+  buffer.EnableChangeTracking();
+  OLA_ASSERT_TRUE(buffer.ChangeTrackingEnabled());
+  unsigned int generation = buffer.Generation();
+  OLA_ASSERT_FALSE(buffer.ChangedSince(generation, &offset, &length));
+
+  // Set the initial data
+  buffer.Set(TEST_DATA2, sizeof(TEST_DATA2));
+  OLA_ASSERT_TRUE(buffer.ChangedSince(generation, &offset, &length));
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(sizeof(TEST_DATA2)), length);
+  generation = buffer.Generation();
+
+  // Setting the same data isn't a change
+  buffer.Set(TEST_DATA2, sizeof(TEST_DATA2));
+  OLA_ASSERT_EQ(generation, buffer.Generation());
+  buffer.SetChannel(2, 7);
+  buffer.SetRange(3, TEST_DATA2 + 3, 4);
+  OLA_ASSERT_EQ(generation, buffer.Generation());
+
+  // Individual changes
+  buffer.SetChannel(2, 100);
+  OLA_ASSERT_TRUE(buffer.ChangedSince(generation, &offset, &length));
+  OLA_ASSERT_EQ(2u, offset);
+  OLA_ASSERT_EQ(1u, length);
+
+  const uint8_t range[] = {5, 0, 0, 2};
+  buffer.SetRange(4, range, sizeof(range));
+  OLA_ASSERT_TRUE(buffer.ChangedSince(generation, &offset, &length));
+  OLA_ASSERT_EQ(2u, offset);
+  OLA_ASSERT_EQ(5u, length);
+
+  unsigned int generation2 = buffer.Generation();
+  OLA_ASSERT_FALSE(buffer.ChangedSince(generation2, &offset, &length));
+
+  // Growing the buffer
+  buffer.SetRangeToValue(9, 1, 2);
+  OLA_ASSERT_TRUE(buffer.ChangedSince(generation2, &offset, &length));
+  OLA_ASSERT_EQ(9u, offset);
+  OLA_ASSERT_EQ(2u, length);
+
+  // Shrinking it, the range covers the old slots
+  generation2 = buffer.Generation();
+  buffer.Set(TEST_DATA, sizeof(TEST_DATA));
+  OLA_ASSERT_TRUE(buffer.ChangedSince(generation2, &offset, &length));
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ(11u, length);
+
+  // Merges
+  generation2 = buffer.Generation();
+  DmxBuffer other(TEST_DATA, sizeof(TEST_DATA));
+  buffer.HTPMerge(other);
+  OLA_ASSERT_FALSE(buffer.ChangedSince(generation2, &offset, &length));
+  other.SetChannel(3, 200);
+  buffer.HTPMerge(other);
+  OLA_ASSERT_TRUE(buffer.ChangedSince(generation2, &offset, &length));
+  OLA_ASSERT_EQ(3u, offset);
+  OLA_ASSERT_EQ(1u, length);
+
+  // Assignment & copy on write. Copies don't track changes.
+  generation2 = buffer.Generation();
+  DmxBuffer copy(buffer);
+  OLA_ASSERT_FALSE(copy.ChangeTrackingEnabled());
+  buffer.SetChannel(0, 1);
+  OLA_ASSERT_FALSE(buffer.ChangedSince(generation2, &offset, &length));
+  buffer = other;
+  OLA_ASSERT_FALSE(buffer.ChangedSince(generation2, &offset, &length));
+  buffer = DmxBuffer(TEST_DATA2, sizeof(TEST_DATA2));
+  OLA_ASSERT_TRUE(buffer.ChangedSince(generation2, &offset, &length));
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(sizeof(TEST_DATA2)), length);
+
+  // Blackout & Reset
+  generation2 = buffer.Generation();
+  buffer.Blackout();
+  OLA_ASSERT_TRUE(buffer.ChangedSince(generation2, &offset, &length));
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(ola::DMX_UNIVERSE_SIZE), length);
+  generation2 = buffer.Generation();
+  buffer.Blackout();
+  OLA_ASSERT_FALSE(buffer.ChangedSince(generation2, &offset, &length));
+  buffer.Reset();
+  OLA_ASSERT_TRUE(buffer.ChangedSince(generation2, &offset, &length));
+
+  // Once the history is exhausted, everything has changed.
+  generation2 = buffer.Generation();
+  for (unsigned int i = 0; i < 20; i++) {
+    buffer.SetChannel(0, i + 1);
+  }
+  OLA_ASSERT_TRUE(buffer.ChangedSince(generation2, &offset, &length));
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(ola::DMX_UNIVERSE_SIZE), length);
+
+  // The original generation is older than the history as well.
+  OLA_ASSERT_TRUE(buffer.ChangedSince(generation, &offset, &length));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(ola::DMX_UNIVERSE_SIZE), length);
+}
@@ -8,6 +8,13 @@ common_libolacommon_la_SOURCES += \
     common/utils/TokenBucket.cpp \
     common/utils/Watchdog.cpp
 
+# PROGRAMS
+################################################
+noinst_PROGRAMS += common/utils/dmx_buffer_benchmark
+common_utils_dmx_buffer_benchmark_SOURCES = \
+    common/utils/dmx_buffer_benchmark.cpp
+common_utils_dmx_buffer_benchmark_LDADD = common/libolacommon.la
+
 # TESTS
 ################################################
 test_programs += common/utils/UtilsTester
@@ -0,0 +1,132 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * dmx_buffer_benchmark.cpp
+ * Measure the cost of change tracking in the DmxBuffer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(iterations, i, 200000, "The number of updates to run");
+DEFINE_s_uint16(changed_slots, c, 8,
+                "The number of slots that change in each frame");
+
+/**
+ * Print the result of a run.
+ */
+void PrintResult(const string &name, bool tracking,
+                 const TimeInterval &duration) {
+  double total_usec = static_cast<double>(duration.AsInt());
+  double ns_per_update = total_usec * 1000.0 / FLAGS_iterations;
+  cout << std::left << std::setw(16) << name << std::setw(10)
+       << (tracking ? "tracked" : "untracked") << std::right << std::fixed
+       << std::setprecision(1) << std::setw(10) << ns_per_update
+       << " ns/update" << endl;
+}
+
+/**
+ * Run each of the update types against a buffer.
+ */
+void RunUpdates(bool tracking) {
+  const unsigned int changed_slots = FLAGS_changed_slots;
+
+  // Two frames that differ in changed_slots slots.
+  vector<DmxBuffer> frames(2);
+  for (unsigned int i = 0; i < frames.size(); i++) {
+    uint8_t data[ola::DMX_UNIVERSE_SIZE];
+    for (unsigned int j = 0; j < ola::DMX_UNIVERSE_SIZE; j++) {
+      data[j] = static_cast<uint8_t>(j * 7);
+      if (i && j % (ola::DMX_UNIVERSE_SIZE / changed_slots) == 0) {
+        data[j]++;
+      }
+    }
+    frames[i].Set(data, sizeof(data));
+  }
+  vector<const DmxBuffer*> sources;
+  sources.push_back(&frames[0]);
+  sources.push_back(&frames[1]);
+
+  Clock clock;
+  TimeStamp start, end;
+  DmxBuffer output;
+  if (tracking) {
+    output.EnableChangeTracking();
+  }
+
+  clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    output.Set(frames[i % 2]);
+  }
+  clock.CurrentMonotonicTime(&end);
+  PrintResult("Set", tracking, end - start);
+
+  clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    output.Set(frames[0]);
+  }
+  clock.CurrentMonotonicTime(&end);
+  PrintResult("Set unchanged", tracking, end - start);
+
+  clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    output.SetChannel(i % ola::DMX_UNIVERSE_SIZE, static_cast<uint8_t>(i));
+  }
+  clock.CurrentMonotonicTime(&end);
+  PrintResult("SetChannel", tracking, end - start);
+
+  clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    output.Set(frames[i % 2]);
+    output.HTPMerge(sources);
+  }
+  clock.CurrentMonotonicTime(&end);
+  PrintResult("Set + HTPMerge", tracking, end - start);
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Benchmark the cost of DmxBuffer change tracking.");
+
+  if (FLAGS_iterations == 0 || FLAGS_changed_slots == 0 ||
+      FLAGS_changed_slots > ola::DMX_UNIVERSE_SIZE) {
+    return -1;
+  }
+
+  cout << FLAGS_iterations << " updates, " << FLAGS_changed_slots
+       << " changed slots per frame" << endl;
+  RunUpdates(false);
+  RunUpdates(true);
+  return 0;
+}
@@ -5,7 +5,7 @@ EXTRA_DIST += \
     debian/copyright \
     debian/libola-dev.dirs \
     debian/libola-dev.install \
-    debian/libola1.install \
+    debian/libola2.install \
     debian/ola-python.dirs \
     debian/ola-python.install \
     debian/ola-rdm-tests.bash-completion \
@@ -44,6 +44,9 @@ DEFINE_s_uint32(universe, u, 1, "The universe to receive data for");
 DEFINE_default_bool(send_dmx, false, "Use SendDmx messages, default is GetDmx");
 DEFINE_s_uint32(count, c, 0,
     "Exit after this many RPCs, default: infinite (0)");
+DEFINE_string(socket, "",
+              "Connect to olad using the local socket at this path, rather "
+              "than TCP");
 
 class Tracker {
  public:
@@ -75,6 +78,7 @@ class Tracker {
 };
 
 bool Tracker::Setup() {
+  m_wrapper.SetServerSocket(FLAGS_socket.str());
   return m_wrapper.Setup();
 }
 
@@ -95,7 +99,8 @@ void Tracker::Start() {
   // It also means you can just see the stats and not each individual request
   // if you want.
   cout << "--------------" << endl;
-  cout << "Sent " << m_count << " RPCs" << endl;
+  cout << "Sent " << m_count << " RPCs over "
+       << (FLAGS_socket.str().empty() ? "TCP" : "the local socket") << endl;
   cout << "Max was " << m_max.MicroSeconds() << " microseconds" << endl;
   cout << "Mean " << m_sum / m_count << " microseconds" << endl;
 }
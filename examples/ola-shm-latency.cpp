@@ -0,0 +1,210 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ola-shm-latency.cpp
+ * Send DMX to a universe we're registered for, and track how long it takes
+ * for the data to come back, either over the socket or shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/DmxBuffer.h>
+#include <ola/Logging.h>
+#include <ola/base/Flags.h>
+#include <ola/base/Init.h>
+#include <ola/client/ClientWrapper.h>
+#include <ola/client/OlaClient.h>
+#include <ola/thread/SignalThread.h>
+
+#include <iostream>
+#include <string>
+
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::client::DMXMetadata;
+using ola::client::OlaClientWrapper;
+using ola::client::Result;
+using std::cout;
+using std::endl;
+using std::string;
+
+DEFINE_s_uint32(universe, u, 1, "The universe to send and receive on");
+DEFINE_default_bool(shared_memory, false,
+                    "Use shared memory rather than the socket");
+DEFINE_s_uint32(count, c, 10000, "Exit after this many frames");
+
+class Tracker {
+ public:
+    Tracker()
+        : m_sequence(0),
+          m_count(0),
+          m_sum(0) {
+      m_buffer.Blackout();
+    }
+
+    bool Setup();
+    void Start();
+
+ private:
+    uint32_t m_sequence;
+    uint32_t m_count;
+    uint64_t m_sum;
+    TimeInterval m_max;
+    TimeInterval m_min;
+    DmxBuffer m_buffer;
+    OlaClientWrapper m_wrapper;
+    ola::Clock m_clock;
+    ola::thread::SignalThread m_signal_thread;
+    TimeStamp m_send_time;
+
+    void Registered(const Result &result);
+    void SharedMemoryReady(const Result &result);
+    void NewDmx(const DMXMetadata &metadata, const DmxBuffer &data);
+    void SendFrame();
+    void StartSignalThread();
+};
+
+bool Tracker::Setup() {
+  if (!m_wrapper.Setup()) {
+    return false;
+  }
+  m_wrapper.GetClient()->SetDMXCallback(NewCallback(this, &Tracker::NewDmx));
+  return true;
+}
+
+void Tracker::Start() {
+  ola::io::SelectServer *ss = m_wrapper.GetSelectServer();
+  m_signal_thread.InstallSignalHandler(
+      SIGINT,
+      ola::NewCallback(ss, &ola::io::SelectServer::Terminate));
+  m_signal_thread.InstallSignalHandler(
+      SIGTERM,
+      ola::NewCallback(ss, &ola::io::SelectServer::Terminate));
+
+  m_wrapper.GetClient()->RegisterUniverse(
+      FLAGS_universe, ola::client::REGISTER,
+      NewSingleCallback(this, &Tracker::Registered));
+
+  ss->Execute(ola::NewSingleCallback(this, &Tracker::StartSignalThread));
+  ss->Run();
+
+  if (!m_count) {
+    return;
+  }
+  cout << "--------------" << endl;
+  cout << "Sent " << m_count << " frames using "
+       << (FLAGS_shared_memory ? "shared memory" : "the socket") << endl;
+  cout << "Min was " << m_min.MicroSeconds() << " microseconds" << endl;
+  cout << "Max was " << m_max.MicroSeconds() << " microseconds" << endl;
+  cout << "Mean " << m_sum / m_count << " microseconds" << endl;
+}
+
+void Tracker::Registered(const Result &result) {
+  if (!result.Success()) {
+    OLA_FATAL << "Failed to register universe: " << result.Error();
+    m_wrapper.GetSelectServer()->Terminate();
+    return;
+  }
+
+  if (FLAGS_shared_memory) {
+    m_wrapper.GetClient()->SetupSharedMemory(
+        1, NewSingleCallback(this, &Tracker::SharedMemoryReady));
+  } else {
+    SendFrame();
+  }
+}
+
+void Tracker::SharedMemoryReady(const Result &result) {
+  if (!result.Success()) {
+    OLA_FATAL << "Failed to set up shared memory: " << result.Error();
+    m_wrapper.GetSelectServer()->Terminate();
+    return;
+  }
+  SendFrame();
+}
+
+/*
+ * Once we get back the frame we sent, record the time and send the next one.
+ * Anything else is an older frame, or from another source.
+ */
+void Tracker::NewDmx(const DMXMetadata &metadata, const DmxBuffer &data) {
+  if (metadata.universe != FLAGS_universe || data.Size() < 4) {
+    return;
+  }
+
+  uint32_t sequence = (static_cast<uint32_t>(data.Get(0)) << 24) |
+                      (data.Get(1) << 16) | (data.Get(2) << 8) | data.Get(3);
+  if (sequence != m_sequence) {
+    return;
+  }
+
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  TimeInterval delta = now - m_send_time;
+  if (delta > m_max) {
+    m_max = delta;
+  }
+  if (!m_count || delta < m_min) {
+    m_min = delta;
+  }
+  m_sum += delta.MicroSeconds();
+
+  OLA_INFO << "Frame took " << delta;
+  if (FLAGS_count == ++m_count) {
+    m_wrapper.GetSelectServer()->Terminate();
+  } else {
+    SendFrame();
+  }
+}
+
+void Tracker::SendFrame() {
+  m_sequence++;
+  m_buffer.SetChannel(0, m_sequence >> 24);
+  m_buffer.SetChannel(1, m_sequence >> 16);
+  m_buffer.SetChannel(2, m_sequence >> 8);
+  m_buffer.SetChannel(3, m_sequence);
+
+  m_clock.CurrentMonotonicTime(&m_send_time);
+  m_wrapper.GetClient()->SendDMX(FLAGS_universe, m_buffer,
+                                 ola::client::SendDMXArgs());
+}
+
+void Tracker::StartSignalThread() {
+  if (!m_signal_thread.Start()) {
+    m_wrapper.GetSelectServer()->Terminate();
+  }
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(
+      &argc, argv, "[options]",
+      "Measure the time taken for DMX data sent to olad to be returned, over "
+      "the socket or shared memory.");
+
+  Tracker tracker;
+  if (!tracker.Setup()) {
+    OLA_FATAL << "Setup failed";
+    exit(1);
+  }
+
+  tracker.Start();
+  return 0;
+}
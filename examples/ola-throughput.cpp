@@ -19,14 +19,17 @@
  */
 
 #include <errno.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <ola/base/Flags.h>
 #include <ola/base/Init.h>
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/StreamingClient.h>
 #include <ola/StringUtils.h>
+#include <ola/client/ClientTypes.h>
 
 #include <iostream>
 #include <string>
@@ -35,9 +38,23 @@ using std::cout;
 using std::endl;
 using std::string;
 using ola::StreamingClient;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::client::DmxBatch;
+using ola::client::DmxBatchEntry;
 
-DEFINE_s_uint32(universe, u, 1, "The universe to send data on");
+DEFINE_s_uint32(universe, u, 1, "The first universe to send data on");
+DEFINE_s_uint32(universes, n, 1, "The number of universes to send data on");
 DEFINE_s_uint32(sleep, s, 40000, "Time between DMX updates in micro-seconds");
+DEFINE_s_default_bool(batch, b, false,
+                      "Send all universes in a single batch message");
+DEFINE_default_bool(deltas, false,
+                    "Only send the slots that changed, if olad supports it");
+DEFINE_s_default_bool(report, r, false,
+                      "Print the number of universes sent per second");
+DEFINE_string(socket, "",
+              "Connect to olad using the local socket at this path, rather "
+              "than TCP");
 
 /*
  * Main
@@ -45,7 +62,10 @@ DEFINE_s_uint32(sleep, s, 40000, "Time between DMX updates in micro-seconds");
 int main(int argc, char *argv[]) {
   ola::AppInit(&argc, argv, "[options]", "Send DMX512 data to OLA.");
 
-  StreamingClient ola_client;
+  StreamingClient::Options options;
+  options.server_socket = FLAGS_socket.str();
+  options.use_delta_frames = FLAGS_deltas;
+  StreamingClient ola_client(options);
   if (!ola_client.Setup()) {
     OLA_FATAL << "Setup failed";
     exit(1);
@@ -54,12 +74,48 @@ int main(int argc, char *argv[]) {
   ola::DmxBuffer buffer;
   buffer.Blackout();
 
+  DmxBatch batch;
+  for (unsigned int i = 0; i < FLAGS_universes; i++) {
+    batch.push_back(DmxBatchEntry(FLAGS_universe + i, buffer));
+  }
+
+  ola::Clock clock;
+  TimeStamp last_report;
+  clock.CurrentMonotonicTime(&last_report);
+  uint64_t universes_sent = 0;
+
   while (1) {
-    usleep(FLAGS_sleep);
-    if (!ola_client.SendDmx(FLAGS_universe, buffer)) {
+    if (FLAGS_sleep) {
+      usleep(FLAGS_sleep);
+    }
+
+    bool ok = true;
+    if (FLAGS_batch) {
+      ok = ola_client.SendDmxBatch(batch);
+    } else {
+      DmxBatch::const_iterator iter = batch.begin();
+      for (; ok && iter != batch.end(); ++iter) {
+        ok = ola_client.SendDmx(iter->universe, iter->data);
+      }
+    }
+
+    if (!ok) {
       cout << "Send DMX failed" << endl;
       exit(1);
     }
+    universes_sent += batch.size();
+
+    if (FLAGS_report) {
+      TimeStamp now;
+      clock.CurrentMonotonicTime(&now);
+      TimeInterval elapsed = now - last_report;
+      if (elapsed.Seconds() >= 1) {
+        cout << universes_sent * ola::USEC_IN_SECONDS / elapsed.AsInt()
+             << " universes/s" << endl;
+        universes_sent = 0;
+        last_report = now;
+      }
+    }
   }
   return 0;
 }
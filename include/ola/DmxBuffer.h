@@ -29,6 +29,7 @@
 #include <stdint.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 
 namespace ola {
@@ -123,6 +124,18 @@ class DmxBuffer {
      */
     bool HTPMerge(const DmxBuffer &other);
 
+    /**
+     * @brief HTP Merge from a number of DmxBuffers in a single pass.
+     * @param sources the DmxBuffers to HTP merge into this one. NULL entries
+     * are skipped.
+     * @return false if the merge failed, and true if merge was successful
+     *
+     * This gives the same result as calling HTPMerge(const DmxBuffer&) for
+     * each source, but only walks the slots once, using a SIMD kernel if the
+     * CPU supports one. Call Reset() first to merge just the sources.
+     */
+    bool HTPMerge(const std::vector<const DmxBuffer*> &sources);
+
     /**
      * @brief Set the contents of this DmxBuffer
      * @param data is a pointer to an array of uint8_t values
@@ -270,7 +283,49 @@ class DmxBuffer {
      */
     std::string ToString() const;
 
+    /**
+     * @brief Start recording which slots change.
+     *
+     * Once enabled, each call that changes the contents or size of the buffer
+     * increments Generation() and records the range of slots that changed.
+     * Calls which leave the contents as they were don't. Tracking belongs to
+     * this object, copies of the buffer don't track changes.
+     *
+     * Tracking compares the new data with the old, so it adds a little work
+     * to each update. It's intended for buffers which are updated in place,
+     * so that consumers can skip or limit work when little has changed.
+     */
+    void EnableChangeTracking();
+
+    /**
+     * @brief Check if change tracking is enabled.
+     */
+    bool ChangeTrackingEnabled() const { return m_changes != NULL; }
+
+    /**
+     * @brief The generation of the data in the buffer.
+     * @return a number which changes each time the contents change, or 0 if
+     * change tracking isn't enabled.
+     */
+    unsigned int Generation() const;
+
+    /**
+     * @brief Get the slots which changed after a generation.
+     * @param generation a value previously returned by Generation().
+     * @param[out] offset the first slot which changed.
+     * @param[out] length the number of slots from offset which may have
+     *   changed. If the buffer shrank, this can extend past Size().
+     * @return false if nothing has changed, true otherwise.
+     *
+     * If change tracking isn't enabled, or the generation is too old for the
+     * changes to have been recorded, the entire buffer is reported as changed.
+     */
+    bool ChangedSince(unsigned int generation, unsigned int *offset,
+                      unsigned int *length) const;
+
  private:
+    struct ChangeHistory;
+
     bool Init();
     bool DuplicateIfNeeded();
     void CopyFromOther(const DmxBuffer &other);
@@ -279,6 +334,16 @@ class DmxBuffer {
     mutable bool m_copy_on_write;
     uint8_t *m_data;
     unsigned int m_length;
+    ChangeHistory *m_changes;
+
+    void RecordChange(unsigned int offset, unsigned int end);
+    void RecordSet(const uint8_t *data, unsigned int length);
+    void RecordRange(unsigned int offset, const uint8_t *data,
+                     unsigned int length);
+    void SaveForDiff();
+    void RecordDiff();
+
+    static const unsigned int MAX_MERGE_INPUTS = 16;
 };
 
 /**
@@ -32,6 +32,7 @@
 
 #include <ola/base/Macro.h>
 #include <ola/StringUtils.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include <functional>
@@ -171,7 +172,8 @@ class IntegerVariable: public BaseVariable {
 
 
 /*
- * Represents a counter which can only be added to.
+ * Represents a counter which can only be added to. The counter can be updated
+ * from any thread.
  */
 class CounterVariable: public BaseVariable {
  public:
@@ -180,13 +182,13 @@ class CounterVariable: public BaseVariable {
         m_value(0) {}
   ~CounterVariable() {}
 
-  void operator++(int) { m_value++; }
-  void operator+=(unsigned int value) { m_value += value; }
-  void Reset() { m_value = 0; }
-  unsigned int Get() const { return m_value; }
+  void operator++(int);
+  void operator+=(unsigned int value);
+  void Reset();
+  unsigned int Get() const;
   const std::string Value() const {
     std::ostringstream out;
-    out << m_value;
+    out << Get();
     return out.str();
   }
 
@@ -195,6 +197,144 @@ class CounterVariable: public BaseVariable {
 };
 
 
+/**
+ * @brief A histogram of unsigned values, typically latencies in microseconds.
+ *
+ * Values are counted in log-linear buckets: each power of two is split into
+ * eight buckets, so a reported percentile is within 12.5% of the true value.
+ * Values larger than 2^32 - 1 are counted as 2^32 - 1.
+ *
+ * Record() doesn't take a lock, so it can be called from any thread. A reader
+ * running at the same time may see a total count that is slightly out of step
+ * with the buckets.
+ */
+class HistogramVariable: public BaseVariable {
+ public:
+  /**
+   * @brief Create a new HistogramVariable.
+   * @param name the variable name.
+   */
+  explicit HistogramVariable(const std::string &name);
+  ~HistogramVariable() {}
+
+  /**
+   * @brief Add a sample to the histogram.
+   * @param value the value to record.
+   */
+  void Record(uint64_t value);
+
+  /**
+   * @brief Remove all samples.
+   */
+  void Reset();
+
+  /**
+   * @brief The number of samples recorded.
+   */
+  unsigned int Count() const;
+
+  /**
+   * @brief The largest sample recorded.
+   */
+  unsigned int Max() const;
+
+  /**
+   * @brief Estimate a percentile.
+   * @param percentile the percentile to return, between 0 and 100.
+   * @returns the upper bound of the bucket containing the percentile, or 0 if
+   *   there are no samples.
+   */
+  unsigned int Percentile(double percentile) const;
+
+  /**
+   * @brief Return the count, p50, p99, p999 and max values as a string.
+   */
+  const std::string Value() const;
+
+ private:
+  static const unsigned int SUB_BUCKET_BITS = 3;
+  static const unsigned int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static const unsigned int BUCKET_COUNT = SUB_BUCKETS * (33 - SUB_BUCKET_BITS);
+
+  unsigned int m_buckets[BUCKET_COUNT];
+  unsigned int m_count;
+  unsigned int m_max;
+
+  static unsigned int BucketIndex(unsigned int value);
+  static unsigned int BucketUpperBound(unsigned int index);
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramVariable);
+};
+
+
+/**
+ * @brief A handle to a single entry in a MapVariable.
+ *
+ * Updating a map entry by name costs a lookup on the variable name in the
+ * ExportMap and another on the key. A handle does the lookups once, so code
+ * that updates a variable on every frame can just increment the value.
+ *
+ * A default constructed handle doesn't refer to anything, and updates are
+ * ignored. This means callers don't need to check for a NULL ExportMap.
+ *
+ * Updates through a handle are atomic, so an output thread can update an
+ * entry while the SelectServer thread updates another one. Creating and
+ * removing keys still has to happen on a single thread.
+ *
+ * The handle is only valid until the key is removed from the map.
+ */
+namespace internal {
+/*
+ * Relaxed atomic access to the map entries, used by MapVariableHandle. These
+ * fall back to plain operations if the compiler doesn't have atomic builtins.
+ */
+void RelaxedAdd(int *value, int delta);
+void RelaxedAdd(unsigned int *value, int delta);
+int RelaxedLoad(const int *value);
+unsigned int RelaxedLoad(const unsigned int *value);
+void RelaxedStore(int *value, int new_value);
+void RelaxedStore(unsigned int *value, unsigned int new_value);
+}  // namespace internal
+
+template<typename Type>
+class MapVariableHandle {
+ public:
+  MapVariableHandle() : m_value(NULL) {}
+  explicit MapVariableHandle(Type *value) : m_value(value) {}
+
+  /**
+   * @brief Check if the handle refers to a map entry.
+   */
+  bool IsValid() const { return m_value != NULL; }
+
+  void Increment() {
+    if (m_value)
+      internal::RelaxedAdd(m_value, 1);
+  }
+
+  void Decrement() {
+    if (m_value)
+      internal::RelaxedAdd(m_value, -1);
+  }
+
+  void Set(Type value) {
+    if (m_value)
+      internal::RelaxedStore(m_value, value);
+  }
+
+  /**
+   * @brief Return the value of the entry, or the default value if the handle
+   * is invalid.
+   */
+  Type Get() const {
+    return m_value ? internal::RelaxedLoad(m_value) : Type();
+  }
+
+ private:
+  Type *m_value;
+};
+
+
 /*
  * A Map variable holds string -> type mappings
  */
@@ -209,6 +349,7 @@ class MapVariable: public BaseVariable {
   void Remove(const std::string &key);
   void Set(const std::string &key, Type value);
   Type &operator[](const std::string &key);
+  MapVariableHandle<Type> GetHandle(const std::string &key);
   const std::string Value() const;
   const std::string Label() const { return m_label; }
 
@@ -220,6 +361,8 @@ class MapVariable: public BaseVariable {
 };
 
 typedef MapVariable<std::string> StringMap;
+typedef MapVariableHandle<int> IntMapHandle;
+typedef MapVariableHandle<unsigned int> UIntMapHandle;
 
 
 /**
@@ -260,6 +403,18 @@ Type &MapVariable<Type>::operator[](const std::string &key) {
 }
 
 
+/**
+ * Return a handle to an entry in the Map Variable, this will create the entry
+ * if it doesn't exist.
+ * @param key the key of the entry.
+ * @returns a handle which remains valid until the key is removed.
+ */
+template<typename Type>
+MapVariableHandle<Type> MapVariable<Type>::GetHandle(const std::string &key) {
+  return MapVariableHandle<Type>(&m_variables[key]);
+}
+
+
 /*
  * Set a value in the Map variable.
  */
@@ -366,6 +521,25 @@ class ExportMap {
    */
   StringVariable *GetStringVar(const std::string &name);
 
+  /**
+   * @brief Lookup or create a HistogramVariable.
+   * @param name the name of this variable.
+   * @return a HistogramVariable.
+   *
+   * The variable is created if it doesn't already exist. The pointer is
+   * valid until the variable is removed with RemoveHistogramVar(), or for the
+   * lifetime of the ExportMap.
+   */
+  HistogramVariable *GetHistogramVar(const std::string &name);
+
+  /**
+   * @brief Remove a HistogramVariable.
+   * @param name the name of the variable to remove.
+   *
+   * Any pointers to the variable are invalid once this returns.
+   */
+  void RemoveHistogramVar(const std::string &name);
+
   StringMap *GetStringMapVar(const std::string &name,
                              const std::string &label = "");
   IntMap *GetIntMapVar(const std::string &name, const std::string &label = "");
@@ -378,6 +552,12 @@ class ExportMap {
    */
   std::vector<BaseVariable*> AllVariables() const;
 
+  /**
+   * @brief Fetch a list of the histogram variables.
+   * @returns a vector of the HistogramVariables, sorted by name.
+   */
+  std::vector<HistogramVariable*> AllHistograms() const;
+
  private :
   template<typename Type>
   Type *GetVar(std::map<std::string, Type*> *var_map,
@@ -390,6 +570,7 @@ class ExportMap {
 
   std::map<std::string, BoolVariable*> m_bool_variables;
   std::map<std::string, CounterVariable*> m_counter_variables;
+  std::map<std::string, HistogramVariable*> m_histogram_variables;
   std::map<std::string, IntegerVariable*> m_int_variables;
   std::map<std::string, StringVariable*> m_string_variables;
 
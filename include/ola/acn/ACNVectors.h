@@ -48,6 +48,7 @@ enum RootVector {
   VECTOR_ROOT_E131 = 0x00000004,  /**< E1.31 (sACN) */
   VECTOR_ROOT_RPT = 0x00000005,  /**< E1.33 (RPT) */
   VECTOR_ROOT_NULL = 0x00000006,  /**< NULL (empty) root */
+  VECTOR_ROOT_E131_EXTENDED = 0x00000008,  /**< E1.31 (sACN) extended */
   VECTOR_ROOT_BROKER = 0x00000009,  /**< E1.33 (Broker) */
   VECTOR_ROOT_LLRP = 0x0000000A,  /**< E1.33 (LLRP) */
   VECTOR_ROOT_EPT = 0x0000000B,  /**< E1.33 (EPT) */
@@ -70,6 +71,16 @@ enum E131Vector {
   VECTOR_E131_DISCOVERY = 4,  /**< Discovery data (DISCOVERY_PACKET_VECTOR) */
 };
 
+/**
+ * @brief Vectors used at the E1.31 extended layer.
+ */
+enum E131ExtendedVector {
+  /** @brief Synchronization (VECTOR_E131_EXTENDED_SYNCHRONIZATION) */
+  VECTOR_E131_EXTENDED_SYNCHRONIZATION = 1,
+  /** @brief Universe discovery (VECTOR_E131_EXTENDED_DISCOVERY) */
+  VECTOR_E131_EXTENDED_DISCOVERY = 2,
+};
+
 /**
  * @brief Vectors used at the E1.33 layer.
  */
@@ -21,6 +21,7 @@
 #ifndef INCLUDE_OLA_CLIENT_CLIENTTYPES_H_
 #define INCLUDE_OLA_CLIENT_CLIENTTYPES_H_
 
+#include <ola/DmxBuffer.h>
 #include <ola/dmx/SourcePriorities.h>
 #include <ola/rdm/RDMFrame.h>
 #include <ola/rdm/RDMResponseCodes.h>
@@ -350,6 +351,34 @@ struct RDMMetadata {
       : response_code(_response_code) {
   }
 };
+
+/**
+ * @brief The DMX data for one universe in a DmxBatch.
+ */
+struct DmxBatchEntry {
+ public:
+  unsigned int universe;  ///< The universe the data is for.
+  DmxBuffer data;  ///< The DMX512 data.
+  /**
+   * @brief The priority of the data.
+   * This should be between ola::dmx::SOURCE_PRIORITY_MIN and
+   * ola::dmx::SOURCE_PRIORITY_MAX.
+   */
+  uint8_t priority;
+
+  DmxBatchEntry(unsigned int _universe,
+                const DmxBuffer &_data,
+                uint8_t _priority = ola::dmx::SOURCE_PRIORITY_DEFAULT)
+      : universe(_universe),
+        data(_data),
+        priority(_priority) {
+  }
+};
+
+/**
+ * @brief A set of universes to send to olad in a single message.
+ */
+typedef std::vector<DmxBatchEntry> DmxBatch;
 }  // namespace client
 }  // namespace ola
 #endif  // INCLUDE_OLA_CLIENT_CLIENTTYPES_H_
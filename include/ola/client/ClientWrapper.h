@@ -38,9 +38,12 @@
 #include <ola/AutoStart.h>
 #include <ola/Callback.h>
 #include <ola/client/OlaClient.h>
+#include <ola/io/Descriptor.h>
 #include <ola/io/SelectServer.h>
+#include <ola/network/LocalSocket.h>
 
 #include <memory>
+#include <string>
 
 namespace ola {
 namespace client {
@@ -73,6 +76,16 @@ class BaseClientWrapper {
    */
   ola::io::SelectServer *GetSelectServer() { return &m_ss; }
 
+  /**
+   * @brief Connect to olad using a local socket rather than TCP.
+   * @param path the path olad is listening on, see olad's --rpc-socket flag.
+   *   An empty path means use TCP.
+   *
+   * This must be called before Setup(). olad isn't auto-started when a
+   * local socket is used.
+   */
+  void SetServerSocket(const std::string &path) { m_socket_path = path; }
+
   /**
    * @brief Setup the client.
    * @returns true on success, false on failure.
@@ -92,7 +105,8 @@ class BaseClientWrapper {
   void SocketClosed();
 
  protected:
-  std::auto_ptr<ola::network::TCPSocket> m_socket;
+  std::auto_ptr<ola::io::ConnectedDescriptor> m_socket;
+  std::string m_socket_path;
 
  private:
   ola::io::SelectServer m_ss;
@@ -140,17 +154,24 @@ class GenericClientWrapper: public BaseClientWrapper {
   }
 
   void InitSocket() {
+    if (!m_socket_path.empty()) {
+      m_socket.reset(ola::network::LocalSocket::Connect(m_socket_path));
+      return;
+    }
+
+    ola::network::TCPSocket *socket;
     if (m_auto_start) {
-      m_socket.reset(ola::client::ConnectToServer(OLA_DEFAULT_PORT));
+      socket = ola::client::ConnectToServer(OLA_DEFAULT_PORT);
     } else {
-      m_socket.reset(ola::network::TCPSocket::Connect(
+      socket = ola::network::TCPSocket::Connect(
           ola::network::IPV4SocketAddress(
             ola::network::IPV4Address::Loopback(),
-           OLA_DEFAULT_PORT)));
+           OLA_DEFAULT_PORT));
     }
-    if (m_socket.get()) {
-      m_socket->SetNoDelay();
+    if (socket) {
+      socket->SetNoDelay();
     }
+    m_socket.reset(socket);
   }
 };
 
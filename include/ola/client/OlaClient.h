@@ -248,6 +248,29 @@ class OlaClient {
                const DmxBuffer &data,
                const SendDMXArgs &args);
 
+  /**
+   * @brief Send DMX data for many universes in a single message.
+   * @param batch the universes and their data.
+   *
+   * The data is streamed to the server, there is no acknowledgement. If the
+   * server doesn't support batches, each universe is sent separately.
+   */
+  void SendDmxBatch(const DmxBatch &batch);
+
+  /**
+   * @brief Exchange DMX data with olad using shared memory.
+   * @param universe_count the number of universes to allocate space for, in
+   *   each direction.
+   * @param callback the SetCallback to invoke upon completion.
+   *
+   * This only works when olad is running on the same host. Once it
+   * completes, DMX data sent without a callback, and the data for registered
+   * universes, is passed through shared memory rather than the socket. If
+   * it fails, or there are more universes than fit in the shared memory, the
+   * socket is used as before.
+   */
+  void SetupSharedMemory(unsigned int universe_count, SetCallback *callback);
+
   /**
    * @brief Fetch the latest DMX data for a universe.
    * @param universe the universe id to get data for.
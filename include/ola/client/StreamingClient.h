@@ -28,12 +28,18 @@
 #include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/base/Macro.h>
+#include <ola/client/ClientTypes.h>
 #include <ola/dmx/SourcePriorities.h>
 
+#include <string>
+
 namespace ola {
 
-namespace io { class SelectServer; }
-namespace network { class TCPSocket; }
+namespace dmx { class SharedDmxRegion; }
+namespace io {
+class ConnectedDescriptor;
+class SelectServer;
+}
 namespace proto { class OlaServerService_Stub; }
 namespace rpc {
 class RpcChannel;
@@ -74,6 +80,26 @@ class StreamingClientInterface {
   virtual bool SendDMX(unsigned int universe,
                        const DmxBuffer &data,
                        const SendArgs &args) = 0;
+
+  /**
+   * @brief Send DMX data for many universes.
+   * @param batch the universes and their data.
+   * @returns true if all the universes were sent, false otherwise.
+   *
+   * The default implementation calls SendDMX() for each universe, so
+   * existing implementations of this interface keep working.
+   */
+  virtual bool SendDmxBatch(const DmxBatch &batch) {
+    DmxBatch::const_iterator iter = batch.begin();
+    for (; iter != batch.end(); ++iter) {
+      SendArgs args;
+      args.priority = iter->priority;
+      if (!SendDMX(iter->universe, iter->data, args)) {
+        return false;
+      }
+    }
+    return true;
+  }
 };
 
 /**
@@ -97,7 +123,13 @@ class StreamingClient : public StreamingClientInterface {
      * Create a new options structure with the default options. This
      * includes automatically starting olad if it's not already running.
      */
-    Options() : auto_start(true), server_port(OLA_DEFAULT_PORT) {}
+    Options()
+        : auto_start(true),
+          server_port(OLA_DEFAULT_PORT),
+          use_shared_memory(false),
+          shared_memory_universes(64),
+          use_delta_frames(false) {
+    }
 
     /**
      * If true, the client will automatically start olad if it's not
@@ -109,6 +141,34 @@ class StreamingClient : public StreamingClientInterface {
      * The RPC port olad is listening on.
      */
     uint16_t server_port;
+
+    /**
+     * If not empty, connect to olad using the local socket at this path
+     * rather than TCP. olad needs to be run with --rpc-socket, and isn't
+     * auto-started.
+     */
+    std::string server_socket;
+
+    /**
+     * If true, DMX data is written to memory shared with olad rather than
+     * being sent over the socket. This only works if olad is running on the
+     * same host, otherwise the socket is used.
+     */
+    bool use_shared_memory;
+
+    /**
+     * The number of universes to allocate shared memory for. Any universes
+     * beyond this are sent over the socket.
+     */
+    unsigned int shared_memory_universes;
+
+    /**
+     * If true, and olad supports it, only the slots that changed since the
+     * previous frame for a universe are sent, with a full frame sent
+     * periodically. This reduces the bandwidth used when only a few slots
+     * change each frame.
+     */
+    bool use_delta_frames;
   };
 
   /**
@@ -164,18 +224,41 @@ class StreamingClient : public StreamingClientInterface {
                const DmxBuffer &data,
                const SendArgs &args);
 
+  /**
+   * @brief Send DMX data for many universes in a single message.
+   * @param batch the universes and their data.
+   * @returns true if sent successfully, false if the connection to the server
+   *   has been closed.
+   *
+   * This uses one write for all the universes. If the server doesn't support
+   * batches, each universe is sent separately.
+   */
+  bool SendDmxBatch(const DmxBatch &batch);
+
   void ChannelClosed(ola::rpc::RpcSession *session);
 
  private:
   bool m_auto_start;
   uint16_t m_server_port;
-  ola::network::TCPSocket *m_socket;
+  std::string m_server_socket;
+  bool m_use_shared_memory;
+  unsigned int m_shared_memory_universes;
+  bool m_use_delta_frames;
+  ola::io::ConnectedDescriptor *m_socket;
   ola::io::SelectServer *m_ss;
   class ola::rpc::RpcChannel *m_channel;
   class ola::proto::OlaServerService_Stub *m_stub;
   bool m_socket_closed;
+  ola::dmx::SharedDmxRegion *m_shm_send;
 
   bool Send(unsigned int universe, uint8_t priority, const DmxBuffer &data);
+  bool CheckConnection();
+  bool SetupSharedMemory();
+  bool WriteSharedMemory(unsigned int universe, uint8_t priority,
+                         const DmxBuffer &data);
+  void SharedMemoryWritten();
+  void StreamUniverse(unsigned int universe, uint8_t priority,
+                      const DmxBuffer &data);
 
   DISALLOW_COPY_AND_ASSIGN(StreamingClient);
 };
@@ -0,0 +1,90 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DeltaEncoder.h
+ * Header file for the DeltaEncoder class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file DeltaEncoder.h
+ * @brief Encode / Decode the changes between two DMX frames.
+ */
+
+#ifndef INCLUDE_OLA_DMX_DELTAENCODER_H_
+#define INCLUDE_OLA_DMX_DELTAENCODER_H_
+
+#include <stdint.h>
+#include <ola/DmxBuffer.h>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief Encode / Decode the changes between two DMX frames as a list of
+ * ranges.
+ *
+ * Each range is the offset of the first slot (2 bytes), the number of slots
+ * (2 bytes), both in network byte order, followed by the slot values. Short
+ * runs of unchanged slots between two changes are included in a single range,
+ * since that's smaller than starting a new one.
+ */
+class DeltaEncoder {
+ public :
+  DeltaEncoder() {}
+  ~DeltaEncoder() {}
+
+  /**
+   * Encode the slots that differ between two frames of the same size.
+   * @param[in] previous the frame the receiver already has.
+   * @param[in] current the new frame.
+   * @param[in] length the number of slots in both frames.
+   * @param[out] data where to store the ranges.
+   * @param[in,out] size the size of the data segment, set to the amount of
+   * data encoded.
+   * @return true if we encoded all the changes, false if we ran out of space.
+   * If nothing changed, true is returned and size is set to 0.
+   */
+  bool Encode(const uint8_t *previous,
+              const uint8_t *current,
+              unsigned int length,
+              uint8_t *data,
+              unsigned int *size);
+
+  /**
+   * Apply a list of ranges to a DmxBuffer.
+   * @param[in] data the encoded ranges.
+   * @param[in] length the length of the encoded ranges.
+   * @param[in,out] output the DmxBuffer holding the previous frame.
+   * @returns true if decoding was successful, false if the data was
+   * malformed or a range extends past the end of the buffer. In that case the
+   * buffer isn't modified.
+   */
+  bool Decode(const uint8_t *data,
+              unsigned int length,
+              DmxBuffer *output);
+
+  /**
+   * The size of the header at the start of each range.
+   */
+  static const unsigned int RANGE_HEADER_SIZE = 4;
+
+ private:
+  bool Validate(const uint8_t *data, unsigned int length,
+                unsigned int slot_count) const;
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_DELTAENCODER_H_
@@ -1,4 +1,5 @@
 oladmxincludedir = $(pkgincludedir)/dmx/
 oladmxinclude_HEADERS = \
+    include/ola/dmx/DeltaEncoder.h \
     include/ola/dmx/RunLengthEncoder.h \
     include/ola/dmx/SourcePriorities.h
@@ -121,6 +121,30 @@ class MemoryBlock {
       return bytes_to_write;
     }
 
+    /**
+     * @brief Provides a pointer to the free space at the end of the block.
+     * @returns a pointer to Remaining() bytes of free space.
+     *
+     * This allows data to be generated directly into the block, rather than
+     * being built elsewhere and then copied with Append(). Call Commit() once
+     * the data has been written.
+     */
+    uint8_t *WritePointer() const { return m_last; }
+
+    /**
+     * @brief Add data that was written to the space returned by
+     * WritePointer().
+     * @param length the number of bytes written.
+     * @returns the number of bytes added, which will be less than length if
+     * the block is now full.
+     */
+    unsigned int Commit(unsigned int length) {
+      unsigned int bytes_written = std::min(
+          length, static_cast<unsigned int>(m_data_end - m_last));
+      m_last += bytes_written;
+      return bytes_written;
+    }
+
     /**
      * @brief Prepend data to this block.
      * @param data the data to prepend.
@@ -66,6 +66,7 @@ class SelectServer: public SelectServerInterface {
    public:
     Options()
         : force_select(false),
+          use_timer_wheel(false),
           export_map(NULL),
           clock(NULL) {
     }
@@ -76,6 +77,16 @@ class SelectServer: public SelectServerInterface {
      */
     bool force_select;
 
+    /**
+     * @brief Store timeouts in a hierarchical timer wheel rather than a
+     * priority queue.
+     *
+     * Registering and removing a timeout is O(1) with the timer wheel, at the
+     * cost of scanning the wheel to find the next event. This is useful when
+     * there are many timeouts which are removed before they trigger.
+     */
+    bool use_timer_wheel;
+
     /**
      * @brief The export map to use.
      */
@@ -187,12 +198,22 @@ class SelectServer: public SelectServerInterface {
    */
   void RunInLoop(ola::Callback0<void> *callback);
 
+  /**
+   * @brief Execute a callback in the SelectServer thread.
+   * @param callback the Callback to execute. Ownership is transferred to the
+   *   SelectServer.
+   *
+   * This may be called from any thread. Callbacks are run in the order they
+   * were added. Where the compiler provides atomic builtins, this doesn't
+   * take a lock, so threads posting at a high rate don't contend with the
+   * SelectServer thread.
+   */
   void Execute(ola::BaseCallback0<void> *callback);
 
   void DrainCallbacks();
 
  private:
-  typedef std::vector<ola::BaseCallback0<void>*> Callbacks;
+  struct IncomingCallback;
   typedef std::set<ola::Callback0<void>*> LoopClosureSet;
 
   ExportMap *m_export_map;
@@ -203,15 +224,20 @@ class SelectServer: public SelectServerInterface {
 
   Clock *m_clock;
   bool m_free_clock;
+  IntegerVariable *m_read_descriptor_var;
+  IntegerVariable *m_write_descriptor_var;
+  IntegerVariable *m_connected_descriptor_var;
   LoopClosureSet m_loop_callbacks;
-  Callbacks m_incoming_callbacks;
+  // A stack of callbacks from Execute(), newest first.
+  IncomingCallback *m_incoming_callbacks;
+  // Only used if atomic builtins aren't available.
   ola::thread::Mutex m_incoming_mutex;
   LoopbackDescriptor m_incoming_descriptor;
 
   void Init(const Options &options);
   bool CheckForEvents(const TimeInterval &poll_interval);
   void DrainAndExecute();
-  void RunCallbacks(Callbacks *callbacks);
+  bool RunIncomingCallbacks();
   void SetTerminate() { m_terminate = true; }
 
   // the maximum time we'll wait in the select call
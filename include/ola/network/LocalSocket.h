@@ -0,0 +1,125 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * LocalSocket.h
+ * Stream sockets in the local (Unix) domain.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * LocalSocket, this represents a connection to a process on the same host.
+ *
+ * LocalAcceptingSocket listens on a path in the filesystem and runs a
+ * callback for each new connection.
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_LOCALSOCKET_H_
+#define INCLUDE_OLA_NETWORK_LOCALSOCKET_H_
+
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <ola/io/Descriptor.h>
+
+#include <memory>
+#include <string>
+
+namespace ola {
+namespace network {
+
+/**
+ * @brief A connected stream socket in the local domain.
+ */
+class LocalSocket: public ola::io::ConnectedDescriptor {
+ public:
+  explicit LocalSocket(int sd);
+
+  ~LocalSocket() { Close(); }
+
+  ola::io::DescriptorHandle ReadDescriptor() const { return m_handle; }
+  ola::io::DescriptorHandle WriteDescriptor() const { return m_handle; }
+  bool Close();
+
+  /**
+   * @brief Connect to a listening socket.
+   * @param path the path of the socket.
+   * @returns a new LocalSocket or NULL if the connection failed.
+   */
+  static LocalSocket* Connect(const std::string &path);
+
+ protected:
+  bool IsSocket() const { return true; }
+
+ private:
+  ola::io::DescriptorHandle m_handle;
+
+  DISALLOW_COPY_AND_ASSIGN(LocalSocket);
+};
+
+
+/**
+ * @brief A listening stream socket in the local domain.
+ */
+class LocalAcceptingSocket: public ola::io::ReadFileDescriptor {
+ public:
+  /**
+   * @brief Called with each new connection, ownership of the socket is
+   * transferred.
+   */
+  typedef ola::Callback1<void, LocalSocket*> AcceptCallback;
+
+  /**
+   * @brief Create a new LocalAcceptingSocket.
+   * @param on_accept the callback to run for new connections, ownership is
+   *   transferred.
+   */
+  explicit LocalAcceptingSocket(AcceptCallback *on_accept);
+  ~LocalAcceptingSocket();
+
+  /**
+   * @brief Start listening.
+   * @param path the path of the socket.
+   * @param group if not empty, members of this group may also connect.
+   *   Otherwise only the user we're running as can.
+   * @param backlog the listen backlog.
+   * @returns true if it succeeded, false otherwise.
+   *
+   * If a socket already exists at the path, but nothing is listening on it,
+   * it's removed. Listen fails if something else exists at the path, or if
+   * another process is listening.
+   */
+  bool Listen(const std::string &path, const std::string &group = "",
+              int backlog = 10);
+
+  ola::io::DescriptorHandle ReadDescriptor() const { return m_handle; }
+
+  /**
+   * @brief Stop listening & remove the socket from the filesystem.
+   */
+  bool Close();
+  void PerformRead();
+
+  /**
+   * @brief The path we're listening on, or the empty string if we're not.
+   */
+  const std::string& Path() const { return m_path; }
+
+ private:
+  ola::io::DescriptorHandle m_handle;
+  std::string m_path;
+  std::auto_ptr<AcceptCallback> m_on_accept;
+
+  DISALLOW_COPY_AND_ASSIGN(LocalAcceptingSocket);
+};
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_LOCALSOCKET_H_
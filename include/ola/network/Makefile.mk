@@ -6,6 +6,7 @@ olanetworkinclude_HEADERS = \
     include/ola/network/IPV6Address.h \
     include/ola/network/Interface.h \
     include/ola/network/InterfacePicker.h \
+    include/ola/network/LocalSocket.h \
     include/ola/network/MACAddress.h \
     include/ola/network/NetworkUtils.h \
     include/ola/network/Socket.h \
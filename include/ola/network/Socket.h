@@ -35,10 +35,98 @@
 #include <ola/io/IOQueue.h>
 #include <ola/network/IPV4Address.h>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace network {
 
+/**
+ * @brief A reusable set of receive buffers for UDPSocketInterface::RecvBatch.
+ *
+ * The buffers are allocated once, so a node can keep a DatagramBatch as a
+ * member and drain the socket into it on every read event.
+ */
+class DatagramBatch {
+ public:
+  /**
+   * @brief Create a new DatagramBatch.
+   * @param max_size the size of each datagram buffer.
+   * @param capacity the maximum number of datagrams per batch.
+   */
+  explicit DatagramBatch(unsigned int max_size,
+                         unsigned int capacity = DEFAULT_CAPACITY);
+  ~DatagramBatch();
+
+  /**
+   * @brief The maximum number of datagrams this batch can hold.
+   */
+  unsigned int Capacity() const { return m_capacity; }
+
+  /**
+   * @brief The size of each datagram buffer.
+   */
+  unsigned int MaxSize() const { return m_max_size; }
+
+  /**
+   * @brief The number of datagrams in the batch.
+   */
+  unsigned int Count() const { return m_count; }
+
+  /**
+   * @brief Return true if the batch can't hold any more datagrams.
+   */
+  bool Full() const { return m_count == m_capacity; }
+
+  /**
+   * @brief The buffer for the i-th datagram.
+   *
+   * Buffers are aligned to 8 bytes so they can be cast to packet structures.
+   */
+  uint8_t *Data(unsigned int i) { return m_buffer + i * m_stride; }
+  const uint8_t *Data(unsigned int i) const {
+    return m_buffer + i * m_stride;
+  }
+
+  /**
+   * @brief The size of the i-th datagram.
+   */
+  unsigned int Size(unsigned int i) const { return m_sizes[i]; }
+
+  /**
+   * @brief The source of the i-th datagram.
+   */
+  const IPV4SocketAddress &Source(unsigned int i) const {
+    return m_sources[i];
+  }
+
+  /**
+   * @brief Empty the batch.
+   */
+  void Clear() { m_count = 0; }
+
+  /**
+   * @brief Record that the next buffer, Data(Count()), has been filled.
+   * @param size the size of the datagram.
+   * @param source the source of the datagram.
+   * @returns false if the batch was already full.
+   */
+  bool Append(unsigned int size, const IPV4SocketAddress &source);
+
+  static const unsigned int DEFAULT_CAPACITY = 16;
+
+ private:
+  const unsigned int m_max_size;
+  const unsigned int m_capacity;
+  const unsigned int m_stride;
+  unsigned int m_count;
+  uint8_t *m_buffer;
+  std::vector<unsigned int> m_sizes;
+  std::vector<IPV4SocketAddress> m_sources;
+
+  DISALLOW_COPY_AND_ASSIGN(DatagramBatch);
+};
+
+
 /**
  * @brief The interface for UDPSockets.
  *
@@ -135,6 +223,23 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
   virtual ssize_t SendTo(ola::io::IOVecInterface *data,
                          const IPV4SocketAddress &dest) const = 0;
 
+  /**
+   * @brief Send the same datagram to a set of destinations.
+   * @param buffer the data to send
+   * @param size the length of the data
+   * @param destinations the IP:Ports to send the datagram to.
+   * @param syscalls if not NULL, this is set to the number of system calls
+   *   used to send the datagrams.
+   * @return the number of destinations the whole datagram was sent to.
+   *
+   * The default implementation calls SendTo() once for each destination.
+   */
+  virtual unsigned int SendToMany(
+      const uint8_t *buffer,
+      unsigned int size,
+      const std::vector<IPV4SocketAddress> &destinations,
+      unsigned int *syscalls) const;
+
   /**
    * @brief Receive data
    * @param buffer the buffer to store the data
@@ -188,6 +293,16 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
                         ssize_t *data_read,
                         IPV4SocketAddress *source) = 0;
 
+  /**
+   * @brief Receive as many datagrams as are waiting, up to the batch capacity.
+   * @param batch the DatagramBatch to fill, it's cleared first.
+   * @return the number of datagrams received.
+   *
+   * This never blocks once the first datagram has been read. The default
+   * implementation reads a single datagram with RecvFrom().
+   */
+  virtual unsigned int RecvBatch(DatagramBatch *batch);
+
   /**
    * @brief Enable broadcasting for this socket.
    * @return true if it worked, false otherwise
@@ -262,6 +377,10 @@ class UDPSocket: public UDPSocketInterface {
                  unsigned short port) const;
   ssize_t SendTo(ola::io::IOVecInterface *data,
                  const IPV4SocketAddress &dest) const;
+  unsigned int SendToMany(const uint8_t *buffer,
+                          unsigned int size,
+                          const std::vector<IPV4SocketAddress> &destinations,
+                          unsigned int *syscalls) const;
 
   bool RecvFrom(uint8_t *buffer, ssize_t *data_read) const;
   bool RecvFrom(uint8_t *buffer,
@@ -276,6 +395,8 @@ class UDPSocket: public UDPSocketInterface {
                 ssize_t *data_read,
                 IPV4SocketAddress *source);
 
+  unsigned int RecvBatch(DatagramBatch *batch);
+
   bool EnableBroadcast();
   bool SetMulticastInterface(const IPV4Address &iface);
   bool JoinMulticast(const IPV4Address &iface,
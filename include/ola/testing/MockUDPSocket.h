@@ -93,6 +93,7 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
   bool RecvFrom(uint8_t *buffer,
                 ssize_t *data_read,
                 ola::network::IPV4SocketAddress *source);
+  unsigned int RecvBatch(ola::network::DatagramBatch *batch);
   bool EnableBroadcast();
   bool SetMulticastInterface(const ola::network::IPV4Address &iface);
   bool JoinMulticast(const ola::network::IPV4Address &iface,
@@ -104,6 +105,8 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
   bool SetTos(uint8_t tos);
 
   void SetDiscardMode(bool discard_mode) { m_discard_mode = discard_mode; }
+  // In failure mode, the SendTo methods fail without checking the data.
+  void SetFailureMode(bool failure_mode) { m_failure_mode = failure_mode; }
 
   // these are methods used for verification
   void AddExpectedData(const uint8_t *data,
@@ -156,6 +159,7 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
   mutable std::queue<received_data> m_received_data;
   ola::network::IPV4Address m_interface;
   bool m_discard_mode;
+  bool m_failure_mode;
 
   uint8_t* IOQueueToBuffer(ola::io::IOQueue *ioqueue,
                            unsigned int *size) const;
@@ -89,6 +89,18 @@ class DmxSource {
     }
 
 
+    /*
+     * Update the DmxSource with new data, copying the slots directly into the
+     * existing buffer.
+     */
+    void UpdateData(const uint8_t *data, unsigned int length,
+                    const TimeStamp &timestamp, uint8_t priority) {
+      m_buffer.Set(data, length);
+      m_timestamp = timestamp;
+      m_priority = priority;
+    }
+
+
     /*
      * Get the DmxBuffer in this source
      */
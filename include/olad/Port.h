@@ -172,6 +172,25 @@ class OutputPort: public Port, ola::rdm::DiscoverableRDMControllerInterface {
    */
   virtual bool WriteDMX(const DmxBuffer &buffer, uint8_t priority) = 0;
 
+  /**
+   * @brief Check if WriteDMX() can be called from an output worker thread.
+   * @return true if the port is safe to write from another thread.
+   *
+   * When olad is run with output workers, WriteDMX() for these ports is
+   * called from the worker thread that handles the universe, rather than the
+   * main SelectServer thread. All other methods are still called from the
+   * main thread. To return true, WriteDMX() must:
+   *  - only use state that belongs to the port, or is protected by a lock.
+   *  - not use the PluginAdaptor, or any sockets, timeouts or descriptors
+   *    that are registered with the main SelectServer.
+   *
+   * Ports that copy the data into a buffer under a mutex, for their own
+   * output thread to send, meet these rules.
+   *
+   * The default is false, so WriteDMX() is called from the main thread.
+   */
+  virtual bool SupportsThreadedOutput() const { return false; }
+
   /**
    * @brief Called if the universe name changes
    */
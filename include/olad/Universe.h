@@ -29,6 +29,8 @@
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/UID.h>
 #include <ola/rdm/UIDSet.h>
+#include <ola/thread/ExecutorInterface.h>
+#include <ola/thread/SchedulerInterface.h>
 #include <ola/util/SequenceNumber.h>
 #include <olad/DmxSource.h>
 
@@ -42,6 +44,7 @@ namespace ola {
 class Client;
 class InputPort;
 class OutputPort;
+class ThreadedPortWriter;
 
 class Universe: public ola::rdm::RDMControllerInterface {
  public:
@@ -52,7 +55,8 @@ class Universe: public ola::rdm::RDMControllerInterface {
 
     Universe(unsigned int uid, class UniverseStore *store,
              ExportMap *export_map,
-             Clock *clock);
+             Clock *clock,
+             ola::thread::SchedulerInterface *scheduler = NULL);
     ~Universe();
 
     // Properties for this universe
@@ -78,6 +82,18 @@ class Universe: public ola::rdm::RDMControllerInterface {
       return m_last_discovery_time;
     }
 
+    /**
+     * @brief Return the maximum rate at which frames are sent to the output
+     * ports and sink clients.
+     * @return the rate in frames per second, 0 means every change is sent.
+     */
+    unsigned int MaxOutputRate() const { return m_max_output_rate; }
+
+    /**
+     * @brief Check if frames which are identical to the last one are skipped.
+     */
+    bool SkipUnchangedFrames() const { return m_skip_unchanged_frames; }
+
     // Used to adjust the properties
     void SetName(const std::string &name);
     void SetMergeMode(merge_mode merge_mode);
@@ -89,6 +105,39 @@ class Universe: public ola::rdm::RDMControllerInterface {
       m_rdm_discovery_interval = discovery_interval;
     }
 
+    /**
+     * @brief Limit the rate at which frames are sent to the output ports and
+     * sink clients.
+     * @param frames_per_second the maximum rate, or 0 to send every change.
+     *
+     * Changes that arrive within a frame period of the last frame are
+     * coalesced and sent as a single frame at the end of the period, so the
+     * extra latency is at most one period. This has no effect if the
+     * universe was created without a scheduler.
+     */
+    void SetMaxOutputRate(unsigned int frames_per_second);
+
+    /**
+     * @brief Don't send frames to the output ports and sink clients if
+     * neither the data nor the priority has changed since the last frame.
+     * @param skip true to skip unchanged frames.
+     *
+     * Some protocols expect a steady stream of frames, so an unchanged frame
+     * is still sent if it's been longer than UNCHANGED_REFRESH_INTERVAL_MS
+     * since the last one.
+     */
+    void SetSkipUnchangedFrames(bool skip);
+
+    /**
+     * @brief Write to thread safe output ports from a worker thread.
+     * @param executor the worker to use, or NULL to write to all ports from
+     *   the calling thread. The executor must outlive the universe.
+     *
+     * Only ports where OutputPort::SupportsThreadedOutput() returns true are
+     * written from the worker, the rest are written as usual.
+     */
+    void SetOutputWorker(ola::thread::ExecutorInterface *executor);
+
     // Each universe has a DMXBuffer
     bool SetDMX(const DmxBuffer &buffer);
     const DmxBuffer &GetDMX() const { return m_buffer; }
@@ -140,9 +189,12 @@ class Universe: public ola::rdm::RDMControllerInterface {
     }
 
     static const char K_FPS_VAR[];
+    static const char K_UNIVERSE_COALESCED_FRAMES_VAR[];
     static const char K_MERGE_HTP_STR[];
     static const char K_MERGE_LTP_STR[];
     static const char K_UNIVERSE_INPUT_PORT_VAR[];
+    static const char K_UNIVERSE_LATENCY_VAR[];
+    static const char K_UNIVERSE_MAX_OUTPUT_RATE_VAR[];
     static const char K_UNIVERSE_MODE_VAR[];
     static const char K_UNIVERSE_NAME_VAR[];
     static const char K_UNIVERSE_OUTPUT_PORT_VAR[];
@@ -150,6 +202,9 @@ class Universe: public ola::rdm::RDMControllerInterface {
     static const char K_UNIVERSE_SINK_CLIENTS_VAR[];
     static const char K_UNIVERSE_SOURCE_CLIENTS_VAR[];
     static const char K_UNIVERSE_UID_COUNT_VAR[];
+    static const char K_UNIVERSE_UNCHANGED_FRAMES_VAR[];
+
+    static const unsigned int UNCHANGED_REFRESH_INTERVAL_MS = 1000;
 
  private:
     typedef struct {
@@ -178,29 +233,53 @@ class Universe: public ola::rdm::RDMControllerInterface {
     class UniverseStore *m_universe_store;
     DmxBuffer m_buffer;
     ExportMap *m_export_map;
+    ola::UIntMapHandle m_fps_var;
+    ola::UIntMapHandle m_coalesced_frames_var;
+    ola::UIntMapHandle m_rdm_requests_var;
+    ola::UIntMapHandle m_sink_clients_var;
+    ola::UIntMapHandle m_source_clients_var;
+    ola::UIntMapHandle m_unchanged_frames_var;
+    ola::HistogramVariable *m_latency_var;
     std::map<ola::rdm::UID, OutputPort*> m_output_uids;
     Clock *m_clock;
     TimeInterval m_rdm_discovery_interval;
     TimeStamp m_last_discovery_time;
     ola::SequenceNumber<uint8_t> m_transaction_number_sequence;
+    ola::thread::SchedulerInterface *m_scheduler;
+    unsigned int m_max_output_rate;
+    TimeInterval m_output_interval;
+    TimeStamp m_last_output_time;
+    TimeStamp m_ingress_time;  // when the pending data arrived
+    ThreadedPortWriter *m_port_writer;
+    bool m_skip_unchanged_frames;
+    // The frame that was last sent, if we're skipping unchanged frames.
+    unsigned int m_sent_generation;
+    uint8_t m_sent_priority;
+    TimeStamp m_last_sent_time;
+    ola::thread::timeout_id m_output_timeout;
+    // Reused by MergeAll() so we don't allocate on every merge.
+    std::vector<const DmxSource*> m_active_sources;
+    std::vector<const DmxBuffer*> m_merge_buffers;
+    DmxBuffer m_merge_output;
 
     void HandleBroadcastAck(broadcast_request_tracker *tracker,
                             ola::rdm::RDMReply *reply);
     void HandleBroadcastDiscovery(broadcast_request_tracker *tracker,
                                   ola::rdm::RDMReply *reply);
+    bool DataChanged();
+    bool RecordIngressTime();
+    void ScheduledUpdate();
     bool UpdateDependants();
+    bool FrameUnchanged();
     void UpdateName();
     void UpdateMode();
-    void HTPMergeSources(const std::vector<DmxSource> &sources);
+    void HTPMergeSources(const std::vector<const DmxSource*> &sources);
     bool MergeAll(const InputPort *port, const Client *client);
     void PortDiscoveryComplete(BaseCallback0<void> *on_complete,
                                OutputPort *output_port,
                                const ola::rdm::UIDSet &uids);
     void DiscoveryComplete(ola::rdm::RDMDiscoveryCallback *on_complete);
 
-    void SafeIncrement(const std::string &name);
-    void SafeDecrement(const std::string &name);
-
     template<class PortClass>
     bool GenericAddPort(PortClass *port,
                         std::vector<PortClass*> *ports);
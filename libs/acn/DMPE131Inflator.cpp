@@ -24,6 +24,7 @@
 #include <memory>
 #include <vector>
 #include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
 #include "libs/acn/DMPE131Inflator.h"
 #include "libs/acn/DMPHeader.h"
 #include "libs/acn/DMPPDU.h"
@@ -39,6 +40,8 @@ using std::pair;
 using std::vector;
 
 const TimeInterval DMPE131Inflator::EXPIRY_INTERVAL(2500000);
+// E131_NETWORK_DATA_LOSS_TIMEOUT
+const TimeInterval DMPE131Inflator::SYNC_TIMEOUT(2500000);
 
 
 DMPE131Inflator::~DMPE131Inflator() {
@@ -141,30 +144,46 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
     }
   }
 
-  if (universe_iter->second.priority) {
-    *universe_iter->second.priority = universe_iter->second.active_priority;
+  universe_handler *handler = &universe_iter->second;
+  if (handler->priority) {
+    *handler->priority = handler->active_priority;
   }
 
+  // Data with a sync address is merged into the held buffer and only applied
+  // once the matching Synchronization packet arrives. If the Synchronization
+  // packets stop, we fall back to applying the data as it arrives.
+  uint16_t sync_address = m_on_sync_address.get() ?
+      e131_header.SyncAddress() : 0;
+  if (sync_address != handler->sync_address) {
+    SetSyncAddress(handler, sync_address);
+  }
+  const bool hold = sync_address && !SyncTimedOut(sync_address);
+  DmxBuffer *output = hold ? &handler->held_buffer : handler->buffer;
+
   // merge the sources
-  switch (universe_iter->second.sources.size()) {
+  switch (handler->sources.size()) {
     case 0:
-      universe_iter->second.buffer->Reset();
-      break;
+      handler->buffer->Reset();
+      handler->waiting_for_sync = false;
+      return true;
     case 1:
-      universe_iter->second.buffer->Set(
-          universe_iter->second.sources[0].buffer);
-      universe_iter->second.closure->Run();
+      output->Set(handler->sources[0].buffer);
       break;
     default:
       // HTP Merge
-      universe_iter->second.buffer->Reset();
+      output->Reset();
       std::vector<dmx_source>::const_iterator source_iter =
-          universe_iter->second.sources.begin();
-      for (; source_iter != universe_iter->second.sources.end();
-           ++source_iter) {
-        universe_iter->second.buffer->HTPMerge(source_iter->buffer);
+          handler->sources.begin();
+      for (; source_iter != handler->sources.end(); ++source_iter) {
+        output->HTPMerge(source_iter->buffer);
       }
-      universe_iter->second.closure->Run();
+  }
+
+  if (hold) {
+    handler->waiting_for_sync = true;
+  } else {
+    handler->waiting_for_sync = false;
+    handler->closure->Run();
   }
   return true;
 }
@@ -193,6 +212,8 @@ bool DMPE131Inflator::SetHandler(uint16_t universe,
     handler.closure = closure;
     handler.active_priority = 0;
     handler.priority = priority;
+    handler.sync_address = 0;
+    handler.waiting_for_sync = false;
     m_handlers[universe] = handler;
   } else {
     Callback0<void> *old_closure = iter->second.closure;
@@ -214,6 +235,7 @@ bool DMPE131Inflator::RemoveHandler(uint16_t universe) {
   UniverseHandlers::iterator iter = m_handlers.find(universe);
 
   if (iter != m_handlers.end()) {
+    SetSyncAddress(&iter->second, 0);
     Callback0<void> *old_closure = iter->second.closure;
     m_handlers.erase(iter);
     delete old_closure;
@@ -223,6 +245,44 @@ bool DMPE131Inflator::RemoveHandler(uint16_t universe) {
 }
 
 
+/*
+ * Apply the held data for every universe that is waiting on this sync address.
+ * @param sync_address the sync address from the Synchronization packet.
+ */
+void DMPE131Inflator::SyncReceived(uint16_t sync_address) {
+  SyncTimes::iterator sync_iter = m_sync_times.find(sync_address);
+  if (sync_iter == m_sync_times.end()) {
+    return;
+  }
+  m_clock->CurrentMonotonicTime(&sync_iter->second);
+
+  UniverseHandlers::iterator iter = m_handlers.begin();
+  for (; iter != m_handlers.end(); ++iter) {
+    universe_handler &handler = iter->second;
+    if (handler.waiting_for_sync && handler.sync_address == sync_address) {
+      handler.waiting_for_sync = false;
+      handler.buffer->Set(handler.held_buffer);
+      handler.closure->Run();
+    }
+  }
+}
+
+
+/*
+ * Get the sync address for a universe.
+ */
+uint16_t DMPE131Inflator::SyncAddress(uint16_t universe,
+                                      bool *synchronized) const {
+  UniverseHandlers::const_iterator iter = m_handlers.find(universe);
+  if (iter == m_handlers.end() || !iter->second.sync_address) {
+    *synchronized = false;
+    return 0;
+  }
+  *synchronized = !SyncTimedOut(iter->second.sync_address);
+  return iter->second.sync_address;
+}
+
+
 /**
  * Get the list of registered universes
  * @param universes a pointer to a vector which is populated with the list of
@@ -254,7 +314,7 @@ bool DMPE131Inflator::TrackSourceIfRequired(
 
   *buffer = NULL;  // default the buffer to NULL
   ola::TimeStamp now;
-  m_clock.CurrentMonotonicTime(&now);
+  m_clock->CurrentMonotonicTime(&now);
   const E131Header &e131_header = headers.GetE131Header();
   uint8_t priority = e131_header.Priority();
   vector<dmx_source> &sources = universe_data->sources;
@@ -363,5 +423,58 @@ bool DMPE131Inflator::TrackSourceIfRequired(
     return true;
   }
 }
+
+
+/*
+ * Change the sync address a universe is using. This tells the caller when a
+ * sync address is first used, and when nothing uses it any more.
+ */
+void DMPE131Inflator::SetSyncAddress(universe_handler *handler,
+                                     uint16_t sync_address) {
+  const uint16_t old_address = handler->sync_address;
+  handler->sync_address = sync_address;
+  handler->waiting_for_sync = false;
+
+  if (old_address) {
+    bool in_use = false;
+    UniverseHandlers::const_iterator iter = m_handlers.begin();
+    for (; iter != m_handlers.end(); ++iter) {
+      if (iter->second.sync_address == old_address) {
+        in_use = true;
+        break;
+      }
+    }
+
+    if (!in_use) {
+      m_sync_times.erase(old_address);
+      if (m_on_sync_address_unused.get()) {
+        m_on_sync_address_unused->Run(old_address);
+      }
+    }
+  }
+
+  if (sync_address && !STLContains(m_sync_times, sync_address)) {
+    // Hold the data until the first Synchronization packet arrives, or
+    // SYNC_TIMEOUT passes.
+    TimeStamp now;
+    m_clock->CurrentMonotonicTime(&now);
+    m_sync_times[sync_address] = now;
+    m_on_sync_address->Run(sync_address);
+  }
+}
+
+
+/*
+ * Check if the Synchronization packets for a sync address have stopped.
+ */
+bool DMPE131Inflator::SyncTimedOut(uint16_t sync_address) const {
+  SyncTimes::const_iterator iter = m_sync_times.find(sync_address);
+  if (iter == m_sync_times.end()) {
+    return true;
+  }
+  TimeStamp now;
+  m_clock->CurrentMonotonicTime(&now);
+  return now > iter->second + SYNC_TIMEOUT;
+}
 }  // namespace acn
 }  // namespace ola
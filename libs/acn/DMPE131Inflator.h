@@ -23,6 +23,7 @@
 #define LIBS_ACN_DMPE131INFLATOR_H_
 
 #include <map>
+#include <memory>
 #include <vector>
 #include "ola/Clock.h"
 #include "ola/Callback.h"
@@ -36,9 +37,28 @@ class DMPE131Inflator: public DMPInflator {
   friend class DMPE131InflatorTest;
 
  public:
-  explicit DMPE131Inflator(bool ignore_preview):
+  typedef ola::Callback1<void, uint16_t> SyncAddressCallback;
+
+  /**
+   * @param ignore_preview true to drop data with the preview bit set.
+   * @param on_sync_address if provided, data that carries a sync address is
+   *   held until SyncReceived() is called for that address. The callback is
+   *   run when the first universe starts using a sync address, so the caller
+   *   can subscribe to it. Ownership is transferred.
+   * @param on_sync_address_unused run when no universe uses a sync address
+   *   any more, so the caller can unsubscribe. Ownership is transferred.
+   * @param clock the clock to use, or NULL to use the system clock.
+   *   Ownership is not transferred.
+   */
+  explicit DMPE131Inflator(bool ignore_preview,
+                           SyncAddressCallback *on_sync_address = NULL,
+                           SyncAddressCallback *on_sync_address_unused = NULL,
+                           const ola::Clock *clock = NULL):
     DMPInflator(),
-    m_ignore_preview(ignore_preview) {
+    m_ignore_preview(ignore_preview),
+    m_on_sync_address(on_sync_address),
+    m_on_sync_address_unused(on_sync_address_unused),
+    m_clock(clock ? clock : &m_system_clock) {
   }
   ~DMPE131Inflator();
 
@@ -46,6 +66,21 @@ class DMPE131Inflator: public DMPInflator {
                   uint8_t *priority, ola::Callback0<void> *handler);
   bool RemoveHandler(uint16_t universe);
 
+  /**
+   * @brief Apply the data held for all universes waiting on a sync address.
+   */
+  void SyncReceived(uint16_t sync_address);
+
+  /**
+   * @brief Get the sync address a universe is using.
+   * @param universe the universe to check.
+   * @param[out] synchronized true if data is held until the Synchronization
+   *   packet arrives, false if the Synchronization packets have stopped and
+   *   data is applied as it arrives.
+   * @returns the sync address, or 0 if the universe isn't synchronized.
+   */
+  uint16_t SyncAddress(uint16_t universe, bool *synchronized) const;
+
   void RegisteredUniverses(std::vector<uint16_t> *universes);
 
  protected:
@@ -68,17 +103,28 @@ class DMPE131Inflator: public DMPInflator {
     uint8_t active_priority;
     uint8_t *priority;
     std::vector<dmx_source> sources;
+    uint16_t sync_address;
+    bool waiting_for_sync;
+    DmxBuffer held_buffer;
   } universe_handler;
 
   typedef std::map<uint16_t, universe_handler> UniverseHandlers;
+  // The time the last Synchronization packet arrived for each sync address.
+  typedef std::map<uint16_t, TimeStamp> SyncTimes;
 
   UniverseHandlers m_handlers;
+  SyncTimes m_sync_times;
   bool m_ignore_preview;
-  ola::Clock m_clock;
+  std::auto_ptr<SyncAddressCallback> m_on_sync_address;
+  std::auto_ptr<SyncAddressCallback> m_on_sync_address_unused;
+  ola::Clock m_system_clock;
+  const ola::Clock *m_clock;
 
   bool TrackSourceIfRequired(universe_handler *universe_data,
                              const HeaderSet &headers,
                              DmxBuffer **buffer);
+  void SetSyncAddress(universe_handler *handler, uint16_t sync_address);
+  bool SyncTimedOut(uint16_t sync_address) const;
 
   // The max number of sources we'll track per universe.
   static const uint8_t MAX_MERGE_SOURCES = 6;
@@ -88,6 +134,8 @@ class DMPE131Inflator: public DMPInflator {
   static const int8_t SEQUENCE_DIFF_THRESHOLD = -20;
   // expire sources after 2.5s
   static const TimeInterval EXPIRY_INTERVAL;
+  // apply data as it arrives if we haven't had a sync for this long
+  static const TimeInterval SYNC_TIMEOUT;
 };
 }  // namespace acn
 }  // namespace ola
@@ -0,0 +1,272 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DMPE131InflatorTest.cpp
+ * Test fixture for the universe synchronization in DMPE131Inflator
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/acn/CID.h"
+#include "libs/acn/DMPE131Inflator.h"
+#include "libs/acn/HeaderSet.h"
+#include "ola/testing/TestUtils.h"
+
+namespace ola {
+namespace acn {
+
+using std::vector;
+
+class DMPE131InflatorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DMPE131InflatorTest);
+  CPPUNIT_TEST(testNoSync);
+  CPPUNIT_TEST(testSyncHold);
+  CPPUNIT_TEST(testSyncTimeout);
+  CPPUNIT_TEST(testSyncAddressUnused);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void testNoSync();
+    void testSyncHold();
+    void testSyncTimeout();
+    void testSyncAddressUnused();
+
+ private:
+    ola::MockClock m_clock;
+    CID m_cid;
+    uint8_t m_sequence;
+    unsigned int m_data_count;
+    vector<uint16_t> m_new_addresses;
+    vector<uint16_t> m_unused_addresses;
+
+    DMPE131Inflator *NewInflator() {
+      return new DMPE131Inflator(
+          false,
+          NewCallback(this, &DMPE131InflatorTest::NewSyncAddress),
+          NewCallback(this, &DMPE131InflatorTest::SyncAddressUnused),
+          &m_clock);
+    }
+
+    void SendData(DMPE131Inflator *inflator, uint16_t universe,
+                  uint16_t sync_address, uint8_t value);
+
+    void DataReceived() { m_data_count++; }
+    void NewSyncAddress(uint16_t address) {
+      m_new_addresses.push_back(address);
+    }
+    void SyncAddressUnused(uint16_t address) {
+      m_unused_addresses.push_back(address);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DMPE131InflatorTest);
+
+
+void DMPE131InflatorTest::setUp() {
+  m_cid = CID::Generate();
+  m_sequence = 0;
+  m_data_count = 0;
+  m_new_addresses.clear();
+  m_unused_addresses.clear();
+}
+
+
+/*
+ * Pass a DMP PDU with 3 slots to the inflator.
+ */
+void DMPE131InflatorTest::SendData(DMPE131Inflator *inflator,
+                                   uint16_t universe,
+                                   uint16_t sync_address,
+                                   uint8_t value) {
+  RootHeader root_header;
+  root_header.SetCid(m_cid);
+  HeaderSet headers;
+  headers.SetRootHeader(root_header);
+  headers.SetE131Header(E131Header("test", 100, m_sequence++, universe, false,
+                                   false, false, sync_address));
+  headers.SetDMPHeader(DMPHeader(true, false, RANGE_EQUAL, TWO_BYTES));
+
+  const uint8_t data[] = {
+    0, 0,  // start
+    0, 1,  // increment
+    0, 4,  // number, including the start code
+    0, value, value, value
+  };
+  OLA_ASSERT_TRUE(inflator->HandlePDUData(DMP_SET_PROPERTY_VECTOR, headers,
+                                          data, sizeof(data)));
+}
+
+
+/*
+ * Check data without a sync address is applied immediately.
+ */
+void DMPE131InflatorTest::testNoSync() {
+  std::auto_ptr<DMPE131Inflator> inflator(NewInflator());
+  DmxBuffer buffer;
+  uint8_t priority;
+  inflator->SetHandler(
+      1, &buffer, &priority,
+      NewCallback(this, &DMPE131InflatorTest::DataReceived));
+
+  SendData(inflator.get(), 1, 0, 10);
+  OLA_ASSERT_EQ(1u, m_data_count);
+  OLA_ASSERT_EQ(DmxBuffer("\x0a\x0a\x0a"), buffer);
+  OLA_ASSERT_TRUE(m_new_addresses.empty());
+
+  bool synchronized;
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0),
+                inflator->SyncAddress(1, &synchronized));
+  OLA_ASSERT_FALSE(synchronized);
+}
+
+
+/*
+ * Check data with a sync address is held until the sync arrives.
+ */
+void DMPE131InflatorTest::testSyncHold() {
+  std::auto_ptr<DMPE131Inflator> inflator(NewInflator());
+  DmxBuffer buffer;
+  uint8_t priority;
+  inflator->SetHandler(
+      1, &buffer, &priority,
+      NewCallback(this, &DMPE131InflatorTest::DataReceived));
+
+  SendData(inflator.get(), 1, 7, 10);
+  OLA_ASSERT_EQ(0u, m_data_count);
+  OLA_ASSERT_EQ(0u, buffer.Size());
+  OLA_ASSERT_EQ(1u, static_cast<unsigned int>(m_new_addresses.size()));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(7), m_new_addresses[0]);
+
+  bool synchronized;
+  OLA_ASSERT_EQ(static_cast<uint16_t>(7),
+                inflator->SyncAddress(1, &synchronized));
+  OLA_ASSERT_TRUE(synchronized);
+
+  // A sync for a different address doesn't apply the data.
+  inflator->SyncReceived(8);
+  OLA_ASSERT_EQ(0u, m_data_count);
+
+  // Later data replaces the held data.
+  SendData(inflator.get(), 1, 7, 20);
+  inflator->SyncReceived(7);
+  OLA_ASSERT_EQ(1u, m_data_count);
+  OLA_ASSERT_EQ(DmxBuffer("\x14\x14\x14"), buffer);
+
+  // Nothing is waiting, so another sync does nothing.
+  inflator->SyncReceived(7);
+  OLA_ASSERT_EQ(1u, m_data_count);
+  OLA_ASSERT_EQ(1u, static_cast<unsigned int>(m_new_addresses.size()));
+}
+
+
+/*
+ * Check data is applied as it arrives once the sync packets stop.
+ */
+void DMPE131InflatorTest::testSyncTimeout() {
+  std::auto_ptr<DMPE131Inflator> inflator(NewInflator());
+  DmxBuffer buffer;
+  uint8_t priority;
+  inflator->SetHandler(
+      1, &buffer, &priority,
+      NewCallback(this, &DMPE131InflatorTest::DataReceived));
+
+  SendData(inflator.get(), 1, 7, 10);
+  inflator->SyncReceived(7);
+  OLA_ASSERT_EQ(1u, m_data_count);
+
+  // Data keeps arriving, but the sync packets stop.
+  m_clock.AdvanceTime(2, 0);
+  SendData(inflator.get(), 1, 7, 20);
+  OLA_ASSERT_EQ(1u, m_data_count);
+
+  m_clock.AdvanceTime(1, 0);
+  SendData(inflator.get(), 1, 7, 30);
+  OLA_ASSERT_EQ(2u, m_data_count);
+  OLA_ASSERT_EQ(DmxBuffer("\x1e\x1e\x1e"), buffer);
+
+  bool synchronized;
+  OLA_ASSERT_EQ(static_cast<uint16_t>(7),
+                inflator->SyncAddress(1, &synchronized));
+  OLA_ASSERT_FALSE(synchronized);
+
+  // Data is held again once the sync packets resume.
+  inflator->SyncReceived(7);
+  SendData(inflator.get(), 1, 7, 40);
+  OLA_ASSERT_EQ(2u, m_data_count);
+  inflator->SyncReceived(7);
+  OLA_ASSERT_EQ(3u, m_data_count);
+  OLA_ASSERT_EQ(DmxBuffer("\x28\x28\x28"), buffer);
+  inflator->SyncAddress(1, &synchronized);
+  OLA_ASSERT_TRUE(synchronized);
+
+  // If no sync ever arrives for a new address, the data is held until the
+  // timeout.
+  SendData(inflator.get(), 1, 9, 50);
+  OLA_ASSERT_EQ(3u, m_data_count);
+  m_clock.AdvanceTime(3, 0);
+  SendData(inflator.get(), 1, 9, 60);
+  OLA_ASSERT_EQ(4u, m_data_count);
+  OLA_ASSERT_EQ(DmxBuffer("\x3c\x3c\x3c"), buffer);
+}
+
+
+/*
+ * Check we're told when nothing uses a sync address.
+ */
+void DMPE131InflatorTest::testSyncAddressUnused() {
+  std::auto_ptr<DMPE131Inflator> inflator(NewInflator());
+  DmxBuffer buffer1, buffer2;
+  uint8_t priority1, priority2;
+  inflator->SetHandler(
+      1, &buffer1, &priority1,
+      NewCallback(this, &DMPE131InflatorTest::DataReceived));
+  inflator->SetHandler(
+      2, &buffer2, &priority2,
+      NewCallback(this, &DMPE131InflatorTest::DataReceived));
+
+  SendData(inflator.get(), 1, 7, 10);
+  SendData(inflator.get(), 2, 7, 10);
+  OLA_ASSERT_EQ(1u, static_cast<unsigned int>(m_new_addresses.size()));
+
+  // Universe 2 is still using the sync address.
+  inflator->RemoveHandler(1);
+  OLA_ASSERT_TRUE(m_unused_addresses.empty());
+
+  // Universe 2 moves to another sync address.
+  SendData(inflator.get(), 2, 8, 10);
+  OLA_ASSERT_EQ(1u, static_cast<unsigned int>(m_unused_addresses.size()));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(7), m_unused_addresses[0]);
+  OLA_ASSERT_EQ(2u, static_cast<unsigned int>(m_new_addresses.size()));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(8), m_new_addresses[1]);
+
+  // And stops using sync.
+  SendData(inflator.get(), 2, 0, 10);
+  OLA_ASSERT_EQ(2u, static_cast<unsigned int>(m_unused_addresses.size()));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(8), m_unused_addresses[1]);
+
+  SendData(inflator.get(), 2, 9, 10);
+  inflator->RemoveHandler(2);
+  OLA_ASSERT_EQ(3u, static_cast<unsigned int>(m_unused_addresses.size()));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(9), m_unused_addresses[2]);
+}
+}  // namespace acn
+}  // namespace ola
@@ -0,0 +1,72 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131ExtendedInflator.h
+ * Interface for the E131ExtendedInflator class.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * This handles the E1.31 extended root vector, which carries the
+ * Synchronization packets.
+ */
+
+#ifndef LIBS_ACN_E131EXTENDEDINFLATOR_H_
+#define LIBS_ACN_E131EXTENDEDINFLATOR_H_
+
+#include <memory>
+#include "ola/Callback.h"
+#include "ola/acn/ACNVectors.h"
+#include "libs/acn/BaseInflator.h"
+
+namespace ola {
+namespace acn {
+
+class E131ExtendedInflator: public BaseInflator {
+  friend class E131ExtendedInflatorTest;
+
+ public:
+  typedef ola::Callback2<void, const HeaderSet&, uint16_t> SyncCallback;
+
+  /**
+   * @param on_sync run with the sync address each time a Synchronization
+   *   packet is received. Ownership is transferred.
+   */
+  explicit E131ExtendedInflator(SyncCallback *on_sync = NULL)
+      : BaseInflator(),
+        m_on_sync(on_sync) {
+  }
+  ~E131ExtendedInflator() {}
+
+  uint32_t Id() const { return ola::acn::VECTOR_ROOT_E131_EXTENDED; }
+
+ protected:
+  // The extended framing layer has no header that is shared between vectors.
+  bool DecodeHeader(HeaderSet *headers,
+                    const uint8_t *data,
+                    unsigned int len,
+                    unsigned int *bytes_used);
+
+  void ResetHeaderField() {}
+
+  bool HandlePDUData(uint32_t vector,
+                     const HeaderSet &headers,
+                     const uint8_t *data,
+                     unsigned int pdu_len);
+
+ private:
+  std::auto_ptr<SyncCallback> m_on_sync;
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131EXTENDEDINFLATOR_H_
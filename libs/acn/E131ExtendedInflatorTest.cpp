@@ -0,0 +1,119 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131ExtendedInflatorTest.cpp
+ * Test fixture for the E131ExtendedInflator class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/network/NetworkUtils.h"
+#include "libs/acn/E131ExtendedInflator.h"
+#include "libs/acn/E131SyncPDU.h"
+#include "libs/acn/HeaderSet.h"
+#include "ola/testing/TestUtils.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::HostToNetwork;
+using std::vector;
+
+class E131ExtendedInflatorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(E131ExtendedInflatorTest);
+  CPPUNIT_TEST(testPackSyncPDU);
+  CPPUNIT_TEST(testInflateSyncPDU);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testPackSyncPDU();
+    void testInflateSyncPDU();
+
+ private:
+    vector<uint16_t> m_sync_addresses;
+
+    void SyncReceived(const HeaderSet&, uint16_t sync_address) {
+      m_sync_addresses.push_back(sync_address);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(E131ExtendedInflatorTest);
+
+
+/*
+ * Check that the Synchronization PDU is packed correctly.
+ */
+void E131ExtendedInflatorTest::testPackSyncPDU() {
+  E131SyncPDU pdu(5, 7962);
+  OLA_ASSERT_EQ((unsigned int) 0, pdu.HeaderSize());
+  OLA_ASSERT_EQ((unsigned int) 5, pdu.DataSize());
+  OLA_ASSERT_EQ((unsigned int) 11, pdu.Size());
+
+  unsigned int size = pdu.Size();
+  uint8_t *data = new uint8_t[size];
+  unsigned int bytes_used = size;
+  OLA_ASSERT(pdu.Pack(data, &bytes_used));
+  OLA_ASSERT_EQ(size, bytes_used);
+
+  const uint8_t expected[] = {
+    0x70, 11,
+    0, 0, 0, VECTOR_E131_EXTENDED_SYNCHRONIZATION,
+    5,  // sequence
+    0x1f, 0x1a,  // sync address
+    0, 0  // reserved
+  };
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), data, bytes_used);
+
+  // try an undersized buffer
+  bytes_used = size - 1;
+  OLA_ASSERT_FALSE(pdu.Pack(data, &bytes_used));
+  OLA_ASSERT_EQ((unsigned int) 0, bytes_used);
+  delete[] data;
+}
+
+
+/*
+ * Check that we run the callback when a Synchronization PDU is inflated.
+ */
+void E131ExtendedInflatorTest::testInflateSyncPDU() {
+  E131ExtendedInflator inflator(
+      NewCallback(this, &E131ExtendedInflatorTest::SyncReceived));
+  OLA_ASSERT_EQ(static_cast<uint32_t>(VECTOR_ROOT_E131_EXTENDED),
+                inflator.Id());
+
+  E131SyncPDU pdu(1, 7962);
+  unsigned int size = pdu.Size();
+  uint8_t *data = new uint8_t[size];
+  unsigned int bytes_used = size;
+  OLA_ASSERT(pdu.Pack(data, &bytes_used));
+
+  HeaderSet header_set;
+  OLA_ASSERT_EQ(size, inflator.InflatePDUBlock(&header_set, data, size));
+  OLA_ASSERT_EQ((size_t) 1, m_sync_addresses.size());
+  OLA_ASSERT_EQ((uint16_t) 7962, m_sync_addresses[0]);
+
+  // A truncated PDU shouldn't run the callback
+  data[1] = static_cast<uint8_t>(size - 1);
+  inflator.InflatePDUBlock(&header_set, data, size - 1);
+  OLA_ASSERT_EQ((size_t) 1, m_sync_addresses.size());
+  delete[] data;
+}
+}  // namespace acn
+}  // namespace ola
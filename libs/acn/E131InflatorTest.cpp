@@ -114,7 +114,9 @@ void E131InflatorTest::testDecodeHeader() {
 
   strncpy(header.source, source_name.data(), source_name.size() + 1);
   header.priority = 99;
+  header.sync_address = HostToNetwork(static_cast<uint16_t>(7962));
   header.sequence = 10;
+  header.options = 0;
   header.universe = HostToNetwork(static_cast<uint16_t>(42));
 
   OLA_ASSERT(inflator.DecodeHeader(&header_set,
@@ -127,6 +129,7 @@ void E131InflatorTest::testDecodeHeader() {
   OLA_ASSERT_EQ((uint8_t) 99, decoded_header.Priority());
   OLA_ASSERT_EQ((uint8_t) 10, decoded_header.Sequence());
   OLA_ASSERT_EQ((uint16_t) 42, decoded_header.Universe());
+  OLA_ASSERT_EQ((uint16_t) 7962, decoded_header.SyncAddress());
 
   // try an undersized header
   OLA_ASSERT_FALSE(inflator.DecodeHeader(
@@ -181,7 +184,7 @@ void E131InflatorTest::testInflateRev2PDU() {
  */
 void E131InflatorTest::testInflatePDU() {
   const string source = "foobar source";
-  E131Header header(source, 1, 2, 6000);
+  E131Header header(source, 1, 2, 6000, false, false, false, 7962);
   // TODO(simon): pass a DMP msg here as well
   E131PDU pdu(3, header, NULL);
   OLA_ASSERT_EQ((unsigned int) 77, pdu.Size());
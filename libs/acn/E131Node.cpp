@@ -118,11 +118,19 @@ E131Node::E131Node(ola::thread::SchedulerInterface *ss,
       m_cid(cid),
       m_root_sender(m_cid),
       m_e131_sender(&m_socket, &m_root_sender),
-      m_dmp_inflator(options.ignore_preview),
+      m_dmp_inflator(options.ignore_preview,
+                     options.ignore_sync ? NULL :
+                         NewCallback(this, &E131Node::NewSyncAddress),
+                     options.ignore_sync ? NULL :
+                         NewCallback(this, &E131Node::SyncAddressUnused)),
       m_discovery_inflator(NewCallback(this, &E131Node::NewDiscoveryPage)),
+      m_extended_inflator(NewCallback(this, &E131Node::SyncReceived)),
       m_incoming_udp_transport(&m_socket, &m_root_inflator),
       m_send_buffer(NULL),
-      m_discovery_timeout(ola::thread::INVALID_TIMEOUT) {
+      m_discovery_timeout(ola::thread::INVALID_TIMEOUT),
+      m_sync_universe(options.use_rev2 ? 0 : options.sync_universe),
+      m_sync_sequence(0),
+      m_sync_timeout(ola::thread::INVALID_TIMEOUT) {
 
 
   if (!m_options.use_rev2) {
@@ -134,6 +142,7 @@ E131Node::E131Node(ola::thread::SchedulerInterface *ss,
   // setup all the inflators
   m_root_inflator.AddInflator(&m_e131_inflator);
   m_root_inflator.AddInflator(&m_e131_rev2_inflator);
+  m_root_inflator.AddInflator(&m_extended_inflator);
   m_e131_inflator.AddInflator(&m_dmp_inflator);
   m_e131_inflator.AddInflator(&m_discovery_inflator);
   m_e131_rev2_inflator.AddInflator(&m_dmp_inflator);
@@ -206,6 +215,8 @@ bool E131Node::Start() {
 bool E131Node::Stop() {
   m_ss->RemoveTimeout(m_discovery_timeout);
   m_discovery_timeout = ola::thread::INVALID_TIMEOUT;
+  m_ss->RemoveTimeout(m_sync_timeout);
+  m_sync_timeout = ola::thread::INVALID_TIMEOUT;
   return true;
 }
 
@@ -278,30 +289,50 @@ bool E131Node::SendDMXWithSequenceOffset(uint16_t universe,
     dmp_data_length = data_size + 1;
   }
 
-  TwoByteRangeDMPAddress range_addr(0, 1,
-                                    static_cast<uint16_t>(dmp_data_length));
-  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr,
-                                                     dmp_data,
-                                                     dmp_data_length);
-  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
-  ranged_chunks.push_back(range_chunk);
-  const DMPPDU *pdu = NewRangeDMPSetProperty<uint16_t>(true,
-                                                       false,
-                                                       ranged_chunks);
-
-  E131Header header(settings->source,
-                    priority,
-                    static_cast<uint8_t>(settings->sequence + sequence_offset),
-                    universe,
-                    preview,  // preview
-                    false,  // terminated
-                    m_options.use_rev2);
+  // Only the per-frame fields change once a universe has been sent, so the
+  // packet is built once and then patched in place.
+  E131PacketTemplate *packet = &settings->packet;
+  if (!packet->Matches(settings->source, universe, m_options.use_rev2,
+                       dmp_data_length)) {
+    TwoByteRangeDMPAddress range_addr(0, 1,
+                                      static_cast<uint16_t>(dmp_data_length));
+    DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr,
+                                                       dmp_data,
+                                                       dmp_data_length);
+    vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
+    ranged_chunks.push_back(range_chunk);
+    const DMPPDU *pdu = NewRangeDMPSetProperty<uint16_t>(true,
+                                                         false,
+                                                         ranged_chunks);
+
+    E131Header header(settings->source,
+                      priority,
+                      settings->sequence,
+                      universe,
+                      preview,  // preview
+                      false,  // terminated
+                      m_options.use_rev2,
+                      m_sync_universe);
+
+    bool ok = m_e131_sender.BuildTemplate(header, pdu, dmp_data_length,
+                                          packet);
+    delete pdu;
+    if (!ok) {
+      return false;
+    }
+  }
 
-  bool result = m_e131_sender.SendDMP(header, pdu);
+  packet->Update(priority,
+                 static_cast<uint8_t>(settings->sequence + sequence_offset),
+                 preview,
+                 dmp_data);
+  bool result = m_e131_sender.SendTemplate(*packet);
   if (result && !sequence_offset) {
     settings->sequence++;
   }
-  delete pdu;
+  if (result) {
+    ScheduleSync();
+  }
   return result;
 }
 
@@ -350,26 +381,57 @@ bool E131Node::SendStreamTerminated(uint16_t universe,
   return result;
 }
 
+bool E131Node::SendSync() {
+  if (!m_sync_universe) {
+    return false;
+  }
+
+  if (m_sync_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_sync_timeout);
+    m_sync_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  bool result = m_e131_sender.SendSync(m_sync_sequence, m_sync_universe);
+  if (result) {
+    m_sync_sequence++;
+  }
+  return result;
+}
+
 bool E131Node::SetHandler(uint16_t universe,
                           DmxBuffer *buffer,
                           uint8_t *priority,
                           Callback0<void> *closure) {
-  IPV4Address addr;
-  if (!m_e131_sender.UniverseIP(universe, &addr)) {
-    OLA_WARN << "Unable to determine multicast group for universe " <<
-      universe;
-    return false;
-  }
+  // We're already a member if the universe is also used as a sync address.
+  if (!STLContains(m_sync_groups, universe)) {
+    IPV4Address addr;
+    if (!m_e131_sender.UniverseIP(universe, &addr)) {
+      OLA_WARN << "Unable to determine multicast group for universe " <<
+        universe;
+      return false;
+    }
 
-  if (!m_socket.JoinMulticast(m_interface.ip_address, addr)) {
-    OLA_WARN << "Failed to join multicast group " << addr;
-    return false;
+    if (!m_socket.JoinMulticast(m_interface.ip_address, addr)) {
+      OLA_WARN << "Failed to join multicast group " << addr;
+      return false;
+    }
   }
 
   return m_dmp_inflator.SetHandler(universe, buffer, priority, closure);
 }
 
 bool E131Node::RemoveHandler(uint16_t universe) {
+  // This may run SyncAddressUnused(), which checks the universes that still
+  // have handlers, so the handler is removed first.
+  if (!m_dmp_inflator.RemoveHandler(universe)) {
+    return false;
+  }
+
+  // Stay in the group if another universe uses this one as a sync address.
+  if (STLContains(m_sync_groups, universe)) {
+    return true;
+  }
+
   IPV4Address addr;
   if (!m_e131_sender.UniverseIP(universe, &addr)) {
     OLA_WARN << "Unable to determine multicast group for universe " <<
@@ -381,8 +443,7 @@ bool E131Node::RemoveHandler(uint16_t universe) {
     OLA_WARN << "Failed to leave multicast group " << addr;
     return false;
   }
-
-  return m_dmp_inflator.RemoveHandler(universe);
+  return true;
 }
 
 
@@ -412,6 +473,85 @@ E131Node::tx_universe *E131Node::SetupOutgoingSettings(uint16_t universe) {
 }
 
 
+/*
+ * Send a sync packet once the current batch of universes has been sent. The
+ * timeout fires after control returns to the scheduler, so all the universes
+ * updated in this iteration share a single Synchronization packet.
+ */
+void E131Node::ScheduleSync() {
+  if (!m_sync_universe || m_sync_timeout != ola::thread::INVALID_TIMEOUT) {
+    return;
+  }
+  m_sync_timeout = m_ss->RegisterSingleTimeout(
+      0, NewSingleCallback(this, &E131Node::ScheduledSync));
+}
+
+void E131Node::ScheduledSync() {
+  m_sync_timeout = ola::thread::INVALID_TIMEOUT;
+  SendSync();
+}
+
+/*
+ * Called when a universe we're listening to starts using a new sync address.
+ */
+void E131Node::NewSyncAddress(uint16_t sync_address) {
+  if (!m_sync_groups.insert(sync_address).second) {
+    return;
+  }
+
+  // We're already a member if the sync address is also a data universe.
+  if (IsDataUniverse(sync_address)) {
+    return;
+  }
+
+  IPV4Address addr;
+  if (!m_e131_sender.UniverseIP(sync_address, &addr)) {
+    return;
+  }
+
+  if (!m_socket.JoinMulticast(m_interface.ip_address, addr)) {
+    OLA_WARN << "Failed to join multicast group " << addr;
+  }
+}
+
+/*
+ * Called when none of the universes we're listening to use a sync address.
+ */
+void E131Node::SyncAddressUnused(uint16_t sync_address) {
+  if (!m_sync_groups.erase(sync_address)) {
+    return;
+  }
+
+  // Stay in the group if the sync address is also a data universe.
+  if (IsDataUniverse(sync_address)) {
+    return;
+  }
+
+  IPV4Address addr;
+  if (!m_e131_sender.UniverseIP(sync_address, &addr)) {
+    return;
+  }
+
+  if (!m_socket.LeaveMulticast(m_interface.ip_address, addr)) {
+    OLA_WARN << "Failed to leave multicast group " << addr;
+  }
+}
+
+/*
+ * Check if we have a handler for a universe.
+ */
+bool E131Node::IsDataUniverse(uint16_t universe) {
+  vector<uint16_t> universes;
+  m_dmp_inflator.RegisteredUniverses(&universes);
+  return std::find(universes.begin(), universes.end(), universe) !=
+      universes.end();
+}
+
+void E131Node::SyncReceived(OLA_UNUSED const HeaderSet &headers,
+                            uint16_t sync_address) {
+  m_dmp_inflator.SyncReceived(sync_address);
+}
+
 bool E131Node::PerformDiscoveryHousekeeping() {
   // Send the Universe Discovery packets.
   vector<uint16_t> universes;
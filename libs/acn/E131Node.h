@@ -38,7 +38,9 @@
 #include "ola/network/Socket.h"
 #include "libs/acn/DMPE131Inflator.h"
 #include "libs/acn/E131DiscoveryInflator.h"
+#include "libs/acn/E131ExtendedInflator.h"
 #include "libs/acn/E131Inflator.h"
+#include "libs/acn/E131PacketTemplate.h"
 #include "libs/acn/E131Sender.h"
 #include "libs/acn/RootInflator.h"
 #include "libs/acn/RootSender.h"
@@ -58,6 +60,8 @@ class E131Node {
        : use_rev2(false),
          ignore_preview(true),
          enable_draft_discovery(false),
+         ignore_sync(false),
+         sync_universe(0),
          dscp(0),
          port(ola::acn::ACN_PORT),
          source_name(ola::OLA_DEFAULT_INSTANCE_NAME) {
@@ -66,6 +70,12 @@ class E131Node {
     bool use_rev2;  /**< Use Revision 0.2 of the 2009 draft */
     bool ignore_preview;  /**< Ignore preview data */
     bool enable_draft_discovery;  /**< Enable 2014 draft discovery */
+    bool ignore_sync;  /**< Apply data immediately, ignoring sync addresses */
+    /**
+     * The universe to send Synchronization packets on, 0 disables sync. This
+     * has no effect if use_rev2 is set.
+     */
+    uint16_t sync_universe;
     uint8_t dscp;  /**< The DSCP value to tag packets with */
     uint16_t port; /**< The UDP port to use, defaults to ACN_PORT */
     std::string source_name; /**< The source name to use */
@@ -171,6 +181,16 @@ class E131Node {
                             const ola::DmxBuffer &buffer = DmxBuffer(),
                             uint8_t priority = DEFAULT_PRIORITY);
 
+  /**
+   * @brief Send a Synchronization packet on the sync universe.
+   *
+   * If a sync universe is set, a Synchronization packet is sent automatically
+   * once the current batch of SendDMX() calls has completed, i.e. when control
+   * returns to the scheduler. This allows a caller to send one sooner.
+   * @return true if it was sent successfully, false otherwise
+   */
+  bool SendSync();
+
   /**
    * @brief Set the Callback to be run when we receive data for this universe.
    * @param universe the universe to register the handler for
@@ -189,6 +209,23 @@ class E131Node {
    */
   bool RemoveHandler(uint16_t universe);
 
+  /**
+   * @brief Get the sync address an incoming universe is using.
+   * @param universe the universe to check.
+   * @param[out] synchronized true if data is held until the Synchronization
+   *   packet arrives, false if the Synchronization packets have stopped.
+   * @return the sync address, or 0 if the universe isn't synchronized.
+   */
+  uint16_t InputSyncAddress(uint16_t universe, bool *synchronized) const {
+    return m_dmp_inflator.SyncAddress(universe, synchronized);
+  }
+
+  /**
+   * @brief Return the universe Synchronization packets are sent on, or 0 if
+   *   sync is disabled.
+   */
+  uint16_t SyncUniverse() const { return m_sync_universe; }
+
   /**
    * @brief Return the Interface this node is using.
    */
@@ -211,6 +248,7 @@ class E131Node {
   struct tx_universe {
     std::string source;
     uint8_t sequence;
+    E131PacketTemplate packet;
   };
 
   typedef std::map<uint16_t, tx_universe> ActiveTxUniverses;
@@ -232,6 +270,7 @@ class E131Node {
   E131InflatorRev2 m_e131_rev2_inflator;
   DMPE131Inflator m_dmp_inflator;
   E131DiscoveryInflator m_discovery_inflator;
+  E131ExtendedInflator m_extended_inflator;
 
   IncomingUDPTransport m_incoming_udp_transport;
   ActiveTxUniverses m_tx_universes;
@@ -241,8 +280,21 @@ class E131Node {
   ola::thread::timeout_id m_discovery_timeout;
   TrackedSources m_discovered_sources;
 
+  // Sync members
+  const uint16_t m_sync_universe;
+  uint8_t m_sync_sequence;
+  ola::thread::timeout_id m_sync_timeout;
+  std::set<uint16_t> m_sync_groups;
+
   tx_universe *SetupOutgoingSettings(uint16_t universe);
 
+  void ScheduleSync();
+  void ScheduledSync();
+  void NewSyncAddress(uint16_t sync_address);
+  void SyncAddressUnused(uint16_t sync_address);
+  bool IsDataUniverse(uint16_t universe);
+  void SyncReceived(const HeaderSet &headers, uint16_t sync_address);
+
   bool PerformDiscoveryHousekeeping();
   void NewDiscoveryPage(const HeaderSet &headers,
                         const E131DiscoveryInflator::DiscoveryPage &page);
@@ -0,0 +1,125 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131PacketTemplate.cpp
+ * A pre-packed E1.31 data packet for a single universe.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <string>
+
+#include "ola/Logging.h"
+#include "libs/acn/E131PacketTemplate.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::IPV4SocketAddress;
+using std::string;
+
+E131PacketTemplate::E131PacketTemplate()
+    : m_size(0),
+      m_universe(0),
+      m_is_rev2(false),
+      m_data_length(0),
+      m_priority_offset(0),
+      m_sequence_offset(0),
+      m_options_offset(0),
+      m_data_offset(0) {
+}
+
+
+bool E131PacketTemplate::Matches(const string &source,
+                                 uint16_t universe,
+                                 bool is_rev2,
+                                 unsigned int data_length) const {
+  return (m_size &&
+          m_universe == universe &&
+          m_is_rev2 == is_rev2 &&
+          m_data_length == data_length &&
+          m_source == source);
+}
+
+
+bool E131PacketTemplate::Set(const E131Header &header,
+                             const uint8_t *packet,
+                             unsigned int size,
+                             unsigned int dmp_pdu_size,
+                             unsigned int data_length,
+                             const IPV4SocketAddress &destination) {
+  m_size = 0;
+
+  const unsigned int header_size = header.UsingRev2() ?
+      sizeof(E131Rev2Header::e131_rev2_pdu_header) :
+      sizeof(E131Header::e131_pdu_header);
+
+  if (size > sizeof(m_packet) || data_length > dmp_pdu_size ||
+      dmp_pdu_size + header_size > size) {
+    OLA_WARN << "Invalid E1.31 packet template, size " << size;
+    return false;
+  }
+
+  // The E1.31 header is immediately followed by the DMP PDU, which carries
+  // the property data at the end.
+  const unsigned int header_offset = size - dmp_pdu_size - header_size;
+  if (header.UsingRev2()) {
+    m_priority_offset = static_cast<unsigned int>(
+        header_offset + offsetof(E131Rev2Header::e131_rev2_pdu_header,
+                                 priority));
+    m_sequence_offset = static_cast<unsigned int>(
+        header_offset + offsetof(E131Rev2Header::e131_rev2_pdu_header,
+                                 sequence));
+    // Rev 2 doesn't have options.
+    m_options_offset = 0;
+  } else {
+    m_priority_offset = static_cast<unsigned int>(
+        header_offset + offsetof(E131Header::e131_pdu_header, priority));
+    m_sequence_offset = static_cast<unsigned int>(
+        header_offset + offsetof(E131Header::e131_pdu_header, sequence));
+    m_options_offset = static_cast<unsigned int>(
+        header_offset + offsetof(E131Header::e131_pdu_header, options));
+  }
+  m_data_offset = size - data_length;
+
+  memcpy(m_packet, packet, size);
+  m_source = header.Source();
+  m_universe = header.Universe();
+  m_is_rev2 = header.UsingRev2();
+  m_data_length = data_length;
+  m_destination = destination;
+  m_size = size;
+  return true;
+}
+
+
+void E131PacketTemplate::Update(uint8_t priority,
+                                uint8_t sequence,
+                                bool preview,
+                                const uint8_t *data) {
+  m_packet[m_priority_offset] = priority;
+  m_packet[m_sequence_offset] = sequence;
+  if (m_options_offset) {
+    // Only the preview bit changes between packets, the other options, e.g.
+    // stream terminated, are kept from the template.
+    m_packet[m_options_offset] = static_cast<uint8_t>(
+        (m_packet[m_options_offset] & ~E131Header::PREVIEW_DATA_MASK) |
+        (preview ? E131Header::PREVIEW_DATA_MASK : 0));
+  }
+  memcpy(m_packet + m_data_offset, data, m_data_length);
+}
+}  // namespace acn
+}  // namespace ola
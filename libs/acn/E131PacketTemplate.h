@@ -0,0 +1,104 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131PacketTemplate.h
+ * A pre-packed E1.31 data packet for a single universe.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E131PACKETTEMPLATE_H_
+#define LIBS_ACN_E131PACKETTEMPLATE_H_
+
+#include <stdint.h>
+#include <string>
+
+#include "ola/network/SocketAddress.h"
+#include "libs/acn/E131Header.h"
+#include "libs/acn/PreamblePacker.h"
+
+namespace ola {
+namespace acn {
+
+/*
+ * A fully packed E1.31 data packet, including the ACN preamble.
+ *
+ * Building a packet from the PDU tree allocates and packs every layer. Once a
+ * universe has been sent, only the priority, sequence number, options and slot
+ * data change from frame to frame, so the packet is kept and those fields are
+ * patched in place. The template must be rebuilt if the source name, universe
+ * or the length of the slot data changes.
+ */
+class E131PacketTemplate {
+ public:
+    E131PacketTemplate();
+
+    /*
+     * Returns true if this template can be used to send the data.
+     */
+    bool Matches(const std::string &source,
+                 uint16_t universe,
+                 bool is_rev2,
+                 unsigned int data_length) const;
+
+    /*
+     * Populate the template from a packed packet.
+     * @param header the E131Header the packet was built with.
+     * @param packet the packet, including the ACN preamble.
+     * @param size the size of the packet.
+     * @param dmp_pdu_size the size of the DMP PDU, which ends the packet.
+     * @param data_length the length of the DMP property data.
+     * @param destination where the packet is sent to.
+     */
+    bool Set(const E131Header &header,
+             const uint8_t *packet,
+             unsigned int size,
+             unsigned int dmp_pdu_size,
+             unsigned int data_length,
+             const ola::network::IPV4SocketAddress &destination);
+
+    /*
+     * Patch the per-frame fields. data must be DataLength() bytes.
+     */
+    void Update(uint8_t priority,
+                uint8_t sequence,
+                bool preview,
+                const uint8_t *data);
+
+    bool IsValid() const { return m_size != 0; }
+    void Invalidate() { m_size = 0; }
+
+    const uint8_t *Data() const { return m_packet; }
+    unsigned int Size() const { return m_size; }
+    unsigned int DataLength() const { return m_data_length; }
+    const ola::network::IPV4SocketAddress &Destination() const {
+      return m_destination;
+    }
+
+ private:
+    uint8_t m_packet[PreamblePacker::MAX_DATAGRAM_SIZE];
+    unsigned int m_size;
+    std::string m_source;
+    uint16_t m_universe;
+    bool m_is_rev2;
+    unsigned int m_data_length;
+    unsigned int m_priority_offset;
+    unsigned int m_sequence_offset;
+    unsigned int m_options_offset;
+    unsigned int m_data_offset;
+    ola::network::IPV4SocketAddress m_destination;
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131PACKETTEMPLATE_H_
@@ -0,0 +1,172 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131PacketTemplateTest.cpp
+ * Test fixture for the E131PacketTemplate class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+
+#include "ola/acn/CID.h"
+#include "ola/network/Socket.h"
+#include "libs/acn/DMPAddress.h"
+#include "libs/acn/DMPPDU.h"
+#include "libs/acn/E131Header.h"
+#include "libs/acn/E131PacketTemplate.h"
+#include "libs/acn/E131Sender.h"
+#include "libs/acn/RootSender.h"
+#include "ola/testing/TestUtils.h"
+
+namespace ola {
+namespace acn {
+
+using std::string;
+using std::vector;
+
+class E131PacketTemplateTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(E131PacketTemplateTest);
+  CPPUNIT_TEST(testTemplate);
+  CPPUNIT_TEST(testRev2Template);
+  CPPUNIT_TEST(testOptionsKept);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    E131PacketTemplateTest()
+        : TestFixture(),
+          m_root_sender(CID::Generate()),
+          m_sender(&m_socket, &m_root_sender) {
+    }
+
+    void testTemplate();
+    void testRev2Template();
+    void testOptionsKept();
+
+ private:
+    ola::network::UDPSocket m_socket;
+    RootSender m_root_sender;
+    E131Sender m_sender;
+
+    void CheckTemplate(bool is_rev2);
+    bool BuildTemplate(const E131Header &header, const uint8_t *data,
+                       unsigned int length,
+                       E131PacketTemplate *packet_template);
+
+    static const uint16_t UNIVERSE = 1;
+    static const char SOURCE[];
+};
+
+const char E131PacketTemplateTest::SOURCE[] = "foo source";
+
+CPPUNIT_TEST_SUITE_REGISTRATION(E131PacketTemplateTest);
+
+
+/*
+ * Build a template using the same DMP PDU as the E131Node.
+ */
+bool E131PacketTemplateTest::BuildTemplate(
+    const E131Header &header,
+    const uint8_t *data,
+    unsigned int length,
+    E131PacketTemplate *packet_template) {
+  TwoByteRangeDMPAddress range_addr(0, 1, static_cast<uint16_t>(length));
+  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr, data,
+                                                     length);
+  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
+  ranged_chunks.push_back(range_chunk);
+  const DMPPDU *pdu = NewRangeDMPSetProperty<uint16_t>(true, false,
+                                                       ranged_chunks);
+  bool ok = m_sender.BuildTemplate(header, pdu, length, packet_template);
+  delete pdu;
+  return ok;
+}
+
+
+/*
+ * Check that patching a template gives the same packet as packing it.
+ */
+void E131PacketTemplateTest::CheckTemplate(bool is_rev2) {
+  const uint8_t data1[] = {0, 1, 2, 3, 4, 5};
+  const uint8_t data2[] = {0, 10, 9, 8, 7, 6};
+
+  E131PacketTemplate packet_template;
+  OLA_ASSERT_FALSE(packet_template.IsValid());
+  OLA_ASSERT_FALSE(packet_template.Matches(SOURCE, UNIVERSE, is_rev2,
+                                           sizeof(data1)));
+
+  E131Header header(SOURCE, 100, 1, UNIVERSE, false, false, is_rev2);
+  OLA_ASSERT_TRUE(BuildTemplate(header, data1, sizeof(data1),
+                                &packet_template));
+  OLA_ASSERT_TRUE(packet_template.IsValid());
+  OLA_ASSERT_TRUE(packet_template.Matches(SOURCE, UNIVERSE, is_rev2,
+                                          sizeof(data1)));
+  OLA_ASSERT_FALSE(packet_template.Matches(SOURCE, UNIVERSE, is_rev2,
+                                           sizeof(data1) - 1));
+  OLA_ASSERT_FALSE(packet_template.Matches(SOURCE, UNIVERSE + 1, is_rev2,
+                                           sizeof(data1)));
+  OLA_ASSERT_FALSE(packet_template.Matches("bar", UNIVERSE, is_rev2,
+                                           sizeof(data1)));
+  OLA_ASSERT_FALSE(packet_template.Matches(SOURCE, UNIVERSE, !is_rev2,
+                                           sizeof(data1)));
+
+  packet_template.Update(150, 42, true, data2);
+
+  E131Header expected_header(SOURCE, 150, 42, UNIVERSE, true, false,
+                             is_rev2);
+  E131PacketTemplate expected;
+  OLA_ASSERT_TRUE(BuildTemplate(expected_header, data2, sizeof(data2),
+                                &expected));
+  OLA_ASSERT_DATA_EQUALS(expected.Data(), expected.Size(),
+                         packet_template.Data(), packet_template.Size());
+}
+
+
+void E131PacketTemplateTest::testTemplate() {
+  CheckTemplate(false);
+}
+
+
+void E131PacketTemplateTest::testRev2Template() {
+  CheckTemplate(true);
+}
+
+
+/*
+ * Check that Update() only changes the preview bit in the options.
+ */
+void E131PacketTemplateTest::testOptionsKept() {
+  const uint8_t data[] = {0, 1, 2, 3};
+
+  E131PacketTemplate packet_template;
+  E131Header header(SOURCE, 100, 1, UNIVERSE, false, true);
+  OLA_ASSERT_TRUE(BuildTemplate(header, data, sizeof(data),
+                                &packet_template));
+
+  for (unsigned int i = 0; i < 2; i++) {
+    const bool preview = (i == 0);
+    packet_template.Update(100, 2, preview, data);
+
+    E131Header expected_header(SOURCE, 100, 2, UNIVERSE, preview, true);
+    E131PacketTemplate expected;
+    OLA_ASSERT_TRUE(BuildTemplate(expected_header, data, sizeof(data),
+                                  &expected));
+    OLA_ASSERT_DATA_EQUALS(expected.Data(), expected.Size(),
+                           packet_template.Data(), packet_template.Size());
+  }
+}
+}  // namespace acn
+}  // namespace ola
@@ -19,6 +19,7 @@
  */
 
 #include "ola/Logging.h"
+#include "ola/acn/ACNPort.h"
 #include "ola/acn/ACNVectors.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/NetworkUtils.h"
@@ -27,6 +28,7 @@
 #include "libs/acn/E131Inflator.h"
 #include "libs/acn/E131Sender.h"
 #include "libs/acn/E131PDU.h"
+#include "libs/acn/E131SyncPDU.h"
 #include "libs/acn/RootSender.h"
 #include "libs/acn/UDPTransport.h"
 
@@ -34,8 +36,37 @@ namespace ola {
 namespace acn {
 
 using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
 using ola::network::HostToNetwork;
 
+namespace {
+
+/*
+ * An OutgoingTransport that packs the PDUs but doesn't send them.
+ */
+class PackingTransport: public OutgoingTransport {
+ public:
+  explicit PackingTransport(PreamblePacker *packer)
+      : m_packer(packer),
+        m_data(NULL),
+        m_size(0) {
+  }
+
+  bool Send(const PDUBlock<PDU> &pdu_block) {
+    m_data = m_packer->Pack(pdu_block, &m_size);
+    return m_data != NULL;
+  }
+
+  const uint8_t *Data() const { return m_data; }
+  unsigned int Size() const { return m_size; }
+
+ private:
+  PreamblePacker *m_packer;
+  const uint8_t *m_data;
+  unsigned int m_size;
+};
+}  // namespace
+
 /*
  * Create a new E131Sender
  * @param root_sender the root layer to use
@@ -100,6 +131,84 @@ bool E131Sender::SendDiscoveryData(const E131Header &header,
 }
 
 
+/*
+ * Send a Synchronization packet.
+ * @param sequence the sequence number for the sync address.
+ * @param sync_address the universe to send the packet on.
+ */
+bool E131Sender::SendSync(uint8_t sequence, uint16_t sync_address) {
+  if (!m_root_sender) {
+    return false;
+  }
+
+  IPV4Address addr;
+  if (!UniverseIP(sync_address, &addr)) {
+    OLA_INFO << "Could not convert universe " << sync_address << " to IP.";
+    return false;
+  }
+
+  OutgoingUDPTransport transport(&m_transport_impl, addr);
+
+  E131SyncPDU pdu(sequence, sync_address);
+  return m_root_sender->SendPDU(ola::acn::VECTOR_ROOT_E131_EXTENDED, pdu,
+                                &transport);
+}
+
+
+/*
+ * Pack a DMPPDU into a template, so it can be sent many times.
+ * @param header the E131Header
+ * @param dmp_pdu the DMPPDU to pack
+ * @param data_length the length of the property data within the DMPPDU
+ * @param packet_template the template to populate
+ */
+bool E131Sender::BuildTemplate(const E131Header &header,
+                               const DMPPDU *dmp_pdu,
+                               unsigned int data_length,
+                               E131PacketTemplate *packet_template) {
+  packet_template->Invalidate();
+  if (!m_root_sender) {
+    return false;
+  }
+
+  IPV4Address addr;
+  if (!UniverseIP(header.Universe(), &addr)) {
+    OLA_INFO << "Could not convert universe " << header.Universe()
+             << " to IP.";
+    return false;
+  }
+
+  PackingTransport transport(&m_packer);
+
+  E131PDU pdu(ola::acn::VECTOR_E131_DATA, header, dmp_pdu);
+  unsigned int vector = ola::acn::VECTOR_ROOT_E131;
+  if (header.UsingRev2()) {
+    vector = ola::acn::VECTOR_ROOT_E131_REV2;
+  }
+  if (!m_root_sender->SendPDU(vector, pdu, &transport)) {
+    return false;
+  }
+  return packet_template->Set(header, transport.Data(), transport.Size(),
+                              dmp_pdu->Size(), data_length,
+                              IPV4SocketAddress(addr, ola::acn::ACN_PORT));
+}
+
+
+/*
+ * Send a packet from a template.
+ * @param packet_template the template to send
+ */
+bool E131Sender::SendTemplate(const E131PacketTemplate &packet_template) {
+  if (!packet_template.IsValid()) {
+    return false;
+  }
+  ssize_t bytes_sent = m_socket->SendTo(packet_template.Data(),
+                                        packet_template.Size(),
+                                        packet_template.Destination());
+  return bytes_sent == static_cast<ssize_t>(packet_template.Size());
+}
+
+
 /*
  * Calculate the IP that corresponds to a universe.
  * @param universe the universe id
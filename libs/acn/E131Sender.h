@@ -25,6 +25,7 @@
 #include "ola/network/Socket.h"
 #include "libs/acn/DMPPDU.h"
 #include "libs/acn/E131Header.h"
+#include "libs/acn/E131PacketTemplate.h"
 #include "libs/acn/PreamblePacker.h"
 #include "libs/acn/Transport.h"
 #include "libs/acn/UDPTransport.h"
@@ -43,6 +44,13 @@ class E131Sender {
   bool SendDMP(const E131Header &header, const DMPPDU *pdu);
   bool SendDiscoveryData(const E131Header &header, const uint8_t *data,
                          unsigned int data_size);
+  bool SendSync(uint8_t sequence, uint16_t sync_address);
+
+  bool BuildTemplate(const E131Header &header,
+                     const DMPPDU *pdu,
+                     unsigned int data_length,
+                     E131PacketTemplate *packet_template);
+  bool SendTemplate(const E131PacketTemplate &packet_template);
 
   static bool UniverseIP(uint16_t universe,
                          class ola::network::IPV4Address *addr);
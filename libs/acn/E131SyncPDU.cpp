@@ -0,0 +1,65 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SyncPDU.cpp
+ * The E1.31 Synchronization PDU
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include "ola/Logging.h"
+#include "ola/network/NetworkUtils.h"
+#include "libs/acn/E131SyncPDU.h"
+
+namespace ola {
+namespace acn {
+
+using ola::io::OutputStream;
+using ola::network::HostToNetwork;
+
+/*
+ * Pack the data portion.
+ */
+bool E131SyncPDU::PackData(uint8_t *data, unsigned int *length) const {
+  if (*length < sizeof(e131_sync_pdu_data)) {
+    OLA_WARN << "E131SyncPDU::PackData: buffer too small, got " << *length
+             << " required " << sizeof(e131_sync_pdu_data);
+    *length = 0;
+    return false;
+  }
+
+  e131_sync_pdu_data sync_data;
+  sync_data.sequence = m_sequence;
+  sync_data.sync_address = HostToNetwork(m_sync_address);
+  sync_data.reserved = 0;
+  *length = sizeof(e131_sync_pdu_data);
+  memcpy(data, &sync_data, *length);
+  return true;
+}
+
+
+/*
+ * Pack the data into a buffer
+ */
+void E131SyncPDU::PackData(OutputStream *stream) const {
+  e131_sync_pdu_data sync_data;
+  sync_data.sequence = m_sequence;
+  sync_data.sync_address = HostToNetwork(m_sync_address);
+  sync_data.reserved = 0;
+  stream->Write(reinterpret_cast<uint8_t*>(&sync_data),
+                sizeof(e131_sync_pdu_data));
+}
+}  // namespace acn
+}  // namespace ola
@@ -0,0 +1,73 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SyncPDU.h
+ * Interface for the E1.31 Synchronization PDU
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E131SYNCPDU_H_
+#define LIBS_ACN_E131SYNCPDU_H_
+
+#include <ola/base/Macro.h>
+#include <stdint.h>
+
+#include "ola/acn/ACNVectors.h"
+#include "libs/acn/PDU.h"
+
+namespace ola {
+namespace acn {
+
+/*
+ * The E1.31 Synchronization PDU. This is carried under the extended root
+ * vector and has no DMP layer, the sequence number & sync address make up the
+ * whole PDU.
+ */
+class E131SyncPDU: public PDU {
+ public:
+  E131SyncPDU(uint8_t sequence, uint16_t sync_address)
+      : PDU(ola::acn::VECTOR_E131_EXTENDED_SYNCHRONIZATION),
+        m_sequence(sequence),
+        m_sync_address(sync_address) {
+  }
+  ~E131SyncPDU() {}
+
+  unsigned int HeaderSize() const { return 0; }
+  bool PackHeader(OLA_UNUSED uint8_t *data,
+                  unsigned int *length) const {
+    *length = 0;
+    return true;
+  }
+  void PackHeader(OLA_UNUSED ola::io::OutputStream *stream) const {}
+
+  unsigned int DataSize() const { return sizeof(e131_sync_pdu_data); }
+  bool PackData(uint8_t *data, unsigned int *length) const;
+  void PackData(ola::io::OutputStream *stream) const;
+
+  PACK(
+  struct e131_sync_pdu_data_s {
+    uint8_t sequence;
+    uint16_t sync_address;
+    uint16_t reserved;
+  });
+  typedef struct e131_sync_pdu_data_s e131_sync_pdu_data;
+
+ private:
+  uint8_t m_sequence;
+  uint16_t m_sync_address;
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131SYNCPDU_H_
@@ -49,6 +49,8 @@ libs_acn_libolae131core_la_SOURCES = \
     libs/acn/DMPPDU.h \
     libs/acn/E131DiscoveryInflator.cpp \
     libs/acn/E131DiscoveryInflator.h \
+    libs/acn/E131ExtendedInflator.cpp \
+    libs/acn/E131ExtendedInflator.h \
     libs/acn/E131Header.h \
     libs/acn/E131Inflator.cpp \
     libs/acn/E131Inflator.h \
@@ -56,8 +58,12 @@ libs_acn_libolae131core_la_SOURCES = \
     libs/acn/E131Node.h \
     libs/acn/E131PDU.cpp \
     libs/acn/E131PDU.h \
+    libs/acn/E131PacketTemplate.cpp \
+    libs/acn/E131PacketTemplate.h \
     libs/acn/E131Sender.cpp \
     libs/acn/E131Sender.h \
+    libs/acn/E131SyncPDU.cpp \
+    libs/acn/E131SyncPDU.h \
     libs/acn/HeaderSet.h \
     libs/acn/LLRPHeader.h \
     libs/acn/LLRPInflator.cpp \
@@ -191,10 +197,13 @@ libs_acn_E131Tester_SOURCES = \
     libs/acn/BaseInflatorTest.cpp \
     libs/acn/CIDTest.cpp \
     libs/acn/DMPAddressTest.cpp \
+    libs/acn/DMPE131InflatorTest.cpp \
     libs/acn/DMPInflatorTest.cpp \
     libs/acn/DMPPDUTest.cpp \
+    libs/acn/E131ExtendedInflatorTest.cpp \
     libs/acn/E131InflatorTest.cpp \
     libs/acn/E131PDUTest.cpp \
+    libs/acn/E131PacketTemplateTest.cpp \
     libs/acn/HeaderSetTest.cpp \
     libs/acn/PDUTest.cpp \
     libs/acn/RootInflatorTest.cpp \
@@ -66,30 +66,41 @@ IncomingUDPTransport::IncomingUDPTransport(ola::network::UDPSocket *socket,
                                            BaseInflator *inflator)
     : m_socket(socket),
       m_inflator(inflator),
-      m_recv_buffer(NULL) {
+      m_recv_batch(NULL) {
 }
 
 
 /*
- * Called when new data arrives.
+ * Called when new data arrives, this drains all waiting datagrams.
  */
 void IncomingUDPTransport::Receive() {
-  if (!m_recv_buffer)
-    m_recv_buffer = new uint8_t[PreamblePacker::MAX_DATAGRAM_SIZE];
+  if (!m_recv_batch) {
+    m_recv_batch = new ola::network::DatagramBatch(
+        PreamblePacker::MAX_DATAGRAM_SIZE);
+  }
 
-  ssize_t size = PreamblePacker::MAX_DATAGRAM_SIZE;
-  ola::network::IPV4SocketAddress source;
+  const unsigned int count = m_socket->RecvBatch(m_recv_batch);
+  for (unsigned int i = 0; i < count; i++) {
+    HandleDatagram(m_recv_batch->Data(i), m_recv_batch->Size(i),
+                   m_recv_batch->Source(i));
+  }
+}
 
-  if (!m_socket->RecvFrom(m_recv_buffer, &size, &source))
-    return;
 
+/*
+ * Check the preamble and inflate a single datagram.
+ */
+void IncomingUDPTransport::HandleDatagram(
+    const uint8_t *data,
+    unsigned int size,
+    const ola::network::IPV4SocketAddress &source) {
   unsigned int header_size = PreamblePacker::ACN_HEADER_SIZE;
-  if (size < static_cast<ssize_t>(header_size)) {
+  if (size < header_size) {
     OLA_WARN << "short ACN frame, discarding";
     return;
   }
 
-  if (memcmp(m_recv_buffer, PreamblePacker::ACN_HEADER, header_size)) {
+  if (memcmp(data, PreamblePacker::ACN_HEADER, header_size)) {
     OLA_WARN << "ACN header is bad, discarding";
     return;
   }
@@ -98,11 +109,8 @@ void IncomingUDPTransport::Receive() {
   TransportHeader transport_header(source, TransportHeader::UDP);
   header_set.SetTransportHeader(transport_header);
 
-  m_inflator->InflatePDUBlock(
-      &header_set,
-      m_recv_buffer + header_size,
-      static_cast<unsigned int>(size) - header_size);
-  return;
+  m_inflator->InflatePDUBlock(&header_set, data + header_size,
+                              size - header_size);
 }
 }  // namespace acn
 }  // namespace ola
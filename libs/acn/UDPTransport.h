@@ -96,8 +96,8 @@ class IncomingUDPTransport {
     IncomingUDPTransport(ola::network::UDPSocket *socket,
                          class BaseInflator *inflator);
     ~IncomingUDPTransport() {
-      if (m_recv_buffer)
-        delete[] m_recv_buffer;
+      if (m_recv_batch)
+        delete m_recv_batch;
     }
 
     void Receive();
@@ -105,7 +105,10 @@ class IncomingUDPTransport {
  private:
     ola::network::UDPSocket *m_socket;
     class BaseInflator *m_inflator;
-    uint8_t *m_recv_buffer;
+    ola::network::DatagramBatch *m_recv_batch;
+
+    void HandleDatagram(const uint8_t *data, unsigned int size,
+                        const ola::network::IPV4SocketAddress &source);
 };
 }  // namespace acn
 }  // namespace ola
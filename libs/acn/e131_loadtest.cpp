@@ -20,8 +20,10 @@
 
 #include <stdlib.h>
 #include <algorithm>
+#include <iostream>
 #include <string>
 #include "ola/Callback.h"
+#include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
 #include "ola/base/Flags.h"
@@ -30,13 +32,19 @@
 #include "libs/acn/E131Node.h"
 
 using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
 using ola::io::SelectServer;
 using ola::acn::E131Node;
 using ola::NewCallback;
+using std::cout;
+using std::endl;
 using std::min;
 
 DEFINE_s_uint32(fps, s, 10, "Frames per second per universe [1 - 40]");
 DEFINE_s_uint16(universes, u, 1, "Number of universes to send");
+DEFINE_uint32(benchmark, 0, "If non-0, send this many frames as fast as "
+              "possible, print the send rate and exit.");
 
 /**
  * Send N DMX frames using E1.31, where N is given by number_of_universes.
@@ -49,6 +57,32 @@ bool SendFrames(E131Node *node, DmxBuffer *buffer,
   return true;
 }
 
+/**
+ * Send frames back to back and report the number of packets per second.
+ */
+int RunBenchmark(E131Node *node, DmxBuffer *buffer,
+                 uint16_t number_of_universes) {
+  ola::Clock clock;
+  TimeStamp start, end;
+  clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < FLAGS_benchmark; i++) {
+    // change the data each frame, like a real source would
+    buffer->SetChannel(0, static_cast<uint8_t>(i));
+    SendFrames(node, buffer, number_of_universes);
+  }
+  clock.CurrentMonotonicTime(&end);
+
+  TimeInterval duration = end - start;
+  uint64_t packets = static_cast<uint64_t>(FLAGS_benchmark) *
+                     number_of_universes;
+  cout << "Sent " << packets << " packets in " << duration << endl;
+  if (duration.InMilliSeconds()) {
+    cout << (packets * ola::USEC_IN_SECONDS / duration.AsInt())
+         << " packets/s" << endl;
+  }
+  return 0;
+}
+
 int main(int argc, char* argv[]) {
   ola::AppInit(&argc, argv, "", "Run the E1.31 load test.");
 
@@ -68,6 +102,10 @@ int main(int argc, char* argv[]) {
     return -1;
   }
 
+  if (FLAGS_benchmark) {
+    return RunBenchmark(&node, &output, universes);
+  }
+
   ss.AddReadDescriptor(node.GetSocket());
   ss.RegisterRepeatingTimeout(
       1000 / fps,
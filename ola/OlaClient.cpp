@@ -164,6 +164,15 @@ void OlaClient::SendDMX(unsigned int universe,
   m_core->SendDMX(universe, data, args);
 }
 
+void OlaClient::SendDmxBatch(const DmxBatch &batch) {
+  m_core->SendDmxBatch(batch);
+}
+
+void OlaClient::SetupSharedMemory(unsigned int universe_count,
+                                  SetCallback *callback) {
+  m_core->SetupSharedMemory(universe_count, callback);
+}
+
 void OlaClient::FetchDMX(unsigned int universe, DMXCallback *callback) {
   m_core->FetchDMX(universe, callback);
 }
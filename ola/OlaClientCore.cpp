@@ -35,6 +35,7 @@
 #include "ola/Logging.h"
 #include "ola/OlaClientCore.h"
 #include "ola/client/ClientTypes.h"
+#include "ola/dmx/DeltaEncoder.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMEnums.h"
@@ -43,6 +44,7 @@
 namespace ola {
 namespace client {
 
+using ola::dmx::SharedDmxRegion;
 using ola::io::ConnectedDescriptor;
 using ola::proto::OlaServerService_Stub;
 using ola::rdm::UID;
@@ -102,6 +104,9 @@ bool OlaClientCore::Stop() {
     m_descriptor->Close();
     m_channel.reset();
     m_stub.reset();
+    m_shm_send.reset();
+    m_shm_receive.reset();
+    m_received_frames.clear();
   }
   m_connected = false;
   return 0;
@@ -469,6 +474,19 @@ void OlaClientCore::RegisterUniverse(unsigned int universe,
 void OlaClientCore::SendDMX(unsigned int universe,
                             const DmxBuffer &data,
                             const SendDMXArgs &args) {
+  if (!args.callback && m_connected &&
+      WriteSharedMemory(universe, args.priority, data)) {
+    SharedMemoryWritten();
+    return;
+  }
+
+  if (!args.callback && m_connected && m_channel->PeerSupportsDmxFrames()) {
+    // stream data using the compact encoding
+    m_channel->SendDmxFrame(universe, args.priority, data.GetRaw(),
+                            data.Size());
+    return;
+  }
+
   ola::proto::DmxData request;
   request.set_universe(universe);
   request.set_data(data.Get());
@@ -495,6 +513,62 @@ void OlaClientCore::SendDMX(unsigned int universe,
   }
 }
 
+void OlaClientCore::SendDmxBatch(const DmxBatch &batch) {
+  if (!m_connected) {
+    return;
+  }
+
+  // Servers that don't advertise batches get a message per universe.
+  const bool use_batch = m_channel->PeerSupportsDmxBatches();
+  bool shared_memory_written = false;
+  ola::proto::DmxDataBatch request;
+  DmxBatch::const_iterator iter = batch.begin();
+  for (; iter != batch.end(); ++iter) {
+    if (WriteSharedMemory(iter->universe, iter->priority, iter->data)) {
+      shared_memory_written = true;
+    } else if (use_batch) {
+      ola::proto::DmxData *data = request.add_data();
+      data->set_universe(iter->universe);
+      data->set_data(iter->data.Get());
+      data->set_priority(iter->priority);
+    } else {
+      SendDMXArgs args;
+      args.priority = iter->priority;
+      SendDMX(iter->universe, iter->data, args);
+    }
+  }
+
+  if (shared_memory_written) {
+    SharedMemoryWritten();
+  }
+  if (use_batch && request.data_size()) {
+    m_stub->StreamDmxBatch(NULL, &request, NULL, NULL);
+  }
+}
+
+void OlaClientCore::SetupSharedMemory(unsigned int universe_count,
+                                      SetCallback *callback) {
+  ola::proto::SharedMemoryRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::SharedMemoryReply *reply = new ola::proto::SharedMemoryReply();
+
+  request.set_universe_count(universe_count);
+
+  if (!m_connected) {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleSharedMemory(controller, reply, callback);
+  } else if (!SharedDmxRegion::Supported()) {
+    controller->SetFailed("Shared memory isn't supported");
+    HandleSharedMemory(controller, reply, callback);
+  } else {
+    CompletionCallback *cb = NewSingleCallback(
+        this,
+        &OlaClientCore::HandleSharedMemory,
+        controller, reply, callback);
+    m_stub->SetupSharedMemory(controller, &request, reply, cb);
+  }
+}
+
 void OlaClientCore::FetchDMX(unsigned int universe,
                              DMXCallback *callback) {
   ola::proto::UniverseRequest request;
@@ -639,6 +713,90 @@ void OlaClientCore::UpdateDmxData(ola::rpc::RpcController*,
   done->Run();
 }
 
+void OlaClientCore::DmxFrameReceived(ola::rpc::RpcController*,
+                                     unsigned int universe,
+                                     uint8_t priority,
+                                     const uint8_t *data,
+                                     unsigned int length) {
+  DmxBuffer &buffer = m_received_frames[universe];
+  if (length) {
+    buffer.Set(data, length);
+  } else {
+    buffer.Reset();
+  }
+
+  if (m_dmx_callback.get()) {
+    DMXMetadata metadata(universe, priority);
+    m_dmx_callback->Run(metadata, buffer);
+  }
+}
+
+void OlaClientCore::DmxDeltaReceived(ola::rpc::RpcController*,
+                                     unsigned int universe,
+                                     uint8_t priority,
+                                     unsigned int length,
+                                     const uint8_t *delta,
+                                     unsigned int delta_size) {
+  std::map<unsigned int, DmxBuffer>::iterator iter =
+      m_received_frames.find(universe);
+  if (iter == m_received_frames.end() || iter->second.Size() != length) {
+    // Wait for the next full frame.
+    return;
+  }
+
+  ola::dmx::DeltaEncoder encoder;
+  if (!encoder.Decode(delta, delta_size, &iter->second)) {
+    OLA_WARN << "Invalid DMX delta for universe " << universe;
+    return;
+  }
+
+  if (m_dmx_callback.get()) {
+    DMXMetadata metadata(universe, priority);
+    m_dmx_callback->Run(metadata, iter->second);
+  }
+}
+
+void OlaClientCore::SharedMemoryUpdated(ola::rpc::RpcController*,
+                                        const ola::proto::SharedMemoryUpdate*,
+                                        ola::proto::STREAMING_NO_RESPONSE*,
+                                        CompletionCallback*) {
+  if (!m_shm_receive.get()) {
+    return;
+  }
+
+  // Anything the server writes after this point triggers another update.
+  m_shm_receive->ClearPending();
+
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  const unsigned int slots_used = m_shm_receive->SlotsUsed();
+  for (unsigned int i = 0; i < slots_used; i++) {
+    unsigned int universe, length;
+    uint8_t priority;
+    if (m_shm_receive->ReadSlot(i, &universe, &priority, data, &length) &&
+        m_dmx_callback.get()) {
+      DmxBuffer buffer(data, length);
+      DMXMetadata metadata(universe, priority);
+      m_dmx_callback->Run(metadata, buffer);
+    }
+  }
+}
+
+bool OlaClientCore::WriteSharedMemory(unsigned int universe,
+                                      uint8_t priority,
+                                      const DmxBuffer &data) {
+  return m_shm_send.get() &&
+      m_shm_send->Write(universe, priority, data.GetRaw(), data.Size());
+}
+
+void OlaClientCore::SharedMemoryWritten() {
+  // If the server hasn't read the last update yet, it'll pick this one up at
+  // the same time.
+  if (m_shm_send->SetPending()) {
+    ola::proto::SharedMemoryUpdate update;
+    m_stub->SharedMemoryUpdated(NULL, &update, NULL, NULL);
+  }
+}
+
 void OlaClientCore::ChannelClosed(ClosedCallback *callback,
                                   OLA_UNUSED ola::rpc::RpcSession *session) {
   callback->Run();
@@ -792,6 +950,34 @@ void OlaClientCore::HandleAck(RpcController *controller_ptr,
   callback->Run(result);
 }
 
+void OlaClientCore::HandleSharedMemory(RpcController *controller_ptr,
+                                       ola::proto::SharedMemoryReply *reply_ptr,
+                                       SetCallback *callback) {
+  auto_ptr<RpcController> controller(controller_ptr);
+  auto_ptr<ola::proto::SharedMemoryReply> reply(reply_ptr);
+
+  string error;
+  if (controller->Failed()) {
+    error = controller->ErrorText();
+  } else {
+    m_shm_send.reset(SharedDmxRegion::Open(reply->input_name()));
+    m_shm_receive.reset(SharedDmxRegion::Open(reply->output_name()));
+    // Nothing else needs to open the regions, so remove the names now.
+    SharedDmxRegion::Unlink(reply->input_name());
+    SharedDmxRegion::Unlink(reply->output_name());
+
+    if (!m_shm_send.get() || !m_shm_receive.get()) {
+      m_shm_send.reset();
+      m_shm_receive.reset();
+      error = "Failed to open shared memory";
+    }
+  }
+
+  if (callback) {
+    callback->Run(Result(error));
+  }
+}
+
 void OlaClientCore::HandleGeneralAck(RpcController *controller_ptr,
                                      ola::proto::Ack *reply_ptr,
                                      GeneralSetCallback *callback) {
@@ -21,9 +21,11 @@
 #ifndef OLA_OLACLIENTCORE_H_
 #define OLA_OLACLIENTCORE_H_
 
+#include <map>
 #include <memory>
 #include <string>
 
+#include "common/dmx/SharedDmxRegion.h"
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
 #include "common/rpc/RpcChannel.h"
@@ -246,6 +248,24 @@ class OlaClientCore: public ola::proto::OlaClientService {
                const DmxBuffer &data,
                const SendDMXArgs &args);
 
+  /**
+   * @brief Send DMX data for many universes in a single message.
+   * @param batch the universes and their data.
+   */
+  void SendDmxBatch(const DmxBatch &batch);
+
+  /**
+   * @brief Exchange DMX data with the server using shared memory.
+   * @param universe_count the number of universes to allocate space for, in
+   *   each direction.
+   * @param callback the SetCallback to invoke upon completion.
+   *
+   * Once this completes, streamed DMX data and the data for registered
+   * universes is passed through shared memory. Universes that don't fit are
+   * sent over the socket as before.
+   */
+  void SetupSharedMemory(unsigned int universe_count, SetCallback *callback);
+
   /**
    * @brief Fetch the latest DMX data for a universe.
    * @param universe the universe id to get data for.
@@ -322,15 +342,77 @@ class OlaClientCore: public ola::proto::OlaClientService {
                      ola::proto::Ack* response,
                      CompletionCallback* done);
 
+  /**
+   * @brief The server streams DMX data to us as compact frames.
+   */
+  bool SupportsDmxFrames() const { return true; }
+
+  /**
+   * @brief This is called by the channel when a compact DMX frame arrives.
+   */
+  void DmxFrameReceived(ola::rpc::RpcController *controller,
+                        unsigned int universe,
+                        uint8_t priority,
+                        const uint8_t *data,
+                        unsigned int length);
+
+  /**
+   * @brief The server may send only the slots that changed.
+   */
+  bool SupportsDmxDeltas() const { return true; }
+
+  /**
+   * @brief This is called by the channel when a DMX delta arrives.
+   */
+  void DmxDeltaReceived(ola::rpc::RpcController *controller,
+                        unsigned int universe,
+                        uint8_t priority,
+                        unsigned int length,
+                        const uint8_t *delta,
+                        unsigned int delta_size);
+
+  /**
+   * @brief This is called by the channel when the server has written to the
+   *   shared memory region.
+   */
+  void SharedMemoryUpdated(ola::rpc::RpcController* controller,
+                           const ola::proto::SharedMemoryUpdate* request,
+                           ola::proto::STREAMING_NO_RESPONSE* response,
+                           CompletionCallback* done);
+
  private:
   ola::io::ConnectedDescriptor *m_descriptor;
   std::auto_ptr<RepeatableDMXCallback> m_dmx_callback;
   std::auto_ptr<ola::rpc::RpcChannel> m_channel;
   std::auto_ptr<ola::proto::OlaServerService_Stub> m_stub;
   int m_connected;
+  // The regions we write to and read from, if shared memory is in use.
+  std::auto_ptr<ola::dmx::SharedDmxRegion> m_shm_send;
+  std::auto_ptr<ola::dmx::SharedDmxRegion> m_shm_receive;
+  // The last frame received for each universe, deltas are applied to these.
+  std::map<unsigned int, DmxBuffer> m_received_frames;
 
   void ChannelClosed(ClosedCallback *callback, ola::rpc::RpcSession *session);
 
+  /**
+   * @brief Write a universe to the shared memory region.
+   * @returns false if shared memory isn't in use or the region is full.
+   */
+  bool WriteSharedMemory(unsigned int universe, uint8_t priority,
+                         const DmxBuffer &data);
+
+  /**
+   * @brief Tell the server we've written to the shared memory region.
+   */
+  void SharedMemoryWritten();
+
+  /**
+   * @brief Called when SetupSharedMemory() completes.
+   */
+  void HandleSharedMemory(ola::rpc::RpcController *controller,
+                          ola::proto::SharedMemoryReply *reply,
+                          SetCallback *callback);
+
   /**
    * @brief Called when GetPlugins() completes.
    */
@@ -21,46 +21,71 @@
 #include <ola/AutoStart.h>  // NOLINT(build/include)
 // ola/StreamingClient.h deprecated
 #include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/client/StreamingClient.h>
 #include <ola/io/SelectServer.h>
 #include <ola/network/IPV4Address.h>
+#include <ola/network/LocalSocket.h>
 #include <ola/network/SocketAddress.h>
 #include <ola/network/TCPSocket.h>
 
+#include "common/dmx/SharedDmxRegion.h"
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
 #include "common/rpc/RpcChannel.h"
+#include "common/rpc/RpcController.h"
 #include "common/rpc/RpcSession.h"
 
 namespace ola {
 namespace client {
 
+using ola::dmx::SharedDmxRegion;
 using ola::io::SelectServer;
+using ola::network::LocalSocket;
 using ola::network::TCPSocket;
 using ola::proto::OlaServerService_Stub;
 using ola::rpc::RpcChannel;
+using ola::rpc::RpcController;
+
+namespace {
+// How long to wait for olad to set up shared memory, in seconds.
+const int SHARED_MEMORY_TIMEOUT = 2;
+
+void SetComplete(bool *complete) {
+  *complete = true;
+}
+}  // namespace
 
 StreamingClient::StreamingClient(bool auto_start)
     : m_auto_start(auto_start),
       m_server_port(OLA_DEFAULT_PORT),
+      m_use_shared_memory(false),
+      m_shared_memory_universes(0),
+      m_use_delta_frames(false),
       m_socket(NULL),
       m_ss(NULL),
       m_channel(NULL),
       m_stub(NULL),
-      m_socket_closed(false) {
+      m_socket_closed(false),
+      m_shm_send(NULL) {
 }
 
 StreamingClient::StreamingClient(const Options &options)
     : m_auto_start(options.auto_start),
       m_server_port(options.server_port),
+      m_server_socket(options.server_socket),
+      m_use_shared_memory(options.use_shared_memory),
+      m_shared_memory_universes(options.shared_memory_universes),
+      m_use_delta_frames(options.use_delta_frames),
       m_socket(NULL),
       m_ss(NULL),
       m_channel(NULL),
       m_stub(NULL),
-      m_socket_closed(false) {
+      m_socket_closed(false),
+      m_shm_send(NULL) {
 }
 
 StreamingClient::~StreamingClient() {
@@ -71,7 +96,9 @@ bool StreamingClient::Setup() {
   if (m_socket || m_channel || m_stub)
     return false;
 
-  if (m_auto_start)
+  if (!m_server_socket.empty())
+    m_socket = LocalSocket::Connect(m_server_socket);
+  else if (m_auto_start)
     m_socket = ola::client::ConnectToServer(m_server_port);
   else
     m_socket = TCPSocket::Connect(
@@ -105,10 +132,21 @@ bool StreamingClient::Setup() {
   m_channel->SetChannelCloseHandler(
       NewSingleCallback(this, &StreamingClient::ChannelClosed));
 
+  if (m_use_delta_frames) {
+    m_channel->EnableDmxDeltas();
+  }
+
+  if (m_use_shared_memory && !SetupSharedMemory()) {
+    Stop();
+    return false;
+  }
   return true;
 }
 
 void StreamingClient::Stop() {
+  if (m_shm_send)
+    delete m_shm_send;
+
   if (m_stub)
     delete m_stub;
 
@@ -125,6 +163,7 @@ void StreamingClient::Stop() {
   m_socket = NULL;
   m_ss = NULL;
   m_stub = NULL;
+  m_shm_send = NULL;
 }
 
 bool StreamingClient::SendDmx(unsigned int universe,
@@ -138,8 +177,80 @@ bool StreamingClient::SendDMX(unsigned int universe,
   return Send(universe, args.priority, data);
 }
 
+bool StreamingClient::SendDmxBatch(const DmxBatch &batch) {
+  if (!CheckConnection())
+    return false;
+
+  // Servers that don't advertise batches get a message per universe. Deltas
+  // are only sent as individual frames, since they're relative to the last
+  // frame the channel sent.
+  if (m_channel->PeerSupportsDmxBatches() && !m_use_delta_frames) {
+    bool shared_memory_written = false;
+    ola::proto::DmxDataBatch request;
+    DmxBatch::const_iterator iter = batch.begin();
+    for (; iter != batch.end(); ++iter) {
+      if (WriteSharedMemory(iter->universe, iter->priority, iter->data)) {
+        shared_memory_written = true;
+        continue;
+      }
+      ola::proto::DmxData *data = request.add_data();
+      data->set_universe(iter->universe);
+      data->set_data(iter->data.Get());
+      data->set_priority(iter->priority);
+    }
+
+    if (shared_memory_written) {
+      SharedMemoryWritten();
+    }
+    if (request.data_size()) {
+      m_stub->StreamDmxBatch(NULL, &request, NULL, NULL);
+    }
+  } else {
+    bool shared_memory_written = false;
+    DmxBatch::const_iterator iter = batch.begin();
+    for (; iter != batch.end() && !m_socket_closed; ++iter) {
+      if (WriteSharedMemory(iter->universe, iter->priority, iter->data)) {
+        shared_memory_written = true;
+      } else {
+        StreamUniverse(iter->universe, iter->priority, iter->data);
+      }
+    }
+
+    if (shared_memory_written && !m_socket_closed) {
+      SharedMemoryWritten();
+    }
+  }
+
+  if (m_socket_closed) {
+    Stop();
+    return false;
+  }
+  return true;
+}
+
 bool StreamingClient::Send(unsigned int universe, uint8_t priority,
                            const DmxBuffer &data) {
+  if (!CheckConnection())
+    return false;
+
+  if (WriteSharedMemory(universe, priority, data)) {
+    SharedMemoryWritten();
+  } else {
+    StreamUniverse(universe, priority, data);
+  }
+
+  if (m_socket_closed) {
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Check the connection to the server is still open, this also processes any
+ * messages from the server.
+ */
+bool StreamingClient::CheckConnection() {
   if (!m_stub || !m_socket->ValidReadDescriptor())
     return false;
 
@@ -153,20 +264,96 @@ bool StreamingClient::Send(unsigned int universe, uint8_t priority,
     Stop();
     return false;
   }
+  return true;
+}
 
-  ola::proto::DmxData request;
-  request.set_universe(universe);
-  request.set_data(data.Get());
-  request.set_priority(priority);
-  m_stub->StreamDmxData(NULL, &request, NULL, NULL);
+/*
+ * Ask olad for a shared memory region and wait for the reply. If olad can't
+ * provide one, we keep using the socket.
+ * @returns false if the connection to the server failed.
+ */
+bool StreamingClient::SetupSharedMemory() {
+  if (!SharedDmxRegion::Supported()) {
+    OLA_WARN << "Shared memory isn't supported, using the socket instead";
+    return true;
+  }
+
+  RpcController controller;
+  ola::proto::SharedMemoryRequest request;
+  ola::proto::SharedMemoryReply reply;
+  bool complete = false;
+  request.set_universe_count(m_shared_memory_universes);
+  m_stub->SetupSharedMemory(&controller, &request, &reply,
+                            NewSingleCallback(SetComplete, &complete));
+
+  Clock clock;
+  TimeStamp start, now;
+  clock.CurrentMonotonicTime(&start);
+  const TimeInterval timeout(SHARED_MEMORY_TIMEOUT, 0);
+  m_socket_closed = false;
+  while (!complete && !m_socket_closed) {
+    clock.CurrentMonotonicTime(&now);
+    if (now - start > timeout) {
+      // The response refers to the controller and reply, so the caller has
+      // to close the channel.
+      OLA_WARN << "Timed out waiting for the shared memory response";
+      return false;
+    }
+    m_ss->RunOnce(TimeInterval(0, 100000));
+  }
 
   if (m_socket_closed) {
-    Stop();
     return false;
   }
+
+  if (controller.Failed()) {
+    OLA_WARN << "Failed to set up shared memory: " << controller.ErrorText()
+             << ", using the socket instead";
+    return true;
+  }
+
+  m_shm_send = SharedDmxRegion::Open(reply.input_name());
+  // We never read from the server, and nothing else needs to open the
+  // regions, so remove the names now.
+  SharedDmxRegion::Unlink(reply.input_name());
+  SharedDmxRegion::Unlink(reply.output_name());
+  if (!m_shm_send) {
+    OLA_WARN << "Failed to open shared memory, using the socket instead";
+  }
   return true;
 }
 
+bool StreamingClient::WriteSharedMemory(unsigned int universe,
+                                        uint8_t priority,
+                                        const DmxBuffer &data) {
+  return m_shm_send &&
+      m_shm_send->Write(universe, priority, data.GetRaw(), data.Size());
+}
+
+/*
+ * Tell the server there is new data in the shared memory region, unless it's
+ * already been told and hasn't read the region yet.
+ */
+void StreamingClient::SharedMemoryWritten() {
+  if (m_shm_send->SetPending()) {
+    ola::proto::SharedMemoryUpdate update;
+    m_stub->SharedMemoryUpdated(NULL, &update, NULL, NULL);
+  }
+}
+
+void StreamingClient::StreamUniverse(unsigned int universe, uint8_t priority,
+                                     const DmxBuffer &data) {
+  if (m_channel->PeerSupportsDmxFrames()) {
+    m_channel->SendDmxFrame(universe, priority, data.GetRaw(), data.Size());
+  } else {
+    ola::proto::DmxData request;
+    request.set_universe(universe);
+    request.set_data(data.Get());
+    request.set_priority(priority);
+    m_stub->StreamDmxData(NULL, &request, NULL, NULL);
+  }
+}
+
 void StreamingClient::ChannelClosed(OLA_UNUSED ola::rpc::RpcSession *session) {
   m_socket_closed = true;
   OLA_WARN << "The RPC socket has been closed, this is more than likely due"
@@ -56,6 +56,7 @@
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
+#include "olad/plugin_api/OutputWorkerPool.h"
 #include "olad/plugin_api/PortManager.h"
 #include "olad/plugin_api/UniverseStore.h"
 
@@ -65,6 +66,15 @@
 
 DEFINE_s_uint16(rpc_port, r, ola::OlaServer::DEFAULT_RPC_PORT,
                 "The port to listen for RPCs on. Defaults to 9010.");
+DEFINE_string(rpc_socket, "",
+              "Also listen for RPCs on a local socket at this path.");
+DEFINE_string(rpc_socket_group, "",
+              "The group allowed to connect to the RPC socket. By default "
+              "only the user olad runs as can connect.");
+DEFINE_uint16(rpc_dmx_keyframe_interval, 0,
+              "If non-zero, send DMX to clients that support it as the "
+              "changes from the previous frame, with a full frame at least "
+              "this often.");
 DEFINE_default_bool(register_with_dns_sd, true,
                     "Don't register the web service using DNS-SD (Bonjour).");
 
@@ -137,6 +147,7 @@ OlaServer::~OlaServer() {
     m_universe_store->DeleteAll();
     m_universe_store.reset();
   }
+  m_output_workers.reset();
 
   if (m_server_preferences) {
     m_server_preferences->Save();
@@ -209,8 +220,21 @@ bool OlaServer::Init() {
       UNIVERSE_PREFERENCES);
   universe_preferences->Load();
 
+  // The universes must be deleted before the workers are stopped.
+  auto_ptr<OutputWorkerPool> output_workers;
+  if (m_options.output_workers) {
+    output_workers.reset(new OutputWorkerPool(m_options.output_workers));
+    if (!output_workers->Start()) {
+      OLA_WARN << "Failed to start the output workers";
+      return false;
+    }
+    OLA_INFO << "Writing to output ports from " << m_options.output_workers
+             << " worker threads";
+  }
+
   auto_ptr<UniverseStore> universe_store(
-      new UniverseStore(universe_preferences, m_export_map));
+      new UniverseStore(universe_preferences, m_export_map, m_ss));
+  universe_store->SetOutputWorkerPool(output_workers.get());
 
   auto_ptr<PortBroker> port_broker(new PortBroker());
 
@@ -244,6 +268,9 @@ bool OlaServer::Init() {
   rpc_options.listen_socket = m_accepting_socket;
   rpc_options.listen_port = FLAGS_rpc_port;
   rpc_options.export_map = m_export_map;
+  rpc_options.socket_path = FLAGS_rpc_socket.str();
+  rpc_options.socket_group = FLAGS_rpc_socket_group.str();
+  rpc_options.dmx_keyframe_interval = FLAGS_rpc_dmx_keyframe_interval;
 
   auto_ptr<ola::rpc::RpcServer> rpc_server(
       new RpcServer(m_ss, service_impl.get(), this, rpc_options));
@@ -300,6 +327,7 @@ bool OlaServer::Init() {
   m_discovery_agent.reset(discovery_agent.release());
   m_plugin_adaptor.reset(plugin_adaptor.release());
   m_plugin_manager.reset(plugin_manager.release());
+  m_output_workers.reset(output_workers.release());
   m_port_broker.reset(port_broker.release());
   m_port_manager.reset(port_manager.release());
   m_rpc_server.reset(rpc_server.release());
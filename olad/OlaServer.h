@@ -72,6 +72,11 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
     std::string http_data_dir;
     std::string network_interface;
     std::string pid_data_dir;  /** @brief Directory with the PID definitions */
+    /**
+     * @brief The number of threads to write thread safe output ports from,
+     * or 0 to write all ports from the main thread.
+     */
+    unsigned int output_workers;
   };
 
   /**
@@ -185,6 +190,7 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   std::auto_ptr<class DeviceManager> m_device_manager;
   std::auto_ptr<class PluginManager> m_plugin_manager;
   std::auto_ptr<class PluginAdaptor> m_plugin_adaptor;
+  std::auto_ptr<class OutputWorkerPool> m_output_workers;
   std::auto_ptr<class UniverseStore> m_universe_store;
   std::auto_ptr<class PortManager> m_port_manager;
   std::auto_ptr<class OlaServerServiceImpl> m_service_impl;
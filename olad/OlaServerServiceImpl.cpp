@@ -19,13 +19,19 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <unistd.h>
+
 #include <algorithm>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
+#include "common/dmx/SharedDmxRegion.h"
 #include "common/protocol/Ola.pb.h"
 #include "common/rpc/RpcSession.h"
 #include "ola/Callback.h"
 #include "ola/CallbackRunner.h"
+#include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
 #include "ola/rdm/RDMCommand.h"
@@ -49,6 +55,7 @@
 namespace ola {
 
 using ola::CallbackRunner;
+using ola::dmx::SharedDmxRegion;
 using ola::proto::Ack;
 using ola::proto::DeviceConfigReply;
 using ola::proto::DeviceConfigRequest;
@@ -75,6 +82,7 @@ using ola::rdm::RDMResponse;
 using ola::rdm::UID;
 using ola::rdm::UIDSet;
 using ola::rpc::RpcController;
+using std::auto_ptr;
 using std::string;
 using std::vector;
 
@@ -124,7 +132,8 @@ OlaServerServiceImpl::OlaServerServiceImpl(
       m_port_manager(port_manager),
       m_broker(broker),
       m_wake_up_time(wake_up_time),
-      m_reload_plugins_callback(reload_plugins_callback) {
+      m_reload_plugins_callback(reload_plugins_callback),
+      m_shared_memory_count(0) {
 }
 
 void OlaServerServiceImpl::GetDmx(
@@ -171,24 +180,15 @@ void OlaServerServiceImpl::UpdateDmxData(
   ClosureRunner runner(done);
   Universe *universe = m_universe_store->GetUniverse(request->universe());
   if (!universe) {
+    GetClient(controller)->DiscardSourceData(request->universe());
     return MissingUniverseError(controller);
   }
 
-  Client *client = GetClient(controller);
-  DmxBuffer buffer;
-  buffer.Set(request->data());
-
-  uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
-  if (request->has_priority()) {
-    priority = request->priority();
-    priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
-                        priority);
-    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
-                        priority);
-  }
-  DmxSource source(buffer, *m_wake_up_time, priority);
-  client->DMXReceived(request->universe(), source);
-  universe->SourceClientDataChanged(client);
+  const string &data = request->data();
+  DmxDataReceived(universe, GetClient(controller),
+                  reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+                  request->has_priority() ? request->priority() :
+                      ola::dmx::SOURCE_PRIORITY_DEFAULT);
 }
 
 void OlaServerServiceImpl::StreamDmxData(
@@ -199,26 +199,166 @@ void OlaServerServiceImpl::StreamDmxData(
   Universe *universe = m_universe_store->GetUniverse(request->universe());
 
   if (!universe) {
+    GetClient(controller)->DiscardSourceData(request->universe());
+    return;
+  }
+
+  const string &data = request->data();
+  DmxDataReceived(universe, GetClient(controller),
+                  reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+                  request->has_priority() ? request->priority() :
+                      ola::dmx::SOURCE_PRIORITY_DEFAULT);
+}
+
+void OlaServerServiceImpl::StreamDmxBatch(
+    RpcController *controller,
+    const ola::proto::DmxDataBatch* request,
+    ola::proto::STREAMING_NO_RESPONSE*,
+    ola::rpc::RpcService::CompletionCallback*) {
+  Client *client = GetClient(controller);
+
+  for (int i = 0; i < request->data_size(); i++) {
+    const DmxData &universe_data = request->data(i);
+    Universe *universe = m_universe_store->GetUniverse(
+        universe_data.universe());
+    if (!universe) {
+      client->DiscardSourceData(universe_data.universe());
+      continue;
+    }
+
+    const string &data = universe_data.data();
+    DmxDataReceived(universe, client,
+                    reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+                    universe_data.has_priority() ? universe_data.priority() :
+                        ola::dmx::SOURCE_PRIORITY_DEFAULT);
+  }
+}
+
+void OlaServerServiceImpl::DmxFrameReceived(RpcController *controller,
+                                            unsigned int universe_id,
+                                            uint8_t priority,
+                                            const uint8_t *data,
+                                            unsigned int length) {
+  Universe *universe = m_universe_store->GetUniverse(universe_id);
+
+  if (!universe) {
+    GetClient(controller)->DiscardSourceData(universe_id);
+    return;
+  }
+
+  DmxDataReceived(universe, GetClient(controller), data, length, priority);
+}
+
+void OlaServerServiceImpl::DmxDeltaReceived(RpcController *controller,
+                                            unsigned int universe_id,
+                                            uint8_t priority,
+                                            unsigned int length,
+                                            const uint8_t *delta,
+                                            unsigned int delta_size) {
+  Universe *universe = m_universe_store->GetUniverse(universe_id);
+
+  if (!universe) {
+    GetClient(controller)->DiscardSourceData(universe_id);
     return;
   }
 
+  priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
+                      priority);
+  priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
+                      priority);
+
+  // The client copies the patched frame into its existing buffer, so nothing
+  // is allocated per delta.
   Client *client = GetClient(controller);
-  DmxBuffer buffer;
-  buffer.Set(request->data());
-
-  uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
-  if (request->has_priority()) {
-    priority = request->priority();
-    priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
-                        priority);
-    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
-                        priority);
+  if (!client->DMXDeltaReceived(universe_id, length, delta, delta_size,
+                                *m_wake_up_time, priority)) {
+    OLA_DEBUG << "Ignoring DMX delta for universe " << universe_id
+              << " until the next full frame";
+    return;
   }
-  DmxSource source(buffer, *m_wake_up_time, priority);
-  client->DMXReceived(request->universe(), source);
   universe->SourceClientDataChanged(client);
 }
 
+void OlaServerServiceImpl::SetupSharedMemory(
+    RpcController* controller,
+    const ola::proto::SharedMemoryRequest* request,
+    ola::proto::SharedMemoryReply* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  if (!SharedDmxRegion::Supported()) {
+    controller->SetFailed("Shared memory isn't supported");
+    return;
+  }
+
+  // The regions are only useful to clients on this host, and each one uses
+  // a few MB, so don't let remote clients create them.
+  if (!controller->Session()->IsLocal()) {
+    controller->SetFailed("Shared memory is only available to local clients");
+    return;
+  }
+
+  Client *client = GetClient(controller);
+  if (client->SharedMemoryInput()) {
+    controller->SetFailed("Shared memory is already set up");
+    return;
+  }
+
+  unsigned int universe_count = std::min(request->universe_count(),
+                                         SharedDmxRegion::MAX_SLOT_COUNT);
+  std::ostringstream prefix;
+  prefix << "/ola-" << getpid() << "-" << m_shared_memory_count++;
+  const string input_name = prefix.str() + "-in";
+  const string output_name = prefix.str() + "-out";
+
+  auto_ptr<SharedDmxRegion> input(
+      SharedDmxRegion::Create(input_name, universe_count));
+  auto_ptr<SharedDmxRegion> output(
+      SharedDmxRegion::Create(output_name, universe_count));
+  if (!input.get() || !output.get()) {
+    controller->SetFailed("Failed to create shared memory");
+    return;
+  }
+
+  // The client unlinks the names once it's opened the regions, otherwise
+  // they're removed when the client disconnects.
+  client->SetSharedMemory(input.release(), output.release());
+  response->set_input_name(input_name);
+  response->set_output_name(output_name);
+  response->set_universe_count(universe_count);
+}
+
+void OlaServerServiceImpl::SharedMemoryUpdated(
+    RpcController *controller,
+    const ola::proto::SharedMemoryUpdate*,
+    ola::proto::STREAMING_NO_RESPONSE*,
+    ola::rpc::RpcService::CompletionCallback*) {
+  Client *client = GetClient(controller);
+  SharedDmxRegion *region = client->SharedMemoryInput();
+  if (!region) {
+    return;
+  }
+
+  // Anything the client writes after this point triggers another update.
+  region->ClearPending();
+
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  const unsigned int slots_used = region->SlotsUsed();
+  for (unsigned int i = 0; i < slots_used; i++) {
+    unsigned int universe_id, length;
+    uint8_t priority;
+    if (!region->ReadSlot(i, &universe_id, &priority, data, &length)) {
+      continue;
+    }
+
+    Universe *universe = m_universe_store->GetUniverse(universe_id);
+    if (universe) {
+      DmxDataReceived(universe, client, data, length, priority);
+    } else {
+      client->DiscardSourceData(universe_id);
+    }
+  }
+}
+
 void OlaServerServiceImpl::SetUniverseName(
     RpcController* controller,
     const UniverseNameRequest* request,
@@ -937,6 +1077,27 @@ void OlaServerServiceImpl::RDMDiscoveryComplete(
 }
 
 
+/*
+ * Copy the slot data from a client into the client's source for the universe
+ * and trigger a merge. The slots are copied straight into the buffer the
+ * client already holds, and the merge works on references, so no memory is
+ * allocated for each frame.
+ */
+void OlaServerServiceImpl::DmxDataReceived(Universe *universe,
+                                           Client *client,
+                                           const uint8_t *data,
+                                           unsigned int length,
+                                           uint8_t priority) {
+  priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
+                      priority);
+  priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
+                      priority);
+
+  client->DMXReceived(universe->UniverseId(), data, length, *m_wake_up_time,
+                      priority);
+  universe->SourceClientDataChanged(client);
+}
+
 void OlaServerServiceImpl::MissingUniverseError(RpcController* controller) {
   controller->SetFailed("Universe doesn't exist");
 }
@@ -99,6 +99,65 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                      ::ola::proto::STREAMING_NO_RESPONSE* response,
                      ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Handle a batch of streaming DMX updates, no response is sent.
+   */
+  void StreamDmxBatch(ola::rpc::RpcController* controller,
+                      const ::ola::proto::DmxDataBatch* request,
+                      ::ola::proto::STREAMING_NO_RESPONSE* response,
+                      ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief We implement StreamDmxBatch.
+   */
+  bool SupportsDmxBatches() const { return true; }
+
+  /**
+   * @brief We accept compact DMX frames from streaming clients.
+   */
+  bool SupportsDmxFrames() const { return true; }
+
+  /**
+   * @brief Handle a compact DMX frame, this is equivalent to StreamDmxData.
+   */
+  void DmxFrameReceived(ola::rpc::RpcController *controller,
+                        unsigned int universe_id,
+                        uint8_t priority,
+                        const uint8_t *data,
+                        unsigned int length);
+
+  /**
+   * @brief We accept DMX deltas from streaming clients.
+   */
+  bool SupportsDmxDeltas() const { return true; }
+
+  /**
+   * @brief Handle a DMX delta, the changed ranges are applied to the data
+   *   we already have from the client.
+   */
+  void DmxDeltaReceived(ola::rpc::RpcController *controller,
+                        unsigned int universe_id,
+                        uint8_t priority,
+                        unsigned int length,
+                        const uint8_t *delta,
+                        unsigned int delta_size);
+
+  /**
+   * @brief Create the shared memory regions for a client.
+   */
+  void SetupSharedMemory(ola::rpc::RpcController* controller,
+                         const ola::proto::SharedMemoryRequest* request,
+                         ola::proto::SharedMemoryReply* response,
+                         ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief Read the universes that have changed in a client's shared memory
+   *   region.
+   */
+  void SharedMemoryUpdated(ola::rpc::RpcController* controller,
+                           const ola::proto::SharedMemoryUpdate* request,
+                           ::ola::proto::STREAMING_NO_RESPONSE* response,
+                           ola::rpc::RpcService::CompletionCallback* done);
 
   /**
    * @brief Sets the name of a universe.
@@ -269,6 +328,12 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                             ola::proto::UIDListReply *response,
                             const ola::rdm::UIDSet &uids);
 
+  void DmxDataReceived(Universe *universe,
+                       class Client *client,
+                       const uint8_t *data,
+                       unsigned int length,
+                       uint8_t priority);
+
   void MissingUniverseError(ola::rpc::RpcController* controller);
   void MissingPluginError(ola::rpc::RpcController* controller);
   void MissingDeviceError(ola::rpc::RpcController* controller);
@@ -297,6 +362,7 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
   class ClientBroker *m_broker;
   const class TimeStamp *m_wake_up_time;
   std::auto_ptr<ReloadPluginsCallback> m_reload_plugins_callback;
+  unsigned int m_shared_memory_count;
 };
 }  // namespace ola
 #endif  // OLAD_OLASERVERSERVICEIMPL_H_
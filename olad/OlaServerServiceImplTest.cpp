@@ -33,6 +33,7 @@
 #include "ola/DmxBuffer.h"
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
+#include "ola/dmx/SourcePriorities.h"
 #include "ola/rdm/UID.h"
 #include "ola/testing/TestUtils.h"
 #include "olad/OlaServerServiceImpl.h"
@@ -58,6 +59,7 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetDmx);
   CPPUNIT_TEST(testRegisterForDmx);
   CPPUNIT_TEST(testUpdateDmxData);
+  CPPUNIT_TEST(testStreamDmxBatch);
   CPPUNIT_TEST(testSetUniverseName);
   CPPUNIT_TEST(testSetMergeMode);
   CPPUNIT_TEST_SUITE_END();
@@ -74,6 +76,7 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
     void testGetDmx();
     void testRegisterForDmx();
     void testUpdateDmxData();
+    void testStreamDmxBatch();
     void testSetUniverseName();
     void testSetMergeMode();
 
@@ -422,6 +425,47 @@ void OlaServerServiceImplTest::CallUpdateDmxData(
   service->UpdateDmxData(&controller, &request, &response, closure);
 }
 
+/*
+ * Check the StreamDmxBatch method works
+ */
+void OlaServerServiceImplTest::testStreamDmxBatch() {
+  UniverseStore store(NULL, NULL);
+  ola::TimeStamp time1;
+  m_clock.CurrentMonotonicTime(&time1);
+  ola::Client client(NULL, m_uid);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL,
+                               &time1, NULL);
+
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  Universe *universe2 = store.GetUniverseOrCreate(2);
+  DmxBuffer dmx_data("this is a test");
+  DmxBuffer dmx_data2("different data hmm");
+
+  RpcSession session(NULL);
+  session.SetData(&client);
+  RpcController controller(&session);
+  ola::proto::DmxDataBatch request;
+  ola::proto::DmxData *data = request.add_data();
+  data->set_universe(1);
+  data->set_data(dmx_data.Get());
+  // universe 3 doesn't exist and should be skipped
+  data = request.add_data();
+  data->set_universe(3);
+  data->set_data(dmx_data.Get());
+  data = request.add_data();
+  data->set_universe(2);
+  data->set_data(dmx_data2.Get());
+  data->set_priority(150);
+
+  service.StreamDmxBatch(&controller, &request, NULL, NULL);
+  OLA_ASSERT_EQ(dmx_data, universe1->GetDMX());
+  OLA_ASSERT_EQ(dmx_data2, universe2->GetDMX());
+  OLA_ASSERT_FALSE(store.GetUniverse(3));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_DEFAULT),
+                client.SourceData(1).Priority());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), client.SourceData(2).Priority());
+}
+
 /*
  * Check the SetUniverseName method works
  */
@@ -63,6 +63,9 @@ DEFINE_string(pid_location, "",
               "The directory containing the PID definitions.");
 DEFINE_s_uint16(http_port, p, ola::OlaServer::DEFAULT_HTTP_PORT,
                 "The port to run the HTTP server on. Defaults to 9090.");
+DEFINE_uint16(output_workers, 0,
+              "The number of threads to write DMX to thread safe output "
+              "ports from. Defaults to 0, which writes from the main thread.");
 
 /**
  * This is called by the SelectServer loop to start up the SignalThread. If the
@@ -137,6 +140,7 @@ int main(int argc, char *argv[]) {
   options.http_data_dir = FLAGS_http_data_dir.str();
   options.network_interface = FLAGS_interface.str();
   options.pid_data_dir = FLAGS_pid_location.str();
+  options.output_workers = FLAGS_output_workers;
 
   std::auto_ptr<OlaDaemon> olad(new OlaDaemon(options, &export_map));
   if (!olad.get()) {
@@ -20,10 +20,13 @@
 
 #include <map>
 #include <utility>
+#include "common/dmx/SharedDmxRegion.h"
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
+#include "common/rpc/RpcChannel.h"
 #include "ola/Callback.h"
 #include "ola/Logging.h"
+#include "ola/dmx/DeltaEncoder.h"
 #include "ola/rdm/UID.h"
 #include "ola/stl/STLUtils.h"
 #include "olad/plugin_api/Client.h"
@@ -37,6 +40,7 @@ using std::map;
 Client::Client(ola::proto::OlaClientService_Stub *client_stub,
                const ola::rdm::UID &uid)
     : m_client_stub(client_stub),
+      m_empty_source(),
       m_uid(uid) {
 }
 
@@ -51,6 +55,28 @@ bool Client::SendDMX(unsigned int universe, uint8_t priority,
     return false;
   }
 
+  // With shared memory we only need to tell the client if it's read all the
+  // previous updates. Universes that don't fit in the region fall through to
+  // the socket.
+  if (m_shm_output.get() &&
+      m_shm_output->Write(universe, priority, buffer.GetRaw(),
+                          buffer.Size())) {
+    if (m_shm_output->SetPending()) {
+      ola::proto::SharedMemoryUpdate update;
+      m_client_stub->SharedMemoryUpdated(NULL, &update, NULL, NULL);
+    }
+    return true;
+  }
+
+  // Clients that accept compact frames don't ack them. If the client falls
+  // behind, the channel replaces the frame waiting to be sent with the
+  // latest one rather than building up a backlog.
+  ola::rpc::RpcChannel *channel = m_client_stub->channel();
+  if (channel && channel->PeerSupportsDmxFrames()) {
+    return channel->SendDmxFrame(universe, priority, buffer.GetRaw(),
+                                 buffer.Size());
+  }
+
   RpcController *controller = new RpcController();
   ola::proto::DmxData dmx_data;
   ola::proto::Ack *ack = new ola::proto::Ack();
@@ -68,19 +94,59 @@ bool Client::SendDMX(unsigned int universe, uint8_t priority,
   return true;
 }
 
+void Client::SetSharedMemory(ola::dmx::SharedDmxRegion *input,
+                             ola::dmx::SharedDmxRegion *output) {
+  m_shm_input.reset(input);
+  m_shm_output.reset(output);
+}
+
 void Client::DMXReceived(unsigned int universe, const DmxSource &source) {
   STLReplace(&m_data_map, universe, source);
 }
 
-const DmxSource Client::SourceData(unsigned int universe) const {
+void Client::DMXReceived(unsigned int universe, const uint8_t *data,
+                         unsigned int length, const TimeStamp &timestamp,
+                         uint8_t priority) {
+  // operator[] only allocates the first time we see a universe, after that
+  // the existing buffer is reused.
+  m_data_map[universe].UpdateData(data, length, timestamp, priority);
+  m_delta_bases[universe].Set(data, length);
+}
+
+bool Client::DMXDeltaReceived(unsigned int universe, unsigned int length,
+                              const uint8_t *delta, unsigned int delta_size,
+                              const TimeStamp &timestamp, uint8_t priority) {
+  map<unsigned int, DmxBuffer>::iterator iter = m_delta_bases.find(universe);
+  if (iter == m_delta_bases.end() || iter->second.Size() != length) {
+    // Wait for the next full frame.
+    return false;
+  }
+
+  // The source may have been replaced by an UpdateDmxData call since the
+  // last frame, so the delta is applied to the base and the result copied
+  // over.
+  ola::dmx::DeltaEncoder encoder;
+  if (!encoder.Decode(delta, delta_size, &iter->second)) {
+    return false;
+  }
+  m_data_map[universe].UpdateData(iter->second.GetRaw(), iter->second.Size(),
+                                  timestamp, priority);
+  return true;
+}
+
+void Client::DiscardSourceData(unsigned int universe) {
+  m_data_map.erase(universe);
+  m_delta_bases.erase(universe);
+}
+
+const DmxSource &Client::SourceData(unsigned int universe) const {
   map<unsigned int, DmxSource>::const_iterator iter =
     m_data_map.find(universe);
 
   if (iter != m_data_map.end()) {
     return iter->second;
   } else {
-    DmxSource source;
-    return source;
+    return m_empty_source;
   }
 }
 
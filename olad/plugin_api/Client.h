@@ -21,14 +21,20 @@
 #ifndef OLAD_PLUGIN_API_CLIENT_H_
 #define OLAD_PLUGIN_API_CLIENT_H_
 
+#include <stdint.h>
 #include <map>
 #include <memory>
 #include "common/rpc/RpcController.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
 #include "ola/base/Macro.h"
 #include "ola/rdm/UID.h"
 #include "olad/DmxSource.h"
 
 namespace ola {
+namespace dmx {
+class SharedDmxRegion;
+}
 namespace proto {
 class OlaClientService_Stub;
 class Ack;
@@ -62,11 +68,34 @@ class Client {
    * @param universe_id the universe the DMX data belongs to
    * @param priority the priority of the DMX data
    * @param buffer the DMX data.
-   * @return true if the update was sent, false otherwise
+   * @return true if the update was sent or queued, false otherwise
+   *
+   * If the client has set up shared memory, the update is written to the
+   * output region. Otherwise if the client accepts compact DMX frames, the
+   * update is streamed without an ack, or an UpdateDmxData RPC is sent.
    */
   virtual bool SendDMX(unsigned int universe_id, uint8_t priority,
                        const DmxBuffer &buffer);
 
+  /**
+   * @brief Set the shared memory regions used to exchange DMX data with this
+   *   client.
+   * @param input the region the client writes to, ownership is transferred.
+   * @param output the region we write to, ownership is transferred.
+   *
+   * Any existing regions are deleted.
+   */
+  void SetSharedMemory(ola::dmx::SharedDmxRegion *input,
+                       ola::dmx::SharedDmxRegion *output);
+
+  /**
+   * @brief Return the region this client writes to, or NULL if the client
+   *   hasn't set up shared memory.
+   */
+  ola::dmx::SharedDmxRegion *SharedMemoryInput() {
+    return m_shm_input.get();
+  }
+
   /**
    * @brief Called when this client sends us new data
    * @param universe the id of the universe for the new data
@@ -74,11 +103,59 @@ class Client {
    */
   void DMXReceived(unsigned int universe, const DmxSource &source);
 
+  /**
+   * @brief Called when this client sends us new data.
+   * @param universe the id of the universe for the new data
+   * @param data the DMX slot data.
+   * @param length the number of slots in data.
+   * @param timestamp the time the data was received.
+   * @param priority the priority of the data.
+   *
+   * Unlike the DmxSource version, this copies the slots straight into the
+   * buffer already held for the universe, so once a client is streaming no
+   * memory is allocated per frame.
+   */
+  void DMXReceived(unsigned int universe, const uint8_t *data,
+                   unsigned int length, const TimeStamp &timestamp,
+                   uint8_t priority);
+
+  /**
+   * @brief Called when this client sends us a delta.
+   * @param universe the id of the universe for the new data
+   * @param length the number of slots in the complete frame.
+   * @param delta the changed ranges, see ola::dmx::DeltaEncoder.
+   * @param delta_size the size of the delta.
+   * @param timestamp the time the data was received.
+   * @param priority the priority of the data.
+   * @returns true if the delta was applied, false if we don't have a frame
+   *   of the same size for the universe or the delta was invalid.
+   *
+   * Deltas are relative to the last compact frame or delta, not to data
+   * that arrived by UpdateDmxData or shared memory, since the sender only
+   * tracks what it sent as frames.
+   */
+  bool DMXDeltaReceived(unsigned int universe, unsigned int length,
+                        const uint8_t *delta, unsigned int delta_size,
+                        const TimeStamp &timestamp, uint8_t priority);
+
+  /**
+   * @brief Discard the data received from this client for a universe.
+   * @param universe the id of the universe.
+   *
+   * This is called when the client sends data for a universe that doesn't
+   * exist. Since that data is dropped, we no longer hold the frame the
+   * client's deltas are relative to, so they are ignored until the next full
+   * frame.
+   */
+  void DiscardSourceData(unsigned int universe);
+
   /**
    * @brief Get the most recent DMX data received from this client.
    * @param universe the id of the universe we're interested in
+   * @returns a reference to the DmxSource, which is valid until the next
+   *   call to DMXReceived() for the universe.
    */
-  const DmxSource SourceData(unsigned int universe) const;
+  const DmxSource &SourceData(unsigned int universe) const;
 
   /**
    * @brief Return the UID associated with this client.
@@ -101,7 +178,12 @@ class Client {
 
   std::auto_ptr<class ola::proto::OlaClientService_Stub> m_client_stub;
   std::map<unsigned int, DmxSource> m_data_map;
+  // The frames the client's deltas are relative to.
+  std::map<unsigned int, DmxBuffer> m_delta_bases;
+  const DmxSource m_empty_source;
   ola::rdm::UID m_uid;
+  std::auto_ptr<ola::dmx::SharedDmxRegion> m_shm_input;
+  std::auto_ptr<ola::dmx::SharedDmxRegion> m_shm_output;
 
   DISALLOW_COPY_AND_ASSIGN(Client);
 };
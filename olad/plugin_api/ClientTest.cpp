@@ -47,12 +47,18 @@ class ClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(ClientTest);
   CPPUNIT_TEST(testSendDMX);
   CPPUNIT_TEST(testGetSetDMX);
+  CPPUNIT_TEST(testRawDMXReceived);
+  CPPUNIT_TEST(testDMXDeltaReceived);
+  CPPUNIT_TEST(testDeltaAfterUpdate);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   ClientTest() : m_test_uid(ola::OPEN_LIGHTING_ESTA_CODE, 0) {}
   void testSendDMX();
   void testGetSetDMX();
+  void testRawDMXReceived();
+  void testDMXDeltaReceived();
+  void testDeltaAfterUpdate();
 
  private:
   ola::Clock m_clock;
@@ -142,3 +148,143 @@ void ClientTest::testGetSetDMX() {
   OLA_ASSERT_FALSE(source4.IsSet());
   OLA_ASSERT_DMX_EQUALS(empty, source4.Data());
 }
+
+
+/*
+ * Check that the in-place update works and reuses the client's buffer.
+ */
+void ClientTest::testRawDMXReceived() {
+  Client client(NULL, m_test_uid);
+  const DmxBuffer expected(TEST_DATA);
+  const DmxBuffer expected2(TEST_DATA2);
+
+  ola::TimeStamp timestamp;
+  m_clock.CurrentMonotonicTime(&timestamp);
+
+  client.DMXReceived(TEST_UNIVERSE,
+                     reinterpret_cast<const uint8_t*>(TEST_DATA),
+                     sizeof(TEST_DATA) - 1, timestamp, 100);
+  const ola::DmxSource &source = client.SourceData(TEST_UNIVERSE);
+  OLA_ASSERT(source.IsSet());
+  OLA_ASSERT_DMX_EQUALS(expected, source.Data());
+  OLA_ASSERT_EQ(timestamp, source.Timestamp());
+  OLA_ASSERT_EQ((uint8_t) 100, source.Priority());
+  const uint8_t *slots = source.Data().GetRaw();
+
+  // a second frame should land in the same buffer
+  ola::TimeStamp timestamp2 = timestamp + ola::TimeInterval(0, 25000);
+  client.DMXReceived(TEST_UNIVERSE,
+                     reinterpret_cast<const uint8_t*>(TEST_DATA2),
+                     sizeof(TEST_DATA2) - 1, timestamp2, 120);
+  const ola::DmxSource &source2 = client.SourceData(TEST_UNIVERSE);
+  OLA_ASSERT_EQ(&source, &source2);
+  OLA_ASSERT_EQ(slots, source2.Data().GetRaw());
+  OLA_ASSERT_DMX_EQUALS(expected2, source2.Data());
+  OLA_ASSERT_EQ(timestamp2, source2.Timestamp());
+  OLA_ASSERT_EQ((uint8_t) 120, source2.Priority());
+
+  // other universes are unaffected
+  OLA_ASSERT_FALSE(client.SourceData(TEST_UNIVERSE2).IsSet());
+}
+
+
+/*
+ * Check that deltas are applied to the data we already have.
+ */
+void ClientTest::testDMXDeltaReceived() {
+  Client client(NULL, m_test_uid);
+  ola::TimeStamp timestamp;
+  m_clock.CurrentMonotonicTime(&timestamp);
+
+  // offset 1, 2 slots
+  const uint8_t delta[] = {0, 1, 0, 2, 10, 11};
+
+  // nothing to apply it to yet
+  OLA_ASSERT_FALSE(client.DMXDeltaReceived(TEST_UNIVERSE, 4, delta,
+                                           sizeof(delta), timestamp, 100));
+  OLA_ASSERT_FALSE(client.SourceData(TEST_UNIVERSE).IsSet());
+
+  const uint8_t frame[] = {1, 2, 3, 4};
+  client.DMXReceived(TEST_UNIVERSE, frame, sizeof(frame), timestamp, 100);
+  const uint8_t *slots = client.SourceData(TEST_UNIVERSE).Data().GetRaw();
+
+  // the frame size doesn't match
+  OLA_ASSERT_FALSE(client.DMXDeltaReceived(TEST_UNIVERSE, 5, delta,
+                                           sizeof(delta), timestamp, 100));
+
+  ola::TimeStamp timestamp2 = timestamp + ola::TimeInterval(0, 25000);
+  OLA_ASSERT_TRUE(client.DMXDeltaReceived(TEST_UNIVERSE, 4, delta,
+                                          sizeof(delta), timestamp2, 100));
+  const ola::DmxSource &source = client.SourceData(TEST_UNIVERSE);
+  DmxBuffer expected;
+  expected.SetFromString("1,10,11,4");
+  OLA_ASSERT_DMX_EQUALS(expected, source.Data());
+  OLA_ASSERT_EQ(slots, source.Data().GetRaw());
+  OLA_ASSERT_EQ(timestamp2, source.Timestamp());
+
+  // a range past the end of the frame is rejected
+  const uint8_t bad_delta[] = {0, 3, 0, 2, 10, 11};
+  OLA_ASSERT_FALSE(client.DMXDeltaReceived(TEST_UNIVERSE, 4, bad_delta,
+                                           sizeof(bad_delta), timestamp2,
+                                           100));
+  OLA_ASSERT_DMX_EQUALS(expected, client.SourceData(TEST_UNIVERSE).Data());
+
+  // once the data is discarded, deltas are ignored until the next frame
+  client.DiscardSourceData(TEST_UNIVERSE);
+  OLA_ASSERT_FALSE(client.SourceData(TEST_UNIVERSE).IsSet());
+  OLA_ASSERT_FALSE(client.DMXDeltaReceived(TEST_UNIVERSE, 4, delta,
+                                           sizeof(delta), timestamp2, 100));
+  OLA_ASSERT_FALSE(client.SourceData(TEST_UNIVERSE).IsSet());
+
+  client.DMXReceived(TEST_UNIVERSE, frame, sizeof(frame), timestamp2, 100);
+  OLA_ASSERT_TRUE(client.DMXDeltaReceived(TEST_UNIVERSE, 4, delta,
+                                          sizeof(delta), timestamp2, 100));
+  OLA_ASSERT_DMX_EQUALS(expected, client.SourceData(TEST_UNIVERSE).Data());
+}
+
+
+/*
+ * Check that deltas stay relative to the last frame when the client also
+ * sends data with UpdateDmxData.
+ */
+void ClientTest::testDeltaAfterUpdate() {
+  Client client(NULL, m_test_uid);
+  ola::TimeStamp timestamp;
+  m_clock.CurrentMonotonicTime(&timestamp);
+
+  const uint8_t frame[] = {1, 2, 3, 4};
+  client.DMXReceived(TEST_UNIVERSE, frame, sizeof(frame), timestamp, 100);
+
+  // offset 1, 1 slot
+  const uint8_t delta[] = {0, 1, 0, 1, 10};
+  OLA_ASSERT_TRUE(client.DMXDeltaReceived(TEST_UNIVERSE, 4, delta,
+                                          sizeof(delta), timestamp, 100));
+  DmxBuffer expected;
+  expected.SetFromString("1,10,3,4");
+  OLA_ASSERT_DMX_EQUALS(expected, client.SourceData(TEST_UNIVERSE).Data());
+
+  // data sent with UpdateDmxData replaces the source
+  DmxBuffer update;
+  update.SetFromString("20,21,22,23");
+  ola::TimeStamp timestamp2 = timestamp + ola::TimeInterval(0, 25000);
+  client.DMXReceived(TEST_UNIVERSE, ola::DmxSource(update, timestamp2, 90));
+  OLA_ASSERT_DMX_EQUALS(update, client.SourceData(TEST_UNIVERSE).Data());
+
+  // but the next delta is applied to the last frame, not the update
+  const uint8_t delta2[] = {0, 3, 0, 1, 11};
+  ola::TimeStamp timestamp3 = timestamp2 + ola::TimeInterval(0, 25000);
+  OLA_ASSERT_TRUE(client.DMXDeltaReceived(TEST_UNIVERSE, 4, delta2,
+                                          sizeof(delta2), timestamp3, 100));
+  const ola::DmxSource &source = client.SourceData(TEST_UNIVERSE);
+  expected.SetFromString("1,10,3,11");
+  OLA_ASSERT_DMX_EQUALS(expected, source.Data());
+  OLA_ASSERT_EQ(timestamp3, source.Timestamp());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), source.Priority());
+
+  // an update of a different size doesn't stop deltas either
+  update.SetFromString("5,6");
+  client.DMXReceived(TEST_UNIVERSE, ola::DmxSource(update, timestamp3, 100));
+  OLA_ASSERT_TRUE(client.DMXDeltaReceived(TEST_UNIVERSE, 4, delta,
+                                          sizeof(delta), timestamp3, 100));
+  OLA_ASSERT_DMX_EQUALS(expected, client.SourceData(TEST_UNIVERSE).Data());
+}
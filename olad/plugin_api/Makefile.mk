@@ -18,6 +18,8 @@ olad_plugin_api_libolaserverplugininterface_la_SOURCES = \
     olad/plugin_api/DeviceManager.cpp \
     olad/plugin_api/DeviceManager.h \
     olad/plugin_api/DmxSource.cpp \
+    olad/plugin_api/OutputWorkerPool.cpp \
+    olad/plugin_api/OutputWorkerPool.h \
     olad/plugin_api/Plugin.cpp \
     olad/plugin_api/PluginAdaptor.cpp \
     olad/plugin_api/Port.cpp \
@@ -35,6 +37,28 @@ olad_plugin_api_libolaserverplugininterface_la_LIBADD = \
     common/web/libolaweb.la \
     ola/libola.la
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += \
+    olad/plugin_api/dmx_ingest_benchmark \
+    olad/plugin_api/output_worker_benchmark
+
+olad_plugin_api_dmx_ingest_benchmark_SOURCES = \
+    olad/plugin_api/dmx_ingest_benchmark.cpp
+olad_plugin_api_dmx_ingest_benchmark_CXXFLAGS = $(COMMON_PROTOBUF_CXXFLAGS)
+olad_plugin_api_dmx_ingest_benchmark_LDADD = \
+    $(libprotobuf_LIBS) \
+    olad/plugin_api/libolaserverplugininterface.la \
+    common/libolacommon.la
+
+olad_plugin_api_output_worker_benchmark_SOURCES = \
+    olad/plugin_api/output_worker_benchmark.cpp
+olad_plugin_api_output_worker_benchmark_CXXFLAGS = $(COMMON_PROTOBUF_CXXFLAGS)
+olad_plugin_api_output_worker_benchmark_LDADD = \
+    $(libprotobuf_LIBS) \
+    olad/plugin_api/libolaserverplugininterface.la \
+    common/libolacommon.la
+
 # TESTS
 ##################################################
 test_programs += \
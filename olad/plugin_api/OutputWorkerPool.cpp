@@ -0,0 +1,202 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OutputWorkerPool.cpp
+ * Threads that write DMX data to output ports.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/OutputWorkerPool.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/io/SelectServer.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/thread/Future.h"
+#include "ola/thread/Thread.h"
+#include "olad/Port.h"
+
+namespace ola {
+
+using ola::io::SelectServer;
+using ola::thread::ExecutorInterface;
+using ola::thread::Future;
+using ola::thread::MutexLocker;
+using ola::thread::Thread;
+using std::string;
+using std::vector;
+
+namespace {
+void SetFuture(Future<void> f) {
+  f.Set();
+}
+}  // namespace
+
+/*
+ * A thread running a SelectServer.
+ */
+class OutputWorkerPool::OutputWorker: public Thread {
+ public:
+  explicit OutputWorker(const string &name)
+      : Thread(Thread::Options(name)) {
+  }
+
+  ExecutorInterface *Executor() { return &m_ss; }
+
+  void *Run() {
+    m_ss.Run();
+    return NULL;
+  }
+
+  bool Join(void *ptr = NULL) {
+    // Terminate() is ignored if the SelectServer isn't running yet, so ask
+    // it to terminate from inside the loop.
+    m_ss.Execute(NewSingleCallback(&m_ss, &SelectServer::Terminate));
+    return Thread::Join(ptr);
+  }
+
+ private:
+  SelectServer m_ss;
+};
+
+
+OutputWorkerPool::OutputWorkerPool(unsigned int worker_count)
+    : m_running(false) {
+  for (unsigned int i = 0; i < worker_count; i++) {
+    std::ostringstream name;
+    name << "output-" << i;
+    m_workers.push_back(new OutputWorker(name.str()));
+  }
+}
+
+OutputWorkerPool::~OutputWorkerPool() {
+  Stop();
+  STLDeleteElements(&m_workers);
+}
+
+bool OutputWorkerPool::Start() {
+  if (m_running) {
+    return false;
+  }
+
+  m_running = true;
+  vector<OutputWorker*>::iterator iter = m_workers.begin();
+  for (; iter != m_workers.end(); ++iter) {
+    if (!(*iter)->Start()) {
+      OLA_WARN << "Failed to start output worker";
+      Stop();
+      return false;
+    }
+  }
+  return true;
+}
+
+void OutputWorkerPool::Stop() {
+  if (!m_running) {
+    return;
+  }
+
+  vector<OutputWorker*>::iterator iter = m_workers.begin();
+  for (; iter != m_workers.end(); ++iter) {
+    if ((*iter)->IsRunning()) {
+      (*iter)->Join();
+    }
+  }
+  m_running = false;
+}
+
+ExecutorInterface *OutputWorkerPool::WorkerFor(unsigned int universe_id)
+    const {
+  if (m_workers.empty()) {
+    return NULL;
+  }
+  return m_workers[universe_id % m_workers.size()]->Executor();
+}
+
+
+ThreadedPortWriter::ThreadedPortWriter(ExecutorInterface *executor)
+    : m_executor(executor),
+      m_port_count(0),
+      m_pending_priority(0),
+      m_write_scheduled(false) {
+}
+
+ThreadedPortWriter::~ThreadedPortWriter() {
+  // A scheduled write holds a pointer to us, so wait for the worker to catch
+  // up. The callback holds its own reference to the future, since Set() may
+  // still be running when Get() returns.
+  Future<void> f;
+  m_executor->Execute(NewSingleCallback(SetFuture, f));
+  f.Get();
+}
+
+void ThreadedPortWriter::AddPort(OutputPort *port) {
+  MutexLocker locker(&m_port_mutex);
+  if (std::find(m_ports.begin(), m_ports.end(), port) == m_ports.end()) {
+    m_ports.push_back(port);
+  }
+  m_port_count = m_ports.size();
+}
+
+void ThreadedPortWriter::RemovePort(OutputPort *port) {
+  MutexLocker locker(&m_port_mutex);
+  vector<OutputPort*>::iterator iter = std::find(m_ports.begin(),
+                                                 m_ports.end(), port);
+  if (iter != m_ports.end()) {
+    m_ports.erase(iter);
+  }
+  m_port_count = m_ports.size();
+}
+
+void ThreadedPortWriter::Write(const DmxBuffer &buffer, uint8_t priority) {
+  bool schedule_write;
+  {
+    MutexLocker locker(&m_frame_mutex);
+    m_pending_frame.Set(buffer);
+    m_pending_priority = priority;
+    schedule_write = !m_write_scheduled;
+    m_write_scheduled = true;
+  }
+
+  if (schedule_write) {
+    m_executor->Execute(
+        NewSingleCallback(this, &ThreadedPortWriter::WritePorts));
+  }
+}
+
+/*
+ * Called on the worker thread.
+ */
+void ThreadedPortWriter::WritePorts() {
+  uint8_t priority;
+  {
+    MutexLocker locker(&m_frame_mutex);
+    m_frame.Set(m_pending_frame);
+    priority = m_pending_priority;
+    m_write_scheduled = false;
+  }
+
+  MutexLocker locker(&m_port_mutex);
+  vector<OutputPort*>::iterator iter = m_ports.begin();
+  for (; iter != m_ports.end(); ++iter) {
+    (*iter)->WriteDMX(m_frame, priority);
+  }
+}
+}  // namespace ola
@@ -0,0 +1,156 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OutputWorkerPool.h
+ * Threads that write DMX data to output ports.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_OUTPUTWORKERPOOL_H_
+#define OLAD_PLUGIN_API_OUTPUTWORKERPOOL_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/ExecutorInterface.h"
+#include "ola/thread/Mutex.h"
+
+namespace ola {
+
+class OutputPort;
+
+/**
+ * @brief A set of threads that output ports can be written from.
+ *
+ * Each worker is a thread running its own SelectServer. Universes are
+ * assigned to a worker by universe id, so all the writes for a universe
+ * happen in order on the same thread, while the merge, RPC and HTTP
+ * handling stay on the main thread.
+ *
+ * The pool must outlive the universes that use it.
+ */
+class OutputWorkerPool {
+ public:
+  /**
+   * @brief Create a new pool.
+   * @param worker_count the number of worker threads.
+   */
+  explicit OutputWorkerPool(unsigned int worker_count);
+
+  /**
+   * @brief Destructor, this stops the workers if they are running.
+   */
+  ~OutputWorkerPool();
+
+  /**
+   * @brief Start the worker threads.
+   * @returns true if all the workers started, false otherwise.
+   */
+  bool Start();
+
+  /**
+   * @brief Stop the worker threads.
+   *
+   * Any pending writes are run before the threads exit.
+   */
+  void Stop();
+
+  /**
+   * @brief Return the number of workers.
+   */
+  unsigned int WorkerCount() const { return m_workers.size(); }
+
+  /**
+   * @brief Return the executor that writes for a universe.
+   * @param universe_id the universe id.
+   * @returns the ExecutorInterface for the worker thread.
+   */
+  ola::thread::ExecutorInterface *WorkerFor(unsigned int universe_id) const;
+
+ private:
+  class OutputWorker;
+
+  std::vector<OutputWorker*> m_workers;
+  bool m_running;
+
+  DISALLOW_COPY_AND_ASSIGN(OutputWorkerPool);
+};
+
+
+/**
+ * @brief Writes a universe's DMX data to its ports from a worker thread.
+ *
+ * Write() is called from the main thread. It copies the frame and schedules
+ * a write on the worker, unless one is already pending in which case the
+ * pending frame is replaced. This means a slow worker drops intermediate
+ * frames rather than building up a queue, the same way rate limited
+ * universes coalesce updates.
+ *
+ * AddPort() and RemovePort() block until any write in progress completes,
+ * so once RemovePort() returns the port won't be used by the worker again.
+ */
+class ThreadedPortWriter {
+ public:
+  /**
+   * @brief Create a new ThreadedPortWriter.
+   * @param executor the worker to write from.
+   */
+  explicit ThreadedPortWriter(ola::thread::ExecutorInterface *executor);
+
+  /**
+   * @brief Destructor, this waits for any pending write to complete.
+   */
+  ~ThreadedPortWriter();
+
+  void AddPort(OutputPort *port);
+  void RemovePort(OutputPort *port);
+
+  /**
+   * @brief The number of ports, only valid on the main thread.
+   */
+  unsigned int PortCount() const { return m_port_count; }
+
+  /**
+   * @brief Write a frame to all ports.
+   * @param buffer the DMX data, this is copied.
+   * @param priority the priority of the data.
+   */
+  void Write(const DmxBuffer &buffer, uint8_t priority);
+
+ private:
+  ola::thread::ExecutorInterface *m_executor;
+  unsigned int m_port_count;
+
+  // Protects the pending frame.
+  ola::thread::Mutex m_frame_mutex;
+  DmxBuffer m_pending_frame;
+  uint8_t m_pending_priority;
+  bool m_write_scheduled;
+
+  // Held by the worker while it's writing to the ports.
+  ola::thread::Mutex m_port_mutex;
+  std::vector<OutputPort*> m_ports;
+
+  // Only used on the worker thread.
+  DmxBuffer m_frame;
+
+  void WritePorts();
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadedPortWriter);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_OUTPUTWORKERPOOL_H_
@@ -30,6 +30,8 @@
 #include "ola/DmxBuffer.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/UIDSet.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Thread.h"
 #include "olad/Device.h"
 #include "olad/Plugin.h"
 #include "olad/Port.h"
@@ -96,20 +98,72 @@ class TestMockOutputPort: public ola::BasicOutputPort {
                      bool start_rdm_discovery_on_patch = false,
                      bool supports_rdm = false)
       : ola::BasicOutputPort(parent, port_id, start_rdm_discovery_on_patch,
-                             supports_rdm) {
+                             supports_rdm),
+        m_write_count(0) {
   }
   ~TestMockOutputPort() {}
 
   std::string Description() const { return ""; }
   bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t priority) {
     m_buffer = buffer;
+    m_write_count++;
     (void) priority;
     return true;
   }
   const ola::DmxBuffer &ReadDMX() const { return m_buffer; }
+  unsigned int WriteCount() const { return m_write_count; }
 
  private:
   ola::DmxBuffer m_buffer;
+  unsigned int m_write_count;
+};
+
+
+/*
+ * Mock out an OutputPort that can be written from an output worker.
+ */
+class TestMockThreadedOutputPort: public ola::BasicOutputPort {
+ public:
+  TestMockThreadedOutputPort(ola::AbstractDevice *parent,
+                             unsigned int port_id)
+      : ola::BasicOutputPort(parent, port_id),
+        m_write_count(0),
+        m_write_thread() {
+  }
+  ~TestMockThreadedOutputPort() {}
+
+  std::string Description() const { return ""; }
+  bool SupportsThreadedOutput() const { return true; }
+
+  bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t priority) {
+    ola::thread::MutexLocker locker(&m_mutex);
+    m_buffer.Set(buffer);
+    m_write_count++;
+    m_write_thread = ola::thread::Thread::Self();
+    (void) priority;
+    return true;
+  }
+
+  ola::DmxBuffer ReadDMX() const {
+    ola::thread::MutexLocker locker(&m_mutex);
+    return ola::DmxBuffer(m_buffer.GetRaw(), m_buffer.Size());
+  }
+
+  unsigned int WriteCount() const {
+    ola::thread::MutexLocker locker(&m_mutex);
+    return m_write_count;
+  }
+
+  ola::thread::ThreadId WriteThread() const {
+    ola::thread::MutexLocker locker(&m_mutex);
+    return m_write_thread;
+  }
+
+ private:
+  mutable ola::thread::Mutex m_mutex;
+  ola::DmxBuffer m_buffer;
+  unsigned int m_write_count;
+  ola::thread::ThreadId m_write_thread;
 };
 
 
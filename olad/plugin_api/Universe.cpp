@@ -28,6 +28,10 @@
  *   A list of source clients. which provide us with data for updating the
  *     DmxBuffer per the merge mode.
  *   A list of sink clients, which we update whenever the DmxBuffer changes.
+ *   An optional maximum output rate. If set, changes to the DmxBuffer that
+ *     arrive faster than this are coalesced before the ports and sink
+ *     clients are updated.
+ *   An option to skip frames that are identical to the last one sent.
  */
 
 #include <algorithm>
@@ -49,6 +53,7 @@
 #include "olad/Port.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/OutputWorkerPool.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 namespace ola {
@@ -59,6 +64,8 @@ using ola::rdm::RDMRequest;
 using ola::rdm::RunRDMCallback;
 using ola::rdm::UID;
 using ola::strings::ToHex;
+using ola::thread::ExecutorInterface;
+using ola::thread::INVALID_TIMEOUT;
 using std::auto_ptr;
 using std::map;
 using std::ostringstream;
@@ -68,9 +75,14 @@ using std::vector;
 
 const char Universe::K_UNIVERSE_UID_COUNT_VAR[] = "universe-uids";
 const char Universe::K_FPS_VAR[] = "universe-dmx-frames";
+const char Universe::K_UNIVERSE_COALESCED_FRAMES_VAR[] =
+    "universe-coalesced-frames";
 const char Universe::K_MERGE_HTP_STR[] = "htp";
 const char Universe::K_MERGE_LTP_STR[] = "ltp";
 const char Universe::K_UNIVERSE_INPUT_PORT_VAR[] = "universe-input-ports";
+const char Universe::K_UNIVERSE_LATENCY_VAR[] = "universe-latency-us-";
+const char Universe::K_UNIVERSE_MAX_OUTPUT_RATE_VAR[] =
+    "universe-max-output-rate";
 const char Universe::K_UNIVERSE_MODE_VAR[] = "universe-mode";
 const char Universe::K_UNIVERSE_NAME_VAR[] = "universe-name";
 const char Universe::K_UNIVERSE_OUTPUT_PORT_VAR[] = "universe-output-ports";
@@ -78,26 +90,43 @@ const char Universe::K_UNIVERSE_RDM_REQUESTS[] = "universe-rdm-requests";
 const char Universe::K_UNIVERSE_SINK_CLIENTS_VAR[] = "universe-sink-clients";
 const char Universe::K_UNIVERSE_SOURCE_CLIENTS_VAR[] =
     "universe-source-clients";
+const char Universe::K_UNIVERSE_UNCHANGED_FRAMES_VAR[] =
+    "universe-unchanged-frames";
 
 /*
  * Create a new universe
  * @param uid  the universe id of this universe
  * @param store the store this universe came from
  * @param export_map the ExportMap that we update
+ * @param clock the Clock to use
+ * @param scheduler the scheduler used to rate limit output, may be NULL
  */
 Universe::Universe(unsigned int universe_id, UniverseStore *store,
                    ExportMap *export_map,
-                   Clock *clock)
+                   Clock *clock,
+                   ola::thread::SchedulerInterface *scheduler)
     : m_universe_name(""),
       m_universe_id(universe_id),
       m_active_priority(ola::dmx::SOURCE_PRIORITY_MIN),
       m_merge_mode(Universe::MERGE_LTP),
       m_universe_store(store),
       m_export_map(export_map),
+      m_latency_var(NULL),
       m_clock(clock),
       m_rdm_discovery_interval(),
       m_last_discovery_time(),
-      m_transaction_number_sequence() {
+      m_transaction_number_sequence(),
+      m_scheduler(scheduler),
+      m_max_output_rate(0),
+      m_output_interval(),
+      m_last_output_time(),
+      m_ingress_time(),
+      m_port_writer(NULL),
+      m_skip_unchanged_frames(false),
+      m_sent_generation(0),
+      m_sent_priority(0),
+      m_last_sent_time(),
+      m_output_timeout(INVALID_TIMEOUT) {
   ostringstream universe_id_str, universe_name_str;
   universe_id_str << universe_id;
   m_universe_id_str = universe_id_str.str();
@@ -109,18 +138,38 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
 
   const char *vars[] = {
     K_FPS_VAR,
+    K_UNIVERSE_COALESCED_FRAMES_VAR,
     K_UNIVERSE_INPUT_PORT_VAR,
+    K_UNIVERSE_MAX_OUTPUT_RATE_VAR,
     K_UNIVERSE_OUTPUT_PORT_VAR,
     K_UNIVERSE_RDM_REQUESTS,
     K_UNIVERSE_SINK_CLIENTS_VAR,
     K_UNIVERSE_SOURCE_CLIENTS_VAR,
     K_UNIVERSE_UID_COUNT_VAR,
+    K_UNIVERSE_UNCHANGED_FRAMES_VAR,
   };
 
   if (m_export_map) {
     for (unsigned int i = 0; i < arraysize(vars); ++i) {
       (*m_export_map->GetUIntMapVar(vars[i]))[m_universe_id_str] = 0;
     }
+
+    // These are updated frequently, so look them up once.
+    m_fps_var = m_export_map->GetUIntMapVar(K_FPS_VAR)->GetHandle(
+        m_universe_id_str);
+    m_coalesced_frames_var = m_export_map->GetUIntMapVar(
+        K_UNIVERSE_COALESCED_FRAMES_VAR)->GetHandle(m_universe_id_str);
+    m_rdm_requests_var = m_export_map->GetUIntMapVar(
+        K_UNIVERSE_RDM_REQUESTS)->GetHandle(m_universe_id_str);
+    m_sink_clients_var = m_export_map->GetUIntMapVar(
+        K_UNIVERSE_SINK_CLIENTS_VAR)->GetHandle(m_universe_id_str);
+    m_source_clients_var = m_export_map->GetUIntMapVar(
+        K_UNIVERSE_SOURCE_CLIENTS_VAR)->GetHandle(m_universe_id_str);
+    m_unchanged_frames_var = m_export_map->GetUIntMapVar(
+        K_UNIVERSE_UNCHANGED_FRAMES_VAR)->GetHandle(m_universe_id_str);
+    m_latency_var = m_export_map->GetHistogramVar(
+        K_UNIVERSE_LATENCY_VAR + m_universe_id_str);
+    m_latency_var->Reset();
   }
 
   // We set the last discovery time to now, since most ports will trigger
@@ -133,6 +182,11 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
  * Delete this universe
  */
 Universe::~Universe() {
+  if (m_output_timeout != INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_output_timeout);
+  }
+  delete m_port_writer;
+
   const char *string_vars[] = {
     K_UNIVERSE_NAME_VAR,
     K_UNIVERSE_MODE_VAR,
@@ -140,12 +194,15 @@ Universe::~Universe() {
 
   const char *uint_vars[] = {
     K_FPS_VAR,
+    K_UNIVERSE_COALESCED_FRAMES_VAR,
     K_UNIVERSE_INPUT_PORT_VAR,
+    K_UNIVERSE_MAX_OUTPUT_RATE_VAR,
     K_UNIVERSE_OUTPUT_PORT_VAR,
     K_UNIVERSE_RDM_REQUESTS,
     K_UNIVERSE_SINK_CLIENTS_VAR,
     K_UNIVERSE_SOURCE_CLIENTS_VAR,
     K_UNIVERSE_UID_COUNT_VAR,
+    K_UNIVERSE_UNCHANGED_FRAMES_VAR,
   };
 
   if (m_export_map) {
@@ -155,6 +212,8 @@ Universe::~Universe() {
     for (unsigned int i = 0; i < arraysize(uint_vars); ++i) {
       m_export_map->GetUIntMapVar(uint_vars[i])->Remove(m_universe_id_str);
     }
+    m_export_map->RemoveHistogramVar(K_UNIVERSE_LATENCY_VAR +
+                                     m_universe_id_str);
   }
 }
 
@@ -185,6 +244,67 @@ void Universe::SetMergeMode(enum merge_mode merge_mode) {
 }
 
 
+/*
+ * Set the maximum output rate
+ * @param frames_per_second the max rate, 0 disables rate limiting
+ */
+void Universe::SetMaxOutputRate(unsigned int frames_per_second) {
+  m_max_output_rate = frames_per_second;
+  m_output_interval = TimeInterval();
+  if (frames_per_second) {
+    m_output_interval = TimeInterval(
+        static_cast<int64_t>(USEC_IN_SECONDS / frames_per_second));
+  }
+
+  if (m_export_map) {
+    (*m_export_map->GetUIntMapVar(K_UNIVERSE_MAX_OUTPUT_RATE_VAR))[
+        m_universe_id_str] = frames_per_second;
+  }
+
+  if (m_output_interval.IsZero() && m_output_timeout != INVALID_TIMEOUT) {
+    // flush the pending frame now, rather than waiting for the timeout
+    m_scheduler->RemoveTimeout(m_output_timeout);
+    m_output_timeout = INVALID_TIMEOUT;
+    UpdateDependants();
+  }
+}
+
+
+/*
+ * Skip frames which are the same as the last one.
+ * @param skip true to skip unchanged frames
+ */
+void Universe::SetSkipUnchangedFrames(bool skip) {
+  m_skip_unchanged_frames = skip;
+  if (skip) {
+    m_buffer.EnableChangeTracking();
+  }
+  // Make sure the next frame is sent.
+  m_last_sent_time = TimeStamp();
+}
+
+
+/*
+ * Set the worker used to write to thread safe output ports.
+ * @param executor the worker, or NULL to write from this thread
+ */
+void Universe::SetOutputWorker(ExecutorInterface *executor) {
+  delete m_port_writer;
+  m_port_writer = NULL;
+  if (!executor) {
+    return;
+  }
+
+  m_port_writer = new ThreadedPortWriter(executor);
+  vector<OutputPort*>::const_iterator iter = m_output_ports.begin();
+  for (; iter != m_output_ports.end(); ++iter) {
+    if ((*iter)->SupportsThreadedOutput()) {
+      m_port_writer->AddPort(*iter);
+    }
+  }
+}
+
+
 /*
  * Add an InputPort to this universe.
  * @param port the port to add
@@ -199,7 +319,15 @@ bool Universe::AddPort(InputPort *port) {
  * @param port the port to add
  */
 bool Universe::AddPort(OutputPort *port) {
-  return GenericAddPort(port, &m_output_ports);
+  bool ret = GenericAddPort(port, &m_output_ports);
+  if (ret && m_port_writer && port->SupportsThreadedOutput()) {
+    m_port_writer->AddPort(port);
+  }
+  if (ret) {
+    // The new port hasn't seen the current frame.
+    m_last_sent_time = TimeStamp();
+  }
+  return ret;
 }
 
 
@@ -219,6 +347,10 @@ bool Universe::RemovePort(InputPort *port) {
  * @return true if the port was removed, false if it didn't exist
  */
 bool Universe::RemovePort(OutputPort *port) {
+  if (m_port_writer) {
+    // This blocks until any write to the port in progress is complete.
+    m_port_writer->RemovePort(port);
+  }
   bool ret = GenericRemovePort(port, &m_output_ports, &m_output_uids);
 
   if (m_export_map) {
@@ -286,7 +418,7 @@ bool Universe::AddSourceClient(Client *client) {
   OLA_INFO << "Added source client, " << client << " to universe "
            << m_universe_id;
 
-  SafeIncrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
+  m_source_clients_var.Increment();
   return true;
 }
 
@@ -303,7 +435,7 @@ bool Universe::RemoveSourceClient(Client *client) {
     return false;
   }
 
-  SafeDecrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
+  m_source_clients_var.Decrement();
 
   OLA_INFO << "Source client " << client << " has been removed from uni "
            << m_universe_id;
@@ -338,7 +470,8 @@ bool Universe::AddSinkClient(Client *client) {
   OLA_INFO << "Added sink client, " << client << " to universe "
            << m_universe_id;
 
-  SafeIncrement(K_UNIVERSE_SINK_CLIENTS_VAR);
+  m_sink_clients_var.Increment();
+  m_last_sent_time = TimeStamp();
   return true;
 }
 
@@ -355,7 +488,7 @@ bool Universe::RemoveSinkClient(Client *client) {
     return false;
   }
 
-  SafeDecrement(K_UNIVERSE_SINK_CLIENTS_VAR);
+  m_sink_clients_var.Decrement();
 
   OLA_INFO << "Sink client " << client << " has been removed from uni "
            << m_universe_id;
@@ -389,7 +522,7 @@ bool Universe::SetDMX(const DmxBuffer &buffer) {
     return true;
   }
   m_buffer.Set(buffer);
-  return UpdateDependants();
+  return DataChanged();
 }
 
 
@@ -403,8 +536,11 @@ bool Universe::PortDataChanged(InputPort *port) {
              << UniverseId();
     return false;
   }
+  const bool recorded = RecordIngressTime();
   if (MergeAll(port, NULL)) {
-    UpdateDependants();
+    DataChanged();
+  } else if (recorded) {
+    m_ingress_time = TimeStamp();
   }
   return true;
 }
@@ -419,8 +555,11 @@ bool Universe::SourceClientDataChanged(Client *client) {
   }
 
   AddSourceClient(client);   // always add since this may be the first call
+  const bool recorded = RecordIngressTime();
   if (MergeAll(NULL, client)) {
-    UpdateDependants();
+    DataChanged();
+  } else if (recorded) {
+    m_ingress_time = TimeStamp();
   }
   return true;
 }
@@ -435,7 +574,7 @@ void Universe::CleanStaleSourceClients() {
     if (iter->second) {
       // if stale remove it
       m_source_clients.erase(iter++);
-      SafeDecrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
+      m_source_clients_var.Decrement();
       OLA_INFO << "Removed Stale Client";
       if (!IsActive()) {
         m_universe_store->AddUniverseGarbageCollection(this);
@@ -464,7 +603,7 @@ void Universe::SendRDMRequest(RDMRequest *request_ptr,
            << ToHex(request->ParamId()) << ", PDL: "
            << request->ParamDataSize();
 
-  SafeIncrement(K_UNIVERSE_RDM_REQUESTS);
+  m_rdm_requests_var.Increment();
 
   if (request->DestinationUID().IsBroadcast()) {
     if (m_output_ports.empty()) {
@@ -630,18 +769,97 @@ bool Universe::IsActive() const {
 
 
 /*
- * Called when the dmx data for this universe changes,
- * updates everyone who needs to know (patched ports and network clients)
+ * Called when the dmx data for this universe changes.
+ *
+ * If there is no rate limit, or it's been at least one output interval since
+ * the last frame, this updates the dependants immediately. Otherwise a single
+ * update is scheduled for the end of the interval, and any changes which
+ * arrive before then are coalesced into it.
+ */
+bool Universe::DataChanged() {
+  if (m_output_interval.IsZero() || !m_scheduler) {
+    return UpdateDependants();
+  }
+
+  if (m_output_timeout != INVALID_TIMEOUT) {
+    // An update is already pending, it'll pick up the new data.
+    m_coalesced_frames_var.Increment();
+    return true;
+  }
+
+  TimeStamp now;
+  m_clock->CurrentMonotonicTime(&now);
+  TimeStamp next_output_time = m_last_output_time + m_output_interval;
+  if (!m_last_output_time.IsSet() || now >= next_output_time) {
+    return UpdateDependants();
+  }
+
+  m_output_timeout = m_scheduler->RegisterSingleTimeout(
+      next_output_time - now,
+      NewSingleCallback(this, &Universe::ScheduledUpdate));
+  return true;
+}
+
+
+/*
+ * Note the time that new data arrived from a port or client, if we're not
+ * already waiting to send earlier data. This is called before the sources are
+ * merged, so the merge is included. UpdateDependants() records the time until
+ * the data was written to the output ports, so coalesced frames are measured
+ * from the oldest change.
+ * @returns true if the time was recorded, false otherwise.
+ */
+bool Universe::RecordIngressTime() {
+  if (m_latency_var && !m_ingress_time.IsSet()) {
+    m_clock->CurrentMonotonicTime(&m_ingress_time);
+    return true;
+  }
+  return false;
+}
+
+
+/*
+ * Called when the output interval expires and there is a pending update.
+ */
+void Universe::ScheduledUpdate() {
+  m_output_timeout = INVALID_TIMEOUT;
+  UpdateDependants();
+}
+
+
+/*
+ * Updates everyone who needs to know about the current dmx data (patched
+ * ports and network clients)
  */
 bool Universe::UpdateDependants() {
   vector<OutputPort*>::const_iterator iter;
   set<Client*>::const_iterator client_iter;
 
+  if (m_skip_unchanged_frames && FrameUnchanged()) {
+    m_unchanged_frames_var.Increment();
+    m_ingress_time = TimeStamp();
+    return true;
+  }
+
   // write to all ports assigned to this universe
   for (iter = m_output_ports.begin(); iter != m_output_ports.end(); ++iter) {
+    if (m_port_writer && (*iter)->SupportsThreadedOutput()) {
+      continue;
+    }
     (*iter)->WriteDMX(m_buffer, m_active_priority);
   }
 
+  if (m_port_writer && m_port_writer->PortCount()) {
+    m_port_writer->Write(m_buffer, m_active_priority);
+  }
+
+  if (m_ingress_time.IsSet()) {
+    TimeStamp now;
+    m_clock->CurrentMonotonicTime(&now);
+    m_latency_var->Record((now - m_ingress_time).AsInt());
+    m_ingress_time = TimeStamp();
+  }
+
   // write to all clients
   for (client_iter = m_sink_clients.begin();
        client_iter != m_sink_clients.end();
@@ -649,11 +867,36 @@ bool Universe::UpdateDependants() {
     (*client_iter)->SendDMX(m_universe_id, m_active_priority, m_buffer);
   }
 
-  SafeIncrement(K_FPS_VAR);
+  if (!m_output_interval.IsZero()) {
+    m_clock->CurrentMonotonicTime(&m_last_output_time);
+  }
+  m_fps_var.Increment();
   return true;
 }
 
 
+/*
+ * Check if the current frame is the same as the last one we sent, and we've
+ * sent a frame recently. If not, this records the current frame as sent.
+ */
+bool Universe::FrameUnchanged() {
+  TimeStamp now;
+  m_clock->CurrentMonotonicTime(&now);
+  if (m_last_sent_time.IsSet() &&
+      m_sent_generation == m_buffer.Generation() &&
+      m_sent_priority == m_active_priority &&
+      (now - m_last_sent_time).InMilliSeconds() <
+          UNCHANGED_REFRESH_INTERVAL_MS) {
+    return true;
+  }
+
+  m_sent_generation = m_buffer.Generation();
+  m_sent_priority = m_active_priority;
+  m_last_sent_time = now;
+  return false;
+}
+
+
 /*
  * Update the name in the export map.
  */
@@ -684,12 +927,23 @@ void Universe::UpdateMode() {
  * @pre sources.size >= 2
  * @param sources the list of DmxSources to merge
  */
-void Universe::HTPMergeSources(const vector<DmxSource> &sources) {
-  vector<DmxSource>::const_iterator iter;
-  m_buffer.Reset();
+void Universe::HTPMergeSources(const vector<const DmxSource*> &sources) {
+  m_merge_buffers.clear();
 
+  vector<const DmxSource*>::const_iterator iter;
   for (iter = sources.begin(); iter != sources.end(); ++iter) {
-    m_buffer.HTPMerge(iter->Data());
+    m_merge_buffers.push_back(&(*iter)->Data());
+  }
+
+  if (m_buffer.ChangeTrackingEnabled()) {
+    // Merge into a separate buffer so only the slots that differ from the
+    // last merge are recorded as changed.
+    m_merge_output.Reset();
+    m_merge_output.HTPMerge(m_merge_buffers);
+    m_buffer.Set(m_merge_output);
+  } else {
+    m_buffer.Reset();
+    m_buffer.HTPMerge(m_merge_buffers);
   }
 }
 
@@ -698,12 +952,14 @@ void Universe::HTPMergeSources(const vector<DmxSource> &sources) {
  * Merge all port/client sources.
  * This does a priority based merge as documented at:
  * https://wiki.openlighting.org/index.php/OLA_Merging_Algorithms
+ * The sources are referenced rather than copied, they remain owned by the
+ * ports & clients.
  * @param port the input port that changed or NULL
  * @param client the client that changed or NULL
  * @returns true if the data for this universe changed, false otherwise
  */
 bool Universe::MergeAll(const InputPort *port, const Client *client) {
-  vector<DmxSource> active_sources;
+  m_active_sources.clear();
 
   vector<InputPort*>::const_iterator iter;
   SourceClientMap::const_iterator client_iter;
@@ -715,19 +971,19 @@ bool Universe::MergeAll(const InputPort *port, const Client *client) {
 
   // Find the highest active ports
   for (iter = m_input_ports.begin(); iter != m_input_ports.end(); ++iter) {
-    DmxSource source = (*iter)->SourceData();
+    const DmxSource &source = (*iter)->SourceData();
     if (!source.IsSet() || !source.IsActive(now) || !source.Data().Size()) {
       continue;
     }
 
     if (source.Priority() > m_active_priority) {
       changed_source_is_active = false;
-      active_sources.clear();
+      m_active_sources.clear();
       m_active_priority = source.Priority();
     }
 
     if (source.Priority() == m_active_priority) {
-      active_sources.push_back(source);
+      m_active_sources.push_back(&source);
       if (*iter == port) {
         changed_source_is_active = true;
       }
@@ -746,19 +1002,19 @@ bool Universe::MergeAll(const InputPort *port, const Client *client) {
 
     if (source.Priority() > m_active_priority) {
       changed_source_is_active = false;
-      active_sources.clear();
+      m_active_sources.clear();
       m_active_priority = source.Priority();
     }
 
     if (source.Priority() == m_active_priority) {
-      active_sources.push_back(source);
+      m_active_sources.push_back(&source);
       if (client_iter->first == client) {
         changed_source_is_active = true;
       }
     }
   }
 
-  if (active_sources.empty()) {
+  if (m_active_sources.empty()) {
     OLA_WARN << "Something changed but we didn't find any active sources "
              << " for universe " << UniverseId();
     return false;
@@ -770,30 +1026,27 @@ bool Universe::MergeAll(const InputPort *port, const Client *client) {
   }
 
   // only one source at the active priority
-  if (active_sources.size() == 1) {
-    m_buffer.Set(active_sources[0].Data());
+  if (m_active_sources.size() == 1) {
+    m_buffer.Set(m_active_sources[0]->Data());
   } else {
     // multi source merge
     if (m_merge_mode == Universe::MERGE_LTP) {
-      vector<DmxSource>::const_iterator source_iter = active_sources.begin();
-      DmxSource changed_source;
-      if (port) {
-        changed_source = port->SourceData();
-      } else {
-        changed_source = client->SourceData(UniverseId());
-      }
+      vector<const DmxSource*>::const_iterator source_iter =
+          m_active_sources.begin();
+      const DmxSource &changed_source = port ?
+          port->SourceData() : client->SourceData(UniverseId());
 
       // check that the current port/client is newer than all other active
       // sources
-      for (; source_iter != active_sources.end(); source_iter++) {
-        if (changed_source.Timestamp() < source_iter->Timestamp()) {
+      for (; source_iter != m_active_sources.end(); source_iter++) {
+        if (changed_source.Timestamp() < (*source_iter)->Timestamp()) {
           return false;
         }
       }
       // if we made it to here this is the newest source
       m_buffer.Set(changed_source.Data());
     } else {
-      HTPMergeSources(active_sources);
+      HTPMergeSources(m_active_sources);
     }
   }
   return true;
@@ -889,25 +1142,6 @@ void Universe::HandleBroadcastDiscovery(
 }
 
 
-/*
- * Helper function to increment an Export Map variable
- */
-void Universe::SafeIncrement(const string &name) {
-  if (m_export_map) {
-    (*m_export_map->GetUIntMapVar(name))[m_universe_id_str]++;
-  }
-}
-
-/*
- * Helper function to decrement an Export Map variable
- */
-void Universe::SafeDecrement(const string &name) {
-  if (m_export_map) {
-    (*m_export_map->GetUIntMapVar(name))[m_universe_id_str]--;
-  }
-}
-
-
 /*
  * Add an Input or Output port to this universe.
  * @param port, the port to add
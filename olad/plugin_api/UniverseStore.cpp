@@ -34,6 +34,7 @@
 #include "ola/stl/STLUtils.h"
 #include "olad/Preferences.h"
 #include "olad/Universe.h"
+#include "olad/plugin_api/OutputWorkerPool.h"
 
 namespace ola {
 
@@ -45,16 +46,21 @@ using std::vector;
 const unsigned int UniverseStore::MINIMUM_RDM_DISCOVERY_INTERVAL = 30;
 
 UniverseStore::UniverseStore(Preferences *preferences,
-                             ExportMap *export_map)
+                             ExportMap *export_map,
+                             ola::thread::SchedulerInterface *scheduler)
     : m_preferences(preferences),
-      m_export_map(export_map) {
+      m_export_map(export_map),
+      m_scheduler(scheduler),
+      m_output_workers(NULL) {
   if (export_map) {
     export_map->GetStringMapVar(Universe::K_UNIVERSE_NAME_VAR, "universe");
     export_map->GetStringMapVar(Universe::K_UNIVERSE_MODE_VAR, "universe");
 
     const char *vars[] = {
       Universe::K_FPS_VAR,
+      Universe::K_UNIVERSE_COALESCED_FRAMES_VAR,
       Universe::K_UNIVERSE_INPUT_PORT_VAR,
+      Universe::K_UNIVERSE_MAX_OUTPUT_RATE_VAR,
       Universe::K_UNIVERSE_OUTPUT_PORT_VAR,
       Universe::K_UNIVERSE_SINK_CLIENTS_VAR,
       Universe::K_UNIVERSE_SOURCE_CLIENTS_VAR,
@@ -71,6 +77,15 @@ UniverseStore::~UniverseStore() {
   DeleteAll();
 }
 
+void UniverseStore::SetOutputWorkerPool(OutputWorkerPool *pool) {
+  m_output_workers = pool;
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->SetOutputWorker(
+        pool ? pool->WorkerFor(iter->first) : NULL);
+  }
+}
+
 Universe *UniverseStore::GetUniverse(unsigned int universe_id) const {
   return STLFindOrNull(m_universe_map, universe_id);
 }
@@ -80,9 +95,14 @@ Universe *UniverseStore::GetUniverseOrCreate(unsigned int universe_id) {
       &m_universe_map, universe_id);
 
   if (!iter->second) {
-    iter->second = new Universe(universe_id, this, m_export_map, &m_clock);
+    iter->second = new Universe(universe_id, this, m_export_map, &m_clock,
+                                m_scheduler);
 
     if (iter->second) {
+      if (m_output_workers) {
+        iter->second->SetOutputWorker(
+            m_output_workers->WorkerFor(universe_id));
+      }
       if (m_preferences) {
         RestoreUniverseSettings(iter->second);
       }
@@ -181,6 +201,28 @@ bool UniverseStore::RestoreUniverseSettings(Universe *universe) const {
         universe->UniverseId() << ", value was " << value;
     }
   }
+
+  // load max output rate
+  key = "uni_" + oss.str() + "_max_output_rate";
+  value = m_preferences->GetValue(key);
+
+  if (!value.empty()) {
+    unsigned int rate;
+    if (StringToInt(value, &rate, true)) {
+      OLA_DEBUG << "Max output rate for " << oss.str() << " is " << rate;
+      universe->SetMaxOutputRate(rate);
+    } else {
+      OLA_WARN << "Invalid max output rate for universe " <<
+        universe->UniverseId() << ", value was " << value;
+    }
+  }
+
+  // load skip unchanged frames
+  key = "uni_" + oss.str() + "_skip_unchanged_frames";
+  if (m_preferences->GetValueAsBool(key)) {
+    OLA_DEBUG << "Skipping unchanged frames for " << oss.str();
+    universe->SetSkipUnchangedFrames(true);
+  }
   return 0;
 }
 
@@ -207,8 +249,8 @@ bool UniverseStore::SaveUniverseSettings(Universe *universe) const {
   mode = (universe->MergeMode() == Universe::MERGE_HTP ? "HTP" : "LTP");
   m_preferences->SetValue(key, mode);
 
-  // We don't save the RDM Discovery interval since it can only be set in the
-  // config files for now.
+  // We don't save the RDM Discovery interval, max output rate or skipping
+  // unchanged frames since they can only be set in the config files for now.
 
   m_preferences->Save();
 
@@ -28,9 +28,11 @@
 
 #include "ola/Clock.h"
 #include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
 
 namespace ola {
 
+class OutputWorkerPool;
 class Universe;
 
 /**
@@ -42,14 +44,26 @@ class UniverseStore {
    * @brief Create a new UniverseStore.
    * @param preferences The Preferences store.
    * @param export_map the ExportMap to use for stats, may be NULL.
+   * @param scheduler the scheduler used by the universes to rate limit
+   *   output, may be NULL.
    */
-  UniverseStore(class Preferences *preferences, class ExportMap *export_map);
+  UniverseStore(class Preferences *preferences, class ExportMap *export_map,
+                ola::thread::SchedulerInterface *scheduler = NULL);
 
   /**
    * @brief Destructor.
    */
   ~UniverseStore();
 
+  /**
+   * @brief Write to thread safe output ports from a pool of workers.
+   * @param pool the OutputWorkerPool, or NULL to write from the main thread.
+   *   The pool must outlive the universes.
+   *
+   * This applies to both the existing universes and ones created later.
+   */
+  void SetOutputWorkerPool(OutputWorkerPool *pool);
+
   /**
    * @brief Lookup a universe from its universe-id.
    * @param universe_id the universe-id of the universe.
@@ -97,6 +111,8 @@ class UniverseStore {
 
   Preferences *m_preferences;
   ExportMap *m_export_map;
+  ola::thread::SchedulerInterface *m_scheduler;
+  OutputWorkerPool *m_output_workers;
   UniverseMap m_universe_map;
   std::set<Universe*> m_deletion_candidates;  // list of universes we may be
                                               // able to delete
@@ -27,10 +27,14 @@
 #include "ola/Constants.h"
 #include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/io/SelectServer.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMReply.h"
 #include "ola/rdm/RDMResponseCodes.h"
 #include "ola/rdm/UID.h"
+#include "ola/thread/Future.h"
+#include "ola/thread/Thread.h"
 #include "olad/DmxSource.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Port.h"
@@ -38,6 +42,7 @@
 #include "olad/Preferences.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/OutputWorkerPool.h"
 #include "olad/plugin_api/PortManager.h"
 #include "olad/plugin_api/TestCommon.h"
 #include "olad/plugin_api/UniverseStore.h"
@@ -47,8 +52,13 @@
 using ola::AbstractDevice;
 using ola::Clock;
 using ola::DmxBuffer;
+using ola::ExportMap;
+using ola::HistogramVariable;
+using ola::MockClock;
+using ola::OutputWorkerPool;
 using ola::NewCallback;
 using ola::NewSingleCallback;
+using ola::TimeInterval;
 using ola::TimeStamp;
 using ola::Universe;
 using ola::rdm::NewDiscoveryUniqueBranchRequest;
@@ -59,18 +69,38 @@ using ola::rdm::RDMResponse;
 using ola::rdm::UID;
 using ola::rdm::UIDSet;
 using ola::rdm::RDMStatusCode;
+using ola::thread::ExecutorInterface;
+using ola::thread::Future;
+using ola::thread::Thread;
 using std::string;
 using std::vector;
 
 static unsigned int TEST_UNIVERSE = 1;
 static const char TEST_DATA[] = "this is some test data";
 
+static void SetFuture(Future<void> f) {
+  f.Set();
+}
+
+/*
+ * Block until the callbacks queued on an executor have run.
+ */
+static void WaitForExecutor(ExecutorInterface *executor) {
+  Future<void> f;
+  executor->Execute(ola::NewSingleCallback(SetFuture, f));
+  f.Get();
+}
+
 
 class UniverseTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(UniverseTest);
   CPPUNIT_TEST(testLifecycle);
   CPPUNIT_TEST(testSetGetDmx);
   CPPUNIT_TEST(testSendDmx);
+  CPPUNIT_TEST(testMaxOutputRate);
+  CPPUNIT_TEST(testSkipUnchangedFrames);
+  CPPUNIT_TEST(testLatencyHistogram);
+  CPPUNIT_TEST(testOutputWorkers);
   CPPUNIT_TEST(testReceiveDmx);
   CPPUNIT_TEST(testSourceClients);
   CPPUNIT_TEST(testSinkClients);
@@ -86,6 +116,10 @@ class UniverseTest: public CppUnit::TestFixture {
   void testLifecycle();
   void testSetGetDmx();
   void testSendDmx();
+  void testMaxOutputRate();
+  void testSkipUnchangedFrames();
+  void testLatencyHistogram();
+  void testOutputWorkers();
   void testReceiveDmx();
   void testSourceClients();
   void testSinkClients();
@@ -233,6 +267,260 @@ void UniverseTest::testSendDmx() {
 }
 
 
+/*
+ * Check that changes are coalesced when the output rate is limited.
+ */
+void UniverseTest::testMaxOutputRate() {
+  MockClock clock;
+  ExportMap export_map;
+  ola::io::SelectServer ss(NULL, &clock);
+  Universe universe(TEST_UNIVERSE, m_store, &export_map, &clock, &ss);
+  TestMockOutputPort port(NULL, 1);
+  universe.AddPort(&port);
+
+  // 40 fps is a frame every 25ms
+  universe.SetMaxOutputRate(40);
+  OLA_ASSERT_EQ(40u, universe.MaxOutputRate());
+  OLA_ASSERT_EQ(40u, (*export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_MAX_OUTPUT_RATE_VAR))["1"]);
+
+  // The first frame is sent immediately
+  DmxBuffer buffer1, buffer2, buffer3;
+  buffer1.SetFromString("1,2,3");
+  buffer2.SetFromString("4,5,6");
+  buffer3.SetFromString("7,8,9");
+  OLA_ASSERT(universe.SetDMX(buffer1));
+  OLA_ASSERT_EQ(1u, port.WriteCount());
+  OLA_ASSERT_DMX_EQUALS(buffer1, port.ReadDMX());
+
+  // Changes within the frame period are held back
+  clock.AdvanceTime(0, 10000);
+  OLA_ASSERT(universe.SetDMX(buffer2));
+  OLA_ASSERT(universe.SetDMX(buffer3));
+  OLA_ASSERT_EQ(1u, port.WriteCount());
+  OLA_ASSERT_EQ(1u, (*export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_COALESCED_FRAMES_VAR))["1"]);
+
+  // Not yet..
+  clock.AdvanceTime(0, 10000);
+  ss.RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(1u, port.WriteCount());
+
+  // and at the end of the period we get the latest data
+  clock.AdvanceTime(0, 5000);
+  ss.RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(2u, port.WriteCount());
+  OLA_ASSERT_DMX_EQUALS(buffer3, port.ReadDMX());
+
+  // Once a full period has passed, changes go out immediately
+  clock.AdvanceTime(0, 30000);
+  OLA_ASSERT(universe.SetDMX(buffer1));
+  OLA_ASSERT_EQ(3u, port.WriteCount());
+  OLA_ASSERT_DMX_EQUALS(buffer1, port.ReadDMX());
+
+  // Removing the limit flushes any pending frame
+  OLA_ASSERT(universe.SetDMX(buffer2));
+  OLA_ASSERT_EQ(3u, port.WriteCount());
+  universe.SetMaxOutputRate(0);
+  OLA_ASSERT_EQ(4u, port.WriteCount());
+  OLA_ASSERT_DMX_EQUALS(buffer2, port.ReadDMX());
+
+  // and then every change is sent
+  OLA_ASSERT(universe.SetDMX(buffer3));
+  OLA_ASSERT_EQ(5u, port.WriteCount());
+}
+
+
+/*
+ * Check that frames which don't change anything are skipped.
+ */
+void UniverseTest::testSkipUnchangedFrames() {
+  MockClock clock;
+  ExportMap export_map;
+  Universe universe(TEST_UNIVERSE, m_store, &export_map, &clock);
+  TestMockOutputPort port(NULL, 1);
+  universe.AddPort(&port);
+
+  DmxBuffer buffer1, buffer2;
+  buffer1.SetFromString("1,2,3");
+  buffer2.SetFromString("1,2,4");
+
+  // By default every frame is sent
+  OLA_ASSERT_FALSE(universe.SkipUnchangedFrames());
+  OLA_ASSERT(universe.SetDMX(buffer1));
+  OLA_ASSERT(universe.SetDMX(buffer1));
+  OLA_ASSERT_EQ(2u, port.WriteCount());
+
+  // The first frame after enabling is always sent
+  universe.SetSkipUnchangedFrames(true);
+  OLA_ASSERT_TRUE(universe.SkipUnchangedFrames());
+  OLA_ASSERT(universe.SetDMX(buffer1));
+  OLA_ASSERT_EQ(3u, port.WriteCount());
+
+  OLA_ASSERT(universe.SetDMX(buffer1));
+  OLA_ASSERT(universe.SetDMX(buffer1));
+  OLA_ASSERT_EQ(3u, port.WriteCount());
+  OLA_ASSERT_EQ(2u, (*export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_UNCHANGED_FRAMES_VAR))["1"]);
+
+  OLA_ASSERT(universe.SetDMX(buffer2));
+  OLA_ASSERT_EQ(4u, port.WriteCount());
+  OLA_ASSERT_DMX_EQUALS(buffer2, port.ReadDMX());
+
+  // An unchanged frame is sent once the refresh interval has passed
+  clock.AdvanceTime(0, 500000);
+  OLA_ASSERT(universe.SetDMX(buffer2));
+  OLA_ASSERT_EQ(4u, port.WriteCount());
+  clock.AdvanceTime(0, 600000);
+  OLA_ASSERT(universe.SetDMX(buffer2));
+  OLA_ASSERT_EQ(5u, port.WriteCount());
+
+  // A new port gets the current frame
+  TestMockOutputPort port2(NULL, 2);
+  universe.AddPort(&port2);
+  OLA_ASSERT(universe.SetDMX(buffer2));
+  OLA_ASSERT_EQ(6u, port.WriteCount());
+  OLA_ASSERT_EQ(1u, port2.WriteCount());
+  OLA_ASSERT_DMX_EQUALS(buffer2, port2.ReadDMX());
+}
+
+
+/*
+ * Check that the time from new data arriving to the output ports being
+ * written is recorded.
+ */
+void UniverseTest::testLatencyHistogram() {
+  MockClock clock;
+  ExportMap export_map;
+  ola::io::SelectServer ss(NULL, &clock);
+  TimeStamp wake_up_time;
+  MockSelectServer mock_ss(&wake_up_time);
+  ola::PluginAdaptor plugin_adaptor(NULL, &mock_ss, NULL, NULL, NULL, NULL,
+                                    NULL);
+  MockDevice device(NULL, "foo");
+  TestMockInputPort input_port(&device, 1, &plugin_adaptor);
+  TestMockOutputPort output_port(&device, 1);
+
+  Universe universe(TEST_UNIVERSE, m_store, &export_map, &clock, &ss);
+  universe.AddPort(&input_port);
+  universe.AddPort(&output_port);
+  input_port.SetUniverse(&universe);
+
+  HistogramVariable *latency = export_map.GetHistogramVar(
+      string(Universe::K_UNIVERSE_LATENCY_VAR) + "1");
+  OLA_ASSERT_EQ(0u, latency->Count());
+
+  // A change which doesn't affect the output isn't measured
+  input_port.DmxChanged();
+  OLA_ASSERT_EQ(0u, output_port.WriteCount());
+  clock.AdvanceTime(0, 20000);
+
+  // Without a rate limit, the data is written straight away
+  clock.CurrentMonotonicTime(&wake_up_time);
+  input_port.WriteDMX(m_buffer);
+  input_port.DmxChanged();
+  OLA_ASSERT_EQ(1u, output_port.WriteCount());
+  OLA_ASSERT_EQ(1u, latency->Count());
+  OLA_ASSERT_LT(latency->Max(), 20000u);
+
+  // Setting the DMX directly doesn't record a sample
+  OLA_ASSERT(universe.SetDMX(m_buffer));
+  OLA_ASSERT_EQ(2u, output_port.WriteCount());
+  OLA_ASSERT_EQ(1u, latency->Count());
+
+  // With a rate limit, held back data is measured from the first change
+  universe.SetMaxOutputRate(40);
+  input_port.DmxChanged();
+  OLA_ASSERT_EQ(3u, output_port.WriteCount());
+  OLA_ASSERT_EQ(2u, latency->Count());
+
+  clock.AdvanceTime(0, 10000);
+  clock.CurrentMonotonicTime(&wake_up_time);
+  input_port.DmxChanged();
+  clock.AdvanceTime(0, 5000);
+  clock.CurrentMonotonicTime(&wake_up_time);
+  input_port.DmxChanged();
+  OLA_ASSERT_EQ(3u, output_port.WriteCount());
+  OLA_ASSERT_EQ(2u, latency->Count());
+
+  clock.AdvanceTime(0, 10000);
+  ss.RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(4u, output_port.WriteCount());
+  OLA_ASSERT_EQ(3u, latency->Count());
+  OLA_ASSERT_TRUE(latency->Max() >= 15000);
+  OLA_ASSERT_TRUE(latency->Percentile(100) >= 15000);
+
+  // The histogram is removed with the universe
+  {
+    Universe other(TEST_UNIVERSE + 1, m_store, &export_map, &clock, &ss);
+    OLA_ASSERT_EQ((size_t) 2, export_map.AllHistograms().size());
+  }
+  OLA_ASSERT_EQ((size_t) 1, export_map.AllHistograms().size());
+  OLA_ASSERT_EQ(latency, export_map.AllHistograms()[0]);
+}
+
+
+/*
+ * Check that thread safe ports are written from the output workers.
+ */
+void UniverseTest::testOutputWorkers() {
+  OutputWorkerPool pool(2);
+  OLA_ASSERT_TRUE(pool.Start());
+  OLA_ASSERT_EQ(2u, pool.WorkerCount());
+  ExecutorInterface *worker = pool.WorkerFor(TEST_UNIVERSE);
+  OLA_ASSERT_NOT_NULL(worker);
+  OLA_ASSERT_TRUE(worker != pool.WorkerFor(TEST_UNIVERSE + 1));
+  OLA_ASSERT_EQ(worker, pool.WorkerFor(TEST_UNIVERSE + 2));
+
+  m_store->SetOutputWorkerPool(&pool);
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  TestMockOutputPort port(NULL, 1);
+  TestMockThreadedOutputPort threaded_port(NULL, 2);
+  universe->AddPort(&port);
+  universe->AddPort(&threaded_port);
+
+  // Ports that aren't thread safe are written straight away, the others are
+  // written by the worker.
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(1u, port.WriteCount());
+  WaitForExecutor(worker);
+  OLA_ASSERT_EQ(1u, threaded_port.WriteCount());
+  OLA_ASSERT_DMX_EQUALS(m_buffer, threaded_port.ReadDMX());
+  OLA_ASSERT_FALSE(pthread_equal(Thread::Self(), threaded_port.WriteThread()));
+
+  // A worker that falls behind only writes the latest frame
+  DmxBuffer buffer;
+  for (unsigned int i = 0; i < 100; i++) {
+    buffer.SetChannel(0, i);
+    OLA_ASSERT(universe->SetDMX(buffer));
+  }
+  OLA_ASSERT_EQ(101u, port.WriteCount());
+  WaitForExecutor(worker);
+  unsigned int write_count = threaded_port.WriteCount();
+  OLA_ASSERT_TRUE(write_count >= 2 && write_count <= 101);
+  OLA_ASSERT_DMX_EQUALS(buffer, threaded_port.ReadDMX());
+
+  // Once the port is removed it isn't written to
+  universe->RemovePort(&threaded_port);
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  WaitForExecutor(worker);
+  OLA_ASSERT_EQ(write_count, threaded_port.WriteCount());
+  OLA_ASSERT_EQ(102u, port.WriteCount());
+
+  // Without the pool, all ports are written from this thread
+  m_store->SetOutputWorkerPool(NULL);
+  universe->AddPort(&threaded_port);
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_EQ(write_count + 1, threaded_port.WriteCount());
+  OLA_ASSERT_TRUE(pthread_equal(Thread::Self(), threaded_port.WriteThread()));
+
+  universe->RemovePort(&port);
+  universe->RemovePort(&threaded_port);
+}
+
+
 /*
  * Check that we update when ports have new data
  */
@@ -0,0 +1,172 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * dmx_ingest_benchmark.cpp
+ * Measure how many client DMX frames per second a single core can push
+ * through the server's ingest & merge path.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/protocol/Ola.pb.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/rdm/UID.h"
+#include "ola/stl/STLUtils.h"
+#include "olad/DmxSource.h"
+#include "olad/Preferences.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+using ola::Client;
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::DmxSource;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::Universe;
+using std::auto_ptr;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(frames, f, 200000, "The number of frames to send per run");
+DEFINE_s_uint16(clients, c, 2, "The number of clients sending to the universe");
+
+static const unsigned int UNIVERSE_ID = 1;
+
+/**
+ * How often we update the source timestamp, the server does this once per
+ * loop of the SelectServer.
+ */
+static const unsigned int TIMESTAMP_INTERVAL = 1000;
+
+typedef enum {
+  INGEST_COPY,  // the original DmxBuffer -> DmxSource -> map copy
+  INGEST_IN_PLACE,  // copy straight into the client's buffer
+} ingest_mode;
+
+/**
+ * Run the ingest path for FLAGS_frames frames, round robin over the clients.
+ */
+TimeInterval RunIngest(ingest_mode mode,
+                       Universe *universe,
+                       const vector<Client*> &clients,
+                       const vector<string> &serialized) {
+  Clock clock;
+  TimeStamp start, end, now;
+  clock.CurrentMonotonicTime(&start);
+  now = start;
+
+  for (unsigned int i = 0; i < FLAGS_frames; i++) {
+    if (i % TIMESTAMP_INTERVAL == 0) {
+      clock.CurrentMonotonicTime(&now);
+    }
+    const unsigned int index = i % clients.size();
+    Client *client = clients[index];
+
+    // The RPC layer creates a new request message for each call.
+    auto_ptr<ola::proto::DmxData> request(new ola::proto::DmxData());
+    request->ParseFromString(serialized[index]);
+
+    if (mode == INGEST_COPY) {
+      DmxBuffer buffer;
+      buffer.Set(request->data());
+      DmxSource source(buffer, now, request->priority());
+      client->DMXReceived(request->universe(), source);
+    } else {
+      const string &data = request->data();
+      client->DMXReceived(request->universe(),
+                          reinterpret_cast<const uint8_t*>(data.data()),
+                          data.size(), now, request->priority());
+    }
+    universe->SourceClientDataChanged(client);
+  }
+  clock.CurrentMonotonicTime(&end);
+  return end - start;
+}
+
+/**
+ * Print the result of a run.
+ */
+void PrintResult(const string &name, const TimeInterval &duration) {
+  double total_usec = static_cast<double>(duration.AsInt());
+  double ns_per_frame = total_usec * 1000.0 / FLAGS_frames;
+  cout << std::left << std::setw(12) << name << std::right << std::fixed
+       << std::setprecision(1) << std::setw(10) << ns_per_frame
+       << " ns/frame " << std::setw(12) << std::setprecision(0)
+       << (ns_per_frame > 0 ? 1e9 / ns_per_frame : 0) << " frames/s" << endl;
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Benchmark the client DMX ingest and merge path.");
+
+  if (FLAGS_clients == 0 || FLAGS_frames == 0) {
+    return -1;
+  }
+
+  ola::MemoryPreferences preferences("benchmark");
+  ola::UniverseStore store(&preferences, NULL);
+  Universe *universe = store.GetUniverseOrCreate(UNIVERSE_ID);
+  universe->SetMergeMode(Universe::MERGE_HTP);
+
+  vector<Client*> clients;
+  vector<string> serialized;
+  for (unsigned int i = 0; i < FLAGS_clients; i++) {
+    Client *client = new Client(
+        NULL, ola::rdm::UID(ola::OPEN_LIGHTING_ESTA_CODE, i));
+    clients.push_back(client);
+    universe->AddSourceClient(client);
+
+    uint8_t slots[ola::DMX_UNIVERSE_SIZE];
+    for (unsigned int j = 0; j < ola::DMX_UNIVERSE_SIZE; j++) {
+      slots[j] = static_cast<uint8_t>(i * 31 + j);
+    }
+    ola::proto::DmxData request;
+    request.set_universe(UNIVERSE_ID);
+    request.set_data(string(reinterpret_cast<char*>(slots), sizeof(slots)));
+    request.set_priority(ola::dmx::SOURCE_PRIORITY_DEFAULT);
+    string output;
+    request.SerializeToString(&output);
+    serialized.push_back(output);
+  }
+
+  cout << FLAGS_clients << " clients, " << FLAGS_frames
+       << " frames of " << ola::DMX_UNIVERSE_SIZE << " slots per run" << endl;
+
+  PrintResult("copy", RunIngest(INGEST_COPY, universe, clients, serialized));
+  PrintResult("in-place",
+              RunIngest(INGEST_IN_PLACE, universe, clients, serialized));
+
+  vector<Client*>::iterator iter = clients.begin();
+  for (; iter != clients.end(); ++iter) {
+    universe->RemoveSourceClient(*iter);
+  }
+  store.DeleteAll();
+  ola::STLDeleteElements(&clients);
+  return 0;
+}
@@ -0,0 +1,225 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * output_worker_benchmark.cpp
+ * Measure how the number of frames written to output ports scales with the
+ * number of output workers.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/thread/Future.h"
+#include "ola/stl/STLUtils.h"
+#include "olad/Port.h"
+#include "olad/Preferences.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/OutputWorkerPool.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::OutputWorkerPool;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::Universe;
+using ola::thread::Future;
+using std::auto_ptr;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(frames, f, 2000, "The number of frames to send per universe");
+DEFINE_s_uint16(universes, u, 32, "The number of universes");
+DEFINE_s_uint32(work_us, w, 20,
+                "The time in microseconds each port spends writing a frame");
+
+/*
+ * An output port that takes a fixed amount of CPU time to write each frame,
+ * similar to a port that has to encode the frame before sending it.
+ */
+class BenchmarkPort: public ola::BasicOutputPort {
+ public:
+  explicit BenchmarkPort(unsigned int port_id)
+      : ola::BasicOutputPort(NULL, port_id),
+        m_write_count(0) {
+  }
+
+  string Description() const { return ""; }
+
+  bool WriteDMX(const DmxBuffer &buffer, uint8_t priority) {
+    TimeStamp start, now;
+    m_clock.CurrentMonotonicTime(&start);
+    do {
+      m_clock.CurrentMonotonicTime(&now);
+    } while ((now - start).AsInt() < FLAGS_work_us);
+    m_write_count++;
+    (void) buffer;
+    (void) priority;
+    return true;
+  }
+
+  bool SupportsThreadedOutput() const { return true; }
+
+  // Only valid once the worker has stopped using the port.
+  unsigned int WriteCount() const { return m_write_count; }
+
+ private:
+  Clock m_clock;
+  unsigned int m_write_count;
+};
+
+void SetFuture(Future<void> f) {
+  f.Set();
+}
+
+/**
+ * Block until all the workers have finished their pending writes.
+ */
+void WaitForWorkers(const OutputWorkerPool *pool) {
+  vector<Future<void> > futures;
+  for (unsigned int i = 0; i < pool->WorkerCount(); i++) {
+    Future<void> f;
+    pool->WorkerFor(i)->Execute(ola::NewSingleCallback(SetFuture, f));
+    futures.push_back(f);
+  }
+  vector<Future<void> >::iterator iter = futures.begin();
+  for (; iter != futures.end(); ++iter) {
+    iter->Get();
+  }
+}
+
+/**
+ * Send FLAGS_frames frames to each universe and return the number of frames
+ * the ports wrote.
+ *
+ * Each frame is sent to all universes and then we wait for the writes to
+ * complete, so no frames are coalesced and the run time is the time taken to
+ * write every frame.
+ */
+unsigned int RunOutput(ola::UniverseStore *store,
+                       const vector<Universe*> &universes,
+                       const vector<BenchmarkPort*> &ports,
+                       unsigned int worker_count,
+                       TimeInterval *duration) {
+  auto_ptr<OutputWorkerPool> pool;
+  if (worker_count) {
+    pool.reset(new OutputWorkerPool(worker_count));
+    if (!pool->Start()) {
+      return 0;
+    }
+    store->SetOutputWorkerPool(pool.get());
+  }
+
+  vector<unsigned int> initial_counts;
+  vector<BenchmarkPort*>::const_iterator port_iter = ports.begin();
+  for (; port_iter != ports.end(); ++port_iter) {
+    initial_counts.push_back((*port_iter)->WriteCount());
+  }
+
+  Clock clock;
+  TimeStamp start, end;
+  clock.CurrentMonotonicTime(&start);
+
+  DmxBuffer buffer;
+  buffer.Blackout();
+  for (unsigned int i = 0; i < FLAGS_frames; i++) {
+    buffer.SetChannel(0, static_cast<uint8_t>(i));
+    vector<Universe*>::const_iterator iter = universes.begin();
+    for (; iter != universes.end(); ++iter) {
+      (*iter)->SetDMX(buffer);
+    }
+    if (pool.get()) {
+      WaitForWorkers(pool.get());
+    }
+  }
+  clock.CurrentMonotonicTime(&end);
+  *duration = end - start;
+
+  store->SetOutputWorkerPool(NULL);
+
+  unsigned int frames = 0;
+  for (unsigned int i = 0; i < ports.size(); i++) {
+    frames += ports[i]->WriteCount() - initial_counts[i];
+  }
+  return frames;
+}
+
+/**
+ * Print the result of a run.
+ */
+void PrintResult(unsigned int worker_count, unsigned int frames,
+                 const TimeInterval &duration) {
+  std::ostringstream name;
+  name << worker_count << " workers";
+  double seconds = static_cast<double>(duration.AsInt()) / 1000000.0;
+  cout << std::left << std::setw(12) << name.str() << std::right
+       << std::fixed << std::setprecision(0) << std::setw(12)
+       << (seconds > 0 ? frames / seconds : 0) << " frames/s" << endl;
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Benchmark writing to output ports from output workers.");
+
+  if (FLAGS_universes == 0 || FLAGS_frames == 0) {
+    return -1;
+  }
+
+  ola::MemoryPreferences preferences("benchmark");
+  ola::UniverseStore store(&preferences, NULL);
+
+  vector<Universe*> universes;
+  vector<BenchmarkPort*> ports;
+  for (unsigned int i = 0; i < FLAGS_universes; i++) {
+    Universe *universe = store.GetUniverseOrCreate(i + 1);
+    BenchmarkPort *port = new BenchmarkPort(i);
+    universe->AddPort(port);
+    universes.push_back(universe);
+    ports.push_back(port);
+  }
+
+  cout << FLAGS_universes << " universes, " << FLAGS_frames
+       << " frames per universe, " << FLAGS_work_us << " us per write"
+       << endl;
+
+  const unsigned int worker_counts[] = {0, 1, 2, 4, 8};
+  for (unsigned int i = 0; i < sizeof(worker_counts) / sizeof(unsigned int);
+       i++) {
+    TimeInterval duration;
+    unsigned int frames = RunOutput(&store, universes, ports,
+                                    worker_counts[i], &duration);
+    PrintResult(worker_counts[i], frames, duration);
+  }
+
+  for (unsigned int i = 0; i < universes.size(); i++) {
+    universes[i]->RemovePort(ports[i]);
+  }
+  store.DeleteAll();
+  ola::STLDeleteElements(&ports);
+  return 0;
+}
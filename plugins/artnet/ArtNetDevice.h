@@ -79,6 +79,7 @@ class ArtNetDevice: public Device {
   static const char K_LOOPBACK_KEY[];
   static const char K_NET_KEY[];
   static const char K_OUTPUT_PORT_KEY[];
+  static const char K_SEND_SYNC_KEY[];
   static const char K_SHORT_NAME_KEY[];
   static const char K_SUBNET_KEY[];
   static const unsigned int K_ARTNET_NET;
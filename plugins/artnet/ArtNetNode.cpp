@@ -75,6 +75,10 @@ using std::vector;
 
 
 const char ArtNetNodeImpl::ARTNET_ID[] = "Art-Net";
+const char ArtNetNodeImpl::K_DMX_PACKETS_VAR[] = "artnet-dmx-packets";
+const char ArtNetNodeImpl::K_DMX_SEND_CALLS_VAR[] = "artnet-dmx-send-calls";
+const char ArtNetNodeImpl::K_DMX_SEND_FAILURES_VAR[] =
+    "artnet-dmx-send-failures";
 
 
 // UID to the IP Address it came from, and the number of times since we last
@@ -207,16 +211,31 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
       m_ss(ss),
       m_always_broadcast(options.always_broadcast),
       m_use_limited_broadcast_address(options.use_limited_broadcast_address),
+      m_send_sync(options.send_sync),
+      m_sync_timeout(ola::thread::INVALID_TIMEOUT),
+      m_sync_mode_timeout(ola::thread::INVALID_TIMEOUT),
       m_in_configuration_mode(false),
       m_artpoll_required(false),
       m_artpollreply_required(false),
       m_interface(iface),
-      m_socket(socket) {
+      m_socket(socket),
+      m_recv_batch(sizeof(artnet_packet)),
+      m_dmx_packets_var(NULL),
+      m_dmx_send_calls_var(NULL),
+      m_dmx_send_failures_var(NULL) {
 
   if (!m_socket.get()) {
     m_socket.reset(new UDPSocket());
   }
 
+  if (options.export_map) {
+    m_dmx_packets_var = options.export_map->GetCounterVar(K_DMX_PACKETS_VAR);
+    m_dmx_send_calls_var = options.export_map->GetCounterVar(
+        K_DMX_SEND_CALLS_VAR);
+    m_dmx_send_failures_var = options.export_map->GetCounterVar(
+        K_DMX_SEND_FAILURES_VAR);
+  }
+
   for (unsigned int i = 0; i < options.input_port_count; i++) {
     m_input_ports.push_back(new InputPort());
   }
@@ -229,6 +248,7 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
     m_output_ports[i].is_merging = false;
     m_output_ports[i].merge_mode = ARTNET_MERGE_HTP;
     m_output_ports[i].buffer = NULL;
+    m_output_ports[i].sync_pending = false;
     m_output_ports[i].on_data = NULL;
     m_output_ports[i].on_discover = NULL;
     m_output_ports[i].on_flush = NULL;
@@ -302,6 +322,16 @@ bool ArtNetNodeImpl::Stop() {
     }
   }
 
+  if (m_sync_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_sync_timeout);
+    m_sync_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  if (m_sync_mode_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_sync_mode_timeout);
+    m_sync_mode_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
   m_ss->RemoveReadDescriptor(m_socket.get());
 
   m_running = false;
@@ -569,7 +599,17 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
         IPV4Address::Broadcast() :
         m_interface.bcast_address);
     port->sequence_number++;
+    ScheduleSync();
+    if (m_dmx_packets_var) {
+      if (sent_ok) {
+        (*m_dmx_packets_var)++;
+      } else {
+        (*m_dmx_send_failures_var)++;
+      }
+      (*m_dmx_send_calls_var)++;
+    }
   } else {
+    m_dmx_destinations.clear();
     map<IPV4Address, TimeStamp>::iterator iter = port->subscribed_nodes.begin();
     TimeStamp last_heard_threshold = (
         *m_ss->WakeUpTime() - TimeInterval(NODE_TIMEOUT, 0));
@@ -579,7 +619,8 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
         port->subscribed_nodes.erase(iter++);
         continue;
       }
-      sent_ok |= SendPacket(packet, size, iter->first);
+      m_dmx_destinations.push_back(IPV4SocketAddress(iter->first,
+                                                     ARTNET_PORT));
       ++iter;
     }
 
@@ -589,8 +630,10 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
                 << static_cast<int>(port->PortAddress());
       sent_ok = true;
     } else {
+      sent_ok = SendPacketToMany(packet, size, m_dmx_destinations);
       // We sent at least one packet, increment the sequence number
       port->sequence_number++;
+      ScheduleSync();
     }
   }
 
@@ -600,6 +643,33 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
   return sent_ok;
 }
 
+bool ArtNetNodeImpl::SendSync() {
+  if (m_sync_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_sync_timeout);
+    m_sync_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  if (!m_running) {
+    return false;
+  }
+
+  artnet_packet packet;
+  PopulatePacketHeader(&packet, ARTNET_SYNC);
+  memset(&packet.data.sync, 0, sizeof(packet.data.sync));
+  packet.data.sync.version = HostToNetwork(ARTNET_VERSION);
+
+  bool sent_ok = SendPacket(
+      packet,
+      sizeof(packet.data.sync),
+      m_use_limited_broadcast_address ?
+      IPV4Address::Broadcast() :
+      m_interface.bcast_address);
+  if (!sent_ok) {
+    OLA_WARN << "Failed to send Art-Net Sync packet";
+  }
+  return sent_ok;
+}
+
 void ArtNetNodeImpl::RunFullDiscovery(uint8_t port_id,
                                       RDMDiscoveryCallback *callback) {
   InputPort *port = GetEnabledInputPort(port_id, "ArtTodControl");
@@ -851,17 +921,13 @@ bool ArtNetNodeImpl::SendTimeCode(const ola::timecode::TimeCode &timecode) {
 }
 
 void ArtNetNodeImpl::SocketReady() {
-  artnet_packet packet;
-  ssize_t packet_size = sizeof(packet);
-  ola::network::IPV4SocketAddress source;
-
-  if (!m_socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                          &packet_size,
-                          &source)) {
-    return;
+  const unsigned int count = m_socket->RecvBatch(&m_recv_batch);
+  for (unsigned int i = 0; i < count; i++) {
+    HandlePacket(
+        m_recv_batch.Source(i).Host(),
+        *reinterpret_cast<const artnet_packet*>(m_recv_batch.Data(i)),
+        m_recv_batch.Size(i));
   }
-
-  HandlePacket(source.Host(), packet, packet_size);
 }
 
 bool ArtNetNodeImpl::SendPollIfAllowed() {
@@ -1004,8 +1070,9 @@ void ArtNetNodeImpl::HandlePacket(const IPV4Address &source_address,
                       packet_size - header_size);
       break;
     case ARTNET_SYNC:
-      // TODO(Someone): Implement me, not currently implemented.
-      OLA_DEBUG << "ArtSync input not currently supported";
+      HandleSyncPacket(source_address,
+                       packet.data.sync,
+                       packet_size - header_size);
       break;
     case ARTNET_RDM_SUB:
       // TODO(Someone): Implement me, not currently implemented.
@@ -1130,6 +1197,40 @@ void ArtNetNodeImpl::HandleDataPacket(const IPV4Address &source_address,
   }
 }
 
+void ArtNetNodeImpl::HandleSyncPacket(const IPV4Address &source_address,
+                                      const artnet_sync_t &packet,
+                                      unsigned int packet_size) {
+  // ignore the ArtSyncs we broadcast ourselves
+  if (m_interface.ip_address == source_address) {
+    return;
+  }
+
+  if (!CheckPacketSize(source_address,
+                       "ArtSync",
+                       packet_size,
+                       sizeof(packet))) {
+    return;
+  }
+
+  if (!CheckPacketVersion(source_address, "ArtSync", packet.version)) {
+    return;
+  }
+
+  if (!InSyncMode()) {
+    OLA_INFO << "Art-Net entering synchronous mode";
+  }
+  m_last_sync = *m_ss->WakeUpTime();
+
+  if (m_sync_mode_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_sync_mode_timeout);
+  }
+  m_sync_mode_timeout = m_ss->RegisterSingleTimeout(
+      TimeInterval(SYNC_TIMEOUT, 0),
+      NewSingleCallback(this, &ArtNetNodeImpl::SyncModeTimeout));
+
+  OutputSyncData();
+}
+
 void ArtNetNodeImpl::HandleTodRequest(const IPV4Address &source_address,
                                       const artnet_todrequest_t &packet,
                                       unsigned int packet_size) {
@@ -1467,6 +1568,72 @@ bool ArtNetNodeImpl::SendPacket(const artnet_packet &packet,
   return true;
 }
 
+bool ArtNetNodeImpl::SendPacketToMany(
+    const artnet_packet &packet,
+    unsigned int size,
+    const vector<IPV4SocketAddress> &destinations) {
+  size += sizeof(packet.id) + sizeof(packet.op_code);
+  unsigned int send_calls = 0;
+  unsigned int sent = m_socket->SendToMany(
+      reinterpret_cast<const uint8_t*>(&packet),
+      size,
+      destinations,
+      &send_calls);
+
+  // Only the datagrams the socket reports as sent are counted as packets.
+  if (m_dmx_packets_var) {
+    (*m_dmx_packets_var) += sent;
+    (*m_dmx_send_failures_var) += destinations.size() - sent;
+    (*m_dmx_send_calls_var) += send_calls;
+  }
+
+  if (sent != destinations.size()) {
+    OLA_INFO << "Only sent " << sent << " of " << destinations.size()
+             << " packets";
+  }
+  return sent > 0;
+}
+
+void ArtNetNodeImpl::ScheduleSync() {
+  if (!m_send_sync || m_sync_timeout != ola::thread::INVALID_TIMEOUT) {
+    return;
+  }
+  m_sync_timeout = m_ss->RegisterSingleTimeout(
+      0, NewSingleCallback(this, &ArtNetNodeImpl::ScheduledSync));
+}
+
+void ArtNetNodeImpl::ScheduledSync() {
+  m_sync_timeout = ola::thread::INVALID_TIMEOUT;
+  SendSync();
+}
+
+bool ArtNetNodeImpl::InSyncMode() const {
+  if (!m_last_sync.IsSet()) {
+    return false;
+  }
+  return m_last_sync > *m_ss->WakeUpTime() - TimeInterval(SYNC_TIMEOUT, 0);
+}
+
+void ArtNetNodeImpl::SyncModeTimeout() {
+  m_sync_mode_timeout = ola::thread::INVALID_TIMEOUT;
+  m_last_sync = TimeStamp();
+  OLA_INFO << "No ArtSync for " << SYNC_TIMEOUT
+           << "s, Art-Net leaving synchronous mode";
+  OutputSyncData();
+}
+
+void ArtNetNodeImpl::OutputSyncData() {
+  for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
+    OutputPort *port = &m_output_ports[port_id];
+    if (port->sync_pending && port->enabled && port->on_data &&
+        port->buffer) {
+      port->sync_pending = false;
+      (*port->buffer) = port->sync_buffer;
+      port->on_data->Run();
+    }
+  }
+}
+
 void ArtNetNodeImpl::TimeoutRDMRequest(InputPort *port) {
   OLA_INFO << "RDM Request timed out.";
   port->rdm_send_timeout = ola::thread::INVALID_TIMEOUT;
@@ -1551,25 +1718,34 @@ void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
 
   port->sources[source_slot] = source;
 
+  // In synchronous mode the data is held until the next ArtSync. The spec
+  // says ArtSync is ignored while merging.
+  bool hold = InSyncMode() && !port->is_merging;
+  DmxBuffer *output = hold ? &port->sync_buffer : port->buffer;
+
   // Now we need to merge
   if (port->merge_mode == ARTNET_MERGE_LTP) {
     // the current source is the latest
-    (*port->buffer) = source.buffer;
+    (*output) = source.buffer;
   } else {
     // HTP merge
     bool first = true;
     for (unsigned int i = 0; i < MAX_MERGE_SOURCES; i++) {
       if (!port->sources[i].address.IsWildcard()) {
         if (first) {
-          (*port->buffer) = port->sources[i].buffer;
+          (*output) = port->sources[i].buffer;
           first = false;
         } else {
-          port->buffer->HTPMerge(port->sources[i].buffer);
+          output->HTPMerge(port->sources[i].buffer);
         }
       }
     }
   }
-  port->on_data->Run();
+
+  port->sync_pending = hold;
+  if (!hold) {
+    port->on_data->Run();
+  }
 }
 
 bool ArtNetNodeImpl::CheckPacketVersion(const IPV4Address &source_address,
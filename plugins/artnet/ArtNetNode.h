@@ -30,6 +30,7 @@
 #include "ola/Callback.h"
 #include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/Interface.h"
 #include "ola/io/SelectServerInterface.h"
@@ -69,7 +70,9 @@ class ArtNetNodeOptions {
         use_limited_broadcast_address(false),
         rdm_queue_size(20),
         broadcast_threshold(30),
-        input_port_count(4) {
+        input_port_count(4),
+        send_sync(false),
+        export_map(NULL) {
   }
 
   bool always_broadcast;
@@ -77,6 +80,10 @@ class ArtNetNodeOptions {
   unsigned int rdm_queue_size;
   unsigned int broadcast_threshold;
   uint8_t input_port_count;
+  // send an ArtSync once the DMX for a frame has been sent
+  bool send_sync;
+  // if not NULL, DMX transmit stats are recorded here
+  ola::ExportMap *export_map;
 };
 
 
@@ -256,6 +263,16 @@ class ArtNetNodeImpl {
    */
   bool SendDMX(uint8_t port_id, const ola::DmxBuffer &buffer);
 
+  /**
+   * @brief Send an ArtSync.
+   *
+   * If send_sync is set, an ArtSync is sent automatically once the current
+   * batch of SendDMX() calls has completed, i.e. when control returns to the
+   * SelectServer. This allows a caller to send one sooner.
+   * @return true if it was sent successfully, false otherwise
+   */
+  bool SendSync();
+
   /**
    * @brief Flush the TOD and force a full discovery.
    *
@@ -378,6 +395,9 @@ class ArtNetNodeImpl {
     bool is_merging;
     DMXSource sources[MAX_MERGE_SOURCES];
     DmxBuffer *buffer;
+    // holds the merged data in synchronous mode until an ArtSync arrives
+    bool sync_pending;
+    DmxBuffer sync_buffer;
     std::map<ola::rdm::UID, ola::network::IPV4Address> uid_map;
     Callback0<void> *on_data;
     Callback0<void> *on_discover;
@@ -397,6 +417,12 @@ class ArtNetNodeImpl {
   ola::io::SelectServerInterface *m_ss;
   bool m_always_broadcast;
   bool m_use_limited_broadcast_address;
+  bool m_send_sync;
+  ola::thread::timeout_id m_sync_timeout;
+  // when we last received an ArtSync
+  TimeStamp m_last_sync;
+  // fires SYNC_TIMEOUT after the last ArtSync, to leave synchronous mode
+  ola::thread::timeout_id m_sync_mode_timeout;
 
   // The following keep track of "Configuration mode"
   bool m_in_configuration_mode;
@@ -407,6 +433,11 @@ class ArtNetNodeImpl {
   OutputPort m_output_ports[ARTNET_MAX_PORTS];
   ola::network::Interface m_interface;
   std::auto_ptr<ola::network::UDPSocketInterface> m_socket;
+  ola::network::DatagramBatch m_recv_batch;
+  std::vector<ola::network::IPV4SocketAddress> m_dmx_destinations;
+  ola::CounterVariable *m_dmx_packets_var;
+  ola::CounterVariable *m_dmx_send_calls_var;
+  ola::CounterVariable *m_dmx_send_failures_var;
 
   /**
    * @brief Called when there is data on this socket
@@ -467,6 +498,13 @@ class ArtNetNodeImpl {
                         const artnet_dmx_t &packet,
                         unsigned int packet_size);
 
+  /**
+   * @brief Handle an ArtSync packet, this outputs any held data
+   */
+  void HandleSyncPacket(const ola::network::IPV4Address &source_address,
+                        const artnet_sync_t &packet,
+                        unsigned int packet_size);
+
   /**
    * @brief Handle a TOD Request packet
    */
@@ -539,6 +577,45 @@ class ArtNetNodeImpl {
                   unsigned int size,
                   const ola::network::IPV4Address &destination);
 
+  /**
+   * @brief Send an Art-Net packet to many nodes at once
+   * @param packet the packet to send
+   * @param size the size of the packet, excluding the header portion
+   * @param destinations where to send the packet to
+   * @returns true if the packet was sent to at least one node
+   */
+  bool SendPacketToMany(
+      const artnet_packet &packet,
+      unsigned int size,
+      const std::vector<ola::network::IPV4SocketAddress> &destinations);
+
+  /**
+   * @brief Send an ArtSync once control returns to the SelectServer
+   */
+  void ScheduleSync();
+
+  /**
+   * @brief Called when the scheduled ArtSync is due
+   */
+  void ScheduledSync();
+
+  /**
+   * @brief Check if we're in synchronous mode, i.e. we've received an ArtSync
+   * recently.
+   */
+  bool InSyncMode() const;
+
+  /**
+   * @brief Called when no ArtSync has arrived for SYNC_TIMEOUT. This leaves
+   * synchronous mode and outputs any held data.
+   */
+  void SyncModeTimeout();
+
+  /**
+   * @brief Output the data held for an ArtSync.
+   */
+  void OutputSyncData();
+
   /**
    * @brief Timeout a pending RDM request
    * @param port the id of the port to timeout.
@@ -631,6 +708,9 @@ class ArtNetNodeImpl {
   bool InitNetwork();
 
   static const char ARTNET_ID[];
+  static const char K_DMX_PACKETS_VAR[];
+  static const char K_DMX_SEND_CALLS_VAR[];
+  static const char K_DMX_SEND_FAILURES_VAR[];
   static const uint16_t ARTNET_PORT = 6454;
   static const uint16_t OEM_CODE = 0x0431;
   static const uint16_t ARTNET_VERSION = 14;
@@ -643,6 +723,8 @@ class ArtNetNodeImpl {
   static const unsigned int MERGE_TIMEOUT = 10;  // As per the spec
   // seconds after which a node is marked as inactive for the dmx merging
   static const unsigned int NODE_TIMEOUT = 31;
+  // seconds without an ArtSync after which we revert to asynchronous mode
+  static const unsigned int SYNC_TIMEOUT = 4;
   // mseconds we wait for a TodData packet before declaring a node missing
   static const unsigned int RDM_TOD_TIMEOUT_MS = 4000;
   // Number of missed TODs before we decide a UID has gone
@@ -783,6 +865,10 @@ class ArtNetNode {
     return m_impl.SendDMX(port_id, buffer);
   }
 
+  bool SendSync() {
+    return m_impl.SendSync();
+  }
+
   /**
    * @brief Trigger full discovery for a port
    */
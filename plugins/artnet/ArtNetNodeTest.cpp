@@ -26,6 +26,7 @@
 
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/IPV4Address.h"
@@ -77,8 +78,11 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testBroadcastSendDMXZeroUniverse);
   CPPUNIT_TEST(testLimitedBroadcastDMX);
   CPPUNIT_TEST(testNonBroadcastSendDMX);
+  CPPUNIT_TEST(testSendSync);
   CPPUNIT_TEST(testReceiveDMX);
   CPPUNIT_TEST(testReceiveDMXZeroUniverse);
+  CPPUNIT_TEST(testReceiveSync);
+  CPPUNIT_TEST(testSyncModeTimeout);
   CPPUNIT_TEST(testHTPMerge);
   CPPUNIT_TEST(testLTPMerge);
   CPPUNIT_TEST(testControllerDiscovery);
@@ -118,8 +122,11 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
   void testBroadcastSendDMXZeroUniverse();
   void testLimitedBroadcastDMX();
   void testNonBroadcastSendDMX();
+  void testSendSync();
   void testReceiveDMX();
   void testReceiveDMXZeroUniverse();
+  void testReceiveSync();
+  void testSyncModeTimeout();
   void testHTPMerge();
   void testLTPMerge();
   void testControllerDiscovery();
@@ -270,6 +277,7 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
 
   static const uint8_t POLL_MESSAGE[];
   static const uint8_t POLL_REPLY_MESSAGE[];
+  static const uint8_t SYNC_MESSAGE[];
   static const uint8_t TOD_CONTROL[];
   static const uint16_t ARTNET_PORT = 6454;
 };
@@ -286,6 +294,14 @@ const uint8_t ArtNetNodeTest::POLL_MESSAGE[] = {
 };
 
 
+const uint8_t ArtNetNodeTest::SYNC_MESSAGE[] = {
+  'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+  0x00, 0x52,
+  0x0, 14,
+  0, 0
+};
+
+
 const uint8_t ArtNetNodeTest::POLL_REPLY_MESSAGE[] = {
   'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
   0x00, 0x21,
@@ -838,12 +854,86 @@ void ArtNetNodeTest::testLimitedBroadcastDMX() {
 }
 
 
+/**
+ * Check that a single ArtSync is sent after a batch of DMX frames.
+ */
+void ArtNetNodeTest::testSendSync() {
+  m_socket->SetDiscardMode(true);
+
+  ArtNetNodeOptions node_options;
+  node_options.always_broadcast = true;
+  node_options.send_sync = true;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupInputPort(&node);
+  node.SetInputPortUniverse(2, 4);
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  const uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    0, 1, 2, 3, 4, 5
+  };
+  const uint8_t DMX_MESSAGE2[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    2,  // physical port
+    0x24, 4,  // subnet & net address
+    0, 6,  // dmx length
+    0, 1, 2, 3, 4, 5
+  };
+
+  DmxBuffer dmx;
+  dmx.SetFromString("0,1,2,3,4,5");
+
+  {
+    SocketVerifier verifier(m_socket);
+    ExpectedBroadcast(DMX_MESSAGE, sizeof(DMX_MESSAGE));
+    ExpectedBroadcast(DMX_MESSAGE2, sizeof(DMX_MESSAGE2));
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+    OLA_ASSERT(node.SendDMX(2, dmx));
+  }
+
+  // The ArtSync is sent once control returns to the SelectServer
+  {
+    SocketVerifier verifier(m_socket);
+    ExpectedBroadcast(SYNC_MESSAGE, sizeof(SYNC_MESSAGE));
+    ss.RunOnce();
+  }
+
+  // Nothing further is sent until there is more DMX
+  {
+    SocketVerifier verifier(m_socket);
+    ss.RunOnce();
+  }
+
+  // Sending a sync explicitly
+  {
+    SocketVerifier verifier(m_socket);
+    ExpectedBroadcast(SYNC_MESSAGE, sizeof(SYNC_MESSAGE));
+    OLA_ASSERT(node.SendSync());
+  }
+}
+
+
 /**
  * Check sending DMX using unicast works.
  */
 void ArtNetNodeTest::testNonBroadcastSendDMX() {
   m_socket->SetDiscardMode(true);
+  ola::ExportMap export_map;
   ArtNetNodeOptions node_options;
+  node_options.export_map = &export_map;
   ArtNetNode node(iface, &ss, node_options, m_socket);
   SetupInputPort(&node);
   OLA_ASSERT(node.Start());
@@ -997,6 +1087,13 @@ void ArtNetNodeTest::testNonBroadcastSendDMX() {
     OLA_ASSERT(node.SendDMX(m_port_id, dmx));
   }
 
+  ola::CounterVariable *packets = export_map.GetCounterVar(
+      "artnet-dmx-packets");
+  ola::CounterVariable *failures = export_map.GetCounterVar(
+      "artnet-dmx-send-failures");
+  OLA_ASSERT_EQ(3u, packets->Get());
+  OLA_ASSERT_EQ(0u, failures->Get());
+
   // adjust the broadcast threshold
   {
     SocketVerifier verifier(m_socket);
@@ -1017,6 +1114,20 @@ void ArtNetNodeTest::testNonBroadcastSendDMX() {
     ExpectedBroadcast(DMX_MESSAGE3, sizeof(DMX_MESSAGE3));
     OLA_ASSERT(node.SendDMX(m_port_id, dmx));
   }
+  OLA_ASSERT_EQ(4u, packets->Get());
+
+  // Sends which fail are counted separately
+  m_socket->SetFailureMode(true);
+  OLA_ASSERT_FALSE(node.SendDMX(m_port_id, dmx));
+  OLA_ASSERT_EQ(4u, packets->Get());
+  OLA_ASSERT_EQ(1u, failures->Get());
+
+  node.SetBroadcastThreshold(3);
+  OLA_ASSERT_FALSE(node.SendDMX(m_port_id, dmx));
+  OLA_ASSERT_EQ(4u, packets->Get());
+  OLA_ASSERT_EQ(3u, failures->Get());
+  OLA_ASSERT_EQ(7u, export_map.GetCounterVar("artnet-dmx-send-calls")->Get());
+  m_socket->SetFailureMode(false);
 }
 
 /**
@@ -1166,6 +1277,143 @@ void ArtNetNodeTest::testReceiveDMXZeroUniverse() {
   }
 }
 
+/**
+ * Check that DMX is held once an ArtSync has been seen.
+ */
+void ArtNetNodeTest::testReceiveSync() {
+  m_socket->SetDiscardMode(true);
+  ArtNetNodeOptions node_options;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupOutputPort(&node);
+  DmxBuffer input_buffer;
+  node.SetDMXHandler(m_port_id,
+                     &input_buffer,
+                     ola::NewCallback(this, &ArtNetNodeTest::NewDmx));
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    0, 1, 2, 3, 4, 5
+  };
+  uint8_t DMX_MESSAGE2[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    1,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 4,  // dmx length
+    10, 11, 12, 13
+  };
+
+  // Until an ArtSync is seen, DMX is output as it arrives
+  {
+    SocketVerifier verifier(m_socket);
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("0,1,2,3,4,5"), input_buffer.ToString());
+  }
+
+  // Now receive an ArtSync, followed by DMX
+  m_got_dmx = false;
+  {
+    SocketVerifier verifier(m_socket);
+    ReceiveFromPeer(SYNC_MESSAGE, sizeof(SYNC_MESSAGE), peer_ip);
+    OLA_ASSERT_FALSE(m_got_dmx);
+    ReceiveFromPeer(DMX_MESSAGE2, sizeof(DMX_MESSAGE2), peer_ip);
+    OLA_ASSERT_FALSE(m_got_dmx);
+    OLA_ASSERT_EQ(string("0,1,2,3,4,5"), input_buffer.ToString());
+  }
+
+  // The next ArtSync releases the held frame
+  {
+    SocketVerifier verifier(m_socket);
+    ReceiveFromPeer(SYNC_MESSAGE, sizeof(SYNC_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("10,11,12,13"), input_buffer.ToString());
+  }
+
+  // Without an ArtSync for 4s, we revert to outputting DMX immediately
+  m_got_dmx = false;
+  m_clock.AdvanceTime(5, 0);
+  {
+    DMX_MESSAGE[12] = 2;
+    SocketVerifier verifier(m_socket);
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("0,1,2,3,4,5"), input_buffer.ToString());
+  }
+}
+
+
+/**
+ * Check that held DMX is output if the ArtSyncs stop.
+ */
+void ArtNetNodeTest::testSyncModeTimeout() {
+  m_socket->SetDiscardMode(true);
+  ArtNetNodeOptions node_options;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupOutputPort(&node);
+  DmxBuffer input_buffer;
+  node.SetDMXHandler(m_port_id,
+                     &input_buffer,
+                     ola::NewCallback(this, &ArtNetNodeTest::NewDmx));
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 4,  // dmx length
+    10, 11, 12, 13
+  };
+
+  // Receive an ArtSync, then DMX which is held
+  {
+    SocketVerifier verifier(m_socket);
+    ReceiveFromPeer(SYNC_MESSAGE, sizeof(SYNC_MESSAGE), peer_ip);
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT_FALSE(m_got_dmx);
+    OLA_ASSERT_EQ(0u, input_buffer.Size());
+  }
+
+  // Nothing happens before the sync timeout
+  m_clock.AdvanceTime(3, 0);
+  ss.RunOnce();
+  OLA_ASSERT_FALSE(m_got_dmx);
+
+  // Once the sync timeout passes the held frame is output, without any
+  // more packets arriving.
+  m_clock.AdvanceTime(2, 0);
+  ss.RunOnce();
+  OLA_ASSERT(m_got_dmx);
+  OLA_ASSERT_EQ(string("10,11,12,13"), input_buffer.ToString());
+
+  // And it isn't output again
+  m_got_dmx = false;
+  m_clock.AdvanceTime(5, 0);
+  ss.RunOnce();
+  OLA_ASSERT_FALSE(m_got_dmx);
+}
+
+
 /**
  * Check that merging works
  */
@@ -125,6 +125,15 @@ struct artnet_timecode_s {
 
 typedef struct artnet_timecode_s artnet_timecode_t;
 
+PACK(
+struct artnet_sync_s {
+  uint16_t version;
+  uint8_t  aux1;
+  uint8_t  aux2;
+});
+
+typedef struct artnet_sync_s artnet_sync_t;
+
 PACK(
 struct artnet_dmx_s {
   uint16_t version;
@@ -256,6 +265,7 @@ typedef struct {
     artnet_poll_t poll;
     artnet_reply_t reply;
     artnet_timecode_t timecode;
+    artnet_sync_t sync;
     artnet_dmx_t dmx;
     artnet_todrequest_t tod_request;
     artnet_toddata_t tod_data;
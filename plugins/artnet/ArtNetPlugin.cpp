@@ -110,6 +110,9 @@ bool ArtNetPlugin::SetDefaultPreferences() {
   save |= m_preferences->SetDefaultValue(ArtNetDevice::K_LOOPBACK_KEY,
                                          BoolValidator(),
                                          false);
+  save |= m_preferences->SetDefaultValue(ArtNetDevice::K_SEND_SYNC_KEY,
+                                         BoolValidator(),
+                                         false);
 
   if (save) {
     m_preferences->Save();
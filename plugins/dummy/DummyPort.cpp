@@ -109,7 +109,9 @@ DummyPort::DummyPort(DummyDevice *parent,
 bool DummyPort::WriteDMX(const DmxBuffer &buffer,
                          uint8_t priority) {
   (void) priority;
-  m_buffer = buffer;
+  // Copy rather than share the buffer, since we may be called from an output
+  // worker thread.
+  m_buffer.Set(buffer);
   ostringstream str;
   string data = buffer.Get();
 
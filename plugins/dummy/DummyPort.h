@@ -74,6 +74,7 @@ class DummyPort: public BasicOutputPort {
             unsigned int id);
   virtual ~DummyPort();
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
+  bool SupportsThreadedOutput() const { return true; }
   std::string Description() const { return "Dummy Port"; }
   void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
   void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
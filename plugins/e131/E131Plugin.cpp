@@ -43,6 +43,7 @@ const unsigned int E131Plugin::DEFAULT_DSCP_VALUE = 0;
 const char E131Plugin::DSCP_KEY[] = "dscp";
 const char E131Plugin::DRAFT_DISCOVERY_KEY[] = "draft_discovery";
 const char E131Plugin::IGNORE_PREVIEW_DATA_KEY[] = "ignore_preview";
+const char E131Plugin::IGNORE_SYNC_KEY[] = "ignore_sync";
 const char E131Plugin::INPUT_PORT_COUNT_KEY[] = "input_ports";
 const char E131Plugin::IP_KEY[] = "ip";
 const char E131Plugin::OUTPUT_PORT_COUNT_KEY[] = "output_ports";
@@ -52,7 +53,9 @@ const char E131Plugin::PREPEND_HOSTNAME_KEY[] = "prepend_hostname";
 const char E131Plugin::REVISION_0_2[] = "0.2";
 const char E131Plugin::REVISION_0_46[] = "0.46";
 const char E131Plugin::REVISION_KEY[] = "revision";
+const char E131Plugin::SYNC_UNIVERSE_KEY[] = "sync_universe";
 const unsigned int E131Plugin::DEFAULT_PORT_COUNT = 5;
+const unsigned int E131Plugin::MAX_SYNC_UNIVERSE = 63999;
 
 
 /*
@@ -68,6 +71,7 @@ bool E131Plugin::StartHook() {
       IGNORE_PREVIEW_DATA_KEY);
   options.enable_draft_discovery = m_preferences->GetValueAsBool(
       DRAFT_DISCOVERY_KEY);
+  options.ignore_sync = m_preferences->GetValueAsBool(IGNORE_SYNC_KEY);
   if (m_preferences->GetValueAsBool(PREPEND_HOSTNAME_KEY)) {
     std::ostringstream str;
     str << ola::network::Hostname() << "-" << m_plugin_adaptor->InstanceName();
@@ -86,6 +90,12 @@ bool E131Plugin::StartHook() {
     options.dscp = dscp << 2;
   }
 
+  if (!StringToInt(m_preferences->GetValue(SYNC_UNIVERSE_KEY),
+                   &options.sync_universe)) {
+    OLA_WARN << "Invalid value for sync_universe";
+    options.sync_universe = 0;
+  }
+
   if (!StringToInt(m_preferences->GetValue(INPUT_PORT_COUNT_KEY),
                    &options.input_ports)) {
     OLA_WARN << "Invalid value for input_ports";
@@ -163,6 +173,11 @@ bool E131Plugin::SetDefaultPreferences() {
       BoolValidator(),
       true);
 
+  save |= m_preferences->SetDefaultValue(
+      IGNORE_SYNC_KEY,
+      BoolValidator(),
+      false);
+
   save |= m_preferences->SetDefaultValue(
       INPUT_PORT_COUNT_KEY,
       UIntValidator(0, 512),
@@ -189,6 +204,11 @@ bool E131Plugin::SetDefaultPreferences() {
       SetValidator<string>(revision_values),
       REVISION_0_46);
 
+  save |= m_preferences->SetDefaultValue(
+      SYNC_UNIVERSE_KEY,
+      UIntValidator(0, MAX_SYNC_UNIVERSE),
+      0);
+
   if (save) {
     m_preferences->Save();
   }
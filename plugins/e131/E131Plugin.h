@@ -55,8 +55,10 @@ class E131Plugin: public ola::Plugin {
     static const char DRAFT_DISCOVERY_KEY[];
     static const char DSCP_KEY[];
     static const char IGNORE_PREVIEW_DATA_KEY[];
+    static const char IGNORE_SYNC_KEY[];
     static const char INPUT_PORT_COUNT_KEY[];
     static const char IP_KEY[];
+    static const unsigned int MAX_SYNC_UNIVERSE;
     static const char OUTPUT_PORT_COUNT_KEY[];
     static const char PLUGIN_NAME[];
     static const char PLUGIN_PREFIX[];
@@ -64,6 +66,7 @@ class E131Plugin: public ola::Plugin {
     static const char REVISION_0_2[];
     static const char REVISION_0_46[];
     static const char REVISION_KEY[];
+    static const char SYNC_UNIVERSE_KEY[];
 };
 }  // namespace e131
 }  // namespace plugin
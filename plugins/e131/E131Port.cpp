@@ -52,6 +52,30 @@ string E131PortHelper::Description(Universe *universe) const {
 
 
 
+/*
+ * Describe an input port, including the sync state.
+ */
+string E131InputPort::Description() const {
+  Universe *universe = GetUniverse();
+  if (!universe) {
+    return "";
+  }
+
+  std::ostringstream str;
+  str << m_helper.Description(universe);
+  bool synchronized;
+  uint16_t sync_address = m_node->InputSyncAddress(universe->UniverseId(),
+                                                   &synchronized);
+  if (sync_address) {
+    str << ", sync address " << sync_address;
+    if (!synchronized) {
+      str << " (no sync received)";
+    }
+  }
+  return str.str();
+}
+
+
 /*
  * Set the universe for an input port.
  */
@@ -75,6 +99,24 @@ E131OutputPort::~E131OutputPort() {
   }
 }
 
+/*
+ * Describe an output port, including the sync universe.
+ */
+string E131OutputPort::Description() const {
+  Universe *universe = GetUniverse();
+  if (!universe) {
+    return "";
+  }
+
+  std::ostringstream str;
+  str << m_helper.Description(universe);
+  if (m_node->SyncUniverse()) {
+    str << ", sync universe " << m_node->SyncUniverse();
+  }
+  return str.str();
+}
+
+
 /*
  * Set the universe for an output port.
  */
@@ -53,9 +53,7 @@ class E131InputPort: public BasicInputPort {
     return m_helper.PreSetUniverse(old_universe, new_universe);
   }
   void PostSetUniverse(Universe *old_universe, Universe *new_universe);
-  std::string Description() const {
-    return m_helper.Description(GetUniverse());
-  }
+  std::string Description() const;
   const ola::DmxBuffer &ReadDMX() const { return m_buffer; }
   bool SupportsPriorities() const { return true; }
   uint8_t InheritedPriority() const { return m_priority; }
@@ -83,9 +81,7 @@ class E131OutputPort: public BasicOutputPort {
     return m_helper.PreSetUniverse(old_universe, new_universe);
   }
   void PostSetUniverse(Universe *old_universe, Universe *new_universe);
-  std::string Description() const {
-    return m_helper.Description(GetUniverse());
-  }
+  std::string Description() const;
 
   bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t priority);
 
@@ -58,7 +58,8 @@ EspNetNode::EspNetNode(const string &ip_address)
       m_universe(0),
       m_type(ESPNET_NODE_TYPE_IO),
       m_node_name(NODE_NAME),
-      m_preferred_ip(ip_address) {
+      m_preferred_ip(ip_address),
+      m_recv_batch(sizeof(espnet_packet_union_t)) {
 }
 
 
@@ -120,17 +121,24 @@ bool EspNetNode::Stop() {
  * Called when there is data on this socket
  */
 void EspNetNode::SocketReady() {
-  espnet_packet_union_t packet;
-  memset(&packet, 0, sizeof(packet));
-  ola::network::IPV4SocketAddress source;
-
-  ssize_t packet_size = sizeof(packet);
-  if (!m_socket.RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                         &packet_size,
-                         &source)) {
-    return;
+  const unsigned int count = m_socket.RecvBatch(&m_recv_batch);
+  for (unsigned int i = 0; i < count; i++) {
+    // the handlers expect the rest of the packet to be zeroed
+    uint8_t *data = m_recv_batch.Data(i);
+    const unsigned int size = m_recv_batch.Size(i);
+    memset(data + size, 0, m_recv_batch.MaxSize() - size);
+    HandlePacket(*reinterpret_cast<const espnet_packet_union_t*>(data), size,
+                 m_recv_batch.Source(i));
   }
+}
 
+
+/*
+ * Handle a single espnet packet
+ */
+void EspNetNode::HandlePacket(const espnet_packet_union_t &packet,
+                              ssize_t packet_size,
+                              const ola::network::IPV4SocketAddress &source) {
   if (packet_size < (ssize_t) sizeof(packet.poll.head)) {
     OLA_WARN << "Small espnet packet received, discarding";
     return;
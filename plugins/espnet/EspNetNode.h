@@ -83,6 +83,9 @@ class EspNetNode {
     } universe_handler;
 
     bool InitNetwork();
+    void HandlePacket(const espnet_packet_union_t &packet,
+                      ssize_t packet_size,
+                      const ola::network::IPV4SocketAddress &source);
     void HandlePoll(const espnet_poll_t &poll, ssize_t length,
                     const ola::network::IPV4Address &source);
     void HandleReply(const espnet_poll_reply_t &reply,
@@ -116,6 +119,7 @@ class EspNetNode {
     std::map<uint8_t, universe_handler> m_handlers;
     ola::network::Interface m_interface;
     ola::network::UDPSocket m_socket;
+    ola::network::DatagramBatch m_recv_batch;
     RunLengthDecoder m_decoder;
 
     static const char NODE_NAME[];
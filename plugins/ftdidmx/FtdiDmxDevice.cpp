@@ -26,6 +26,7 @@
 #include <string>
 #include <memory>
 #include "ola/Logging.h"
+#include "ola/StringUtils.h"
 #include "plugins/ftdidmx/FtdiDmxDevice.h"
 #include "plugins/ftdidmx/FtdiDmxPort.h"
 
@@ -35,12 +36,17 @@ namespace ftdidmx {
 
 using std::string;
 
-FtdiDmxDevice::FtdiDmxDevice(AbstractPlugin *owner,
-                             const FtdiWidgetInfo &widget_info,
-                             unsigned int frequency)
+FtdiDmxDevice::FtdiDmxDevice(
+    AbstractPlugin *owner,
+    const FtdiWidgetInfo &widget_info,
+    unsigned int frequency,
+    const ola::dmx::DmxFrameScheduler::Options &scheduler_options,
+    ExportMap *export_map)
     : Device(owner, widget_info.Description()),
       m_widget_info(widget_info),
-      m_frequency(frequency) {
+      m_frequency(frequency),
+      m_scheduler_options(scheduler_options),
+      m_export_map(export_map) {
   m_widget = new FtdiWidget(widget_info.Serial(),
                             widget_info.Name(),
                             widget_info.Id(),
@@ -64,7 +70,22 @@ bool FtdiDmxDevice::StartHook() {
     FtdiInterface *port = new FtdiInterface(m_widget,
                                             static_cast<ftdi_interface>(i));
     if (port->SetupOutput()) {
-      AddPort(new FtdiDmxOutputPort(this, port, i, m_frequency));
+      // ftdi_write_data() blocks until the data has been sent, so each
+      // interface gets its own thread, otherwise one slow interface would
+      // hold up the others.
+      std::auto_ptr<ola::dmx::DmxFrameScheduler> scheduler(
+          new ola::dmx::DmxFrameScheduler(m_scheduler_options, m_export_map));
+      if (!scheduler->Start()) {
+        OLA_WARN << "Failed to start the DMX frame scheduler for interface "
+                 << i;
+        delete port;
+        continue;
+      }
+      ola::dmx::DmxFrameScheduler::OutputOptions options;
+      options.frame_rate = m_frequency;
+      options.name = m_widget->Serial() + "-" + IntToString(i);
+      AddPort(new FtdiDmxOutputPort(this, port, i, scheduler.release(),
+                                    options));
       successfully_added += 1;
     } else {
       OLA_WARN << "Failed to add interface: " << i;
@@ -28,7 +28,9 @@
 
 #include <string>
 #include <memory>
+#include "common/dmx/DmxFrameScheduler.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "olad/Device.h"
 #include "olad/Preferences.h"
 #include "plugins/ftdidmx/FtdiWidget.h"
@@ -41,7 +43,9 @@ class FtdiDmxDevice : public Device {
  public:
   FtdiDmxDevice(AbstractPlugin *owner,
                 const FtdiWidgetInfo &widget_info,
-                unsigned int frequency);
+                unsigned int frequency,
+                const ola::dmx::DmxFrameScheduler::Options &scheduler_options,
+                ExportMap *export_map);
   ~FtdiDmxDevice();
 
   std::string DeviceId() const { return m_widget->Serial(); }
@@ -59,6 +63,8 @@ class FtdiDmxDevice : public Device {
   FtdiWidget *m_widget;
   const FtdiWidgetInfo m_widget_info;
   unsigned int m_frequency;
+  const ola::dmx::DmxFrameScheduler::Options m_scheduler_options;
+  ExportMap *m_export_map;
 };
 }  // namespace ftdidmx
 }  // namespace plugin
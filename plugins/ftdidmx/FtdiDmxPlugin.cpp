@@ -42,6 +42,7 @@ using std::string;
 using std::vector;
 
 const char FtdiDmxPlugin::K_FREQUENCY[] = "frequency";
+const char FtdiDmxPlugin::K_REALTIME_PRIORITY[] = "realtime-priority";
 const char FtdiDmxPlugin::PLUGIN_NAME[] = "FTDI USB DMX";
 const char FtdiDmxPlugin::PLUGIN_PREFIX[] = "ftdidmx";
 
@@ -73,9 +74,15 @@ bool FtdiDmxPlugin::StartHook() {
       m_preferences->GetValue(K_FREQUENCY),
       DEFAULT_FREQUENCY);
 
+  ola::dmx::DmxFrameScheduler::Options options;
+  options.realtime_priority = StringToIntOrDefault(
+      m_preferences->GetValue(K_REALTIME_PRIORITY),
+      DEFAULT_REALTIME_PRIORITY);
+
   FtdiWidgetInfoVector::const_iterator iter;
   for (iter = widgets.begin(); iter != widgets.end(); ++iter) {
-    AddDevice(new FtdiDmxDevice(this, *iter, frequency));
+    AddDevice(new FtdiDmxDevice(this, *iter, frequency, options,
+                                m_plugin_adaptor->GetExportMap()));
   }
   return true;
 }
@@ -112,9 +119,13 @@ bool FtdiDmxPlugin::SetDefaultPreferences() {
     return false;
   }
 
-  if (m_preferences->SetDefaultValue(FtdiDmxPlugin::K_FREQUENCY,
-                                     UIntValidator(1, 44),
-                                     DEFAULT_FREQUENCY)) {
+  bool save = m_preferences->SetDefaultValue(FtdiDmxPlugin::K_FREQUENCY,
+                                             UIntValidator(1, 44),
+                                             DEFAULT_FREQUENCY);
+  save |= m_preferences->SetDefaultValue(FtdiDmxPlugin::K_REALTIME_PRIORITY,
+                                         UIntValidator(0, 99),
+                                         DEFAULT_REALTIME_PRIORITY);
+  if (save) {
     m_preferences->Save();
   }
 
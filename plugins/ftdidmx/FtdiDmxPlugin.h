@@ -21,6 +21,7 @@
 #ifndef PLUGINS_FTDIDMX_FTDIDMXPLUGIN_H_
 #define PLUGINS_FTDIDMX_FTDIDMXPLUGIN_H_
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -64,8 +65,10 @@ class FtdiDmxPlugin : public Plugin {
   bool SetDefaultPreferences();
 
   static const uint8_t DEFAULT_FREQUENCY = 30;
+  static const uint8_t DEFAULT_REALTIME_PRIORITY = 0;
 
   static const char K_FREQUENCY[];
+  static const char K_REALTIME_PRIORITY[];
   static const char PLUGIN_NAME[];
   static const char PLUGIN_PREFIX[];
 };
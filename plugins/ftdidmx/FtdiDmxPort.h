@@ -28,12 +28,12 @@
 
 #include <string>
 
+#include "common/dmx/DmxFrameScheduler.h"
 #include "ola/DmxBuffer.h"
 #include "olad/Port.h"
 #include "olad/Preferences.h"
 #include "plugins/ftdidmx/FtdiDmxDevice.h"
 #include "plugins/ftdidmx/FtdiWidget.h"
-#include "plugins/ftdidmx/FtdiDmxThread.h"
 
 namespace ola {
 namespace plugin {
@@ -41,29 +41,37 @@ namespace ftdidmx {
 
 class FtdiDmxOutputPort : public ola::BasicOutputPort {
  public:
+    /*
+     * Ownership of the interface and the scheduler is transferred.
+     */
     FtdiDmxOutputPort(FtdiDmxDevice *parent,
                       FtdiInterface *interface,
                       unsigned int id,
-                      unsigned int freq)
+                      ola::dmx::DmxFrameScheduler *scheduler,
+                      const ola::dmx::DmxFrameScheduler::OutputOptions &options)
         : BasicOutputPort(parent, id),
           m_interface(interface),
-          m_thread(interface, freq) {
-      m_thread.Start();
+          m_scheduler(scheduler) {
+      m_scheduler->AddOutput(m_interface, options);
     }
     ~FtdiDmxOutputPort() {
-      m_thread.Stop();
+      m_scheduler->Stop();
+      m_scheduler->RemoveOutput(m_interface);
+      delete m_scheduler;
       delete m_interface;
     }
 
     bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t) {
-      return m_thread.WriteDMX(buffer);
+      return m_scheduler->WriteDMX(m_interface, buffer);
     }
 
+    bool SupportsThreadedOutput() const { return true; }
+
     std::string Description() const { return m_interface->Description(); }
 
  private:
     FtdiInterface *m_interface;
-    FtdiDmxThread m_thread;
+    ola::dmx::DmxFrameScheduler *m_scheduler;
 };
 }  // namespace ftdidmx
 }  // namespace plugin
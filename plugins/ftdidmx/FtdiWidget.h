@@ -51,6 +51,7 @@
 #include <string>
 #include <vector>
 
+#include "common/dmx/DmxFrameScheduler.h"
 #include "ola/DmxBuffer.h"
 
 namespace ola {
@@ -180,7 +181,7 @@ class FtdiWidget {
   const uint16_t m_pid;
 };
 
-class FtdiInterface {
+class FtdiInterface : public ola::dmx::DmxSerialWriter {
  public:
   FtdiInterface(const FtdiWidget * parent,
                 const ftdi_interface interface);
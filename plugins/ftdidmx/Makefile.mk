@@ -16,8 +16,6 @@ plugins_ftdidmx_libolaftdidmx_la_SOURCES = \
     plugins/ftdidmx/FtdiDmxPlugin.cpp \
     plugins/ftdidmx/FtdiDmxPlugin.h \
     plugins/ftdidmx/FtdiDmxPort.h \
-    plugins/ftdidmx/FtdiDmxThread.cpp \
-    plugins/ftdidmx/FtdiDmxThread.h \
     plugins/ftdidmx/FtdiWidget.cpp \
     plugins/ftdidmx/FtdiWidget.h
 plugins_ftdidmx_libolaftdidmx_la_LIBADD = \
@@ -21,10 +21,12 @@
 #include "plugins/openpixelcontrol/OPCClient.h"
 
 #include "ola/Callback.h"
+#include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/io/BigEndianStream.h"
 #include "ola/io/IOQueue.h"
+#include "ola/io/MemoryBlock.h"
 #include "ola/io/NonBlockingSender.h"
 #include "ola/network/SocketAddress.h"
 #include "ola/util/Utils.h"
@@ -35,6 +37,7 @@ namespace plugin {
 namespace openpixelcontrol {
 
 using ola::TimeInterval;
+using ola::dmx::ColorCorrection;
 using ola::network::TCPSocket;
 
 OPCClient::OPCClient(ola::io::SelectServerInterface *ss,
@@ -55,17 +58,38 @@ OPCClient::~OPCClient() {
   }
 }
 
-bool OPCClient::SendDmx(uint8_t channel, const DmxBuffer &buffer) {
+bool OPCClient::SendDmx(uint8_t channel, const DmxBuffer &buffer,
+                        const ColorCorrection *correction) {
   if (!m_sender.get()) {
     return false;  // not connected
   }
 
   ola::io::IOQueue queue(&m_pool);
-  ola::io::BigEndianOutputStream stream(&queue);
-  stream << channel;
-  stream << SET_PIXEL_COMMAND;
-  stream << static_cast<uint16_t>(buffer.Size());
-  stream.Write(buffer.GetRaw(), buffer.Size());
+  if (correction && !correction->IsIdentity()) {
+    // The pool blocks hold a whole frame, so the corrected slots are written
+    // straight into the block that's sent.
+    ola::io::MemoryBlock *block = m_pool.Allocate();
+    if (!block) {
+      return false;
+    }
+    // Blocks can be returned to the pool with data in them.
+    block->PopFront(block->Size());
+    uint8_t *frame = block->WritePointer();
+    frame[0] = channel;
+    frame[1] = SET_PIXEL_COMMAND;
+    utils::SplitUInt16(static_cast<uint16_t>(buffer.Size()), &frame[2],
+                       &frame[3]);
+    correction->Apply(buffer.GetRaw(), buffer.Size(),
+                      frame + OPC_HEADER_SIZE);
+    block->Commit(OPC_HEADER_SIZE + buffer.Size());
+    queue.AppendBlock(block);
+  } else {
+    ola::io::BigEndianOutputStream stream(&queue);
+    stream << channel;
+    stream << SET_PIXEL_COMMAND;
+    stream << static_cast<uint16_t>(buffer.Size());
+    stream.Write(buffer.GetRaw(), buffer.Size());
+  }
   return m_sender->SendMessage(&queue);
 }
 
@@ -24,6 +24,7 @@
 #include <memory>
 #include <string>
 
+#include "common/dmx/ColorCorrection.h"
 #include "ola/DmxBuffer.h"
 #include "ola/io/MemoryBlockPool.h"
 #include "ola/io/SelectServerInterface.h"
@@ -76,8 +77,11 @@ class OPCClient {
    * @brief Send a DMX frame.
    * @param channel the OPC channel to use.
    * @param buffer the DMX data.
+   * @param correction the color correction to apply to the data, or NULL.
+   *   Ownership is not transferred.
    */
-  bool SendDmx(uint8_t channel, const DmxBuffer &buffer);
+  bool SendDmx(uint8_t channel, const DmxBuffer &buffer,
+               const ola::dmx::ColorCorrection *correction = NULL);
 
   /**
    * @brief Set the callback to be run when the socket state changes.
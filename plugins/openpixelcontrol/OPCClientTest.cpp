@@ -21,6 +21,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <memory>
+#include "common/dmx/ColorCorrection.h"
 #include "ola/base/Array.h"
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
@@ -35,6 +36,7 @@
 
 
 using ola::DmxBuffer;
+using ola::dmx::ColorCorrection;
 using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
 using ola::plugin::openpixelcontrol::OPCClient;
@@ -44,22 +46,26 @@ using std::auto_ptr;
 class OPCClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(OPCClientTest);
   CPPUNIT_TEST(testTransmit);
+  CPPUNIT_TEST(testTransmitWithCorrection);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   OPCClientTest()
       : CppUnit::TestFixture(),
-        m_ss(NULL) {
+        m_ss(NULL),
+        m_correction(NULL) {
   }
   void setUp();
 
   void testTransmit();
+  void testTransmitWithCorrection();
 
  private:
   ola::io::SelectServer m_ss;
   auto_ptr<OPCServer> m_server;
   DmxBuffer m_received_data;
   uint8_t m_command;
+  const ColorCorrection *m_correction;
 
   void CaptureData(uint8_t command, const uint8_t *data, unsigned int length) {
     m_received_data.Set(data, length);
@@ -69,7 +75,7 @@ class OPCClientTest: public CppUnit::TestFixture {
 
   void SendDMX(OPCClient *client, DmxBuffer *buffer, bool connected) {
     if (connected) {
-      OLA_ASSERT_TRUE(client->SendDmx(CHANNEL, *buffer));
+      OLA_ASSERT_TRUE(client->SendDmx(CHANNEL, *buffer, m_correction));
     } else {
       m_ss.Terminate();
     }
@@ -111,3 +117,20 @@ void OPCClientTest::testTransmit() {
   // Now sends should fail since there is no connection
   OLA_ASSERT_FALSE(client.SendDmx(CHANNEL, buffer));
 }
+
+void OPCClientTest::testTransmitWithCorrection() {
+  OPCClient client(&m_ss, m_server->ListenAddress());
+  const ColorCorrection correction(1.0, 255, 128, 0);
+  m_correction = &correction;
+
+  DmxBuffer buffer;
+  buffer.SetFromString("255,255,255,100");
+
+  client.SetSocketCallback(
+      ola::NewCallback(this, &OPCClientTest::SendDMX, &client, &buffer));
+
+  m_ss.Run();
+  DmxBuffer expected;
+  expected.SetFromString("255,128,0,100");
+  OLA_ASSERT_EQ(expected, m_received_data);
+}
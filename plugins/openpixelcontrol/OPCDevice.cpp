@@ -25,6 +25,7 @@
 #include <string>
 #include <vector>
 
+#include "common/dmx/ColorCorrection.h"
 #include "ola/Logging.h"
 #include "olad/Preferences.h"
 #include "plugins/openpixelcontrol/OPCPort.h"
@@ -34,6 +35,7 @@ namespace plugin {
 namespace openpixelcontrol {
 
 using ola::AbstractPlugin;
+using ola::dmx::ColorCorrection;
 using std::ostringstream;
 using std::set;
 using std::string;
@@ -113,7 +115,17 @@ bool OPCClientDevice::StartHook() {
       m_preferences->GetMultipleValue(str.str()));
   set<uint8_t>::const_iterator iter = channels.begin();
   for (; iter != channels.end(); ++iter) {
-    OPCOutputPort *port = new OPCOutputPort(this, *iter, m_client.get());
+    ostringstream key;
+    key << "target_" << m_target << "_channel_" << static_cast<int>(*iter);
+    ColorCorrection correction;
+    if (!ColorCorrection::FromStrings(
+            m_preferences->GetValue(key.str() + "_gamma"),
+            m_preferences->GetValue(key.str() + "_white_balance"),
+            &correction)) {
+      OLA_WARN << "Invalid color correction for " << key.str();
+    }
+    OPCOutputPort *port = new OPCOutputPort(this, *iter, m_client.get(),
+                                            correction);
     AddPort(port);
   }
   return true;
@@ -64,15 +64,17 @@ string OPCInputPort::Description() const {
 
 OPCOutputPort::OPCOutputPort(OPCClientDevice *parent,
                              uint8_t channel,
-                             OPCClient *client)
+                             OPCClient *client,
+                             const ola::dmx::ColorCorrection &correction)
     : BasicOutputPort(parent, channel),
       m_client(client),
-      m_channel(channel) {
+      m_channel(channel),
+      m_correction(correction) {
 }
 
 bool OPCOutputPort::WriteDMX(const DmxBuffer &buffer,
                              OLA_UNUSED uint8_t priority) {
-  return m_client->SendDmx(m_channel, buffer);
+  return m_client->SendDmx(m_channel, buffer, &m_correction);
 }
 
 string OPCOutputPort::Description() const {
@@ -22,6 +22,7 @@
 #define PLUGINS_OPENPIXELCONTROL_OPCPORT_H_
 
 #include <string>
+#include "common/dmx/ColorCorrection.h"
 #include "ola/DmxBuffer.h"
 #include "olad/Port.h"
 #include "plugins/openpixelcontrol/OPCDevice.h"
@@ -76,10 +77,12 @@ class OPCOutputPort: public BasicOutputPort {
    * @param channel the OPC channel for the port.
    * @param client the OPCClient to use for this port, ownership is not
    *   transferred.
+   * @param correction the color correction to apply to the pixel data.
    */
   OPCOutputPort(OPCClientDevice *parent,
                 uint8_t channel,
-                class OPCClient *client);
+                class OPCClient *client,
+                const ola::dmx::ColorCorrection &correction);
 
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
 
@@ -88,6 +91,7 @@ class OPCOutputPort: public BasicOutputPort {
  private:
   class OPCClient* const m_client;
   const uint8_t m_channel;
+  const ola::dmx::ColorCorrection m_correction;
 
   DISALLOW_COPY_AND_ASSIGN(OPCOutputPort);
 };
@@ -56,7 +56,8 @@ PathportNode::PathportNode(const string &ip_address,
       m_dscp(dscp),
       m_preferred_ip(ip_address),
       m_device_id(device_id),
-      m_sequence_number(1) {
+      m_sequence_number(1),
+      m_recv_batch(sizeof(pathport_packet_s)) {
 }
 
 
@@ -125,14 +126,22 @@ bool PathportNode::Stop() {
  * Called when there is data on this socket
  */
 void PathportNode::SocketReady(UDPSocket *socket) {
-  pathport_packet_s packet;
-  ssize_t packet_size = sizeof(packet);
-  IPV4SocketAddress source;
+  const unsigned int count = socket->RecvBatch(&m_recv_batch);
+  for (unsigned int i = 0; i < count; i++) {
+    HandlePacket(
+        *reinterpret_cast<const pathport_packet_s*>(m_recv_batch.Data(i)),
+        m_recv_batch.Size(i),
+        m_recv_batch.Source(i));
+  }
+}
 
-  if (!socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                        &packet_size, &source))
-    return;
 
+/*
+ * Handle a single pathport packet
+ */
+void PathportNode::HandlePacket(const pathport_packet_s &packet,
+                                ssize_t packet_size,
+                                const IPV4SocketAddress &source) {
   // skip packets sent by us
   if (source.Host() == m_interface.ip_address) {
     return;
@@ -162,7 +171,7 @@ void PathportNode::SocketReady(UDPSocket *socket) {
   }
 
   // TODO(simon): Handle multiple pdus here
-  pathport_packet_pdu *pdu = &packet.d.pdu;
+  const pathport_packet_pdu *pdu = &packet.d.pdu;
 
   if (packet_size < static_cast<ssize_t>(sizeof(pathport_pdu_header))) {
     OLA_WARN << "Pathport packet too small to fit a pdu header";
@@ -103,6 +103,9 @@ class PathportNode {
     bool InitNetwork();
     void PopulateHeader(pathport_packet_header *header, uint32_t destination);
     bool ValidateHeader(const pathport_packet_header &header);
+    void HandlePacket(const pathport_packet_s &packet,
+                      ssize_t packet_size,
+                      const ola::network::IPV4SocketAddress &source);
     void HandleDmxData(const pathport_pdu_data &packet,
                        unsigned int size);
     bool SendArpRequest(uint32_t destination = PATHPORT_ID_BROADCAST);
@@ -119,6 +122,7 @@ class PathportNode {
     universe_handlers m_handlers;
     ola::network::Interface m_interface;
     ola::network::UDPSocket m_socket;
+    ola::network::DatagramBatch m_recv_batch;
     ola::network::IPV4Address m_config_addr;
     ola::network::IPV4Address m_status_addr;
     ola::network::IPV4Address m_data_addr;
@@ -59,7 +59,8 @@ const char SandNetNode::DEFAULT_NODE_NAME[] = "ola-SandNet";
 SandNetNode::SandNetNode(const string &ip_address)
     : m_running(false),
       m_node_name(DEFAULT_NODE_NAME),
-      m_preferred_ip(ip_address) {
+      m_preferred_ip(ip_address),
+      m_recv_batch(sizeof(sandnet_packet)) {
   for (unsigned int i = 0; i < SANDNET_MAX_PORTS; i++) {
     m_ports[i].group = 0;
     m_ports[i].universe = i;
@@ -151,15 +152,22 @@ vector<UDPSocket*> SandNetNode::GetSockets() {
  * Called when there is data on this socket
  */
 void SandNetNode::SocketReady(UDPSocket *socket) {
-  sandnet_packet packet;
-  ssize_t packet_size = sizeof(packet);
-  IPV4SocketAddress source;
-
-  if (!socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                        &packet_size, &source)) {
-    return;
+  const unsigned int count = socket->RecvBatch(&m_recv_batch);
+  for (unsigned int i = 0; i < count; i++) {
+    HandlePacket(
+        *reinterpret_cast<const sandnet_packet*>(m_recv_batch.Data(i)),
+        m_recv_batch.Size(i),
+        m_recv_batch.Source(i));
   }
+}
 
+
+/*
+ * Handle a single sandnet packet
+ */
+void SandNetNode::HandlePacket(const sandnet_packet &packet,
+                               ssize_t packet_size,
+                               const IPV4SocketAddress &source) {
   // skip packets sent by us
   if (source.Host() == m_interface.ip_address) {
     return;
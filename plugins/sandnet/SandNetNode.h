@@ -91,6 +91,10 @@ class SandNetNode {
 
     bool InitNetwork();
 
+    void HandlePacket(const sandnet_packet &packet,
+                      ssize_t packet_size,
+                      const ola::network::IPV4SocketAddress &source);
+
     bool HandleCompressedDMX(const sandnet_compressed_dmx &dmx_packet,
                              unsigned int size);
 
@@ -110,6 +114,7 @@ class SandNetNode {
     ola::network::Interface m_interface;
     ola::network::UDPSocket m_control_socket;
     ola::network::UDPSocket m_data_socket;
+    ola::network::DatagramBatch m_recv_batch;
     ola::dmx::RunLengthEncoder m_encoder;
     ola::network::IPV4SocketAddress m_control_addr;
     ola::network::IPV4SocketAddress m_data_addr;
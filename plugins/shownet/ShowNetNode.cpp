@@ -58,7 +58,8 @@ ShowNetNode::ShowNetNode(const std::string &ip_address)
       m_packet_count(0),
       m_node_name(),
       m_preferred_ip(ip_address),
-      m_socket(NULL) {
+      m_socket(NULL),
+      m_recv_batch(sizeof(shownet_packet)) {
 }
 
 
@@ -217,18 +218,14 @@ bool ShowNetNode::RemoveHandler(unsigned int universe) {
  * Called when there is data on this socket
  */
 void ShowNetNode::SocketReady() {
-  shownet_packet packet;
-  ssize_t packet_size = sizeof(packet);
-  ola::network::IPV4SocketAddress source;
-
-  if (!m_socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                          &packet_size, &source)) {
-    return;
-  }
-
-  // skip packets sent by us
-  if (source.Host() != m_interface.ip_address) {
-    HandlePacket(&packet, packet_size);
+  const unsigned int count = m_socket->RecvBatch(&m_recv_batch);
+  for (unsigned int i = 0; i < count; i++) {
+    // skip packets sent by us
+    if (m_recv_batch.Source(i).Host() != m_interface.ip_address) {
+      HandlePacket(
+          reinterpret_cast<const shownet_packet*>(m_recv_batch.Data(i)),
+          m_recv_batch.Size(i));
+    }
   }
 }
 
@@ -75,6 +75,7 @@ class ShowNetNode {
     ola::network::Interface m_interface;
     ola::dmx::RunLengthEncoder m_encoder;
     ola::network::UDPSocket *m_socket;
+    ola::network::DatagramBatch m_recv_batch;
 
     bool HandlePacket(const shownet_packet *packet, unsigned int size);
     bool HandleCompressedPacket(const shownet_compressed_dmx *packet,
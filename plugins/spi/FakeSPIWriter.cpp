@@ -31,7 +31,13 @@ namespace spi {
 
 using ola::thread::MutexLocker;
 
-bool FakeSPIWriter::WriteSPIData(const uint8_t *data, unsigned int length) {
+bool FakeSPIWriter::WriteSPIData(const ola::io::IOVec *segments,
+                                 unsigned int segment_count) {
+  unsigned int length = 0;
+  for (unsigned int i = 0; i < segment_count; i++) {
+    length += segments[i].iov_len;
+  }
+
   {
     MutexLocker lock(&m_mutex);
 
@@ -39,11 +45,16 @@ bool FakeSPIWriter::WriteSPIData(const uint8_t *data, unsigned int length) {
       delete[] m_data;
       m_data = new uint8_t[length];
     }
-    memcpy(m_data, data, length);
+    uint8_t *data = m_data;
+    for (unsigned int i = 0; i < segment_count; i++) {
+      memcpy(data, segments[i].iov_base, segments[i].iov_len);
+      data += segments[i].iov_len;
+    }
 
     m_writes++;
     m_write_pending = true;
     m_last_write_size = length;
+    m_last_segment_count = segment_count;
   }
   m_cond_var.Signal();
 
@@ -81,6 +92,11 @@ unsigned int FakeSPIWriter::LastWriteSize() const {
   return m_last_write_size;
 }
 
+unsigned int FakeSPIWriter::LastSegmentCount() const {
+  MutexLocker lock(&m_mutex);
+  return m_last_segment_count;
+}
+
 void FakeSPIWriter::CheckDataMatches(
     const ola::testing::SourceLine &source_line,
     const uint8_t *expected,
@@ -41,6 +41,7 @@ class FakeSPIWriter : public SPIWriterInterface {
       m_write_pending(0),
       m_writes(0),
       m_last_write_size(0),
+      m_last_segment_count(0),
       m_data(NULL) {
   }
 
@@ -52,7 +53,8 @@ class FakeSPIWriter : public SPIWriterInterface {
 
   std::string DevicePath() const { return m_device_path; }
 
-  bool WriteSPIData(const uint8_t *data, unsigned int length);
+  bool WriteSPIData(const ola::io::IOVec *segments,
+                    unsigned int segment_count);
 
   // Methods used for testing
   void BlockWriter();
@@ -63,6 +65,7 @@ class FakeSPIWriter : public SPIWriterInterface {
 
   unsigned int WriteCount() const;
   unsigned int LastWriteSize() const;
+  unsigned int LastSegmentCount() const;
   void CheckDataMatches(const ola::testing::SourceLine &source_line,
                         const uint8_t *data,
                         unsigned int length);
@@ -72,6 +75,7 @@ class FakeSPIWriter : public SPIWriterInterface {
   bool m_write_pending;  // GUARDED_BY(m_mutex)
   unsigned int m_writes;  // GUARDED_BY(m_mutex)
   unsigned int m_last_write_size;  // GUARDED_BY(m_mutex)
+  unsigned int m_last_segment_count;  // GUARDED_BY(m_mutex)
   uint8_t *m_data;  // GUARDED_BY(m_mutex)
 
   ola::thread::Mutex m_write_lock;
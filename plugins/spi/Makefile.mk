@@ -4,12 +4,16 @@ if USE_SPI
 # This is a library which isn't coupled to olad
 lib_LTLIBRARIES += plugins/spi/libolaspicore.la plugins/spi/libolaspi.la
 plugins_spi_libolaspicore_la_SOURCES = \
+    plugins/spi/PixelEncoder.cpp \
+    plugins/spi/PixelEncoder.h \
     plugins/spi/SPIBackend.cpp \
     plugins/spi/SPIBackend.h \
     plugins/spi/SPIOutput.cpp \
     plugins/spi/SPIOutput.h \
     plugins/spi/SPIWriter.cpp \
-    plugins/spi/SPIWriter.h
+    plugins/spi/SPIWriter.h \
+    plugins/spi/TripleBuffer.cpp \
+    plugins/spi/TripleBuffer.h
 plugins_spi_libolaspicore_la_LIBADD = common/libolacommon.la
 
 # Plugin description is generated from README.md
@@ -31,13 +35,34 @@ plugins_spi_libolaspi_la_LIBADD = \
     olad/plugin_api/libolaserverplugininterface.la \
     plugins/spi/libolaspicore.la
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += plugins/spi/pixel_encoder_benchmark \
+                   plugins/spi/spi_output_benchmark
+plugins_spi_pixel_encoder_benchmark_SOURCES = \
+    plugins/spi/pixel_encoder_benchmark.cpp
+plugins_spi_pixel_encoder_benchmark_LDADD = plugins/spi/libolaspicore.la \
+                                            common/libolacommon.la
+
+plugins_spi_spi_output_benchmark_SOURCES = \
+    plugins/spi/spi_output_benchmark.cpp
+plugins_spi_spi_output_benchmark_CXXFLAGS = $(COMMON_PROTOBUF_CXXFLAGS)
+plugins_spi_spi_output_benchmark_LDADD = \
+    $(libprotobuf_LIBS) \
+    plugins/spi/libolaspi.la \
+    plugins/spi/libolaspicore.la \
+    olad/plugin_api/libolaserverplugininterface.la \
+    common/libolacommon.la
+
 # TESTS
 ##################################################
 test_programs += plugins/spi/SPITester
 
 plugins_spi_SPITester_SOURCES = \
+    plugins/spi/PixelEncoderTest.cpp \
     plugins/spi/SPIBackendTest.cpp \
     plugins/spi/SPIOutputTest.cpp \
+    plugins/spi/TripleBufferTest.cpp \
     plugins/spi/FakeSPIWriter.cpp \
     plugins/spi/FakeSPIWriter.h
 plugins_spi_SPITester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
@@ -0,0 +1,597 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PixelEncoder.cpp
+ * Convert DMX slots to the SPI data for a string of pixels.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * The scalar kernels use lookup tables for the per-slot conversions. The
+ * SIMD kernels do the colour reordering with byte shuffles and compute the
+ * per pixel header bytes a block of pixels at a time. As with the HTP merge
+ * kernels, the x86 kernels are compiled with per-function target attributes
+ * and the one to use is picked at runtime.
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+#include "plugins/spi/PixelEncoder.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OLA_PIXEL_ENCODER_X86
+#include <immintrin.h>
+#endif  // defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OLA_PIXEL_ENCODER_NEON
+#include <arm_neon.h>
+#endif  // defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+using ola::dmx::ColorCorrection;
+using std::max;
+using std::min;
+using std::string;
+
+namespace {
+
+const uint8_t APA102_START_MARK = 0xE0;
+const uint8_t APA102_FULL_BRIGHTNESS = 0xFF;
+const unsigned int APA102_MAX_BRIGHTNESS = 31;
+// The shift used with the reciprocals of the APA102 brightness divisors.
+const unsigned int APA102_RECIPROCAL_SHIFT = 35;
+
+/*
+ * The lookup tables used by the scalar kernels.
+ */
+struct EncodeTables {
+  // 7 bits of colour with the high bit set.
+  uint8_t lpd8806[256];
+  // The start mark and 5 bits of brightness.
+  uint8_t apa102_brightness[256];
+  // The flag byte, indexed by the top two bits of R, G & B.
+  uint8_t p9813_flag[64];
+  // Used to divide a 16 bit color by 257 * brightness, this is exact for
+  // every value the corrected APA102 encoder uses.
+  uint64_t apa102_reciprocal[APA102_MAX_BRIGHTNESS + 1];
+
+  EncodeTables() {
+    for (unsigned int i = 0; i < 256; i++) {
+      lpd8806[i] = 0x80 | (i >> 1);
+      apa102_brightness[i] = APA102_START_MARK | (i >> 3);
+    }
+    for (unsigned int i = 0; i < 64; i++) {
+      p9813_flag[i] = ~i;
+    }
+    apa102_reciprocal[0] = 0;
+    for (unsigned int i = 1; i <= APA102_MAX_BRIGHTNESS; i++) {
+      const uint64_t divisor = 257 * i;
+      const uint64_t one = static_cast<uint64_t>(1) << APA102_RECIPROCAL_SHIFT;
+      apa102_reciprocal[i] = (one + divisor - 1) / divisor;
+    }
+  }
+};
+
+const EncodeTables tables;
+
+inline unsigned int P9813FlagIndex(uint8_t red, uint8_t green,
+                                   uint8_t blue) {
+  return (red >> 6) | ((green >> 6) << 2) | ((blue >> 6) << 4);
+}
+
+inline uint8_t ScaleAPA102(unsigned int color, unsigned int round,
+                           uint64_t reciprocal) {
+  const uint64_t value =
+      ((color * APA102_MAX_BRIGHTNESS + round) * reciprocal) >>
+      APA102_RECIPROCAL_SHIFT;
+  return static_cast<uint8_t>(min(static_cast<uint64_t>(255), value));
+}
+
+void CopyRGB(const uint8_t *slots, unsigned int pixel_count,
+             uint8_t *output) {
+  memcpy(output, slots, pixel_count * 3);
+}
+
+void ScalarLPD8806(const uint8_t *slots, unsigned int pixel_count,
+                   uint8_t *output) {
+  for (unsigned int i = 0; i < pixel_count; i++) {
+    output[0] = tables.lpd8806[slots[1]];
+    output[1] = tables.lpd8806[slots[0]];
+    output[2] = tables.lpd8806[slots[2]];
+    slots += 3;
+    output += 3;
+  }
+}
+
+void ScalarP9813(const uint8_t *slots, unsigned int pixel_count,
+                 uint8_t *output) {
+  for (unsigned int i = 0; i < pixel_count; i++) {
+    output[0] = tables.p9813_flag[P9813FlagIndex(slots[0], slots[1],
+                                                 slots[2])];
+    output[1] = slots[2];
+    output[2] = slots[1];
+    output[3] = slots[0];
+    slots += 3;
+    output += 4;
+  }
+}
+
+void ScalarAPA102(const uint8_t *slots, unsigned int pixel_count,
+                  uint8_t *output) {
+  for (unsigned int i = 0; i < pixel_count; i++) {
+    output[0] = APA102_FULL_BRIGHTNESS;
+    output[1] = slots[2];
+    output[2] = slots[1];
+    output[3] = slots[0];
+    slots += 3;
+    output += 4;
+  }
+}
+
+void ScalarAPA102PB(const uint8_t *slots, unsigned int pixel_count,
+                    uint8_t *output) {
+  for (unsigned int i = 0; i < pixel_count; i++) {
+    output[0] = tables.apa102_brightness[slots[0]];
+    output[1] = slots[3];
+    output[2] = slots[2];
+    output[3] = slots[1];
+    slots += 4;
+    output += 4;
+  }
+}
+
+#ifdef OLA_PIXEL_ENCODER_X86
+/*
+ * Each block loads 16 slots, and stores 16 bytes. 5 pixels are converted,
+ * the last byte is overwritten by the next block or the scalar tail.
+ */
+__attribute__((target("ssse3")))
+void SSSE3LPD8806(const uint8_t *slots, unsigned int pixel_count,
+                  uint8_t *output) {
+  const __m128i shuffle = _mm_setr_epi8(
+      1, 0, 2, 4, 3, 5, 7, 6, 8, 10, 9, 11, 13, 12, 14, 15);
+  const __m128i colour_mask = _mm_set1_epi8(0x7f);
+  const __m128i high_bit = _mm_set1_epi8(static_cast<char>(0x80));
+
+  unsigned int pixel = 0;
+  for (; pixel * 3 + sizeof(__m128i) <= pixel_count * 3; pixel += 5) {
+    __m128i data = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(slots + pixel * 3));
+    data = _mm_shuffle_epi8(data, shuffle);
+    data = _mm_or_si128(
+        _mm_and_si128(_mm_srli_epi16(data, 1), colour_mask), high_bit);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pixel * 3), data);
+  }
+  ScalarLPD8806(slots + pixel * 3, pixel_count - pixel, output + pixel * 3);
+}
+
+/*
+ * Load 4 RGB pixels and return them as 0, B, G, R in each 32 bit lane.
+ * This reads 16 slots, 4 more than the pixels use.
+ */
+__attribute__((target("ssse3")))
+inline __m128i SSSE3LoadBGR(const uint8_t *slots) {
+  const __m128i shuffle = _mm_setr_epi8(
+      -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9);
+  return _mm_shuffle_epi8(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(slots)), shuffle);
+}
+
+__attribute__((target("ssse3")))
+void SSSE3P9813(const uint8_t *slots, unsigned int pixel_count,
+                uint8_t *output) {
+  const __m128i red_mask = _mm_set1_epi32(0x03);
+  const __m128i green_mask = _mm_set1_epi32(0x0c);
+  const __m128i blue_mask = _mm_set1_epi32(0x30);
+  const __m128i invert = _mm_set1_epi32(0xff);
+
+  unsigned int pixel = 0;
+  for (; pixel * 3 + sizeof(__m128i) <= pixel_count * 3; pixel += 4) {
+    __m128i data = SSSE3LoadBGR(slots + pixel * 3);
+    // The top 2 bits of each colour, R in bits 0-1, G in 2-3 & B in 4-5.
+    __m128i flag = _mm_and_si128(_mm_srli_epi32(data, 30), red_mask);
+    flag = _mm_or_si128(
+        flag, _mm_and_si128(_mm_srli_epi32(data, 20), green_mask));
+    flag = _mm_or_si128(
+        flag, _mm_and_si128(_mm_srli_epi32(data, 10), blue_mask));
+    data = _mm_or_si128(data, _mm_xor_si128(flag, invert));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pixel * 4), data);
+  }
+  ScalarP9813(slots + pixel * 3, pixel_count - pixel, output + pixel * 4);
+}
+
+__attribute__((target("ssse3")))
+void SSSE3APA102(const uint8_t *slots, unsigned int pixel_count,
+                 uint8_t *output) {
+  const __m128i start_mark = _mm_set1_epi32(APA102_FULL_BRIGHTNESS);
+
+  unsigned int pixel = 0;
+  for (; pixel * 3 + sizeof(__m128i) <= pixel_count * 3; pixel += 4) {
+    __m128i data = _mm_or_si128(SSSE3LoadBGR(slots + pixel * 3), start_mark);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pixel * 4), data);
+  }
+  ScalarAPA102(slots + pixel * 3, pixel_count - pixel, output + pixel * 4);
+}
+
+__attribute__((target("ssse3")))
+void SSSE3APA102PB(const uint8_t *slots, unsigned int pixel_count,
+                   uint8_t *output) {
+  const __m128i shuffle = _mm_setr_epi8(
+      0, 3, 2, 1, 4, 7, 6, 5, 8, 11, 10, 9, 12, 15, 14, 13);
+  const __m128i colour_mask = _mm_set1_epi32(~0xff);
+  const __m128i brightness_mask = _mm_set1_epi32(0x1f);
+  const __m128i start_mark = _mm_set1_epi32(APA102_START_MARK);
+
+  unsigned int pixel = 0;
+  for (; pixel + 4 <= pixel_count; pixel += 4) {
+    __m128i data = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(slots + pixel * 4)),
+        shuffle);
+    __m128i brightness = _mm_or_si128(
+        _mm_and_si128(_mm_srli_epi32(data, 3), brightness_mask), start_mark);
+    data = _mm_or_si128(_mm_and_si128(data, colour_mask), brightness);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pixel * 4), data);
+  }
+  ScalarAPA102PB(slots + pixel * 4, pixel_count - pixel, output + pixel * 4);
+}
+#endif  // OLA_PIXEL_ENCODER_X86
+
+#ifdef OLA_PIXEL_ENCODER_NEON
+void NEONLPD8806(const uint8_t *slots, unsigned int pixel_count,
+                 uint8_t *output) {
+  const uint8x16_t high_bit = vdupq_n_u8(0x80);
+  unsigned int pixel = 0;
+  for (; pixel + 16 <= pixel_count; pixel += 16) {
+    uint8x16x3_t rgb = vld3q_u8(slots + pixel * 3);
+    uint8x16x3_t grb;
+    grb.val[0] = vorrq_u8(vshrq_n_u8(rgb.val[1], 1), high_bit);
+    grb.val[1] = vorrq_u8(vshrq_n_u8(rgb.val[0], 1), high_bit);
+    grb.val[2] = vorrq_u8(vshrq_n_u8(rgb.val[2], 1), high_bit);
+    vst3q_u8(output + pixel * 3, grb);
+  }
+  ScalarLPD8806(slots + pixel * 3, pixel_count - pixel, output + pixel * 3);
+}
+
+void NEONP9813(const uint8_t *slots, unsigned int pixel_count,
+               uint8_t *output) {
+  unsigned int pixel = 0;
+  for (; pixel + 16 <= pixel_count; pixel += 16) {
+    uint8x16x3_t rgb = vld3q_u8(slots + pixel * 3);
+    uint8x16_t flag = vorrq_u8(
+        vshrq_n_u8(rgb.val[0], 6),
+        vshlq_n_u8(vshrq_n_u8(rgb.val[1], 6), 2));
+    flag = vorrq_u8(flag, vshlq_n_u8(vshrq_n_u8(rgb.val[2], 6), 4));
+    uint8x16x4_t encoded;
+    encoded.val[0] = vmvnq_u8(flag);
+    encoded.val[1] = rgb.val[2];
+    encoded.val[2] = rgb.val[1];
+    encoded.val[3] = rgb.val[0];
+    vst4q_u8(output + pixel * 4, encoded);
+  }
+  ScalarP9813(slots + pixel * 3, pixel_count - pixel, output + pixel * 4);
+}
+
+void NEONAPA102(const uint8_t *slots, unsigned int pixel_count,
+                uint8_t *output) {
+  unsigned int pixel = 0;
+  for (; pixel + 16 <= pixel_count; pixel += 16) {
+    uint8x16x3_t rgb = vld3q_u8(slots + pixel * 3);
+    uint8x16x4_t encoded;
+    encoded.val[0] = vdupq_n_u8(APA102_FULL_BRIGHTNESS);
+    encoded.val[1] = rgb.val[2];
+    encoded.val[2] = rgb.val[1];
+    encoded.val[3] = rgb.val[0];
+    vst4q_u8(output + pixel * 4, encoded);
+  }
+  ScalarAPA102(slots + pixel * 3, pixel_count - pixel, output + pixel * 4);
+}
+
+void NEONAPA102PB(const uint8_t *slots, unsigned int pixel_count,
+                  uint8_t *output) {
+  const uint8x16_t start_mark = vdupq_n_u8(APA102_START_MARK);
+  unsigned int pixel = 0;
+  for (; pixel + 16 <= pixel_count; pixel += 16) {
+    uint8x16x4_t irgb = vld4q_u8(slots + pixel * 4);
+    uint8x16x4_t encoded;
+    encoded.val[0] = vorrq_u8(vshrq_n_u8(irgb.val[0], 3), start_mark);
+    encoded.val[1] = irgb.val[3];
+    encoded.val[2] = irgb.val[2];
+    encoded.val[3] = irgb.val[1];
+    vst4q_u8(output + pixel * 4, encoded);
+  }
+  ScalarAPA102PB(slots + pixel * 4, pixel_count - pixel, output + pixel * 4);
+}
+#endif  // OLA_PIXEL_ENCODER_NEON
+
+/*
+ * The functions for each kernel, indexed by pixel_format.
+ */
+const PixelEncoder::EncodeFunction SCALAR_FUNCTIONS[] = {
+  &CopyRGB,
+  &ScalarLPD8806,
+  &ScalarP9813,
+  &ScalarAPA102,
+  &ScalarAPA102PB,
+};
+
+#ifdef OLA_PIXEL_ENCODER_X86
+const PixelEncoder::EncodeFunction SSSE3_FUNCTIONS[] = {
+  &CopyRGB,
+  &SSSE3LPD8806,
+  &SSSE3P9813,
+  &SSSE3APA102,
+  &SSSE3APA102PB,
+};
+#endif  // OLA_PIXEL_ENCODER_X86
+
+#ifdef OLA_PIXEL_ENCODER_NEON
+const PixelEncoder::EncodeFunction NEON_FUNCTIONS[] = {
+  &CopyRGB,
+  &NEONLPD8806,
+  &NEONP9813,
+  &NEONAPA102,
+  &NEONAPA102PB,
+};
+#endif  // OLA_PIXEL_ENCODER_NEON
+
+const PixelEncoder::EncodeFunction *KernelFunctions(pixel_kernel kernel) {
+  switch (kernel) {
+    case PIXEL_KERNEL_SCALAR:
+      return SCALAR_FUNCTIONS;
+#ifdef OLA_PIXEL_ENCODER_X86
+    case PIXEL_KERNEL_SSSE3:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("ssse3") ? SSSE3_FUNCTIONS : NULL;
+#endif  // OLA_PIXEL_ENCODER_X86
+#ifdef OLA_PIXEL_ENCODER_NEON
+    case PIXEL_KERNEL_NEON:
+      return NEON_FUNCTIONS;
+#endif  // OLA_PIXEL_ENCODER_NEON
+    default:
+      return NULL;
+  }
+}
+
+/*
+ * Pick the best kernel for this CPU. This is only done once, a race between
+ * two threads is harmless since they'll both store the same value.
+ */
+bool active_kernel_set = false;
+pixel_kernel active_kernel = PIXEL_KERNEL_SCALAR;
+}  // namespace
+
+
+/*
+ * The tables used when a color correction is applied. The 8 bit tables have
+ * the correction and the format's conversion combined.
+ */
+struct PixelEncoder::CorrectionTables {
+  uint8_t slots[ColorCorrection::COLOR_COUNT][256];
+  uint16_t wide[ColorCorrection::COLOR_COUNT][256];
+};
+
+
+PixelEncoder::PixelEncoder(pixel_format format) {
+  Init(format, ActiveKernel());
+}
+
+
+PixelEncoder::PixelEncoder(pixel_format format, pixel_kernel kernel) {
+  Init(format, KernelSupported(kernel) ? kernel : PIXEL_KERNEL_SCALAR);
+}
+
+
+PixelEncoder::~PixelEncoder() {}
+
+
+void PixelEncoder::SetCorrection(const ColorCorrection &correction) {
+  if (correction.IsIdentity()) {
+    m_correction.reset();
+    return;
+  }
+
+  if (!m_correction.get()) {
+    m_correction.reset(new CorrectionTables());
+  }
+  for (unsigned int color = 0; color < ColorCorrection::COLOR_COUNT;
+       color++) {
+    const uint8_t *table = correction.Table(color);
+    for (unsigned int i = 0; i < 256; i++) {
+      m_correction->slots[color][i] = m_format == PIXEL_LPD8806 ?
+          tables.lpd8806[table[i]] : table[i];
+    }
+    memcpy(m_correction->wide[color], correction.WideTable(color),
+           sizeof(m_correction->wide[color]));
+  }
+}
+
+
+void PixelEncoder::Encode(const uint8_t *slots, unsigned int pixel_count,
+                          uint8_t *output) const {
+  if (m_correction.get()) {
+    EncodeCorrected(slots, pixel_count, output);
+  } else {
+    m_encode(slots, pixel_count, output);
+  }
+}
+
+
+void PixelEncoder::Fill(const uint8_t *slots, unsigned int pixel_count,
+                        uint8_t *output) const {
+  if (!pixel_count) {
+    return;
+  }
+
+  // Encode the first pixel, then double the encoded data each pass.
+  Encode(slots, 1, output);
+  const unsigned int length = pixel_count * m_bytes_per_pixel;
+  unsigned int encoded = m_bytes_per_pixel;
+  while (encoded < length) {
+    const unsigned int copy_length = min(encoded, length - encoded);
+    memcpy(output + encoded, output, copy_length);
+    encoded += copy_length;
+  }
+}
+
+
+bool PixelEncoder::KernelSupported(pixel_kernel kernel) {
+  return KernelFunctions(kernel) != NULL;
+}
+
+
+pixel_kernel PixelEncoder::ActiveKernel() {
+  if (!active_kernel_set) {
+    const pixel_kernel preferred[] = {
+      PIXEL_KERNEL_NEON,
+      PIXEL_KERNEL_SSSE3,
+    };
+
+    pixel_kernel kernel = PIXEL_KERNEL_SCALAR;
+    for (unsigned int i = 0; i < sizeof(preferred) / sizeof(preferred[0]);
+         i++) {
+      if (KernelSupported(preferred[i])) {
+        kernel = preferred[i];
+        break;
+      }
+    }
+    active_kernel = kernel;
+    active_kernel_set = true;
+  }
+  return active_kernel;
+}
+
+
+string PixelEncoder::KernelName(pixel_kernel kernel) {
+  switch (kernel) {
+    case PIXEL_KERNEL_SCALAR:
+      return "scalar";
+    case PIXEL_KERNEL_SSSE3:
+      return "ssse3";
+    case PIXEL_KERNEL_NEON:
+      return "neon";
+    default:
+      return "unknown";
+  }
+}
+
+
+string PixelEncoder::FormatName(pixel_format format) {
+  switch (format) {
+    case PIXEL_WS2801:
+      return "WS2801";
+    case PIXEL_LPD8806:
+      return "LPD8806";
+    case PIXEL_P9813:
+      return "P9813";
+    case PIXEL_APA102:
+      return "APA102";
+    case PIXEL_APA102_PB:
+      return "APA102 PB";
+    default:
+      return "unknown";
+  }
+}
+
+
+void PixelEncoder::Init(pixel_format format, pixel_kernel kernel) {
+  m_format = format;
+  m_kernel = kernel;
+  m_slots_per_pixel = format == PIXEL_APA102_PB ? 4 : 3;
+  m_bytes_per_pixel = (format == PIXEL_WS2801 || format == PIXEL_LPD8806) ?
+      3 : 4;
+  m_encode = KernelFunctions(kernel)[format];
+}
+
+
+/*
+ * Encode with the correction tables.
+ */
+void PixelEncoder::EncodeCorrected(const uint8_t *slots,
+                                   unsigned int pixel_count,
+                                   uint8_t *output) const {
+  const uint8_t (*table)[256] = m_correction->slots;
+  const uint8_t *end = slots + pixel_count * m_slots_per_pixel;
+
+  switch (m_format) {
+    case PIXEL_WS2801:
+      for (; slots != end; slots += 3, output += 3) {
+        output[0] = table[0][slots[0]];
+        output[1] = table[1][slots[1]];
+        output[2] = table[2][slots[2]];
+      }
+      break;
+    case PIXEL_LPD8806:
+      for (; slots != end; slots += 3, output += 3) {
+        output[0] = table[1][slots[1]];
+        output[1] = table[0][slots[0]];
+        output[2] = table[2][slots[2]];
+      }
+      break;
+    case PIXEL_P9813:
+      for (; slots != end; slots += 3, output += 4) {
+        const uint8_t red = table[0][slots[0]];
+        const uint8_t green = table[1][slots[1]];
+        const uint8_t blue = table[2][slots[2]];
+        output[0] = tables.p9813_flag[P9813FlagIndex(red, green, blue)];
+        output[1] = blue;
+        output[2] = green;
+        output[3] = red;
+      }
+      break;
+    case PIXEL_APA102:
+      {
+        const uint16_t (*wide)[256] = m_correction->wide;
+        for (; slots != end; slots += 3, output += 4) {
+          const unsigned int red = wide[0][slots[0]];
+          const unsigned int green = wide[1][slots[1]];
+          const unsigned int blue = wide[2][slots[2]];
+          // Use the lowest global brightness that can still reach the
+          // brightest color, which leaves the most precision for the colors.
+          const unsigned int brightness =
+              (max(red, max(green, blue)) * APA102_MAX_BRIGHTNESS + 65534) /
+              65535;
+          if (!brightness) {
+            output[0] = APA102_FULL_BRIGHTNESS;
+            output[1] = output[2] = output[3] = 0;
+            continue;
+          }
+          // (color * 31 + divisor / 2) / divisor, where divisor is
+          // 257 * brightness.
+          const uint64_t reciprocal = tables.apa102_reciprocal[brightness];
+          const unsigned int round = 257 * brightness / 2;
+          output[0] = APA102_START_MARK | brightness;
+          output[1] = ScaleAPA102(blue, round, reciprocal);
+          output[2] = ScaleAPA102(green, round, reciprocal);
+          output[3] = ScaleAPA102(red, round, reciprocal);
+        }
+      }
+      break;
+    case PIXEL_APA102_PB:
+      for (; slots != end; slots += 4, output += 4) {
+        output[0] = tables.apa102_brightness[slots[0]];
+        output[1] = table[2][slots[3]];
+        output[2] = table[1][slots[2]];
+        output[3] = table[0][slots[1]];
+      }
+      break;
+  }
+}
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,174 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PixelEncoder.h
+ * Convert DMX slots to the SPI data for a string of pixels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_SPI_PIXELENCODER_H_
+#define PLUGINS_SPI_PIXELENCODER_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include "common/dmx/ColorCorrection.h"
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+/**
+ * @brief The pixel formats we know how to encode.
+ */
+typedef enum {
+  PIXEL_WS2801,  /**< R, G, B */
+  PIXEL_LPD8806,  /**< G, R, B, 7 bits per colour with the high bit set */
+  PIXEL_P9813,  /**< A flag byte, then B, G, R */
+  PIXEL_APA102,  /**< A start mark with full brightness, then B, G, R */
+  PIXEL_APA102_PB,  /**< As APA102, with the brightness from a 4th slot */
+} pixel_format;
+
+/**
+ * @brief The implementations of the encoding kernels.
+ */
+typedef enum {
+  PIXEL_KERNEL_SCALAR,  /**< Portable C++, using lookup tables */
+  PIXEL_KERNEL_SSSE3,  /**< x86 SSSE3, 4 or 5 pixels at a time */
+  PIXEL_KERNEL_NEON,  /**< ARM NEON, 16 pixels at a time */
+} pixel_kernel;
+
+/**
+ * @brief Encode DMX slots as SPI data for a particular type of pixel.
+ *
+ * The slots for each pixel are consecutive, e.g. R, G, B for most formats.
+ * The encoder doesn't know about start or latch frames, the caller is
+ * responsible for those.
+ */
+class PixelEncoder {
+ public:
+  /**
+   * @brief Create a new encoder using the fastest kernel the CPU supports.
+   * @param format the pixel format.
+   */
+  explicit PixelEncoder(pixel_format format);
+
+  /**
+   * @brief Create a new encoder using a specific kernel.
+   * @param format the pixel format.
+   * @param kernel the kernel to use. If it isn't supported, the scalar
+   *   kernel is used instead.
+   *
+   * This is used by the tests & benchmarks to compare kernels.
+   */
+  PixelEncoder(pixel_format format, pixel_kernel kernel);
+
+  ~PixelEncoder();
+
+  pixel_format Format() const { return m_format; }
+  pixel_kernel Kernel() const { return m_kernel; }
+
+  /**
+   * @brief The number of DMX slots used by each pixel.
+   */
+  unsigned int SlotsPerPixel() const { return m_slots_per_pixel; }
+
+  /**
+   * @brief The number of bytes of SPI data for each pixel.
+   */
+  unsigned int BytesPerPixel() const { return m_bytes_per_pixel; }
+
+  /**
+   * @brief Apply a color correction while encoding.
+   * @param correction the correction to apply. If this is the identity, any
+   *   existing correction is removed.
+   *
+   * The correction is folded into the tables used to encode each format, so
+   * it doesn't add another pass over the data. Corrected pixels always use
+   * the scalar kernel. APA102 pixels use the 16 bit tables and send the
+   * extra precision in the global brightness bits.
+   */
+  void SetCorrection(const ola::dmx::ColorCorrection &correction);
+
+  /**
+   * @brief Check if a color correction is applied.
+   */
+  bool Corrected() const { return m_correction.get() != NULL; }
+
+  /**
+   * @brief Encode a run of pixels.
+   * @param slots the DMX data, pixel_count * SlotsPerPixel() slots.
+   * @param pixel_count the number of pixels to encode.
+   * @param output where to write the SPI data, pixel_count * BytesPerPixel()
+   *   bytes.
+   */
+  void Encode(const uint8_t *slots, unsigned int pixel_count,
+              uint8_t *output) const;
+
+  /**
+   * @brief Set a run of pixels to the same value.
+   * @param slots the DMX data for a single pixel.
+   * @param pixel_count the number of pixels to set.
+   * @param output where to write the SPI data, pixel_count * BytesPerPixel()
+   *   bytes.
+   */
+  void Fill(const uint8_t *slots, unsigned int pixel_count,
+            uint8_t *output) const;
+
+  /**
+   * @brief Check if a kernel was compiled in and is supported by the CPU.
+   */
+  static bool KernelSupported(pixel_kernel kernel);
+
+  /**
+   * @brief Return the kernel used by encoders that don't specify one.
+   */
+  static pixel_kernel ActiveKernel();
+
+  /**
+   * @brief Return the name of a kernel, e.g. "ssse3".
+   */
+  static std::string KernelName(pixel_kernel kernel);
+
+  /**
+   * @brief Return the name of a pixel format, e.g. "LPD8806".
+   */
+  static std::string FormatName(pixel_format format);
+
+  typedef void (*EncodeFunction)(const uint8_t *slots,
+                                 unsigned int pixel_count,
+                                 uint8_t *output);
+
+ private:
+  pixel_format m_format;
+  pixel_kernel m_kernel;
+  unsigned int m_slots_per_pixel;
+  unsigned int m_bytes_per_pixel;
+  EncodeFunction m_encode;
+
+  struct CorrectionTables;
+  std::auto_ptr<CorrectionTables> m_correction;
+
+  void Init(pixel_format format, pixel_kernel kernel);
+  void EncodeCorrected(const uint8_t *slots, unsigned int pixel_count,
+                       uint8_t *output) const;
+
+  DISALLOW_COPY_AND_ASSIGN(PixelEncoder);
+};
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_SPI_PIXELENCODER_H_
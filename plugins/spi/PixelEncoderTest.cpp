@@ -0,0 +1,249 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PixelEncoderTest.cpp
+ * Test fixture for the PixelEncoder.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "common/dmx/ColorCorrection.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/spi/PixelEncoder.h"
+
+using ola::dmx::ColorCorrection;
+using ola::plugin::spi::PIXEL_APA102;
+using ola::plugin::spi::PIXEL_APA102_PB;
+using ola::plugin::spi::PIXEL_KERNEL_NEON;
+using ola::plugin::spi::PIXEL_KERNEL_SCALAR;
+using ola::plugin::spi::PIXEL_KERNEL_SSSE3;
+using ola::plugin::spi::PIXEL_LPD8806;
+using ola::plugin::spi::PIXEL_P9813;
+using ola::plugin::spi::PIXEL_WS2801;
+using ola::plugin::spi::PixelEncoder;
+using ola::plugin::spi::pixel_format;
+using ola::plugin::spi::pixel_kernel;
+using std::string;
+
+class PixelEncoderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PixelEncoderTest);
+  CPPUNIT_TEST(testEncode);
+  CPPUNIT_TEST(testFill);
+  CPPUNIT_TEST(testKernels);
+  CPPUNIT_TEST(testCorrection);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testEncode();
+  void testFill();
+  void testKernels();
+  void testCorrection();
+
+ private:
+  static const pixel_format FORMATS[];
+  static const pixel_kernel KERNELS[];
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PixelEncoderTest);
+
+const pixel_format PixelEncoderTest::FORMATS[] = {
+  PIXEL_WS2801,
+  PIXEL_LPD8806,
+  PIXEL_P9813,
+  PIXEL_APA102,
+  PIXEL_APA102_PB,
+};
+
+const pixel_kernel PixelEncoderTest::KERNELS[] = {
+  PIXEL_KERNEL_SCALAR,
+  PIXEL_KERNEL_SSSE3,
+  PIXEL_KERNEL_NEON,
+};
+
+
+/*
+ * Check each format with a couple of pixels.
+ */
+void PixelEncoderTest::testEncode() {
+  const uint8_t rgb[] = {1, 10, 100, 255, 128, 64};
+  const uint8_t irgb[] = {255, 1, 10, 100, 8, 200, 128, 64};
+  uint8_t output[8];
+
+  PixelEncoder ws2801(PIXEL_WS2801, PIXEL_KERNEL_SCALAR);
+  OLA_ASSERT_EQ(3u, ws2801.SlotsPerPixel());
+  OLA_ASSERT_EQ(3u, ws2801.BytesPerPixel());
+  ws2801.Encode(rgb, 2, output);
+  OLA_ASSERT_DATA_EQUALS(rgb, sizeof(rgb), output, 6);
+
+  PixelEncoder lpd8806(PIXEL_LPD8806, PIXEL_KERNEL_SCALAR);
+  OLA_ASSERT_EQ(3u, lpd8806.SlotsPerPixel());
+  OLA_ASSERT_EQ(3u, lpd8806.BytesPerPixel());
+  lpd8806.Encode(rgb, 2, output);
+  const uint8_t expected_lpd8806[] = {0x85, 0x80, 0xb2, 0xc0, 0xff, 0xa0};
+  OLA_ASSERT_DATA_EQUALS(expected_lpd8806, sizeof(expected_lpd8806),
+                         output, 6);
+
+  PixelEncoder p9813(PIXEL_P9813, PIXEL_KERNEL_SCALAR);
+  OLA_ASSERT_EQ(3u, p9813.SlotsPerPixel());
+  OLA_ASSERT_EQ(4u, p9813.BytesPerPixel());
+  p9813.Encode(rgb, 2, output);
+  const uint8_t expected_p9813[] = {0xef, 100, 10, 1, 0xe4, 64, 128, 255};
+  OLA_ASSERT_DATA_EQUALS(expected_p9813, sizeof(expected_p9813),
+                         output, sizeof(output));
+
+  PixelEncoder apa102(PIXEL_APA102, PIXEL_KERNEL_SCALAR);
+  OLA_ASSERT_EQ(3u, apa102.SlotsPerPixel());
+  OLA_ASSERT_EQ(4u, apa102.BytesPerPixel());
+  apa102.Encode(rgb, 2, output);
+  const uint8_t expected_apa102[] = {0xff, 100, 10, 1, 0xff, 64, 128, 255};
+  OLA_ASSERT_DATA_EQUALS(expected_apa102, sizeof(expected_apa102),
+                         output, sizeof(output));
+
+  PixelEncoder apa102_pb(PIXEL_APA102_PB, PIXEL_KERNEL_SCALAR);
+  OLA_ASSERT_EQ(4u, apa102_pb.SlotsPerPixel());
+  OLA_ASSERT_EQ(4u, apa102_pb.BytesPerPixel());
+  apa102_pb.Encode(irgb, 2, output);
+  const uint8_t expected_apa102_pb[] = {0xff, 100, 10, 1, 0xe1, 64, 128, 200};
+  OLA_ASSERT_DATA_EQUALS(expected_apa102_pb, sizeof(expected_apa102_pb),
+                         output, sizeof(output));
+}
+
+
+/*
+ * Check that Fill() repeats a single pixel.
+ */
+void PixelEncoderTest::testFill() {
+  const uint8_t rgb[] = {1, 10, 100};
+  uint8_t output[23];
+  memset(output, 0x55, sizeof(output));
+
+  PixelEncoder p9813(PIXEL_P9813);
+  p9813.Fill(rgb, 5, output);
+  const uint8_t expected[] = {
+    0xef, 100, 10, 1, 0xef, 100, 10, 1, 0xef, 100, 10, 1,
+    0xef, 100, 10, 1, 0xef, 100, 10, 1, 0x55, 0x55, 0x55};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output, sizeof(output));
+
+  // No pixels doesn't touch the output
+  memset(output, 0x55, sizeof(output));
+  p9813.Fill(rgb, 0, output);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0x55), output[0]);
+}
+
+
+/*
+ * Check that every supported kernel matches the scalar one, for a range of
+ * lengths so that the tails of the SIMD kernels are covered.
+ */
+void PixelEncoderTest::testKernels() {
+  uint8_t slots[4 * 70];
+  for (unsigned int i = 0; i < sizeof(slots); i++) {
+    slots[i] = static_cast<uint8_t>(i * 37 + (i >> 3));
+  }
+
+  const unsigned int format_count = sizeof(FORMATS) / sizeof(FORMATS[0]);
+  const unsigned int kernel_count = sizeof(KERNELS) / sizeof(KERNELS[0]);
+  OLA_ASSERT_TRUE(PixelEncoder::KernelSupported(PIXEL_KERNEL_SCALAR));
+  OLA_ASSERT_TRUE(
+      PixelEncoder::KernelSupported(PixelEncoder::ActiveKernel()));
+
+  for (unsigned int i = 0; i < format_count; i++) {
+    PixelEncoder scalar(FORMATS[i], PIXEL_KERNEL_SCALAR);
+    for (unsigned int j = 0; j < kernel_count; j++) {
+      if (!PixelEncoder::KernelSupported(KERNELS[j])) {
+        continue;
+      }
+      PixelEncoder encoder(FORMATS[i], KERNELS[j]);
+      OLA_ASSERT_EQ(KERNELS[j], encoder.Kernel());
+
+      for (unsigned int pixels = 0; pixels <= 70; pixels++) {
+        // The extra byte catches writes past the end of the output.
+        uint8_t expected[4 * 70 + 1];
+        uint8_t output[4 * 70 + 1];
+        memset(expected, 0x55, sizeof(expected));
+        memset(output, 0x55, sizeof(output));
+        const unsigned int length = pixels * encoder.BytesPerPixel() + 1;
+
+        scalar.Encode(slots, pixels, expected);
+        encoder.Encode(slots, pixels, output);
+        OLA_ASSERT_DATA_EQUALS(expected, length, output, length);
+      }
+    }
+  }
+}
+
+
+/*
+ * Check that a color correction is applied as the pixels are encoded.
+ */
+void PixelEncoderTest::testCorrection() {
+  const ColorCorrection correction(2.0, 255, 128, 64);
+  uint8_t slots[4 * 20];
+  for (unsigned int i = 0; i < sizeof(slots); i++) {
+    slots[i] = static_cast<uint8_t>(i * 37);
+  }
+
+  // An identity correction is a no-op
+  PixelEncoder encoder(PIXEL_P9813);
+  encoder.SetCorrection(ColorCorrection());
+  OLA_ASSERT_FALSE(encoder.Corrected());
+
+  // For the 8 bit formats, this is the same as encoding corrected slots
+  const pixel_format formats[] = {PIXEL_WS2801, PIXEL_LPD8806, PIXEL_P9813};
+  uint8_t corrected_slots[3 * 20];
+  correction.Apply(slots, sizeof(corrected_slots), corrected_slots);
+  for (unsigned int i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+    PixelEncoder plain(formats[i]);
+    PixelEncoder corrected(formats[i]);
+    corrected.SetCorrection(correction);
+    OLA_ASSERT_TRUE(corrected.Corrected());
+
+    uint8_t expected[4 * 20];
+    uint8_t output[4 * 20];
+    plain.Encode(corrected_slots, 20, expected);
+    corrected.Encode(slots, 20, output);
+    OLA_ASSERT_DATA_EQUALS(expected, 20 * plain.BytesPerPixel(),
+                           output, 20 * corrected.BytesPerPixel());
+  }
+
+  // APA102 pixel brightness doesn't correct the brightness slot
+  const uint8_t irgb[] = {255, 255, 128, 10};
+  uint8_t output[8];
+  PixelEncoder apa102_pb(PIXEL_APA102_PB);
+  apa102_pb.SetCorrection(correction);
+  apa102_pb.Encode(irgb, 1, output);
+  const uint8_t expected_apa102_pb[] = {0xff, 0, 32, 255};
+  OLA_ASSERT_DATA_EQUALS(expected_apa102_pb, sizeof(expected_apa102_pb),
+                         output, 4);
+
+  // APA102 uses the global brightness for dim pixels
+  const uint8_t rgb[] = {255, 255, 255, 10, 20, 30};
+  PixelEncoder apa102(PIXEL_APA102);
+  apa102.SetCorrection(ColorCorrection(2.0, 255, 255, 255));
+  apa102.Encode(rgb, 2, output);
+  const uint8_t expected_apa102[] = {0xff, 255, 255, 255, 0xe1, 109, 49, 12};
+  OLA_ASSERT_DATA_EQUALS(expected_apa102, sizeof(expected_apa102),
+                         output, sizeof(output));
+
+  // Black
+  const uint8_t black[] = {0, 0, 0};
+  apa102.Fill(black, 2, output);
+  const uint8_t expected_black[] = {0xff, 0, 0, 0, 0xff, 0, 0, 0};
+  OLA_ASSERT_DATA_EQUALS(expected_black, sizeof(expected_black),
+                         output, sizeof(output));
+}
@@ -26,7 +26,6 @@
 #include <string.h>
 #include <sys/ioctl.h>
 
-#include <numeric>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -41,6 +40,7 @@ namespace ola {
 namespace plugin {
 namespace spi {
 
+using ola::io::IOVec;
 using ola::thread::MutexLocker;
 using std::string;
 using std::vector;
@@ -48,65 +48,21 @@ using std::vector;
 const char SPIBackendInterface::SPI_DROP_VAR[] = "spi-drops";
 const char SPIBackendInterface::SPI_DROP_VAR_KEY[] = "device";
 
-uint8_t *HardwareBackend::OutputData::Resize(unsigned int length) {
-  if (length < m_size) {
-    m_size = length;
-    return m_data;
-  } else if (length == m_size) {
-    return m_data;
-  }
-
-  if (length <= m_actual_size) {
-    m_size = length;
-    return m_data;
-  }
-
-  delete[] m_data;
-  m_data = new uint8_t[length];
-  if (m_data) {
-    m_size = m_data ? length : 0;
-    m_actual_size = m_size;
-    memset(m_data, 0, length);
-  }
-  return m_data;
-}
-
-void HardwareBackend::OutputData::SetPending() {
-  m_write_pending = true;
-}
-
-void HardwareBackend::OutputData::SetLatchBytes(unsigned int latch_bytes) {
-  m_latch_bytes = latch_bytes;
-}
-
-HardwareBackend::OutputData& HardwareBackend::OutputData::operator=(
-    const HardwareBackend::OutputData &other) {
-  if (this != &other) {
-    uint8_t *data = Resize(other.m_size + other.m_latch_bytes);
-    if (data) {
-      memcpy(data, other.m_data, other.m_size);
-      memset(data + other.m_size, 0, other.m_latch_bytes);
-      m_write_pending = true;
-    } else {
-      m_write_pending = false;
-    }
-  }
-  return *this;
-}
-
 HardwareBackend::HardwareBackend(const Options &options,
                                  SPIWriterInterface *writer,
                                  ExportMap *export_map)
     : m_spi_writer(writer),
-      m_drop_map(NULL),
       m_output_count(1 << options.gpio_pins.size()),
+      m_write_pending(false),
       m_exit(false),
       m_gpio_pins(options.gpio_pins) {
-  SetupOutputs(&m_output_data);
+  for (unsigned int i = 0; i < m_output_count; i++) {
+    m_outputs.push_back(new TripleBuffer());
+  }
   if (export_map) {
-    m_drop_map = export_map->GetUIntMapVar(SPI_DROP_VAR,
-                                           SPI_DROP_VAR_KEY);
-    (*m_drop_map)[m_spi_writer->DevicePath()] = 0;
+    m_drop_var = export_map->GetUIntMapVar(
+        SPI_DROP_VAR, SPI_DROP_VAR_KEY)->GetHandle(m_spi_writer->DevicePath());
+    m_drop_var.Set(0);
   }
 }
 
@@ -120,7 +76,7 @@ HardwareBackend::~HardwareBackend() {
   m_cond_var.Signal();
   Join();
 
-  STLDeleteElements(&m_output_data);
+  STLDeleteElements(&m_outputs);
   CloseGPIOFDs();
 }
 
@@ -142,16 +98,7 @@ uint8_t *HardwareBackend::Checkout(uint8_t output_id,
   if (output_id >= m_output_count) {
     return NULL;
   }
-
-  m_mutex.Lock();
-  uint8_t *output = m_output_data[output_id]->Resize(length);
-  if (!output) {
-    m_mutex.Unlock();
-  }
-  m_output_data[output_id]->SetLatchBytes(latch_bytes);
-  // We return with the Mutex locked, the caller must then call Commit()
-  // coverity[LOCK]
-  return output;
+  return m_outputs[output_id]->Checkout(length, latch_bytes);
 }
 
 void HardwareBackend::Commit(uint8_t output) {
@@ -159,72 +106,41 @@ void HardwareBackend::Commit(uint8_t output) {
     return;
   }
 
-  OutputData *output_data = m_output_data[output];
-  if (output_data->IsPending() && m_drop_map) {
+  if (m_outputs[output]->Commit()) {
     // There was already another write pending which we're now stomping on
-    (*m_drop_map)[m_spi_writer->DevicePath()]++;
+    m_drop_var.Increment();
+  }
+
+  {
+    MutexLocker lock(&m_mutex);
+    m_write_pending = true;
   }
-  output_data->SetPending();
-  m_mutex.Unlock();
   m_cond_var.Signal();
 }
 
 void *HardwareBackend::Run() {
-  Outputs outputs;
-  SetupOutputs(&outputs);
-
   while (true) {
-    m_mutex.Lock();
-
-    if (m_exit) {
-      m_mutex.Unlock();
-      STLDeleteElements(&outputs);
-      return NULL;
-    }
-
-    bool action_pending = false;
-    Outputs::const_iterator iter = m_output_data.begin();
-    for (; iter != m_output_data.end(); ++iter) {
-      if ((*iter)->IsPending()) {
-        action_pending = true;
-        break;
+    {
+      MutexLocker lock(&m_mutex);
+      if (!(m_exit || m_write_pending)) {
+        m_cond_var.Wait(&m_mutex);
       }
-    }
-    if (!action_pending) {
-      m_cond_var.Wait(&m_mutex);
-    }
-
-    if (m_exit) {
-      m_mutex.Unlock();
-      STLDeleteElements(&outputs);
-      return NULL;
-    }
-
-    for (unsigned int i = 0; i < m_output_data.size(); i++) {
-      if (m_output_data[i]->IsPending()) {
-        // take a copy
-        *outputs[i] = *m_output_data[i];
-        m_output_data[i]->ResetPending();
+      if (m_exit) {
+        return NULL;
       }
+      m_write_pending = false;
     }
-    m_mutex.Unlock();
 
-    for (unsigned int i = 0; i < outputs.size(); i++) {
-      if (outputs[i]->IsPending()) {
-        WriteOutput(i, outputs[i]);
-        outputs[i]->ResetPending();
+    for (unsigned int i = 0; i < m_outputs.size(); i++) {
+      if (m_outputs[i]->Acquire()) {
+        WriteOutput(i, *m_outputs[i]);
       }
     }
   }
 }
 
-void HardwareBackend::SetupOutputs(Outputs *outputs) {
-  for (unsigned int i = 0; i < m_output_count; i++) {
-    outputs->push_back(new OutputData());
-  }
-}
-
-void HardwareBackend::WriteOutput(uint8_t output_id, OutputData *output) {
+void HardwareBackend::WriteOutput(uint8_t output_id,
+                                  const TripleBuffer &output) {
   const string on("1");
   const string off("0");
 
@@ -247,7 +163,23 @@ void HardwareBackend::WriteOutput(uint8_t output_id, OutputData *output) {
     }
   }
 
-  m_spi_writer->WriteSPIData(output->GetData(), output->Size());
+  // The latch bytes follow the data in the same message.
+  IOVec segments[2];
+  unsigned int segment_count = 0;
+  if (output.Size()) {
+    segments[segment_count].iov_base = const_cast<uint8_t*>(output.Data());
+    segments[segment_count++].iov_len = output.Size();
+  }
+  if (output.LatchBytes()) {
+    if (m_latch_data.size() < output.LatchBytes()) {
+      m_latch_data.resize(output.LatchBytes(), 0);
+    }
+    segments[segment_count].iov_base = &m_latch_data[0];
+    segments[segment_count++].iov_len = output.LatchBytes();
+  }
+  if (segment_count) {
+    m_spi_writer->WriteSPIData(segments, segment_count);
+  }
 }
 
 bool HardwareBackend::SetupGPIO() {
@@ -304,18 +236,16 @@ SoftwareBackend::SoftwareBackend(const Options &options,
                                  SPIWriterInterface *writer,
                                  ExportMap *export_map)
     : m_spi_writer(writer),
-      m_drop_map(NULL),
       m_write_pending(false),
       m_exit(false),
-      m_sync_output(options.sync_output),
-      m_output_sizes(options.outputs, 0),
-      m_latch_bytes(options.outputs, 0),
-      m_output(NULL),
-      m_length(0) {
+      m_sync_output(options.sync_output) {
+  for (unsigned int i = 0; i < options.outputs; i++) {
+    m_outputs.push_back(new TripleBuffer());
+  }
   if (export_map) {
-    m_drop_map = export_map->GetUIntMapVar(SPI_DROP_VAR,
-                                           SPI_DROP_VAR_KEY);
-    (*m_drop_map)[m_spi_writer->DevicePath()] = 0;
+    m_drop_var = export_map->GetUIntMapVar(
+        SPI_DROP_VAR, SPI_DROP_VAR_KEY)->GetHandle(m_spi_writer->DevicePath());
+    m_drop_var.Set(0);
   }
 }
 
@@ -328,7 +258,7 @@ SoftwareBackend::~SoftwareBackend() {
   m_cond_var.Signal();
   Join();
 
-  delete[] m_output;
+  STLDeleteElements(&m_outputs);
 }
 
 bool SoftwareBackend::Init() {
@@ -345,104 +275,81 @@ bool SoftwareBackend::Init() {
 uint8_t *SoftwareBackend::Checkout(uint8_t output,
                                    unsigned int length,
                                    unsigned int latch_bytes) {
-  if (output >= m_output_sizes.size()) {
+  if (output >= m_outputs.size()) {
     OLA_WARN << "Invalid SPI output " << static_cast<int>(output);
     return NULL;
   }
-
-  m_mutex.Lock();
-
-  unsigned int leading = 0;
-  unsigned int trailing = 0;
-  for (uint8_t i = 0; i < m_output_sizes.size(); i++) {
-    if (i < output) {
-      leading += m_output_sizes[i];
-    } else if (i > output) {
-      trailing += m_output_sizes[i];
-    }
-  }
-
-  m_latch_bytes[output] = latch_bytes;
-  const unsigned int total_latch_bytes = std::accumulate(
-      m_latch_bytes.begin(), m_latch_bytes.end(), 0);
-  const unsigned int required_size = (
-      leading + length + trailing + total_latch_bytes);
-
-  // Check if the current buffer is large enough to hold our data.
-  if (required_size != m_length) {
-    // The length changed
-    uint8_t *new_output = new uint8_t[required_size];
-    memcpy(new_output, m_output, leading);
-    memset(new_output + leading, 0, length);
-    memcpy(new_output + leading + length, m_output + leading, trailing);
-    memset(new_output + leading + length + trailing, 0, total_latch_bytes);
-    delete[] m_output;
-    m_output = new_output;
-    m_length = required_size;
-    m_output_sizes[output] = length;
-  }
-  return m_output + leading;
+  return m_outputs[output]->Checkout(length, latch_bytes);
 }
 
 void SoftwareBackend::Commit(uint8_t output) {
-  if (output >= m_output_sizes.size()) {
+  if (output >= m_outputs.size()) {
     OLA_WARN << "Invalid SPI output " << static_cast<int>(output);
     return;
   }
 
+  m_outputs[output]->Commit();
   bool should_write = m_sync_output < 0 || output == m_sync_output;
-  if (should_write) {
-    if (m_write_pending && m_drop_map) {
+  if (!should_write) {
+    return;
+  }
+
+  {
+    MutexLocker lock(&m_mutex);
+    if (m_write_pending) {
       // There was already another write pending which we're now stomping on
-      (*m_drop_map)[m_spi_writer->DevicePath()]++;
+      m_drop_var.Increment();
     }
-    m_write_pending = should_write;
-  }
-  m_mutex.Unlock();
-  if (should_write) {
-    m_cond_var.Signal();
+    m_write_pending = true;
   }
+  m_cond_var.Signal();
 }
 
 void *SoftwareBackend::Run() {
-  uint8_t *output_data = NULL;
-  unsigned int length = 0;
-
   while (true) {
-    m_mutex.Lock();
-
-    if (m_exit) {
-      m_mutex.Unlock();
-      delete output_data;
-      return NULL;
-    }
-
-    if (!m_write_pending) {
-      m_cond_var.Wait(&m_mutex);
+    {
+      MutexLocker lock(&m_mutex);
+      if (!(m_exit || m_write_pending)) {
+        m_cond_var.Wait(&m_mutex);
+      }
+      if (m_exit) {
+        return NULL;
+      }
+      if (!m_write_pending) {
+        continue;
+      }
+      m_write_pending = false;
     }
 
-    if (m_exit) {
-      m_mutex.Unlock();
-      delete[] output_data;
-      return NULL;
+    // Send the latest frame for each output, and then the latch bytes for
+    // all of them.
+    m_segments.clear();
+    unsigned int latch_bytes = 0;
+    Outputs::iterator iter = m_outputs.begin();
+    for (; iter != m_outputs.end(); ++iter) {
+      TripleBuffer *output = *iter;
+      output->Acquire();
+      if (output->Size()) {
+        IOVec segment;
+        segment.iov_base = const_cast<uint8_t*>(output->Data());
+        segment.iov_len = output->Size();
+        m_segments.push_back(segment);
+      }
+      latch_bytes += output->LatchBytes();
     }
 
-    bool write_pending = m_write_pending;
-    m_write_pending = false;
-    if (write_pending) {
-      if (length < m_length) {
-        delete[] output_data;
-        output_data = new uint8_t[m_length];
-        length = m_length;
+    if (latch_bytes) {
+      if (m_latch_data.size() < latch_bytes) {
+        m_latch_data.resize(latch_bytes, 0);
       }
-      // TODO(simon) Add an actual size here
-      length = m_length;
-      memcpy(output_data, m_output, m_length);
+      IOVec segment;
+      segment.iov_base = &m_latch_data[0];
+      segment.iov_len = latch_bytes;
+      m_segments.push_back(segment);
     }
-    m_mutex.Unlock();
 
-    if (write_pending) {
-      m_spi_writer->WriteSPIData(output_data, length);
+    if (!m_segments.empty()) {
+      m_spi_writer->WriteSPIData(&m_segments[0], m_segments.size());
     }
   }
 }
@@ -29,6 +29,7 @@
 #include <vector>
 
 #include "plugins/spi/SPIWriter.h"
+#include "plugins/spi/TripleBuffer.h"
 
 namespace ola {
 namespace plugin {
@@ -36,6 +37,10 @@ namespace spi {
 
 /**
  * The interface for all SPI Backends.
+ *
+ * The buffer returned by Checkout() holds the data from the last Commit() for
+ * the output, so callers only need to update what changed. Checkout() must
+ * be followed by Commit().
  */
 class SPIBackendInterface {
  public:
@@ -91,65 +96,38 @@ class HardwareBackend : public ola::thread::Thread,
   void* Run();
 
  private:
-  class OutputData {
-   public:
-    OutputData()
-        : m_data(NULL),
-          m_write_pending(false),
-          m_size(0),
-          m_actual_size(0),
-          m_latch_bytes(0) {
-    }
-
-    ~OutputData() { delete[] m_data; }
-
-    uint8_t *Resize(unsigned int length);
-    void SetLatchBytes(unsigned int latch_bytes);
-    void SetPending();
-    bool IsPending() const { return m_write_pending; }
-    void ResetPending() { m_write_pending = false; }
-    const uint8_t *GetData() const { return m_data; }
-    unsigned int Size() const { return m_size; }
-
-    OutputData& operator=(const OutputData &other);
-
-   private:
-    uint8_t *m_data;
-    bool m_write_pending;
-    unsigned int m_size;
-    unsigned int m_actual_size;
-    unsigned int m_latch_bytes;
-
-    OutputData(const OutputData&);
-  };
-
   typedef std::vector<int> GPIOFds;
-  typedef std::vector<OutputData*> Outputs;
+  typedef std::vector<TripleBuffer*> Outputs;
 
   SPIWriterInterface *m_spi_writer;
-  UIntMap *m_drop_map;
+  UIntMapHandle m_drop_var;
   const uint8_t m_output_count;
+  // Only used to wake the writer thread, the frames are handed over by the
+  // TripleBuffers.
   ola::thread::Mutex m_mutex;
   ola::thread::ConditionVariable m_cond_var;
-  bool m_exit;
+  bool m_write_pending;  // GUARDED_BY(m_mutex)
+  bool m_exit;  // GUARDED_BY(m_mutex)
 
-  Outputs m_output_data;
+  Outputs m_outputs;
+  // Owned by the writer thread.
+  std::vector<uint8_t> m_latch_data;
 
   // GPIO members
   GPIOFds m_gpio_fds;
   const std::vector<uint16_t> m_gpio_pins;
   std::vector<bool> m_gpio_pin_state;
 
-  void SetupOutputs(Outputs *outputs);
-  void WriteOutput(uint8_t output_id, OutputData *output);
+  void WriteOutput(uint8_t output_id, const TripleBuffer &output);
   bool SetupGPIO();
   void CloseGPIOFDs();
 };
 
 
 /**
- * An SPI Backend which uses a software multipliexer. This accumulates all data
- * into a single buffer and then writes it to the SPI bus.
+ * An SPI Backend which uses a software multipliexer. This writes the data for
+ * all outputs, followed by the latch bytes, to the SPI bus as a single
+ * message.
  */
 class SoftwareBackend : public SPIBackendInterface,
                         public ola::thread::Thread {
@@ -191,18 +169,22 @@ class SoftwareBackend : public SPIBackendInterface,
   void* Run();
 
  private:
+  typedef std::vector<TripleBuffer*> Outputs;
+
   SPIWriterInterface *m_spi_writer;
-  UIntMap *m_drop_map;
+  UIntMapHandle m_drop_var;
+  // Only used to wake the writer thread, the frames are handed over by the
+  // TripleBuffers.
   ola::thread::Mutex m_mutex;
   ola::thread::ConditionVariable m_cond_var;
-  bool m_write_pending;
-  bool m_exit;
+  bool m_write_pending;  // GUARDED_BY(m_mutex)
+  bool m_exit;  // GUARDED_BY(m_mutex)
 
   const int16_t m_sync_output;
-  std::vector<unsigned int> m_output_sizes;
-  std::vector<unsigned int> m_latch_bytes;
-  uint8_t *m_output;
-  unsigned int m_length;
+  Outputs m_outputs;
+  // Owned by the writer thread.
+  std::vector<ola::io::IOVec> m_segments;
+  std::vector<uint8_t> m_latch_data;
 };
 
 
@@ -19,9 +19,11 @@
  */
 
 #include <string.h>
+#include <unistd.h>
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "ola/base/Array.h"
+#include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
@@ -31,6 +33,8 @@
 
 using ola::DmxBuffer;
 using ola::ExportMap;
+using ola::TimeInterval;
+using ola::TimeStamp;
 using ola::plugin::spi::FakeSPIWriter;
 using ola::plugin::spi::HardwareBackend;
 using ola::plugin::spi::SoftwareBackend;
@@ -41,9 +45,12 @@ class SPIBackendTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(SPIBackendTest);
   CPPUNIT_TEST(testHardwareDrops);
   CPPUNIT_TEST(testHardwareVariousFrameLengths);
+  CPPUNIT_TEST(testHardwareThroughput);
   CPPUNIT_TEST(testInvalidOutputs);
   CPPUNIT_TEST(testSoftwareDrops);
   CPPUNIT_TEST(testSoftwareVariousFrameLengths);
+  CPPUNIT_TEST(testSoftwareMultipleOutputs);
+  CPPUNIT_TEST(testSoftwareThroughput);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -57,12 +64,17 @@ class SPIBackendTest: public CppUnit::TestFixture {
                     unsigned int length,
                     unsigned int checkout_size,
                     unsigned int latch_bytes = 0);
+  void SendFrames(SPIBackendInterface *backend, uint8_t outputs,
+                  const char *name);
 
   void testHardwareDrops();
   void testHardwareVariousFrameLengths();
+  void testHardwareThroughput();
   void testInvalidOutputs();
   void testSoftwareDrops();
   void testSoftwareVariousFrameLengths();
+  void testSoftwareMultipleOutputs();
+  void testSoftwareThroughput();
 
  private:
   ExportMap m_export_map;
@@ -75,10 +87,11 @@ class SPIBackendTest: public CppUnit::TestFixture {
   static const uint8_t EXPECTED1[];
   static const uint8_t EXPECTED2[];
   static const uint8_t EXPECTED3[];
-  static const uint8_t EXPECTED4[];
   static const char DEVICE_NAME[];
   static const char SPI_DROP_VAR[];
   static const char SPI_DROP_VAR_KEY[];
+  static const unsigned int FRAME_COUNT = 20000;
+  static const unsigned int FRAME_SIZE = 1024;
 };
 
 const uint8_t SPIBackendTest::DATA1[] = {
@@ -107,14 +120,11 @@ const uint8_t SPIBackendTest::EXPECTED3[] = {
   0, 0, 0, 0,
 };
 
-const uint8_t SPIBackendTest::EXPECTED4[] = {
-  1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0, 0, 0, 0, 0,
-  0, 0, 0, 0
-};
-
 const char SPIBackendTest::DEVICE_NAME[] = "Fake Device";
 const char SPIBackendTest::SPI_DROP_VAR[] = "spi-drops";
 const char SPIBackendTest::SPI_DROP_VAR_KEY[] = "device";
+const unsigned int SPIBackendTest::FRAME_COUNT;
+const unsigned int SPIBackendTest::FRAME_SIZE;
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SPIBackendTest);
@@ -149,6 +159,49 @@ bool SPIBackendTest::SendSomeData(SPIBackendInterface *backend,
   return true;
 }
 
+/**
+ * Send FRAME_COUNT frames as fast as we can, and wait for the writer to catch
+ * up. Every frame is either written or counted as a drop.
+ */
+void SPIBackendTest::SendFrames(SPIBackendInterface *backend, uint8_t outputs,
+                                const char *name) {
+  ola::Clock clock;
+  TimeStamp start, end;
+  clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < FRAME_COUNT; i++) {
+    for (uint8_t output = 0; output < outputs; output++) {
+      uint8_t *data = backend->Checkout(output, FRAME_SIZE);
+      OLA_ASSERT_NOT_NULL(data);
+      memset(data, static_cast<uint8_t>(i + output), FRAME_SIZE);
+      backend->Commit(output);
+    }
+  }
+  clock.CurrentMonotonicTime(&end);
+
+  // Give the writer up to 10s to finish.
+  for (unsigned int i = 0; i < 10000; i++) {
+    if (m_writer.WriteCount() + DropCount() >= FRAME_COUNT) {
+      break;
+    }
+    usleep(1000);
+  }
+  OLA_ASSERT_EQ(FRAME_COUNT, m_writer.WriteCount() + DropCount());
+
+  // The last write is the last frame for each output.
+  uint8_t expected[FRAME_SIZE * 4];
+  for (uint8_t output = 0; output < outputs; output++) {
+    memset(expected + output * FRAME_SIZE,
+           static_cast<uint8_t>(FRAME_COUNT - 1 + output), FRAME_SIZE);
+  }
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), expected, outputs * FRAME_SIZE);
+
+  const TimeInterval duration = end - start;
+  OLA_INFO << name << ": " << FRAME_COUNT << " frames of "
+           << static_cast<int>(outputs) << " x " << FRAME_SIZE
+           << " bytes committed in " << duration << ", "
+           << m_writer.WriteCount() << " writes, " << DropCount() << " drops";
+}
+
 /**
  * Check that we increment the exported variable when we drop frames.
  */
@@ -215,6 +268,7 @@ void SPIBackendTest::testHardwareVariousFrameLengths() {
       SendSomeData(&backend, 0, DATA1, arraysize(DATA1), m_total_size, 4));
   m_writer.WaitForWrite();
   OLA_ASSERT_EQ(6u, m_writer.WriteCount());
+  OLA_ASSERT_EQ(2u, m_writer.LastSegmentCount());
   m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED3, arraysize(EXPECTED3));
   m_writer.ResetWrite();
 
@@ -226,6 +280,16 @@ void SPIBackendTest::testHardwareVariousFrameLengths() {
   m_writer.ResetWrite();
 }
 
+/**
+ * Check the throughput of the HardwareBackend.
+ */
+void SPIBackendTest::testHardwareThroughput() {
+  HardwareBackend backend(HardwareBackend::Options(), &m_writer,
+                          &m_export_map);
+  OLA_ASSERT(backend.Init());
+  SendFrames(&backend, 1, "HardwareBackend");
+}
+
 /**
  * Check we can't send to invalid outputs.
  */
@@ -314,7 +378,8 @@ void SPIBackendTest::testSoftwareVariousFrameLengths() {
       SendSomeData(&backend, 0, DATA1, arraysize(DATA1), m_total_size, 4));
   m_writer.WaitForWrite();
   OLA_ASSERT_EQ(6u, m_writer.WriteCount());
-  m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED4, arraysize(EXPECTED4));
+  OLA_ASSERT_EQ(2u, m_writer.LastSegmentCount());
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED3, arraysize(EXPECTED3));
   m_writer.ResetWrite();
 
   OLA_ASSERT(
@@ -324,3 +389,60 @@ void SPIBackendTest::testSoftwareVariousFrameLengths() {
   m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED3, arraysize(EXPECTED3));
   m_writer.ResetWrite();
 }
+
+/**
+ * Check that the outputs are written as a single message, and only when the
+ * sync output is updated.
+ */
+void SPIBackendTest::testSoftwareMultipleOutputs() {
+  SoftwareBackend::Options options;
+  options.outputs = 3;
+  options.sync_output = 2;
+  SoftwareBackend backend(options, &m_writer, &m_export_map);
+  OLA_ASSERT(backend.Init());
+
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA1, arraysize(DATA1),
+                          arraysize(DATA1), 2));
+  OLA_ASSERT(SendSomeData(&backend, 1, DATA2, arraysize(DATA2),
+                          arraysize(DATA2), 1));
+  OLA_ASSERT_EQ(0u, m_writer.WriteCount());
+
+  OLA_ASSERT(SendSomeData(&backend, 2, DATA1, 4, 4));
+  m_writer.WaitForWrite();
+  OLA_ASSERT_EQ(1u, m_writer.WriteCount());
+  OLA_ASSERT_EQ(4u, m_writer.LastSegmentCount());
+  const uint8_t expected[] = {
+    1, 2, 3, 4, 5, 6, 7, 8, 9, 0,
+    0xa, 0xb, 0xc, 0xd, 0xe, 0xf,
+    1, 2, 3, 4,
+    0, 0, 0
+  };
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), expected, arraysize(expected));
+  m_writer.ResetWrite();
+
+  // Only the changed output is updated.
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA2, 2, arraysize(DATA1), 2));
+  OLA_ASSERT(SendSomeData(&backend, 2, DATA2, 0, 4));
+  m_writer.WaitForWrite();
+  OLA_ASSERT_EQ(2u, m_writer.WriteCount());
+  const uint8_t expected2[] = {
+    0xa, 0xb, 3, 4, 5, 6, 7, 8, 9, 0,
+    0xa, 0xb, 0xc, 0xd, 0xe, 0xf,
+    1, 2, 3, 4,
+    0, 0, 0
+  };
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), expected2, arraysize(expected2));
+}
+
+/**
+ * Check the throughput of the SoftwareBackend, with the last of four outputs
+ * triggering the writes.
+ */
+void SPIBackendTest::testSoftwareThroughput() {
+  SoftwareBackend::Options options;
+  options.outputs = 4;
+  options.sync_output = 3;
+  SoftwareBackend backend(options, &m_writer, &m_export_map);
+  OLA_ASSERT(backend.Init());
+  SendFrames(&backend, 4, "SoftwareBackend");
+}
@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 
+#include "common/dmx/ColorCorrection.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
 #include "ola/file/Util.h"
@@ -38,6 +39,7 @@ namespace ola {
 namespace plugin {
 namespace spi {
 
+using ola::dmx::ColorCorrection;
 using ola::rdm::UID;
 using std::auto_ptr;
 using std::ostringstream;
@@ -115,6 +117,15 @@ SPIDevice::SPIDevice(SPIPlugin *owner,
       spi_output_options.pixel_count = pixel_count;
     }
 
+    if (!ColorCorrection::FromStrings(
+            m_preferences->GetValue(GammaKey(i)),
+            m_preferences->GetValue(WhiteBalanceKey(i)),
+            &spi_output_options.color_correction)) {
+      OLA_WARN << "Invalid color correction for SPI port "
+               << static_cast<int>(i) << ", check " << GammaKey(i) << " and "
+               << WhiteBalanceKey(i);
+    }
+
     auto_ptr<UID> uid(uid_allocator->AllocateNext());
     if (!uid.get()) {
       OLA_WARN << "Insufficient UIDs remaining to allocate a UID for SPI port "
@@ -220,6 +231,14 @@ string SPIDevice::PixelCountKey(uint8_t port) const {
   return GetPortKey("pixel-count", port);
 }
 
+string SPIDevice::GammaKey(uint8_t port) const {
+  return GetPortKey("gamma", port);
+}
+
+string SPIDevice::WhiteBalanceKey(uint8_t port) const {
+  return GetPortKey("white-balance", port);
+}
+
 string SPIDevice::GetPortKey(const string &suffix, uint8_t port) const {
   std::ostringstream str;
   str << m_spi_device_name << "-" << static_cast<int>(port) << "-" << suffix;
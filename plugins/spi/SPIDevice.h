@@ -75,6 +75,8 @@ class SPIDevice: public ola::Device {
   std::string DeviceLabelKey(uint8_t port) const;
   std::string PersonalityKey(uint8_t port) const;
   std::string PixelCountKey(uint8_t port) const;
+  std::string GammaKey(uint8_t port) const;
+  std::string WhiteBalanceKey(uint8_t port) const;
   std::string StartAddressKey(uint8_t port) const;
   std::string GetPortKey(const std::string &suffix, uint8_t port) const;
 
@@ -45,7 +45,9 @@
 #include "ola/rdm/UID.h"
 #include "ola/rdm/UIDSet.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/thread/Mutex.h"
 
+#include "plugins/spi/PixelEncoder.h"
 #include "plugins/spi/SPIBackend.h"
 #include "plugins/spi/SPIOutput.h"
 
@@ -69,6 +71,8 @@ using ola::rdm::RDMResponse;
 using ola::rdm::ResponderHelper;
 using ola::rdm::UID;
 using ola::rdm::UIDSet;
+using ola::thread::MutexLocker;
+using std::max;
 using std::min;
 using std::string;
 using std::vector;
@@ -94,7 +98,9 @@ const uint16_t SPIOutput::P9813_SPI_BYTES_PER_PIXEL = 4;
 const uint16_t SPIOutput::APA102_SPI_BYTES_PER_PIXEL = 4;
 
 const uint16_t SPIOutput::APA102_START_FRAME_BYTES = 4;
-const uint8_t SPIOutput::APA102_LEDFRAME_START_MARK = 0xE0;
+
+// The slots for a pixel which is off, this is long enough for any personality.
+const uint8_t SPIOutput::BLACK_PIXEL[] = {0, 0, 0, 0};
 
 SPIOutput::RDMOps *SPIOutput::RDMOps::instance = NULL;
 
@@ -180,7 +186,24 @@ SPIOutput::SPIOutput(const UID &uid, SPIBackendInterface *backend,
       m_pixel_count(options.pixel_count),
       m_device_label(options.device_label),
       m_start_address(1),
-      m_identify_mode(false) {
+      m_identify_mode(false),
+      m_color_correction(options.color_correction),
+      m_ws2801_encoder(PIXEL_WS2801),
+      m_lpd8806_encoder(PIXEL_LPD8806),
+      m_p9813_encoder(PIXEL_P9813),
+      m_apa102_encoder(PIXEL_APA102),
+      m_apa102_pb_encoder(PIXEL_APA102_PB),
+      m_encoded_generation(0),
+      m_encoded_personality(0),
+      m_encoded_start_address(0),
+      m_dirty_slot_start(0),
+      m_dirty_slot_end(0) {
+  m_last_frame.EnableChangeTracking();
+  m_ws2801_encoder.SetCorrection(m_color_correction);
+  m_lpd8806_encoder.SetCorrection(m_color_correction);
+  m_p9813_encoder.SetCorrection(m_color_correction);
+  m_apa102_encoder.SetCorrection(m_color_correction);
+  m_apa102_pb_encoder.SetCorrection(m_color_correction);
   m_spi_device_name = FilenameFromPathOrPath(m_backend->DevicePath());
 
   PersonalityCollection::PersonalityList personalities;
@@ -297,6 +320,7 @@ uint8_t SPIOutput::GetPersonality() const {
 }
 
 bool SPIOutput::SetPersonality(uint16_t personality) {
+  MutexLocker lock(&m_mutex);
   return m_personality_manager->SetActivePersonality(personality);
 }
 
@@ -310,6 +334,7 @@ bool SPIOutput::SetStartAddress(uint16_t address) {
   if (address == 0 || address > end_address || footprint == 0) {
     return false;
   }
+  MutexLocker lock(&m_mutex);
   m_start_address = address;
   return true;
 }
@@ -327,6 +352,7 @@ string SPIOutput::Description() const {
  * Send DMX data over SPI.
  */
 bool SPIOutput::WriteDMX(const DmxBuffer &buffer) {
+  MutexLocker lock(&m_mutex);
   if (m_identify_mode) {
     return true;
   }
@@ -356,33 +382,58 @@ void SPIOutput::SendRDMRequest(RDMRequest *request,
 }
 
 bool SPIOutput::InternalWriteDMX(const DmxBuffer &buffer) {
-  switch (m_personality_manager->ActivePersonalityNumber()) {
+  const uint8_t personality = m_personality_manager->ActivePersonalityNumber();
+
+  if (buffer.Size()) {
+    m_last_frame.Set(buffer);
+  } else {
+    m_last_frame.Reset();
+  }
+
+  // Work out which slots need to be encoded. The backends keep the data
+  // from the last frame, so if nothing that affects the encoding has changed
+  // we only need to encode the pixels that did.
+  m_dirty_slot_start = 0;
+  m_dirty_slot_end = DMX_UNIVERSE_SIZE;
+  if (m_encoded_generation && personality == m_encoded_personality &&
+      m_start_address == m_encoded_start_address) {
+    unsigned int offset, length;
+    if (m_last_frame.ChangedSince(m_encoded_generation, &offset, &length)) {
+      m_dirty_slot_start = offset;
+      m_dirty_slot_end = offset + length;
+    } else {
+      m_dirty_slot_end = 0;
+    }
+  }
+
+  bool encoded = false;
+  switch (personality) {
     case PERS_WS2801_INDIVIDUAL:
-      IndividualWS2801Control(buffer);
+      encoded = IndividualWS2801Control(buffer);
       break;
     case PERS_WS2801_COMBINED:
       CombinedWS2801Control(buffer);
       break;
     case PERS_LDP8806_INDIVIDUAL:
-      IndividualLPD8806Control(buffer);
+      encoded = IndividualLPD8806Control(buffer);
       break;
     case PERS_LDP8806_COMBINED:
       CombinedLPD8806Control(buffer);
       break;
     case PERS_P9813_INDIVIDUAL:
-      IndividualP9813Control(buffer);
+      encoded = IndividualP9813Control(buffer);
       break;
     case PERS_P9813_COMBINED:
       CombinedP9813Control(buffer);
       break;
     case PERS_APA102_INDIVIDUAL:
-      IndividualAPA102Control(buffer);
+      encoded = IndividualAPA102Control(buffer);
       break;
     case PERS_APA102_COMBINED:
       CombinedAPA102Control(buffer);
       break;
     case PERS_APA102_PB_INDIVIDUAL:
-      IndividualAPA102ControlPixelBrightness(buffer);
+      encoded = IndividualAPA102ControlPixelBrightness(buffer);
       break;
     case PERS_APA102_PB_COMBINED:
       CombinedAPA102ControlPixelBrightness(buffer);
@@ -390,22 +441,134 @@ bool SPIOutput::InternalWriteDMX(const DmxBuffer &buffer) {
     default:
       break;
   }
+
+  if (encoded) {
+    m_encoded_generation = m_last_frame.Generation();
+    m_encoded_personality = personality;
+    m_encoded_start_address = m_start_address;
+  } else {
+    m_encoded_generation = 0;
+  }
   return true;
 }
 
 
-void SPIOutput::IndividualWS2801Control(const DmxBuffer &buffer) {
+/*
+ * Get the range of pixels affected by the dirty slots.
+ * @param slots_per_pixel the number of DMX slots for each pixel.
+ * @param[out] first_pixel the first pixel to encode.
+ * @param[out] end_pixel one past the last pixel to encode.
+ */
+void SPIOutput::DirtyPixels(unsigned int slots_per_pixel,
+                            unsigned int *first_pixel,
+                            unsigned int *end_pixel) const {
+  const unsigned int first_slot = m_start_address - 1;  // 0 offset
+  *first_pixel = 0;
+  *end_pixel = 0;
+  if (m_dirty_slot_end <= first_slot) {
+    return;
+  }
+
+  if (m_dirty_slot_start > first_slot) {
+    *first_pixel = (m_dirty_slot_start - first_slot) / slots_per_pixel;
+  }
+  *end_pixel = min(
+      m_pixel_count,
+      (m_dirty_slot_end - first_slot + slots_per_pixel - 1) / slots_per_pixel);
+  *first_pixel = min(*first_pixel, *end_pixel);
+}
+
+
+/*
+ * Encode the dirty pixels for the individual personalities.
+ * Pixels with complete data are encoded from the DMX buffer, pixels that
+ * start past the end of the data are set to black.
+ * @param encoder the encoder for the personality.
+ * @param buffer the DMX data.
+ * @param output the SPI data for the first pixel.
+ * @returns the index of the dirty pixel that only has some of its slots, or
+ *   m_pixel_count if there isn't one. What to do with this pixel depends on
+ *   the personality.
+ */
+unsigned int SPIOutput::EncodeDirtyPixels(const PixelEncoder &encoder,
+                                          const DmxBuffer &buffer,
+                                          uint8_t *output) const {
+  const unsigned int slots_per_pixel = encoder.SlotsPerPixel();
+  const unsigned int bytes_per_pixel = encoder.BytesPerPixel();
+  const unsigned int first_slot = m_start_address - 1;  // 0 offset
+
+  unsigned int first_pixel, end_pixel;
+  DirtyPixels(slots_per_pixel, &first_pixel, &end_pixel);
+
+  unsigned int incomplete_pixel = m_pixel_count;
+  unsigned int complete_pixels = 0;
+  unsigned int first_black_pixel = 0;
+  if (buffer.Size() >= first_slot) {
+    complete_pixels = (buffer.Size() - first_slot) / slots_per_pixel;
+    first_black_pixel = complete_pixels + 1;
+    if (complete_pixels >= first_pixel && complete_pixels < end_pixel) {
+      incomplete_pixel = complete_pixels;
+    }
+  }
+
+  const unsigned int encode_end = min(end_pixel, complete_pixels);
+  if (first_pixel < encode_end) {
+    encoder.Encode(buffer.GetRaw() + first_slot + first_pixel * slots_per_pixel,
+                   encode_end - first_pixel,
+                   output + first_pixel * bytes_per_pixel);
+  }
+
+  const unsigned int black_start = max(first_pixel, first_black_pixel);
+  if (black_start < end_pixel) {
+    encoder.Fill(BLACK_PIXEL, end_pixel - black_start,
+                 output + black_start * bytes_per_pixel);
+  }
+  return incomplete_pixel;
+}
+
+
+/*
+ * Read the single pixel used by the combined personalities.
+ * @param slots_per_pixel the number of DMX slots for the pixel.
+ * @param buffer the DMX data.
+ * @param[out] pixel_data the slots for the pixel, missing slots are set to 0.
+ */
+void SPIOutput::CombinedPixel(unsigned int slots_per_pixel,
+                              const DmxBuffer &buffer,
+                              uint8_t *pixel_data) const {
+  const unsigned int first_slot = m_start_address - 1;  // 0 offset
+  for (unsigned int i = 0; i < slots_per_pixel; i++) {
+    pixel_data[i] = buffer.Get(first_slot + i);
+  }
+}
+
+
+bool SPIOutput::IndividualWS2801Control(const DmxBuffer &buffer) {
   // We always check out the entire string length, even if we only have data
   // for part of it
   const unsigned int output_length = m_pixel_count * WS2801_SLOTS_PER_PIXEL;
   uint8_t *output = m_backend->Checkout(m_output_number, output_length);
   if (!output) {
-    return;
+    return false;
   }
 
-  unsigned int new_length = output_length;
-  buffer.GetRange(m_start_address - 1, output, &new_length);
+  // The WS2801 data is the DMX data, including any partial pixel at the end.
+  unsigned int first_pixel, end_pixel;
+  DirtyPixels(WS2801_SLOTS_PER_PIXEL, &first_pixel, &end_pixel);
+  const unsigned int start = first_pixel * WS2801_SLOTS_PER_PIXEL;
+  unsigned int new_length = (end_pixel - first_pixel) * WS2801_SLOTS_PER_PIXEL;
+  if (m_color_correction.IsIdentity()) {
+    buffer.GetRange(m_start_address - 1 + start, output + start, &new_length);
+  } else {
+    // As GetRange(), but with the correction applied as the data is copied.
+    const unsigned int first_slot = m_start_address - 1 + start;
+    new_length = first_slot < buffer.Size() ?
+        min(new_length, buffer.Size() - first_slot) : 0;
+    m_color_correction.Apply(buffer.GetRaw() + first_slot, new_length,
+                             output + start);
+  }
   m_backend->Commit(m_output_number);
+  return true;
 }
 
 void SPIOutput::CombinedWS2801Control(const DmxBuffer &buffer) {
@@ -424,19 +587,16 @@ void SPIOutput::CombinedWS2801Control(const DmxBuffer &buffer) {
     return;
   }
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    memcpy(output + (i * WS2801_SLOTS_PER_PIXEL), pixel_data,
-           pixel_data_length);
-  }
+  m_ws2801_encoder.Fill(pixel_data, m_pixel_count, output);
   m_backend->Commit(m_output_number);
 }
 
-void SPIOutput::IndividualLPD8806Control(const DmxBuffer &buffer) {
+bool SPIOutput::IndividualLPD8806Control(const DmxBuffer &buffer) {
   const uint8_t latch_bytes = (m_pixel_count + 31) / 32;
   const unsigned int first_slot = m_start_address - 1;  // 0 offset
   if (buffer.Size() - first_slot < LPD8806_SLOTS_PER_PIXEL) {
     // not even 3 bytes of data, don't bother updating
-    return;
+    return false;
   }
 
   // We always check out the entire string length, even if we only have data
@@ -445,22 +605,29 @@ void SPIOutput::IndividualLPD8806Control(const DmxBuffer &buffer) {
   uint8_t *output = m_backend->Checkout(m_output_number, output_length,
                                         latch_bytes);
   if (!output)
-    return;
+    return false;
 
-  const unsigned int length = min(m_pixel_count * LPD8806_SLOTS_PER_PIXEL,
-                                       buffer.Size() - first_slot);
-
-  for (unsigned int i = 0; i < length / LPD8806_SLOTS_PER_PIXEL; i++) {
-    // Convert RGB to GRB
-    unsigned int offset = first_slot + i * LPD8806_SLOTS_PER_PIXEL;
-    uint8_t r = buffer.Get(offset);
-    uint8_t g = buffer.Get(offset + 1);
-    uint8_t b = buffer.Get(offset + 2);
-    output[i * LPD8806_SLOTS_PER_PIXEL] = 0x80 | (g >> 1);
-    output[i * LPD8806_SLOTS_PER_PIXEL + 1] = 0x80 | (r >> 1);
-    output[i * LPD8806_SLOTS_PER_PIXEL + 2] = 0x80 | (b >> 1);
+  unsigned int first_pixel, end_pixel;
+  DirtyPixels(LPD8806_SLOTS_PER_PIXEL, &first_pixel, &end_pixel);
+  if (buffer.Size() < first_slot) {
+    // No data for any of the pixels, set them to black.
+    if (first_pixel < end_pixel) {
+      m_lpd8806_encoder.Fill(BLACK_PIXEL, end_pixel - first_pixel,
+                             output + first_pixel * LPD8806_SLOTS_PER_PIXEL);
+    }
+  } else {
+    // Only the pixels we have complete data for are updated.
+    end_pixel = min(end_pixel,
+                    (buffer.Size() - first_slot) / LPD8806_SLOTS_PER_PIXEL);
+    if (first_pixel < end_pixel) {
+      m_lpd8806_encoder.Encode(
+          buffer.GetRaw() + first_slot + first_pixel * LPD8806_SLOTS_PER_PIXEL,
+          end_pixel - first_pixel,
+          output + first_pixel * LPD8806_SLOTS_PER_PIXEL);
+    }
   }
   m_backend->Commit(m_output_number);
+  return true;
 }
 
 void SPIOutput::CombinedLPD8806Control(const DmxBuffer &buffer) {
@@ -475,32 +642,23 @@ void SPIOutput::CombinedLPD8806Control(const DmxBuffer &buffer) {
     return;
   }
 
-  // The leds are GRB format so convert here
-  uint8_t temp = pixel_data[1];
-  pixel_data[1] = pixel_data[0];
-  pixel_data[0] = temp;
-
   const unsigned int length = m_pixel_count * LPD8806_SLOTS_PER_PIXEL;
   uint8_t *output = m_backend->Checkout(m_output_number, length, latch_bytes);
   if (!output)
     return;
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    for (unsigned int j = 0; j < LPD8806_SLOTS_PER_PIXEL; j++) {
-      output[i * LPD8806_SLOTS_PER_PIXEL + j] = 0x80 | (pixel_data[j] >> 1);
-    }
-  }
+  m_lpd8806_encoder.Fill(pixel_data, m_pixel_count, output);
   m_backend->Commit(m_output_number);
 }
 
-void SPIOutput::IndividualP9813Control(const DmxBuffer &buffer) {
+bool SPIOutput::IndividualP9813Control(const DmxBuffer &buffer) {
   // We need 4 bytes of zeros in the beginning and 8 bytes at
   // the end
   const uint8_t latch_bytes = 3 * P9813_SPI_BYTES_PER_PIXEL;
   const unsigned int first_slot = m_start_address - 1;  // 0 offset
   if (buffer.Size() - first_slot < P9813_SLOTS_PER_PIXEL) {
     // not even 3 bytes of data, don't bother updating
-    return;
+    return false;
   }
 
   // We always check out the entire string length, even if we only have data
@@ -510,29 +668,20 @@ void SPIOutput::IndividualP9813Control(const DmxBuffer &buffer) {
                                         latch_bytes);
 
   if (!output) {
-    return;
+    return false;
   }
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    // Convert RGB to P9813 Pixel
-    unsigned int offset = first_slot + i * P9813_SLOTS_PER_PIXEL;
-    // We need to avoid the first 4 bytes of the buffer since that acts as a
-    // start of frame delimiter
-    unsigned int spi_offset = (i + 1) * P9813_SPI_BYTES_PER_PIXEL;
-    uint8_t r = 0;
-    uint8_t b = 0;
-    uint8_t g = 0;
-    if (buffer.Size() - offset >= P9813_SLOTS_PER_PIXEL) {
-      r = buffer.Get(offset);
-      g = buffer.Get(offset + 1);
-      b = buffer.Get(offset + 2);
-    }
-    output[spi_offset] = P9813CreateFlag(r, g, b);
-    output[spi_offset + 1] = b;
-    output[spi_offset + 2] = g;
-    output[spi_offset + 3] = r;
+  // We need to avoid the first 4 bytes of the buffer since that acts as a
+  // start of frame delimiter
+  uint8_t *pixels = output + P9813_SPI_BYTES_PER_PIXEL;
+  const unsigned int incomplete_pixel = EncodeDirtyPixels(m_p9813_encoder,
+                                                          buffer, pixels);
+  if (incomplete_pixel < m_pixel_count) {
+    m_p9813_encoder.Fill(BLACK_PIXEL, 1,
+                         pixels + incomplete_pixel * P9813_SPI_BYTES_PER_PIXEL);
   }
   m_backend->Commit(m_output_number);
+  return true;
 }
 
 void SPIOutput::CombinedP9813Control(const DmxBuffer &buffer) {
@@ -545,12 +694,8 @@ void SPIOutput::CombinedP9813Control(const DmxBuffer &buffer) {
     return;
   }
 
-  uint8_t pixel_data[P9813_SPI_BYTES_PER_PIXEL];
-  pixel_data[3] = buffer.Get(first_slot);  // Get Red
-  pixel_data[2] = buffer.Get(first_slot + 1);  // Get Green
-  pixel_data[1] = buffer.Get(first_slot + 2);  // Get Blue
-  pixel_data[0] = P9813CreateFlag(pixel_data[3], pixel_data[2],
-                                  pixel_data[1]);
+  uint8_t pixel_data[P9813_SLOTS_PER_PIXEL];
+  CombinedPixel(P9813_SLOTS_PER_PIXEL, buffer, pixel_data);
 
   const unsigned int length = m_pixel_count * P9813_SPI_BYTES_PER_PIXEL;
   uint8_t *output = m_backend->Checkout(m_output_number, length, latch_bytes);
@@ -558,27 +703,13 @@ void SPIOutput::CombinedP9813Control(const DmxBuffer &buffer) {
     return;
   }
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    memcpy(&output[(i + 1) * P9813_SPI_BYTES_PER_PIXEL], pixel_data,
-           P9813_SPI_BYTES_PER_PIXEL);
-  }
+  m_p9813_encoder.Fill(pixel_data, m_pixel_count,
+                       output + P9813_SPI_BYTES_PER_PIXEL);
   m_backend->Commit(m_output_number);
 }
 
-/**
- * For more information please visit:
- * https://github.com/CoolNeon/elinux-tcl/blob/master/README.txt
- */
-uint8_t SPIOutput::P9813CreateFlag(uint8_t red, uint8_t green, uint8_t blue) {
-  uint8_t flag = 0;
-  flag =  (red & 0xc0) >> 6;
-  flag |= (green & 0xc0) >> 4;
-  flag |= (blue & 0xc0) >> 2;
-  return ~flag;
-}
-
 
-void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
+bool SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
   // some detailed information on the protocol:
   // https://cpldcpu.wordpress.com/2014/11/30/understanding-the-apa102-superled/
   // Data-Struct
@@ -593,66 +724,34 @@ void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
   if ((buffer.Size() - first_slot) < APA102_SLOTS_PER_PIXEL) {
     OLA_INFO << "Insufficient DMX data, required " << APA102_SLOTS_PER_PIXEL
              << ", got " << buffer.Size() - first_slot;
-    return;
-  }
-
-  // We always check out the entire string length, even if we only have data
-  // for part of it
-  uint16_t output_length = (m_pixel_count * APA102_SPI_BYTES_PER_PIXEL);
-  // only add the APA102_START_FRAME_BYTES on the first port!!
-  if (m_output_number == 0) {
-    output_length += APA102_START_FRAME_BYTES;
-  }
-  uint8_t *output = m_backend->Checkout(
-      m_output_number,
-      output_length,
-      CalculateAPA102LatchBytes(m_pixel_count));
-
-  // only update SPI data if possible
-  if (!output) {
-    return;
+    return false;
   }
 
-  // only write to APA102_START_FRAME_BYTES on the first port!!
-  if (m_output_number == 0) {
-    // set APA102_START_FRAME_BYTES to zero
-    memset(output, 0, APA102_START_FRAME_BYTES);
+  uint8_t *pixels = CheckoutAPA102();
+  if (!pixels) {
+    return false;
   }
 
-  for (uint16_t i = 0; i < m_pixel_count; i++) {
-    // Convert RGB to APA102 Pixel
-    uint16_t offset = first_slot + (i * APA102_SLOTS_PER_PIXEL);
-
-
-    uint16_t spi_offset = (i * APA102_SPI_BYTES_PER_PIXEL);
-    // only skip APA102_START_FRAME_BYTES on the first port!!
-    if (m_output_number == 0) {
-      // We need to avoid the first 4 bytes of the buffer since that acts as a
-      // start of frame delimiter
-      spi_offset += APA102_START_FRAME_BYTES;
-    }
-    // set pixel data
-    // first Byte contains:
-    // 3 bits start mark (111) + 5 bits global brightness
-    // set global brightness fixed to 31 --> that reduces flickering
-    // that can be written as 0xE0 & 0x1F
-    output[spi_offset] = 0xFF;
-    // only write pixel data if buffer has complete data for this pixel:
-    if ((buffer.Size() - offset) >= APA102_SLOTS_PER_PIXEL) {
-      // Convert RGB to APA102 Pixel
-      // skip spi_offset + 0 (is already set)
-      output[spi_offset + 1] = buffer.Get(offset + 2);  // blue
-      output[spi_offset + 2] = buffer.Get(offset + 1);  // green
-      output[spi_offset + 3] = buffer.Get(offset);      // red
-    }
+  // set pixel data
+  // first Byte contains:
+  // 3 bits start mark (111) + 5 bits global brightness
+  // set global brightness fixed to 31 --> that reduces flickering
+  // that can be written as 0xE0 & 0x1F
+  const unsigned int incomplete_pixel = EncodeDirtyPixels(m_apa102_encoder,
+                                                          buffer, pixels);
+  if (incomplete_pixel < m_pixel_count) {
+    // only write the color data if the buffer has complete data for this
+    // pixel
+    pixels[incomplete_pixel * APA102_SPI_BYTES_PER_PIXEL] = 0xFF;
   }
 
   // write output back
   m_backend->Commit(m_output_number);
+  return true;
 }
 
 
-void SPIOutput::IndividualAPA102ControlPixelBrightness(
+bool SPIOutput::IndividualAPA102ControlPixelBrightness(
     const DmxBuffer &buffer) {
   // some detailed information on the protocol:
   // https://cpldcpu.wordpress.com/2014/11/30/understanding-the-apa102-superled/
@@ -670,60 +769,24 @@ void SPIOutput::IndividualAPA102ControlPixelBrightness(
   if ((buffer.Size() - first_slot) < APA102_PB_SLOTS_PER_PIXEL) {
     OLA_INFO << "Insufficient DMX data, required " << APA102_PB_SLOTS_PER_PIXEL
              << ", got " << buffer.Size() - first_slot;
-    return;
-  }
-
-  // We always check out the entire string length, even if we only have data
-  // for part of it
-  uint16_t output_length = (m_pixel_count * APA102_SPI_BYTES_PER_PIXEL);
-  // only add the APA102_START_FRAME_BYTES on the first port!!
-  if (m_output_number == 0) {
-    output_length += APA102_START_FRAME_BYTES;
-  }
-  uint8_t *output = m_backend->Checkout(
-      m_output_number,
-      output_length,
-      CalculateAPA102LatchBytes(m_pixel_count));
-
-  // only update SPI data if possible
-  if (!output) {
-    return;
+    return false;
   }
 
-  // only write to APA102_START_FRAME_BYTES on the first port!!
-  if (m_output_number == 0) {
-    // set APA102_START_FRAME_BYTES to zero
-    memset(output, 0, APA102_START_FRAME_BYTES);
+  uint8_t *pixels = CheckoutAPA102();
+  if (!pixels) {
+    return false;
   }
 
-  for (uint16_t i = 0; i < m_pixel_count; i++) {
-    // Convert RGB to APA102 Pixel
-    uint16_t offset = first_slot + (i * APA102_PB_SLOTS_PER_PIXEL);
-
-    uint16_t spi_offset = (i * APA102_SPI_BYTES_PER_PIXEL);
-    // only skip APA102_START_FRAME_BYTES on the first port!!
-    if (m_output_number == 0) {
-      // We need to avoid the first 4 bytes of the buffer since that acts as a
-      // start of frame delimiter
-      spi_offset += APA102_START_FRAME_BYTES;
-    }
-    // set pixel data
-    // only write pixel data if buffer has complete data for this pixel:
-    if ((buffer.Size() - offset) >= APA102_PB_SLOTS_PER_PIXEL) {
-      // first Byte:
-      // 3 bits start mark (111) (APA102_LEDFRAME_START_MARK) +
-      // 5 bits pixel brightness (datasheet name: global brightness)
-      output[spi_offset + 0] = (SPIOutput::APA102_LEDFRAME_START_MARK |
-          CalculateAPA102PixelBrightness(buffer.Get(offset + 0)));
-      // Convert RGB to APA102 Pixel
-      output[spi_offset + 1] = buffer.Get(offset + 3);  // blue
-      output[spi_offset + 2] = buffer.Get(offset + 2);  // green
-      output[spi_offset + 3] = buffer.Get(offset + 1);  // red
-    }
-  }
+  // set pixel data
+  // first Byte:
+  // 3 bits start mark (111) + 5 bits pixel brightness (datasheet name: global
+  // brightness)
+  // A pixel without complete data is left as is.
+  EncodeDirtyPixels(m_apa102_pb_encoder, buffer, pixels);
 
   // write output back
   m_backend->Commit(m_output_number);
+  return true;
 }
 
 void SPIOutput::CombinedAPA102Control(const DmxBuffer &buffer) {
@@ -739,45 +802,15 @@ void SPIOutput::CombinedAPA102Control(const DmxBuffer &buffer) {
     return;
   }
 
-  // We always check out the entire string length, even if we only have data
-  // for part of it
-  uint16_t output_length = (m_pixel_count * APA102_SPI_BYTES_PER_PIXEL);
-  // only add the APA102_START_FRAME_BYTES on the first port!!
-  if (m_output_number == 0) {
-    output_length += APA102_START_FRAME_BYTES;
-  }
-  uint8_t *output = m_backend->Checkout(
-      m_output_number,
-      output_length,
-      CalculateAPA102LatchBytes(m_pixel_count));
-
-  // only update SPI data if possible
-  if (!output) {
+  uint8_t *pixels = CheckoutAPA102();
+  if (!pixels) {
     return;
   }
 
-  // only write to APA102_START_FRAME_BYTES on the first port!!
-  if (m_output_number == 0) {
-    // set APA102_START_FRAME_BYTES to zero
-    memset(output, 0, APA102_START_FRAME_BYTES);
-  }
-
-  // create Pixel Data
-  uint8_t pixel_data[APA102_SPI_BYTES_PER_PIXEL];
-  pixel_data[0] = 0xFF;
-  pixel_data[1] = buffer.Get(first_slot + 2);  // Get Blue
-  pixel_data[2] = buffer.Get(first_slot + 1);  // Get Green
-  pixel_data[3] = buffer.Get(first_slot);      // Get Red
-
   // set all pixel to same value
-  for (uint16_t i = 0; i < m_pixel_count; i++) {
-    uint16_t spi_offset = (i * APA102_SPI_BYTES_PER_PIXEL);
-    if (m_output_number == 0) {
-      spi_offset += APA102_START_FRAME_BYTES;
-    }
-    memcpy(&output[spi_offset], pixel_data,
-           APA102_SPI_BYTES_PER_PIXEL);
-  }
+  uint8_t pixel_data[APA102_SLOTS_PER_PIXEL];
+  CombinedPixel(APA102_SLOTS_PER_PIXEL, buffer, pixel_data);
+  m_apa102_encoder.Fill(pixel_data, m_pixel_count, pixels);
 
   // write output back...
   m_backend->Commit(m_output_number);
@@ -796,6 +829,26 @@ void SPIOutput::CombinedAPA102ControlPixelBrightness(const DmxBuffer &buffer) {
     return;
   }
 
+  uint8_t *pixels = CheckoutAPA102();
+  if (!pixels) {
+    return;
+  }
+
+  // set all pixel to same value
+  uint8_t pixel_data[APA102_PB_SLOTS_PER_PIXEL];
+  CombinedPixel(APA102_PB_SLOTS_PER_PIXEL, buffer, pixel_data);
+  m_apa102_pb_encoder.Fill(pixel_data, m_pixel_count, pixels);
+
+  // write output back...
+  m_backend->Commit(m_output_number);
+}
+
+/**
+ * Checkout the output buffer for the APA102 personalities.
+ * @returns a pointer to the data for the first pixel, or NULL if the buffer
+ *   couldn't be checked out.
+ */
+uint8_t *SPIOutput::CheckoutAPA102() {
   // We always check out the entire string length, even if we only have data
   // for part of it
   uint16_t output_length = (m_pixel_count * APA102_SPI_BYTES_PER_PIXEL);
@@ -810,39 +863,18 @@ void SPIOutput::CombinedAPA102ControlPixelBrightness(const DmxBuffer &buffer) {
 
   // only update SPI data if possible
   if (!output) {
-    return;
+    return NULL;
   }
 
   // only write to APA102_START_FRAME_BYTES on the first port!!
   if (m_output_number == 0) {
     // set APA102_START_FRAME_BYTES to zero
     memset(output, 0, APA102_START_FRAME_BYTES);
+    // We need to avoid the first 4 bytes of the buffer since that acts as a
+    // start of frame delimiter
+    output += APA102_START_FRAME_BYTES;
   }
-
-  // create Pixel Data
-  uint8_t pixel_data[APA102_SPI_BYTES_PER_PIXEL];
-  // first Byte:
-  // 3 bits start mark (111) (APA102_LEDFRAME_START_MARK) +
-  // 5 bits pixel brightness (datasheet name: global brightness)
-  pixel_data[0] = (SPIOutput::APA102_LEDFRAME_START_MARK |
-      CalculateAPA102PixelBrightness(buffer.Get(first_slot + 0)));
-  // color data
-  pixel_data[1] = buffer.Get(first_slot + 3);  // Get Blue
-  pixel_data[2] = buffer.Get(first_slot + 2);  // Get Green
-  pixel_data[3] = buffer.Get(first_slot + 1);  // Get Red
-
-  // set all pixel to same value
-  for (uint16_t i = 0; i < m_pixel_count; i++) {
-    uint16_t spi_offset = (i * APA102_SPI_BYTES_PER_PIXEL);
-    if (m_output_number == 0) {
-      spi_offset += APA102_START_FRAME_BYTES;
-    }
-    memcpy(&output[spi_offset], pixel_data,
-           APA102_SPI_BYTES_PER_PIXEL);
-  }
-
-  // write output back...
-  m_backend->Commit(m_output_number);
+  return output;
 }
 
 /**
@@ -862,16 +894,6 @@ uint8_t SPIOutput::CalculateAPA102LatchBytes(uint16_t pixel_count) {
   return latch_bytes;
 }
 
-/**
- * Calculate Pixel Brightness for APA102:
- * Map Input to Output range:
- * Input is 8bit value (0..255)
- * Output is 5bit value (0..31)
- */
-uint8_t SPIOutput::CalculateAPA102PixelBrightness(uint8_t brightness) {
-  return (brightness >> 3);
-}
-
 
 
 RDMResponse *SPIOutput::GetDeviceInfo(const RDMRequest *request) {
@@ -918,6 +940,7 @@ RDMResponse *SPIOutput::GetDmxPersonality(const RDMRequest *request) {
 }
 
 RDMResponse *SPIOutput::SetDmxPersonality(const RDMRequest *request) {
+  MutexLocker lock(&m_mutex);
   return ResponderHelper::SetPersonality(request, m_personality_manager.get(),
                                          m_start_address);
 }
@@ -937,6 +960,7 @@ RDMResponse *SPIOutput::GetDmxStartAddress(const RDMRequest *request) {
 }
 
 RDMResponse *SPIOutput::SetDmxStartAddress(const RDMRequest *request) {
+  MutexLocker lock(&m_mutex);
   return ResponderHelper::SetDmxAddress(request, m_personality_manager.get(),
                                         &m_start_address);
 }
@@ -946,6 +970,7 @@ RDMResponse *SPIOutput::GetIdentify(const RDMRequest *request) {
 }
 
 RDMResponse *SPIOutput::SetIdentify(const RDMRequest *request) {
+  MutexLocker lock(&m_mutex);
   bool old_value = m_identify_mode;
   RDMResponse *response = ResponderHelper::SetBoolValue(
       request, &m_identify_mode);
@@ -23,6 +23,7 @@
 
 #include <memory>
 #include <string>
+#include "common/dmx/ColorCorrection.h"
 #include "common/rdm/NetworkManager.h"
 #include "ola/DmxBuffer.h"
 #include "ola/rdm/RDMControllerInterface.h"
@@ -31,6 +32,8 @@
 #include "ola/rdm/ResponderOps.h"
 #include "ola/rdm/ResponderPersonality.h"
 #include "ola/rdm/ResponderSensor.h"
+#include "ola/thread/Mutex.h"
+#include "plugins/spi/PixelEncoder.h"
 
 namespace ola {
 namespace plugin {
@@ -63,6 +66,8 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
     std::string device_label;
     uint8_t pixel_count;
     uint8_t output_number;
+    // Applied to the pixel data as it's encoded.
+    ola::dmx::ColorCorrection color_correction;
 
     explicit Options(uint8_t output_number, const std::string &spi_device_name)
         : device_label("SPI Device - " + spi_device_name),
@@ -116,26 +121,57 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
   const ola::rdm::UID m_uid;
   const unsigned int m_pixel_count;
   std::string m_device_label;
-  uint16_t m_start_address;  // starts from 1
-  bool m_identify_mode;
+
+  // WriteDMX() may be called from an output worker thread. Everything else
+  // runs on the main thread, which changes the settings below while holding
+  // the mutex, so the main thread can read them without it.
+  ola::thread::Mutex m_mutex;
+  uint16_t m_start_address;  // starts from 1, GUARDED_BY(m_mutex)
+  bool m_identify_mode;  // GUARDED_BY(m_mutex)
   std::auto_ptr<ola::rdm::PersonalityCollection> m_personality_collection;
   std::auto_ptr<ola::rdm::PersonalityManager> m_personality_manager;
   ola::rdm::Sensors m_sensors;
   std::auto_ptr<ola::rdm::NetworkManagerInterface> m_network_manager;
 
+  const ola::dmx::ColorCorrection m_color_correction;
+  PixelEncoder m_ws2801_encoder;
+  PixelEncoder m_lpd8806_encoder;
+  PixelEncoder m_p9813_encoder;
+  PixelEncoder m_apa102_encoder;
+  PixelEncoder m_apa102_pb_encoder;
+
+  // A copy of the last frame, with change tracking enabled. The individual
+  // personalities use this to only encode the pixels that changed. The
+  // encoding state is only used with m_mutex held.
+  DmxBuffer m_last_frame;
+  unsigned int m_encoded_generation;  // 0 if a full update is required
+  uint8_t m_encoded_personality;
+  uint16_t m_encoded_start_address;
+  unsigned int m_dirty_slot_start;
+  unsigned int m_dirty_slot_end;
+
   // DMX methods
   bool InternalWriteDMX(const DmxBuffer &buffer);
+  void DirtyPixels(unsigned int slots_per_pixel, unsigned int *first_pixel,
+                   unsigned int *end_pixel) const;
+  unsigned int EncodeDirtyPixels(const PixelEncoder &encoder,
+                                 const DmxBuffer &buffer,
+                                 uint8_t *output) const;
+  void CombinedPixel(unsigned int slots_per_pixel, const DmxBuffer &buffer,
+                     uint8_t *pixel_data) const;
 
-  void IndividualWS2801Control(const DmxBuffer &buffer);
+  // The individual methods return true if the output was updated.
+  bool IndividualWS2801Control(const DmxBuffer &buffer);
   void CombinedWS2801Control(const DmxBuffer &buffer);
-  void IndividualLPD8806Control(const DmxBuffer &buffer);
+  bool IndividualLPD8806Control(const DmxBuffer &buffer);
   void CombinedLPD8806Control(const DmxBuffer &buffer);
-  void IndividualP9813Control(const DmxBuffer &buffer);
+  bool IndividualP9813Control(const DmxBuffer &buffer);
   void CombinedP9813Control(const DmxBuffer &buffer);
-  void IndividualAPA102Control(const DmxBuffer &buffer);
+  bool IndividualAPA102Control(const DmxBuffer &buffer);
   void CombinedAPA102Control(const DmxBuffer &buffer);
-  void IndividualAPA102ControlPixelBrightness(const DmxBuffer &buffer);
+  bool IndividualAPA102ControlPixelBrightness(const DmxBuffer &buffer);
   void CombinedAPA102ControlPixelBrightness(const DmxBuffer &buffer);
+  uint8_t *CheckoutAPA102();
 
   unsigned int LPD8806BufferSize() const;
   void WriteSPIData(const uint8_t *data, unsigned int length);
@@ -197,9 +233,7 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
       const ola::rdm::RDMRequest *request);
 
   // Helpers
-  uint8_t P9813CreateFlag(uint8_t red, uint8_t green, uint8_t blue);
   static uint8_t CalculateAPA102LatchBytes(uint16_t pixel_count);
-  static uint8_t CalculateAPA102PixelBrightness(uint8_t brightness);
 
   static const uint8_t SPI_MODE;
   static const uint8_t SPI_BITS_PER_WORD;
@@ -213,7 +247,7 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
   static const uint16_t APA102_PB_SLOTS_PER_PIXEL;
   static const uint16_t APA102_SPI_BYTES_PER_PIXEL;
   static const uint16_t APA102_START_FRAME_BYTES;
-  static const uint8_t APA102_LEDFRAME_START_MARK;
+  static const uint8_t BLACK_PIXEL[];
 
   static const ola::rdm::ResponderOps<SPIOutput>::ParamHandler
       PARAM_HANDLERS[];
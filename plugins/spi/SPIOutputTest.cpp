@@ -21,6 +21,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <string>
 
+#include "common/dmx/ColorCorrection.h"
 #include "ola/base/Array.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
@@ -30,6 +31,7 @@
 #include "plugins/spi/SPIOutput.h"
 
 using ola::DmxBuffer;
+using ola::dmx::ColorCorrection;
 using ola::plugin::spi::FakeSPIBackend;
 using ola::plugin::spi::SPIBackendInterface;
 using ola::plugin::spi::SPIOutput;
@@ -49,6 +51,11 @@ class SPIOutputTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testCombinedAPA102Control);
   CPPUNIT_TEST(testIndividualAPA102ControlPixelBrightness);
   CPPUNIT_TEST(testCombinedAPA102ControlPixelBrightness);
+  CPPUNIT_TEST(testColorCorrection);
+  CPPUNIT_TEST(testChangedPixel);
+  CPPUNIT_TEST(testStartAddressChange);
+  CPPUNIT_TEST(testShorterFrame);
+  CPPUNIT_TEST(testPersonalityChange);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -69,6 +76,11 @@ class SPIOutputTest: public CppUnit::TestFixture {
   void testCombinedAPA102Control();
   void testIndividualAPA102ControlPixelBrightness();
   void testCombinedAPA102ControlPixelBrightness();
+  void testColorCorrection();
+  void testChangedPixel();
+  void testStartAddressChange();
+  void testShorterFrame();
+  void testPersonalityChange();
 
  private:
   UID m_uid;
@@ -1139,3 +1151,233 @@ void SPIOutputTest::testCombinedAPA102ControlPixelBrightness() {
   OLA_ASSERT_DATA_EQUALS(EXPECTED8, arraysize(EXPECTED8), data, length);
   OLA_ASSERT_EQ(5u, backend.Writes(0));
 }
+
+
+/**
+ * Test DMX writes with a color correction.
+ */
+void SPIOutputTest::testColorCorrection() {
+  FakeSPIBackend backend(2);
+  SPIOutput::Options options(0, "Test SPI Device");
+  options.pixel_count = 2;
+  options.color_correction = ColorCorrection(2.0, 255, 255, 255);
+  SPIOutput output(m_uid, &backend, options);
+  output.SetPersonality(SPIOutput::PERS_WS2801_INDIVIDUAL);
+
+  DmxBuffer buffer;
+  unsigned int length = 0;
+  const uint8_t *data = NULL;
+
+  buffer.SetFromString("255,128,0,10,20,30");
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED1[] = { 255, 64, 0, 0, 2, 4 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED1, arraysize(EXPECTED1), data, length);
+
+  // Partial pixels are corrected as well
+  buffer.SetFromString("200,100");
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED2[] = { 157, 39, 0, 0, 2, 4 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED2, arraysize(EXPECTED2), data, length);
+
+  output.SetPersonality(SPIOutput::PERS_LDP8806_COMBINED);
+  buffer.SetFromString("255,128,0");
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED3[] = { 0xA0, 0xFF, 0x80, 0xA0, 0xFF, 0x80, 0 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED3, arraysize(EXPECTED3), data, length);
+
+  // The APA102 uses the global brightness for dim pixels
+  output.SetPersonality(SPIOutput::PERS_APA102_INDIVIDUAL);
+  buffer.SetFromString("255,255,255,10,20,30");
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED4[] = { 0, 0, 0, 0,
+                                0xFF, 0xFF, 0xFF, 0xFF,
+                                0xE1, 0x6D, 0x31, 0x0C,
+                                0};
+  OLA_ASSERT_DATA_EQUALS(EXPECTED4, arraysize(EXPECTED4), data, length);
+}
+
+
+/**
+ * Check that only the pixels which changed are encoded again.
+ */
+void SPIOutputTest::testChangedPixel() {
+  FakeSPIBackend backend(1);
+  SPIOutput::Options options(0, "Test SPI Device");
+  options.pixel_count = 4;
+  SPIOutput output(m_uid, &backend, options);
+  output.SetPersonality(SPIOutput::PERS_LDP8806_INDIVIDUAL);
+
+  DmxBuffer buffer;
+  unsigned int length = 0;
+  const uint8_t *data = NULL;
+
+  buffer.SetRangeToValue(0, 2, 12);
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED0[] = { 0x81, 0x81, 0x81, 0x81, 0x81, 0x81,
+                                0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED0, arraysize(EXPECTED0), data, length);
+  OLA_ASSERT_EQ(1u, backend.Writes(0));
+
+  // Mark the first and last pixels in the backend. If they're encoded again
+  // the marks are overwritten.
+  uint8_t *spi_data = backend.Checkout(0, 12, 1);
+  spi_data[0] = 0;
+  spi_data[9] = 0;
+
+  // Change the green slot of the second pixel.
+  buffer.SetChannel(4, 100);
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED1[] = { 0, 0x81, 0x81, 0xB2, 0x81, 0x81,
+                                0x81, 0x81, 0x81, 0, 0x81, 0x81, 0 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED1, arraysize(EXPECTED1), data, length);
+  OLA_ASSERT_EQ(2u, backend.Writes(0));
+
+  // An identical frame is still written, but nothing is encoded.
+  spi_data[4] = 0;
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED2[] = { 0, 0x81, 0x81, 0xB2, 0, 0x81,
+                                0x81, 0x81, 0x81, 0, 0x81, 0x81, 0 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED2, arraysize(EXPECTED2), data, length);
+  OLA_ASSERT_EQ(3u, backend.Writes(0));
+}
+
+
+/**
+ * Check the whole string is encoded after the start address changes, even if
+ * the DMX data is the same.
+ */
+void SPIOutputTest::testStartAddressChange() {
+  FakeSPIBackend backend(1);
+  SPIOutput::Options options(0, "Test SPI Device");
+  options.pixel_count = 4;
+  SPIOutput output(m_uid, &backend, options);
+  output.SetPersonality(SPIOutput::PERS_LDP8806_INDIVIDUAL);
+
+  DmxBuffer buffer;
+  unsigned int length = 0;
+  const uint8_t *data = NULL;
+
+  buffer.SetFromString("2,4,6,8,10,12,14,16,18,20,22,24,26,28,30");
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED0[] = { 0x82, 0x81, 0x83, 0x85, 0x84, 0x86,
+                                0x88, 0x87, 0x89, 0x8B, 0x8A, 0x8C, 0 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED0, arraysize(EXPECTED0), data, length);
+
+  output.SetStartAddress(4);
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED1[] = { 0x85, 0x84, 0x86, 0x88, 0x87, 0x89,
+                                0x8B, 0x8A, 0x8C, 0x8E, 0x8D, 0x8F, 0 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED1, arraysize(EXPECTED1), data, length);
+
+  // Changes after the new start address are encoded as usual.
+  buffer.SetChannel(14, 60);
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED2[] = { 0x85, 0x84, 0x86, 0x88, 0x87, 0x89,
+                                0x8B, 0x8A, 0x8C, 0x8E, 0x8D, 0x9E, 0 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED2, arraysize(EXPECTED2), data, length);
+
+  output.SetStartAddress(1);
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  OLA_ASSERT_DATA_EQUALS(EXPECTED0, arraysize(EXPECTED0), data, length);
+  OLA_ASSERT_EQ(4u, backend.Writes(0));
+}
+
+
+/**
+ * Check a shorter frame after a longer one, and the longer frame again.
+ */
+void SPIOutputTest::testShorterFrame() {
+  FakeSPIBackend backend(1);
+  SPIOutput::Options options(0, "Test SPI Device");
+  options.pixel_count = 4;
+  SPIOutput output(m_uid, &backend, options);
+  output.SetPersonality(SPIOutput::PERS_APA102_INDIVIDUAL);
+
+  DmxBuffer long_frame;
+  unsigned int length = 0;
+  const uint8_t *data = NULL;
+
+  long_frame.SetFromString("1,2,3,4,5,6,7,8,9,10,11,12");
+  output.WriteDMX(long_frame);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED0[] = { 0, 0, 0, 0,
+                                0xFF, 3, 2, 1,
+                                0xFF, 6, 5, 4,
+                                0xFF, 9, 8, 7,
+                                0xFF, 12, 11, 10,
+                                0};
+  OLA_ASSERT_DATA_EQUALS(EXPECTED0, arraysize(EXPECTED0), data, length);
+
+  // The pixel following the data keeps its color, the ones after it are set
+  // to black.
+  DmxBuffer short_frame;
+  short_frame.SetFromString("20,21,22");
+  output.WriteDMX(short_frame);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED1[] = { 0, 0, 0, 0,
+                                0xFF, 22, 21, 20,
+                                0xFF, 6, 5, 4,
+                                0xFF, 0, 0, 0,
+                                0xFF, 0, 0, 0,
+                                0};
+  OLA_ASSERT_DATA_EQUALS(EXPECTED1, arraysize(EXPECTED1), data, length);
+
+  // The same data as the first frame is encoded again.
+  output.WriteDMX(long_frame);
+  data = backend.GetData(0, &length);
+  OLA_ASSERT_DATA_EQUALS(EXPECTED0, arraysize(EXPECTED0), data, length);
+  OLA_ASSERT_EQ(3u, backend.Writes(0));
+}
+
+
+/**
+ * Check the whole string is encoded after the personality changes, even if
+ * the DMX data is the same.
+ */
+void SPIOutputTest::testPersonalityChange() {
+  FakeSPIBackend backend(1);
+  SPIOutput::Options options(0, "Test SPI Device");
+  options.pixel_count = 2;
+  SPIOutput output(m_uid, &backend, options);
+  output.SetPersonality(SPIOutput::PERS_LDP8806_INDIVIDUAL);
+
+  DmxBuffer buffer;
+  unsigned int length = 0;
+  const uint8_t *data = NULL;
+
+  buffer.SetFromString("255,128,0,10,20,30");
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED0[] = { 0xC0, 0xFF, 0x80, 0x8A, 0x85, 0x8F, 0 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED0, arraysize(EXPECTED0), data, length);
+
+  output.SetPersonality(SPIOutput::PERS_WS2801_INDIVIDUAL);
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED1[] = { 255, 128, 0, 10, 20, 30 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED1, arraysize(EXPECTED1), data, length);
+
+  output.SetPersonality(SPIOutput::PERS_P9813_INDIVIDUAL);
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED2[] = { 0, 0, 0, 0, 0xF4, 0, 0x80, 0xFF,
+                                0xFF, 0x1E, 0x14, 0x0A, 0, 0, 0, 0, 0, 0, 0, 0};
+  OLA_ASSERT_DATA_EQUALS(EXPECTED2, arraysize(EXPECTED2), data, length);
+
+  output.SetPersonality(SPIOutput::PERS_LDP8806_INDIVIDUAL);
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  OLA_ASSERT_DATA_EQUALS(EXPECTED0, arraysize(EXPECTED0), data, length);
+  OLA_ASSERT_EQ(4u, backend.Writes(0));
+}
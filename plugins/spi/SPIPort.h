@@ -47,6 +47,7 @@ class SPIOutputPort: public BasicOutputPort {
 
   std::string Description() const;
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
+  bool SupportsThreadedOutput() const { return true; }
 
   void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
   void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
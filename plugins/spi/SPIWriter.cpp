@@ -26,6 +26,7 @@
 #include <string.h>
 #include <sys/ioctl.h>
 
+#include <algorithm>
 #include <numeric>
 #include <sstream>
 #include <string>
@@ -38,11 +39,13 @@ namespace ola {
 namespace plugin {
 namespace spi {
 
+using ola::io::IOVec;
 using ola::thread::MutexLocker;
 using std::string;
 
 const uint8_t SPIWriter::SPI_BITS_PER_WORD = 8;
 const uint8_t SPIWriter::SPI_MODE = 0;
+const unsigned int SPIWriter::MAX_TRANSFERS_PER_MESSAGE;
 const char SPIWriter::SPI_DEVICE_KEY[] = "device";
 const char SPIWriter::SPI_ERROR_VAR[] = "spi-write-errors";
 const char SPIWriter::SPI_WRITE_VAR[] = "spi-writes";
@@ -53,18 +56,16 @@ SPIWriter::SPIWriter(const string &spi_device,
     : m_device_path(spi_device),
       m_spi_speed(options.spi_speed),
       m_cs_enable_high(options.cs_enable_high),
-      m_fd(-1),
-      m_error_map_var(NULL),
-      m_write_map_var(NULL) {
+      m_fd(-1) {
   OLA_INFO << "Created SPI Writer " << spi_device << " with speed "
            << options.spi_speed << ", CE is " << m_cs_enable_high;
   if (export_map) {
-    m_error_map_var = export_map->GetUIntMapVar(SPI_ERROR_VAR,
-                                                SPI_DEVICE_KEY);
-    (*m_error_map_var)[m_device_path] = 0;
-    m_write_map_var = export_map->GetUIntMapVar(SPI_WRITE_VAR,
-                                                SPI_DEVICE_KEY);
-    (*m_write_map_var)[m_device_path] = 0;
+    m_error_var = export_map->GetUIntMapVar(
+        SPI_ERROR_VAR, SPI_DEVICE_KEY)->GetHandle(m_device_path);
+    m_error_var.Set(0);
+    m_write_var = export_map->GetUIntMapVar(
+        SPI_WRITE_VAR, SPI_DEVICE_KEY)->GetHandle(m_device_path);
+    m_write_var.Set(0);
   }
 }
 
@@ -104,23 +105,36 @@ bool SPIWriter::Init() {
   return true;
 }
 
-bool SPIWriter::WriteSPIData(const uint8_t *data, unsigned int length) {
-  struct spi_ioc_transfer spi;
-  memset(&spi, 0, sizeof(spi));
-  spi.tx_buf = reinterpret_cast<__u64>(data);
-  spi.len = length;
+bool SPIWriter::WriteSPIData(const IOVec *segments,
+                             unsigned int segment_count) {
+  m_write_var.Increment();
 
-  if (m_write_map_var) {
-    (*m_write_map_var)[m_device_path]++;
-  }
+  // Each segment is a transfer, and the transfers in a message are sent
+  // without releasing chip select. The size of the message is encoded in the
+  // ioctl request, so long chains are split over several messages.
+  struct spi_ioc_transfer transfers[MAX_TRANSFERS_PER_MESSAGE];
+  unsigned int offset = 0;
+  while (offset < segment_count) {
+    const unsigned int count = std::min(segment_count - offset,
+                                        MAX_TRANSFERS_PER_MESSAGE);
+    memset(transfers, 0, count * sizeof(transfers[0]));
+    int length = 0;
+    for (unsigned int i = 0; i < count; i++) {
+      transfers[i].tx_buf = reinterpret_cast<__u64>(
+          segments[offset + i].iov_base);
+      transfers[i].len = segments[offset + i].iov_len;
+      length += segments[offset + i].iov_len;
+    }
 
-  int bytes_written = ioctl(m_fd, SPI_IOC_MESSAGE(1), &spi);
-  if (bytes_written != static_cast<int>(length)) {
-    OLA_WARN << "Failed to write all the SPI data: " << strerror(errno);
-    if (m_error_map_var) {
-      (*m_error_map_var)[m_device_path]++;
+    int bytes_written = ioctl(
+        m_fd, _IOC(_IOC_WRITE, SPI_IOC_MAGIC, 0, count * sizeof(transfers[0])),
+        transfers);
+    if (bytes_written != length) {
+      OLA_WARN << "Failed to write all the SPI data: " << strerror(errno);
+      m_error_var.Increment();
+      return false;
     }
-    return false;
+    offset += count;
   }
   return true;
 }
@@ -22,6 +22,7 @@
 #define PLUGINS_SPI_SPIWRITER_H_
 
 #include <ola/ExportMap.h>
+#include <ola/io/IOVecInterface.h>
 #include <ola/thread/Mutex.h>
 #include <stdint.h>
 #include <string>
@@ -39,7 +40,16 @@ class SPIWriterInterface {
 
   virtual std::string DevicePath() const = 0;
   virtual bool Init() = 0;
-  virtual bool WriteSPIData(const uint8_t *data, unsigned int length) = 0;
+
+  /**
+   * @brief Write data to the SPI device.
+   * @param segments the data to write. The segments are sent back to back,
+   *   as a single message where possible.
+   * @param segment_count the number of segments.
+   * @returns true if all the data was written.
+   */
+  virtual bool WriteSPIData(const ola::io::IOVec *segments,
+                            unsigned int segment_count) = 0;
 };
 
 /**
@@ -69,18 +79,20 @@ class SPIWriter : public SPIWriterInterface {
    */
   bool Init();
 
-  bool WriteSPIData(const uint8_t *data, unsigned int length);
+  bool WriteSPIData(const ola::io::IOVec *segments,
+                    unsigned int segment_count);
 
  private:
   const std::string m_device_path;
   const uint32_t m_spi_speed;
   const bool m_cs_enable_high;
   int m_fd;
-  UIntMap *m_error_map_var;
-  UIntMap *m_write_map_var;
+  UIntMapHandle m_error_var;
+  UIntMapHandle m_write_var;
 
   static const uint8_t SPI_MODE;
   static const uint8_t SPI_BITS_PER_WORD;
+  static const unsigned int MAX_TRANSFERS_PER_MESSAGE = 64;
   static const char SPI_DEVICE_KEY[];
   static const char SPI_ERROR_VAR[];
   static const char SPI_WRITE_VAR[];
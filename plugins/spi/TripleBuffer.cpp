@@ -0,0 +1,133 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TripleBuffer.cpp
+ * Hands frames from the thread that builds them to the SPI writer thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <string.h>
+#include <algorithm>
+
+#include "ola/base/Array.h"
+#include "plugins/spi/TripleBuffer.h"
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+using ola::thread::MutexLocker;
+using std::max;
+using std::min;
+
+TripleBuffer::TripleBuffer()
+    : m_back(0),
+      m_committed(-1),
+      m_back_current(false),
+      m_front(2),
+      m_middle(1) {
+  for (unsigned int i = 0; i < arraysize(m_frames); i++) {
+    m_frames[i].data = NULL;
+    m_frames[i].size = 0;
+    m_frames[i].capacity = 0;
+    m_frames[i].latch_bytes = 0;
+  }
+}
+
+TripleBuffer::~TripleBuffer() {
+  for (unsigned int i = 0; i < arraysize(m_frames); i++) {
+    delete[] m_frames[i].data;
+  }
+}
+
+uint8_t *TripleBuffer::Checkout(unsigned int length,
+                                unsigned int latch_bytes) {
+  Frame *frame = &m_frames[m_back];
+
+  // The back frame is stale after a Commit(), so bring it up to date from
+  // the frame we committed. The consumer may be reading that frame as well,
+  // but no one writes to it until it comes back around.
+  const Frame *source = NULL;
+  if (m_back_current) {
+    source = frame;
+  } else if (m_committed >= 0) {
+    source = &m_frames[m_committed];
+  }
+  const unsigned int keep = source ? min(length, source->size) : 0;
+
+  if (!frame->data || length > frame->capacity) {
+    const unsigned int capacity = max(length, 1u);
+    uint8_t *data = new uint8_t[capacity];
+    if (keep) {
+      memcpy(data, source->data, keep);
+    }
+    delete[] frame->data;
+    frame->data = data;
+    frame->capacity = capacity;
+  } else if (keep && source != frame) {
+    memcpy(frame->data, source->data, keep);
+  }
+  memset(frame->data + keep, 0, length - keep);
+
+  frame->size = length;
+  frame->latch_bytes = latch_bytes;
+  m_back_current = true;
+  return frame->data;
+}
+
+bool TripleBuffer::Commit() {
+  const uint32_t old_middle = ExchangeMiddle(m_back | FRESH_FRAME);
+  m_committed = m_back;
+  m_back = old_middle & INDEX_MASK;
+  m_back_current = false;
+  return old_middle & FRESH_FRAME;
+}
+
+bool TripleBuffer::Acquire() {
+  // Only the consumer clears FRESH_FRAME, so it can't go away between the
+  // load and the exchange.
+  if (!(LoadMiddle() & FRESH_FRAME)) {
+    return false;
+  }
+  m_front = ExchangeMiddle(m_front) & INDEX_MASK;
+  return true;
+}
+
+uint32_t TripleBuffer::LoadMiddle() {
+#ifdef HAVE_ATOMIC_BUILTINS
+  return __atomic_load_n(&m_middle, __ATOMIC_RELAXED);
+#else
+  MutexLocker lock(&m_mutex);
+  return m_middle;
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+
+uint32_t TripleBuffer::ExchangeMiddle(uint32_t value) {
+#ifdef HAVE_ATOMIC_BUILTINS
+  return __atomic_exchange_n(&m_middle, value, __ATOMIC_ACQ_REL);
+#else
+  MutexLocker lock(&m_mutex);
+  const uint32_t old_value = m_middle;
+  m_middle = value;
+  return old_value;
+#endif  // HAVE_ATOMIC_BUILTINS
+}
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
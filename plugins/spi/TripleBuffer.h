@@ -0,0 +1,115 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TripleBuffer.h
+ * Hands frames from the thread that builds them to the SPI writer thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_SPI_TRIPLEBUFFER_H_
+#define PLUGINS_SPI_TRIPLEBUFFER_H_
+
+#include <stdint.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/Mutex.h>
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+/**
+ * @brief A triple buffer for the frames sent to a SPI output.
+ *
+ * There is a single producer, which calls Checkout() & Commit(), and a single
+ * consumer, which calls Acquire() and then reads the front frame. The frames
+ * are swapped with an atomic exchange so neither side ever waits for the
+ * other, and the consumer reads the frame in place.
+ *
+ * The frame returned by Checkout() always holds the data from the last
+ * Commit(), so the producer only needs to update what changed.
+ */
+class TripleBuffer {
+ public:
+  TripleBuffer();
+  ~TripleBuffer();
+
+  /**
+   * @brief Get the frame to update.
+   * @param length the size of the frame.
+   * @param latch_bytes the number of zero bytes to send after the frame.
+   * @returns the frame data. If the frame grew the new bytes are 0.
+   */
+  uint8_t *Checkout(unsigned int length, unsigned int latch_bytes);
+
+  /**
+   * @brief Make the checked out frame available to the consumer.
+   * @returns true if this replaced a frame the consumer hadn't acquired.
+   */
+  bool Commit();
+
+  /**
+   * @brief Make the last committed frame the front frame.
+   * @returns true if there was a new frame, false if the front frame is
+   *   unchanged.
+   */
+  bool Acquire();
+
+  /**
+   * @brief The data for the front frame.
+   */
+  const uint8_t *Data() const { return m_frames[m_front].data; }
+
+  /**
+   * @brief The size of the front frame, not including the latch bytes.
+   */
+  unsigned int Size() const { return m_frames[m_front].size; }
+
+  /**
+   * @brief The number of latch bytes for the front frame.
+   */
+  unsigned int LatchBytes() const { return m_frames[m_front].latch_bytes; }
+
+ private:
+  struct Frame {
+    uint8_t *data;
+    unsigned int size;
+    unsigned int capacity;
+    unsigned int latch_bytes;
+  };
+
+  Frame m_frames[3];
+  // Owned by the producer.
+  unsigned int m_back;
+  int m_committed;
+  bool m_back_current;
+  // Owned by the consumer.
+  unsigned int m_front;
+  // Shared, the index of the middle frame and the FRESH_FRAME flag.
+  uint32_t m_middle;
+  // Only used if the atomic builtins aren't available.
+  ola::thread::Mutex m_mutex;
+
+  uint32_t LoadMiddle();
+  uint32_t ExchangeMiddle(uint32_t value);
+
+  static const uint32_t FRESH_FRAME = 0x4;
+  static const uint32_t INDEX_MASK = 0x3;
+
+  DISALLOW_COPY_AND_ASSIGN(TripleBuffer);
+};
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_SPI_TRIPLEBUFFER_H_
@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TripleBufferTest.cpp
+ * Test fixture for the TripleBuffer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "ola/testing/TestUtils.h"
+#include "plugins/spi/TripleBuffer.h"
+
+using ola::plugin::spi::TripleBuffer;
+
+class TripleBufferTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TripleBufferTest);
+  CPPUNIT_TEST(testHandoff);
+  CPPUNIT_TEST(testContentsKept);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testHandoff();
+  void testContentsKept();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TripleBufferTest);
+
+
+/*
+ * Check frames are passed from the producer to the consumer.
+ */
+void TripleBufferTest::testHandoff() {
+  TripleBuffer buffer;
+  OLA_ASSERT_FALSE(buffer.Acquire());
+  OLA_ASSERT_EQ(0u, buffer.Size());
+
+  uint8_t *data = buffer.Checkout(4, 2);
+  OLA_ASSERT_NOT_NULL(data);
+  memset(data, 1, 4);
+  OLA_ASSERT_FALSE(buffer.Commit());
+
+  OLA_ASSERT_TRUE(buffer.Acquire());
+  OLA_ASSERT_FALSE(buffer.Acquire());
+  const uint8_t expected1[] = {1, 1, 1, 1};
+  OLA_ASSERT_DATA_EQUALS(expected1, sizeof(expected1), buffer.Data(),
+                         buffer.Size());
+  OLA_ASSERT_EQ(2u, buffer.LatchBytes());
+
+  // A frame that isn't acquired is replaced by the next one.
+  memset(buffer.Checkout(4, 0), 2, 4);
+  OLA_ASSERT_FALSE(buffer.Commit());
+  memset(buffer.Checkout(4, 0), 3, 4);
+  OLA_ASSERT_TRUE(buffer.Commit());
+
+  // The consumer still has the old frame until it calls Acquire().
+  OLA_ASSERT_DATA_EQUALS(expected1, sizeof(expected1), buffer.Data(),
+                         buffer.Size());
+  OLA_ASSERT_TRUE(buffer.Acquire());
+  const uint8_t expected3[] = {3, 3, 3, 3};
+  OLA_ASSERT_DATA_EQUALS(expected3, sizeof(expected3), buffer.Data(),
+                         buffer.Size());
+  OLA_ASSERT_EQ(0u, buffer.LatchBytes());
+}
+
+
+/*
+ * Check each checkout starts with the last committed frame.
+ */
+void TripleBufferTest::testContentsKept() {
+  TripleBuffer buffer;
+  uint8_t *data = buffer.Checkout(6, 0);
+  const uint8_t zeros[] = {0, 0, 0, 0, 0, 0};
+  OLA_ASSERT_DATA_EQUALS(zeros, sizeof(zeros), data, 6);
+  for (unsigned int i = 0; i < 6; i++) {
+    data[i] = i + 1;
+  }
+  buffer.Commit();
+
+  // Update a single byte each time, the rest is carried over.
+  for (unsigned int i = 0; i < 6; i++) {
+    data = buffer.Checkout(6, 0);
+    data[i] = 0xff;
+    buffer.Commit();
+  }
+  OLA_ASSERT_TRUE(buffer.Acquire());
+  const uint8_t expected[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), buffer.Data(),
+                         buffer.Size());
+
+  // Shrink & then grow the frame, the new bytes are 0.
+  data = buffer.Checkout(2, 0);
+  buffer.Commit();
+  data = buffer.Checkout(4, 0);
+  const uint8_t expected2[] = {0xff, 0xff, 0, 0};
+  OLA_ASSERT_DATA_EQUALS(expected2, sizeof(expected2), data, 4);
+  buffer.Commit();
+
+  // Checking out twice keeps what was written.
+  data = buffer.Checkout(4, 0);
+  data[3] = 7;
+  data = buffer.Checkout(8, 0);
+  const uint8_t expected3[] = {0xff, 0xff, 0, 7, 0, 0, 0, 0};
+  OLA_ASSERT_DATA_EQUALS(expected3, sizeof(expected3), data, 8);
+  buffer.Commit();
+  OLA_ASSERT_TRUE(buffer.Acquire());
+  OLA_ASSERT_DATA_EQUALS(expected3, sizeof(expected3), buffer.Data(),
+                         buffer.Size());
+}
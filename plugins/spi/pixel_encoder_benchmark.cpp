@@ -0,0 +1,139 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * pixel_encoder_benchmark.cpp
+ * Compare the pixel encoding kernels for each of the SPI pixel formats, and
+ * the cost of a color correction.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/dmx/ColorCorrection.h"
+#include "ola/Clock.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "plugins/spi/PixelEncoder.h"
+
+using ola::Clock;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::dmx::ColorCorrection;
+using ola::plugin::spi::PixelEncoder;
+using ola::plugin::spi::pixel_format;
+using ola::plugin::spi::pixel_kernel;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(iterations, i, 100000, "The number of strings to encode");
+
+/**
+ * Print the result of a run.
+ */
+void PrintResult(const string &name, unsigned int pixel_count,
+                 const TimeInterval &duration) {
+  double total_usec = static_cast<double>(duration.AsInt());
+  double ns_per_string = total_usec * 1000.0 / FLAGS_iterations;
+  cout << std::left << std::setw(24) << name << std::right << std::fixed
+       << std::setprecision(1) << std::setw(10) << ns_per_string
+       << " ns/string " << std::setw(8) << std::setprecision(2)
+       << ns_per_string / pixel_count << " ns/pixel" << endl;
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "", "Benchmark the SPI pixel encoders.");
+
+  if (FLAGS_iterations == 0) {
+    return -1;
+  }
+
+  const pixel_format formats[] = {
+    ola::plugin::spi::PIXEL_WS2801,
+    ola::plugin::spi::PIXEL_LPD8806,
+    ola::plugin::spi::PIXEL_P9813,
+    ola::plugin::spi::PIXEL_APA102,
+    ola::plugin::spi::PIXEL_APA102_PB,
+  };
+  const pixel_kernel kernels[] = {
+    ola::plugin::spi::PIXEL_KERNEL_SCALAR,
+    ola::plugin::spi::PIXEL_KERNEL_SSSE3,
+    ola::plugin::spi::PIXEL_KERNEL_NEON,
+  };
+  // A universe worth of RGB pixels, and a long string which would be fed
+  // from several universes.
+  const unsigned int pixel_counts[] = {170, 1000};
+
+  const ColorCorrection correction(2.2, 255, 200, 180);
+
+  cout << FLAGS_iterations << " strings, active kernel: "
+       << PixelEncoder::KernelName(PixelEncoder::ActiveKernel()) << endl;
+
+  Clock clock;
+  TimeStamp start, end;
+  for (unsigned int p = 0; p < sizeof(pixel_counts) / sizeof(pixel_counts[0]);
+       p++) {
+    const unsigned int pixel_count = pixel_counts[p];
+    vector<uint8_t> slots(pixel_count * 4);
+    for (unsigned int i = 0; i < slots.size(); i++) {
+      slots[i] = static_cast<uint8_t>(i * 7);
+    }
+    vector<uint8_t> output(pixel_count * 4);
+
+    cout << endl << pixel_count << " pixels" << endl;
+    for (unsigned int f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+      for (unsigned int k = 0; k < sizeof(kernels) / sizeof(kernels[0]);
+           k++) {
+        if (!PixelEncoder::KernelSupported(kernels[k])) {
+          continue;
+        }
+        PixelEncoder encoder(formats[f], kernels[k]);
+        clock.CurrentMonotonicTime(&start);
+        for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+          encoder.Encode(&slots[0], pixel_count, &output[0]);
+        }
+        clock.CurrentMonotonicTime(&end);
+        PrintResult(PixelEncoder::FormatName(formats[f]) + " " +
+                    PixelEncoder::KernelName(kernels[k]),
+                    pixel_count, end - start);
+      }
+
+      // With gamma & white balance correction
+      PixelEncoder encoder(formats[f]);
+      encoder.SetCorrection(correction);
+      clock.CurrentMonotonicTime(&start);
+      for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+        encoder.Encode(&slots[0], pixel_count, &output[0]);
+      }
+      clock.CurrentMonotonicTime(&end);
+      PrintResult(PixelEncoder::FormatName(formats[f]) + " corrected",
+                  pixel_count, end - start);
+    }
+
+    // The correction on its own, as used for Open Pixel Control.
+    clock.CurrentMonotonicTime(&start);
+    for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+      correction.Apply(&slots[0], pixel_count * 3, &output[0]);
+    }
+    clock.CurrentMonotonicTime(&end);
+    PrintResult("RGB correction only", pixel_count, end - start);
+  }
+  return 0;
+}
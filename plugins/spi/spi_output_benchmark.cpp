@@ -0,0 +1,205 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * spi_output_benchmark.cpp
+ * Measure the SPI pixel encoding throughput with 0 to 8 output workers.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/rdm/UID.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/thread/Future.h"
+#include "olad/Preferences.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/OutputWorkerPool.h"
+#include "olad/plugin_api/UniverseStore.h"
+#include "plugins/spi/SPIBackend.h"
+#include "plugins/spi/SPIOutput.h"
+#include "plugins/spi/SPIPort.h"
+
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::OutputWorkerPool;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::Universe;
+using ola::plugin::spi::FakeSPIBackend;
+using ola::plugin::spi::SPIOutput;
+using ola::plugin::spi::SPIOutputPort;
+using ola::rdm::UID;
+using ola::thread::Future;
+using std::auto_ptr;
+using std::cout;
+using std::endl;
+using std::vector;
+
+DEFINE_s_uint32(frames, f, 2000, "The number of frames to send per output");
+DEFINE_s_uint8(outputs, o, 16, "The number of SPI outputs");
+DEFINE_s_uint8(pixels, p, 170, "The number of pixels per output");
+DEFINE_s_uint16(personality, s, SPIOutput::PERS_APA102_INDIVIDUAL,
+                "The SPI personality to use");
+
+void SetFuture(Future<void> f) {
+  f.Set();
+}
+
+/**
+ * Block until all the workers have finished their pending writes.
+ */
+void WaitForWorkers(const OutputWorkerPool *pool) {
+  vector<Future<void> > futures;
+  for (unsigned int i = 0; i < pool->WorkerCount(); i++) {
+    Future<void> f;
+    pool->WorkerFor(i)->Execute(ola::NewSingleCallback(SetFuture, f));
+    futures.push_back(f);
+  }
+  vector<Future<void> >::iterator iter = futures.begin();
+  for (; iter != futures.end(); ++iter) {
+    iter->Get();
+  }
+}
+
+/**
+ * Count the frames committed to the backend.
+ */
+unsigned int BackendWrites(const FakeSPIBackend &backend) {
+  unsigned int writes = 0;
+  for (unsigned int i = 0; i < FLAGS_outputs; i++) {
+    writes += backend.Writes(i);
+  }
+  return writes;
+}
+
+/**
+ * Send FLAGS_frames frames to each output and return the number of frames
+ * that were encoded.
+ *
+ * Every slot changes on every frame, so the individual personalities have to
+ * encode the whole string each time.
+ */
+unsigned int RunOutput(ola::UniverseStore *store,
+                       const vector<Universe*> &universes,
+                       const FakeSPIBackend &backend,
+                       unsigned int worker_count,
+                       TimeInterval *duration) {
+  auto_ptr<OutputWorkerPool> pool;
+  if (worker_count) {
+    pool.reset(new OutputWorkerPool(worker_count));
+    if (!pool->Start()) {
+      return 0;
+    }
+    store->SetOutputWorkerPool(pool.get());
+  }
+
+  const unsigned int initial_writes = BackendWrites(backend);
+
+  Clock clock;
+  TimeStamp start, end;
+  clock.CurrentMonotonicTime(&start);
+
+  DmxBuffer buffer;
+  for (unsigned int i = 0; i < FLAGS_frames; i++) {
+    buffer.SetRangeToValue(0, static_cast<uint8_t>(i), ola::DMX_UNIVERSE_SIZE);
+    vector<Universe*>::const_iterator iter = universes.begin();
+    for (; iter != universes.end(); ++iter) {
+      (*iter)->SetDMX(buffer);
+    }
+    if (pool.get()) {
+      WaitForWorkers(pool.get());
+    }
+  }
+  clock.CurrentMonotonicTime(&end);
+  *duration = end - start;
+
+  store->SetOutputWorkerPool(NULL);
+  return BackendWrites(backend) - initial_writes;
+}
+
+/**
+ * Print the result of a run.
+ */
+void PrintResult(unsigned int worker_count, unsigned int frames,
+                 const TimeInterval &duration) {
+  std::ostringstream name;
+  name << worker_count << " workers";
+  double seconds = static_cast<double>(duration.AsInt()) / 1000000.0;
+  cout << std::left << std::setw(12) << name.str() << std::right
+       << std::fixed << std::setprecision(0) << std::setw(12)
+       << (seconds > 0 ? frames / seconds : 0) << " frames/s" << endl;
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Benchmark encoding SPI pixel data from output workers.");
+
+  if (FLAGS_outputs == 0 || FLAGS_frames == 0 || FLAGS_pixels == 0) {
+    return -1;
+  }
+
+  ola::MemoryPreferences preferences("benchmark");
+  ola::UniverseStore store(&preferences, NULL);
+  FakeSPIBackend backend(FLAGS_outputs);
+
+  vector<Universe*> universes;
+  vector<SPIOutputPort*> ports;
+  for (uint8_t i = 0; i < FLAGS_outputs; i++) {
+    SPIOutput::Options options(i, "benchmark");
+    options.pixel_count = FLAGS_pixels;
+    SPIOutputPort *port = new SPIOutputPort(NULL, &backend, UID(0x7a70, i),
+                                            options);
+    if (!port->SetPersonality(FLAGS_personality)) {
+      cout << "Invalid personality " << FLAGS_personality << endl;
+      delete port;
+      ola::STLDeleteElements(&ports);
+      return -1;
+    }
+    Universe *universe = store.GetUniverseOrCreate(i + 1);
+    universe->AddPort(port);
+    universes.push_back(universe);
+    ports.push_back(port);
+  }
+
+  cout << static_cast<int>(FLAGS_outputs) << " outputs of "
+       << static_cast<int>(FLAGS_pixels) << " pixels, " << FLAGS_frames
+       << " frames per output, " << ports[0]->Description() << endl;
+
+  const unsigned int worker_counts[] = {0, 1, 2, 4, 8};
+  for (unsigned int i = 0; i < sizeof(worker_counts) / sizeof(unsigned int);
+       i++) {
+    TimeInterval duration;
+    unsigned int frames = RunOutput(&store, universes, backend,
+                                    worker_counts[i], &duration);
+    PrintResult(worker_counts[i], frames, duration);
+  }
+
+  for (unsigned int i = 0; i < universes.size(); i++) {
+    universes[i]->RemovePort(ports[i]);
+  }
+  store.DeleteAll();
+  ola::STLDeleteElements(&ports);
+  return 0;
+}
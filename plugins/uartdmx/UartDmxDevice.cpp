@@ -34,18 +34,22 @@ using std::string;
 
 const char UartDmxDevice::K_MALF[] = "-malf";
 const char UartDmxDevice::K_BREAK[] = "-break";
+const char UartDmxDevice::K_FREQUENCY[] = "-frequency";
 const unsigned int UartDmxDevice::DEFAULT_BREAK = 100;
 const unsigned int UartDmxDevice::DEFAULT_MALF = 100;
+const unsigned int UartDmxDevice::DEFAULT_FREQUENCY = 0;
 
 
 UartDmxDevice::UartDmxDevice(AbstractPlugin *owner,
                              class Preferences *preferences,
                              const string &name,
-                             const string &path)
+                             const string &path,
+                             ola::dmx::DmxFrameScheduler *scheduler)
     : Device(owner, name),
       m_preferences(preferences),
       m_name(name),
-      m_path(path) {
+      m_path(path),
+      m_scheduler(scheduler) {
   // set up some per-device default configuration if not already set
   SetDefaults();
   // now read per-device configuration
@@ -57,6 +61,11 @@ UartDmxDevice::UartDmxDevice(AbstractPlugin *owner,
   if (!StringToInt(m_preferences->GetValue(DeviceMalfKey()), &m_malft)) {
     m_malft = DEFAULT_MALF;
   }
+  // Frames per second, 0 sends frames back to back
+  if (!StringToInt(m_preferences->GetValue(DeviceFrequencyKey()),
+                   &m_frequency)) {
+    m_frequency = DEFAULT_FREQUENCY;
+  }
   m_widget.reset(new UartWidget(path));
 }
 
@@ -67,7 +76,12 @@ UartDmxDevice::~UartDmxDevice() {
 }
 
 bool UartDmxDevice::StartHook() {
-  AddPort(new UartDmxOutputPort(this, 0, m_widget.get(), m_breakt, m_malft));
+  ola::dmx::DmxFrameScheduler::OutputOptions options;
+  options.break_time = m_breakt;
+  options.mark_after_frame = m_malft;
+  options.frame_rate = m_frequency;
+  AddPort(new UartDmxOutputPort(this, 0, m_widget.get(), m_scheduler,
+                                options));
   return true;
 }
 
@@ -77,6 +91,9 @@ string UartDmxDevice::DeviceMalfKey() const {
 string UartDmxDevice::DeviceBreakKey() const {
   return m_path + K_BREAK;
 }
+string UartDmxDevice::DeviceFrequencyKey() const {
+  return m_path + K_FREQUENCY;
+}
 
 /**
  * Set the default preferences for this one Device
@@ -94,6 +111,9 @@ void UartDmxDevice::SetDefaults() {
   save |= m_preferences->SetDefaultValue(DeviceMalfKey(),
                                          UIntValidator(8, 1000000),
                                          DEFAULT_MALF);
+  save |= m_preferences->SetDefaultValue(DeviceFrequencyKey(),
+                                         UIntValidator(0, 44),
+                                         DEFAULT_FREQUENCY);
   if (save) {
     m_preferences->Save();
   }
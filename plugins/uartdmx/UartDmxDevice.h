@@ -25,6 +25,7 @@
 #include <string>
 #include <sstream>
 #include <memory>
+#include "common/dmx/DmxFrameScheduler.h"
 #include "ola/DmxBuffer.h"
 #include "olad/Device.h"
 #include "olad/Preferences.h"
@@ -39,7 +40,8 @@ class UartDmxDevice : public Device {
   UartDmxDevice(AbstractPlugin *owner,
                 class Preferences *preferences,
                 const std::string &name,
-                const std::string &path);
+                const std::string &path,
+                ola::dmx::DmxFrameScheduler *scheduler);
   ~UartDmxDevice();
 
   std::string DeviceId() const { return m_path; }
@@ -52,19 +54,24 @@ class UartDmxDevice : public Device {
   // Per device options
   std::string DeviceBreakKey() const;
   std::string DeviceMalfKey() const;
+  std::string DeviceFrequencyKey() const;
   void SetDefaults();
 
   std::auto_ptr<UartWidget> m_widget;
   class Preferences *m_preferences;
   const std::string m_name;
   const std::string m_path;
+  ola::dmx::DmxFrameScheduler *m_scheduler;
   unsigned int m_breakt;
   unsigned int m_malft;
+  unsigned int m_frequency;
 
   static const unsigned int DEFAULT_MALF;
   static const char K_MALF[];
   static const unsigned int DEFAULT_BREAK;
   static const char K_BREAK[];
+  static const unsigned int DEFAULT_FREQUENCY;
+  static const char K_FREQUENCY[];
 
   DISALLOW_COPY_AND_ASSIGN(UartDmxDevice);
 };
@@ -46,12 +46,28 @@ const char UartDmxPlugin::PLUGIN_NAME[] = "UART native DMX";
 const char UartDmxPlugin::PLUGIN_PREFIX[] = "uartdmx";
 const char UartDmxPlugin::K_DEVICE[] = "device";
 const char UartDmxPlugin::DEFAULT_DEVICE[] = "/dev/ttyACM0";
+const char UartDmxPlugin::K_REALTIME_PRIORITY[] = "realtime-priority";
+const unsigned int UartDmxPlugin::DEFAULT_REALTIME_PRIORITY = 0;
 
 /*
  * Start the plug-in, using only the configured device(s) (we cannot sensibly
  * scan for UARTs!). Stolen from the opendmx plugin.
  */
 bool UartDmxPlugin::StartHook() {
+  // All the devices share a single thread for the DMX frame timing.
+  ola::dmx::DmxFrameScheduler::Options options;
+  if (!StringToInt(m_preferences->GetValue(K_REALTIME_PRIORITY),
+                   &options.realtime_priority)) {
+    options.realtime_priority = DEFAULT_REALTIME_PRIORITY;
+  }
+  m_scheduler.reset(new ola::dmx::DmxFrameScheduler(
+      options, m_plugin_adaptor->GetExportMap()));
+  if (!m_scheduler->Start()) {
+    OLA_WARN << "Failed to start the DMX frame scheduler";
+    m_scheduler.reset();
+    return false;
+  }
+
   vector<string> devices = m_preferences->GetMultipleValue(K_DEVICE);
   vector<string>::const_iterator iter;  // iterate over devices
 
@@ -75,7 +91,7 @@ bool UartDmxPlugin::StartHook() {
     // can open device, so shut the temporary file descriptor
     close(fd);
     std::auto_ptr<UartDmxDevice> device(new UartDmxDevice(
-        this, m_preferences, PLUGIN_NAME, *iter));
+        this, m_preferences, PLUGIN_NAME, *iter, m_scheduler.get()));
 
     // got a device, now lets see if we can configure it before we announce
     // it to the world
@@ -108,6 +124,11 @@ bool UartDmxPlugin::StopHook() {
     delete *iter;
   }
   m_devices.clear();
+
+  if (m_scheduler.get()) {
+    m_scheduler->Stop();
+    m_scheduler.reset();
+  }
   return true;
 }
 
@@ -131,6 +152,9 @@ bool UartDmxPlugin::SetDefaultPreferences() {
   // only insert default device name, no others at this stage
   bool save = m_preferences->SetDefaultValue(K_DEVICE, StringValidator(),
                                              DEFAULT_DEVICE);
+  save |= m_preferences->SetDefaultValue(K_REALTIME_PRIORITY,
+                                         UIntValidator(0, 99),
+                                         DEFAULT_REALTIME_PRIORITY);
   if (save) {
     m_preferences->Save();
   }
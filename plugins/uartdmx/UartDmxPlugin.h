@@ -22,10 +22,12 @@
 #ifndef PLUGINS_UARTDMX_UARTDMXPLUGIN_H_
 #define PLUGINS_UARTDMX_UARTDMXPLUGIN_H_
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "common/dmx/DmxFrameScheduler.h"
 #include "olad/Plugin.h"
 #include "ola/plugin_id.h"
 
@@ -52,6 +54,7 @@ class UartDmxPlugin : public Plugin {
  private:
   typedef std::vector<UartDmxDevice*> UartDeviceVector;
   UartDeviceVector m_devices;
+  std::auto_ptr<ola::dmx::DmxFrameScheduler> m_scheduler;
 
   void AddDevice(UartDmxDevice *device);
   bool StartHook();
@@ -64,6 +67,8 @@ class UartDmxPlugin : public Plugin {
   static const char PLUGIN_PREFIX[];
   static const char K_DEVICE[];
   static const char DEFAULT_DEVICE[];
+  static const char K_REALTIME_PRIORITY[];
+  static const unsigned int DEFAULT_REALTIME_PRIORITY;
 
   DISALLOW_COPY_AND_ASSIGN(UartDmxPlugin);
 };
@@ -24,12 +24,12 @@
 
 #include <string>
 
+#include "common/dmx/DmxFrameScheduler.h"
 #include "ola/DmxBuffer.h"
 #include "olad/Port.h"
 #include "olad/Preferences.h"
 #include "plugins/uartdmx/UartDmxDevice.h"
 #include "plugins/uartdmx/UartWidget.h"
-#include "plugins/uartdmx/UartDmxThread.h"
 
 namespace ola {
 namespace plugin {
@@ -40,24 +40,26 @@ class UartDmxOutputPort : public ola::BasicOutputPort {
   UartDmxOutputPort(UartDmxDevice *parent,
                     unsigned int id,
                     UartWidget *widget,
-                    unsigned int breakt,
-                    unsigned int malft)
+                    ola::dmx::DmxFrameScheduler *scheduler,
+                    const ola::dmx::DmxFrameScheduler::OutputOptions &options)
       : BasicOutputPort(parent, id),
         m_widget(widget),
-        m_thread(widget, breakt, malft) {
-    m_thread.Start();
+        m_scheduler(scheduler) {
+    m_scheduler->AddOutput(m_widget, options);
   }
-  ~UartDmxOutputPort() { m_thread.Stop(); }
+  ~UartDmxOutputPort() { m_scheduler->RemoveOutput(m_widget); }
 
   bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t) {
-    return m_thread.WriteDMX(buffer);
+    return m_scheduler->WriteDMX(m_widget, buffer);
   }
 
+  bool SupportsThreadedOutput() const { return true; }
+
   std::string Description() const { return m_widget->Description(); }
 
  private:
   UartWidget *m_widget;
-  UartDmxThread m_thread;
+  ola::dmx::DmxFrameScheduler *m_scheduler;
 
   DISALLOW_COPY_AND_ASSIGN(UartDmxOutputPort);
 };
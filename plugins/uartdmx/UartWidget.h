@@ -33,6 +33,7 @@
 
 #include <string>
 #include <vector>
+#include "common/dmx/DmxFrameScheduler.h"
 #include "ola/base/Macro.h"
 #include "ola/DmxBuffer.h"
 
@@ -43,7 +44,7 @@ namespace uartdmx {
 /**
  * An UART widget (i.e. a serial port with suitable hardware attached)
  */
-class UartWidget {
+class UartWidget : public ola::dmx::DmxSerialWriter {
  public:
     /**
      * Construct a new UartWidget instance for one widget.
@@ -118,7 +118,7 @@ bool SynchronousAVLdiyD512::SendDMX(const DmxBuffer &buffer) {
 class AVLdiyAsyncUsbSender : public AsyncUsbSender {
  public:
   AVLdiyAsyncUsbSender(LibUsbAdaptor *adaptor, libusb_device *usb_device)
-      : AsyncUsbSender(adaptor, usb_device) {
+      : AsyncUsbSender(adaptor, usb_device, PIPELINE_DEPTH) {
     m_control_setup_buffer =
         new uint8_t[LIBUSB_CONTROL_SETUP_SIZE + DMX_UNIVERSE_SIZE];
   }
@@ -118,7 +118,7 @@ bool SynchronousAnymauDMX::SendDMX(const DmxBuffer &buffer) {
 class AnymaAsyncUsbSender : public AsyncUsbSender {
  public:
   AnymaAsyncUsbSender(LibUsbAdaptor *adaptor, libusb_device *usb_device)
-      : AsyncUsbSender(adaptor, usb_device) {
+      : AsyncUsbSender(adaptor, usb_device, PIPELINE_DEPTH) {
     m_control_setup_buffer =
         new uint8_t[LIBUSB_CONTROL_SETUP_SIZE + DMX_UNIVERSE_SIZE];
   }
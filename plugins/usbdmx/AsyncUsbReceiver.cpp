@@ -62,9 +62,9 @@ bool AsyncUsbReceiver::Start() {
 }
 
 void AsyncUsbReceiver::TransferComplete(struct libusb_transfer *transfer) {
-  if (transfer != m_transfer) {
-    OLA_WARN << "Mismatched libusb transfer: " << transfer << " != "
-             << m_transfer;
+  ola::thread::MutexLocker locker(&m_mutex);
+  if (!TransferDone(transfer)) {
+    OLA_WARN << "Mismatched libusb transfer: " << transfer;
     return;
   }
 
@@ -73,10 +73,6 @@ void AsyncUsbReceiver::TransferComplete(struct libusb_transfer *transfer) {
     OLA_WARN << "Transfer returned " << transfer->status;
   }
 
-  ola::thread::MutexLocker locker(&m_mutex);
-  m_transfer_state = (transfer->status == LIBUSB_TRANSFER_NO_DEVICE ?
-      DISCONNECTED : IDLE);
-
   if (m_suppress_continuation) {
     return;
   }
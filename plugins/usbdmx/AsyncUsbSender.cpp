@@ -29,9 +29,12 @@ namespace usbdmx {
 
 using ola::usb::LibUsbAdaptor;
 
+const unsigned int AsyncUsbSender::PIPELINE_DEPTH;
+
 AsyncUsbSender::AsyncUsbSender(LibUsbAdaptor *adaptor,
-                               libusb_device *usb_device)
-    : AsyncUsbTransceiverBase(adaptor, usb_device),
+                               libusb_device *usb_device,
+                               unsigned int max_in_flight)
+    : AsyncUsbTransceiverBase(adaptor, usb_device, max_in_flight),
       m_pending_tx(false) {
 }
 
@@ -45,11 +48,11 @@ bool AsyncUsbSender::SendDMX(const DmxBuffer &buffer) {
     return false;
   }
   ola::thread::MutexLocker locker(&m_mutex);
-  if (m_transfer_state == IDLE) {
+  if (m_transfer_state != DISCONNECTED && CanSubmitTransfer()) {
     PerformTransfer(buffer);
   } else {
     // Buffer incoming data so we can send it when the outstanding transfers
-    // complete.
+    // complete. This replaces any frame that was already waiting.
     m_pending_tx = true;
     m_tx_buffer.Set(buffer);
   }
@@ -57,9 +60,9 @@ bool AsyncUsbSender::SendDMX(const DmxBuffer &buffer) {
 }
 
 void AsyncUsbSender::TransferComplete(struct libusb_transfer *transfer) {
-  if (transfer != m_transfer) {
-    OLA_WARN << "Mismatched libusb transfer: " << transfer << " != "
-             << m_transfer;
+  ola::thread::MutexLocker locker(&m_mutex);
+  if (!TransferDone(transfer)) {
+    OLA_WARN << "Mismatched libusb transfer: " << transfer;
     return;
   }
 
@@ -68,17 +71,14 @@ void AsyncUsbSender::TransferComplete(struct libusb_transfer *transfer) {
              << m_adaptor->ErrorCodeToString(transfer->status);
   }
 
-  ola::thread::MutexLocker locker(&m_mutex);
-  m_transfer_state = (transfer->status == LIBUSB_TRANSFER_NO_DEVICE ?
-      DISCONNECTED : IDLE);
-
   if (m_suppress_continuation) {
     return;
   }
 
   PostTransferHook();
 
-  if ((m_transfer_state == IDLE) && m_pending_tx) {
+  if (m_transfer_state != DISCONNECTED && m_pending_tx &&
+      CanSubmitTransfer()) {
     m_pending_tx = false;
     PerformTransfer(m_tx_buffer);
   }
@@ -38,6 +38,16 @@ namespace usbdmx {
  *
  * This encapsulates much of the asynchronous libusb logic. Subclasses should
  * implement the SetupHandle() and PerformTransfer() methods.
+ *
+ * Widgets which send each DMX frame as a single transfer should pass
+ * PIPELINE_DEPTH to the constructor. The next frame is then submitted while
+ * the current one is in flight, so the device always has a frame queued.
+ * Widgets which need several transfers per frame must use a depth of 1, since
+ * the transfers for one frame depend on each other.
+ *
+ * If the device can't keep up, frames which arrive while all the transfers are
+ * in flight are dropped, apart from the most recent one which is sent as soon
+ * as a transfer completes.
  */
 class AsyncUsbSender: public AsyncUsbTransceiverBase {
  public:
@@ -45,9 +55,11 @@ class AsyncUsbSender: public AsyncUsbTransceiverBase {
    * @brief Create a new AsyncUsbSender.
    * @param adaptor the LibUsbAdaptor to use.
    * @param usb_device the libusb_device to use for the widget.
+   * @param max_in_flight the maximum number of frames in flight at once.
    */
   AsyncUsbSender(ola::usb::LibUsbAdaptor* const adaptor,
-                 libusb_device *usb_device);
+                 libusb_device *usb_device,
+                 unsigned int max_in_flight = 1);
 
   /**
    * @brief Destructor
@@ -68,6 +80,12 @@ class AsyncUsbSender: public AsyncUsbTransceiverBase {
    */
   void TransferComplete(struct libusb_transfer *transfer);
 
+  /**
+   * @brief The number of frames to keep in flight for widgets that use a
+   *   single transfer per frame.
+   */
+  static const unsigned int PIPELINE_DEPTH = 2;
+
  protected:
   /**
    * @brief Perform the DMX transfer.
@@ -89,8 +107,9 @@ class AsyncUsbSender: public AsyncUsbTransceiverBase {
   virtual void PostTransferHook() {}
 
   /**
-   * @brief Check if there is a pending transfer.
-   * @returns true if there is a transfer in progress, false otherwise.
+   * @brief Check if there is a frame waiting to be sent.
+   * @returns true if there is a frame waiting for a transfer to complete,
+   *   false otherwise.
    */
   bool TransferPending() const { return m_pending_tx; }
 
@@ -0,0 +1,479 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * AsyncUsbSenderTest.cpp
+ * Test fixture for the transfer pipelining in AsyncUsbSender.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <libusb.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+
+#include "libs/usb/LibUsbAdaptor.h"
+#include "libs/usb/Types.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Thread.h"
+#include "plugins/usbdmx/AsyncUsbSender.h"
+
+using ola::DmxBuffer;
+using ola::plugin::usbdmx::AsyncUsbSender;
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using ola::usb::LibUsbAdaptor;
+using ola::usb::USBDeviceID;
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * A LibUsbAdaptor which records the transfers rather than sending them. The
+ * test completes the transfers by calling CompleteTransfer().
+ */
+class FakeLibUsbAdaptor : public LibUsbAdaptor {
+ public:
+  struct Submission {
+    struct libusb_transfer *transfer;
+    DmxBuffer data;
+  };
+
+  FakeLibUsbAdaptor()
+      : m_cancel_count(0) {
+  }
+
+  libusb_device* RefDevice(libusb_device *dev) { return dev; }
+  void UnrefDevice(libusb_device*) {}
+
+  bool OpenDevice(libusb_device*, libusb_device_handle **usb_handle) {
+    *usb_handle = reinterpret_cast<libusb_device_handle*>(&m_handle);
+    return true;
+  }
+
+  bool OpenDeviceAndClaimInterface(libusb_device *usb_device, int,
+                                   libusb_device_handle **usb_handle) {
+    return OpenDevice(usb_device, usb_handle);
+  }
+
+  void Close(libusb_device_handle*) {}
+  int SetConfiguration(libusb_device_handle*, int) { return 0; }
+  int ClaimInterface(libusb_device_handle*, int) { return 0; }
+  int DetachKernelDriver(libusb_device_handle*, int) { return 0; }
+
+  int GetDeviceDescriptor(libusb_device*, struct libusb_device_descriptor*) {
+    return LIBUSB_ERROR_NOT_SUPPORTED;
+  }
+
+  int GetActiveConfigDescriptor(libusb_device*,
+                                struct libusb_config_descriptor**) {
+    return LIBUSB_ERROR_NOT_SUPPORTED;
+  }
+
+  int GetConfigDescriptor(libusb_device*, uint8_t,
+                          struct libusb_config_descriptor**) {
+    return LIBUSB_ERROR_NOT_SUPPORTED;
+  }
+
+  void FreeConfigDescriptor(struct libusb_config_descriptor*) {}
+
+  bool GetStringDescriptor(libusb_device_handle*, uint8_t, string*) {
+    return false;
+  }
+
+  struct libusb_transfer* AllocTransfer(int) {
+    return static_cast<struct libusb_transfer*>(
+        calloc(1, sizeof(struct libusb_transfer)));
+  }
+
+  void FreeTransfer(struct libusb_transfer *transfer) { free(transfer); }
+
+  int SubmitTransfer(struct libusb_transfer *transfer) {
+    MutexLocker lock(&m_mutex);
+    Submission submission;
+    submission.transfer = transfer;
+    submission.data.Set(transfer->buffer, transfer->length);
+    m_submissions.push_back(submission);
+    return 0;
+  }
+
+  int CancelTransfer(struct libusb_transfer*) {
+    MutexLocker lock(&m_mutex);
+    m_cancel_count++;
+    return 0;
+  }
+
+  void FillControlSetup(unsigned char*, uint8_t, uint8_t, uint16_t, uint16_t,
+                        uint16_t) {
+  }
+
+  void FillControlTransfer(struct libusb_transfer*, libusb_device_handle*,
+                           unsigned char*, libusb_transfer_cb_fn, void*,
+                           unsigned int) {
+  }
+
+  void FillBulkTransfer(struct libusb_transfer *transfer,
+                        libusb_device_handle *dev_handle,
+                        unsigned char endpoint,
+                        unsigned char *buffer,
+                        int length,
+                        libusb_transfer_cb_fn callback,
+                        void *user_data,
+                        unsigned int timeout) {
+    transfer->dev_handle = dev_handle;
+    transfer->endpoint = endpoint;
+    transfer->buffer = buffer;
+    transfer->length = length;
+    transfer->callback = callback;
+    transfer->user_data = user_data;
+    transfer->timeout = timeout;
+  }
+
+  void FillInterruptTransfer(struct libusb_transfer*, libusb_device_handle*,
+                             unsigned char, unsigned char*, int,
+                             libusb_transfer_cb_fn, void*, unsigned int) {
+  }
+
+  int ControlTransfer(libusb_device_handle*, uint8_t, uint8_t, uint16_t,
+                      uint16_t, unsigned char*, uint16_t, unsigned int) {
+    return LIBUSB_ERROR_NOT_SUPPORTED;
+  }
+
+  int BulkTransfer(struct libusb_device_handle*, unsigned char,
+                   unsigned char*, int, int*, unsigned int) {
+    return LIBUSB_ERROR_NOT_SUPPORTED;
+  }
+
+  int InterruptTransfer(libusb_device_handle*, unsigned char, unsigned char*,
+                        int, int*, unsigned int) {
+    return LIBUSB_ERROR_NOT_SUPPORTED;
+  }
+
+  USBDeviceID GetDeviceId(libusb_device*) const {
+    return USBDeviceID(0, 0);
+  }
+
+  /*
+   * Run the libusb callback for a transfer, as the libusb thread would.
+   */
+  void CompleteTransfer(struct libusb_transfer *transfer,
+                        enum libusb_transfer_status status) {
+    transfer->status = status;
+    transfer->callback(transfer);
+  }
+
+  vector<Submission> Submissions() const {
+    MutexLocker lock(&m_mutex);
+    return m_submissions;
+  }
+
+  unsigned int CancelCount() const {
+    MutexLocker lock(&m_mutex);
+    return m_cancel_count;
+  }
+
+ private:
+  mutable Mutex m_mutex;
+  int m_handle;
+  vector<Submission> m_submissions;
+  unsigned int m_cancel_count;
+};
+
+
+/*
+ * Sends each frame as a single bulk transfer.
+ */
+class TestSender : public AsyncUsbSender {
+ public:
+  TestSender(LibUsbAdaptor *adaptor, unsigned int max_in_flight)
+      : AsyncUsbSender(adaptor, NULL, max_in_flight) {
+  }
+
+  void Cancel() { CancelTransfer(); }
+
+  // Submit a frame without checking if a transfer is free.
+  int ForceSubmit(const DmxBuffer &buffer) {
+    MutexLocker lock(&m_mutex);
+    unsigned int length = sizeof(m_frame);
+    buffer.Get(m_frame, &length);
+    FillBulkTransfer(ENDPOINT, m_frame, length, TIMEOUT);
+    return SubmitTransfer();
+  }
+
+  bool IsDisconnected() {
+    MutexLocker lock(&m_mutex);
+    return m_transfer_state == DISCONNECTED;
+  }
+
+ protected:
+  libusb_device_handle* SetupHandle() {
+    libusb_device_handle *handle = NULL;
+    m_adaptor->OpenDevice(m_usb_device, &handle);
+    return handle;
+  }
+
+  bool PerformTransfer(const DmxBuffer &buffer) {
+    // Reuse the same buffer for each frame, like the real widgets.
+    unsigned int length = sizeof(m_frame);
+    buffer.Get(m_frame, &length);
+    FillBulkTransfer(ENDPOINT, m_frame, length, TIMEOUT);
+    return SubmitTransfer() == 0;
+  }
+
+ private:
+  uint8_t m_frame[ola::DMX_UNIVERSE_SIZE];
+
+  static const unsigned char ENDPOINT = 2;
+  static const unsigned int TIMEOUT = 50;
+};
+
+
+/*
+ * Cancels the transfers from another thread, since CancelTransfer() blocks
+ * until they complete.
+ */
+class CancelThread : public ola::thread::Thread {
+ public:
+  explicit CancelThread(TestSender *sender)
+      : Thread(),
+        m_sender(sender),
+        m_done(false) {
+  }
+
+  bool Done() const {
+    MutexLocker lock(&m_mutex);
+    return m_done;
+  }
+
+ protected:
+  void *Run() {
+    m_sender->Cancel();
+    MutexLocker lock(&m_mutex);
+    m_done = true;
+    return NULL;
+  }
+
+ private:
+  TestSender *m_sender;
+  mutable Mutex m_mutex;
+  bool m_done;
+};
+}  // namespace
+
+
+class AsyncUsbSenderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(AsyncUsbSenderTest);
+  CPPUNIT_TEST(testPipelinedSend);
+  CPPUNIT_TEST(testHeldFrameReplaced);
+  CPPUNIT_TEST(testDisconnect);
+  CPPUNIT_TEST(testCancel);
+  CPPUNIT_TEST(testNoFreeTransfer);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testPipelinedSend();
+    void testHeldFrameReplaced();
+    void testDisconnect();
+    void testCancel();
+    void testNoFreeTransfer();
+
+ private:
+    FakeLibUsbAdaptor m_adaptor;
+
+    static DmxBuffer Frame(uint8_t value) {
+      DmxBuffer buffer;
+      buffer.SetRangeToValue(0, value, 4);
+      return buffer;
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AsyncUsbSenderTest);
+
+
+/*
+ * Check two frames can be in flight at once.
+ */
+void AsyncUsbSenderTest::testPipelinedSend() {
+  TestSender sender(&m_adaptor, AsyncUsbSender::PIPELINE_DEPTH);
+  OLA_ASSERT_TRUE(sender.Init());
+
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(1)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(2)));
+
+  // Both frames are submitted without waiting, on different transfers, and
+  // each kept its own data even though the sender reused its buffer.
+  vector<FakeLibUsbAdaptor::Submission> submissions = m_adaptor.Submissions();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), submissions.size());
+  OLA_ASSERT_NE(submissions[0].transfer, submissions[1].transfer);
+  OLA_ASSERT_EQ(Frame(1), submissions[0].data);
+  OLA_ASSERT_EQ(Frame(2), submissions[1].data);
+  OLA_ASSERT_EQ(Frame(1), DmxBuffer(submissions[0].transfer->buffer,
+                                    submissions[0].transfer->length));
+
+  // Nothing is waiting, so a completion doesn't submit anything.
+  m_adaptor.CompleteTransfer(submissions[0].transfer,
+                             LIBUSB_TRANSFER_COMPLETED);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_adaptor.Submissions().size());
+
+  // The next frame reuses the completed transfer.
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(3)));
+  submissions = m_adaptor.Submissions();
+  OLA_ASSERT_EQ(static_cast<size_t>(3), submissions.size());
+  OLA_ASSERT_EQ(submissions[0].transfer, submissions[2].transfer);
+  OLA_ASSERT_EQ(Frame(3), submissions[2].data);
+
+  m_adaptor.CompleteTransfer(submissions[1].transfer,
+                             LIBUSB_TRANSFER_COMPLETED);
+  m_adaptor.CompleteTransfer(submissions[2].transfer,
+                             LIBUSB_TRANSFER_COMPLETED);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_adaptor.Submissions().size());
+  OLA_ASSERT_FALSE(sender.IsDisconnected());
+}
+
+
+/*
+ * Check only the latest frame is held while both transfers are busy.
+ */
+void AsyncUsbSenderTest::testHeldFrameReplaced() {
+  TestSender sender(&m_adaptor, AsyncUsbSender::PIPELINE_DEPTH);
+  OLA_ASSERT_TRUE(sender.Init());
+
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(1)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(2)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(3)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(4)));
+
+  vector<FakeLibUsbAdaptor::Submission> submissions = m_adaptor.Submissions();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), submissions.size());
+
+  // The first completion sends the newest frame, the one in between is
+  // dropped.
+  m_adaptor.CompleteTransfer(submissions[0].transfer,
+                             LIBUSB_TRANSFER_COMPLETED);
+  submissions = m_adaptor.Submissions();
+  OLA_ASSERT_EQ(static_cast<size_t>(3), submissions.size());
+  OLA_ASSERT_EQ(submissions[0].transfer, submissions[2].transfer);
+  OLA_ASSERT_EQ(Frame(4), submissions[2].data);
+
+  // Nothing else is waiting.
+  m_adaptor.CompleteTransfer(submissions[1].transfer,
+                             LIBUSB_TRANSFER_COMPLETED);
+  m_adaptor.CompleteTransfer(submissions[2].transfer,
+                             LIBUSB_TRANSFER_COMPLETED);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_adaptor.Submissions().size());
+}
+
+
+/*
+ * Check the device is marked as disconnected if one of the two in-flight
+ * transfers fails with NO_DEVICE.
+ */
+void AsyncUsbSenderTest::testDisconnect() {
+  TestSender sender(&m_adaptor, AsyncUsbSender::PIPELINE_DEPTH);
+  OLA_ASSERT_TRUE(sender.Init());
+
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(1)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(2)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(3)));
+  vector<FakeLibUsbAdaptor::Submission> submissions = m_adaptor.Submissions();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), submissions.size());
+
+  m_adaptor.CompleteTransfer(submissions[0].transfer,
+                             LIBUSB_TRANSFER_NO_DEVICE);
+  OLA_ASSERT_TRUE(sender.IsDisconnected());
+  // The held frame isn't sent to a device that has gone.
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_adaptor.Submissions().size());
+
+  // The other transfer completing doesn't reset the state.
+  m_adaptor.CompleteTransfer(submissions[1].transfer,
+                             LIBUSB_TRANSFER_COMPLETED);
+  OLA_ASSERT_TRUE(sender.IsDisconnected());
+
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(4)));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_adaptor.Submissions().size());
+}
+
+
+/*
+ * Check CancelTransfer() waits for both in-flight transfers.
+ */
+void AsyncUsbSenderTest::testCancel() {
+  TestSender sender(&m_adaptor, AsyncUsbSender::PIPELINE_DEPTH);
+  OLA_ASSERT_TRUE(sender.Init());
+
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(1)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(2)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(3)));
+  vector<FakeLibUsbAdaptor::Submission> submissions = m_adaptor.Submissions();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), submissions.size());
+
+  CancelThread thread(&sender);
+  OLA_ASSERT_TRUE(thread.Start());
+  while (m_adaptor.CancelCount() < 2) {
+    usleep(1000);
+  }
+
+  // One transfer completing isn't enough.
+  m_adaptor.CompleteTransfer(submissions[0].transfer,
+                             LIBUSB_TRANSFER_CANCELLED);
+  usleep(20000);
+  OLA_ASSERT_FALSE(thread.Done());
+
+  m_adaptor.CompleteTransfer(submissions[1].transfer,
+                             LIBUSB_TRANSFER_CANCELLED);
+  OLA_ASSERT_TRUE(thread.Join());
+  OLA_ASSERT_TRUE(thread.Done());
+
+  // The held frame isn't sent while cancelling.
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_adaptor.Submissions().size());
+}
+
+
+/*
+ * Check a transfer isn't submitted again while it's in flight.
+ */
+void AsyncUsbSenderTest::testNoFreeTransfer() {
+  TestSender sender(&m_adaptor, AsyncUsbSender::PIPELINE_DEPTH);
+  OLA_ASSERT_TRUE(sender.Init());
+
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(1)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(2)));
+  vector<FakeLibUsbAdaptor::Submission> submissions = m_adaptor.Submissions();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), submissions.size());
+
+  OLA_ASSERT_EQ(static_cast<int>(LIBUSB_ERROR_BUSY),
+                sender.ForceSubmit(Frame(3)));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_adaptor.Submissions().size());
+
+  // Once a transfer completes it can be used again.
+  m_adaptor.CompleteTransfer(submissions[0].transfer,
+                             LIBUSB_TRANSFER_COMPLETED);
+  OLA_ASSERT_EQ(0, sender.ForceSubmit(Frame(3)));
+  submissions = m_adaptor.Submissions();
+  OLA_ASSERT_EQ(static_cast<size_t>(3), submissions.size());
+  OLA_ASSERT_EQ(Frame(3), submissions[2].data);
+
+  m_adaptor.CompleteTransfer(submissions[1].transfer,
+                             LIBUSB_TRANSFER_COMPLETED);
+  m_adaptor.CompleteTransfer(submissions[2].transfer,
+                             LIBUSB_TRANSFER_COMPLETED);
+}
@@ -20,6 +20,9 @@
 
 #include "plugins/usbdmx/AsyncUsbTransceiverBase.h"
 
+#include <string.h>
+#include <algorithm>
+
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/Logging.h"
 
@@ -45,20 +48,34 @@ void AsyncCallback(struct libusb_transfer *transfer) {
 }  // namespace
 
 AsyncUsbTransceiverBase::AsyncUsbTransceiverBase(LibUsbAdaptor *adaptor,
-                                                 libusb_device *usb_device)
+                                                 libusb_device *usb_device,
+                                                 unsigned int max_in_flight)
     : m_adaptor(adaptor),
       m_usb_device(usb_device),
       m_usb_handle(NULL),
       m_suppress_continuation(false),
-      m_transfer_state(IDLE) {
-  m_transfer = m_adaptor->AllocTransfer(0);
+      m_transfer_state(IDLE),
+      m_in_flight(0) {
+  m_slots.resize(std::max(max_in_flight, 1u));
+  for (TransferSlots::iterator iter = m_slots.begin(); iter != m_slots.end();
+       ++iter) {
+    iter->transfer = m_adaptor->AllocTransfer(0);
+    iter->in_flight = false;
+    iter->data = NULL;
+    iter->data_size = 0;
+  }
+  m_transfer = m_slots[0].transfer;
   m_adaptor->RefDevice(usb_device);
 }
 
 AsyncUsbTransceiverBase::~AsyncUsbTransceiverBase() {
   CancelTransfer();
   m_adaptor->UnrefDevice(m_usb_device);
-  m_adaptor->FreeTransfer(m_transfer);
+  for (TransferSlots::iterator iter = m_slots.begin(); iter != m_slots.end();
+       ++iter) {
+    m_adaptor->FreeTransfer(iter->transfer);
+    delete[] iter->data;
+  }
 }
 
 bool AsyncUsbTransceiverBase::Init() {
@@ -74,14 +91,21 @@ void AsyncUsbTransceiverBase::CancelTransfer() {
   bool canceled = false;
   while (1) {
     ola::thread::MutexLocker locker(&m_mutex);
-    if (m_transfer_state == IDLE || m_transfer_state == DISCONNECTED) {
+    // Wait for every transfer, since the device may disconnect while more
+    // than one is in flight.
+    if (m_in_flight == 0) {
       break;
     }
     if (!canceled) {
       m_suppress_continuation = true;
-      if (m_adaptor->CancelTransfer(m_transfer) == 0) {
-        canceled = true;
-      } else {
+      for (TransferSlots::iterator iter = m_slots.begin();
+           iter != m_slots.end(); ++iter) {
+        if (iter->in_flight &&
+            m_adaptor->CancelTransfer(iter->transfer) == 0) {
+          canceled = true;
+        }
+      }
+      if (!canceled) {
         break;
       }
     }
@@ -113,6 +137,33 @@ void AsyncUsbTransceiverBase::FillInterruptTransfer(unsigned char endpoint,
 }
 
 int AsyncUsbTransceiverBase::SubmitTransfer() {
+  TransferSlot *slot = NULL;
+  for (TransferSlots::iterator iter = m_slots.begin(); iter != m_slots.end();
+       ++iter) {
+    if (iter->transfer == m_transfer) {
+      slot = &(*iter);
+      break;
+    }
+  }
+
+  if (!slot || slot->in_flight) {
+    OLA_WARN << "No free USB transfer to submit";
+    return LIBUSB_ERROR_BUSY;
+  }
+
+  if (m_slots.size() > 1) {
+    // Take a copy of the data, so the caller can reuse its buffer while this
+    // transfer is in flight.
+    const unsigned int length = static_cast<unsigned int>(m_transfer->length);
+    if (length > slot->data_size) {
+      delete[] slot->data;
+      slot->data = new uint8_t[length];
+      slot->data_size = length;
+    }
+    memcpy(slot->data, m_transfer->buffer, length);
+    m_transfer->buffer = slot->data;
+  }
+
   int ret = m_adaptor->SubmitTransfer(m_transfer);
   if (ret) {
     OLA_WARN << "libusb_submit_transfer returned "
@@ -122,9 +173,48 @@ int AsyncUsbTransceiverBase::SubmitTransfer() {
     }
     return false;
   }
+  slot->in_flight = true;
+  m_in_flight++;
   m_transfer_state = IN_PROGRESS;
+
+  // Move on to a transfer that isn't in flight, if there is one.
+  for (TransferSlots::iterator iter = m_slots.begin(); iter != m_slots.end();
+       ++iter) {
+    if (!iter->in_flight) {
+      m_transfer = iter->transfer;
+      break;
+    }
+  }
   return ret;
 }
+
+bool AsyncUsbTransceiverBase::CanSubmitTransfer() const {
+  return m_in_flight < m_slots.size();
+}
+
+bool AsyncUsbTransceiverBase::TransferDone(struct libusb_transfer *transfer) {
+  for (TransferSlots::iterator iter = m_slots.begin(); iter != m_slots.end();
+       ++iter) {
+    if (iter->transfer != transfer || !iter->in_flight) {
+      continue;
+    }
+
+    iter->in_flight = false;
+    m_in_flight--;
+    if (transfer->status == LIBUSB_TRANSFER_NO_DEVICE) {
+      m_transfer_state = DISCONNECTED;
+    } else if (m_in_flight == 0 && m_transfer_state != DISCONNECTED) {
+      m_transfer_state = IDLE;
+    }
+
+    if (m_in_flight == m_slots.size() - 1) {
+      // All the transfers were in flight, so m_transfer is still in use.
+      m_transfer = transfer;
+    }
+    return true;
+  }
+  return false;
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
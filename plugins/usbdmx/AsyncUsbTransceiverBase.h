@@ -22,6 +22,9 @@
 #define PLUGINS_USBDMX_ASYNCUSBTRANSCEIVERBASE_H_
 
 #include <libusb.h>
+#include <stdint.h>
+
+#include <vector>
 
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/DmxBuffer.h"
@@ -35,6 +38,11 @@ namespace usbdmx {
 /**
  * @brief A base class that implements common functionality to send or receive
  * DMX asynchronously to a libusb_device.
+ *
+ * Subclasses fill m_transfer and then call SubmitTransfer(). If more than one
+ * transfer can be in flight, the data is copied when the transfer is
+ * submitted, so the subclass can start building the next transfer straight
+ * away, and m_transfer moves on to a transfer that isn't in use.
  */
 class AsyncUsbTransceiverBase {
  public:
@@ -42,9 +50,12 @@ class AsyncUsbTransceiverBase {
    * @brief Create a new AsyncUsbTransceiverBase.
    * @param adaptor the LibUsbAdaptor to use.
    * @param usb_device the libusb_device to use for the widget.
+   * @param max_in_flight the maximum number of transfers that can be in
+   *   flight at once.
    */
   AsyncUsbTransceiverBase(ola::usb::LibUsbAdaptor* const adaptor,
-                          libusb_device *usb_device);
+                          libusb_device *usb_device,
+                          unsigned int max_in_flight = 1);
 
   /**
    * @brief Destructor
@@ -122,10 +133,26 @@ class AsyncUsbTransceiverBase {
 
   /**
    * @brief Submit the transfer for tx.
-   * @returns the result of libusb_submit_transfer().
+   * @returns the result of libusb_submit_transfer(), or LIBUSB_ERROR_BUSY if
+   *   all the transfers are already in flight.
    */
   int SubmitTransfer();
 
+  /**
+   * @brief Check if another transfer can be submitted.
+   * @returns true if fewer than max_in_flight transfers are in flight.
+   */
+  bool CanSubmitTransfer() const;
+
+  /**
+   * @brief Mark a transfer as no longer in flight.
+   * @param transfer the transfer passed to TransferComplete().
+   * @returns false if the transfer doesn't belong to us.
+   *
+   * This updates m_transfer_state and must be called with m_mutex held.
+   */
+  bool TransferDone(struct libusb_transfer *transfer);
+
   enum TransferState {
     IDLE,
     IN_PROGRESS,
@@ -140,6 +167,19 @@ class AsyncUsbTransceiverBase {
   ola::thread::Mutex m_mutex;
 
  private:
+  struct TransferSlot {
+    struct libusb_transfer *transfer;
+    bool in_flight;
+    // A copy of the data, only used if more than one transfer can be in
+    // flight.
+    uint8_t *data;
+    unsigned int data_size;
+  };
+  typedef std::vector<TransferSlot> TransferSlots;
+
+  TransferSlots m_slots;
+  unsigned int m_in_flight;  // GUARDED_BY(m_mutex);
+
   DISALLOW_COPY_AND_ASSIGN(AsyncUsbTransceiverBase);
 };
 }  // namespace usbdmx
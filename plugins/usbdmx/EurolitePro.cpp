@@ -219,7 +219,7 @@ class EuroliteProAsyncUsbSender : public AsyncUsbSender {
   EuroliteProAsyncUsbSender(LibUsbAdaptor *adaptor,
                             libusb_device *usb_device,
                             bool is_mk2)
-      : AsyncUsbSender(adaptor, usb_device),
+      : AsyncUsbSender(adaptor, usb_device, PIPELINE_DEPTH),
         m_is_mk2(is_mk2) {
   }
 
@@ -101,6 +101,19 @@ plugins_usbdmx_libolausbdmx_la_CXXFLAGS = $(COMMON_CXXFLAGS) $(libusb_CFLAGS)
 plugins_usbdmx_libolausbdmx_la_LIBADD = \
     olad/plugin_api/libolaserverplugininterface.la \
     plugins/usbdmx/libolausbdmxwidget.la
+
+# TESTS
+##################################################
+test_programs += plugins/usbdmx/AsyncUsbSenderTester
+
+plugins_usbdmx_AsyncUsbSenderTester_SOURCES = \
+    plugins/usbdmx/AsyncUsbSenderTest.cpp
+plugins_usbdmx_AsyncUsbSenderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS) \
+                                               $(libusb_CFLAGS)
+plugins_usbdmx_AsyncUsbSenderTester_LDADD = \
+    $(COMMON_TESTING_LIBS) \
+    $(libusb_LIBS) \
+    plugins/usbdmx/libolausbdmxwidget.la
 endif
 
 EXTRA_DIST += \
@@ -285,7 +285,7 @@ class FadecandyAsyncUsbSender : public AsyncUsbSender {
  public:
   FadecandyAsyncUsbSender(LibUsbAdaptor *adaptor,
                           libusb_device *usb_device)
-      : AsyncUsbSender(adaptor, usb_device) {
+      : AsyncUsbSender(adaptor, usb_device, PIPELINE_DEPTH) {
   }
 
   libusb_device_handle* SetupHandle();
@@ -265,7 +265,8 @@ class ShowJockeyDMXU1AsyncUsbSender : public AsyncUsbSender {
                                 int endpoint,
                                 int max_packet_size_out,
                                 libusb_device_handle *handle)
-                                : AsyncUsbSender(adaptor, usb_device),
+                                : AsyncUsbSender(adaptor, usb_device,
+                                                 PIPELINE_DEPTH),
                                   m_endpoint(endpoint),
                                   m_max_packet_size_out(max_packet_size_out) {
     m_usb_handle = handle;
@@ -168,7 +168,7 @@ class SunliteAsyncUsbSender : public AsyncUsbSender {
  public:
   SunliteAsyncUsbSender(LibUsbAdaptor *adaptor,
                         libusb_device *usb_device)
-      : AsyncUsbSender(adaptor, usb_device) {
+      : AsyncUsbSender(adaptor, usb_device, PIPELINE_DEPTH) {
     InitPacket(m_packet);
   }
 
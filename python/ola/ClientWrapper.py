@@ -292,9 +292,9 @@ class SelectServer(object):
 
 
 class ClientWrapper(object):
-  def __init__(self, socket=None):
+  def __init__(self, socket=None, socket_path=None):
     self._ss = SelectServer()
-    self._client = OlaClient(socket)
+    self._client = OlaClient(socket, socket_path=socket_path)
     self._ss.AddReadDescriptor(self._client.GetSocket(),
                                self._client.SocketReady)
 
@@ -778,21 +778,29 @@ class RDMResponse(object):
 
 class OlaClient(Ola_pb2.OlaClientService):
   """The client used to communicate with olad."""
-  def __init__(self, our_socket=None, close_callback=None):
+  def __init__(self, our_socket=None, close_callback=None, socket_path=None):
     """Create a new client.
 
     Args:
       socket: the socket to use for communications, if not provided one is
         created.
       close_callback: A callable to run if the socket is closed
+      socket_path: if set, and no socket is provided, connect to olad using
+        the local socket at this path rather than TCP. olad needs to be run
+        with --rpc-socket.
     """
     self._close_callback = close_callback
     self._socket = our_socket
 
     if self._socket is None:
-      self._socket = socket.socket()
+      if socket_path:
+        self._socket = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        address = socket_path
+      else:
+        self._socket = socket.socket()
+        address = ('localhost', OLA_PORT)
       try:
-        self._socket.connect(('localhost', OLA_PORT))
+        self._socket.connect(address)
       except socket.error:
         raise OLADNotRunningException('Failed to connect to olad')
 